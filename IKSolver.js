@@ -63,6 +63,99 @@ class Vector3D {
     clone() {
         return new Vector3D(this.x, this.y, this.z);
     }
+
+    // In-place operations - these modify and return `this` and never allocate.
+    // Use them (or the static *Into variants) inside per-frame loops.
+    set(x, y, z) {
+        this.x = x;
+        this.y = y;
+        this.z = z;
+        return this;
+    }
+
+    copy(v) {
+        return this.set(v.x, v.y, v.z);
+    }
+
+    addInPlace(v) {
+        return this.set(this.x + v.x, this.y + v.y, this.z + v.z);
+    }
+
+    subtractInPlace(v) {
+        return this.set(this.x - v.x, this.y - v.y, this.z - v.z);
+    }
+
+    multiplyInPlace(scalar) {
+        return this.set(this.x * scalar, this.y * scalar, this.z * scalar);
+    }
+
+    normalizeInPlace() {
+        const mag = this.magnitude();
+        return mag > 0 ? this.multiplyInPlace(1 / mag) : this.set(0, 0, 0);
+    }
+
+    // Output-parameter operations - write a op b into `out` (which may alias a or b)
+    static addInto(out, a, b) {
+        return out.set(a.x + b.x, a.y + b.y, a.z + b.z);
+    }
+
+    static subtractInto(out, a, b) {
+        return out.set(a.x - b.x, a.y - b.y, a.z - b.z);
+    }
+
+    static crossInto(out, a, b) {
+        return out.set(
+            a.y * b.z - a.z * b.y,
+            a.z * b.x - a.x * b.z,
+            a.x * b.y - a.y * b.x
+        );
+    }
+}
+
+/**
+ * Unit quaternion (x, y, z, w) for bone orientations; see IKSolver.initBoneQuaternions
+ */
+class Quaternion {
+    constructor(x = 0, y = 0, z = 0, w = 1) {
+        this.x = x;
+        this.y = y;
+        this.z = z;
+        this.w = w;
+    }
+
+    set(x, y, z, w) {
+        this.x = x;
+        this.y = y;
+        this.z = z;
+        this.w = w;
+        return this;
+    }
+
+    clone() {
+        return new Quaternion(this.x, this.y, this.z, this.w);
+    }
+
+    // this * q: q first, then this
+    multiply(q) {
+        return new Quaternion(
+            this.w * q.x + this.x * q.w + this.y * q.z - this.z * q.y,
+            this.w * q.y - this.x * q.z + this.y * q.w + this.z * q.x,
+            this.w * q.z + this.x * q.y - this.y * q.x + this.z * q.w,
+            this.w * q.w - this.x * q.x - this.y * q.y - this.z * q.z
+        );
+    }
+
+    rotate(v) {
+        // v + 2w (u x v) + 2 u x (u x v)
+        const tx = 2 * (this.y * v.z - this.z * v.y);
+        const ty = 2 * (this.z * v.x - this.x * v.z);
+        const tz = 2 * (this.x * v.y - this.y * v.x);
+        return new Vector3D(
+            v.x + this.w * tx + this.y * tz - this.z * ty,
+            v.y + this.w * ty + this.z * tx - this.x * tz,
+            v.z + this.w * tz + this.x * ty - this.y * tx
+        );
+    }
 }
 
 class Joint {
@@ -71,15 +164,34 @@ class Joint {
         this.minAngle = minAngle; // Constraint in degrees
         this.maxAngle = maxAngle; // Constraint in degrees
         this.rotation = new Vector3D(0, 0, 0); // Euler angles in degrees (x, y, z)
+        this.hingeAxis = null; // Optional world-space bend axis; null limits the bend as a cone
+        this.quaternion = null; // Bone orientation, kept current by the solvers once set (see initBoneQuaternions)
     }
 
     clone() {
         const joint = new Joint(this.position.clone(), this.minAngle, this.maxAngle);
         joint.rotation = this.rotation.clone();
+        joint.hingeAxis = this.hingeAxis ? this.hingeAxis.clone() : null;
+        joint.quaternion = this.quaternion ? this.quaternion.clone() : null;
         return joint;
     }
 }
 
+// cos(0.001): CCD skips pivots whose correction is below a milliradian
+const COS_MIN_CCD_ANGLE = Math.cos(0.001);
+// per-pivot rotation scratch shared by the CCD solvers: the 3x3 matrix, then the same
+// rotation as a quaternion
+const CCD_ROTATION = new Float64Array(13);
+// bone quaternion bookkeeping, grown on demand by IKSolver._quaternionScratch
+const QUATERNION_SCRATCH = { joints: 0, pivots: null, isPivotRotated: null, directions: null, positions: null, quaternions: null };
+// constrained bone direction written by IKSolver._constrainDirectionScalar
+const BATCH_DIRECTION = new Float64Array(3);
+
+/**
+ * Parent of each of the 21 MediaPipe hand landmarks (-1 for the wrist), for solveDLS
+ */
+const MediaPipeHandParents = [-1, 0, 1, 2, 3, 0, 5, 6, 7, 0, 9, 10, 11, 0, 13, 14, 15, 0, 17, 18, 19];
+
 class IKSolver {
     /**
      * Solve IK using CCD (Cyclic Coordinate Descent) algorithm
@@ -94,9 +206,18 @@ class IKSolver {
             throw new Error("Chain must have at least 2 joints");
         }
 
+        // Two-bone chains (shoulder-elbow-wrist) have a closed-form solution
+        if (chain.length === 3) {
+            return this.solveTwoBone(chain, targetPosition);
+        }
+
         // Clone the chain to avoid modifying the original
         const workChain = chain.map(joint => joint.clone());
         const endEffectorIndex = workChain.length - 1;
+        const scratch = this._isTrackingQuaternions(workChain) ? this._quaternionScratch(workChain.length) : null;
+        if (scratch) {
+            this._packQuaternions(workChain, scratch.quaternions);
+        }
 
         for (let iter = 0; iter < iterations; iter++) {
             // Check if we've reached the target
@@ -109,37 +230,36 @@ class IKSolver {
 
             // Iterate backwards through the chain (excluding end effector)
             for (let i = endEffectorIndex - 1; i >= 0; i--) {
-                const currentJoint = workChain[i].position;
-                const currentEnd = workChain[endEffectorIndex].position;
-
-                // Vector from current joint to end effector
-                const toEnd = currentEnd.subtract(currentJoint);
-                // Vector from current joint to target
-                const toTarget = targetPosition.subtract(currentJoint);
-
-                // Calculate rotation angle
-                const toEndNorm = toEnd.normalize();
-                const toTargetNorm = toTarget.normalize();
-                
-                // Calculate angle between vectors
-                const dotProduct = Math.max(-1, Math.min(1, toEndNorm.dot(toTargetNorm)));
-                const angle = Math.acos(dotProduct);
-
-                // Skip if angle is too small
-                if (Math.abs(angle) < 0.001) continue;
-
-                // Get rotation axis
-                const rotationAxis = toEndNorm.cross(toTargetNorm).normalize();
+                const pivot = workChain[i].position;
+                const end = workChain[endEffectorIndex].position;
+                const m = CCD_ROTATION;
+                m[0] = end.x - pivot.x; m[1] = end.y - pivot.y; m[2] = end.z - pivot.z;
+                m[3] = targetPosition.x - pivot.x; m[4] = targetPosition.y - pivot.y; m[5] = targetPosition.z - pivot.z;
+                if (!this._ccdRotation(m, scratch !== null)) {
+                    continue;
+                }
 
-                // Apply rotation to all joints from current to end
+                // Apply the pivot's rotation to all joints from current to end
                 for (let j = i + 1; j <= endEffectorIndex; j++) {
-                    const relPos = workChain[j].position.subtract(currentJoint);
-                    const rotated = this.rotateAroundAxis(relPos, rotationAxis, angle);
-                    workChain[j].position = currentJoint.add(rotated);
+                    const p = workChain[j].position;
+                    const vx = p.x - pivot.x, vy = p.y - pivot.y, vz = p.z - pivot.z;
+                    p.set(pivot.x + m[0] * vx + m[1] * vy + m[2] * vz,
+                        pivot.y + m[3] * vx + m[4] * vy + m[5] * vz,
+                        pivot.z + m[6] * vx + m[7] * vy + m[8] * vz);
                 }
+                if (scratch) {
+                    this._storePivotRotation(scratch, i, m);
+                }
+            }
+            if (scratch) {
+                this._applyCCDSweep(scratch, workChain.length, scratch.quaternions);
             }
         }
 
+        if (scratch) {
+            this._normalizeBoneQuaternions(scratch.quaternions, workChain.length);
+            return this._unpackQuaternions(scratch.quaternions, workChain);
+        }
         // Calculate and store bone rotations
         return this.calculateBoneRotations(workChain);
     }
@@ -157,9 +277,19 @@ class IKSolver {
             throw new Error("Chain must have at least 2 joints");
         }
 
+        // Two-bone chains (shoulder-elbow-wrist) have a closed-form solution
+        if (chain.length === 3) {
+            return this.solveTwoBone(chain, targetPosition);
+        }
+
         // Clone the chain
         const workChain = chain.map(joint => joint.clone());
         const n = workChain.length;
+        const scratch = this._isTrackingQuaternions(workChain) ? this._quaternionScratch(n) : null;
+        if (scratch) {
+            this._packPositions(workChain, scratch.positions);
+            this._captureBoneDirections(scratch.positions, n, scratch.directions);
+        }
         
         // Store original bone lengths
         const boneLengths = [];
@@ -181,9 +311,13 @@ class IKSolver {
                 const offset = direction.multiply(boneLengths[i - 1]);
                 workChain[i].position = workChain[i - 1].position.add(offset);
             }
-            return workChain;
+            return scratch ? this._finishBoneQuaternions(scratch, workChain) : workChain;
         }
 
+        // Joint limits are enforced inside both passes, so the iteration converges to a
+        // pose that already respects them instead of being corrected afterwards
+        const constrained = this.hasConstraints(workChain);
+
         // FABRIK iterations
         for (let iter = 0; iter < iterations; iter++) {
             // Check convergence
@@ -195,22 +329,203 @@ class IKSolver {
             // Forward reaching phase
             workChain[n - 1].position = targetPosition.clone();
             for (let i = n - 2; i >= 0; i--) {
-                const direction = workChain[i].position.subtract(workChain[i + 1].position).normalize();
+                let direction = workChain[i].position.subtract(workChain[i + 1].position).normalize();
+                if (constrained && i + 2 < n) {
+                    // Bone i enters joint i + 1, whose outgoing bone is already placed
+                    const next = workChain[i + 2].position.subtract(workChain[i + 1].position).normalize();
+                    direction = this.constrainDirection(next, direction.multiply(-1), workChain[i + 1], true).multiply(-1);
+                }
                 workChain[i].position = workChain[i + 1].position.add(direction.multiply(boneLengths[i]));
             }
 
             // Backward reaching phase
             workChain[0].position = rootPos.clone();
             for (let i = 0; i < n - 1; i++) {
-                const direction = workChain[i + 1].position.subtract(workChain[i].position).normalize();
+                let direction = workChain[i + 1].position.subtract(workChain[i].position).normalize();
+                if (constrained && i > 0) {
+                    const previous = workChain[i].position.subtract(workChain[i - 1].position).normalize();
+                    direction = this.constrainDirection(previous, direction, workChain[i], false);
+                }
                 workChain[i + 1].position = workChain[i].position.add(direction.multiply(boneLengths[i]));
             }
         }
 
+        if (scratch) {
+            return this._finishBoneQuaternions(scratch, workChain);
+        }
         // Calculate and store bone rotations
         return this.calculateBoneRotations(workChain);
     }
 
+    /**
+     * Analytic two-bone IK (law of cosines), used automatically for 3-joint chains
+     *
+     * Constant time and no convergence jitter. The elbow bends in the plane spanned by the
+     * root-to-target direction and the pole: by default the current middle joint, so the
+     * bend direction carries over from the input pose.
+     *
+     * @param {Array<Joint>} chain - Exactly 3 joints: root, middle, end
+     * @param {Vector3D} targetPosition - Desired position for end effector
+     * @param {Vector3D} poleTarget - Optional point the middle joint should bend towards
+     * @returns {Array<Joint>} - Updated joint chain
+     */
+    static solveTwoBone(chain, targetPosition, poleTarget = null) {
+        if (!chain || chain.length !== 3) {
+            throw new Error("Two-bone IK needs exactly 3 joints");
+        }
+        const positions = new Float32Array(9);
+        chain.forEach((joint, i) => {
+            positions[i * 3] = joint.position.x;
+            positions[i * 3 + 1] = joint.position.y;
+            positions[i * 3 + 2] = joint.position.z;
+        });
+        const elbow = chain[1];
+        const scratch = this._isTrackingQuaternions(chain) ? this._quaternionScratch(3) : null;
+        if (scratch) {
+            this._packQuaternions(chain, scratch.quaternions);
+        }
+        this.solveTwoBoneFlat(positions, targetPosition, poleTarget,
+            Math.max(0, elbow.minAngle), Math.min(180, Math.max(Math.abs(elbow.minAngle), Math.abs(elbow.maxAngle))),
+            scratch ? scratch.quaternions : null);
+
+        const workChain = chain.map((joint, i) => {
+            const j = joint.clone();
+            j.position.set(positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2]);
+            return j;
+        });
+        return scratch ? this._unpackQuaternions(scratch.quaternions, workChain) : this.calculateBoneRotations(workChain);
+    }
+
+    /**
+     * Flat-buffer form of solveTwoBone; updates 9 floats in place without allocating
+     * @param {Float32Array} positions - Interleaved x, y, z of root, middle and end joint
+     * @param {Vector3D} targetPosition - Desired position for end effector
+     * @param {Vector3D} poleTarget - Optional point the middle joint should bend towards
+     * @param {Number} minBend - Smallest bend at the middle joint in degrees, 0 is straight (default: 0)
+     * @param {Number} maxBend - Largest bend at the middle joint in degrees (default: 180)
+     * @param {Float32Array} quaternions - Optional x, y, z, w per joint from initBoneQuaternionsFlat
+     * @returns {Number} - Always 0 (no iterations)
+     */
+    static solveTwoBoneFlat(positions, targetPosition, poleTarget = null, minBend = 0, maxBend = 180, quaternions = null) {
+        if (quaternions) {
+            const directions = this._quaternionScratch(3).directions;
+            this._captureBoneDirections(positions, 3, directions);
+            this.solveTwoBoneFlat(positions, targetPosition, poleTarget, minBend, maxBend);
+            this._updateBoneQuaternions(directions, positions, 3, quaternions);
+            return 0;
+        }
+        const ax = positions[0], ay = positions[1], az = positions[2];
+        const px = poleTarget ? poleTarget.x : positions[3];
+        const py = poleTarget ? poleTarget.y : positions[4];
+        const pz = poleTarget ? poleTarget.z : positions[5];
+
+        const ux = positions[3] - ax, uy = positions[4] - ay, uz = positions[5] - az;
+        const vx = positions[6] - positions[3], vy = positions[7] - positions[4], vz = positions[8] - positions[5];
+        const upper = Math.sqrt(ux * ux + uy * uy + uz * uz);
+        const lower = Math.sqrt(vx * vx + vy * vy + vz * vz);
+
+        let dx = targetPosition.x - ax, dy = targetPosition.y - ay, dz = targetPosition.z - az;
+        const targetDistance = Math.sqrt(dx * dx + dy * dy + dz * dz);
+        let dist = targetDistance;
+        if (dist === 0) {
+            // Degenerate target on the root: keep the current direction of the chain
+            dx = positions[6] - ax; dy = positions[7] - ay; dz = positions[8] - az;
+            dist = Math.sqrt(dx * dx + dy * dy + dz * dz) || 1;
+        }
+        dx /= dist; dy /= dist; dz /= dist;
+
+        // Unreachable targets stretch the chain; too-close targets fold it as far as it goes.
+        // The bend limits at the middle joint bound the reach the same way
+        const minReach = Math.sqrt(Math.max(0, upper * upper + lower * lower + 2 * upper * lower * Math.cos(maxBend * Math.PI / 180)));
+        const maxReach = Math.sqrt(Math.max(0, upper * upper + lower * lower + 2 * upper * lower * Math.cos(minBend * Math.PI / 180)));
+        const reach = Math.max(minReach, Math.min(maxReach, targetDistance));
+
+        // Bend direction: pole projected onto the plane perpendicular to the reach direction
+        let bx = px - ax, by = py - ay, bz = pz - az;
+        const along = bx * dx + by * dy + bz * dz;
+        bx -= dx * along; by -= dy * along; bz -= dz * along;
+        let bl = Math.sqrt(bx * bx + by * by + bz * bz);
+        if (bl < 1e-6) {
+            // Pole on the reach line: pick any perpendicular
+            if (Math.abs(dx) < 0.9) { bx = 0; by = -dz; bz = dy; } else { bx = dz; by = 0; bz = -dx; }
+            bl = Math.sqrt(bx * bx + by * by + bz * bz);
+        }
+        bx /= bl; by /= bl; bz /= bl;
+
+        // Law of cosines for the angle at the root
+        const cosA = upper > 0 && reach > 0
+            ? Math.max(-1, Math.min(1, (upper * upper + reach * reach - lower * lower) / (2 * upper * reach)))
+            : 1;
+        const sinA = Math.sqrt(1 - cosA * cosA);
+
+        positions[3] = ax + (dx * cosA + bx * sinA) * upper;
+        positions[4] = ay + (dy * cosA + by * sinA) * upper;
+        positions[5] = az + (dz * cosA + bz * sinA) * upper;
+        positions[6] = ax + dx * reach;
+        positions[7] = ay + dy * reach;
+        positions[8] = az + dz * reach;
+        return 0;
+    }
+
+    /**
+     * Rotation taking direction a onto direction b, as a row-major 3x3 matrix. For unit
+     * vectors the dot is the cosine and the cross length the sine of the angle, so no
+     * trig is needed; CCD builds this once per pivot and applies it to every joint after it.
+     * a and b are read from out[0..2] and out[3..5]: V8 does not inline this call, and six
+     * double arguments would be boxed on every pivot.
+     * With withQuaternion set, out[9..12] also receives the rotation as a quaternion.
+     * @returns {Boolean} - false when the angle is below a milliradian or undefined
+     */
+    static _ccdRotation(out, withQuaternion) {
+        let ax = out[0], ay = out[1], az = out[2];
+        let bx = out[3], by = out[4], bz = out[5];
+        const la = Math.sqrt(ax * ax + ay * ay + az * az);
+        const lb = Math.sqrt(bx * bx + by * by + bz * bz);
+        if (la === 0 || lb === 0) return false;
+        ax /= la; ay /= la; az /= la;
+        bx /= lb; by /= lb; bz /= lb;
+
+        const c = Math.max(-1, Math.min(1, ax * bx + ay * by + az * bz));
+        if (c > COS_MIN_CCD_ANGLE) return false;
+        let kx = ay * bz - az * by, ky = az * bx - ax * bz, kz = ax * by - ay * bx;
+        const s = Math.sqrt(kx * kx + ky * ky + kz * kz);
+        if (s === 0) return false;
+        kx /= s; ky /= s; kz /= s;
+
+        const t = 1 - c;
+        out[0] = c + kx * kx * t; out[1] = kx * ky * t - kz * s; out[2] = kx * kz * t + ky * s;
+        out[3] = ky * kx * t + kz * s; out[4] = c + ky * ky * t; out[5] = ky * kz * t - kx * s;
+        out[6] = kz * kx * t - ky * s; out[7] = kz * ky * t + kx * s; out[8] = c + kz * kz * t;
+        if (withQuaternion) {
+            // _halfCos/_halfSin inlined: called per pivot, their double arguments get boxed
+            let hc, hs;
+            if (c >= 0) {
+                hc = Math.sqrt(0.5 * (1 + c));
+                hs = s / (2 * hc);
+            } else {
+                hs = Math.sqrt(0.5 * Math.min(2, 1 - c));
+                hc = s / (2 * hs);
+            }
+            out[9] = kx * hs; out[10] = ky * hs; out[11] = kz * hs; out[12] = hc;
+        }
+        return true;
+    }
+
+    // cos and sin of half the angle with cosine c and sine s, without trig. The square root
+    // is taken of whichever of 1 + c and 1 - c does not cancel, the other half follows from
+    // sin a = 2 sin(a/2) cos(a/2)
+    static _halfCos(c, s) {
+        return c >= 0 ? Math.sqrt(0.5 * (1 + c)) : s / (2 * this._halfSin(c, s));
+    }
+
+    static _halfSin(c, s) {
+        if (c >= 0) {
+            return s / (2 * Math.sqrt(0.5 * (1 + c)));
+        }
+        const hs = Math.sqrt(0.5 * Math.min(2, 1 - c));
+        return s < 0 ? -hs : hs;
+    }
+
     /**
      * Rotate a vector around an axis by an angle
      * Uses Rodrigues' rotation formula
@@ -261,35 +576,98 @@ class IKSolver {
     }
 
     /**
-     * Apply joint constraints to ensure angles are within limits
+     * Enforce joint limits on an already solved chain (root to tip). solveFABRIK applies the
+     * same limits inside its iteration, so this is only needed for poses from other sources
      * @param {Array<Joint>} chain - Joint chain
-     * @returns {Array<Joint>} - Constrained chain
+     * @returns {Array<Joint>} - Chain with every interior joint inside its limits
      */
     static applyConstraints(chain) {
         const constrainedChain = chain.map(joint => joint.clone());
         
         for (let i = 1; i < constrainedChain.length - 1; i++) {
-            const v1 = constrainedChain[i].position.subtract(constrainedChain[i - 1].position);
-            const v2 = constrainedChain[i + 1].position.subtract(constrainedChain[i].position);
-            
-            const currentAngle = Math.acos(
-                Math.max(-1, Math.min(1, v1.normalize().dot(v2.normalize())))
-            ) * (180 / Math.PI);
+            const previous = constrainedChain[i].position.subtract(constrainedChain[i - 1].position).normalize();
+            const bone = constrainedChain[i + 1].position.subtract(constrainedChain[i].position);
+            const length = bone.magnitude();
+            const direction = this.constrainDirection(previous, bone.normalize(), constrainedChain[i], false);
+            const moved = constrainedChain[i].position.add(direction.multiply(length)).subtract(constrainedChain[i + 1].position);
 
-            const joint = constrainedChain[i];
-            
-            // Clamp angle within constraints
-            if (currentAngle < joint.minAngle || currentAngle > joint.maxAngle) {
-                const targetAngle = Math.max(joint.minAngle, Math.min(joint.maxAngle, currentAngle));
-                // Adjust position to respect constraint
-                // This is a simplified constraint - real implementation would be more complex
-                console.warn(`Joint ${i} angle ${currentAngle}° outside limits [${joint.minAngle}°, ${joint.maxAngle}°]`);
+            // Carry the rest of the chain along with the corrected bone
+            for (let k = i + 1; k < constrainedChain.length; k++) {
+                constrainedChain[k].position = constrainedChain[k].position.add(moved);
             }
         }
         
         return constrainedChain;
     }
 
+    /**
+     * Whether any interior joint of the chain limits its bend
+     * @param {Array<Joint>} chain - Joint chain
+     * @returns {Boolean}
+     */
+    static hasConstraints(chain) {
+        for (let i = 1; i < chain.length - 1; i++) {
+            const joint = chain[i];
+            if (joint.hingeAxis || joint.minAngle > 0 || Math.max(-joint.minAngle, joint.maxAngle) < 180) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Clamp the bend at a joint
+     *
+     * The bend is the angle between the incoming bone (previous) and the outgoing bone
+     * (direction). With joint.hingeAxis set, both bones are kept in the plane normal to the
+     * axis and the signed bend about it is clamped to [minAngle, maxAngle]. Otherwise the
+     * outgoing bone is kept in a cone around the incoming one whose half-angle is the larger
+     * of |minAngle| and maxAngle, and a positive minAngle forbids straightening past it.
+     *
+     * @param {Vector3D} previous - Unit direction of the incoming bone
+     * @param {Vector3D} direction - Unit direction of the outgoing bone
+     * @param {Joint} joint - Joint between the two bones
+     * @param {Boolean} reverse - True when previous is the outgoing bone and the incoming one is
+     *                            being placed (tip-to-root pass); the signed hinge range flips
+     * @returns {Vector3D} - Unit direction inside the limits
+     */
+    static constrainDirection(previous, direction, joint, reverse) {
+        const toRadians = Math.PI / 180;
+        if (joint.hingeAxis) {
+            const axis = joint.hingeAxis.normalize();
+            const p = previous.subtract(axis.multiply(axis.dot(previous)));
+            let d = direction.subtract(axis.multiply(axis.dot(direction)));
+            if (p.magnitude() < 1e-9) {
+                return direction;
+            }
+            if (d.magnitude() < 1e-9) {
+                d = p;
+            }
+            const pn = p.normalize(), dn = d.normalize();
+            const angle = Math.atan2(axis.dot(pn.cross(dn)), pn.dot(dn)) / toRadians;
+            const lo = reverse ? -joint.maxAngle : joint.minAngle;
+            const hi = reverse ? -joint.minAngle : joint.maxAngle;
+            const clamped = Math.max(lo, Math.min(hi, angle));
+            return this.rotateAroundAxis(pn, axis, clamped * toRadians).normalize();
+        }
+
+        const lo = Math.max(0, joint.minAngle);
+        const hi = Math.min(180, Math.max(-joint.minAngle, joint.maxAngle));
+        const angle = Math.acos(Math.max(-1, Math.min(1, previous.dot(direction)))) / toRadians;
+        if (angle >= lo && angle <= hi) {
+            return direction;
+        }
+
+        // Keep the bend plane, move the bone to the nearest edge of the allowed range
+        let side = direction.subtract(previous.multiply(previous.dot(direction)));
+        if (side.magnitude() < 1e-9) {
+            side = Math.abs(previous.x) < 0.9 ? new Vector3D(0, -previous.z, previous.y) : new Vector3D(previous.z, 0, -previous.x);
+        }
+        side = side.normalize();
+        const clamped = Math.max(lo, Math.min(hi, angle)) * toRadians;
+        return previous.multiply(Math.cos(clamped)).add(side.multiply(Math.sin(clamped)));
+    }
+
     /**
      * Calculate bone rotations (Euler angles) from joint positions
      * @param {Array<Joint>} chain - Joint chain with positions
@@ -326,6 +704,919 @@ class IKSolver {
         return rotatedChain;
     }
 
+    /**
+     * Allocation-free FABRIK on a flat joint buffer
+     * @param {Float32Array} positions - Interleaved x, y, z of each joint, root first; updated in place
+     * @param {Vector3D} targetPosition - Desired position for end effector
+     * @param {Number} iterations - Maximum iterations (default: 10)
+     * @param {Number} tolerance - Distance tolerance for convergence (default: 0.01)
+     * @param {Float32Array} boneLengths - Optional scratch of at least jointCount - 1 floats; pass
+     *                                     one in to keep repeated calls allocation-free
+     * @param {Float32Array} quaternions - Optional x, y, z, w per joint from initBoneQuaternionsFlat;
+     *                                     each bone turns by the shortest arc to its new direction
+     * @returns {Number} - Iterations used (0 when the chain was stretched to an unreachable target)
+     */
+    static solveFABRIKFlat(positions, targetPosition, iterations = 10, tolerance = 0.01, boneLengths = null, quaternions = null) {
+        const n = positions.length / 3;
+        if (n < 2) {
+            throw new Error("Chain must have at least 2 joints");
+        }
+        if (n === 3) {
+            return this.solveTwoBoneFlat(positions, targetPosition, null, 0, 180, quaternions);
+        }
+        if (quaternions) {
+            const directions = this._quaternionScratch(n).directions;
+            this._captureBoneDirections(positions, n, directions);
+            const iter = this.solveFABRIKFlat(positions, targetPosition, iterations, tolerance, boneLengths);
+            this._updateBoneQuaternions(directions, positions, n, quaternions);
+            return iter;
+        }
+        const lengths = boneLengths || new Float32Array(n - 1);
+        const tx = targetPosition.x, ty = targetPosition.y, tz = targetPosition.z;
+
+        let totalLength = 0;
+        for (let i = 0; i < n - 1; i++) {
+            const o = i * 3;
+            const dx = positions[o + 3] - positions[o];
+            const dy = positions[o + 4] - positions[o + 1];
+            const dz = positions[o + 5] - positions[o + 2];
+            lengths[i] = Math.sqrt(dx * dx + dy * dy + dz * dz);
+            totalLength += lengths[i];
+        }
+
+        const rx = positions[0], ry = positions[1], rz = positions[2];
+        const rtx = tx - rx, rty = ty - ry, rtz = tz - rz;
+        const rootDistance = Math.sqrt(rtx * rtx + rty * rty + rtz * rtz);
+
+        // If target is unreachable, stretch chain towards target
+        if (rootDistance > totalLength) {
+            const inv = rootDistance > 0 ? 1 / rootDistance : 0;
+            for (let i = 1; i < n; i++) {
+                const o = i * 3;
+                positions[o] = positions[o - 3] + rtx * inv * lengths[i - 1];
+                positions[o + 1] = positions[o - 2] + rty * inv * lengths[i - 1];
+                positions[o + 2] = positions[o - 1] + rtz * inv * lengths[i - 1];
+            }
+            return 0;
+        }
+
+        const end = (n - 1) * 3;
+        let iter = 0;
+        for (; iter < iterations; iter++) {
+            const ex = positions[end] - tx, ey = positions[end + 1] - ty, ez = positions[end + 2] - tz;
+            if (Math.sqrt(ex * ex + ey * ey + ez * ez) < tolerance) {
+                break;
+            }
+
+            // Forward reaching phase
+            positions[end] = tx;
+            positions[end + 1] = ty;
+            positions[end + 2] = tz;
+            for (let i = n - 2; i >= 0; i--) {
+                this._placeAlong(positions, i * 3, (i + 1) * 3, lengths[i]);
+            }
+
+            // Backward reaching phase
+            positions[0] = rx;
+            positions[1] = ry;
+            positions[2] = rz;
+            for (let i = 0; i < n - 1; i++) {
+                this._placeAlong(positions, (i + 1) * 3, i * 3, lengths[i]);
+            }
+        }
+
+        return iter;
+    }
+
+    /**
+     * Allocation-free CCD on a flat joint buffer
+     * @param {Float32Array} positions - Interleaved x, y, z of each joint, root first; updated in place
+     * @param {Vector3D} targetPosition - Desired position for end effector
+     * @param {Number} iterations - Maximum iterations (default: 10)
+     * @param {Number} tolerance - Distance tolerance for convergence (default: 0.01)
+     * @param {Float32Array} quaternions - Optional x, y, z, w per joint from initBoneQuaternionsFlat;
+     *                                     every pivot's rotation is applied to the bones it turns
+     * @returns {Number} - Iterations used
+     */
+    static solveCCDFlat(positions, targetPosition, iterations = 10, tolerance = 0.01, quaternions = null) {
+        const n = positions.length / 3;
+        if (n < 2) {
+            throw new Error("Chain must have at least 2 joints");
+        }
+        if (n === 3) {
+            return this.solveTwoBoneFlat(positions, targetPosition, null, 0, 180, quaternions);
+        }
+        const tx = targetPosition.x, ty = targetPosition.y, tz = targetPosition.z;
+        const end = (n - 1) * 3;
+        const scratch = quaternions ? this._quaternionScratch(n) : null;
+
+        let iter = 0;
+        for (; iter < iterations; iter++) {
+            const ex = positions[end] - tx, ey = positions[end + 1] - ty, ez = positions[end + 2] - tz;
+            if (Math.sqrt(ex * ex + ey * ey + ez * ez) < tolerance) {
+                break;
+            }
+
+            for (let i = n - 2; i >= 0; i--) {
+                const o = i * 3;
+                const px = positions[o], py = positions[o + 1], pz = positions[o + 2];
+                const m = CCD_ROTATION;
+                m[0] = positions[end] - px; m[1] = positions[end + 1] - py; m[2] = positions[end + 2] - pz;
+                m[3] = tx - px; m[4] = ty - py; m[5] = tz - pz;
+                if (!this._ccdRotation(m, scratch !== null)) {
+                    continue;
+                }
+
+                // One rotation matrix per pivot, applied to every joint after i
+                for (let j = o + 3; j <= end; j += 3) {
+                    const vx = positions[j] - px, vy = positions[j + 1] - py, vz = positions[j + 2] - pz;
+                    positions[j] = px + m[0] * vx + m[1] * vy + m[2] * vz;
+                    positions[j + 1] = py + m[3] * vx + m[4] * vy + m[5] * vz;
+                    positions[j + 2] = pz + m[6] * vx + m[7] * vy + m[8] * vz;
+                }
+                if (scratch) {
+                    this._storePivotRotation(scratch, i, m);
+                }
+            }
+            if (scratch) {
+                this._applyCCDSweep(scratch, n, quaternions);
+            }
+        }
+
+        if (quaternions) {
+            this._normalizeBoneQuaternions(quaternions, n);
+        }
+        return iter;
+    }
+
+    /**
+     * Bone rotations for a flat joint buffer, same convention as calculateBoneRotations
+     * @param {Float32Array} positions - Interleaved x, y, z of each joint
+     * @param {Float32Array} rotations - Receives (pitch, yaw, roll) in degrees per joint; same length as positions
+     * @returns {Float32Array} - rotations
+     */
+    static calculateBoneRotationsFlat(positions, rotations) {
+        const n = positions.length / 3;
+        for (let i = 0; i < n - 1; i++) {
+            const o = i * 3;
+            let bx = positions[o + 3] - positions[o];
+            let by = positions[o + 4] - positions[o + 1];
+            let bz = positions[o + 5] - positions[o + 2];
+            const len = Math.sqrt(bx * bx + by * by + bz * bz);
+            if (len > 0) {
+                bx /= len; by /= len; bz /= len;
+            }
+            rotations[o] = Math.asin(Math.max(-1, Math.min(1, -by))) * (180 / Math.PI);
+            rotations[o + 1] = Math.atan2(bx, bz) * (180 / Math.PI);
+            rotations[o + 2] = 0;
+        }
+        if (n > 1) {
+            const last = (n - 1) * 3;
+            rotations[last] = rotations[last - 3];
+            rotations[last + 1] = rotations[last - 2];
+            rotations[last + 2] = rotations[last - 1];
+        }
+        return rotations;
+    }
+
+    /**
+     * Seed bone quaternions for the solvers: yaw about y, then pitch about x, no roll, i.e.
+     * the orientation calculateBoneRotations describes, rotating +z onto each bone. Built from
+     * half angles without trig. Seed once; the solvers then keep the quaternions current,
+     * twist included, so no Euler angles need re-deriving per frame.
+     * @param {Float32Array} positions - Interleaved x, y, z of each joint
+     * @param {Float32Array} quaternions - Receives x, y, z, w per joint; the last joint repeats the last bone
+     * @returns {Float32Array} - quaternions
+     */
+    static initBoneQuaternionsFlat(positions, quaternions) {
+        const n = positions.length / 3;
+        for (let i = 0; i < n - 1; i++) {
+            const o = i * 3;
+            let bx = positions[o + 3] - positions[o];
+            let by = positions[o + 4] - positions[o + 1];
+            let bz = positions[o + 5] - positions[o + 2];
+            const len = Math.sqrt(bx * bx + by * by + bz * bz);
+            if (len > 0) {
+                bx /= len; by /= len; bz /= len;
+            }
+            // cos/sin of yaw = atan2(x, z) and pitch = asin(-y)
+            const h = Math.sqrt(bx * bx + bz * bz);
+            const cy = h > 0 ? bz / h : 1, sy = h > 0 ? bx / h : 0;
+            const hcy = this._halfCos(cy, sy), hsy = this._halfSin(cy, sy);
+            const hcp = this._halfCos(h, -by), hsp = this._halfSin(h, -by);
+            const q = i * 4;
+            quaternions[q] = hcy * hsp;
+            quaternions[q + 1] = hsy * hcp;
+            quaternions[q + 2] = -hsy * hsp;
+            quaternions[q + 3] = hcy * hcp;
+        }
+        if (n > 1) {
+            quaternions.copyWithin((n - 1) * 4, (n - 2) * 4, (n - 1) * 4);
+        }
+        return quaternions;
+    }
+
+    /**
+     * Seed joint.quaternion on every joint of a chain (see initBoneQuaternionsFlat). Chains
+     * carrying quaternions get them updated by solveCCD / solveFABRIK / solveTwoBone in
+     * place of the Euler rebuild, so `rotation` is left as it was.
+     * @param {Array<Joint>} chain - Joint chain with positions; updated in place
+     * @returns {Array<Joint>} - chain
+     */
+    static initBoneQuaternions(chain) {
+        const scratch = this._quaternionScratch(chain.length);
+        this._packPositions(chain, scratch.positions);
+        this.initBoneQuaternionsFlat(scratch.positions.subarray(0, chain.length * 3), scratch.quaternions);
+        chain.forEach((joint, i) => {
+            joint.quaternion = new Quaternion(scratch.quaternions[i * 4], scratch.quaternions[i * 4 + 1],
+                scratch.quaternions[i * 4 + 2], scratch.quaternions[i * 4 + 3]);
+        });
+        return chain;
+    }
+
+    static _quaternionScratch(n) {
+        if (QUATERNION_SCRATCH.joints < n) {
+            QUATERNION_SCRATCH.joints = Math.max(n, 32);
+            const size = QUATERNION_SCRATCH.joints;
+            QUATERNION_SCRATCH.pivots = new Float64Array(size * 4);
+            QUATERNION_SCRATCH.isPivotRotated = new Uint8Array(size);
+            QUATERNION_SCRATCH.directions = new Float64Array(size * 3);
+            QUATERNION_SCRATCH.positions = new Float64Array(size * 3);
+            QUATERNION_SCRATCH.quaternions = new Float64Array(size * 4);
+        }
+        return QUATERNION_SCRATCH;
+    }
+
+    static _packPositions(chain, out) {
+        chain.forEach((joint, i) => {
+            out[i * 3] = joint.position.x;
+            out[i * 3 + 1] = joint.position.y;
+            out[i * 3 + 2] = joint.position.z;
+        });
+    }
+
+    static _storePivotRotation(scratch, i, m) {
+        const o = i * 4;
+        scratch.pivots[o] = m[9];
+        scratch.pivots[o + 1] = m[10];
+        scratch.pivots[o + 2] = m[11];
+        scratch.pivots[o + 3] = m[12];
+        scratch.isPivotRotated[i] = 1;
+    }
+
+    // Pivots run from the end back to the root, so over one sweep bone j turns by
+    // q0 * q1 * ... * qj; a running product applies the whole sweep in one pass
+    static _applyCCDSweep(scratch, n, quaternions) {
+        const pivots = scratch.pivots, isPivotRotated = scratch.isPivotRotated;
+        let sx = 0, sy = 0, sz = 0, sw = 1;
+        let isSweepRotated = false;
+        for (let j = 0; j < n - 1; j++) {
+            if (isPivotRotated[j]) {
+                const o = j * 4;
+                const px = pivots[o], py = pivots[o + 1], pz = pivots[o + 2], pw = pivots[o + 3];
+                const x = sw * px + sx * pw + sy * pz - sz * py;
+                const y = sw * py - sx * pz + sy * pw + sz * px;
+                const z = sw * pz + sx * py - sy * px + sz * pw;
+                sw = sw * pw - sx * px - sy * py - sz * pz;
+                sx = x; sy = y; sz = z;
+                isSweepRotated = true;
+                isPivotRotated[j] = 0;
+            }
+            if (isSweepRotated) {
+                // quaternions[j] = s * quaternions[j], inline: a helper taking four doubles boxes them per bone
+                const o = j * 4;
+                const bx = quaternions[o], by = quaternions[o + 1], bz = quaternions[o + 2], bw = quaternions[o + 3];
+                quaternions[o] = sw * bx + sx * bw + sy * bz - sz * by;
+                quaternions[o + 1] = sw * by - sx * bz + sy * bw + sz * bx;
+                quaternions[o + 2] = sw * bz + sx * by - sy * bx + sz * bw;
+                quaternions[o + 3] = sw * bw - sx * bx - sy * by - sz * bz;
+            }
+        }
+    }
+
+    // Products of unit quaternions drift slowly; renormalize once per solve. The last joint
+    // repeats the last bone
+    static _normalizeBoneQuaternions(quaternions, n) {
+        for (let j = 0; j < n - 1; j++) {
+            const o = j * 4;
+            const len = Math.sqrt(quaternions[o] * quaternions[o] + quaternions[o + 1] * quaternions[o + 1] +
+                quaternions[o + 2] * quaternions[o + 2] + quaternions[o + 3] * quaternions[o + 3]);
+            if (len > 0) {
+                quaternions[o] /= len; quaternions[o + 1] /= len; quaternions[o + 2] /= len; quaternions[o + 3] /= len;
+            }
+        }
+        quaternions.copyWithin((n - 1) * 4, (n - 2) * 4, (n - 1) * 4);
+    }
+
+    static _captureBoneDirections(positions, n, directions) {
+        for (let i = 0; i < n - 1; i++) {
+            const o = i * 3;
+            const dx = positions[o + 3] - positions[o];
+            const dy = positions[o + 4] - positions[o + 1];
+            const dz = positions[o + 5] - positions[o + 2];
+            const len = Math.sqrt(dx * dx + dy * dy + dz * dz) || 1;
+            directions[o] = dx / len;
+            directions[o + 1] = dy / len;
+            directions[o + 2] = dz / len;
+        }
+    }
+
+    // Turn every bone's quaternion by the shortest arc from its captured to its current direction
+    static _updateBoneQuaternions(directions, positions, n, quaternions) {
+        for (let i = 0; i < n - 1; i++) {
+            const o = i * 3;
+            let dx = positions[o + 3] - positions[o];
+            let dy = positions[o + 4] - positions[o + 1];
+            let dz = positions[o + 5] - positions[o + 2];
+            const len = Math.sqrt(dx * dx + dy * dy + dz * dz) || 1;
+            dx /= len; dy /= len; dz /= len;
+            const fx = directions[o], fy = directions[o + 1], fz = directions[o + 2];
+
+            let ax, ay, az;
+            let aw = 1 + fx * dx + fy * dy + fz * dz;
+            if (aw < 1e-6) {
+                // opposite directions: half a turn about any perpendicular axis
+                if (Math.abs(fx) < 0.9) { ax = 0; ay = -fz; az = fy; } else { ax = fz; ay = 0; az = -fx; }
+                aw = 0;
+            } else {
+                ax = fy * dz - fz * dy; ay = fz * dx - fx * dz; az = fx * dy - fy * dx;
+            }
+            const al = Math.sqrt(ax * ax + ay * ay + az * az + aw * aw);
+            ax /= al; ay /= al; az /= al; aw /= al;
+
+            // quaternions[i] = arc * quaternions[i], inline for the same reason as in _applyCCDSweep
+            const q = i * 4;
+            const bx = quaternions[q], by = quaternions[q + 1], bz = quaternions[q + 2], bw = quaternions[q + 3];
+            quaternions[q] = aw * bx + ax * bw + ay * bz - az * by;
+            quaternions[q + 1] = aw * by - ax * bz + ay * bw + az * bx;
+            quaternions[q + 2] = aw * bz + ax * by - ay * bx + az * bw;
+            quaternions[q + 3] = aw * bw - ax * bx - ay * by - az * bz;
+        }
+        this._normalizeBoneQuaternions(quaternions, n);
+    }
+
+    // Object-chain wrappers: joint.quaternion to and from the flat scratch
+    static _packQuaternions(chain, out) {
+        chain.forEach((joint, i) => {
+            out[i * 4] = joint.quaternion.x;
+            out[i * 4 + 1] = joint.quaternion.y;
+            out[i * 4 + 2] = joint.quaternion.z;
+            out[i * 4 + 3] = joint.quaternion.w;
+        });
+    }
+
+    static _unpackQuaternions(quaternions, chain) {
+        chain.forEach((joint, i) => {
+            joint.quaternion.set(quaternions[i * 4], quaternions[i * 4 + 1], quaternions[i * 4 + 2], quaternions[i * 4 + 3]);
+        });
+        return chain;
+    }
+
+    // Shortest-arc update of joint.quaternion against the directions captured before the solve
+    static _finishBoneQuaternions(scratch, chain) {
+        this._packPositions(chain, scratch.positions);
+        this._packQuaternions(chain, scratch.quaternions);
+        this._updateBoneQuaternions(scratch.directions, scratch.positions, chain.length, scratch.quaternions);
+        return this._unpackQuaternions(scratch.quaternions, chain);
+    }
+
+    static _isTrackingQuaternions(chain) {
+        return chain.every(joint => joint.quaternion !== null);
+    }
+
+    // Move joint `dst` to lie `length` away from joint `src`, along the src->dst direction
+    static _placeAlong(positions, dst, src, length) {
+        let dx = positions[dst] - positions[src];
+        let dy = positions[dst + 1] - positions[src + 1];
+        let dz = positions[dst + 2] - positions[src + 2];
+        const len = Math.sqrt(dx * dx + dy * dy + dz * dz);
+        const scale = len > 0 ? length / len : 0;
+        positions[dst] = positions[src] + dx * scale;
+        positions[dst + 1] = positions[src + 1] + dy * scale;
+        positions[dst + 2] = positions[src + 2] + dz * scale;
+    }
+
+    /**
+     * Scratch buffers for solveFABRIKBatch; allocate once and reuse every frame
+     * @param {Number} chainCount - Number of chains solved together
+     * @param {Number} jointCount - Joints per chain
+     * @returns {Object} - Scratch object
+     */
+    static createBatchScratch(chainCount, jointCount) {
+        return {
+            boneLengths: new Float32Array((jointCount - 1) * chainCount),
+            rootX: new Float32Array(chainCount),
+            rootY: new Float32Array(chainCount),
+            rootZ: new Float32Array(chainCount),
+            active: new Uint8Array(chainCount),
+            constrained: new Uint8Array(chainCount)
+        };
+    }
+
+    /**
+     * Joint limits for solveFABRIKBatch, laid out like the coordinates: five floats per joint
+     * and chain at (joint * chainCount + chain) * 5, holding minAngle, maxAngle (degrees) and
+     * the hinge axis x, y, z (all zero for a cone). Starts unlimited; fill it with
+     * setBatchChainLimits once per chain layout
+     * @param {Number} chainCount - Number of chains solved together
+     * @param {Number} jointCount - Joints per chain
+     * @returns {Float32Array}
+     */
+    static createBatchLimits(chainCount, jointCount) {
+        const limits = new Float32Array(chainCount * jointCount * 5);
+        for (let o = 0; o < limits.length; o += 5) {
+            limits[o] = -180;
+            limits[o + 1] = 180;
+        }
+        return limits;
+    }
+
+    /**
+     * Copy the limits of one chain's joints into a createBatchLimits buffer
+     * @param {Float32Array} limits - From createBatchLimits
+     * @param {Number} chainCount - Number of chains solved together
+     * @param {Number} chain - Chain to set
+     * @param {Array<Joint>} joints - The chain's joints (minAngle, maxAngle, hingeAxis)
+     */
+    static setBatchChainLimits(limits, chainCount, chain, joints) {
+        for (let i = 0; i < joints.length; i++) {
+            const o = (i * chainCount + chain) * 5, axis = joints[i].hingeAxis;
+            limits[o] = joints[i].minAngle;
+            limits[o + 1] = joints[i].maxAngle;
+            limits[o + 2] = axis ? axis.x : 0;
+            limits[o + 3] = axis ? axis.y : 0;
+            limits[o + 4] = axis ? axis.z : 0;
+        }
+    }
+
+    /**
+     * FABRIK over many equal-length chains in lockstep (struct-of-arrays layout)
+     *
+     * Coordinates are stored joint-major: xs[joint * chainCount + chain]. Each pass
+     * walks one joint index across every chain, so the inner loops are contiguous
+     * and free of per-chain branching apart from the convergence mask.
+     *
+     * @param {Float32Array} xs - X of every joint, updated in place
+     * @param {Float32Array} ys - Y of every joint, updated in place
+     * @param {Float32Array} zs - Z of every joint, updated in place
+     * @param {Number} chainCount - Number of chains
+     * @param {Float32Array} targets - Interleaved x, y, z target per chain
+     * @param {Number} iterations - Maximum iterations (default: 10)
+     * @param {Number} tolerance - Distance tolerance for convergence (default: 0.01)
+     * @param {Object} scratch - Optional result of createBatchScratch
+     * @param {Float32Array} limits - Optional joint limits from createBatchLimits, enforced inside
+     *                                both passes exactly as solveFABRIK does
+     * @returns {Number} - Iterations used by the slowest chain
+     */
+    static solveFABRIKBatch(xs, ys, zs, chainCount, targets, iterations = 10, tolerance = 0.01, scratch = null, limits = null) {
+        const n = xs.length / chainCount;
+        if (n < 2) {
+            throw new Error("Chain must have at least 2 joints");
+        }
+        const work = scratch || this.createBatchScratch(chainCount, n);
+        const lengths = work.boneLengths, active = work.active, constrained = work.constrained;
+        const rootX = work.rootX, rootY = work.rootY, rootZ = work.rootZ;
+        const endBase = (n - 1) * chainCount;
+
+        // Same test as hasConstraints, per chain; unlimited chains keep the plain passes
+        let anyConstrained = false;
+        for (let c = 0; c < chainCount; c++) {
+            constrained[c] = 0;
+            for (let i = 1; limits && i < n - 1; i++) {
+                const o = (i * chainCount + c) * 5;
+                if (limits[o + 2] !== 0 || limits[o + 3] !== 0 || limits[o + 4] !== 0 ||
+                    limits[o] > 0 || Math.max(-limits[o], limits[o + 1]) < 180) {
+                    constrained[c] = 1;
+                    anyConstrained = true;
+                    break;
+                }
+            }
+        }
+
+        let activeCount = 0;
+        for (let c = 0; c < chainCount; c++) {
+            let total = 0;
+            for (let i = 0; i < n - 1; i++) {
+                const a = i * chainCount + c, b = a + chainCount;
+                const dx = xs[b] - xs[a], dy = ys[b] - ys[a], dz = zs[b] - zs[a];
+                const len = Math.sqrt(dx * dx + dy * dy + dz * dz);
+                lengths[i * chainCount + c] = len;
+                total += len;
+            }
+            rootX[c] = xs[c];
+            rootY[c] = ys[c];
+            rootZ[c] = zs[c];
+
+            const tx = targets[c * 3] - xs[c], ty = targets[c * 3 + 1] - ys[c], tz = targets[c * 3 + 2] - zs[c];
+            const dist = Math.sqrt(tx * tx + ty * ty + tz * tz);
+            if (dist > total) {
+                // Unreachable: stretch towards the target and leave the chain out of the iterations
+                const inv = dist > 0 ? 1 / dist : 0;
+                for (let i = 1; i < n; i++) {
+                    const j = i * chainCount + c, p = j - chainCount, l = lengths[(i - 1) * chainCount + c] * inv;
+                    xs[j] = xs[p] + tx * l;
+                    ys[j] = ys[p] + ty * l;
+                    zs[j] = zs[p] + tz * l;
+                }
+                active[c] = 0;
+            } else {
+                active[c] = 1;
+                activeCount++;
+            }
+        }
+
+        let iter = 0;
+        for (; iter < iterations && activeCount > 0; iter++) {
+            // Convergence mask
+            for (let c = 0; c < chainCount; c++) {
+                if (!active[c]) continue;
+                const e = endBase + c;
+                const dx = xs[e] - targets[c * 3], dy = ys[e] - targets[c * 3 + 1], dz = zs[e] - targets[c * 3 + 2];
+                if (Math.sqrt(dx * dx + dy * dy + dz * dz) < tolerance) {
+                    active[c] = 0;
+                    activeCount--;
+                }
+            }
+            if (activeCount === 0) break;
+
+            // Forward reaching phase
+            for (let c = 0; c < chainCount; c++) {
+                if (!active[c]) continue;
+                xs[endBase + c] = targets[c * 3];
+                ys[endBase + c] = targets[c * 3 + 1];
+                zs[endBase + c] = targets[c * 3 + 2];
+            }
+            for (let i = n - 2; i >= 0; i--) {
+                const row = i * chainCount;
+                for (let c = 0; c < chainCount; c++) {
+                    if (!active[c]) continue;
+                    if (anyConstrained && constrained[c] && i + 2 < n) {
+                        // Bone i enters joint i + 1, whose outgoing bone is already placed
+                        this._placeConstrainedSoA(xs, ys, zs, row + c, row + chainCount + c, row + 2 * chainCount + c,
+                            lengths[row + c], limits, true);
+                    } else {
+                        this._placeAlongSoA(xs, ys, zs, row + c, row + chainCount + c, lengths[row + c]);
+                    }
+                }
+            }
+
+            // Backward reaching phase
+            for (let c = 0; c < chainCount; c++) {
+                if (!active[c]) continue;
+                xs[c] = rootX[c];
+                ys[c] = rootY[c];
+                zs[c] = rootZ[c];
+            }
+            for (let i = 0; i < n - 1; i++) {
+                const row = i * chainCount;
+                for (let c = 0; c < chainCount; c++) {
+                    if (!active[c]) continue;
+                    if (anyConstrained && constrained[c] && i > 0) {
+                        this._placeConstrainedSoA(xs, ys, zs, row + chainCount + c, row + c, row - chainCount + c,
+                            lengths[row + c], limits, false);
+                    } else {
+                        this._placeAlongSoA(xs, ys, zs, row + chainCount + c, row + c, lengths[row + c]);
+                    }
+                }
+            }
+        }
+
+        return iter;
+    }
+
+    static _placeAlongSoA(xs, ys, zs, dst, src, length) {
+        const dx = xs[dst] - xs[src], dy = ys[dst] - ys[src], dz = zs[dst] - zs[src];
+        const len = Math.sqrt(dx * dx + dy * dy + dz * dz);
+        const scale = len > 0 ? length / len : 0;
+        xs[dst] = xs[src] + dx * scale;
+        ys[dst] = ys[src] + dy * scale;
+        zs[dst] = zs[src] + dz * scale;
+    }
+
+    /**
+     * _placeAlongSoA with the bend at src limited as constrainDirection does. other is the
+     * joint across src from dst, so the fixed bone is src - other (backward pass, limits of
+     * src) or other - src (forward pass, reverse, limits of src as well)
+     */
+    static _placeConstrainedSoA(xs, ys, zs, dst, src, other, length, limits, reverse) {
+        let dx = xs[dst] - xs[src], dy = ys[dst] - ys[src], dz = zs[dst] - zs[src];
+        let len = Math.sqrt(dx * dx + dy * dy + dz * dz);
+        let inv = len > 0 ? 1 / len : 0;
+        dx *= inv; dy *= inv; dz *= inv;
+        let px = xs[src] - xs[other], py = ys[src] - ys[other], pz = zs[src] - zs[other];
+        if (reverse) {
+            // previous is the outgoing bone (src towards other), direction the incoming one
+            px = -px; py = -py; pz = -pz;
+            dx = -dx; dy = -dy; dz = -dz;
+        }
+        len = Math.sqrt(px * px + py * py + pz * pz);
+        inv = len > 0 ? 1 / len : 0;
+        const out = BATCH_DIRECTION;
+        this._constrainDirectionScalar(px * inv, py * inv, pz * inv, dx, dy, dz, limits, src * 5, reverse, out);
+        const sign = reverse ? -length : length;
+        xs[dst] = xs[src] + out[0] * sign;
+        ys[dst] = ys[src] + out[1] * sign;
+        zs[dst] = zs[src] + out[2] * sign;
+    }
+
+    /**
+     * constrainDirection on plain numbers, for the batch solver; writes the unit result to out
+     * @param {Float32Array} limits - createBatchLimits buffer; o is the joint's first float
+     */
+    static _constrainDirectionScalar(px, py, pz, dx, dy, dz, limits, o, reverse, out) {
+        const toRadians = Math.PI / 180;
+        const minAngle = limits[o], maxAngle = limits[o + 1];
+        let ax = limits[o + 2], ay = limits[o + 3], az = limits[o + 4];
+        const axisLength = Math.sqrt(ax * ax + ay * ay + az * az);
+        if (axisLength > 0) {
+            ax /= axisLength; ay /= axisLength; az /= axisLength;
+            const ap = ax * px + ay * py + az * pz, ad = ax * dx + ay * dy + az * dz;
+            let qx = px - ax * ap, qy = py - ay * ap, qz = pz - az * ap;
+            let ex = dx - ax * ad, ey = dy - ay * ad, ez = dz - az * ad;
+            const q = Math.sqrt(qx * qx + qy * qy + qz * qz);
+            if (q < 1e-9) {
+                out[0] = dx; out[1] = dy; out[2] = dz;
+                return;
+            }
+            let e = Math.sqrt(ex * ex + ey * ey + ez * ez);
+            if (e < 1e-9) {
+                ex = qx; ey = qy; ez = qz; e = q;
+            }
+            qx /= q; qy /= q; qz /= q;
+            ex /= e; ey /= e; ez /= e;
+            const cx = qy * ez - qz * ey, cy = qz * ex - qx * ez, cz = qx * ey - qy * ex;
+            const angle = Math.atan2(ax * cx + ay * cy + az * cz, qx * ex + qy * ey + qz * ez) / toRadians;
+            const lo = reverse ? -maxAngle : minAngle;
+            const hi = reverse ? -minAngle : maxAngle;
+            const clamped = Math.max(lo, Math.min(hi, angle)) * toRadians;
+            // q is normal to the axis, so Rodrigues reduces to q cos + (axis x q) sin
+            const cos = Math.cos(clamped), sin = Math.sin(clamped);
+            let rx = qx * cos + (ay * qz - az * qy) * sin;
+            let ry = qy * cos + (az * qx - ax * qz) * sin;
+            let rz = qz * cos + (ax * qy - ay * qx) * sin;
+            const r = Math.sqrt(rx * rx + ry * ry + rz * rz) || 1;
+            out[0] = rx / r; out[1] = ry / r; out[2] = rz / r;
+            return;
+        }
+
+        const lo = Math.max(0, minAngle);
+        const hi = Math.min(180, Math.max(-minAngle, maxAngle));
+        const dot = px * dx + py * dy + pz * dz;
+        const angle = Math.acos(Math.max(-1, Math.min(1, dot))) / toRadians;
+        if (angle >= lo && angle <= hi) {
+            out[0] = dx; out[1] = dy; out[2] = dz;
+            return;
+        }
+        let sx = dx - px * dot, sy = dy - py * dot, sz = dz - pz * dot;
+        let side = Math.sqrt(sx * sx + sy * sy + sz * sz);
+        if (side < 1e-9) {
+            if (Math.abs(px) < 0.9) {
+                sx = 0; sy = -pz; sz = py;
+            } else {
+                sx = pz; sy = 0; sz = -px;
+            }
+            side = Math.sqrt(sx * sx + sy * sy + sz * sz);
+        }
+        sx /= side; sy /= side; sz /= side;
+        const clamped = Math.max(lo, Math.min(hi, angle)) * toRadians;
+        const cos = Math.cos(clamped), sin = Math.sin(clamped);
+        out[0] = px * cos + sx * sin;
+        out[1] = py * cos + sy * sin;
+        out[2] = pz * cos + sz * sin;
+    }
+
+    /**
+     * Topology and buffers for solveDLS; build once per skeleton and reuse every frame
+     * @param {Array<Number>} parents - Parent index of each joint, -1 for the root; every
+     *                                  joint must come after its parent
+     * @param {Array<Number>} effectors - Joint indices that have a target
+     * @returns {Object} - Scratch object
+     */
+    static createDLSScratch(parents, effectors) {
+        const n = parents.length, m = effectors.length;
+        for (let i = 0; i < n; i++) {
+            if (parents[i] >= i) {
+                throw new Error("Every joint must come after its parent");
+            }
+        }
+
+        // Only ancestors of an effector move it, so each joint keeps the effectors below it;
+        // every other Jacobian entry is zero and never touched
+        const effectorsBelow = [];
+        const descendants = [];
+        for (let j = 0; j < n; j++) {
+            effectorsBelow.push([]);
+            descendants.push([]);
+        }
+        for (let k = 0; k < m; k++) {
+            for (let j = parents[effectors[k]]; j >= 0; j = parents[j]) {
+                effectorsBelow[j].push(k);
+            }
+        }
+        for (let i = 0; i < n; i++) {
+            for (let j = parents[i]; j >= 0; j = parents[j]) {
+                descendants[j].push(i);
+            }
+        }
+
+        return {
+            parents: parents,
+            effectors: effectors,
+            effectorsBelow: effectorsBelow,
+            descendants: descendants,
+            offsets: new Float64Array(m * 3),
+            error: new Float64Array(m * 3),
+            system: new Float64Array(m * 3 * m * 3),
+            omega: new Float64Array(n * 3)
+        };
+    }
+
+    /**
+     * Damped least-squares IK for a tree with several end effectors (e.g. a whole hand)
+     *
+     * All effectors are solved together, so joints shared by several fingers (the wrist)
+     * move once for all of them instead of being fought over by per-finger solves.
+     * Each joint rotates freely about its position; bone lengths are preserved and the
+     * root stays in place. Per iteration the 3m x 3m system (J J^T + damping^2 I) y = e
+     * is built only from the joints that actually move each effector pair, and the joint
+     * updates are J^T y.
+     *
+     * @param {Float32Array} positions - Interleaved x, y, z of each joint; updated in place
+     * @param {Array<Number>} parents - Parent index of each joint, -1 for the root
+     * @param {Array<Number>} effectors - Joint indices that have a target
+     * @param {Array<Vector3D>} targets - One target per effector
+     * @param {Number} iterations - Maximum iterations (default: 20)
+     * @param {Number} tolerance - Largest remaining effector distance that counts as converged (default: 0.01)
+     * @param {Number} damping - Damping relative to the mean bone length; larger is more stable near
+     *                           singular poses, smaller converges faster (default: 0.1)
+     * @param {Object} scratch - Optional result of createDLSScratch for the same parents/effectors
+     * @returns {Number} - Iterations used
+     */
+    static solveDLS(positions, parents, effectors, targets, iterations = 20, tolerance = 0.01, damping = 0.1, scratch = null) {
+        const work = scratch || this.createDLSScratch(parents, effectors);
+        const n = parents.length, m = effectors.length, size = m * 3;
+        const e = work.error, A = work.system, r = work.offsets, w = work.omega;
+
+        // Damping is given relative to the mean bone length so the same value works for
+        // normalised landmarks and for pixel coordinates
+        let boneSum = 0;
+        for (let i = 0; i < n; i++) {
+            if (parents[i] >= 0) {
+                const o = i * 3, q = parents[i] * 3;
+                const dx = positions[o] - positions[q], dy = positions[o + 1] - positions[q + 1], dz = positions[o + 2] - positions[q + 2];
+                boneSum += Math.sqrt(dx * dx + dy * dy + dz * dz);
+            }
+        }
+        const scale = n > 1 ? boneSum / (n - 1) : 1;
+        const lambda2 = damping * damping * scale * scale;
+
+        let iter = 0;
+        for (; iter < iterations; iter++) {
+            let worst = 0;
+            for (let k = 0; k < m; k++) {
+                const o = effectors[k] * 3;
+                e[k * 3] = targets[k].x - positions[o];
+                e[k * 3 + 1] = targets[k].y - positions[o + 1];
+                e[k * 3 + 2] = targets[k].z - positions[o + 2];
+                worst = Math.max(worst, Math.sqrt(e[k * 3] * e[k * 3] + e[k * 3 + 1] * e[k * 3 + 1] + e[k * 3 + 2] * e[k * 3 + 2]));
+            }
+            if (worst < tolerance) {
+                break;
+            }
+
+            // J J^T: a free rotation at joint j contributes (r_a . r_b) I - r_b r_a^T to block (a, b),
+            // where r is the offset from joint j to each effector below it
+            A.fill(0);
+            for (let i = 0; i < size; i++) {
+                A[i * size + i] = lambda2;
+            }
+            for (let j = 0; j < n; j++) {
+                const below = work.effectorsBelow[j];
+                if (below.length === 0) {
+                    continue;
+                }
+                this._effectorOffsets(positions, j, below, effectors, r);
+                for (let a = 0; a < below.length; a++) {
+                    for (let b = 0; b < below.length; b++) {
+                        const ax = r[a * 3], ay = r[a * 3 + 1], az = r[a * 3 + 2];
+                        const bx = r[b * 3], by = r[b * 3 + 1], bz = r[b * 3 + 2];
+                        const d = ax * bx + ay * by + az * bz;
+                        const row = below[a] * 3, col = below[b] * 3;
+                        A[row * size + col] += d - bx * ax;
+                        A[row * size + col + 1] -= bx * ay;
+                        A[row * size + col + 2] -= bx * az;
+                        A[(row + 1) * size + col] -= by * ax;
+                        A[(row + 1) * size + col + 1] += d - by * ay;
+                        A[(row + 1) * size + col + 2] -= by * az;
+                        A[(row + 2) * size + col] -= bz * ax;
+                        A[(row + 2) * size + col + 1] -= bz * ay;
+                        A[(row + 2) * size + col + 2] += d - bz * az;
+                    }
+                }
+            }
+
+            // The damped system is symmetric positive definite; e becomes y
+            this._choleskySolve(A, e, size);
+
+            // Joint updates J^T y: a joint's rotation vector is the sum of r x y over its effectors
+            let largest = 0;
+            for (let j = 0; j < n; j++) {
+                const below = work.effectorsBelow[j];
+                const o = j * 3;
+                w[o] = 0; w[o + 1] = 0; w[o + 2] = 0;
+                if (below.length === 0) {
+                    continue;
+                }
+                this._effectorOffsets(positions, j, below, effectors, r);
+                for (let a = 0; a < below.length; a++) {
+                    const ax = r[a * 3], ay = r[a * 3 + 1], az = r[a * 3 + 2];
+                    const y = below[a] * 3;
+                    w[o] += ay * e[y + 2] - az * e[y + 1];
+                    w[o + 1] += az * e[y] - ax * e[y + 2];
+                    w[o + 2] += ax * e[y + 1] - ay * e[y];
+                }
+                largest = Math.max(largest, Math.sqrt(w[o] * w[o] + w[o + 1] * w[o + 1] + w[o + 2] * w[o + 2]));
+            }
+
+            // Large steps leave the linear model; scale the whole step down so no joint turns
+            // more than DLS_MAX_STEP, which keeps the direction of the update
+            const stepScale = largest > this.DLS_MAX_STEP ? this.DLS_MAX_STEP / largest : 1;
+
+            // Children first, so every joint rotates its subtree from the pose the Jacobian saw
+            for (let j = n - 1; j >= 0; j--) {
+                if (work.effectorsBelow[j].length > 0) {
+                    this._rotateSubtree(positions, j, work.descendants[j], w, j * 3, stepScale);
+                }
+            }
+        }
+
+        return iter;
+    }
+
+    static get DLS_MAX_STEP() {
+        return 0.25; // radians per joint per iteration
+    }
+
+    // Offsets from joint j to each effector below it, packed in below-order
+    static _effectorOffsets(positions, j, below, effectors, out) {
+        const o = j * 3;
+        for (let a = 0; a < below.length; a++) {
+            const p = effectors[below[a]] * 3;
+            out[a * 3] = positions[p] - positions[o];
+            out[a * 3 + 1] = positions[p + 1] - positions[o + 1];
+            out[a * 3 + 2] = positions[p + 2] - positions[o + 2];
+        }
+    }
+
+    // In-place Cholesky factorisation of the size x size matrix A, then solve A x = b into b
+    static _choleskySolve(A, b, size) {
+        for (let i = 0; i < size; i++) {
+            for (let k = 0; k <= i; k++) {
+                let sum = A[i * size + k];
+                for (let p = 0; p < k; p++) {
+                    sum -= A[i * size + p] * A[k * size + p];
+                }
+                A[i * size + k] = i === k ? Math.sqrt(Math.max(sum, 1e-12)) : sum / A[k * size + k];
+            }
+        }
+        for (let i = 0; i < size; i++) {
+            let sum = b[i];
+            for (let p = 0; p < i; p++) {
+                sum -= A[i * size + p] * b[p];
+            }
+            b[i] = sum / A[i * size + i];
+        }
+        for (let i = size - 1; i >= 0; i--) {
+            let sum = b[i];
+            for (let p = i + 1; p < size; p++) {
+                sum -= A[p * size + i] * b[p];
+            }
+            b[i] = sum / A[i * size + i];
+        }
+    }
+
+    // Rotate every descendant of joint j about it by scale times the rotation vector at w[offset] (axis * angle, radians)
+    static _rotateSubtree(positions, j, descendants, w, offset, scale) {
+        const wx = w[offset] * scale, wy = w[offset + 1] * scale, wz = w[offset + 2] * scale;
+        const angle = Math.sqrt(wx * wx + wy * wy + wz * wz);
+        if (angle < 1e-9) {
+            return;
+        }
+        const kx = wx / angle, ky = wy / angle, kz = wz / angle;
+        const c = Math.cos(angle), s = Math.sin(angle), t = 1 - c;
+        const o = j * 3;
+        const px = positions[o], py = positions[o + 1], pz = positions[o + 2];
+        for (const d of descendants) {
+            const q = d * 3;
+            const vx = positions[q] - px, vy = positions[q + 1] - py, vz = positions[q + 2] - pz;
+            const kv = kx * vx + ky * vy + kz * vz;
+            // Rodrigues' rotation formula
+            positions[q] = px + vx * c + (ky * vz - kz * vy) * s + kx * kv * t;
+            positions[q + 1] = py + vy * c + (kz * vx - kx * vz) * s + ky * kv * t;
+            positions[q + 2] = pz + vz * c + (kx * vy - ky * vx) * s + kz * kv * t;
+        }
+    }
+
     /**
      * Helper function to create a finger chain (5 joints typical for fingers)
      * @param {Vector3D} basePosition - Starting position of finger
@@ -362,7 +1653,131 @@ class IKSolver {
     }
 }
 
+/**
+ * Stateful solver that warm-starts each chain from its previous solution
+ *
+ * Landmarks move little between frames, so starting the iteration from last
+ * frame's pose (re-rooted at the current root, with the current bone lengths)
+ * usually converges in one or two iterations instead of the full budget.
+ * Chains are keyed by an id chosen by the caller, e.g. 'left-index'.
+ */
+class IKSolverState {
+    /**
+     * @param {String} algorithm - 'fabrik' or 'ccd' (default: 'fabrik')
+     * @param {Number} iterations - Maximum iterations per solve (default: 10)
+     * @param {Number} tolerance - Distance tolerance for convergence (default: 0.01)
+     */
+    constructor(algorithm = 'fabrik', iterations = 10, tolerance = 0.01) {
+        this.algorithm = algorithm;
+        this.iterations = iterations;
+        this.tolerance = tolerance;
+        this.lastIterations = 0;
+        this._previous = new Map();
+        this._boneLengths = new Map();
+    }
+
+    /**
+     * Solve a flat chain in place, seeded from the previous solution of the same chain
+     * @param {*} chainId - Key identifying the chain across frames
+     * @param {Float32Array} positions - Interleaved x, y, z of each joint, root first
+     * @param {Vector3D} targetPosition - Desired position for end effector
+     * @returns {Number} - Iterations used (also stored in lastIterations)
+     */
+    solve(chainId, positions, targetPosition) {
+        let previous = this._previous.get(chainId);
+        if (previous && previous.length === positions.length) {
+            this._seedFromPrevious(positions, previous);
+        } else {
+            previous = new Float32Array(positions.length);
+            this._previous.set(chainId, previous);
+        }
+
+        if (this.algorithm === 'ccd') {
+            this.lastIterations = IKSolver.solveCCDFlat(positions, targetPosition, this.iterations, this.tolerance);
+        } else {
+            let lengths = this._boneLengths.get(chainId);
+            if (!lengths || lengths.length !== positions.length / 3 - 1) {
+                lengths = new Float32Array(positions.length / 3 - 1);
+                this._boneLengths.set(chainId, lengths);
+            }
+            this.lastIterations = IKSolver.solveFABRIKFlat(positions, targetPosition, this.iterations, this.tolerance, lengths);
+        }
+
+        previous.set(positions);
+        return this.lastIterations;
+    }
+
+    /**
+     * Joint-array convenience wrapper around solve()
+     * @param {*} chainId - Key identifying the chain across frames
+     * @param {Array<Joint>} chain - Array of joints from root to end effector
+     * @param {Vector3D} targetPosition - Desired position for end effector
+     * @returns {Array<Joint>} - Solved chain with rotations
+     */
+    solveChain(chainId, chain, targetPosition) {
+        const positions = new Float32Array(chain.length * 3);
+        chain.forEach((joint, i) => {
+            positions[i * 3] = joint.position.x;
+            positions[i * 3 + 1] = joint.position.y;
+            positions[i * 3 + 2] = joint.position.z;
+        });
+        this.solve(chainId, positions, targetPosition);
+
+        const solved = chain.map((joint, i) => {
+            const j = joint.clone();
+            j.position.set(positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2]);
+            return j;
+        });
+        return IKSolver.calculateBoneRotations(solved);
+    }
+
+    /**
+     * Forget the stored solution of one chain, or of all chains when no id is given
+     * @param {*} chainId - Optional chain key
+     */
+    reset(chainId) {
+        if (chainId === undefined) {
+            this._previous.clear();
+            this._boneLengths.clear();
+        } else {
+            this._previous.delete(chainId);
+            this._boneLengths.delete(chainId);
+        }
+    }
+
+    // Keep the current root and bone lengths, but take each bone's direction from the previous solution
+    _seedFromPrevious(positions, previous) {
+        const n = positions.length / 3;
+        // o*: original position of the previous joint, s*: where it was seeded
+        let ox = positions[0], oy = positions[1], oz = positions[2];
+        let sx = ox, sy = oy, sz = oz;
+        for (let i = 1; i < n; i++) {
+            const o = i * 3;
+            const cx = positions[o], cy = positions[o + 1], cz = positions[o + 2];
+            const bx = cx - ox, by = cy - oy, bz = cz - oz;
+            const length = Math.sqrt(bx * bx + by * by + bz * bz);
+            const dx = previous[o] - previous[o - 3], dy = previous[o + 1] - previous[o - 2], dz = previous[o + 2] - previous[o - 1];
+            const d = Math.sqrt(dx * dx + dy * dy + dz * dz);
+            if (d > 0) {
+                sx += dx / d * length;
+                sy += dy / d * length;
+                sz += dz / d * length;
+            } else {
+                sx += bx;
+                sy += by;
+                sz += bz;
+            }
+            positions[o] = sx;
+            positions[o + 1] = sy;
+            positions[o + 2] = sz;
+            ox = cx;
+            oy = cy;
+            oz = cz;
+        }
+    }
+}
+
 // Export for use in Node.js or browser
 if (typeof module !== 'undefined' && module.exports) {
-    module.exports = { IKSolver, Vector3D, Joint };
+    module.exports = { IKSolver, IKSolverState, Vector3D, Quaternion, Joint, MediaPipeHandParents };
 }
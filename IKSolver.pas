@@ -15,7 +15,7 @@ unit IKSolver;
 interface
 
 uses
-  System.SysUtils, System.Math;
+  System.SysUtils, System.Math, System.Generics.Collections;
 
 type
   TVector3D = record
@@ -38,31 +38,150 @@ type
     Rotation: TVector3D;  // Euler angles in degrees (X=pitch, Y=yaw, Z=roll)
     MinAngle: Double;  // Constraint in degrees
     MaxAngle: Double;  // Constraint in degrees
+    HingeAxis: TVector3D;  // World-space bend axis; zero limits the bend as a cone instead
     class function Create(const APosition: TVector3D; AMinAngle: Double = -180; AMaxAngle: Double = 180): TJoint; static;
   end;
 
   TJointArray = array of TJoint;
 
+const
+  { Parent of each of the 21 MediaPipe hand landmarks (-1 for the wrist), for SolveDLS }
+  MediaPipeHandParents: array[0..20] of Integer =
+    (-1, 0, 1, 2, 3, 0, 5, 6, 7, 0, 9, 10, 11, 0, 13, 14, 15, 0, 17, 18, 19);
+
+  { Longest chain the in-place and flat solvers accept (matches the native solver) }
+  IKMaxChainJoints = 32;
+
+  { Largest joint rotation, in radians, SolveDLS takes in one iteration }
+  DLSMaxStep = 0.25;
+
+  { cos(0.001): CCD skips pivots whose correction is below a milliradian }
+  CosMinCCDAngle = 0.9999995;
+
+  { SolveChains stays on the calling thread below this many joint iterations (joints
+    times Iterations, summed over the chains); a handful of fingers is cheaper to solve
+    than to hand to the task pool }
+  ParallelChainsMinWork = 2000;
+
+type
+  { Row-major 3x3 rotation, built once per CCD pivot }
+  TRotationMatrix3 = array[0..8] of Double;
+  { Quaternion as X, Y, Z, W }
+  TQuaternion4 = array[0..3] of Double;
+
   TIKSolver = class
   private
     class function RotateAroundAxis(const Vector, Axis: TVector3D; Angle: Double): TVector3D;
+    { Rotation taking direction A onto direction B; False when the angle is below a
+      milliradian or undefined }
+    class function CCDRotation(AX, AY, AZ, BX, BY, BZ: Double; out M: TRotationMatrix3): Boolean;
+    { Cos and sin of half the angle with cosine C and sine S, without trig }
+    class procedure HalfAngle(C, S: Double; out HalfCos, HalfSin: Double);
+    { Q[O..O+3] := A * Q[O..O+3] }
+    class procedure PremultiplyQuaternion(var Q: array of Single; O: Integer; const A: TQuaternion4);
+    class procedure NormalizeBoneQuaternions(var Q: array of Single; N: Integer);
+    class procedure SolveChainAt(const Chains: TArray<TJointArray>; const Targets: TArray<TVector3D>;
+      UseCCD: Boolean; Iterations: Integer; Tolerance: Double; const IterationsUsed: TArray<Integer>;
+      Index: Integer);
   public
     { Solve IK using CCD (Cyclic Coordinate Descent) algorithm }
     class function SolveCCD(const Chain: TJointArray; const TargetPosition: TVector3D;
-      Iterations: Integer = 10; Tolerance: Double = 0.01): TJointArray;
+      Iterations: Integer = 10; Tolerance: Double = 0.01): TJointArray; overload;
+    class function SolveCCD(const Chain: TJointArray; const TargetPosition: TVector3D;
+      Iterations: Integer; Tolerance: Double; out IterationsUsed: Integer): TJointArray; overload;
     
     { Solve IK using FABRIK (Forward And Backward Reaching Inverse Kinematics) algorithm }
     class function SolveFABRIK(const Chain: TJointArray; const TargetPosition: TVector3D;
-      Iterations: Integer = 10; Tolerance: Double = 0.01): TJointArray;
+      Iterations: Integer = 10; Tolerance: Double = 0.01): TJointArray; overload;
+    class function SolveFABRIK(const Chain: TJointArray; const TargetPosition: TVector3D;
+      Iterations: Integer; Tolerance: Double; out IterationsUsed: Integer): TJointArray; overload;
+
+    { In-place variants for per-frame use: they update a caller-owned joint buffer
+      (dynamic or static array) and allocate nothing. Chains are limited to
+      IKMaxChainJoints joints; the TJointArray functions above wrap these. }
+    class procedure SolveCCDInPlace(var Chain: array of TJoint; const TargetPosition: TVector3D;
+      Iterations: Integer; Tolerance: Double; out IterationsUsed: Integer);
+    class procedure SolveFABRIKInPlace(var Chain: array of TJoint; const TargetPosition: TVector3D;
+      Iterations: Integer; Tolerance: Double; out IterationsUsed: Integer);
+    class procedure SolveTwoBoneInPlace(var Chain: array of TJoint; const TargetPosition, PoleTarget: TVector3D);
+    class procedure CalculateBoneRotationsInPlace(var Chain: array of TJoint);
+    class procedure ApplyConstraintsInPlace(var Chain: array of TJoint);
+
+    { Single-precision FABRIK/CCD on a flat buffer of interleaved X, Y, Z per joint
+      (root first), updated in place without allocating. Returns the iterations used. }
+    class function SolveFABRIKFlat(var Positions: array of Single; const TargetPosition: TVector3D;
+      Iterations: Integer = 10; Tolerance: Single = 0.01): Integer; overload;
+    class function SolveCCDFlat(var Positions: array of Single; const TargetPosition: TVector3D;
+      Iterations: Integer = 10; Tolerance: Single = 0.01): Integer; overload;
+    { Same angles as CalculateBoneRotations: (pitch, yaw, roll) in degrees per joint }
+    class procedure CalculateBoneRotationsFlat(const Positions: array of Single; var Rotations: array of Single);
+
+    { Bone orientations as quaternions (X, Y, Z, W per joint) kept current by the flat
+      solvers instead of Euler angles re-derived after every solve. Seed once with
+      InitBoneQuaternionsFlat: yaw about Y, then pitch about X, no roll, i.e. the
+      orientation CalculateBoneRotationsFlat describes, built from half angles. CCD then
+      applies every pivot's rotation to the bones it turns, so twist accumulates; FABRIK
+      turns each bone by the shortest arc to its new direction. The last joint repeats
+      the last bone. }
+    class procedure InitBoneQuaternionsFlat(const Positions: array of Single; var Quaternions: array of Single);
+    class function SolveFABRIKFlat(var Positions: array of Single; const TargetPosition: TVector3D;
+      Iterations: Integer; Tolerance: Single; var Quaternions: array of Single): Integer; overload;
+    class function SolveCCDFlat(var Positions: array of Single; const TargetPosition: TVector3D;
+      Iterations: Integer; Tolerance: Single; var Quaternions: array of Single): Integer; overload;
+
+    { Closed-form two-bone IK (law of cosines) for shoulder-elbow-wrist chains.
+      The middle joint bends towards PoleTarget, or towards its current position.
+      SolveCCD and SolveFABRIK use this automatically for 3-joint chains. }
+    class function SolveTwoBone(const Chain: TJointArray; const TargetPosition: TVector3D): TJointArray; overload;
+    class function SolveTwoBone(const Chain: TJointArray; const TargetPosition, PoleTarget: TVector3D): TJointArray; overload;
+
+    { FABRIK over ChainCount equal-length chains in lockstep. Xs/Ys/Zs are joint-major
+      struct-of-arrays (Xs[Joint * ChainCount + Chain]) and are updated in place.
+      Returns the iterations used by the slowest chain. }
+    class function SolveFABRIKBatch(var Xs, Ys, Zs: TArray<Double>; ChainCount: Integer;
+      const Targets: array of TVector3D; Iterations: Integer = 10; Tolerance: Double = 0.01): Integer;
+
+    { Solves Chains[I] towards Targets[I] for every I with SolveCCDInPlace (UseCCD) or
+      SolveFABRIKInPlace, updating the chains in place; IterationsUsed, when not nil,
+      receives each chain's iteration count. Above ParallelChainsMinWork the chains are
+      spread over the System.Threading task pool, so every chain must be its own array:
+      two entries sharing one TJointArray would be solved concurrently. }
+    class procedure SolveChains(const Chains: TArray<TJointArray>; const Targets: TArray<TVector3D>;
+      UseCCD: Boolean; Iterations: Integer; Tolerance: Double; const IterationsUsed: TArray<Integer>);
     
+    { Damped least-squares IK for a joint tree with several end effectors, e.g. the
+      21 MediaPipe hand landmarks with all five fingertips as effectors (see
+      MediaPipeHandParents). Parents[I] is the parent of joint I (-1 for the root)
+      and must be less than I. All effectors are solved jointly, so the wrist moves
+      once for every finger. Damping is relative to the mean bone length. Bone
+      lengths are preserved; each joint's Rotation points along its first bone. }
+    class function SolveDLS(const Skeleton: TJointArray; const Parents, Effectors: array of Integer;
+      const Targets: array of TVector3D; Iterations: Integer = 20; Tolerance: Double = 0.01;
+      Damping: Double = 0.1): TJointArray; overload;
+    class function SolveDLS(const Skeleton: TJointArray; const Parents, Effectors: array of Integer;
+      const Targets: array of TVector3D; Iterations: Integer; Tolerance, Damping: Double;
+      out IterationsUsed: Integer): TJointArray; overload;
+
     { Calculate angles between consecutive joints in a chain }
     class function CalculateJointAngles(const Chain: TJointArray): TArray<Double>;
     
     { Simple single joint IK - directly moves a joint to target position }
     class function SolveSingleJoint(const Joint: TJoint; const TargetPosition: TVector3D): TJoint;
     
-    { Apply joint constraints to ensure angles are within limits }
+    { Enforce joint limits on an already solved chain, root to tip. SolveFABRIK applies
+      the same limits inside its iteration, so this is only needed for other poses. }
     class function ApplyConstraints(const Chain: TJointArray): TJointArray;
+
+    { True if any interior joint limits its bend }
+    class function HasConstraints(const Chain: array of TJoint): Boolean;
+
+    { Clamp the bend between the incoming bone Previous and the outgoing bone Direction
+      (both unit) at Joint. With a HingeAxis the bones stay in the plane normal to it and
+      the signed bend is clamped to [MinAngle, MaxAngle]; otherwise the outgoing bone stays
+      in a cone of half-angle Max(-MinAngle, MaxAngle) and a positive MinAngle forbids
+      straightening. Reverse is set when Previous is the outgoing bone (tip-to-root pass). }
+    class function ConstrainDirection(const Previous, Direction: TVector3D; const Joint: TJoint;
+      Reverse: Boolean): TVector3D;
     
     { Calculate bone rotations (Euler angles) from joint positions }
     class function CalculateBoneRotations(const Chain: TJointArray): TJointArray;
@@ -76,8 +195,34 @@ type
       UpperArmLength: Double = 1.0; ForearmLength: Double = 1.0): TJointArray;
   end;
 
+  { Stateful solver that warm-starts each chain from its previous solution.
+    The previous pose is re-rooted at the current root and rescaled to the
+    current bone lengths before iterating, so smooth motion converges in a
+    couple of iterations. Chains are keyed by a caller-chosen integer id. }
+  TIKSolverState = class
+  private
+    FPrevious: TDictionary<Integer, TJointArray>;
+    FUseCCD: Boolean;
+    FIterations: Integer;
+    FTolerance: Double;
+    FLastIterations: Integer;
+    procedure SeedFromPrevious(var Chain: TJointArray; const Previous: TJointArray);
+  public
+    constructor Create(UseCCD: Boolean = False; Iterations: Integer = 10; Tolerance: Double = 0.01);
+    destructor Destroy; override;
+
+    function Solve(ChainId: Integer; const Chain: TJointArray; const TargetPosition: TVector3D): TJointArray;
+    procedure Reset(ChainId: Integer); overload;
+    procedure Reset; overload;
+
+    property LastIterations: Integer read FLastIterations;
+  end;
+
 implementation
 
+uses
+  System.Classes, System.Threading;
+
 { TVector3D }
 
 class function TVector3D.Create(AX, AY, AZ: Double): TVector3D;
@@ -161,6 +306,7 @@ begin
   Result.Rotation := TVector3D.Create(0, 0, 0);  // Initialize rotation to zero
   Result.MinAngle := AMinAngle;
   Result.MaxAngle := AMaxAngle;
+  Result.HingeAxis := TVector3D.Create(0, 0, 0);
 end;
 
 { TIKSolver }
@@ -168,151 +314,870 @@ end;
 class function TIKSolver.SolveCCD(const Chain: TJointArray; const TargetPosition: TVector3D;
   Iterations: Integer; Tolerance: Double): TJointArray;
 var
-  WorkChain: TJointArray;
+  IterationsUsed: Integer;
+begin
+  Result := SolveCCD(Chain, TargetPosition, Iterations, Tolerance, IterationsUsed);
+end;
+
+class function TIKSolver.SolveCCD(const Chain: TJointArray; const TargetPosition: TVector3D;
+  Iterations: Integer; Tolerance: Double; out IterationsUsed: Integer): TJointArray;
+begin
+  Result := Copy(Chain);
+  SolveCCDInPlace(Result, TargetPosition, Iterations, Tolerance, IterationsUsed);
+end;
+
+class procedure TIKSolver.SolveCCDInPlace(var Chain: array of TJoint; const TargetPosition: TVector3D;
+  Iterations: Integer; Tolerance: Double; out IterationsUsed: Integer);
+var
+  Target: TVector3D;
   EndEffectorIndex: Integer;
   Iter, I, J: Integer;
   EndEffector: TVector3D;
   DistanceToTarget: Double;
   CurrentJoint, CurrentEnd: TVector3D;
-  ToEnd, ToTarget, ToEndNorm, ToTargetNorm: TVector3D;
-  DotProduct, Angle: Double;
-  RotationAxis: TVector3D;
-  RelPos, Rotated: TVector3D;
+  M: TRotationMatrix3;
+  RelPos: TVector3D;
 begin
   if Length(Chain) < 2 then
     raise Exception.Create('Chain must have at least 2 joints');
 
-  // Clone the chain
-  SetLength(WorkChain, Length(Chain));
-  for I := 0 to High(Chain) do
-    WorkChain[I] := Chain[I];
+  // Two-bone chains (shoulder-elbow-wrist) have a closed-form solution
+  if Length(Chain) = 3 then
+  begin
+    IterationsUsed := 0;
+    SolveTwoBoneInPlace(Chain, TargetPosition, Chain[1].Position);
+    Exit;
+  end;
+
+  // Copy in case the target aliases one of the joints being moved
+  Target := TargetPosition;
 
-  EndEffectorIndex := High(WorkChain);
+  EndEffectorIndex := High(Chain);
+  IterationsUsed := 0;
 
   for Iter := 0 to Iterations - 1 do
   begin
     // Check if we've reached the target
-    EndEffector := WorkChain[EndEffectorIndex].Position;
-    DistanceToTarget := EndEffector.Distance(TargetPosition);
+    EndEffector := Chain[EndEffectorIndex].Position;
+    DistanceToTarget := EndEffector.Distance(Target);
     
     if DistanceToTarget < Tolerance then
       Break; // Solution found
 
+    Inc(IterationsUsed);
+
     // Iterate backwards through the chain (excluding end effector)
     for I := EndEffectorIndex - 1 downto 0 do
     begin
-      CurrentJoint := WorkChain[I].Position;
-      CurrentEnd := WorkChain[EndEffectorIndex].Position;
-
-      // Vector from current joint to end effector
-      ToEnd := CurrentEnd.Subtract(CurrentJoint);
-      // Vector from current joint to target
-      ToTarget := TargetPosition.Subtract(CurrentJoint);
-
-      // Calculate rotation angle
-      ToEndNorm := ToEnd.Normalize;
-      ToTargetNorm := ToTarget.Normalize;
-      
-      // Calculate angle between vectors
-      DotProduct := Max(-1.0, Min(1.0, ToEndNorm.Dot(ToTargetNorm)));
-      Angle := ArcCos(DotProduct);
-
-      // Skip if angle is too small
-      if Abs(Angle) < 0.001 then
-        Continue;
+      CurrentJoint := Chain[I].Position;
+      CurrentEnd := Chain[EndEffectorIndex].Position;
 
-      // Get rotation axis
-      RotationAxis := ToEndNorm.Cross(ToTargetNorm).Normalize;
+      // Rotation taking the end effector direction onto the target direction
+      if not CCDRotation(CurrentEnd.X - CurrentJoint.X, CurrentEnd.Y - CurrentJoint.Y, CurrentEnd.Z - CurrentJoint.Z,
+        Target.X - CurrentJoint.X, Target.Y - CurrentJoint.Y, Target.Z - CurrentJoint.Z, M) then
+        Continue;
 
       // Apply rotation to all joints from current to end
       for J := I + 1 to EndEffectorIndex do
       begin
-        RelPos := WorkChain[J].Position.Subtract(CurrentJoint);
-        Rotated := RotateAroundAxis(RelPos, RotationAxis, Angle);
-        WorkChain[J].Position := CurrentJoint.Add(Rotated);
+        RelPos := Chain[J].Position.Subtract(CurrentJoint);
+        Chain[J].Position := TVector3D.Create(
+          CurrentJoint.X + M[0] * RelPos.X + M[1] * RelPos.Y + M[2] * RelPos.Z,
+          CurrentJoint.Y + M[3] * RelPos.X + M[4] * RelPos.Y + M[5] * RelPos.Z,
+          CurrentJoint.Z + M[6] * RelPos.X + M[7] * RelPos.Y + M[8] * RelPos.Z);
       end;
     end;
   end;
 
   // Calculate and store bone rotations
-  Result := CalculateBoneRotations(WorkChain);
+  CalculateBoneRotationsInPlace(Chain);
 end;
 
 class function TIKSolver.SolveFABRIK(const Chain: TJointArray; const TargetPosition: TVector3D;
   Iterations: Integer; Tolerance: Double): TJointArray;
 var
-  WorkChain: TJointArray;
+  IterationsUsed: Integer;
+begin
+  Result := SolveFABRIK(Chain, TargetPosition, Iterations, Tolerance, IterationsUsed);
+end;
+
+class function TIKSolver.SolveFABRIK(const Chain: TJointArray; const TargetPosition: TVector3D;
+  Iterations: Integer; Tolerance: Double; out IterationsUsed: Integer): TJointArray;
+begin
+  Result := Copy(Chain);
+  SolveFABRIKInPlace(Result, TargetPosition, Iterations, Tolerance, IterationsUsed);
+end;
+
+class procedure TIKSolver.SolveFABRIKInPlace(var Chain: array of TJoint; const TargetPosition: TVector3D;
+  Iterations: Integer; Tolerance: Double; out IterationsUsed: Integer);
+var
   N, I, Iter: Integer;
-  BoneLengths: TArray<Double>;
-  RootPos, EndEffector, Direction: TVector3D;
+  BoneLengths: array[0..IKMaxChainJoints - 1] of Double;
+  Target, RootPos, EndEffector, Direction, Neighbour: TVector3D;
   TotalLength, DistanceToTarget: Double;
   Offset: TVector3D;
+  Constrained: Boolean;
 begin
   if Length(Chain) < 2 then
     raise Exception.Create('Chain must have at least 2 joints');
+  if Length(Chain) > IKMaxChainJoints then
+    raise Exception.CreateFmt('Chain must have at most %d joints', [IKMaxChainJoints]);
 
-  // Clone the chain
-  SetLength(WorkChain, Length(Chain));
-  for I := 0 to High(Chain) do
-    WorkChain[I] := Chain[I];
+  // Two-bone chains (shoulder-elbow-wrist) have a closed-form solution
+  if Length(Chain) = 3 then
+  begin
+    IterationsUsed := 0;
+    SolveTwoBoneInPlace(Chain, TargetPosition, Chain[1].Position);
+    Exit;
+  end;
 
-  N := Length(WorkChain);
+  // Copy in case the target aliases one of the joints being moved
+  Target := TargetPosition;
+  N := Length(Chain);
+  IterationsUsed := 0;
   
   // Store original bone lengths
-  SetLength(BoneLengths, N - 1);
   for I := 0 to N - 2 do
-    BoneLengths[I] := WorkChain[I].Position.Distance(WorkChain[I + 1].Position);
+    BoneLengths[I] := Chain[I].Position.Distance(Chain[I + 1].Position);
 
   // Store the root position
-  RootPos := WorkChain[0].Position;
+  RootPos := Chain[0].Position;
 
   // Calculate total chain length
   TotalLength := 0;
-  for I := 0 to High(BoneLengths) do
+  for I := 0 to N - 2 do
     TotalLength := TotalLength + BoneLengths[I];
 
-  DistanceToTarget := RootPos.Distance(TargetPosition);
+  DistanceToTarget := RootPos.Distance(Target);
 
   // If target is unreachable, stretch chain towards target
   if DistanceToTarget > TotalLength then
   begin
-    Direction := TargetPosition.Subtract(RootPos).Normalize;
+    Direction := Target.Subtract(RootPos).Normalize;
     for I := 1 to N - 1 do
     begin
       Offset := Direction.Multiply(BoneLengths[I - 1]);
-      WorkChain[I].Position := WorkChain[I - 1].Position.Add(Offset);
+      Chain[I].Position := Chain[I - 1].Position.Add(Offset);
     end;
-    Result := WorkChain;
     Exit;
   end;
 
+  // Joint limits are enforced inside both passes, so the iteration converges to a
+  // pose that already respects them instead of being corrected afterwards
+  Constrained := HasConstraints(Chain);
+
   // FABRIK iterations
   for Iter := 0 to Iterations - 1 do
   begin
     // Check convergence
-    EndEffector := WorkChain[N - 1].Position;
-    if EndEffector.Distance(TargetPosition) < Tolerance then
+    EndEffector := Chain[N - 1].Position;
+    if EndEffector.Distance(Target) < Tolerance then
       Break;
 
+    Inc(IterationsUsed);
+
     // Forward reaching phase
-    WorkChain[N - 1].Position := TargetPosition;
+    Chain[N - 1].Position := Target;
     for I := N - 2 downto 0 do
     begin
-      Direction := WorkChain[I].Position.Subtract(WorkChain[I + 1].Position).Normalize;
-      WorkChain[I].Position := WorkChain[I + 1].Position.Add(Direction.Multiply(BoneLengths[I]));
+      Direction := Chain[I].Position.Subtract(Chain[I + 1].Position).Normalize;
+      if Constrained and (I + 2 < N) then
+      begin
+        // Bone I enters joint I + 1, whose outgoing bone is already placed
+        Neighbour := Chain[I + 2].Position.Subtract(Chain[I + 1].Position).Normalize;
+        Direction := ConstrainDirection(Neighbour, Direction.Multiply(-1), Chain[I + 1], True).Multiply(-1);
+      end;
+      Chain[I].Position := Chain[I + 1].Position.Add(Direction.Multiply(BoneLengths[I]));
     end;
 
     // Backward reaching phase
-    WorkChain[0].Position := RootPos;
+    Chain[0].Position := RootPos;
     for I := 0 to N - 2 do
     begin
-      Direction := WorkChain[I + 1].Position.Subtract(WorkChain[I].Position).Normalize;
-      WorkChain[I + 1].Position := WorkChain[I].Position.Add(Direction.Multiply(BoneLengths[I]));
+      Direction := Chain[I + 1].Position.Subtract(Chain[I].Position).Normalize;
+      if Constrained and (I > 0) then
+      begin
+        Neighbour := Chain[I].Position.Subtract(Chain[I - 1].Position).Normalize;
+        Direction := ConstrainDirection(Neighbour, Direction, Chain[I], False);
+      end;
+      Chain[I + 1].Position := Chain[I].Position.Add(Direction.Multiply(BoneLengths[I]));
     end;
   end;
 
   // Calculate and store bone rotations
-  Result := CalculateBoneRotations(WorkChain);
+  CalculateBoneRotationsInPlace(Chain);
+end;
+
+class function TIKSolver.SolveTwoBone(const Chain: TJointArray; const TargetPosition: TVector3D): TJointArray;
+begin
+  if Length(Chain) <> 3 then
+    raise Exception.Create('Two-bone IK needs exactly 3 joints');
+  Result := SolveTwoBone(Chain, TargetPosition, Chain[1].Position);
+end;
+
+class function TIKSolver.SolveTwoBone(const Chain: TJointArray; const TargetPosition, PoleTarget: TVector3D): TJointArray;
+begin
+  if Length(Chain) <> 3 then
+    raise Exception.Create('Two-bone IK needs exactly 3 joints');
+  Result := Copy(Chain);
+  SolveTwoBoneInPlace(Result, TargetPosition, PoleTarget);
+end;
+
+class procedure TIKSolver.SolveTwoBoneInPlace(var Chain: array of TJoint; const TargetPosition, PoleTarget: TVector3D);
+var
+  Target, Pole, Root, ToTarget, Direction, ToPole, Bend: TVector3D;
+  Upper, Lower, TargetDistance, Reach, CosAngle, SinAngle: Double;
+  MinBend, MaxBend, MinReach, MaxReach: Double;
+begin
+  if Length(Chain) <> 3 then
+    raise Exception.Create('Two-bone IK needs exactly 3 joints');
+
+  // Copy first: either point may alias a joint of the chain
+  Target := TargetPosition;
+  Pole := PoleTarget;
+
+  Root := Chain[0].Position;
+  Upper := Chain[0].Position.Distance(Chain[1].Position);
+  Lower := Chain[1].Position.Distance(Chain[2].Position);
+
+  ToTarget := Target.Subtract(Root);
+  TargetDistance := ToTarget.Magnitude;
+  // A target on the root keeps the current chain direction
+  if TargetDistance > 0 then
+    Direction := ToTarget.Normalize
+  else
+    Direction := Chain[2].Position.Subtract(Root).Normalize;
+
+  // Unreachable targets stretch the chain, too-close ones fold it as far as it goes.
+  // The bend limits of the middle joint bound the reach the same way
+  MinBend := Max(0.0, Chain[1].MinAngle);
+  MaxBend := Min(180.0, Max(-Chain[1].MinAngle, Chain[1].MaxAngle));
+  MinReach := Sqrt(Max(0.0, Upper * Upper + Lower * Lower + 2 * Upper * Lower * Cos(DegToRad(MaxBend))));
+  MaxReach := Sqrt(Max(0.0, Upper * Upper + Lower * Lower + 2 * Upper * Lower * Cos(DegToRad(MinBend))));
+  Reach := Max(MinReach, Min(MaxReach, TargetDistance));
+
+  // Bend direction: pole projected onto the plane perpendicular to the reach direction
+  ToPole := Pole.Subtract(Root);
+  Bend := ToPole.Subtract(Direction.Multiply(ToPole.Dot(Direction)));
+  if Bend.Magnitude < 1e-6 then
+  begin
+    if Abs(Direction.X) < 0.9 then
+      Bend := TVector3D.Create(0, -Direction.Z, Direction.Y)
+    else
+      Bend := TVector3D.Create(Direction.Z, 0, -Direction.X);
+  end;
+  Bend := Bend.Normalize;
+
+  // Law of cosines for the angle at the root
+  if (Upper > 0) and (Reach > 0) then
+    CosAngle := Max(-1.0, Min(1.0, (Upper * Upper + Reach * Reach - Lower * Lower) / (2 * Upper * Reach)))
+  else
+    CosAngle := 1;
+  SinAngle := Sqrt(1 - CosAngle * CosAngle);
+
+  Chain[1].Position := Root.Add(Direction.Multiply(CosAngle).Add(Bend.Multiply(SinAngle)).Multiply(Upper));
+  Chain[2].Position := Root.Add(Direction.Multiply(Reach));
+
+  CalculateBoneRotationsInPlace(Chain);
+end;
+
+class function TIKSolver.SolveFABRIKFlat(var Positions: array of Single; const TargetPosition: TVector3D;
+  Iterations: Integer; Tolerance: Single): Integer;
+var
+  N, I, O, Last: Integer;
+  BoneLengths: array[0..IKMaxChainJoints - 1] of Single;
+  TX, TY, TZ, RX, RY, RZ, DX, DY, DZ, Len, Scale, TotalLength, RootDistance: Single;
+
+  // Move joint Dst to lie Length away from joint Src, along the Src->Dst direction
+  procedure PlaceAlong(Dst, Src: Integer; BoneLength: Single);
+  var
+    AX, AY, AZ, L, K: Single;
+  begin
+    AX := Positions[Dst] - Positions[Src];
+    AY := Positions[Dst + 1] - Positions[Src + 1];
+    AZ := Positions[Dst + 2] - Positions[Src + 2];
+    L := Sqrt(AX * AX + AY * AY + AZ * AZ);
+    if L > 0 then
+      K := BoneLength / L
+    else
+      K := 0;
+    Positions[Dst] := Positions[Src] + AX * K;
+    Positions[Dst + 1] := Positions[Src + 1] + AY * K;
+    Positions[Dst + 2] := Positions[Src + 2] + AZ * K;
+  end;
+
+begin
+  N := Length(Positions) div 3;
+  if N < 2 then
+    raise Exception.Create('Chain must have at least 2 joints');
+  if N > IKMaxChainJoints then
+    raise Exception.CreateFmt('Chain must have at most %d joints', [IKMaxChainJoints]);
+
+  TX := TargetPosition.X;
+  TY := TargetPosition.Y;
+  TZ := TargetPosition.Z;
+
+  TotalLength := 0;
+  for I := 0 to N - 2 do
+  begin
+    O := I * 3;
+    DX := Positions[O + 3] - Positions[O];
+    DY := Positions[O + 4] - Positions[O + 1];
+    DZ := Positions[O + 5] - Positions[O + 2];
+    BoneLengths[I] := Sqrt(DX * DX + DY * DY + DZ * DZ);
+    TotalLength := TotalLength + BoneLengths[I];
+  end;
+
+  RX := Positions[0];
+  RY := Positions[1];
+  RZ := Positions[2];
+  DX := TX - RX;
+  DY := TY - RY;
+  DZ := TZ - RZ;
+  RootDistance := Sqrt(DX * DX + DY * DY + DZ * DZ);
+
+  // If target is unreachable, stretch chain towards target
+  if RootDistance > TotalLength then
+  begin
+    if RootDistance > 0 then
+      Scale := 1 / RootDistance
+    else
+      Scale := 0;
+    for I := 1 to N - 1 do
+    begin
+      O := I * 3;
+      Positions[O] := Positions[O - 3] + DX * Scale * BoneLengths[I - 1];
+      Positions[O + 1] := Positions[O - 2] + DY * Scale * BoneLengths[I - 1];
+      Positions[O + 2] := Positions[O - 1] + DZ * Scale * BoneLengths[I - 1];
+    end;
+    Exit(0);
+  end;
+
+  Last := (N - 1) * 3;
+  Result := 0;
+  while Result < Iterations do
+  begin
+    DX := Positions[Last] - TX;
+    DY := Positions[Last + 1] - TY;
+    DZ := Positions[Last + 2] - TZ;
+    Len := Sqrt(DX * DX + DY * DY + DZ * DZ);
+    if Len < Tolerance then
+      Break;
+
+    // Forward reaching phase
+    Positions[Last] := TX;
+    Positions[Last + 1] := TY;
+    Positions[Last + 2] := TZ;
+    for I := N - 2 downto 0 do
+      PlaceAlong(I * 3, (I + 1) * 3, BoneLengths[I]);
+
+    // Backward reaching phase
+    Positions[0] := RX;
+    Positions[1] := RY;
+    Positions[2] := RZ;
+    for I := 0 to N - 2 do
+      PlaceAlong((I + 1) * 3, I * 3, BoneLengths[I]);
+
+    Inc(Result);
+  end;
+end;
+
+class function TIKSolver.SolveCCDFlat(var Positions: array of Single; const TargetPosition: TVector3D;
+  Iterations: Integer; Tolerance: Single): Integer;
+var
+  NoQuaternions: array[0..0] of Single;
+begin
+  Result := SolveCCDFlat(Positions, TargetPosition, Iterations, Tolerance, NoQuaternions);
+end;
+
+class function TIKSolver.SolveCCDFlat(var Positions: array of Single; const TargetPosition: TVector3D;
+  Iterations: Integer; Tolerance: Single; var Quaternions: array of Single): Integer;
+var
+  N, I, J, O, Last: Integer;
+  TX, TY, TZ, PX, PY, PZ, VX, VY, VZ: Single;
+  M: TRotationMatrix3;
+  Tracked, SweepRotated: Boolean;
+  Pivots: array[0..IKMaxChainJoints - 1] of TQuaternion4;
+  PivotRotated: array[0..IKMaxChainJoints - 1] of Boolean;
+  Sweep, Product: TQuaternion4;
+  HalfCos, HalfSin, Sine: Double;
+begin
+  N := Length(Positions) div 3;
+  if N < 2 then
+    raise Exception.Create('Chain must have at least 2 joints');
+  // the single-float dummy of the plain overload means no quaternions
+  Tracked := Length(Quaternions) >= N * 4;
+  if Tracked and (N > IKMaxChainJoints) then
+    raise Exception.CreateFmt('Chain must have at most %d joints', [IKMaxChainJoints]);
+  if Tracked then
+    FillChar(PivotRotated, SizeOf(PivotRotated), 0);
+
+  TX := TargetPosition.X;
+  TY := TargetPosition.Y;
+  TZ := TargetPosition.Z;
+  Last := (N - 1) * 3;
+
+  Result := 0;
+  while Result < Iterations do
+  begin
+    VX := Positions[Last] - TX;
+    VY := Positions[Last + 1] - TY;
+    VZ := Positions[Last + 2] - TZ;
+    if Sqrt(VX * VX + VY * VY + VZ * VZ) < Tolerance then
+      Break;
+
+    for I := N - 2 downto 0 do
+    begin
+      O := I * 3;
+      PX := Positions[O];
+      PY := Positions[O + 1];
+      PZ := Positions[O + 2];
+
+      if not CCDRotation(Positions[Last] - PX, Positions[Last + 1] - PY, Positions[Last + 2] - PZ,
+        TX - PX, TY - PY, TZ - PZ, M) then
+        Continue;
+
+      // One rotation matrix per pivot, applied to every joint after I
+      J := O + 3;
+      while J <= Last do
+      begin
+        VX := Positions[J] - PX;
+        VY := Positions[J + 1] - PY;
+        VZ := Positions[J + 2] - PZ;
+        Positions[J] := PX + M[0] * VX + M[1] * VY + M[2] * VZ;
+        Positions[J + 1] := PY + M[3] * VX + M[4] * VY + M[5] * VZ;
+        Positions[J + 2] := PZ + M[6] * VX + M[7] * VY + M[8] * VZ;
+        Inc(J, 3);
+      end;
+
+      if Tracked then
+      begin
+        // Same rotation as a quaternion: the skew part of M is 2 sin times the axis and
+        // its trace 1 + 2 cos
+        VX := M[7] - M[5];
+        VY := M[2] - M[6];
+        VZ := M[3] - M[1];
+        Sine := 0.5 * Sqrt(VX * VX + VY * VY + VZ * VZ);
+        HalfAngle(0.5 * (M[0] + M[4] + M[8] - 1), Sine, HalfCos, HalfSin);
+        Pivots[I][0] := VX / (2 * Sine) * HalfSin;
+        Pivots[I][1] := VY / (2 * Sine) * HalfSin;
+        Pivots[I][2] := VZ / (2 * Sine) * HalfSin;
+        Pivots[I][3] := HalfCos;
+        PivotRotated[I] := True;
+      end;
+    end;
+
+    // Pivots run from the end back to the root, so over one sweep bone J turns by
+    // Q0 * Q1 * ... * QJ; a running product applies the sweep in one pass
+    if Tracked then
+    begin
+      SweepRotated := False;
+      for J := 0 to N - 2 do
+      begin
+        if PivotRotated[J] then
+        begin
+          if SweepRotated then
+          begin
+            Product[0] := Sweep[3] * Pivots[J][0] + Sweep[0] * Pivots[J][3] + Sweep[1] * Pivots[J][2] - Sweep[2] * Pivots[J][1];
+            Product[1] := Sweep[3] * Pivots[J][1] - Sweep[0] * Pivots[J][2] + Sweep[1] * Pivots[J][3] + Sweep[2] * Pivots[J][0];
+            Product[2] := Sweep[3] * Pivots[J][2] + Sweep[0] * Pivots[J][1] - Sweep[1] * Pivots[J][0] + Sweep[2] * Pivots[J][3];
+            Product[3] := Sweep[3] * Pivots[J][3] - Sweep[0] * Pivots[J][0] - Sweep[1] * Pivots[J][1] - Sweep[2] * Pivots[J][2];
+            Sweep := Product;
+          end
+          else
+            Sweep := Pivots[J];
+          SweepRotated := True;
+          PivotRotated[J] := False;
+        end;
+        if SweepRotated then
+          PremultiplyQuaternion(Quaternions, J * 4, Sweep);
+      end;
+    end;
+
+    Inc(Result);
+  end;
+
+  if Tracked then
+    NormalizeBoneQuaternions(Quaternions, N);
+end;
+
+class function TIKSolver.SolveFABRIKFlat(var Positions: array of Single; const TargetPosition: TVector3D;
+  Iterations: Integer; Tolerance: Single; var Quaternions: array of Single): Integer;
+var
+  N, I, O: Integer;
+  Directions: array[0..IKMaxChainJoints * 3 - 1] of Single;
+  DX, DY, DZ, FX, FY, FZ, Len: Single;
+  Arc: TQuaternion4;
+begin
+  N := Length(Positions) div 3;
+  if (N < 2) or (N > IKMaxChainJoints) then
+    Exit(SolveFABRIKFlat(Positions, TargetPosition, Iterations, Tolerance));
+
+  for I := 0 to N - 2 do
+  begin
+    O := I * 3;
+    DX := Positions[O + 3] - Positions[O];
+    DY := Positions[O + 4] - Positions[O + 1];
+    DZ := Positions[O + 5] - Positions[O + 2];
+    Len := Sqrt(DX * DX + DY * DY + DZ * DZ);
+    if Len = 0 then
+      Len := 1;
+    Directions[O] := DX / Len;
+    Directions[O + 1] := DY / Len;
+    Directions[O + 2] := DZ / Len;
+  end;
+
+  Result := SolveFABRIKFlat(Positions, TargetPosition, Iterations, Tolerance);
+
+  // Turn every bone by the shortest arc from its old to its new direction
+  for I := 0 to N - 2 do
+  begin
+    O := I * 3;
+    DX := Positions[O + 3] - Positions[O];
+    DY := Positions[O + 4] - Positions[O + 1];
+    DZ := Positions[O + 5] - Positions[O + 2];
+    Len := Sqrt(DX * DX + DY * DY + DZ * DZ);
+    if Len = 0 then
+      Len := 1;
+    DX := DX / Len; DY := DY / Len; DZ := DZ / Len;
+    FX := Directions[O]; FY := Directions[O + 1]; FZ := Directions[O + 2];
+
+    Arc[3] := 1 + FX * DX + FY * DY + FZ * DZ;
+    if Arc[3] < 1e-6 then
+    begin
+      // Opposite directions: half a turn about any perpendicular axis
+      if Abs(FX) < 0.9 then
+      begin
+        Arc[0] := 0; Arc[1] := -FZ; Arc[2] := FY;
+      end
+      else
+      begin
+        Arc[0] := FZ; Arc[1] := 0; Arc[2] := -FX;
+      end;
+      Arc[3] := 0;
+    end
+    else
+    begin
+      Arc[0] := FY * DZ - FZ * DY;
+      Arc[1] := FZ * DX - FX * DZ;
+      Arc[2] := FX * DY - FY * DX;
+    end;
+    Len := Sqrt(Arc[0] * Arc[0] + Arc[1] * Arc[1] + Arc[2] * Arc[2] + Arc[3] * Arc[3]);
+    Arc[0] := Arc[0] / Len; Arc[1] := Arc[1] / Len; Arc[2] := Arc[2] / Len; Arc[3] := Arc[3] / Len;
+    PremultiplyQuaternion(Quaternions, I * 4, Arc);
+  end;
+  NormalizeBoneQuaternions(Quaternions, N);
+end;
+
+class procedure TIKSolver.InitBoneQuaternionsFlat(const Positions: array of Single; var Quaternions: array of Single);
+var
+  N, I, O, Q: Integer;
+  BX, BY, BZ, Len, H, CosYaw, SinYaw: Single;
+  HalfCosYaw, HalfSinYaw, HalfCosPitch, HalfSinPitch: Double;
+begin
+  N := Length(Positions) div 3;
+  for I := 0 to N - 2 do
+  begin
+    O := I * 3;
+    BX := Positions[O + 3] - Positions[O];
+    BY := Positions[O + 4] - Positions[O + 1];
+    BZ := Positions[O + 5] - Positions[O + 2];
+    Len := Sqrt(BX * BX + BY * BY + BZ * BZ);
+    if Len > 0 then
+    begin
+      BX := BX / Len; BY := BY / Len; BZ := BZ / Len;
+    end;
+    // Cos/sin of yaw = ArcTan2(X, Z) and pitch = ArcSin(-Y), then their half angles
+    H := Sqrt(BX * BX + BZ * BZ);
+    if H > 0 then
+    begin
+      CosYaw := BZ / H;
+      SinYaw := BX / H;
+    end
+    else
+    begin
+      CosYaw := 1;
+      SinYaw := 0;
+    end;
+    HalfAngle(CosYaw, SinYaw, HalfCosYaw, HalfSinYaw);
+    HalfAngle(H, -BY, HalfCosPitch, HalfSinPitch);
+    // Yaw about Y composed with pitch about X
+    Q := I * 4;
+    Quaternions[Q] := HalfCosYaw * HalfSinPitch;
+    Quaternions[Q + 1] := HalfSinYaw * HalfCosPitch;
+    Quaternions[Q + 2] := -HalfSinYaw * HalfSinPitch;
+    Quaternions[Q + 3] := HalfCosYaw * HalfCosPitch;
+  end;
+  if N > 1 then
+    for I := 0 to 3 do
+      Quaternions[(N - 1) * 4 + I] := Quaternions[(N - 2) * 4 + I];
+end;
+
+class procedure TIKSolver.HalfAngle(C, S: Double; out HalfCos, HalfSin: Double);
+begin
+  // Square root of whichever of 1 + C, 1 - C does not cancel; the other half follows
+  // from sin A = 2 sin(A/2) cos(A/2)
+  if C >= 0 then
+  begin
+    HalfCos := Sqrt(0.5 * (1 + C));
+    HalfSin := S / (2 * HalfCos);
+  end
+  else
+  begin
+    HalfSin := Sqrt(0.5 * Min(2.0, 1 - C));
+    if S < 0 then
+      HalfSin := -HalfSin;
+    HalfCos := S / (2 * HalfSin);
+  end;
+end;
+
+class procedure TIKSolver.PremultiplyQuaternion(var Q: array of Single; O: Integer; const A: TQuaternion4);
+var
+  BX, BY, BZ, BW: Double;
+begin
+  BX := Q[O]; BY := Q[O + 1]; BZ := Q[O + 2]; BW := Q[O + 3];
+  Q[O] := A[3] * BX + A[0] * BW + A[1] * BZ - A[2] * BY;
+  Q[O + 1] := A[3] * BY - A[0] * BZ + A[1] * BW + A[2] * BX;
+  Q[O + 2] := A[3] * BZ + A[0] * BY - A[1] * BX + A[2] * BW;
+  Q[O + 3] := A[3] * BW - A[0] * BX - A[1] * BY - A[2] * BZ;
+end;
+
+class procedure TIKSolver.NormalizeBoneQuaternions(var Q: array of Single; N: Integer);
+var
+  J, O: Integer;
+  Len: Double;
+begin
+  // Products of unit quaternions drift slowly; renormalize once per solve
+  for J := 0 to N - 2 do
+  begin
+    O := J * 4;
+    Len := Sqrt(Sqr(Q[O]) + Sqr(Q[O + 1]) + Sqr(Q[O + 2]) + Sqr(Q[O + 3]));
+    if Len > 0 then
+    begin
+      Q[O] := Q[O] / Len; Q[O + 1] := Q[O + 1] / Len; Q[O + 2] := Q[O + 2] / Len; Q[O + 3] := Q[O + 3] / Len;
+    end;
+  end;
+  // The last joint repeats the last bone
+  for J := 0 to 3 do
+    Q[(N - 1) * 4 + J] := Q[(N - 2) * 4 + J];
+end;
+
+class procedure TIKSolver.CalculateBoneRotationsFlat(const Positions: array of Single; var Rotations: array of Single);
+var
+  N, I, O: Integer;
+  BX, BY, BZ, Len: Single;
+begin
+  N := Length(Positions) div 3;
+  for I := 0 to N - 2 do
+  begin
+    O := I * 3;
+    BX := Positions[O + 3] - Positions[O];
+    BY := Positions[O + 4] - Positions[O + 1];
+    BZ := Positions[O + 5] - Positions[O + 2];
+    Len := Sqrt(BX * BX + BY * BY + BZ * BZ);
+    if Len > 0 then
+    begin
+      BX := BX / Len; BY := BY / Len; BZ := BZ / Len;
+    end;
+    Rotations[O] := ArcSin(Max(-1.0, Min(1.0, -BY))) * (180 / Pi);
+    Rotations[O + 1] := ArcTan2(BX, BZ) * (180 / Pi);
+    Rotations[O + 2] := 0;
+  end;
+  if N > 1 then
+  begin
+    O := (N - 1) * 3;
+    Rotations[O] := Rotations[O - 3];
+    Rotations[O + 1] := Rotations[O - 2];
+    Rotations[O + 2] := Rotations[O - 1];
+  end;
+end;
+
+class function TIKSolver.SolveFABRIKBatch(var Xs, Ys, Zs: TArray<Double>; ChainCount: Integer;
+  const Targets: array of TVector3D; Iterations: Integer; Tolerance: Double): Integer;
+var
+  N, C, I, Iter, A, B, EndRow, ActiveCount: Integer;
+  BoneLengths, RootX, RootY, RootZ: TArray<Double>;
+  Active: TArray<Boolean>;
+  DX, DY, DZ, Len, Total, Dist, Scale: Double;
+
+  procedure PlaceAlong(Dst, Src: Integer; BoneLength: Double);
+  begin
+    DX := Xs[Dst] - Xs[Src];
+    DY := Ys[Dst] - Ys[Src];
+    DZ := Zs[Dst] - Zs[Src];
+    Len := Sqrt(DX * DX + DY * DY + DZ * DZ);
+    if Len > 0 then Scale := BoneLength / Len else Scale := 0;
+    Xs[Dst] := Xs[Src] + DX * Scale;
+    Ys[Dst] := Ys[Src] + DY * Scale;
+    Zs[Dst] := Zs[Src] + DZ * Scale;
+  end;
+
+begin
+  if (ChainCount <= 0) or (Length(Targets) < ChainCount) then
+    raise Exception.Create('Targets must hold one position per chain');
+  N := Length(Xs) div ChainCount;
+  if N < 2 then
+    raise Exception.Create('Chain must have at least 2 joints');
+
+  SetLength(BoneLengths, (N - 1) * ChainCount);
+  SetLength(RootX, ChainCount);
+  SetLength(RootY, ChainCount);
+  SetLength(RootZ, ChainCount);
+  SetLength(Active, ChainCount);
+  EndRow := (N - 1) * ChainCount;
+  ActiveCount := 0;
+
+  for C := 0 to ChainCount - 1 do
+  begin
+    Total := 0;
+    for I := 0 to N - 2 do
+    begin
+      A := I * ChainCount + C;
+      B := A + ChainCount;
+      DX := Xs[B] - Xs[A];
+      DY := Ys[B] - Ys[A];
+      DZ := Zs[B] - Zs[A];
+      BoneLengths[A] := Sqrt(DX * DX + DY * DY + DZ * DZ);
+      Total := Total + BoneLengths[A];
+    end;
+    RootX[C] := Xs[C];
+    RootY[C] := Ys[C];
+    RootZ[C] := Zs[C];
+
+    DX := Targets[C].X - Xs[C];
+    DY := Targets[C].Y - Ys[C];
+    DZ := Targets[C].Z - Zs[C];
+    Dist := Sqrt(DX * DX + DY * DY + DZ * DZ);
+    if Dist > Total then
+    begin
+      // Unreachable: stretch towards the target and leave the chain out of the iterations
+      if Dist > 0 then Scale := 1 / Dist else Scale := 0;
+      for I := 1 to N - 1 do
+      begin
+        A := I * ChainCount + C;
+        B := A - ChainCount;
+        Xs[A] := Xs[B] + DX * Scale * BoneLengths[B];
+        Ys[A] := Ys[B] + DY * Scale * BoneLengths[B];
+        Zs[A] := Zs[B] + DZ * Scale * BoneLengths[B];
+      end;
+      Active[C] := False;
+    end
+    else
+    begin
+      Active[C] := True;
+      Inc(ActiveCount);
+    end;
+  end;
+
+  Iter := 0;
+  while (Iter < Iterations) and (ActiveCount > 0) do
+  begin
+    // Convergence mask
+    for C := 0 to ChainCount - 1 do
+      if Active[C] then
+      begin
+        DX := Xs[EndRow + C] - Targets[C].X;
+        DY := Ys[EndRow + C] - Targets[C].Y;
+        DZ := Zs[EndRow + C] - Targets[C].Z;
+        if Sqrt(DX * DX + DY * DY + DZ * DZ) < Tolerance then
+        begin
+          Active[C] := False;
+          Dec(ActiveCount);
+        end;
+      end;
+    if ActiveCount = 0 then
+      Break;
+
+    // Forward reaching phase
+    for C := 0 to ChainCount - 1 do
+      if Active[C] then
+      begin
+        Xs[EndRow + C] := Targets[C].X;
+        Ys[EndRow + C] := Targets[C].Y;
+        Zs[EndRow + C] := Targets[C].Z;
+      end;
+    for I := N - 2 downto 0 do
+      for C := 0 to ChainCount - 1 do
+        if Active[C] then
+          PlaceAlong(I * ChainCount + C, (I + 1) * ChainCount + C, BoneLengths[I * ChainCount + C]);
+
+    // Backward reaching phase
+    for C := 0 to ChainCount - 1 do
+      if Active[C] then
+      begin
+        Xs[C] := RootX[C];
+        Ys[C] := RootY[C];
+        Zs[C] := RootZ[C];
+      end;
+    for I := 0 to N - 2 do
+      for C := 0 to ChainCount - 1 do
+        if Active[C] then
+          PlaceAlong((I + 1) * ChainCount + C, I * ChainCount + C, BoneLengths[I * ChainCount + C]);
+
+    Inc(Iter);
+  end;
+
+  Result := Iter;
+end;
+
+class procedure TIKSolver.SolveChainAt(const Chains: TArray<TJointArray>; const Targets: TArray<TVector3D>;
+  UseCCD: Boolean; Iterations: Integer; Tolerance: Double; const IterationsUsed: TArray<Integer>;
+  Index: Integer);
+var
+  Chain: TJointArray;
+  Used: Integer;
+begin
+  // Same array as Chains[Index]; dynamic arrays are references, so this solves it in place
+  Chain := Chains[Index];
+  if UseCCD then
+    SolveCCDInPlace(Chain, Targets[Index], Iterations, Tolerance, Used)
+  else
+    SolveFABRIKInPlace(Chain, Targets[Index], Iterations, Tolerance, Used);
+  if IterationsUsed <> nil then
+    IterationsUsed[Index] := Used;
+end;
+
+class procedure TIKSolver.SolveChains(const Chains: TArray<TJointArray>; const Targets: TArray<TVector3D>;
+  UseCCD: Boolean; Iterations: Integer; Tolerance: Double; const IterationsUsed: TArray<Integer>);
+var
+  I, Work: Integer;
+  LocalChains: TArray<TJointArray>;
+  LocalTargets: TArray<TVector3D>;
+  LocalUsed: TArray<Integer>;
+begin
+  if Length(Targets) < Length(Chains) then
+    raise Exception.Create('Targets must hold one position per chain');
+  if (IterationsUsed <> nil) and (Length(IterationsUsed) < Length(Chains)) then
+    raise Exception.Create('IterationsUsed must hold one entry per chain');
+
+  // Validate up front: an exception raised inside TParallel.For reaches the caller
+  // wrapped in an EAggregateException, after the other chains have been solved
+  Work := 0;
+  for I := 0 to High(Chains) do
+  begin
+    if Length(Chains[I]) < 2 then
+      raise Exception.Create('Chain must have at least 2 joints');
+    if Length(Chains[I]) > IKMaxChainJoints then
+      raise Exception.CreateFmt('Chain must have at most %d joints', [IKMaxChainJoints]);
+    Inc(Work, Length(Chains[I]) * Max(Iterations, 1));
+  end;
+
+  if (Length(Chains) < 2) or (Work < ParallelChainsMinWork) or (TThread.ProcessorCount < 2) then
+  begin
+    for I := 0 to High(Chains) do
+      SolveChainAt(Chains, Targets, UseCCD, Iterations, Tolerance, IterationsUsed, I);
+    Exit;
+  end;
+
+  // Anonymous methods capture locals; each task writes only its own chain and slot
+  LocalChains := Chains;
+  LocalTargets := Targets;
+  LocalUsed := IterationsUsed;
+  TParallel.&For(0, High(LocalChains),
+    procedure(Index: Integer)
+    begin
+      SolveChainAt(LocalChains, LocalTargets, UseCCD, Iterations, Tolerance, LocalUsed, Index);
+    end);
 end;
 
 class function TIKSolver.RotateAroundAxis(const Vector, Axis: TVector3D; Angle: Double): TVector3D;
@@ -331,6 +1196,238 @@ begin
   Result := Term1.Add(Term2).Add(Term3);
 end;
 
+class function TIKSolver.CCDRotation(AX, AY, AZ, BX, BY, BZ: Double; out M: TRotationMatrix3): Boolean;
+var
+  LA, LB, C, S, T, KX, KY, KZ: Double;
+begin
+  Result := False;
+  LA := Sqrt(AX * AX + AY * AY + AZ * AZ);
+  LB := Sqrt(BX * BX + BY * BY + BZ * BZ);
+  if (LA = 0) or (LB = 0) then
+    Exit;
+  AX := AX / LA; AY := AY / LA; AZ := AZ / LA;
+  BX := BX / LB; BY := BY / LB; BZ := BZ / LB;
+
+  // For unit vectors the dot is the cosine and the cross length the sine, so no trig
+  C := Max(-1.0, Min(1.0, AX * BX + AY * BY + AZ * BZ));
+  if C > CosMinCCDAngle then
+    Exit;
+  KX := AY * BZ - AZ * BY;
+  KY := AZ * BX - AX * BZ;
+  KZ := AX * BY - AY * BX;
+  S := Sqrt(KX * KX + KY * KY + KZ * KZ);
+  if S = 0 then
+    Exit;
+  KX := KX / S; KY := KY / S; KZ := KZ / S;
+
+  // Rodrigues' rotation formula as a matrix
+  T := 1 - C;
+  M[0] := C + KX * KX * T; M[1] := KX * KY * T - KZ * S; M[2] := KX * KZ * T + KY * S;
+  M[3] := KY * KX * T + KZ * S; M[4] := C + KY * KY * T; M[5] := KY * KZ * T - KX * S;
+  M[6] := KZ * KX * T - KY * S; M[7] := KZ * KY * T + KX * S; M[8] := C + KZ * KZ * T;
+  Result := True;
+end;
+
+class function TIKSolver.SolveDLS(const Skeleton: TJointArray; const Parents, Effectors: array of Integer;
+  const Targets: array of TVector3D; Iterations: Integer; Tolerance, Damping: Double): TJointArray;
+var
+  IterationsUsed: Integer;
+begin
+  Result := SolveDLS(Skeleton, Parents, Effectors, Targets, Iterations, Tolerance, Damping, IterationsUsed);
+end;
+
+class function TIKSolver.SolveDLS(const Skeleton: TJointArray; const Parents, Effectors: array of Integer;
+  const Targets: array of TVector3D; Iterations: Integer; Tolerance, Damping: Double;
+  out IterationsUsed: Integer): TJointArray;
+var
+  N, M, Size, I, J, K, A, B, P, Row, Col: Integer;
+  EffectorsBelow, Descendants: array of TArray<Integer>;
+  Error: TArray<Double>;
+  Normal: TArray<Double>;  // J J^T + damping^2 I, factored in place
+  Offsets, Omega: TArray<TVector3D>;
+  RA, RB, Y: TVector3D;
+  Lambda2, Worst, BoneSum, Dot, Sum, Largest, StepScale, Angle: Double;
+  HasRotation: TArray<Boolean>;
+  Bone: TVector3D;
+begin
+  N := Length(Skeleton);
+  M := Length(Effectors);
+  if (Length(Parents) <> N) or (Length(Targets) <> M) then
+    raise Exception.Create('Parents must match the skeleton and Targets the effectors');
+  for I := 0 to N - 1 do
+    if Parents[I] >= I then
+      raise Exception.Create('Every joint must come after its parent');
+
+  SetLength(Result, N);
+  for I := 0 to N - 1 do
+    Result[I] := Skeleton[I];
+  IterationsUsed := 0;
+  if M = 0 then
+    Exit;
+
+  // Only ancestors of an effector move it, so each joint keeps the effectors below it;
+  // every other Jacobian entry is zero and never touched
+  SetLength(EffectorsBelow, N);
+  SetLength(Descendants, N);
+  for K := 0 to M - 1 do
+  begin
+    J := Parents[Effectors[K]];
+    while J >= 0 do
+    begin
+      EffectorsBelow[J] := EffectorsBelow[J] + [K];
+      J := Parents[J];
+    end;
+  end;
+  for I := 0 to N - 1 do
+  begin
+    J := Parents[I];
+    while J >= 0 do
+    begin
+      Descendants[J] := Descendants[J] + [I];
+      J := Parents[J];
+    end;
+  end;
+
+  Size := M * 3;
+  SetLength(Error, Size);
+  SetLength(Normal, Size * Size);
+  SetLength(Offsets, M);
+  SetLength(Omega, N);
+
+  // Damping is relative to the mean bone length so it does not depend on units
+  BoneSum := 0;
+  for I := 1 to N - 1 do
+    BoneSum := BoneSum + Result[I].Position.Distance(Result[Parents[I]].Position);
+  if N > 1 then
+    Lambda2 := Sqr(Damping * BoneSum / (N - 1))
+  else
+    Lambda2 := Sqr(Damping);
+
+  while IterationsUsed < Iterations do
+  begin
+    Worst := 0;
+    for K := 0 to M - 1 do
+    begin
+      Y := Targets[K].Subtract(Result[Effectors[K]].Position);
+      Error[K * 3] := Y.X;
+      Error[K * 3 + 1] := Y.Y;
+      Error[K * 3 + 2] := Y.Z;
+      Worst := Max(Worst, Y.Magnitude);
+    end;
+    if Worst < Tolerance then
+      Break;
+
+    // J J^T: a free rotation at joint J contributes (rA . rB) I - rB rA^T to block (A, B),
+    // where r is the offset from joint J to each effector below it
+    for I := 0 to Size * Size - 1 do
+      Normal[I] := 0;
+    for I := 0 to Size - 1 do
+      Normal[I * Size + I] := Lambda2;
+    for J := 0 to N - 1 do
+    begin
+      for A := 0 to High(EffectorsBelow[J]) do
+        Offsets[A] := Result[Effectors[EffectorsBelow[J][A]]].Position.Subtract(Result[J].Position);
+      for A := 0 to High(EffectorsBelow[J]) do
+        for B := 0 to High(EffectorsBelow[J]) do
+        begin
+          RA := Offsets[A];
+          RB := Offsets[B];
+          Dot := RA.Dot(RB);
+          Row := EffectorsBelow[J][A] * 3;
+          Col := EffectorsBelow[J][B] * 3;
+          Normal[Row * Size + Col] := Normal[Row * Size + Col] + Dot - RB.X * RA.X;
+          Normal[Row * Size + Col + 1] := Normal[Row * Size + Col + 1] - RB.X * RA.Y;
+          Normal[Row * Size + Col + 2] := Normal[Row * Size + Col + 2] - RB.X * RA.Z;
+          Normal[(Row + 1) * Size + Col] := Normal[(Row + 1) * Size + Col] - RB.Y * RA.X;
+          Normal[(Row + 1) * Size + Col + 1] := Normal[(Row + 1) * Size + Col + 1] + Dot - RB.Y * RA.Y;
+          Normal[(Row + 1) * Size + Col + 2] := Normal[(Row + 1) * Size + Col + 2] - RB.Y * RA.Z;
+          Normal[(Row + 2) * Size + Col] := Normal[(Row + 2) * Size + Col] - RB.Z * RA.X;
+          Normal[(Row + 2) * Size + Col + 1] := Normal[(Row + 2) * Size + Col + 1] - RB.Z * RA.Y;
+          Normal[(Row + 2) * Size + Col + 2] := Normal[(Row + 2) * Size + Col + 2] + Dot - RB.Z * RA.Z;
+        end;
+    end;
+
+    // The damped system is symmetric positive definite: Cholesky in place, then solve into Error
+    for I := 0 to Size - 1 do
+      for K := 0 to I do
+      begin
+        Sum := Normal[I * Size + K];
+        for P := 0 to K - 1 do
+          Sum := Sum - Normal[I * Size + P] * Normal[K * Size + P];
+        if I = K then
+          Normal[I * Size + K] := Sqrt(Max(Sum, 1e-12))
+        else
+          Normal[I * Size + K] := Sum / Normal[K * Size + K];
+      end;
+    for I := 0 to Size - 1 do
+    begin
+      Sum := Error[I];
+      for P := 0 to I - 1 do
+        Sum := Sum - Normal[I * Size + P] * Error[P];
+      Error[I] := Sum / Normal[I * Size + I];
+    end;
+    for I := Size - 1 downto 0 do
+    begin
+      Sum := Error[I];
+      for P := I + 1 to Size - 1 do
+        Sum := Sum - Normal[P * Size + I] * Error[P];
+      Error[I] := Sum / Normal[I * Size + I];
+    end;
+
+    // Joint updates J^T y: a joint's rotation vector is the sum of r x y over its effectors
+    Largest := 0;
+    for J := 0 to N - 1 do
+    begin
+      Omega[J] := TVector3D.Create(0, 0, 0);
+      for A := 0 to High(EffectorsBelow[J]) do
+      begin
+        K := EffectorsBelow[J][A];
+        RA := Result[Effectors[K]].Position.Subtract(Result[J].Position);
+        Y := TVector3D.Create(Error[K * 3], Error[K * 3 + 1], Error[K * 3 + 2]);
+        Omega[J] := Omega[J].Add(RA.Cross(Y));
+      end;
+      Largest := Max(Largest, Omega[J].Magnitude);
+    end;
+
+    // Large steps leave the linear model; scale the whole step so no joint turns more than DLSMaxStep
+    if Largest > DLSMaxStep then
+      StepScale := DLSMaxStep / Largest
+    else
+      StepScale := 1;
+
+    // Children first, so every joint rotates its subtree from the pose the Jacobian saw
+    for J := N - 1 downto 0 do
+    begin
+      Angle := Omega[J].Magnitude * StepScale;
+      if Angle < 1e-9 then
+        Continue;
+      RA := Omega[J].Normalize;
+      for I in Descendants[J] do
+        Result[I].Position := Result[J].Position.Add(
+          RotateAroundAxis(Result[I].Position.Subtract(Result[J].Position), RA, Angle));
+    end;
+
+    Inc(IterationsUsed);
+  end;
+
+  // Same convention as CalculateBoneRotations: a joint points along its first bone, leaves copy their parent
+  SetLength(HasRotation, N);
+  for I := 1 to N - 1 do
+  begin
+    P := Parents[I];
+    if (P >= 0) and not HasRotation[P] then
+    begin
+      Bone := Result[I].Position.Subtract(Result[P].Position).Normalize;
+      Result[P].Rotation := TVector3D.Create(ArcSin(Max(-1.0, Min(1.0, -Bone.Y))) * (180 / Pi),
+        ArcTan2(Bone.X, Bone.Z) * (180 / Pi), 0);
+      HasRotation[P] := True;
+    end;
+  end;
+  for I := 1 to N - 1 do
+    if not HasRotation[I] and (Parents[I] >= 0) then
+      Result[I].Rotation := Result[Parents[I]].Rotation;
+end;
+
 class function TIKSolver.CalculateJointAngles(const Chain: TJointArray): TArray<Double>;
 var
   I: Integer;
@@ -355,46 +1452,110 @@ begin
 end;
 
 class function TIKSolver.ApplyConstraints(const Chain: TJointArray): TJointArray;
-var
-  I: Integer;
-  V1, V2: TVector3D;
-  CurrentAngle, TargetAngle: Double;
 begin
-  SetLength(Result, Length(Chain));
-  for I := 0 to High(Chain) do
-    Result[I] := Chain[I];
+  Result := Copy(Chain);
+  ApplyConstraintsInPlace(Result);
+end;
 
+class procedure TIKSolver.ApplyConstraintsInPlace(var Chain: array of TJoint);
+var
+  I, K: Integer;
+  Previous, Bone, Direction, Moved: TVector3D;
+  BoneLength: Double;
+begin
   for I := 1 to Length(Chain) - 2 do
   begin
-    V1 := Result[I].Position.Subtract(Result[I - 1].Position);
-    V2 := Result[I + 1].Position.Subtract(Result[I].Position);
-    
-    CurrentAngle := ArcCos(Max(-1.0, Min(1.0, V1.Normalize.Dot(V2.Normalize)))) * (180 / Pi);
+    Previous := Chain[I].Position.Subtract(Chain[I - 1].Position).Normalize;
+    Bone := Chain[I + 1].Position.Subtract(Chain[I].Position);
+    BoneLength := Bone.Magnitude;
+    Direction := ConstrainDirection(Previous, Bone.Normalize, Chain[I], False);
+    Moved := Chain[I].Position.Add(Direction.Multiply(BoneLength)).Subtract(Chain[I + 1].Position);
+
+    // Carry the rest of the chain along with the corrected bone
+    for K := I + 1 to High(Chain) do
+      Chain[K].Position := Chain[K].Position.Add(Moved);
+  end;
+end;
 
-    // Clamp angle within constraints
-    if (CurrentAngle < Result[I].MinAngle) or (CurrentAngle > Result[I].MaxAngle) then
+class function TIKSolver.HasConstraints(const Chain: array of TJoint): Boolean;
+var
+  I: Integer;
+begin
+  for I := 1 to Length(Chain) - 2 do
+    if (Chain[I].HingeAxis.Magnitude > 0) or (Chain[I].MinAngle > 0)
+      or (Max(-Chain[I].MinAngle, Chain[I].MaxAngle) < 180) then
+      Exit(True);
+  Result := False;
+end;
+
+class function TIKSolver.ConstrainDirection(const Previous, Direction: TVector3D; const Joint: TJoint;
+  Reverse: Boolean): TVector3D;
+var
+  Axis, P, D, Side: TVector3D;
+  Angle, Lo, Hi: Double;
+begin
+  if Joint.HingeAxis.Magnitude > 0 then
+  begin
+    Axis := Joint.HingeAxis.Normalize;
+    P := Previous.Subtract(Axis.Multiply(Axis.Dot(Previous)));
+    D := Direction.Subtract(Axis.Multiply(Axis.Dot(Direction)));
+    if P.Magnitude < 1e-9 then
+      Exit(Direction);
+    if D.Magnitude < 1e-9 then
+      D := P;
+    P := P.Normalize;
+    D := D.Normalize;
+    Angle := RadToDeg(ArcTan2(Axis.Dot(P.Cross(D)), P.Dot(D)));
+    if Reverse then
+    begin
+      Lo := -Joint.MaxAngle;
+      Hi := -Joint.MinAngle;
+    end
+    else
     begin
-      TargetAngle := Max(Result[I].MinAngle, Min(Result[I].MaxAngle, CurrentAngle));
-      // Note: Actual constraint adjustment would require more complex calculations
-      // This is a simplified version for demonstration
+      Lo := Joint.MinAngle;
+      Hi := Joint.MaxAngle;
     end;
+    Result := RotateAroundAxis(P, Axis, DegToRad(Max(Lo, Min(Hi, Angle)))).Normalize;
+    Exit;
   end;
+
+  Lo := Max(0.0, Joint.MinAngle);
+  Hi := Min(180.0, Max(-Joint.MinAngle, Joint.MaxAngle));
+  Angle := RadToDeg(ArcCos(Max(-1.0, Min(1.0, Previous.Dot(Direction)))));
+  if (Angle >= Lo) and (Angle <= Hi) then
+    Exit(Direction);
+
+  // Keep the bend plane, move the bone to the nearest edge of the allowed range
+  Side := Direction.Subtract(Previous.Multiply(Previous.Dot(Direction)));
+  if Side.Magnitude < 1e-9 then
+  begin
+    if Abs(Previous.X) < 0.9 then
+      Side := TVector3D.Create(0, -Previous.Z, Previous.Y)
+    else
+      Side := TVector3D.Create(Previous.Z, 0, -Previous.X);
+  end;
+  Side := Side.Normalize;
+  Angle := DegToRad(Max(Lo, Min(Hi, Angle)));
+  Result := Previous.Multiply(Cos(Angle)).Add(Side.Multiply(Sin(Angle)));
 end;
 
 class function TIKSolver.CalculateBoneRotations(const Chain: TJointArray): TJointArray;
+begin
+  Result := Copy(Chain);
+  CalculateBoneRotationsInPlace(Result);
+end;
+
+class procedure TIKSolver.CalculateBoneRotationsInPlace(var Chain: array of TJoint);
 var
   I: Integer;
   BoneVector: TVector3D;
   Yaw, Pitch, Roll: Double;
 begin
-  SetLength(Result, Length(Chain));
-  for I := 0 to High(Chain) do
-    Result[I] := Chain[I];
-
   // For each bone (segment between two joints)
-  for I := 0 to Length(Result) - 2 do
+  for I := 0 to Length(Chain) - 2 do
   begin
-    BoneVector := Result[I + 1].Position.Subtract(Result[I].Position).Normalize;
+    BoneVector := Chain[I + 1].Position.Subtract(Chain[I].Position).Normalize;
     
     // Calculate Euler angles (ZYX convention)
     // Rotation around Y-axis (yaw)
@@ -408,12 +1569,12 @@ begin
     // A more complex implementation would track twist along the bone
     Roll := 0;
     
-    Result[I].Rotation := TVector3D.Create(Pitch, Yaw, Roll);
+    Chain[I].Rotation := TVector3D.Create(Pitch, Yaw, Roll);
   end;
   
   // Last joint's rotation is same as the previous bone's direction
-  if Length(Result) > 1 then
-    Result[High(Result)].Rotation := Result[High(Result) - 1].Rotation;
+  if Length(Chain) > 1 then
+    Chain[High(Chain)].Rotation := Chain[High(Chain) - 1].Rotation;
 end;
 
 class function TIKSolver.CreateFingerChain(const BasePosition: TVector3D; 
@@ -445,4 +1606,74 @@ begin
   Result[2] := TJoint.Create(ShoulderPosition.Add(TVector3D.Create(0, -(UpperArmLength + ForearmLength), 0)), -90, 90);
 end;
 
+{ TIKSolverState }
+
+constructor TIKSolverState.Create(UseCCD: Boolean; Iterations: Integer; Tolerance: Double);
+begin
+  inherited Create;
+  FPrevious := TDictionary<Integer, TJointArray>.Create;
+  FUseCCD := UseCCD;
+  FIterations := Iterations;
+  FTolerance := Tolerance;
+  FLastIterations := 0;
+end;
+
+destructor TIKSolverState.Destroy;
+begin
+  FPrevious.Free;
+  inherited;
+end;
+
+procedure TIKSolverState.SeedFromPrevious(var Chain: TJointArray; const Previous: TJointArray);
+var
+  I: Integer;
+  OriginalPrev, Original, Direction: TVector3D;
+  BoneLength: Double;
+begin
+  // Keep the current root and bone lengths, take each bone's direction from the previous solution
+  OriginalPrev := Chain[0].Position;
+  for I := 1 to High(Chain) do
+  begin
+    Original := Chain[I].Position;
+    BoneLength := Original.Distance(OriginalPrev);
+    Direction := Previous[I].Position.Subtract(Previous[I - 1].Position);
+    if Direction.Magnitude > 0 then
+      Chain[I].Position := Chain[I - 1].Position.Add(Direction.Normalize.Multiply(BoneLength))
+    else
+      Chain[I].Position := Chain[I - 1].Position.Add(Original.Subtract(OriginalPrev));
+    OriginalPrev := Original;
+  end;
+end;
+
+function TIKSolverState.Solve(ChainId: Integer; const Chain: TJointArray; const TargetPosition: TVector3D): TJointArray;
+var
+  Seed, Previous: TJointArray;
+  I: Integer;
+begin
+  SetLength(Seed, Length(Chain));
+  for I := 0 to High(Chain) do
+    Seed[I] := Chain[I];
+
+  if FPrevious.TryGetValue(ChainId, Previous) and (Length(Previous) = Length(Seed)) then
+    SeedFromPrevious(Seed, Previous);
+
+  if FUseCCD then
+    Result := TIKSolver.SolveCCD(Seed, TargetPosition, FIterations, FTolerance, FLastIterations)
+  else
+    Result := TIKSolver.SolveFABRIK(Seed, TargetPosition, FIterations, FTolerance, FLastIterations);
+
+  // store a copy; dynamic arrays are shared by reference
+  FPrevious.AddOrSetValue(ChainId, Copy(Result));
+end;
+
+procedure TIKSolverState.Reset(ChainId: Integer);
+begin
+  FPrevious.Remove(ChainId);
+end;
+
+procedure TIKSolverState.Reset;
+begin
+  FPrevious.Clear;
+end;
+
 end.
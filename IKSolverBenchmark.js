@@ -0,0 +1,383 @@
+/**
+ * IKSolverBenchmark.js - Speed and convergence benchmark for IKSolver.js
+ *
+ * Runs hand landmark sequences through every solver and reports solves/sec, mean
+ * iterations, residual error and heap growth per solve. Sequences are either
+ * recorded (a JSON array of frames, each 21 {x, y, z} landmarks as MediaPipe
+ * returns them) or synthetic, with fingers curling and jittering like live
+ * tracking. Targets are the fingertip of the next frame, or random points
+ * inside each finger's reach.
+ *
+ * Usage:
+ *   node --expose-gc IKSolverBenchmark.js [--frames N] [--landmarks rec.json]
+ *        [--targets next|random] [--seed S] [--json out.json] [--baseline old.json]
+ *
+ * With --baseline, any solver whose solves/sec fell more than 10% below the
+ * baseline run is reported and the process exits with code 1.
+ *
+ * With --expose-gc the flat solvers documented as allocation-free, with and without
+ * quaternions, are also checked on their own, outside the harness: young-generation
+ * growth over a short run of index finger solves, small enough that no scavenge hides
+ * what was allocated. A solver above ALLOCATION_LIMIT bytes per solve is reported and
+ * the process exits with code 1.
+ */
+
+const { IKSolver, IKSolverState, Vector3D, MediaPipeHandParents } = require('./IKSolver.js');
+const {
+    FingerChainIndices,
+    extractFingerChain,
+    createHandBatch,
+    packHandChains,
+    createSimulatedHandLandmarks
+} = require('./MediaPipeIKIntegration.js');
+
+const FINGERS = Object.keys(FingerChainIndices);
+const SCALE = 100; // the scale MediaPipeIKIntegration.js applies to landmarks
+const REGRESSION_THRESHOLD = 0.10;
+const ALLOCATION_LIMIT = 16; // bytes per solve; boxing one double per pivot is already over it
+const ALLOCATION_SOLVES = 100;
+
+function parseArgs(argv) {
+    const args = { frames: 2000, landmarks: null, targets: 'next', seed: 1, json: null, baseline: null };
+    for (let i = 2; i < argv.length; i++) {
+        const key = argv[i].replace(/^--/, '');
+        if (key in args) {
+            args[key] = key === 'frames' || key === 'seed' ? parseInt(argv[++i], 10) : argv[++i];
+        }
+    }
+    return args;
+}
+
+// Small deterministic PRNG so runs are comparable
+function createRandom(seed) {
+    let state = seed >>> 0 || 1;
+    return () => {
+        state ^= state << 13;
+        state ^= state >>> 17;
+        state ^= state << 5;
+        return (state >>> 0) / 4294967296;
+    };
+}
+
+/**
+ * Synthetic landmark sequence: the simulated open hand with each finger curling at
+ * its own rate, the wrist drifting, and per-landmark jitter similar to tracking noise
+ */
+function createSyntheticSequence(frameCount, random) {
+    const rest = createSimulatedHandLandmarks();
+    const frames = [];
+    for (let f = 0; f < frameCount; f++) {
+        const t = f / 30;
+        const drift = { x: Math.sin(t * 0.7) * 0.02, y: Math.cos(t * 0.5) * 0.02 };
+        const frame = rest.map(p => ({ x: p.x + drift.x, y: p.y + drift.y, z: p.z }));
+        FINGERS.forEach((name, k) => {
+            const indices = FingerChainIndices[name];
+            const curl = (Math.sin(t * (1 + k * 0.3)) + 1) * 0.35; // radians per joint
+            const pivot = frame[indices[1]];
+            for (let j = 2; j < indices.length; j++) {
+                // bend every joint past the knuckle about the knuckle, in the y/z plane
+                const p = frame[indices[j]];
+                const dx = p.x - pivot.x, dz = p.z - pivot.z, dy = p.y - pivot.y;
+                const a = curl * (j - 1);
+                frame[indices[j]] = {
+                    x: pivot.x + dx,
+                    y: pivot.y + dy * Math.cos(a) - dz * Math.sin(a),
+                    z: pivot.z + dy * Math.sin(a) + dz * Math.cos(a)
+                };
+            }
+        });
+        for (const p of frame) {
+            p.x += (random() - 0.5) * 0.002;
+            p.y += (random() - 0.5) * 0.002;
+            p.z += (random() - 0.5) * 0.002;
+        }
+        frames.push(frame);
+    }
+    return frames;
+}
+
+function loadSequence(args, random) {
+    if (args.landmarks) {
+        const frames = JSON.parse(require('fs').readFileSync(args.landmarks, 'utf8'));
+        return args.frames > 0 ? frames.slice(0, args.frames) : frames;
+    }
+    return createSyntheticSequence(args.frames, random);
+}
+
+/**
+ * One target per finger per frame, in the same (scaled) space as the chains
+ */
+function createTargets(frames, mode, random) {
+    return frames.map((frame, f) => FINGERS.map(name => {
+        const indices = FingerChainIndices[name];
+        if (mode === 'random') {
+            const chain = extractFingerChain(frame, name, SCALE);
+            let reach = 0;
+            for (let i = 0; i < chain.length - 1; i++) {
+                reach += chain[i].position.distance(chain[i + 1].position);
+            }
+            const base = chain[0].position;
+            const r = reach * 0.9 * Math.cbrt(random());
+            const theta = random() * Math.PI * 2, phi = Math.acos(2 * random() - 1);
+            return new Vector3D(base.x + r * Math.sin(phi) * Math.cos(theta),
+                base.y + r * Math.sin(phi) * Math.sin(theta), base.z + r * Math.cos(phi));
+        }
+        const next = frames[Math.min(f + 1, frames.length - 1)][indices[indices.length - 1]];
+        return new Vector3D(next.x * SCALE, next.y * SCALE, next.z * SCALE);
+    }));
+}
+
+function packFlat(frame, name, out) {
+    FingerChainIndices[name].forEach((index, i) => {
+        out[i * 3] = frame[index].x * SCALE;
+        out[i * 3 + 1] = frame[index].y * SCALE;
+        out[i * 3 + 2] = frame[index].z * SCALE;
+    });
+    return out;
+}
+
+function flatResidual(positions, target) {
+    const e = positions.length - 3;
+    return Math.hypot(positions[e] - target.x, positions[e + 1] - target.y, positions[e + 2] - target.z);
+}
+
+/**
+ * Solvers under test; each solves frame f and reports { solves, iterations, residual }
+ * (iterations is null where the solver does not expose it)
+ */
+function createCases() {
+    const flat = new Float32Array(15);
+    const boneLengths = new Float32Array(4);
+    const state = new IKSolverState('fabrik', 10, 0.01);
+    const batch = createHandBatch(1);
+    const hand = new Float32Array(63);
+    const tips = [4, 8, 12, 16, 20];
+    const dlsScratch = IKSolver.createDLSScratch(MediaPipeHandParents, tips);
+    const rotations = new Float32Array(15);
+    // per-finger quaternions, seeded on first use and then carried frame to frame
+    const quaternions = {};
+
+    const objectCase = (solve) => (frame, targets) => {
+        let residual = 0;
+        FINGERS.forEach((name, k) => {
+            const solved = solve(extractFingerChain(frame, name, SCALE), targets[k]);
+            residual += solved[solved.length - 1].position.distance(targets[k]);
+        });
+        return { solves: FINGERS.length, iterations: null, residual };
+    };
+    const flatCase = (solve) => (frame, targets) => {
+        let residual = 0, iterations = 0;
+        FINGERS.forEach((name, k) => {
+            iterations += solve(packFlat(frame, name, flat), targets[k], name);
+            residual += flatResidual(flat, targets[k]);
+        });
+        return { solves: FINGERS.length, iterations, residual };
+    };
+
+    return {
+        'ccd': objectCase((chain, target) => IKSolver.solveCCD(chain, target, 10, 0.01)),
+        'fabrik': objectCase((chain, target) => IKSolver.solveFABRIK(chain, target, 10, 0.01)),
+        'ccd-flat': flatCase((positions, target) => IKSolver.solveCCDFlat(positions, target, 10, 0.01)),
+        // bone rotations each frame: Euler angles re-derived after the solve, against
+        // quaternions the solver keeps current
+        'ccd-flat+euler': flatCase((positions, target) => {
+            const iterations = IKSolver.solveCCDFlat(positions, target, 10, 0.01);
+            IKSolver.calculateBoneRotationsFlat(positions, rotations);
+            return iterations;
+        }),
+        'ccd-flat+quat': flatCase((positions, target, name) => {
+            if (!quaternions[name]) {
+                quaternions[name] = IKSolver.initBoneQuaternionsFlat(positions, new Float32Array(20));
+            }
+            return IKSolver.solveCCDFlat(positions, target, 10, 0.01, quaternions[name]);
+        }),
+        'fabrik-flat': flatCase((positions, target) => IKSolver.solveFABRIKFlat(positions, target, 10, 0.01, boneLengths)),
+        'fabrik-warm': flatCase((positions, target, name) => state.solve(name, positions, target)),
+        'fabrik-batch': (frame, targets) => {
+            packHandChains([frame], batch, SCALE);
+            targets.forEach((t, k) => {
+                batch.targets[k * 3] = t.x;
+                batch.targets[k * 3 + 1] = t.y;
+                batch.targets[k * 3 + 2] = t.z;
+            });
+            const iterations = IKSolver.solveFABRIKBatch(batch.xs, batch.ys, batch.zs, batch.chainCount,
+                batch.targets, 10, 0.01, batch.scratch);
+            const end = batch.xs.length - batch.chainCount;
+            let residual = 0;
+            targets.forEach((t, k) => {
+                residual += Math.hypot(batch.xs[end + k] - t.x, batch.ys[end + k] - t.y, batch.zs[end + k] - t.z);
+            });
+            // the batch iterates until its slowest chain converges
+            return { solves: FINGERS.length, iterations: iterations * FINGERS.length, residual };
+        },
+        'dls-hand': (frame, targets) => {
+            frame.forEach((p, i) => {
+                hand[i * 3] = p.x * SCALE;
+                hand[i * 3 + 1] = p.y * SCALE;
+                hand[i * 3 + 2] = p.z * SCALE;
+            });
+            // one solve covers all five fingertips
+            const iterations = IKSolver.solveDLS(hand, MediaPipeHandParents, tips, targets, 20, 0.01, 0.1, dlsScratch);
+            let residual = 0;
+            tips.forEach((tip, k) => {
+                residual += Math.hypot(hand[tip * 3] - targets[k].x, hand[tip * 3 + 1] - targets[k].y, hand[tip * 3 + 2] - targets[k].z);
+            });
+            return { solves: FINGERS.length, iterations: iterations * FINGERS.length, residual };
+        }
+    };
+}
+
+function run(name, solveFrame, frames, targets) {
+    // warm up the JIT on a slice of the data before measuring
+    for (let f = 0; f < Math.min(200, frames.length); f++) {
+        solveFrame(frames[f], targets[f]);
+    }
+    if (global.gc) {
+        global.gc();
+    }
+
+    let solves = 0, iterations = 0, residual = 0, maxResidual = 0, hasIterations = true;
+    const heapBefore = process.memoryUsage().heapUsed;
+    const start = process.hrtime.bigint();
+    for (let f = 0; f < frames.length; f++) {
+        const r = solveFrame(frames[f], targets[f]);
+        solves += r.solves;
+        residual += r.residual;
+        maxResidual = Math.max(maxResidual, r.residual / r.solves);
+        if (r.iterations === null) {
+            hasIterations = false;
+        } else {
+            iterations += r.iterations;
+        }
+    }
+    const seconds = Number(process.hrtime.bigint() - start) / 1e9;
+    const heapAfter = process.memoryUsage().heapUsed;
+
+    return {
+        solver: name,
+        solvesPerSecond: solves / seconds,
+        meanIterations: hasIterations ? iterations / solves : null,
+        meanResidual: residual / solves,
+        maxResidual: maxResidual,
+        // heap growth without a GC in between approximates bytes allocated per solve
+        heapBytesPerSolve: Math.max(0, heapAfter - heapBefore) / solves
+    };
+}
+
+function newSpaceUsed() {
+    const space = require('v8').getHeapSpaceStatistics().find(s => s.space_name === 'new_space');
+    return space ? space.space_used_size : 0;
+}
+
+/**
+ * Bytes each allocation-free solver allocates per solve, or null without --expose-gc.
+ * Chains and targets are packed up front and copied in with set(), so the measured loop
+ * runs nothing but the solver
+ */
+function measureAllocations(frames, targets) {
+    if (!global.gc) {
+        return null;
+    }
+    const count = Math.min(ALLOCATION_SOLVES, frames.length);
+    const finger = FINGERS.indexOf('index');
+    const chains = frames.slice(0, count).map(frame => packFlat(frame, 'index', new Float32Array(15)));
+    const chainTargets = targets.slice(0, count).map(t => t[finger]);
+    const seeds = chains.map(chain => IKSolver.initBoneQuaternionsFlat(chain, new Float32Array(20)));
+    const positions = new Float32Array(15);
+    const quaternions = new Float32Array(20);
+    const boneLengths = new Float32Array(4);
+    const solvers = {
+        'ccd-flat': (p, t) => IKSolver.solveCCDFlat(p, t, 10, 0.01),
+        'fabrik-flat': (p, t) => IKSolver.solveFABRIKFlat(p, t, 10, 0.01, boneLengths),
+        'ccd-flat+quat': (p, t) => IKSolver.solveCCDFlat(p, t, 10, 0.01, quaternions),
+        'fabrik-flat+quat': (p, t) => IKSolver.solveFABRIKFlat(p, t, 10, 0.01, boneLengths, quaternions)
+    };
+
+    const measure = (solve) => {
+        global.gc();
+        const before = newSpaceUsed();
+        for (let i = 0; i < count; i++) {
+            positions.set(chains[i]);
+            quaternions.set(seeds[i]);
+            solve(positions, chainTargets[i]);
+        }
+        return newSpaceUsed() - before;
+    };
+    // what reading the heap statistics itself costs
+    let overhead = Infinity;
+    for (let trial = 0; trial < 3; trial++) {
+        overhead = Math.min(overhead, measure(() => 0));
+    }
+
+    const allocations = {};
+    for (const name of Object.keys(solvers)) {
+        // optimized code is what has to stay allocation-free
+        for (let warm = 0; warm < 200; warm++) {
+            measure(solvers[name]);
+        }
+        let bytes = 0;
+        for (let trial = 0; trial < 3; trial++) {
+            bytes = Math.max(bytes, measure(solvers[name]) - overhead);
+        }
+        allocations[name] = Math.max(0, bytes) / count;
+    }
+    return allocations;
+}
+
+function printTable(results, args, frameCount) {
+    console.log(`IK benchmark: ${frameCount} frames x ${FINGERS.length} fingers, targets=${args.targets}` +
+        `${args.landmarks ? `, recorded ${args.landmarks}` : ', synthetic landmarks'}` +
+        `${global.gc ? '' : ' (run with --expose-gc for steadier heap numbers)'}`);
+    console.log('solver          solves/s   mean iter   mean resid    max resid   heap B/solve');
+    for (const r of results) {
+        console.log(`${r.solver.padEnd(14)}${r.solvesPerSecond.toFixed(0).padStart(10)}` +
+            `${(r.meanIterations === null ? '-' : r.meanIterations.toFixed(2)).padStart(12)}` +
+            `${r.meanResidual.toFixed(4).padStart(13)}${r.maxResidual.toFixed(4).padStart(13)}` +
+            `${r.heapBytesPerSolve.toFixed(0).padStart(15)}`);
+    }
+}
+
+function compareWithBaseline(results, baselinePath) {
+    const baseline = JSON.parse(require('fs').readFileSync(baselinePath, 'utf8'));
+    let regressed = false;
+    for (const r of results) {
+        const old = baseline.results.find(b => b.solver === r.solver);
+        if (old && r.solvesPerSecond < old.solvesPerSecond * (1 - REGRESSION_THRESHOLD)) {
+            console.log(`REGRESSION ${r.solver}: ${r.solvesPerSecond.toFixed(0)} solves/s, baseline ${old.solvesPerSecond.toFixed(0)}`);
+            regressed = true;
+        }
+    }
+    return regressed;
+}
+
+function main() {
+    const args = parseArgs(process.argv);
+    const random = createRandom(args.seed);
+    const frames = loadSequence(args, random);
+    const targets = createTargets(frames, args.targets, random);
+
+    const cases = createCases();
+    const results = Object.keys(cases).map(name => run(name, cases[name], frames, targets));
+    printTable(results, args, frames.length);
+
+    if (args.json) {
+        require('fs').writeFileSync(args.json, JSON.stringify({ args, results }, null, 2));
+    }
+    if (args.baseline && compareWithBaseline(results, args.baseline)) {
+        process.exitCode = 1;
+    }
+
+    const allocations = measureAllocations(frames, targets);
+    if (allocations) {
+        console.log('allocation check: ' + Object.keys(allocations)
+            .map(name => `${name} ${allocations[name].toFixed(1)} B/solve`).join(', '));
+        for (const name of Object.keys(allocations)) {
+            if (allocations[name] > ALLOCATION_LIMIT) {
+                console.log(`ALLOCATION ${name}: ${allocations[name].toFixed(0)} B/solve, limit ${ALLOCATION_LIMIT}`);
+                process.exitCode = 1;
+            }
+        }
+    }
+}
+
+main();
@@ -0,0 +1,443 @@
+program IKSolverBenchmark;
+
+{$APPTYPE CONSOLE}
+
+{*******************************************************************************
+  IKSolverBenchmark - Speed and convergence benchmark for IKSolver.pas
+
+  Runs a hand landmark sequence through every solver and reports solves/sec,
+  mean iterations, residual error and heap allocations per solve. The sequence
+  is either recorded (a JSON array of frames, each 21 x/y/z landmarks, the same
+  file IKSolverBenchmark.js reads) or synthetic finger-curl motion with jitter.
+  Targets are the fingertip of the next frame, or random points in reach.
+
+  Usage: IKSolverBenchmark [-frames N] [-landmarks rec.json] [-random] [-seed S]
+*******************************************************************************}
+
+uses
+  System.SysUtils,
+  System.Math,
+  System.Classes,
+  System.StrUtils,
+  System.IOUtils,
+  System.JSON,
+  System.Diagnostics,
+  IKSolver in 'IKSolver.pas';
+
+const
+  FingerCount = 5;
+  FingerJoints = 5;
+  Scale = 100; // same scale as IKSolverBenchmark.js and MediaPipeIKIntegration.js
+  FingerTips: array[0..FingerCount - 1] of Integer = (4, 8, 12, 16, 20);
+
+type
+  THandFrame = array[0..20] of TVector3D;
+  TFrameTargets = array[0..FingerCount - 1] of TVector3D;
+
+  TSolveResult = record
+    Iterations: Integer; // -1 when the solver does not report it
+    Residual: Double;
+  end;
+
+  TFrameSolver = reference to function(const Frame: THandFrame; const Targets: TFrameTargets): TSolveResult;
+
+var
+  Frames: TArray<THandFrame>;
+  Targets: TArray<TFrameTargets>;
+  AllocationCount: Int64;
+  DefaultManager: TMemoryManagerEx;
+
+{ Counting memory manager: every GetMem/AllocMem/ReallocMem bumps AllocationCount }
+
+function CountingGetMem(Size: NativeInt): Pointer;
+begin
+  AtomicIncrement(AllocationCount);
+  Result := DefaultManager.GetMem(Size);
+end;
+
+function CountingAllocMem(Size: NativeInt): Pointer;
+begin
+  AtomicIncrement(AllocationCount);
+  Result := DefaultManager.AllocMem(Size);
+end;
+
+function CountingReallocMem(P: Pointer; Size: NativeInt): Pointer;
+begin
+  AtomicIncrement(AllocationCount);
+  Result := DefaultManager.ReallocMem(P, Size);
+end;
+
+procedure InstallCountingManager;
+var
+  Counting: TMemoryManagerEx;
+begin
+  GetMemoryManager(DefaultManager);
+  Counting := DefaultManager;
+  Counting.GetMem := CountingGetMem;
+  Counting.AllocMem := CountingAllocMem;
+  Counting.ReallocMem := CountingReallocMem;
+  SetMemoryManager(Counting);
+end;
+
+function FingerIndex(Finger, Joint: Integer): Integer;
+begin
+  // Joint 0 of every finger chain is the wrist, as in FingerChainIndices
+  if Joint = 0 then
+    Result := 0
+  else
+    Result := Finger * 4 + Joint;
+end;
+
+function ExtractFinger(const Frame: THandFrame; Finger: Integer): TJointArray;
+var
+  J: Integer;
+begin
+  SetLength(Result, FingerJoints);
+  for J := 0 to FingerJoints - 1 do
+    Result[J] := TJoint.Create(Frame[FingerIndex(Finger, J)]);
+end;
+
+procedure PackFlat(const Frame: THandFrame; Finger: Integer; var Flat: array of Single);
+var
+  J: Integer;
+  P: TVector3D;
+begin
+  for J := 0 to FingerJoints - 1 do
+  begin
+    P := Frame[FingerIndex(Finger, J)];
+    Flat[J * 3] := P.X;
+    Flat[J * 3 + 1] := P.Y;
+    Flat[J * 3 + 2] := P.Z;
+  end;
+end;
+
+procedure PackChain(const Frame: THandFrame; Finger: Integer; var Chain: array of TJoint);
+var
+  J: Integer;
+begin
+  for J := 0 to FingerJoints - 1 do
+    Chain[J] := TJoint.Create(Frame[FingerIndex(Finger, J)]);
+end;
+
+{ Open hand in the y/z plane, each finger curling at its own rate, plus jitter }
+procedure CreateSyntheticSequence(FrameCount: Integer);
+const
+  KnuckleX: array[0..FingerCount - 1] of Double = (-3, -1.5, 0, 1.5, 3);
+  BoneLength: array[1..4] of Double = (4, 2.5, 2, 1.5);
+var
+  F, K, J: Integer;
+  T, Curl, Angle: Double;
+  Drift, Pos: TVector3D;
+begin
+  SetLength(Frames, FrameCount);
+  for F := 0 to FrameCount - 1 do
+  begin
+    T := F / 30;
+    Drift := TVector3D.Create(Sin(T * 0.7) * 2, Cos(T * 0.5) * 2, 0);
+    Frames[F][0] := Drift;
+    for K := 0 to FingerCount - 1 do
+    begin
+      Curl := (Sin(T * (1 + K * 0.3)) + 1) * 0.35;
+      Pos := Drift.Add(TVector3D.Create(KnuckleX[K], BoneLength[1], 0));
+      Frames[F][FingerIndex(K, 1)] := Pos;
+      Angle := 0;
+      for J := 2 to 4 do
+      begin
+        Angle := Angle + Curl;
+        Pos := Pos.Add(TVector3D.Create(0, Cos(Angle), Sin(Angle)).Multiply(BoneLength[J]));
+        Frames[F][FingerIndex(K, J)] := Pos;
+      end;
+    end;
+    for J := 0 to 20 do
+      Frames[F][J] := Frames[F][J].Add(TVector3D.Create(Random - 0.5, Random - 0.5, Random - 0.5).Multiply(0.2));
+  end;
+end;
+
+procedure LoadRecordedSequence(const FileName: string; MaxFrames: Integer);
+var
+  Root: TJSONArray;
+  Landmarks: TJSONArray;
+  Point: TJSONObject;
+  F, I: Integer;
+begin
+  Root := TJSONObject.ParseJSONValue(TFile.ReadAllText(FileName)) as TJSONArray;
+  if Root = nil then
+    raise Exception.CreateFmt('%s is not a JSON array of frames', [FileName]);
+  try
+    SetLength(Frames, Min(Root.Count, MaxFrames));
+    for F := 0 to High(Frames) do
+    begin
+      Landmarks := Root.Items[F] as TJSONArray;
+      for I := 0 to 20 do
+      begin
+        Point := Landmarks.Items[I] as TJSONObject;
+        Frames[F][I] := TVector3D.Create(Point.GetValue<Double>('x'), Point.GetValue<Double>('y'),
+          Point.GetValue<Double>('z', 0)).Multiply(Scale);
+      end;
+    end;
+  finally
+    Root.Free;
+  end;
+end;
+
+procedure CreateTargets(RandomTargets: Boolean);
+var
+  F, K, J: Integer;
+  Reach, R, Theta, Phi: Double;
+  Base: TVector3D;
+begin
+  SetLength(Targets, Length(Frames));
+  for F := 0 to High(Frames) do
+    for K := 0 to FingerCount - 1 do
+      if RandomTargets then
+      begin
+        Reach := 0;
+        for J := 0 to FingerJoints - 2 do
+          Reach := Reach + Frames[F][FingerIndex(K, J)].Distance(Frames[F][FingerIndex(K, J + 1)]);
+        Base := Frames[F][0];
+        R := Reach * 0.9 * Power(Random, 1 / 3);
+        Theta := Random * 2 * Pi;
+        Phi := ArcCos(2 * Random - 1);
+        Targets[F][K] := Base.Add(TVector3D.Create(Sin(Phi) * Cos(Theta), Sin(Phi) * Sin(Theta), Cos(Phi)).Multiply(R));
+      end
+      else
+        Targets[F][K] := Frames[Min(F + 1, High(Frames))][FingerTips[K]];
+end;
+
+function FlatResidual(const Positions: array of Single; const Target: TVector3D): Double;
+var
+  E: Integer;
+begin
+  E := Length(Positions) - 3;
+  Result := TVector3D.Create(Positions[E], Positions[E + 1], Positions[E + 2]).Distance(Target);
+end;
+
+procedure Run(const Name: string; Solver: TFrameSolver; SolvesPerFrame: Integer);
+var
+  F, Iterations, Solves: Integer;
+  Residual, MaxResidual: Double;
+  HasIterations: Boolean;
+  Allocations: Int64;
+  Watch: TStopwatch;
+  R: TSolveResult;
+  IterText: string;
+begin
+  // Warm up caches and the memory manager before measuring
+  for F := 0 to Min(199, High(Frames)) do
+    Solver(Frames[F], Targets[F]);
+
+  Iterations := 0;
+  Residual := 0;
+  MaxResidual := 0;
+  HasIterations := True;
+  Allocations := AllocationCount;
+  Watch := TStopwatch.StartNew;
+  for F := 0 to High(Frames) do
+  begin
+    R := Solver(Frames[F], Targets[F]);
+    Residual := Residual + R.Residual;
+    MaxResidual := Max(MaxResidual, R.Residual / SolvesPerFrame);
+    if R.Iterations < 0 then
+      HasIterations := False
+    else
+      Inc(Iterations, R.Iterations);
+  end;
+  Watch.Stop;
+  Allocations := AllocationCount - Allocations;
+  Solves := Length(Frames) * SolvesPerFrame;
+
+  if HasIterations then
+    IterText := Format('%.2f', [Iterations / Solves])
+  else
+    IterText := '-';
+  WriteLn(Format('%-14s%10.0f%12s%13.4f%13.4f%14.2f',
+    [Name, Solves / Max(Watch.Elapsed.TotalSeconds, 1e-9), IterText,
+     Residual / Solves, MaxResidual, Allocations / Solves]));
+end;
+
+procedure RunAll;
+var
+  State: TIKSolverState;
+  Flat: array[0..FingerJoints * 3 - 1] of Single;
+  Chain: array[0..FingerJoints - 1] of TJoint;
+  Tips: array[0..FingerCount - 1] of Integer;
+  K: Integer;
+begin
+  for K := 0 to FingerCount - 1 do
+    Tips[K] := FingerTips[K];
+
+  WriteLn('solver          solves/s   mean iter   mean resid    max resid  allocs/solve');
+
+  Run('ccd', function(const Frame: THandFrame; const T: TFrameTargets): TSolveResult
+    var
+      F, Used: Integer;
+      Solved: TJointArray;
+    begin
+      Result.Iterations := 0;
+      Result.Residual := 0;
+      for F := 0 to FingerCount - 1 do
+      begin
+        Solved := TIKSolver.SolveCCD(ExtractFinger(Frame, F), T[F], 10, 0.01, Used);
+        Inc(Result.Iterations, Used);
+        Result.Residual := Result.Residual + Solved[High(Solved)].Position.Distance(T[F]);
+      end;
+    end, FingerCount);
+
+  Run('fabrik', function(const Frame: THandFrame; const T: TFrameTargets): TSolveResult
+    var
+      F, Used: Integer;
+      Solved: TJointArray;
+    begin
+      Result.Iterations := 0;
+      Result.Residual := 0;
+      for F := 0 to FingerCount - 1 do
+      begin
+        Solved := TIKSolver.SolveFABRIK(ExtractFinger(Frame, F), T[F], 10, 0.01, Used);
+        Inc(Result.Iterations, Used);
+        Result.Residual := Result.Residual + Solved[High(Solved)].Position.Distance(T[F]);
+      end;
+    end, FingerCount);
+
+  Run('ccd-inplace', function(const Frame: THandFrame; const T: TFrameTargets): TSolveResult
+    var
+      F, Used: Integer;
+    begin
+      Result.Iterations := 0;
+      Result.Residual := 0;
+      for F := 0 to FingerCount - 1 do
+      begin
+        PackChain(Frame, F, Chain);
+        TIKSolver.SolveCCDInPlace(Chain, T[F], 10, 0.01, Used);
+        Inc(Result.Iterations, Used);
+        Result.Residual := Result.Residual + Chain[High(Chain)].Position.Distance(T[F]);
+      end;
+    end, FingerCount);
+
+  Run('fabrik-inplace', function(const Frame: THandFrame; const T: TFrameTargets): TSolveResult
+    var
+      F, Used: Integer;
+    begin
+      Result.Iterations := 0;
+      Result.Residual := 0;
+      for F := 0 to FingerCount - 1 do
+      begin
+        PackChain(Frame, F, Chain);
+        TIKSolver.SolveFABRIKInPlace(Chain, T[F], 10, 0.01, Used);
+        Inc(Result.Iterations, Used);
+        Result.Residual := Result.Residual + Chain[High(Chain)].Position.Distance(T[F]);
+      end;
+    end, FingerCount);
+
+  Run('ccd-flat', function(const Frame: THandFrame; const T: TFrameTargets): TSolveResult
+    var
+      F: Integer;
+    begin
+      Result.Iterations := 0;
+      Result.Residual := 0;
+      for F := 0 to FingerCount - 1 do
+      begin
+        PackFlat(Frame, F, Flat);
+        Inc(Result.Iterations, TIKSolver.SolveCCDFlat(Flat, T[F]));
+        Result.Residual := Result.Residual + FlatResidual(Flat, T[F]);
+      end;
+    end, FingerCount);
+
+  Run('fabrik-flat', function(const Frame: THandFrame; const T: TFrameTargets): TSolveResult
+    var
+      F: Integer;
+    begin
+      Result.Iterations := 0;
+      Result.Residual := 0;
+      for F := 0 to FingerCount - 1 do
+      begin
+        PackFlat(Frame, F, Flat);
+        Inc(Result.Iterations, TIKSolver.SolveFABRIKFlat(Flat, T[F]));
+        Result.Residual := Result.Residual + FlatResidual(Flat, T[F]);
+      end;
+    end, FingerCount);
+
+  State := TIKSolverState.Create;
+  try
+    Run('fabrik-warm', function(const Frame: THandFrame; const T: TFrameTargets): TSolveResult
+      var
+        F: Integer;
+        Solved: TJointArray;
+      begin
+        Result.Iterations := 0;
+        Result.Residual := 0;
+        for F := 0 to FingerCount - 1 do
+        begin
+          Solved := State.Solve(F, ExtractFinger(Frame, F), T[F]);
+          Inc(Result.Iterations, State.LastIterations);
+          Result.Residual := Result.Residual + Solved[High(Solved)].Position.Distance(T[F]);
+        end;
+      end, FingerCount);
+  finally
+    State.Free;
+  end;
+
+  // One DLS solve moves all five fingertips; it is reported per fingertip
+  Run('dls-hand', function(const Frame: THandFrame; const T: TFrameTargets): TSolveResult
+    var
+      I, Used: Integer;
+      Skeleton, Solved: TJointArray;
+    begin
+      SetLength(Skeleton, Length(Frame));
+      for I := 0 to High(Frame) do
+        Skeleton[I] := TJoint.Create(Frame[I]);
+      Solved := TIKSolver.SolveDLS(Skeleton, MediaPipeHandParents, Tips, T, 20, 0.01, 0.1, Used);
+      Result.Iterations := Used * FingerCount;
+      Result.Residual := 0;
+      for I := 0 to FingerCount - 1 do
+        Result.Residual := Result.Residual + Solved[Tips[I]].Position.Distance(T[I]);
+    end, FingerCount);
+end;
+
+var
+  I, FrameCount: Integer;
+  LandmarkFile: string;
+  RandomTargets: Boolean;
+begin
+  try
+    FrameCount := 2000;
+    LandmarkFile := '';
+    RandomTargets := False;
+    RandSeed := 1;
+    I := 1;
+    while I <= ParamCount do
+    begin
+      if SameText(ParamStr(I), '-frames') and (I < ParamCount) then
+      begin
+        Inc(I);
+        FrameCount := StrToInt(ParamStr(I));
+      end
+      else if SameText(ParamStr(I), '-landmarks') and (I < ParamCount) then
+      begin
+        Inc(I);
+        LandmarkFile := ParamStr(I);
+      end
+      else if SameText(ParamStr(I), '-seed') and (I < ParamCount) then
+      begin
+        Inc(I);
+        RandSeed := StrToInt(ParamStr(I));
+      end
+      else if SameText(ParamStr(I), '-random') then
+        RandomTargets := True;
+      Inc(I);
+    end;
+
+    if LandmarkFile <> '' then
+      LoadRecordedSequence(LandmarkFile, FrameCount)
+    else
+      CreateSyntheticSequence(FrameCount);
+    CreateTargets(RandomTargets);
+
+    WriteLn(Format('IK benchmark: %d frames x %d fingers, %s targets', [Length(Frames), FingerCount,
+      IfThen(RandomTargets, 'random', 'next-frame')]));
+    InstallCountingManager;
+    RunAll;
+  except
+    on E: Exception do
+      WriteLn(E.ClassName, ': ', E.Message);
+  end;
+end.
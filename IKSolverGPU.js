@@ -0,0 +1,432 @@
+/**
+ * IKSolverGPU.js - Batched FABRIK for thousands of chains on the GPU (WebGPU compute)
+ *
+ * IKGPUBatchSolver solves the same struct-of-arrays batch as IKSolver.solveFABRIKBatch,
+ * with the same optional joint limits (IKSolver.createBatchLimits), in one compute
+ * dispatch: one invocation per chain, coordinates joint-major so neighbouring
+ * invocations read neighbouring floats. The GPU works in single precision, so results
+ * match the CPU solver to float rounding, not bit for bit.
+ *
+ * Without WebGPU (Node, older browsers, a lost device) solve() runs on the CPU instead:
+ * IKSolverWasm's SIMD batch in groups of its chain limit when the module is loaded and
+ * no limits are set, otherwise IKSolver.solveFABRIKBatch over the whole batch.
+ */
+
+const { IKSolver: IKSolverBase } = (typeof module !== 'undefined' && module.exports)
+    ? require('./IKSolver.js')
+    : { IKSolver };
+
+// Chain length the kernel's private bone length array holds (IKMaxChainJoints elsewhere)
+const GPU_MAX_CHAIN_JOINTS = 32;
+const GPU_WORKGROUP_SIZE = 64;
+// chainCount, jointCount, iterations, hasLimits, tolerance; padded to 16 bytes
+const GPU_PARAMS_BYTES = 32;
+
+const FABRIK_BATCH_WGSL = `
+struct Params {
+    chainCount: u32,
+    jointCount: u32,
+    iterations: u32,
+    hasLimits: u32,
+    tolerance: f32,
+};
+
+@group(0) @binding(0) var<uniform> params: Params;
+// xs, then ys, then zs, each jointCount * chainCount floats, joint-major
+@group(0) @binding(1) var<storage, read_write> positions: array<f32>;
+@group(0) @binding(2) var<storage, read> goals: array<f32>;
+// minAngle, maxAngle, hinge axis x, y, z per joint and chain (IKSolver.createBatchLimits)
+@group(0) @binding(3) var<storage, read> limits: array<f32>;
+@group(0) @binding(4) var<storage, read_write> slowest: atomic<u32>;
+
+const MAX_JOINTS: u32 = ${GPU_MAX_CHAIN_JOINTS}u;
+const TO_RADIANS: f32 = 0.017453292519943295;
+
+fn readJoint(j: u32) -> vec3<f32> {
+    let plane = params.chainCount * params.jointCount;
+    return vec3<f32>(positions[j], positions[plane + j], positions[2u * plane + j]);
+}
+
+fn writeJoint(j: u32, p: vec3<f32>) {
+    let plane = params.chainCount * params.jointCount;
+    positions[j] = p.x;
+    positions[plane + j] = p.y;
+    positions[2u * plane + j] = p.z;
+}
+
+fn safeNormalize(v: vec3<f32>) -> vec3<f32> {
+    let len = length(v);
+    if (len > 0.0) {
+        return v / len;
+    }
+    return vec3<f32>(0.0);
+}
+
+// IKSolver.constrainDirection; o is the joint's first float in limits
+fn constrainDirection(previous: vec3<f32>, direction: vec3<f32>, o: u32, isReverse: bool) -> vec3<f32> {
+    let minAngle = limits[o];
+    let maxAngle = limits[o + 1u];
+    let rawAxis = vec3<f32>(limits[o + 2u], limits[o + 3u], limits[o + 4u]);
+    if (dot(rawAxis, rawAxis) > 0.0) {
+        let axis = normalize(rawAxis);
+        let q = previous - axis * dot(axis, previous);
+        var e = direction - axis * dot(axis, direction);
+        if (length(q) < 1e-6) {
+            return direction;
+        }
+        if (length(e) < 1e-6) {
+            e = q;
+        }
+        let qn = normalize(q);
+        let en = normalize(e);
+        let angle = atan2(dot(axis, cross(qn, en)), dot(qn, en)) / TO_RADIANS;
+        var lo = minAngle;
+        var hi = maxAngle;
+        if (isReverse) {
+            lo = -maxAngle;
+            hi = -minAngle;
+        }
+        let clamped = max(lo, min(hi, angle)) * TO_RADIANS;
+        // qn is normal to the axis, so Rodrigues reduces to two terms
+        return safeNormalize(qn * cos(clamped) + cross(axis, qn) * sin(clamped));
+    }
+
+    let lo = max(0.0, minAngle);
+    let hi = min(180.0, max(-minAngle, maxAngle));
+    let d = dot(previous, direction);
+    let angle = acos(clamp(d, -1.0, 1.0)) / TO_RADIANS;
+    if (angle >= lo && angle <= hi) {
+        return direction;
+    }
+    var side = direction - previous * d;
+    if (length(side) < 1e-6) {
+        if (abs(previous.x) < 0.9) {
+            side = vec3<f32>(0.0, -previous.z, previous.y);
+        } else {
+            side = vec3<f32>(previous.z, 0.0, -previous.x);
+        }
+    }
+    side = normalize(side);
+    let clamped = max(lo, min(hi, angle)) * TO_RADIANS;
+    return previous * cos(clamped) + side * sin(clamped);
+}
+
+@compute @workgroup_size(${GPU_WORKGROUP_SIZE})
+fn main(@builtin(global_invocation_id) id: vec3<u32>) {
+    let c = id.x;
+    let cc = params.chainCount;
+    let n = params.jointCount;
+    if (c >= cc) {
+        return;
+    }
+
+    var lengths: array<f32, MAX_JOINTS>;
+    var total = 0.0;
+    for (var i = 0u; i + 1u < n; i++) {
+        let len = distance(readJoint(i * cc + c), readJoint((i + 1u) * cc + c));
+        lengths[i] = len;
+        total += len;
+    }
+    let rootPos = readJoint(c);
+    let goal = vec3<f32>(goals[c * 3u], goals[c * 3u + 1u], goals[c * 3u + 2u]);
+    let toGoal = goal - rootPos;
+    let dist = length(toGoal);
+
+    // Unreachable: stretch towards the target, no iterations
+    if (dist > total) {
+        let direction = toGoal / dist;
+        for (var i = 1u; i < n; i++) {
+            writeJoint(i * cc + c, readJoint((i - 1u) * cc + c) + direction * lengths[i - 1u]);
+        }
+        return;
+    }
+
+    // Same test as IKSolver.hasConstraints
+    var constrained = false;
+    if (params.hasLimits != 0u) {
+        for (var i = 1u; i + 1u < n; i++) {
+            let o = (i * cc + c) * 5u;
+            let minAngle = limits[o];
+            if (limits[o + 2u] != 0.0 || limits[o + 3u] != 0.0 || limits[o + 4u] != 0.0 ||
+                minAngle > 0.0 || max(-minAngle, limits[o + 1u]) < 180.0) {
+                constrained = true;
+            }
+        }
+    }
+
+    let endIndex = (n - 1u) * cc + c;
+    var iter = 0u;
+    loop {
+        if (iter >= params.iterations || distance(readJoint(endIndex), goal) < params.tolerance) {
+            break;
+        }
+
+        // Forward reaching phase
+        writeJoint(endIndex, goal);
+        for (var k = 0u; k + 1u < n; k++) {
+            let i = n - 2u - k;
+            let src = readJoint((i + 1u) * cc + c);
+            var direction = safeNormalize(readJoint(i * cc + c) - src);
+            if (constrained && i + 2u < n) {
+                // Bone i enters joint i + 1, whose outgoing bone is already placed
+                let next = safeNormalize(readJoint((i + 2u) * cc + c) - src);
+                direction = -constrainDirection(next, -direction, ((i + 1u) * cc + c) * 5u, true);
+            }
+            writeJoint(i * cc + c, src + direction * lengths[i]);
+        }
+
+        // Backward reaching phase
+        writeJoint(c, rootPos);
+        for (var i = 0u; i + 1u < n; i++) {
+            let src = readJoint(i * cc + c);
+            var direction = safeNormalize(readJoint((i + 1u) * cc + c) - src);
+            if (constrained && i > 0u) {
+                let previous = safeNormalize(src - readJoint((i - 1u) * cc + c));
+                direction = constrainDirection(previous, direction, (i * cc + c) * 5u, false);
+            }
+            writeJoint((i + 1u) * cc + c, src + direction * lengths[i]);
+        }
+        iter++;
+    }
+    atomicMax(&slowest, iter);
+}
+`;
+
+class IKGPUBatchSolver {
+    /**
+     * Use create(); the constructor only sets up the CPU path
+     */
+    constructor(chainCount, jointCount, cpuSolver) {
+        this.chainCount = chainCount;
+        this.jointCount = jointCount;
+        this.cpuSolver = cpuSolver;
+        this._limits = null;
+        this._scratch = IKSolverBase.createBatchScratch(chainCount, jointCount);
+        this._groups = null;
+        this._gpu = null;
+        this._isBusy = false;
+    }
+
+    /**
+     * Create a solver for a fixed batch shape, on the GPU when WebGPU is available
+     * @param {Number} chainCount - Chains solved together
+     * @param {Number} jointCount - Joints per chain (2..32)
+     * @param {Object} options - { device: GPUDevice to use, cpuSolver: IKSolver or IKSolverWasm
+     *                           for the fallback, forceCPU: skip WebGPU }
+     * @returns {Promise<IKGPUBatchSolver>}
+     */
+    static async create(chainCount, jointCount, options = {}) {
+        if (chainCount < 1 || jointCount < 2 || jointCount > GPU_MAX_CHAIN_JOINTS) {
+            throw new Error(`Chains must have 2 to ${GPU_MAX_CHAIN_JOINTS} joints`);
+        }
+        const solver = new IKGPUBatchSolver(chainCount, jointCount, options.cpuSolver || IKSolverBase);
+        if (options.forceCPU) {
+            return solver;
+        }
+        try {
+            let device = options.device || null;
+            if (!device && typeof navigator !== 'undefined' && navigator.gpu) {
+                const adapter = await navigator.gpu.requestAdapter();
+                device = adapter ? await adapter.requestDevice() : null;
+            }
+            if (device) {
+                await solver._initGPU(device);
+            }
+        } catch (error) {
+            solver._gpu = null;
+        }
+        return solver;
+    }
+
+    /**
+     * True while solves run on the GPU; turns false if the device is lost
+     */
+    get isGPU() {
+        return !!this._gpu;
+    }
+
+    /**
+     * Joint limits for every later solve, or null for none
+     * @param {Float32Array} limits - From IKSolver.createBatchLimits(chainCount, jointCount)
+     */
+    setLimits(limits) {
+        if (limits && limits.length !== this.chainCount * this.jointCount * 5) {
+            throw new Error("Limits must come from createBatchLimits(chainCount, jointCount)");
+        }
+        this._limits = limits;
+        if (this._gpu && limits) {
+            this._gpu.device.queue.writeBuffer(this._gpu.limits, 0, limits);
+        }
+    }
+
+    /**
+     * Solve the batch in place. Only one solve may be in flight per solver
+     * @param {Float32Array} xs - X of every joint, xs[joint * chainCount + chain]
+     * @param {Float32Array} ys - Y of every joint
+     * @param {Float32Array} zs - Z of every joint
+     * @param {Float32Array} targets - Interleaved x, y, z target per chain
+     * @param {Number} iterations - Maximum iterations (default: 10)
+     * @param {Number} tolerance - Distance tolerance for convergence (default: 0.01)
+     * @returns {Promise<Number>} - Iterations used by the slowest chain
+     */
+    async solve(xs, ys, zs, targets, iterations = 10, tolerance = 0.01) {
+        if (this._isBusy) {
+            throw new Error("A solve is already in flight");
+        }
+        this._isBusy = true;
+        try {
+            return this._gpu
+                ? await this._solveGPU(xs, ys, zs, targets, iterations, tolerance)
+                : this._solveCPU(xs, ys, zs, targets, iterations, tolerance);
+        } finally {
+            this._isBusy = false;
+        }
+    }
+
+    /**
+     * Release the GPU buffers; the solver keeps working on the CPU
+     */
+    destroy() {
+        if (this._gpu) {
+            const g = this._gpu;
+            this._gpu = null;
+            [g.params, g.positions, g.targets, g.limits, g.result, g.readback].forEach(buffer => buffer.destroy());
+        }
+    }
+
+    async _initGPU(device) {
+        const planeBytes = this.chainCount * this.jointCount * 4;
+        const STORAGE = GPUBufferUsage.STORAGE, COPY_DST = GPUBufferUsage.COPY_DST, COPY_SRC = GPUBufferUsage.COPY_SRC;
+        const g = {
+            device,
+            planeBytes,
+            params: device.createBuffer({ size: GPU_PARAMS_BYTES, usage: GPUBufferUsage.UNIFORM | COPY_DST }),
+            positions: device.createBuffer({ size: planeBytes * 3, usage: STORAGE | COPY_DST | COPY_SRC }),
+            targets: device.createBuffer({ size: this.chainCount * 12, usage: STORAGE | COPY_DST }),
+            limits: device.createBuffer({ size: planeBytes * 5, usage: STORAGE | COPY_DST }),
+            result: device.createBuffer({ size: 4, usage: STORAGE | COPY_DST | COPY_SRC }),
+            // positions, then the slowest chain's iteration count
+            readback: device.createBuffer({ size: planeBytes * 3 + 4, usage: GPUBufferUsage.MAP_READ | COPY_DST }),
+            paramData: new ArrayBuffer(GPU_PARAMS_BYTES)
+        };
+        // createComputePipelineAsync rejects on a shader or layout error, so create() falls back
+        g.pipeline = await device.createComputePipelineAsync({
+            layout: 'auto',
+            compute: { module: device.createShaderModule({ code: FABRIK_BATCH_WGSL }), entryPoint: 'main' }
+        });
+        g.bindGroup = device.createBindGroup({
+            layout: g.pipeline.getBindGroupLayout(0),
+            entries: [g.params, g.positions, g.targets, g.limits, g.result].map((buffer, binding) => ({ binding, resource: { buffer } }))
+        });
+        if (this._limits) {
+            device.queue.writeBuffer(g.limits, 0, this._limits);
+        }
+        device.lost.then(() => {
+            if (this._gpu === g) {
+                this._gpu = null;
+            }
+        });
+        this._gpu = g;
+    }
+
+    async _solveGPU(xs, ys, zs, targets, iterations, tolerance) {
+        const g = this._gpu;
+        const queue = g.device.queue;
+        const plane = this.chainCount * this.jointCount;
+
+        const words = new Uint32Array(g.paramData);
+        words[0] = this.chainCount;
+        words[1] = this.jointCount;
+        words[2] = iterations;
+        words[3] = this._limits ? 1 : 0;
+        new Float32Array(g.paramData)[4] = tolerance;
+        queue.writeBuffer(g.params, 0, g.paramData);
+        queue.writeBuffer(g.positions, 0, xs, 0, plane);
+        queue.writeBuffer(g.positions, g.planeBytes, ys, 0, plane);
+        queue.writeBuffer(g.positions, g.planeBytes * 2, zs, 0, plane);
+        queue.writeBuffer(g.targets, 0, targets, 0, this.chainCount * 3);
+
+        const encoder = g.device.createCommandEncoder();
+        encoder.clearBuffer(g.result);
+        const pass = encoder.beginComputePass();
+        pass.setPipeline(g.pipeline);
+        pass.setBindGroup(0, g.bindGroup);
+        pass.dispatchWorkgroups(Math.ceil(this.chainCount / GPU_WORKGROUP_SIZE));
+        pass.end();
+        encoder.copyBufferToBuffer(g.positions, 0, g.readback, 0, g.planeBytes * 3);
+        encoder.copyBufferToBuffer(g.result, 0, g.readback, g.planeBytes * 3, 4);
+        queue.submit([encoder.finish()]);
+
+        await g.readback.mapAsync(GPUMapMode.READ);
+        const mapped = g.readback.getMappedRange();
+        const solved = new Float32Array(mapped, 0, plane * 3);
+        xs.set(solved.subarray(0, plane));
+        ys.set(solved.subarray(plane, plane * 2));
+        zs.set(solved.subarray(plane * 2));
+        const used = new Uint32Array(mapped, g.planeBytes * 3, 1)[0];
+        g.readback.unmap();
+        return used;
+    }
+
+    _solveCPU(xs, ys, zs, targets, iterations, tolerance) {
+        const cpu = this.cpuSolver;
+        const group = this._limits ? Infinity : (cpu.maxBatchChains || Infinity);
+        if (group >= this.chainCount) {
+            return cpu.solveFABRIKBatch(xs, ys, zs, this.chainCount, targets, iterations, tolerance, this._scratch, this._limits);
+        }
+
+        // The SIMD batch takes at most `group` chains: gather each group's columns, solve, scatter
+        const cc = this.chainCount, n = this.jointCount;
+        let slowest = 0;
+        for (let start = 0; start < cc; start += group) {
+            const g = Math.min(group, cc - start);
+            const buffers = this._groupBuffers(g);
+            for (let j = 0; j < n; j++) {
+                for (let k = 0; k < g; k++) {
+                    buffers.xs[j * g + k] = xs[j * cc + start + k];
+                    buffers.ys[j * g + k] = ys[j * cc + start + k];
+                    buffers.zs[j * g + k] = zs[j * cc + start + k];
+                }
+            }
+            for (let k = 0; k < g * 3; k++) {
+                buffers.targets[k] = targets[start * 3 + k];
+            }
+            slowest = Math.max(slowest, cpu.solveFABRIKBatch(buffers.xs, buffers.ys, buffers.zs, g,
+                buffers.targets, iterations, tolerance, buffers.scratch));
+            for (let j = 0; j < n; j++) {
+                for (let k = 0; k < g; k++) {
+                    xs[j * cc + start + k] = buffers.xs[j * g + k];
+                    ys[j * cc + start + k] = buffers.ys[j * g + k];
+                    zs[j * cc + start + k] = buffers.zs[j * g + k];
+                }
+            }
+        }
+        return slowest;
+    }
+
+    // Group buffers by chain count (a full group and the remainder), in module memory when the
+    // CPU solver has one so the SIMD batch solves them without copying
+    _groupBuffers(chains) {
+        this._groups = this._groups || {};
+        if (!this._groups[chains]) {
+            const cpu = this.cpuSolver;
+            const allocate = count => cpu.createSharedBuffer ? cpu.createSharedBuffer(count) : new Float32Array(count);
+            const size = chains * this.jointCount;
+            this._groups[chains] = {
+                xs: allocate(size),
+                ys: allocate(size),
+                zs: allocate(size),
+                targets: new Float32Array(chains * 3),
+                scratch: IKSolverBase.createBatchScratch(chains, this.jointCount)
+            };
+        }
+        return this._groups[chains];
+    }
+}
+
+// Export for use in Node.js or browser
+if (typeof module !== 'undefined' && module.exports) {
+    module.exports = { IKGPUBatchSolver, FABRIK_BATCH_WGSL };
+} else {
+    window.IKGPUBatchSolver = IKGPUBatchSolver;
+}
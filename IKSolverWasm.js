@@ -0,0 +1,160 @@
+/**
+ * IKSolverWasm.js - IKSolver backed by the WebAssembly build of dll/ik_solver
+ *
+ * IKSolverWasm extends IKSolver, so it has the same API. The flat-buffer and batched
+ * solvers (solveFABRIKFlat, solveCCDFlat, solveFABRIKBatch) run in the native module
+ * once load() has finished, and everything else, including those three when WASM is
+ * unavailable, falls back to the JavaScript implementation.
+ *
+ * Buffers returned by createSharedBuffer() live in the module's memory and are solved
+ * in place with no copying; any other Float32Array is copied in and out per call.
+ * See IK_README.md for the emcc command that produces ik_solver_wasm.js/.wasm.
+ */
+
+const { IKSolver: IKSolverBase } = (typeof module !== 'undefined' && module.exports)
+    ? require('./IKSolver.js')
+    : { IKSolver };
+
+// Limits of the native solver (IK_MAX_CHAIN_JOINTS / IK_MAX_BATCH_CHAINS in ik_solver.h)
+const WASM_MAX_CHAIN_JOINTS = 32;
+const WASM_MAX_BATCH_CHAINS = 64;
+
+class IKSolverWasm extends IKSolverBase {
+    /**
+     * Instantiate the WebAssembly module; until this resolves every call runs in JavaScript
+     * @param {Function} createModule - Factory emitted by emcc (createIKSolverModule); in Node it
+     *                                  defaults to require('./ik_solver_wasm.js')
+     * @returns {Promise<Boolean>} - True when the native solvers are in use
+     */
+    static async load(createModule = null) {
+        try {
+            const factory = createModule || require('./ik_solver_wasm.js');
+            const mod = await factory();
+            const batchFloats = WASM_MAX_CHAIN_JOINTS * WASM_MAX_BATCH_CHAINS;
+
+            // Scratch for callers whose buffers are not in module memory; allocated once
+            IKSolverWasm._scratch = {
+                chain: mod._malloc(WASM_MAX_CHAIN_JOINTS * 3 * 4),
+                target: mod._malloc(WASM_MAX_BATCH_CHAINS * 3 * 4),
+                iterations: mod._malloc(4),
+                xs: mod._malloc(batchFloats * 4),
+                ys: mod._malloc(batchFloats * 4),
+                zs: mod._malloc(batchFloats * 4)
+            };
+            IKSolverWasm._module = mod;
+        } catch (error) {
+            IKSolverWasm._module = null;
+        }
+        return IKSolverWasm.isLoaded;
+    }
+
+    static get isLoaded() {
+        return !!IKSolverWasm._module;
+    }
+
+    /**
+     * Allocate a Float32Array inside module memory, e.g. the landmark buffer of a whole
+     * holistic skeleton; solving it needs no copies. Falls back to a plain Float32Array.
+     * @param {Number} floatCount - Number of floats
+     * @returns {Float32Array}
+     */
+    static createSharedBuffer(floatCount) {
+        const mod = IKSolverWasm._module;
+        if (!mod) {
+            return new Float32Array(floatCount);
+        }
+        return new Float32Array(mod.HEAPF32.buffer, mod._malloc(floatCount * 4), floatCount);
+    }
+
+    static solveFABRIKFlat(positions, targetPosition, iterations = 10, tolerance = 0.01, boneLengths = null) {
+        const used = IKSolverWasm._solveChain(1, positions, targetPosition, iterations, tolerance);
+        return used !== null ? used : super.solveFABRIKFlat(positions, targetPosition, iterations, tolerance, boneLengths);
+    }
+
+    static solveCCDFlat(positions, targetPosition, iterations = 10, tolerance = 0.01) {
+        const used = IKSolverWasm._solveChain(0, positions, targetPosition, iterations, tolerance);
+        return used !== null ? used : super.solveCCDFlat(positions, targetPosition, iterations, tolerance);
+    }
+
+    /**
+     * Most chains one native solveFABRIKBatch call takes; larger batches (and every batch
+     * before load()) run in JavaScript, so callers with many chains solve in groups this size
+     */
+    static get maxBatchChains() {
+        return IKSolverWasm._module ? WASM_MAX_BATCH_CHAINS : Infinity;
+    }
+
+    static solveFABRIKBatch(xs, ys, zs, chainCount, targets, iterations = 10, tolerance = 0.01, scratch = null, limits = null) {
+        const mod = IKSolverWasm._module;
+        const jointCount = xs.length / chainCount;
+        // The native batch has no joint limits
+        if (!mod || limits || chainCount > WASM_MAX_BATCH_CHAINS || jointCount > WASM_MAX_CHAIN_JOINTS) {
+            return super.solveFABRIKBatch(xs, ys, zs, chainCount, targets, iterations, tolerance, scratch, limits);
+        }
+
+        const work = IKSolverWasm._scratch;
+        const heap = mod.HEAPF32;
+        const px = IKSolverWasm._enter(xs, work.xs), py = IKSolverWasm._enter(ys, work.ys), pz = IKSolverWasm._enter(zs, work.zs);
+        heap.set(targets.subarray ? targets.subarray(0, chainCount * 3) : targets.slice(0, chainCount * 3), work.target >> 2);
+
+        const ok = mod._Mediapipe_IK_Solve_Chain_Batch(px, py, pz, chainCount, jointCount, work.target, iterations, tolerance, work.iterations);
+        IKSolverWasm._leave(xs, px);
+        IKSolverWasm._leave(ys, py);
+        IKSolverWasm._leave(zs, pz);
+        if (!ok) {
+            throw new Error("Chain must have at least 2 joints");
+        }
+        return mod.HEAP32[work.iterations >> 2];
+    }
+
+    // Solve one interleaved chain natively; null means "use the JavaScript solver"
+    static _solveChain(solverType, positions, targetPosition, iterations, tolerance) {
+        const mod = IKSolverWasm._module;
+        const jointCount = positions.length / 3;
+        if (!mod || jointCount > WASM_MAX_CHAIN_JOINTS) {
+            return null;
+        }
+
+        const work = IKSolverWasm._scratch;
+        const ptr = IKSolverWasm._enter(positions, work.chain);
+        const heap = mod.HEAPF32;
+        heap[work.target >> 2] = targetPosition.x;
+        heap[(work.target >> 2) + 1] = targetPosition.y;
+        heap[(work.target >> 2) + 2] = targetPosition.z;
+
+        const ok = mod._Mediapipe_IK_Solve_Chain(ptr, jointCount, work.target, solverType, iterations, tolerance, 0, work.iterations);
+        IKSolverWasm._leave(positions, ptr);
+        if (!ok) {
+            throw new Error("Chain must have at least 2 joints");
+        }
+        return mod.HEAP32[work.iterations >> 2];
+    }
+
+    // Pointer to the data of array in module memory, copying it into scratch if it lives elsewhere
+    static _enter(array, scratchPtr) {
+        const heap = IKSolverWasm._module.HEAPF32;
+        if (array.buffer === heap.buffer) {
+            return array.byteOffset;
+        }
+        heap.set(array, scratchPtr >> 2);
+        return scratchPtr;
+    }
+
+    // Copy a solved scratch copy back into the caller's array
+    static _leave(array, ptr) {
+        const heap = IKSolverWasm._module.HEAPF32;
+        if (array.buffer !== heap.buffer) {
+            array.set(heap.subarray(ptr >> 2, (ptr >> 2) + array.length));
+        }
+    }
+}
+
+IKSolverWasm._module = null;
+IKSolverWasm._scratch = null;
+
+// Export for use in Node.js or browser
+if (typeof module !== 'undefined' && module.exports) {
+    module.exports = { IKSolverWasm };
+} else {
+    window.IKSolverWasm = IKSolverWasm;
+}
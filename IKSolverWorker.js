@@ -0,0 +1,184 @@
+/**
+ * IKSolverWorker.js - Off-main-thread IK solving over SharedArrayBuffer
+ *
+ * Loaded with a <script> tag this file defines IKWorkerPipeline for the page; loaded
+ * with new Worker('IKSolverWorker.js') it is the solver loop. The page writes each
+ * frame's chain and target into a small ring of request slots in shared memory and
+ * returns immediately; the worker always solves the newest request (older unsolved
+ * ones are skipped) and publishes the result into a second ring. Nothing is posted
+ * or structured-cloned per frame, so rendering keeps its own rate when a solve is slow.
+ *
+ * SharedArrayBuffer needs a cross-origin isolated page (COOP: same-origin and
+ * COEP: require-corp). Without it IKWorkerPipeline solves on the calling thread.
+ */
+
+// Int32 control words at the start of the shared buffer
+const IK_PIPE_REQUEST_SEQ = 0;  // sequence number of the newest request
+const IK_PIPE_RESULT_SEQ = 1;   // count of published results; result k lives in slot k % slotCount
+const IK_PIPE_RUNNING = 2;      // 1 while the worker should keep serving
+const IK_PIPE_CONTROL_WORDS = 4;
+
+// Slot header (floats): algorithm (0 = CCD, 1 = FABRIK), iterations, tolerance, target x/y/z
+const IK_PIPE_HEADER_FLOATS = 6;
+
+/**
+ * Float offsets of the request and result rings inside the shared buffer
+ * @param {Number} jointCount - Joints per chain
+ * @param {Number} slotCount - Slots per ring
+ * @returns {Object}
+ */
+function ikPipeLayout(jointCount, slotCount) {
+    const requestSlotFloats = IK_PIPE_HEADER_FLOATS + jointCount * 3;
+    const resultSlotFloats = 1 + jointCount * 3; // iterations used, then positions
+    return {
+        jointCount: jointCount,
+        slotCount: slotCount,
+        requestSlotFloats: requestSlotFloats,
+        resultSlotFloats: resultSlotFloats,
+        requestBase: IK_PIPE_CONTROL_WORDS,
+        resultBase: IK_PIPE_CONTROL_WORDS + requestSlotFloats * slotCount,
+        totalFloats: IK_PIPE_CONTROL_WORDS + (requestSlotFloats + resultSlotFloats) * slotCount
+    };
+}
+
+/**
+ * Page-side handle: submit() from input/landmark callbacks, read() from requestAnimationFrame
+ */
+class IKWorkerPipeline {
+    /**
+     * @param {Number} jointCount - Joints per chain
+     * @param {Object} options - workerUrl (default 'IKSolverWorker.js'), slotCount (default 4)
+     */
+    constructor(jointCount, options = {}) {
+        this.layout = ikPipeLayout(jointCount, options.slotCount || 4);
+        this.shared = typeof SharedArrayBuffer !== 'undefined'
+            && (typeof crossOriginIsolated === 'undefined' || crossOriginIsolated);
+        this.lastResultSeq = 0;
+        this.resultCount = 0;
+
+        const bytes = this.layout.totalFloats * 4;
+        const buffer = this.shared ? new SharedArrayBuffer(bytes) : new ArrayBuffer(bytes);
+        this.control = new Int32Array(buffer, 0, IK_PIPE_CONTROL_WORDS);
+        this.data = new Float32Array(buffer);
+
+        if (this.shared) {
+            Atomics.store(this.control, IK_PIPE_RUNNING, 1);
+            this.worker = new Worker(options.workerUrl || 'IKSolverWorker.js');
+            // The only message ever sent: hand the worker the shared memory once
+            this.worker.postMessage({ buffer: buffer, jointCount: jointCount, slotCount: this.layout.slotCount });
+        } else {
+            this.worker = null;
+        }
+    }
+
+    /** True when solving runs in the worker */
+    get isOffMainThread() {
+        return this.worker !== null;
+    }
+
+    /**
+     * Queue a solve; never blocks
+     * @param {Float32Array} positions - Interleaved x, y, z of each joint, root first
+     * @param {Vector3D} target - Target for the end effector
+     * @param {String} algorithm - 'fabrik' or 'ccd'
+     * @param {Number} iterations - Maximum iterations
+     * @param {Number} tolerance - Distance tolerance
+     * @returns {Number} - Sequence number of the request
+     */
+    submit(positions, target, algorithm = 'fabrik', iterations = 10, tolerance = 0.01) {
+        const layout = this.layout;
+        const seq = this.control[IK_PIPE_REQUEST_SEQ] + 1;
+        const base = layout.requestBase + (seq % layout.slotCount) * layout.requestSlotFloats;
+        const data = this.data;
+        data[base] = algorithm === 'ccd' ? 0 : 1;
+        data[base + 1] = iterations;
+        data[base + 2] = tolerance;
+        data[base + 3] = target.x;
+        data[base + 4] = target.y;
+        data[base + 5] = target.z;
+        data.set(positions.subarray(0, layout.jointCount * 3), base + IK_PIPE_HEADER_FLOATS);
+
+        if (this.shared) {
+            // Publishing the sequence number releases the slot contents to the worker
+            Atomics.store(this.control, IK_PIPE_REQUEST_SEQ, seq);
+            Atomics.notify(this.control, IK_PIPE_REQUEST_SEQ);
+        } else {
+            this.control[IK_PIPE_REQUEST_SEQ] = seq;
+            ikPipeSolve(this.data, this.control, layout, seq, ++this.resultCount);
+        }
+        return seq;
+    }
+
+    /**
+     * Copy the newest result into out if one arrived since the last read
+     * @param {Float32Array} out - Receives jointCount * 3 floats
+     * @returns {Number} - Iterations used, or -1 when there is nothing new
+     */
+    read(out) {
+        const layout = this.layout;
+        const seq = Atomics.load(this.control, IK_PIPE_RESULT_SEQ);
+        if (seq === this.lastResultSeq) {
+            return -1;
+        }
+        const base = layout.resultBase + (seq % layout.slotCount) * layout.resultSlotFloats;
+        out.set(this.data.subarray(base + 1, base + 1 + layout.jointCount * 3));
+        // The worker only starts overwriting this slot after publishing slotCount - 1 newer
+        // results, so re-checking the count afterwards is enough to detect a torn copy
+        const after = Atomics.load(this.control, IK_PIPE_RESULT_SEQ);
+        if (after - seq >= layout.slotCount - 1) {
+            return -1;
+        }
+        this.lastResultSeq = seq;
+        return this.data[base];
+    }
+
+    /** Stop the worker */
+    terminate() {
+        if (this.worker) {
+            Atomics.store(this.control, IK_PIPE_RUNNING, 0);
+            Atomics.notify(this.control, IK_PIPE_REQUEST_SEQ);
+            this.worker.terminate();
+            this.worker = null;
+        }
+    }
+}
+
+// Solve request seq and publish it as result number resultIndex
+function ikPipeSolve(data, control, layout, seq, resultIndex) {
+    const request = layout.requestBase + (seq % layout.slotCount) * layout.requestSlotFloats;
+    const result = layout.resultBase + (resultIndex % layout.slotCount) * layout.resultSlotFloats;
+
+    // Take the whole request before solving; the page only reuses the slot after
+    // slotCount newer submissions
+    const algorithm = data[request], iterations = data[request + 1], tolerance = data[request + 2];
+    const target = new Vector3D(data[request + 3], data[request + 4], data[request + 5]);
+    const positions = data.subarray(result + 1, result + 1 + layout.jointCount * 3);
+    positions.set(data.subarray(request + IK_PIPE_HEADER_FLOATS, request + IK_PIPE_HEADER_FLOATS + layout.jointCount * 3));
+
+    data[result] = algorithm === 0
+        ? IKSolver.solveCCDFlat(positions, target, iterations, tolerance)
+        : IKSolver.solveFABRIKFlat(positions, target, iterations, tolerance);
+
+    Atomics.store(control, IK_PIPE_RESULT_SEQ, resultIndex);
+}
+
+// Worker side: block until a new request is published, solve only the newest one
+if (typeof WorkerGlobalScope !== 'undefined' && self instanceof WorkerGlobalScope) {
+    importScripts('IKSolver.js');
+    self.onmessage = (event) => {
+        const { buffer, jointCount, slotCount } = event.data;
+        const layout = ikPipeLayout(jointCount, slotCount);
+        const control = new Int32Array(buffer, 0, IK_PIPE_CONTROL_WORDS);
+        const data = new Float32Array(buffer);
+
+        let solved = 0, results = 0;
+        while (Atomics.load(control, IK_PIPE_RUNNING) === 1) {
+            Atomics.wait(control, IK_PIPE_REQUEST_SEQ, solved);
+            const seq = Atomics.load(control, IK_PIPE_REQUEST_SEQ);
+            if (seq !== solved) {
+                ikPipeSolve(data, control, layout, seq, ++results);
+                solved = seq;
+            }
+        }
+    };
+}
@@ -69,6 +69,35 @@ const PoseLandmarks = {
     RIGHT_WRIST: 16
 };
 
+/**
+ * Landmark indices of each finger chain, wrist first
+ */
+const FingerChainIndices = {
+    'thumb': [HandLandmarks.WRIST, HandLandmarks.THUMB_CMC, HandLandmarks.THUMB_MCP,
+              HandLandmarks.THUMB_IP, HandLandmarks.THUMB_TIP],
+    'index': [HandLandmarks.WRIST, HandLandmarks.INDEX_FINGER_MCP, HandLandmarks.INDEX_FINGER_PIP,
+              HandLandmarks.INDEX_FINGER_DIP, HandLandmarks.INDEX_FINGER_TIP],
+    'middle': [HandLandmarks.WRIST, HandLandmarks.MIDDLE_FINGER_MCP, HandLandmarks.MIDDLE_FINGER_PIP,
+               HandLandmarks.MIDDLE_FINGER_DIP, HandLandmarks.MIDDLE_FINGER_TIP],
+    'ring': [HandLandmarks.WRIST, HandLandmarks.RING_FINGER_MCP, HandLandmarks.RING_FINGER_PIP,
+             HandLandmarks.RING_FINGER_DIP, HandLandmarks.RING_FINGER_TIP],
+    'pinky': [HandLandmarks.WRIST, HandLandmarks.PINKY_MCP, HandLandmarks.PINKY_PIP,
+              HandLandmarks.PINKY_DIP, HandLandmarks.PINKY_TIP]
+};
+
+const FingerNames = ['thumb', 'index', 'middle', 'ring', 'pinky'];
+const FINGER_CHAIN_JOINTS = 5;
+const ARM_CHAIN_JOINTS = 3;
+
+/**
+ * Index tables for the flat extractors: the five finger chains (thumb..pinky) back to back,
+ * FINGER_CHAIN_JOINTS entries each, and the left then right arm (shoulder, elbow, wrist)
+ */
+const FINGER_CHAIN_TABLE = Uint8Array.from([].concat(...FingerNames.map(name => FingerChainIndices[name])));
+const ARM_CHAIN_TABLE = Uint8Array.of(
+    PoseLandmarks.LEFT_SHOULDER, PoseLandmarks.LEFT_ELBOW, PoseLandmarks.LEFT_WRIST,
+    PoseLandmarks.RIGHT_SHOULDER, PoseLandmarks.RIGHT_ELBOW, PoseLandmarks.RIGHT_WRIST);
+
 /**
  * Convert MediaPipe landmark (normalized 0-1 coordinates) to Vector3D
  * @param {Object} landmark - MediaPipe landmark with x, y, z properties
@@ -83,6 +112,111 @@ function landmarkToVector3D(landmark, scale = 1.0) {
     );
 }
 
+/**
+ * Allocation-free form of landmarkToVector3D for flat landmark buffers
+ * @param {Float32Array} flatLandmarks - stride floats per landmark (see gatherChainFlat)
+ * @param {Number} index - Landmark index
+ * @param {Vector3D} out - Receives the scaled position
+ * @param {Number} scale - Scale factor
+ * @param {Number} stride - Floats per landmark, 3 (x, y, z) or 2 (x, y; z is 0)
+ * @param {Number} landmarkOffset - Float offset of landmark 0, e.g. hand * 21 * stride
+ * @returns {Vector3D} - out
+ */
+function landmarkToVector3DFlat(flatLandmarks, index, out, scale = 1.0, stride = 3, landmarkOffset = 0) {
+    const i = landmarkOffset + index * stride;
+    return out.set(flatLandmarks[i] * scale, flatLandmarks[i + 1] * scale,
+        stride > 2 ? flatLandmarks[i + 2] * scale : 0);
+}
+
+/**
+ * Copy landmarks into an interleaved x, y, z chain buffer through an index table, without
+ * allocating. flatLandmarks holds stride floats per landmark: 3 (x, y, z) as the N-API and
+ * WASM bindings produce, or 2 (x, y) as the Node addon's shared buffer holds, in which case
+ * z is 0. The result is what solveFABRIKFlat / solveCCDFlat take.
+ * @param {Float32Array} flatLandmarks - Landmarks of one or more hands or poses
+ * @param {Uint8Array} table - Landmark indices, e.g. FINGER_CHAIN_TABLE or ARM_CHAIN_TABLE
+ * @param {Number} tableOffset - First entry of the chain in table
+ * @param {Number} jointCount - Joints in the chain
+ * @param {Float32Array} out - Receives jointCount * 3 floats from outOffset
+ * @param {Number} outOffset - First float written in out
+ * @param {Number} scale - Scale factor
+ * @param {Number} stride - Floats per landmark
+ * @param {Number} landmarkOffset - Float offset of landmark 0, e.g. hand * 21 * stride
+ * @returns {Float32Array} - out
+ */
+function gatherChainFlat(flatLandmarks, table, tableOffset, jointCount, out, outOffset = 0,
+    scale = 100, stride = 3, landmarkOffset = 0) {
+    for (let j = 0; j < jointCount; j++) {
+        const i = landmarkOffset + table[tableOffset + j] * stride;
+        const o = outOffset + j * 3;
+        out[o] = flatLandmarks[i] * scale;
+        out[o + 1] = flatLandmarks[i + 1] * scale;
+        out[o + 2] = stride > 2 ? flatLandmarks[i + 2] * scale : 0;
+    }
+    return out;
+}
+
+/**
+ * Flat form of extractFingerChain: writes the finger's five joints into out
+ * @param {Float32Array} flatLandmarks - stride floats per landmark (see gatherChainFlat)
+ * @param {Number|String} finger - 0..4 (thumb..pinky) or the finger name
+ * @param {Float32Array} out - At least 15 floats, reused every frame
+ * @param {Number} scale - Scale factor
+ * @param {Number} stride - Floats per landmark
+ * @param {Number} landmarkOffset - Float offset of the hand's wrist, e.g. hand * 21 * stride
+ * @returns {Float32Array} - out
+ */
+function extractFingerChainFlat(flatLandmarks, finger, out, scale = 100, stride = 3, landmarkOffset = 0) {
+    const f = typeof finger === 'number' ? finger : FingerNames.indexOf(finger.toLowerCase());
+    if (f < 0 || f >= FingerNames.length) {
+        throw new Error(`Unknown finger: ${finger}`);
+    }
+    return gatherChainFlat(flatLandmarks, FINGER_CHAIN_TABLE, f * FINGER_CHAIN_JOINTS, FINGER_CHAIN_JOINTS,
+        out, 0, scale, stride, landmarkOffset);
+}
+
+/**
+ * Flat form of extractArmChain: writes shoulder, elbow and wrist into out
+ * @param {Float32Array} flatLandmarks - Pose landmarks, stride floats each (see gatherChainFlat)
+ * @param {String} side - 'left' or 'right'
+ * @param {Float32Array} out - At least 9 floats, reused every frame
+ * @param {Number} scale - Scale factor
+ * @param {Number} stride - Floats per landmark
+ * @param {Number} landmarkOffset - Float offset of pose landmark 0
+ * @returns {Float32Array} - out
+ */
+function extractArmChainFlat(flatLandmarks, side, out, scale = 100, stride = 3, landmarkOffset = 0) {
+    return gatherChainFlat(flatLandmarks, ARM_CHAIN_TABLE, side === 'left' ? 0 : ARM_CHAIN_JOINTS, ARM_CHAIN_JOINTS,
+        out, 0, scale, stride, landmarkOffset);
+}
+
+/**
+ * Preallocated chain buffers for one hand: positions holds the five finger chains back to
+ * back and fingers[f] is a view of chain f that the flat solvers work on in place
+ * @returns {Object} - { positions, fingers }
+ */
+function createHandChainBuffers() {
+    const size = FINGER_CHAIN_JOINTS * 3;
+    const positions = new Float32Array(FingerNames.length * size);
+    const fingers = FingerNames.map((name, f) => positions.subarray(f * size, (f + 1) * size));
+    return { positions, fingers };
+}
+
+/**
+ * Write all five finger chains of one hand into buffers from createHandChainBuffers
+ * @param {Float32Array} flatLandmarks - stride floats per landmark (see gatherChainFlat)
+ * @param {Object} buffers - From createHandChainBuffers
+ * @param {Number} scale - Scale factor
+ * @param {Number} stride - Floats per landmark
+ * @param {Number} landmarkOffset - Float offset of the hand's wrist, e.g. hand * 21 * stride
+ * @returns {Object} - buffers
+ */
+function extractHandChainsFlat(flatLandmarks, buffers, scale = 100, stride = 3, landmarkOffset = 0) {
+    gatherChainFlat(flatLandmarks, FINGER_CHAIN_TABLE, 0, FINGER_CHAIN_TABLE.length, buffers.positions, 0,
+        scale, stride, landmarkOffset);
+    return buffers;
+}
+
 /**
  * Extract a finger chain from MediaPipe hand landmarks
  * @param {Array} landmarks - MediaPipe hand landmarks (21 points)
@@ -91,20 +225,7 @@ function landmarkToVector3D(landmark, scale = 1.0) {
  * @returns {Array<Joint>} - Joint chain for the finger
  */
 function extractFingerChain(landmarks, fingerName, scale = 100) {
-    const fingerIndices = {
-        'thumb': [HandLandmarks.WRIST, HandLandmarks.THUMB_CMC, HandLandmarks.THUMB_MCP, 
-                  HandLandmarks.THUMB_IP, HandLandmarks.THUMB_TIP],
-        'index': [HandLandmarks.WRIST, HandLandmarks.INDEX_FINGER_MCP, HandLandmarks.INDEX_FINGER_PIP, 
-                  HandLandmarks.INDEX_FINGER_DIP, HandLandmarks.INDEX_FINGER_TIP],
-        'middle': [HandLandmarks.WRIST, HandLandmarks.MIDDLE_FINGER_MCP, HandLandmarks.MIDDLE_FINGER_PIP, 
-                   HandLandmarks.MIDDLE_FINGER_DIP, HandLandmarks.MIDDLE_FINGER_TIP],
-        'ring': [HandLandmarks.WRIST, HandLandmarks.RING_FINGER_MCP, HandLandmarks.RING_FINGER_PIP, 
-                 HandLandmarks.RING_FINGER_DIP, HandLandmarks.RING_FINGER_TIP],
-        'pinky': [HandLandmarks.WRIST, HandLandmarks.PINKY_MCP, HandLandmarks.PINKY_PIP, 
-                  HandLandmarks.PINKY_DIP, HandLandmarks.PINKY_TIP]
-    };
-    
-    const indices = fingerIndices[fingerName.toLowerCase()];
+    const indices = FingerChainIndices[fingerName.toLowerCase()];
     if (!indices) {
         throw new Error(`Unknown finger name: ${fingerName}`);
     }
@@ -209,6 +330,98 @@ function manipulateArm(landmarks, side, targetPosition, algorithm = 'fabrik') {
     return solved;
 }
 
+/**
+ * Allocate the struct-of-arrays buffers for solving every finger of several hands at once.
+ * Chain c = hand * 5 + finger (thumb, index, middle, ring, pinky). Allocate once, reuse every frame.
+ * @param {Number} handCount - Number of hands (default: 2)
+ * @returns {Object} - { chainCount, xs, ys, zs, targets, scratch }
+ */
+function createHandBatch(handCount = 2) {
+    const chainCount = handCount * FingerNames.length;
+    const size = chainCount * FINGER_CHAIN_JOINTS;
+    return {
+        chainCount,
+        xs: new Float32Array(size),
+        ys: new Float32Array(size),
+        zs: new Float32Array(size),
+        targets: new Float32Array(chainCount * 3),
+        scratch: IKSolver.createBatchScratch(chainCount, FINGER_CHAIN_JOINTS)
+    };
+}
+
+/**
+ * Copy all finger chains of every hand into a batch, without creating Joint objects
+ * @param {Array<Array>} handsLandmarks - One array of 21 landmarks per hand
+ * @param {Object} batch - From createHandBatch
+ * @param {Number} scale - Scale factor
+ */
+function packHandChains(handsLandmarks, batch, scale = 100) {
+    const chainCount = batch.chainCount;
+    for (let h = 0; h < handsLandmarks.length; h++) {
+        const landmarks = handsLandmarks[h];
+        for (let f = 0; f < FingerNames.length; f++) {
+            const c = h * FingerNames.length + f;
+            const indices = FingerChainIndices[FingerNames[f]];
+            for (let j = 0; j < FINGER_CHAIN_JOINTS; j++) {
+                const lm = landmarks[indices[j]];
+                const k = j * chainCount + c;
+                batch.xs[k] = lm.x * scale;
+                batch.ys[k] = lm.y * scale;
+                batch.zs[k] = (lm.z || 0) * scale;
+            }
+        }
+    }
+}
+
+/**
+ * Copy all finger chains from flat landmarks, by default the x, y pairs the Node addon
+ * (dll_use_example/MediapipeNodeAddon) writes into its shared Float32Array (z is left at 0)
+ * @param {Float32Array} flatLandmarks - 21 * stride floats per hand
+ * @param {Number} handCount - Hands present in flatLandmarks
+ * @param {Object} batch - From createHandBatch
+ * @param {Number} scale - Scale factor
+ * @param {Number} stride - Floats per landmark, 2 (x, y) or 3 (x, y, z)
+ */
+function packHandChainsFromFlat(flatLandmarks, handCount, batch, scale = 100, stride = 2) {
+    const chainCount = batch.chainCount;
+    for (let h = 0; h < handCount; h++) {
+        const base = h * 21 * stride;
+        for (let f = 0; f < FingerNames.length; f++) {
+            const c = h * FingerNames.length + f;
+            for (let j = 0; j < FINGER_CHAIN_JOINTS; j++) {
+                const i = base + FINGER_CHAIN_TABLE[f * FINGER_CHAIN_JOINTS + j] * stride;
+                const k = j * chainCount + c;
+                batch.xs[k] = flatLandmarks[i] * scale;
+                batch.ys[k] = flatLandmarks[i + 1] * scale;
+                batch.zs[k] = stride > 2 ? flatLandmarks[i + 2] * scale : 0;
+            }
+        }
+    }
+}
+
+/**
+ * Solve every finger of every hand in one batched FABRIK call
+ * @param {Array<Array>} handsLandmarks - One array of 21 landmarks per hand
+ * @param {Array<Array<Vector3D>>} fingertipTargets - Per hand, five fingertip targets (thumb..pinky)
+ * @param {Object} batch - Optional, from createHandBatch; pass one in to avoid per-frame allocation
+ * @returns {Object} - The batch, with solved coordinates in xs/ys/zs
+ */
+function manipulateHandsBatch(handsLandmarks, fingertipTargets, batch = null) {
+    const work = batch || createHandBatch(handsLandmarks.length);
+    packHandChains(handsLandmarks, work);
+    for (let h = 0; h < fingertipTargets.length; h++) {
+        for (let f = 0; f < FingerNames.length; f++) {
+            const t = fingertipTargets[h][f];
+            const c = (h * FingerNames.length + f) * 3;
+            work.targets[c] = t.x;
+            work.targets[c + 1] = t.y;
+            work.targets[c + 2] = t.z;
+        }
+    }
+    IKSolver.solveFABRIKBatch(work.xs, work.ys, work.zs, work.chainCount, work.targets, 15, 0.01, work.scratch);
+    return work;
+}
+
 /**
  * Create simulated MediaPipe hand landmarks for demo purposes
  * In real usage, these would come from MediaPipe hand tracking
@@ -256,35 +469,50 @@ function createSimulatedPoseLandmarks() {
 
 // ================= DEMO WITH SIMULATED MEDIAPIPE DATA =================
 
-console.log("=== MediaPipe IK Integration Demo ===\n");
+// Only when run directly; requiring the module for its helpers stays quiet
+if (require.main === module) {
+    console.log("=== MediaPipe IK Integration Demo ===\n");
+
+    const simulatedHandLandmarks = createSimulatedHandLandmarks();
+    const simulatedPoseLandmarks = createSimulatedPoseLandmarks();
 
-const simulatedHandLandmarks = createSimulatedHandLandmarks();
-const simulatedPoseLandmarks = createSimulatedPoseLandmarks();
+    // Example 1: Move index finger to a new position
+    const indexTargetPosition = new Vector3D(60, 25, 5);
+    const solvedIndexFinger = manipulateFinger(
+        simulatedHandLandmarks, 
+        'index', 
+        indexTargetPosition, 
+        'fabrik'
+    );
 
-// Example 1: Move index finger to a new position
-const indexTargetPosition = new Vector3D(60, 25, 5);
-const solvedIndexFinger = manipulateFinger(
-    simulatedHandLandmarks, 
-    'index', 
-    indexTargetPosition, 
-    'fabrik'
-);
+    // Example 2: Move middle finger
+    const middleTargetPosition = new Vector3D(62, 22, 3);
+    manipulateFinger(simulatedHandLandmarks, 'middle', middleTargetPosition, 'ccd');
 
-// Example 2: Move middle finger
-const middleTargetPosition = new Vector3D(62, 22, 3);
-manipulateFinger(simulatedHandLandmarks, 'middle', middleTargetPosition, 'ccd');
+    // Example 3: Move left arm to reach a target
+    const armTargetPosition = new Vector3D(55, 65, -5);
+    const solvedArm = manipulateArm(simulatedPoseLandmarks, 'left', armTargetPosition, 'fabrik');
 
-// Example 3: Move left arm to reach a target
-const armTargetPosition = new Vector3D(55, 65, -5);
-const solvedArm = manipulateArm(simulatedPoseLandmarks, 'left', armTargetPosition, 'fabrik');
+    // Example 4: Move all five fingers of a hand in one batched solve
+    const handTips = FingerNames.map(name => {
+        const tip = simulatedHandLandmarks[FingerChainIndices[name][FINGER_CHAIN_JOINTS - 1]];
+        return new Vector3D(tip.x * 100 - 1, tip.y * 100 + 3, tip.z * 100 + 2);
+    });
+    const handBatch = manipulateHandsBatch([simulatedHandLandmarks], [handTips]);
+    console.log("\nBatched solve of all five fingers:");
+    FingerNames.forEach((name, f) => {
+        const k = (FINGER_CHAIN_JOINTS - 1) * handBatch.chainCount + f;
+        console.log(`  ${name} tip: (${handBatch.xs[k].toFixed(2)}, ${handBatch.ys[k].toFixed(2)}, ${handBatch.zs[k].toFixed(2)})`);
+    });
 
-console.log("\n=== Integration Complete ===");
-console.log("\nUsage in your application:");
-console.log("1. Get landmarks from MediaPipe tracking");
-console.log("2. Call extractFingerChain() or extractArmChain() to build joint chains");
-console.log("3. Define target position where you want the end effector to move");
-console.log("4. Call manipulateFinger() or manipulateArm() to solve IK");
-console.log("5. Use the solved joint positions to update your 3D model or animation");
+    console.log("\n=== Integration Complete ===");
+    console.log("\nUsage in your application:");
+    console.log("1. Get landmarks from MediaPipe tracking");
+    console.log("2. Call extractFingerChain() or extractArmChain() to build joint chains");
+    console.log("3. Define target position where you want the end effector to move");
+    console.log("4. Call manipulateFinger() or manipulateArm() to solve IK");
+    console.log("5. Use the solved joint positions to update your 3D model or animation");
+}
 
 // Export functions for use in other modules
 if (typeof module !== 'undefined' && module.exports) {
@@ -292,11 +520,24 @@ if (typeof module !== 'undefined' && module.exports) {
         JointConstraints,
         HandLandmarks,
         PoseLandmarks,
+        FingerChainIndices,
+        FINGER_CHAIN_TABLE,
+        ARM_CHAIN_TABLE,
         landmarkToVector3D,
+        landmarkToVector3DFlat,
         extractFingerChain,
         extractArmChain,
+        gatherChainFlat,
+        extractFingerChainFlat,
+        extractArmChainFlat,
+        createHandChainBuffers,
+        extractHandChainsFlat,
         manipulateFinger,
         manipulateArm,
+        createHandBatch,
+        packHandChains,
+        packHandChainsFromFlat,
+        manipulateHandsBatch,
         createSimulatedHandLandmarks,
         createSimulatedPoseLandmarks
     };
@@ -0,0 +1,392 @@
+unit MediapipeTracking;
+
+{*******************************************************************************
+  MediapipeTracking - Delphi binding for the hand and holistic tracking DLLs
+
+  Mirrors MediapipeHandTrackingDll and MediapipeHolisticTrackingDll from the C++
+  example client. GetAllFunctions reads the DLL's function table
+  (Mediapipe_Hand_Tracking_Get_Api_Table / MediapipeHolisticTrackingGetApiTable)
+  with a single lookup when the DLL exports one and falls back to the individual
+  exports otherwise. Each DLL has its own table export, so loading the wrong DLL
+  cannot return a table of the other layout.
+
+  Landmarks arrive through the landmark callback as a pointer to the DLL's own
+  PoseInfo buffer, valid for the duration of the callback. PPoseInfoArray types
+  that pointer so it can be indexed in place, and GatherChain writes the joints
+  of a chain from it straight into the flat Single buffer that
+  TIKSolver.SolveFABRIKFlat / SolveCCDFlat take, so a frame goes from the DLL to
+  the solver without intermediate records or allocations.
+*******************************************************************************}
+
+interface
+
+uses
+  Winapi.Windows, System.SysUtils;
+
+const
+  MediapipeHandTrackingApiVersion = 1;
+  MediapipeHolisticTrackingApiVersion = 1;
+
+  { Wrist-to-tip landmark indices of the five fingers, for GatherChain }
+  MediaPipeFingerChains: array[0..4, 0..4] of Integer = (
+    (0, 1, 2, 3, 4),      // thumb
+    (0, 5, 6, 7, 8),      // index
+    (0, 9, 10, 11, 12),   // middle
+    (0, 13, 14, 15, 16),  // ring
+    (0, 17, 18, 19, 20)); // pinky
+
+  { Landmarks per hand; the callback delivers 21 per detected hand, hand after hand }
+  MediaPipeHandLandmarkCount = 21;
+  { Most hands the callback delivers; MAX_HAND_COUNT in MediapipeHandTrackingDll.h }
+  MediaPipeMaxHandCount = 6;
+
+type
+  { Same layout as PoseInfo in MediapipeHandTrackingDll.h: pixel coordinates }
+  TPoseInfo = record
+    X, Y: Single;
+  end;
+  TPoseInfoArray = array[0..MaxInt div SizeOf(TPoseInfo) - 1] of TPoseInfo;
+  PPoseInfoArray = ^TPoseInfoArray;
+
+  TGestureRecognitionResult = record
+    GestureRecognitionResult: array[0..1] of Integer;
+    HandUpHandDownDetectResult: array[0..1] of Integer;
+  end;
+
+  TLandmarksCallBack = procedure(ImageIndex: Integer; Infos: PPoseInfoArray; Count: Integer); cdecl;
+  TGestureResultCallBack = procedure(ImageIndex: Integer; RecognResult: PInteger; Count: Integer); cdecl;
+
+  TFuncHandTrackingInit = function(ModelPath: PAnsiChar): Integer; cdecl;
+  TFuncHandTrackingRegisterLandmarksCallback = function(Func: TLandmarksCallBack): Integer; cdecl;
+  TFuncHandTrackingRegisterGestureResultCallback = function(Func: TGestureResultCallBack): Integer; cdecl;
+  TFuncHandTrackingDetectFrame = function(ImageIndex, ImageWidth, ImageHeight: Integer; ImageData: Pointer): Integer; cdecl;
+  TFuncHandTrackingDetectFrameDirect = function(ImageWidth, ImageHeight: Integer; ImageData: Pointer;
+    var GestureResult: TGestureRecognitionResult): Integer; cdecl;
+  TFuncHandTrackingDetectVideo = function(VideoPath: PAnsiChar; ShowImage: Integer): Integer; cdecl;
+  TFuncHandTrackingRelease = function: Integer; cdecl;
+
+  TFuncHolisticTrackingInit = function(ModelPath: PAnsiChar; NeedVideoOutputStream, NeedPoseOutputStream,
+    NeedHandOutputStream, NeedFaceOutputStream: Boolean): Integer; cdecl;
+  { DetectResult points at 4 Integers: left/right arm up-down, left/right hand gesture }
+  TFuncHolisticTrackingDetectFrameDirect = function(ImageWidth, ImageHeight: Integer; ImageData: Pointer;
+    DetectResult: PInteger; ShowResultImage: Boolean): Integer; cdecl;
+  TFuncHolisticTrackingDetectCamera = function(ShowImage: Boolean): Integer; cdecl;
+  TFuncHolisticTrackingRelease = function: Integer; cdecl;
+
+  { Optional, exported by DLLs built with dll/ik_solver; see ik_solver_api.h }
+  TFuncIKSolveChain = function(JointPositions: PSingle; JointCount: Integer; TargetPosition: PSingle;
+    SolverType, MaxIterations: Integer; Tolerance: Single; BoneRotations: PSingle;
+    IterationsUsed: PInteger): Integer; cdecl;
+  TFuncIKSolveLandmarkChain = function(Landmarks: PSingle; LandmarkCount, LandmarkStride: Integer;
+    ChainIndices: PInteger; ChainLength: Integer; TargetPosition: PSingle; SolverType, MaxIterations: Integer;
+    Tolerance: Single; BoneRotations: PSingle; IterationsUsed: PInteger): Integer; cdecl;
+  TFuncIKSolveChainBatch = function(Xs, Ys, Zs: PSingle; ChainCount, JointCount: Integer; Targets: PSingle;
+    MaxIterations: Integer; Tolerance: Single; IterationsUsed: PInteger): Integer; cdecl;
+
+  { Function tables as laid out by the DLLs; new entries are only ever appended }
+  TMediapipeHandTrackingApiTable = record
+    Version: Integer;
+    Size: Integer;
+    Init: TFuncHandTrackingInit;
+    RegisterLandmarksCallback: TFuncHandTrackingRegisterLandmarksCallback;
+    RegisterGestureResultCallback: TFuncHandTrackingRegisterGestureResultCallback;
+    DetectFrame: TFuncHandTrackingDetectFrame;
+    DetectFrameDirect: TFuncHandTrackingDetectFrameDirect;
+    DetectVideo: TFuncHandTrackingDetectVideo;
+    Release: TFuncHandTrackingRelease;
+  end;
+  PMediapipeHandTrackingApiTable = ^TMediapipeHandTrackingApiTable;
+  TFuncGetHandTrackingApiTable = function(Version: Integer): PMediapipeHandTrackingApiTable; cdecl;
+
+  TMediapipeHolisticTrackingApiTable = record
+    Version: Integer;
+    Size: Integer;
+    Init: TFuncHolisticTrackingInit;
+    DetectFrameDirect: TFuncHolisticTrackingDetectFrameDirect;
+    DetectCamera: TFuncHolisticTrackingDetectCamera;
+    Release: TFuncHolisticTrackingRelease;
+  end;
+  PMediapipeHolisticTrackingApiTable = ^TMediapipeHolisticTrackingApiTable;
+  TFuncGetHolisticTrackingApiTable = function(Version: Integer): PMediapipeHolisticTrackingApiTable; cdecl;
+
+  TMediapipeHandTrackingDll = class
+  private
+    FHandle: HMODULE;
+    function GetFunctionsFromApiTable: Boolean;
+    procedure GetOptionalFunctions;
+    function GetLoaded: Boolean;
+  public
+    Init: TFuncHandTrackingInit;
+    RegisterLandmarksCallback: TFuncHandTrackingRegisterLandmarksCallback;
+    RegisterGestureResultCallback: TFuncHandTrackingRegisterGestureResultCallback;
+    DetectFrame: TFuncHandTrackingDetectFrame;
+    DetectFrameDirect: TFuncHandTrackingDetectFrameDirect;
+    DetectVideo: TFuncHandTrackingDetectVideo;
+    Release: TFuncHandTrackingRelease;
+
+    { nil when the loaded DLL does not export them }
+    IKSolveChain: TFuncIKSolveChain;
+    IKSolveLandmarkChain: TFuncIKSolveLandmarkChain;
+    IKSolveChainBatch: TFuncIKSolveChainBatch;
+
+    destructor Destroy; override;
+
+    function Load(const DllPath: string): Boolean;
+    procedure Unload;
+    function GetAllFunctions: Boolean;
+
+    property Loaded: Boolean read GetLoaded;
+  end;
+
+  TMediapipeHolisticTrackingDll = class
+  private
+    FHandle: HMODULE;
+    function GetFunctionsFromApiTable: Boolean;
+    procedure GetOptionalFunctions;
+    function GetLoaded: Boolean;
+  public
+    Init: TFuncHolisticTrackingInit;
+    DetectFrameDirect: TFuncHolisticTrackingDetectFrameDirect;
+    DetectCamera: TFuncHolisticTrackingDetectCamera;
+    Release: TFuncHolisticTrackingRelease;
+
+    { nil when the loaded DLL does not export them }
+    IKSolveChain: TFuncIKSolveChain;
+    IKSolveLandmarkChain: TFuncIKSolveLandmarkChain;
+    IKSolveChainBatch: TFuncIKSolveChainBatch;
+
+    destructor Destroy; override;
+
+    function Load(const DllPath: string): Boolean;
+    procedure Unload;
+    function GetAllFunctions: Boolean;
+
+    property Loaded: Boolean read GetLoaded;
+  end;
+
+{ Writes landmarks ChainIndices of hand Hand (0 .. MediaPipeMaxHandCount - 1) from the DLL's buffer into
+  Positions as interleaved X, Y, Z Singles with Z = 0, ready for
+  TIKSolver.SolveFABRIKFlat. Call it inside the landmark callback. Returns False
+  when the hand is not in the callback or Positions is too short. }
+function GatherChain(Infos: PPoseInfoArray; Count: Integer; const ChainIndices: array of Integer;
+  var Positions: array of Single; Hand: Integer = 0): Boolean;
+
+implementation
+
+function GatherChain(Infos: PPoseInfoArray; Count: Integer; const ChainIndices: array of Integer;
+  var Positions: array of Single; Hand: Integer): Boolean;
+var
+  I, Base, Index: Integer;
+begin
+  Result := False;
+  Base := Hand * MediaPipeHandLandmarkCount;
+  if (Infos = nil) or (Hand < 0) or (Base + MediaPipeHandLandmarkCount > Count) or
+    (Length(Positions) < Length(ChainIndices) * 3) then
+    Exit;
+
+  for I := 0 to High(ChainIndices) do
+  begin
+    Index := ChainIndices[I];
+    if (Index < 0) or (Index >= MediaPipeHandLandmarkCount) then
+      Exit;
+    Positions[I * 3] := Infos^[Base + Index].X;
+    Positions[I * 3 + 1] := Infos^[Base + Index].Y;
+    Positions[I * 3 + 2] := 0;
+  end;
+  Result := True;
+end;
+
+{ TMediapipeHandTrackingDll }
+
+destructor TMediapipeHandTrackingDll.Destroy;
+begin
+  Unload;
+  inherited;
+end;
+
+function TMediapipeHandTrackingDll.Load(const DllPath: string): Boolean;
+begin
+  Unload;
+  if not FileExists(DllPath) then
+    Exit(False);
+  FHandle := SafeLoadLibrary(DllPath);
+  Result := FHandle <> 0;
+end;
+
+procedure TMediapipeHandTrackingDll.Unload;
+begin
+  if FHandle <> 0 then
+    FreeLibrary(FHandle);
+  FHandle := 0;
+  Init := nil;
+  RegisterLandmarksCallback := nil;
+  RegisterGestureResultCallback := nil;
+  DetectFrame := nil;
+  DetectFrameDirect := nil;
+  DetectVideo := nil;
+  Release := nil;
+  IKSolveChain := nil;
+  IKSolveLandmarkChain := nil;
+  IKSolveChainBatch := nil;
+end;
+
+function TMediapipeHandTrackingDll.GetLoaded: Boolean;
+begin
+  Result := FHandle <> 0;
+end;
+
+function TMediapipeHandTrackingDll.GetAllFunctions: Boolean;
+begin
+  Result := False;
+  if FHandle = 0 then
+    Exit;
+
+  // DLLs that export the function table need a single lookup; older ones fall through
+  if not GetFunctionsFromApiTable then
+  begin
+    @Init := GetProcAddress(FHandle, 'Mediapipe_Hand_Tracking_Init');
+    // the export name carries the typo of the C API
+    @RegisterLandmarksCallback := GetProcAddress(FHandle, 'Mediapipe_Hand_Tracking_Reigeter_Landmarks_Callback');
+    @RegisterGestureResultCallback := GetProcAddress(FHandle, 'Mediapipe_Hand_Tracking_Register_Gesture_Result_Callback');
+    @DetectFrame := GetProcAddress(FHandle, 'Mediapipe_Hand_Tracking_Detect_Frame');
+    @DetectFrameDirect := GetProcAddress(FHandle, 'Mediapipe_Hand_Tracking_Detect_Frame_Direct');
+    @DetectVideo := GetProcAddress(FHandle, 'Mediapipe_Hand_Tracking_Detect_Video');
+    @Release := GetProcAddress(FHandle, 'Mediapipe_Hand_Tracking_Release');
+    if not Assigned(Init) or not Assigned(RegisterLandmarksCallback) or
+      not Assigned(RegisterGestureResultCallback) or not Assigned(DetectFrame) or
+      not Assigned(DetectFrameDirect) or not Assigned(DetectVideo) or not Assigned(Release) then
+      Exit;
+  end;
+
+  GetOptionalFunctions;
+  Result := True;
+end;
+
+function TMediapipeHandTrackingDll.GetFunctionsFromApiTable: Boolean;
+var
+  GetApiTable: TFuncGetHandTrackingApiTable;
+  Table: PMediapipeHandTrackingApiTable;
+begin
+  Result := False;
+  @GetApiTable := GetProcAddress(FHandle, 'Mediapipe_Hand_Tracking_Get_Api_Table');
+  if not Assigned(GetApiTable) then
+    Exit;
+
+  Table := GetApiTable(MediapipeHandTrackingApiVersion);
+  if (Table = nil) or (Table^.Version < MediapipeHandTrackingApiVersion) or
+    (Table^.Size < SizeOf(TMediapipeHandTrackingApiTable)) then
+    Exit;
+  if not Assigned(Table^.Init) or not Assigned(Table^.RegisterLandmarksCallback) or
+    not Assigned(Table^.RegisterGestureResultCallback) or not Assigned(Table^.DetectFrame) or
+    not Assigned(Table^.DetectFrameDirect) or not Assigned(Table^.DetectVideo) or
+    not Assigned(Table^.Release) then
+    Exit;
+
+  Init := Table^.Init;
+  RegisterLandmarksCallback := Table^.RegisterLandmarksCallback;
+  RegisterGestureResultCallback := Table^.RegisterGestureResultCallback;
+  DetectFrame := Table^.DetectFrame;
+  DetectFrameDirect := Table^.DetectFrameDirect;
+  DetectVideo := Table^.DetectVideo;
+  Release := Table^.Release;
+  Result := True;
+end;
+
+procedure TMediapipeHandTrackingDll.GetOptionalFunctions;
+begin
+  // missing optional exports are not an error; callers check Assigned
+  @IKSolveChain := GetProcAddress(FHandle, 'Mediapipe_IK_Solve_Chain');
+  @IKSolveLandmarkChain := GetProcAddress(FHandle, 'Mediapipe_IK_Solve_Landmark_Chain');
+  @IKSolveChainBatch := GetProcAddress(FHandle, 'Mediapipe_IK_Solve_Chain_Batch');
+end;
+
+{ TMediapipeHolisticTrackingDll }
+
+destructor TMediapipeHolisticTrackingDll.Destroy;
+begin
+  Unload;
+  inherited;
+end;
+
+function TMediapipeHolisticTrackingDll.Load(const DllPath: string): Boolean;
+begin
+  Unload;
+  if not FileExists(DllPath) then
+    Exit(False);
+  FHandle := SafeLoadLibrary(DllPath);
+  Result := FHandle <> 0;
+end;
+
+procedure TMediapipeHolisticTrackingDll.Unload;
+begin
+  if FHandle <> 0 then
+    FreeLibrary(FHandle);
+  FHandle := 0;
+  Init := nil;
+  DetectFrameDirect := nil;
+  DetectCamera := nil;
+  Release := nil;
+  IKSolveChain := nil;
+  IKSolveLandmarkChain := nil;
+  IKSolveChainBatch := nil;
+end;
+
+function TMediapipeHolisticTrackingDll.GetLoaded: Boolean;
+begin
+  Result := FHandle <> 0;
+end;
+
+function TMediapipeHolisticTrackingDll.GetAllFunctions: Boolean;
+begin
+  Result := False;
+  if FHandle = 0 then
+    Exit;
+
+  if not GetFunctionsFromApiTable then
+  begin
+    @Init := GetProcAddress(FHandle, 'MediapipeHolisticTrackingInit');
+    @DetectFrameDirect := GetProcAddress(FHandle, 'MediapipeHolisticTrackingDetectFrameDirect');
+    @DetectCamera := GetProcAddress(FHandle, 'MediapipeHolisticTrackingDetectCamera');
+    @Release := GetProcAddress(FHandle, 'MediapipeHolisticTrackingRelease');
+    if not Assigned(Init) or not Assigned(DetectFrameDirect) or not Assigned(DetectCamera) or
+      not Assigned(Release) then
+      Exit;
+  end;
+
+  GetOptionalFunctions;
+  Result := True;
+end;
+
+function TMediapipeHolisticTrackingDll.GetFunctionsFromApiTable: Boolean;
+var
+  GetApiTable: TFuncGetHolisticTrackingApiTable;
+  Table: PMediapipeHolisticTrackingApiTable;
+begin
+  Result := False;
+  @GetApiTable := GetProcAddress(FHandle, 'MediapipeHolisticTrackingGetApiTable');
+  if not Assigned(GetApiTable) then
+    Exit;
+
+  Table := GetApiTable(MediapipeHolisticTrackingApiVersion);
+  if (Table = nil) or (Table^.Version < MediapipeHolisticTrackingApiVersion) or
+    (Table^.Size < SizeOf(TMediapipeHolisticTrackingApiTable)) then
+    Exit;
+  if not Assigned(Table^.Init) or not Assigned(Table^.DetectFrameDirect) or
+    not Assigned(Table^.DetectCamera) or not Assigned(Table^.Release) then
+    Exit;
+
+  Init := Table^.Init;
+  DetectFrameDirect := Table^.DetectFrameDirect;
+  DetectCamera := Table^.DetectCamera;
+  Release := Table^.Release;
+  Result := True;
+end;
+
+procedure TMediapipeHolisticTrackingDll.GetOptionalFunctions;
+begin
+  @IKSolveChain := GetProcAddress(FHandle, 'Mediapipe_IK_Solve_Chain');
+  @IKSolveLandmarkChain := GetProcAddress(FHandle, 'Mediapipe_IK_Solve_Landmark_Chain');
+  @IKSolveChainBatch := GetProcAddress(FHandle, 'Mediapipe_IK_Solve_Chain_Batch');
+end;
+
+end.
@@ -0,0 +1,515 @@
+//!
+//! @brief - End-to-end replay benchmark for the tracking DLLs
+//!
+//! Decodes a video (or a raw BGR dump, or synthetic frames) into memory up front and
+//! drives the exported C API with the same frames in the same order on every run, so
+//! two builds of the DLL can be compared number for number.
+//!
+//!   sync      Mediapipe_Hand_Tracking_Detect_Frame_Direct per frame
+//!   async     Mediapipe_Hand_Tracking_Detect_Frame back to back, results via the callbacks
+//!   batched   bursts of --batch frames through Detect_Frame, waiting for each burst
+//!   holistic  MediapipeHolisticTrackingDetectFrameDirect per frame (--dll must be the holistic DLL)
+//!
+//! Reported per mode: fps, latency percentiles of the API call and, where the DLL
+//! reports back through callbacks, of submit-to-result; peak RSS; and heap
+//! allocations per frame. The allocation count covers the DLL only where it shares
+//! the process allocator (Linux builds against the shared libstdc++).
+//!
+//! Before the modes run, startup is broken down as the caller sees it: loading the
+//! DLL and its dependencies, Init (graph config parsing and every model's load,
+//! interpreter build and tensor allocation), the first frame, and the rest of the
+//! warm-up frames. model_benchmark splits the per-model share of Init further. Run it
+//! after a reboot, or with the files evicted from the page cache, for a cold start.
+//!
+//! A raw dump is "MPRF" | width u32 | height u32 | count u32 followed by count BGR frames.
+//!
+//! Usage: hand_tracking_benchmark --dll path --model path [--video file | --raw file]
+//!        [--frames N] [--width W] [--height H] [--modes sync,async,batched] [--batch B] [--json]
+//!
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "mediapipe/framework/port/opencv_imgproc_inc.h"
+#include "mediapipe/framework/port/opencv_video_inc.h"
+
+#if defined(_WIN32)
+#include <Windows.h>
+#include <Psapi.h>
+#else
+#include <dlfcn.h>
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+	std::atomic<long long> g_allocations{ 0 };
+
+	struct PoseInfo
+	{
+		float x;
+		float y;
+	};
+
+	struct GestureRecognitionResult
+	{
+		int m_Gesture_Recognition_Result[2] = { -1, -1 };
+		int m_HandUp_HandDown_Detect_Result[2] = { -1, -1 };
+	};
+
+	typedef void (*LandmarksCallBack)(int image_index, PoseInfo* infos, int count);
+	typedef void (*GestureResultCallBack)(int image_index, int* recogn_result, int count);
+	typedef int (*FuncHandInit)(const char* model_path);
+	typedef int (*FuncHandRegisterLandmarks)(LandmarksCallBack func);
+	typedef int (*FuncHandRegisterGesture)(GestureResultCallBack func);
+	typedef int (*FuncHandDetectFrame)(int image_index, int image_width, int image_height, void* image_data);
+	typedef int (*FuncHandDetectFrameDirect)(int image_width, int image_height, void* image_data, GestureRecognitionResult& gesture_result);
+	typedef int (*FuncRelease)();
+	typedef int (*FuncHolisticInit)(const char* model_path, bool is_need_video_outputstream, bool is_need_pose_outputstream, bool is_need_hand_outputstream, bool is_need_face_outputstream);
+	typedef int (*FuncHolisticDetectFrameDirect)(int image_width, int image_height, void* image_data, int* detect_result, bool show_result_image);
+
+	struct Options
+	{
+		std::string dll;
+		std::string model;
+		std::string video;
+		std::string raw;
+		int frames = 300;
+		int width = 640;
+		int height = 480;
+		int batch = 4;
+		std::string modes = "sync,async,batched";
+		bool json = false;
+	};
+
+	struct FrameSet
+	{
+		int width = 0;
+		int height = 0;
+		std::vector<std::vector<unsigned char>> frames;
+	};
+
+	struct ModeResult
+	{
+		std::string name;
+		int frames = 0;
+		int results = 0;
+		double seconds = 0.0;
+		std::vector<double> call_ms;
+		std::vector<double> result_ms;
+		long long allocations = 0;
+	};
+
+	// submit and callback times per image_index, written from the graph thread
+	std::vector<long long> g_submitNs;
+	std::vector<std::atomic<long long>> g_resultNs(0);
+	std::atomic<int> g_resultCount{ 0 };
+	std::atomic<long long> g_lastResultNs{ 0 };
+
+	long long NowNs()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	void MarkResult(int image_index)
+	{
+		long long now = NowNs();
+		g_lastResultNs = now;
+		if (image_index < 0 || image_index >= (int)g_resultNs.size())
+			return;
+		long long expected = 0;
+		// landmarks and gesture callbacks both arrive; the first one counts
+		if (g_resultNs[image_index].compare_exchange_strong(expected, now))
+			++g_resultCount;
+	}
+
+	void OnLandmarks(int image_index, PoseInfo*, int) { MarkResult(image_index); }
+	void OnGestures(int image_index, int*, int) { MarkResult(image_index); }
+
+	void* OpenLibrary(const std::string& path)
+	{
+#if defined(_WIN32)
+		return (void*)LoadLibraryA(path.c_str());
+#else
+		return dlopen(path.c_str(), RTLD_NOW);
+#endif
+	}
+
+	void* GetSymbol(void* library, const char* name)
+	{
+#if defined(_WIN32)
+		return (void*)GetProcAddress((HMODULE)library, name);
+#else
+		return dlsym(library, name);
+#endif
+	}
+
+	long long PeakRssBytes()
+	{
+#if defined(_WIN32)
+		PROCESS_MEMORY_COUNTERS counters;
+		return GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) ? (long long)counters.PeakWorkingSetSize : 0;
+#else
+		rusage usage;
+		getrusage(RUSAGE_SELF, &usage);
+		return (long long)usage.ru_maxrss * 1024;
+#endif
+	}
+
+	bool LoadVideo(const Options& options, FrameSet& set)
+	{
+		cv::VideoCapture capture(options.video);
+		if (!capture.isOpened())
+			return false;
+		cv::Mat frame;
+		while ((int)set.frames.size() < options.frames && capture.read(frame))
+		{
+			if (!frame.isContinuous())
+				frame = frame.clone();
+			set.width = frame.cols;
+			set.height = frame.rows;
+			set.frames.emplace_back(frame.data, frame.data + frame.total() * frame.elemSize());
+		}
+		return !set.frames.empty();
+	}
+
+	bool LoadRaw(const Options& options, FrameSet& set)
+	{
+		FILE* file = std::fopen(options.raw.c_str(), "rb");
+		if (file == nullptr)
+			return false;
+		char magic[4];
+		uint32_t header[3];
+		bool ok = std::fread(magic, 4, 1, file) == 1 && std::memcmp(magic, "MPRF", 4) == 0 && std::fread(header, sizeof(header), 1, file) == 1;
+		if (ok)
+		{
+			set.width = (int)header[0];
+			set.height = (int)header[1];
+			const size_t bytes = (size_t)set.width * set.height * 3;
+			const int count = std::min<int>((int)header[2], options.frames);
+			for (int i = 0; i < count; ++i)
+			{
+				std::vector<unsigned char> frame(bytes);
+				if (std::fread(frame.data(), bytes, 1, file) != 1)
+					break;
+				set.frames.push_back(std::move(frame));
+			}
+		}
+		std::fclose(file);
+		return !set.frames.empty();
+	}
+
+	// Moving gradient plus fixed-seed noise: deterministic, but not trivially compressible
+	void CreateSynthetic(const Options& options, FrameSet& set)
+	{
+		std::mt19937 random(1234);
+		set.width = options.width;
+		set.height = options.height;
+		set.frames.resize(options.frames);
+		for (int f = 0; f < options.frames; ++f)
+		{
+			std::vector<unsigned char>& frame = set.frames[f];
+			frame.resize((size_t)set.width * set.height * 3);
+			for (size_t i = 0; i < frame.size(); ++i)
+				frame[i] = (unsigned char)((i / 3 % set.width + f * 4) ^ (random() & 15));
+		}
+	}
+
+	double Percentile(std::vector<double> values, double p)
+	{
+		if (values.empty())
+			return 0.0;
+		std::sort(values.begin(), values.end());
+		const size_t index = std::min(values.size() - 1, (size_t)(p * (values.size() - 1) + 0.5));
+		return values[index];
+	}
+
+	void ResetResults(int frame_count)
+	{
+		g_submitNs.assign(frame_count, 0);
+		std::vector<std::atomic<long long>> results(frame_count);
+		g_resultNs.swap(results);
+		g_resultCount = 0;
+		g_lastResultNs = 0;
+	}
+
+	// Returns once `target` results arrived or no callback fired for idle_ms
+	void WaitForResults(int target, int idle_ms)
+	{
+		long long idle_since = NowNs();
+		int seen = g_resultCount.load();
+		while (g_resultCount.load() < target)
+		{
+			std::this_thread::sleep_for(std::chrono::microseconds(200));
+			const int now_seen = g_resultCount.load();
+			if (now_seen != seen)
+			{
+				seen = now_seen;
+				idle_since = NowNs();
+			}
+			else if (NowNs() - idle_since > (long long)idle_ms * 1000000)
+				break;
+		}
+	}
+
+	void CollectResultLatencies(ModeResult& result)
+	{
+		for (size_t i = 0; i < g_resultNs.size(); ++i)
+		{
+			const long long done = g_resultNs[i].load();
+			if (done != 0 && g_submitNs[i] != 0)
+				result.result_ms.push_back((done - g_submitNs[i]) / 1e6);
+		}
+		result.results = (int)result.result_ms.size();
+	}
+
+	void PrintResult(const ModeResult& r, bool json, bool first)
+	{
+		const double fps = r.frames / std::max(r.seconds, 1e-9);
+		const double allocs = (double)r.allocations / std::max(r.frames, 1);
+		if (json)
+		{
+			std::printf("%s\n    {\"mode\": \"%s\", \"frames\": %d, \"results\": %d, \"fps\": %.2f, "
+				"\"call_ms\": {\"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f}, "
+				"\"result_ms\": {\"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f}, \"allocs_per_frame\": %.2f}",
+				first ? "" : ",", r.name.c_str(), r.frames, r.results, fps,
+				Percentile(r.call_ms, 0.5), Percentile(r.call_ms, 0.9), Percentile(r.call_ms, 0.99), Percentile(r.call_ms, 1.0),
+				Percentile(r.result_ms, 0.5), Percentile(r.result_ms, 0.9), Percentile(r.result_ms, 0.99), Percentile(r.result_ms, 1.0), allocs);
+			return;
+		}
+		std::printf("%-10s%9.1f%10.2f%10.2f%10.2f", r.name.c_str(), fps,
+			Percentile(r.call_ms, 0.5), Percentile(r.call_ms, 0.9), Percentile(r.call_ms, 0.99));
+		if (r.result_ms.empty())
+			std::printf("%10s%10s%10s", "-", "-", "-");
+		else
+			std::printf("%10.2f%10.2f%10.2f", Percentile(r.result_ms, 0.5), Percentile(r.result_ms, 0.9), Percentile(r.result_ms, 0.99));
+		std::printf("%9d/%-6d%10.1f\n", r.results, r.frames, allocs);
+	}
+
+	bool ParseOptions(int argc, char** argv, Options& options)
+	{
+		for (int i = 1; i < argc; ++i)
+		{
+			const std::string arg = argv[i];
+			const bool has_value = i + 1 < argc;
+			if (arg == "--dll" && has_value) options.dll = argv[++i];
+			else if (arg == "--model" && has_value) options.model = argv[++i];
+			else if (arg == "--video" && has_value) options.video = argv[++i];
+			else if (arg == "--raw" && has_value) options.raw = argv[++i];
+			else if (arg == "--frames" && has_value) options.frames = std::atoi(argv[++i]);
+			else if (arg == "--width" && has_value) options.width = std::atoi(argv[++i]);
+			else if (arg == "--height" && has_value) options.height = std::atoi(argv[++i]);
+			else if (arg == "--batch" && has_value) options.batch = std::max(1, std::atoi(argv[++i]));
+			else if (arg == "--modes" && has_value) options.modes = argv[++i];
+			else if (arg == "--json") options.json = true;
+			else
+				return false;
+		}
+		return !options.dll.empty() && !options.model.empty() && options.frames > 0;
+	}
+}
+
+// Every heap allocation in the process is counted, see the header comment for the DLL's share
+void* operator new(std::size_t size)
+{
+	++g_allocations;
+	if (void* p = std::malloc(size ? size : 1))
+		return p;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		std::printf("Usage: %s --dll path --model path [--video file | --raw file] [--frames N] [--width W] [--height H]"
+			" [--modes sync,async,batched,holistic] [--batch B] [--json]\n", argv[0]);
+		return 1;
+	}
+
+	FrameSet set;
+	if (!options.video.empty() ? !LoadVideo(options, set) : !options.raw.empty() ? !LoadRaw(options, set) : false)
+	{
+		std::printf("failed to read frames\n");
+		return 1;
+	}
+	if (set.frames.empty())
+		CreateSynthetic(options, set);
+	const int frame_count = (int)set.frames.size();
+
+	const long long load_start = NowNs();
+	void* library = OpenLibrary(options.dll);
+	const double load_ms = (NowNs() - load_start) / 1e6;
+	if (library == nullptr)
+	{
+		std::printf("failed to load %s\n", options.dll.c_str());
+		return 1;
+	}
+
+	std::vector<std::string> modes;
+	std::stringstream mode_list(options.modes);
+	for (std::string mode; std::getline(mode_list, mode, ',');)
+		modes.push_back(mode);
+
+	const bool holistic_only = modes.size() == 1 && modes[0] == "holistic";
+	FuncRelease release = (FuncRelease)GetSymbol(library, holistic_only ? "MediapipeHolisticTrackingRelease" : "Mediapipe_Hand_Tracking_Release");
+	FuncHandDetectFrame detect_frame = (FuncHandDetectFrame)GetSymbol(library, "Mediapipe_Hand_Tracking_Detect_Frame");
+	FuncHandDetectFrameDirect detect_frame_direct = (FuncHandDetectFrameDirect)GetSymbol(library, "Mediapipe_Hand_Tracking_Detect_Frame_Direct");
+	FuncHolisticDetectFrameDirect holistic_detect = (FuncHolisticDetectFrameDirect)GetSymbol(library, "MediapipeHolisticTrackingDetectFrameDirect");
+
+	const long long init_start = NowNs();
+	bool initialized = false;
+	if (holistic_only)
+	{
+		FuncHolisticInit init = (FuncHolisticInit)GetSymbol(library, "MediapipeHolisticTrackingInit");
+		initialized = init != nullptr && holistic_detect != nullptr && release != nullptr && init(options.model.c_str(), false, true, true, true);
+	}
+	else
+	{
+		FuncHandInit init = (FuncHandInit)GetSymbol(library, "Mediapipe_Hand_Tracking_Init");
+		FuncHandRegisterLandmarks register_landmarks = (FuncHandRegisterLandmarks)GetSymbol(library, "Mediapipe_Hand_Tracking_Reigeter_Landmarks_Callback");
+		FuncHandRegisterGesture register_gestures = (FuncHandRegisterGesture)GetSymbol(library, "Mediapipe_Hand_Tracking_Register_Gesture_Result_Callback");
+		initialized = init != nullptr && register_landmarks != nullptr && register_gestures != nullptr && detect_frame != nullptr
+			&& detect_frame_direct != nullptr && release != nullptr
+			&& init(options.model.c_str()) && register_landmarks(OnLandmarks) && register_gestures(OnGestures);
+	}
+	const double init_ms = (NowNs() - init_start) / 1e6;
+	if (!initialized)
+	{
+		std::printf("failed to initialize %s with %s\n", options.dll.c_str(), options.model.c_str());
+		return 1;
+	}
+	const long long init_rss = PeakRssBytes();
+
+	// First inferences allocate tensors and pick kernels; keep them out of every mode
+	double first_frame_ms = 0.0;
+	std::vector<double> warmup_ms;
+	for (int i = 0; i < std::min(frame_count, 10); ++i)
+	{
+		const long long t0 = NowNs();
+		if (holistic_only)
+		{
+			int detect_result[4] = { 0 };
+			holistic_detect(set.width, set.height, set.frames[i].data(), detect_result, false);
+		}
+		else
+		{
+			GestureRecognitionResult gesture_result;
+			detect_frame_direct(set.width, set.height, set.frames[i].data(), gesture_result);
+		}
+		const double frame_ms = (NowNs() - t0) / 1e6;
+		if (i == 0)
+			first_frame_ms = frame_ms;
+		else
+			warmup_ms.push_back(frame_ms);
+	}
+
+	if (options.json)
+		std::printf("{\n  \"dll\": \"%s\", \"frames\": %d, \"width\": %d, \"height\": %d,\n"
+			"  \"startup\": {\"dll_load_ms\": %.3f, \"init_ms\": %.3f, \"first_frame_ms\": %.3f, \"warmup_p50_ms\": %.3f, \"init_peak_rss_bytes\": %lld},\n  \"modes\": [",
+			options.dll.c_str(), frame_count, set.width, set.height, load_ms, init_ms, first_frame_ms, Percentile(warmup_ms, 0.5), init_rss);
+	else
+		std::printf("startup: dll load %.1f ms, init %.1f ms, first frame %.1f ms, warm-up p50 %.2f ms, peak RSS after init %.1f MB\n",
+			load_ms, init_ms, first_frame_ms, Percentile(warmup_ms, 0.5), init_rss / (1024.0 * 1024.0));
+	if (!options.json)
+		std::printf("%d frames %dx%d\n%-10s%9s%10s%10s%10s%10s%10s%10s%16s%10s\n", frame_count, set.width, set.height,
+			"mode", "fps", "call p50", "p90", "p99", "res p50", "p90", "p99", "results", "allocs/f");
+
+	bool first = true;
+	for (const std::string& mode : modes)
+	{
+		ModeResult result;
+		result.name = mode;
+		result.frames = frame_count;
+		ResetResults(frame_count);
+		result.call_ms.reserve(frame_count);
+		const long long allocations = g_allocations.load();
+		const long long start = NowNs();
+
+		if (mode == "sync" && !holistic_only)
+		{
+			for (int i = 0; i < frame_count; ++i)
+			{
+				GestureRecognitionResult gesture_result;
+				const long long t0 = NowNs();
+				detect_frame_direct(set.width, set.height, set.frames[i].data(), gesture_result);
+				result.call_ms.push_back((NowNs() - t0) / 1e6);
+			}
+			result.seconds = (NowNs() - start) / 1e9;
+		}
+		else if ((mode == "async" || mode == "batched") && !holistic_only)
+		{
+			const int burst = mode == "async" ? frame_count : options.batch;
+			long long active_ns = 0;
+			for (int begin = 0; begin < frame_count; begin += burst)
+			{
+				const int end = std::min(frame_count, begin + burst);
+				const long long burst_start = NowNs();
+				for (int i = begin; i < end; ++i)
+				{
+					const long long t0 = NowNs();
+					g_submitNs[i] = t0;
+					detect_frame(i, set.width, set.height, set.frames[i].data());
+					result.call_ms.push_back((NowNs() - t0) / 1e6);
+				}
+				const long long submitted = NowNs();
+				// frames without hands never call back, so a burst ends at its last result
+				// and the idle wait that detects this is not part of the run
+				WaitForResults(end, mode == "async" ? 200 : 50);
+				active_ns += std::max(g_lastResultNs.load(), submitted) - burst_start;
+			}
+			result.seconds = active_ns / 1e9;
+			CollectResultLatencies(result);
+		}
+		else if (mode == "holistic" && holistic_only)
+		{
+			for (int i = 0; i < frame_count; ++i)
+			{
+				int detect_result[4] = { 0 };
+				const long long t0 = NowNs();
+				holistic_detect(set.width, set.height, set.frames[i].data(), detect_result, false);
+				result.call_ms.push_back((NowNs() - t0) / 1e6);
+			}
+			result.seconds = (NowNs() - start) / 1e9;
+		}
+		else
+		{
+			std::fprintf(stderr, "skipping mode %s\n", mode.c_str());
+			continue;
+		}
+
+		result.allocations = g_allocations.load() - allocations;
+		PrintResult(result, options.json, first);
+		first = false;
+	}
+
+	if (options.json)
+		std::printf("\n  ],\n  \"peak_rss_bytes\": %lld\n}\n", PeakRssBytes());
+	else
+		std::printf("peak RSS %.1f MB\n", PeakRssBytes() / (1024.0 * 1024.0));
+
+	release();
+	return 0;
+}
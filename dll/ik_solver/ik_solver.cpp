@@ -0,0 +1,580 @@
+#include "ik_solver.h"
+
+#include <cmath>
+
+#if defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#endif
+
+namespace
+{
+	const float kRadToDeg = 57.29577951308232f;
+	// cos(0.001): CCD skips pivots whose correction is below a milliradian
+	const float kCosMinCcdAngle = 0.9999995f;
+
+	inline IKVector3 Sub(const IKVector3& a, const IKVector3& b)
+	{
+		return IKVector3{ a.x - b.x, a.y - b.y, a.z - b.z };
+	}
+
+	inline IKVector3 Add(const IKVector3& a, const IKVector3& b)
+	{
+		return IKVector3{ a.x + b.x, a.y + b.y, a.z + b.z };
+	}
+
+	inline IKVector3 Scale(const IKVector3& a, float s)
+	{
+		return IKVector3{ a.x * s, a.y * s, a.z * s };
+	}
+
+	inline float Dot(const IKVector3& a, const IKVector3& b)
+	{
+		return a.x * b.x + a.y * b.y + a.z * b.z;
+	}
+
+	inline IKVector3 Cross(const IKVector3& a, const IKVector3& b)
+	{
+		return IKVector3{ a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+	}
+
+	inline float Length(const IKVector3& a)
+	{
+		return std::sqrt(Dot(a, a));
+	}
+
+	inline IKVector3 Normalize(const IKVector3& a)
+	{
+		float len = Length(a);
+		return len > 0.0f ? Scale(a, 1.0f / len) : IKVector3{ 0.0f, 0.0f, 0.0f };
+	}
+
+	inline float Distance(const IKVector3& a, const IKVector3& b)
+	{
+		return Length(Sub(a, b));
+	}
+
+	inline float Clamp(float v, float lo, float hi)
+	{
+		return v < lo ? lo : (v > hi ? hi : v);
+	}
+
+	inline bool IsValidChain(const IKVector3* joints, int joint_count)
+	{
+		return joints != nullptr && joint_count >= 2 && joint_count <= IK_MAX_CHAIN_JOINTS;
+	}
+
+	// a * b: b first, then a
+	inline IKQuaternion Multiply(const IKQuaternion& a, const IKQuaternion& b)
+	{
+		return IKQuaternion{ a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+			a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+			a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+			a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z };
+	}
+
+	inline IKQuaternion NormalizeQuaternion(const IKQuaternion& q)
+	{
+		float len = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+		return len > 0.0f ? IKQuaternion{ q.x / len, q.y / len, q.z / len, q.w / len } : IKQuaternion{ 0.0f, 0.0f, 0.0f, 1.0f };
+	}
+
+	// Shortest arc taking unit vector from onto unit vector to
+	inline IKQuaternion ArcBetween(const IKVector3& from, const IKVector3& to)
+	{
+		float w = 1.0f + Dot(from, to);
+		if (w < 1e-6f)
+		{
+			// opposite directions: half a turn about any perpendicular axis
+			IKVector3 axis = std::fabs(from.x) < 0.9f ? IKVector3{ 0.0f, -from.z, from.y } : IKVector3{ from.z, 0.0f, -from.x };
+			axis = Normalize(axis);
+			return IKQuaternion{ axis.x, axis.y, axis.z, 0.0f };
+		}
+		IKVector3 axis = Cross(from, to);
+		return NormalizeQuaternion(IKQuaternion{ axis.x, axis.y, axis.z, w });
+	}
+
+	// cos and sin of half the angle with cosine c and sine s, without trig
+	inline void HalfAngle(float c, float s, float& half_cos, float& half_sin)
+	{
+		// take the square root of whichever of 1 + c, 1 - c does not cancel, the other from
+		// sin a = 2 sin(a/2) cos(a/2)
+		if (c >= 0.0f)
+		{
+			half_cos = std::sqrt(0.5f * (1.0f + c));
+			half_sin = s / (2.0f * half_cos);
+		}
+		else
+		{
+			half_sin = std::copysign(std::sqrt(0.5f * Clamp(1.0f - c, 0.0f, 2.0f)), s);
+			half_cos = s / (2.0f * half_sin);
+		}
+	}
+
+	void CaptureBoneDirections(const IKVector3* joints, int joint_count, IKVector3* directions)
+	{
+		for (int i = 0; i < joint_count - 1; ++i)
+		{
+			directions[i] = Normalize(Sub(joints[i + 1], joints[i]));
+		}
+	}
+
+	// Turns each bone's orientation by the arc its direction moved through; the last joint
+	// repeats the last bone, as in CalculateBoneRotations
+	void UpdateBoneRotations(const IKVector3* directions, const IKVector3* joints, int joint_count, IKQuaternion* rotations)
+	{
+		for (int i = 0; i < joint_count - 1; ++i)
+		{
+			IKVector3 direction = Normalize(Sub(joints[i + 1], joints[i]));
+			rotations[i] = NormalizeQuaternion(Multiply(ArcBetween(directions[i], direction), rotations[i]));
+		}
+		rotations[joint_count - 1] = rotations[joint_count - 2];
+	}
+}
+
+IKVector3 IKSolver::RotateAroundAxis(const IKVector3& vector, const IKVector3& axis, float angle)
+{
+	// Rodrigues' rotation formula; axis must be normalized
+	float cosAngle = std::cos(angle);
+	float sinAngle = std::sin(angle);
+
+	IKVector3 term1 = Scale(vector, cosAngle);
+	IKVector3 term2 = Scale(Cross(axis, vector), sinAngle);
+	IKVector3 term3 = Scale(axis, Dot(axis, vector) * (1.0f - cosAngle));
+
+	return Add(Add(term1, term2), term3);
+}
+
+int IKSolver::SolveCCD(IKVector3* joints, int joint_count, const IKVector3& target, int max_iterations, float tolerance, IKQuaternion* bone_rotations)
+{
+	if (!IsValidChain(joints, joint_count))
+	{
+		return -1;
+	}
+
+	int endIndex = joint_count - 1;
+	IKQuaternion pivotRotations[IK_MAX_CHAIN_JOINTS];
+	bool isPivotRotated[IK_MAX_CHAIN_JOINTS] = {};
+	int iter = 0;
+	for (; iter < max_iterations; ++iter)
+	{
+		if (Distance(joints[endIndex], target) < tolerance)
+		{
+			break;
+		}
+
+		for (int i = endIndex - 1; i >= 0; --i)
+		{
+			IKVector3 pivot = joints[i];
+			IKVector3 toEnd = Normalize(Sub(joints[endIndex], pivot));
+			IKVector3 toTarget = Normalize(Sub(target, pivot));
+
+			// For unit vectors the dot is cos and the cross length is sin of the angle, so
+			// the rotation needs no acos/sin/cos at all
+			float c = Clamp(Dot(toEnd, toTarget), -1.0f, 1.0f);
+			if (c > kCosMinCcdAngle)
+			{
+				continue;
+			}
+			IKVector3 axis = Cross(toEnd, toTarget);
+			float s = Length(axis);
+			if (s == 0.0f)
+			{
+				continue;
+			}
+			axis = Scale(axis, 1.0f / s);
+
+			// One rotation matrix per pivot, applied to every joint after it
+			float t = 1.0f - c;
+			float m00 = c + axis.x * axis.x * t, m01 = axis.x * axis.y * t - axis.z * s, m02 = axis.x * axis.z * t + axis.y * s;
+			float m10 = axis.y * axis.x * t + axis.z * s, m11 = c + axis.y * axis.y * t, m12 = axis.y * axis.z * t - axis.x * s;
+			float m20 = axis.z * axis.x * t - axis.y * s, m21 = axis.z * axis.y * t + axis.x * s, m22 = c + axis.z * axis.z * t;
+			for (int j = i + 1; j <= endIndex; ++j)
+			{
+				IKVector3 v = Sub(joints[j], pivot);
+				joints[j] = IKVector3{ pivot.x + m00 * v.x + m01 * v.y + m02 * v.z,
+					pivot.y + m10 * v.x + m11 * v.y + m12 * v.z,
+					pivot.z + m20 * v.x + m21 * v.y + m22 * v.z };
+			}
+
+			// the same rotation turns bones i..end-1; half angles straight from c and s
+			if (bone_rotations != nullptr)
+			{
+				float halfCos, halfSin;
+				HalfAngle(c, s, halfCos, halfSin);
+				pivotRotations[i] = IKQuaternion{ axis.x * halfSin, axis.y * halfSin, axis.z * halfSin, halfCos };
+				isPivotRotated[i] = true;
+			}
+		}
+
+		// Pivots run from the end back to the root, so over one sweep bone j turns by
+		// q0 * q1 * ... * qj; a running product applies the sweep in one pass
+		if (bone_rotations != nullptr)
+		{
+			IKQuaternion sweep{ 0.0f, 0.0f, 0.0f, 1.0f };
+			bool isSweepRotated = false;
+			for (int j = 0; j < endIndex; ++j)
+			{
+				if (isPivotRotated[j])
+				{
+					sweep = isSweepRotated ? Multiply(sweep, pivotRotations[j]) : pivotRotations[j];
+					isSweepRotated = true;
+					isPivotRotated[j] = false;
+				}
+				if (isSweepRotated)
+				{
+					bone_rotations[j] = Multiply(sweep, bone_rotations[j]);
+				}
+			}
+		}
+	}
+
+	if (bone_rotations != nullptr)
+	{
+		// products of unit quaternions drift slowly; renormalize once per solve
+		for (int j = 0; j < endIndex; ++j)
+		{
+			bone_rotations[j] = NormalizeQuaternion(bone_rotations[j]);
+		}
+		bone_rotations[endIndex] = bone_rotations[endIndex - 1];
+	}
+
+	return iter;
+}
+
+int IKSolver::SolveFABRIK(IKVector3* joints, int joint_count, const IKVector3& target, int max_iterations, float tolerance, IKQuaternion* bone_rotations)
+{
+	if (!IsValidChain(joints, joint_count))
+	{
+		return -1;
+	}
+
+	IKVector3 directions[IK_MAX_CHAIN_JOINTS];
+	if (bone_rotations != nullptr)
+	{
+		CaptureBoneDirections(joints, joint_count, directions);
+	}
+
+	float boneLengths[IK_MAX_CHAIN_JOINTS];
+	float totalLength = 0.0f;
+	for (int i = 0; i < joint_count - 1; ++i)
+	{
+		boneLengths[i] = Distance(joints[i], joints[i + 1]);
+		totalLength += boneLengths[i];
+	}
+
+	IKVector3 root = joints[0];
+
+	// unreachable target: stretch the chain straight towards it
+	if (Distance(root, target) > totalLength)
+	{
+		IKVector3 direction = Normalize(Sub(target, root));
+		for (int i = 1; i < joint_count; ++i)
+		{
+			joints[i] = Add(joints[i - 1], Scale(direction, boneLengths[i - 1]));
+		}
+		if (bone_rotations != nullptr)
+		{
+			UpdateBoneRotations(directions, joints, joint_count, bone_rotations);
+		}
+		return 0;
+	}
+
+	int endIndex = joint_count - 1;
+	int iter = 0;
+	for (; iter < max_iterations; ++iter)
+	{
+		if (Distance(joints[endIndex], target) < tolerance)
+		{
+			break;
+		}
+
+		// forward reaching: pin the end effector to the target
+		joints[endIndex] = target;
+		for (int i = endIndex - 1; i >= 0; --i)
+		{
+			IKVector3 direction = Normalize(Sub(joints[i], joints[i + 1]));
+			joints[i] = Add(joints[i + 1], Scale(direction, boneLengths[i]));
+		}
+
+		// backward reaching: pin the root back in place
+		joints[0] = root;
+		for (int i = 0; i < endIndex; ++i)
+		{
+			IKVector3 direction = Normalize(Sub(joints[i + 1], joints[i]));
+			joints[i + 1] = Add(joints[i], Scale(direction, boneLengths[i]));
+		}
+	}
+
+	if (bone_rotations != nullptr)
+	{
+		UpdateBoneRotations(directions, joints, joint_count, bone_rotations);
+	}
+	return iter;
+}
+
+int IKSolver::SolveTwoBone(IKVector3* joints, const IKVector3& target, const IKVector3* pole_target, IKQuaternion* bone_rotations)
+{
+	if (joints == nullptr)
+	{
+		return -1;
+	}
+
+	IKVector3 directions[2];
+	if (bone_rotations != nullptr)
+	{
+		CaptureBoneDirections(joints, 3, directions);
+	}
+
+	IKVector3 root = joints[0];
+	IKVector3 pole = pole_target != nullptr ? *pole_target : joints[1];
+	float upper = Distance(joints[0], joints[1]);
+	float lower = Distance(joints[1], joints[2]);
+
+	IKVector3 toTarget = Sub(target, root);
+	float targetDistance = Length(toTarget);
+	// a target on the root keeps the current chain direction
+	IKVector3 direction = Normalize(targetDistance > 0.0f ? toTarget : Sub(joints[2], root));
+
+	// unreachable targets stretch the chain, too-close ones fold it as far as it goes
+	float reach = Clamp(targetDistance, std::fabs(upper - lower), upper + lower);
+
+	// bend direction: pole projected onto the plane perpendicular to the reach direction
+	IKVector3 toPole = Sub(pole, root);
+	IKVector3 bend = Sub(toPole, Scale(direction, Dot(toPole, direction)));
+	if (Length(bend) < 1e-6f)
+	{
+		bend = std::fabs(direction.x) < 0.9f ? IKVector3{ 0.0f, -direction.z, direction.y } : IKVector3{ direction.z, 0.0f, -direction.x };
+	}
+	bend = Normalize(bend);
+
+	float cosAngle = (upper > 0.0f && reach > 0.0f) ? Clamp((upper * upper + reach * reach - lower * lower) / (2.0f * upper * reach), -1.0f, 1.0f) : 1.0f;
+	float sinAngle = std::sqrt(1.0f - cosAngle * cosAngle);
+
+	joints[1] = Add(root, Scale(Add(Scale(direction, cosAngle), Scale(bend, sinAngle)), upper));
+	joints[2] = Add(root, Scale(direction, reach));
+
+	if (bone_rotations != nullptr)
+	{
+		UpdateBoneRotations(directions, joints, 3, bone_rotations);
+	}
+	return 0;
+}
+
+int IKSolver::Solve(IKSolverType solver_type, IKVector3* joints, int joint_count, const IKVector3& target, int max_iterations, float tolerance, IKQuaternion* bone_rotations)
+{
+	if (joint_count == 3 && joints != nullptr && (solver_type == IKST_CCD || solver_type == IKST_FABRIK))
+	{
+		return SolveTwoBone(joints, target, nullptr, bone_rotations);
+	}
+
+	switch (solver_type)
+	{
+	case IKST_CCD:
+		return SolveCCD(joints, joint_count, target, max_iterations, tolerance, bone_rotations);
+	case IKST_FABRIK:
+		return SolveFABRIK(joints, joint_count, target, max_iterations, tolerance, bone_rotations);
+	default:
+		return -1;
+	}
+}
+
+int IKSolver::SolveFABRIKBatch(float* xs, float* ys, float* zs, int chain_count, int joint_count, const float* targets, int max_iterations, float tolerance)
+{
+	if (xs == nullptr || ys == nullptr || zs == nullptr || targets == nullptr
+		|| chain_count <= 0 || chain_count > IK_MAX_BATCH_CHAINS
+		|| joint_count < 2 || joint_count > IK_MAX_CHAIN_JOINTS)
+	{
+		return -1;
+	}
+
+	float boneLengths[(IK_MAX_CHAIN_JOINTS - 1) * IK_MAX_BATCH_CHAINS];
+	float rootX[IK_MAX_BATCH_CHAINS];
+	float rootY[IK_MAX_BATCH_CHAINS];
+	float rootZ[IK_MAX_BATCH_CHAINS];
+	// 1.0f while a chain is still iterating; used as a blend weight so the loops stay branch-free
+	float active[IK_MAX_BATCH_CHAINS];
+
+	const int endRow = (joint_count - 1) * chain_count;
+	int activeCount = 0;
+	for (int c = 0; c < chain_count; ++c)
+	{
+		float totalLength = 0.0f;
+		for (int i = 0; i < joint_count - 1; ++i)
+		{
+			int a = i * chain_count + c;
+			int b = a + chain_count;
+			float dx = xs[b] - xs[a];
+			float dy = ys[b] - ys[a];
+			float dz = zs[b] - zs[a];
+			boneLengths[a] = std::sqrt(dx * dx + dy * dy + dz * dz);
+			totalLength += boneLengths[a];
+		}
+		rootX[c] = xs[c];
+		rootY[c] = ys[c];
+		rootZ[c] = zs[c];
+
+		float tx = targets[c * 3] - xs[c];
+		float ty = targets[c * 3 + 1] - ys[c];
+		float tz = targets[c * 3 + 2] - zs[c];
+		float distance = std::sqrt(tx * tx + ty * ty + tz * tz);
+		if (distance > totalLength)
+		{
+			// unreachable: stretch the chain towards the target and leave it out of the iterations
+			float inv = distance > 0.0f ? 1.0f / distance : 0.0f;
+			for (int i = 1; i < joint_count; ++i)
+			{
+				int j = i * chain_count + c;
+				int p = j - chain_count;
+				float l = boneLengths[p] * inv;
+				xs[j] = xs[p] + tx * l;
+				ys[j] = ys[p] + ty * l;
+				zs[j] = zs[p] + tz * l;
+			}
+			active[c] = 0.0f;
+		}
+		else
+		{
+			active[c] = 1.0f;
+			++activeCount;
+		}
+	}
+
+	// moves joint dst (row dstRow) to lie boneLengths away from src, for every active chain
+	auto placeRow = [&](int dstRow, int srcRow, int lengthRow)
+	{
+		int c = 0;
+#if defined(__wasm_simd128__)
+		// four chains per step; same arithmetic as the scalar loop below, which handles the tail
+		const v128_t zero = wasm_f32x4_splat(0.0f);
+		for (; c + 4 <= chain_count; c += 4)
+		{
+			float* dxp = xs + dstRow + c;
+			float* dyp = ys + dstRow + c;
+			float* dzp = zs + dstRow + c;
+			v128_t sx = wasm_v128_load(xs + srcRow + c);
+			v128_t sy = wasm_v128_load(ys + srcRow + c);
+			v128_t sz = wasm_v128_load(zs + srcRow + c);
+			v128_t px = wasm_v128_load(dxp);
+			v128_t py = wasm_v128_load(dyp);
+			v128_t pz = wasm_v128_load(dzp);
+			v128_t dx = wasm_f32x4_sub(px, sx);
+			v128_t dy = wasm_f32x4_sub(py, sy);
+			v128_t dz = wasm_f32x4_sub(pz, sz);
+			v128_t len = wasm_f32x4_sqrt(wasm_f32x4_add(wasm_f32x4_add(wasm_f32x4_mul(dx, dx), wasm_f32x4_mul(dy, dy)), wasm_f32x4_mul(dz, dz)));
+			v128_t scale = wasm_v128_and(wasm_f32x4_div(wasm_v128_load(boneLengths + lengthRow + c), len), wasm_f32x4_gt(len, zero));
+			v128_t w = wasm_v128_load(active + c);
+			wasm_v128_store(dxp, wasm_f32x4_add(px, wasm_f32x4_mul(w, wasm_f32x4_sub(wasm_f32x4_add(sx, wasm_f32x4_mul(dx, scale)), px))));
+			wasm_v128_store(dyp, wasm_f32x4_add(py, wasm_f32x4_mul(w, wasm_f32x4_sub(wasm_f32x4_add(sy, wasm_f32x4_mul(dy, scale)), py))));
+			wasm_v128_store(dzp, wasm_f32x4_add(pz, wasm_f32x4_mul(w, wasm_f32x4_sub(wasm_f32x4_add(sz, wasm_f32x4_mul(dz, scale)), pz))));
+		}
+#endif
+		for (; c < chain_count; ++c)
+		{
+			int d = dstRow + c;
+			int s = srcRow + c;
+			float dx = xs[d] - xs[s];
+			float dy = ys[d] - ys[s];
+			float dz = zs[d] - zs[s];
+			float len = std::sqrt(dx * dx + dy * dy + dz * dz);
+			float scale = len > 0.0f ? boneLengths[lengthRow + c] / len : 0.0f;
+			float w = active[c];
+			xs[d] += w * (xs[s] + dx * scale - xs[d]);
+			ys[d] += w * (ys[s] + dy * scale - ys[d]);
+			zs[d] += w * (zs[s] + dz * scale - zs[d]);
+		}
+	};
+
+	int iter = 0;
+	for (; iter < max_iterations && activeCount > 0; ++iter)
+	{
+		for (int c = 0; c < chain_count; ++c)
+		{
+			if (active[c] == 0.0f)
+			{
+				continue;
+			}
+			float dx = xs[endRow + c] - targets[c * 3];
+			float dy = ys[endRow + c] - targets[c * 3 + 1];
+			float dz = zs[endRow + c] - targets[c * 3 + 2];
+			if (std::sqrt(dx * dx + dy * dy + dz * dz) < tolerance)
+			{
+				active[c] = 0.0f;
+				--activeCount;
+			}
+		}
+		if (activeCount == 0)
+		{
+			break;
+		}
+
+		// forward reaching
+		for (int c = 0; c < chain_count; ++c)
+		{
+			float w = active[c];
+			xs[endRow + c] += w * (targets[c * 3] - xs[endRow + c]);
+			ys[endRow + c] += w * (targets[c * 3 + 1] - ys[endRow + c]);
+			zs[endRow + c] += w * (targets[c * 3 + 2] - zs[endRow + c]);
+		}
+		for (int i = joint_count - 2; i >= 0; --i)
+		{
+			placeRow(i * chain_count, (i + 1) * chain_count, i * chain_count);
+		}
+
+		// backward reaching
+		for (int c = 0; c < chain_count; ++c)
+		{
+			float w = active[c];
+			xs[c] += w * (rootX[c] - xs[c]);
+			ys[c] += w * (rootY[c] - ys[c]);
+			zs[c] += w * (rootZ[c] - zs[c]);
+		}
+		for (int i = 0; i < joint_count - 1; ++i)
+		{
+			placeRow((i + 1) * chain_count, i * chain_count, i * chain_count);
+		}
+	}
+
+	return iter;
+}
+
+void IKSolver::CalculateBoneRotations(const IKVector3* joints, int joint_count, IKVector3* rotations)
+{
+	if (joints == nullptr || rotations == nullptr || joint_count < 2)
+	{
+		return;
+	}
+
+	for (int i = 0; i < joint_count - 1; ++i)
+	{
+		IKVector3 bone = Normalize(Sub(joints[i + 1], joints[i]));
+		float yaw = std::atan2(bone.x, bone.z) * kRadToDeg;
+		float pitch = std::asin(Clamp(-bone.y, -1.0f, 1.0f)) * kRadToDeg;
+		rotations[i] = IKVector3{ pitch, yaw, 0.0f };
+	}
+
+	rotations[joint_count - 1] = rotations[joint_count - 2];
+}
+
+void IKSolver::InitBoneRotations(const IKVector3* joints, int joint_count, IKQuaternion* rotations)
+{
+	if (joints == nullptr || rotations == nullptr || joint_count < 2)
+	{
+		return;
+	}
+
+	for (int i = 0; i < joint_count - 1; ++i)
+	{
+		IKVector3 bone = Normalize(Sub(joints[i + 1], joints[i]));
+		// cos/sin of yaw = atan2(x, z) and pitch = asin(-y), then their half angles
+		float horizontal = std::sqrt(bone.x * bone.x + bone.z * bone.z);
+		float cosYaw = horizontal > 0.0f ? bone.z / horizontal : 1.0f;
+		float sinYaw = horizontal > 0.0f ? bone.x / horizontal : 0.0f;
+		float halfCosYaw, halfSinYaw, halfCosPitch, halfSinPitch;
+		HalfAngle(cosYaw, sinYaw, halfCosYaw, halfSinYaw);
+		HalfAngle(horizontal, -bone.y, halfCosPitch, halfSinPitch);
+		// yaw about y composed with pitch about x
+		rotations[i] = IKQuaternion{ halfCosYaw * halfSinPitch, halfSinYaw * halfCosPitch, -halfSinYaw * halfSinPitch, halfCosYaw * halfCosPitch };
+	}
+
+	rotations[joint_count - 1] = rotations[joint_count - 2];
+}
@@ -0,0 +1,74 @@
+#ifndef IK_SOLVER_H
+#define IK_SOLVER_H
+
+//!
+//! @brief - Native CCD/FABRIK solver shared by the hand and holistic tracking DLLs
+//!
+//! Same algorithms as IKSolver.js / IKSolver.pas, but operating in place on flat
+//! joint arrays so landmark data from the graph can be solved without being
+//! converted into per-joint objects. Nothing here allocates.
+//!
+
+// chains longer than this are rejected; a finger is 5 joints, an arm 3
+#define IK_MAX_CHAIN_JOINTS 32
+// upper bound for SolveFABRIKBatch; two hands are 10 finger chains
+#define IK_MAX_BATCH_CHAINS 64
+
+struct IKVector3
+{
+	float x;
+	float y;
+	float z;
+};
+
+// unit quaternion, x y z w
+struct IKQuaternion
+{
+	float x;
+	float y;
+	float z;
+	float w;
+};
+
+enum IKSolverType
+{
+	IKST_CCD = 0,
+	IKST_FABRIK = 1
+};
+
+class IKSolver
+{
+public:
+	// All solvers update joints[0..joint_count) in place and return the number of
+	// iterations used, or -1 if the chain is invalid. joints[0] is the root.
+	// bone_rotations, when not null, holds one orientation per joint (see InitBoneRotations)
+	// and is updated along with the joints: CCD applies each pivot's rotation to the bones
+	// it moves, so twist accumulates; FABRIK and two-bone turn every bone by the shortest
+	// arc from its old to its new direction.
+	static int SolveCCD(IKVector3* joints, int joint_count, const IKVector3& target, int max_iterations = 10, float tolerance = 0.01f, IKQuaternion* bone_rotations = nullptr);
+	static int SolveFABRIK(IKVector3* joints, int joint_count, const IKVector3& target, int max_iterations = 10, float tolerance = 0.01f, IKQuaternion* bone_rotations = nullptr);
+	// Closed-form shoulder-elbow-wrist solve (law of cosines). The middle joint bends towards
+	// pole_target, or towards its current position when pole_target is null. Returns 0.
+	static int SolveTwoBone(IKVector3* joints, const IKVector3& target, const IKVector3* pole_target = nullptr, IKQuaternion* bone_rotations = nullptr);
+
+	// Dispatches to CCD/FABRIK; 3-joint chains always take the SolveTwoBone fast path
+	static int Solve(IKSolverType solver_type, IKVector3* joints, int joint_count, const IKVector3& target, int max_iterations = 10, float tolerance = 0.01f, IKQuaternion* bone_rotations = nullptr);
+
+	// FABRIK over chain_count equal-length chains in lockstep. Coordinates are joint-major
+	// struct-of-arrays, xs[joint * chain_count + chain], so each pass runs one contiguous
+	// loop over all chains that the compiler can vectorize. targets holds xyz per chain.
+	// Returns the iterations used by the slowest chain, or -1 if the batch is invalid.
+	static int SolveFABRIKBatch(float* xs, float* ys, float* zs, int chain_count, int joint_count, const float* targets, int max_iterations = 10, float tolerance = 0.01f);
+
+	// Writes (pitch, yaw, roll) in degrees for every joint, matching calculateBoneRotations
+	// in IKSolver.js. The last joint repeats the rotation of the last bone.
+	static void CalculateBoneRotations(const IKVector3* joints, int joint_count, IKVector3* rotations);
+	// Seeds bone orientations for the solvers: yaw about y, then pitch about x, no roll, i.e.
+	// the orientation CalculateBoneRotations describes, rotating +z onto each bone. Built from
+	// half angles, no trig. Call once per chain; after that the solvers keep it current.
+	static void InitBoneRotations(const IKVector3* joints, int joint_count, IKQuaternion* rotations);
+
+	static IKVector3 RotateAroundAxis(const IKVector3& vector, const IKVector3& axis, float angle);
+};
+
+#endif // !IK_SOLVER_H
@@ -0,0 +1,130 @@
+#include "ik_solver_api.h"
+#include "ik_solver.h"
+
+static_assert(sizeof(IKVector3) == 3 * sizeof(float), "IKVector3 must alias packed xyz floats");
+static_assert(sizeof(IKQuaternion) == 4 * sizeof(float), "IKQuaternion must alias packed xyzw floats");
+
+EXPORT_IK_API int Mediapipe_IK_Solve_Chain(float* joint_positions, int joint_count, const float* target_position, int solver_type, int max_iterations, float tolerance, float* bone_rotations, int* iterations_used)
+{
+	if (joint_positions == nullptr || target_position == nullptr)
+	{
+		return 0;
+	}
+
+	IKVector3* joints = reinterpret_cast<IKVector3*>(joint_positions);
+	IKVector3 target{ target_position[0], target_position[1], target_position[2] };
+
+	int iterations = IKSolver::Solve((IKSolverType)solver_type, joints, joint_count, target, max_iterations, tolerance);
+	if (iterations < 0)
+	{
+		return 0;
+	}
+
+	if (bone_rotations != nullptr)
+	{
+		IKSolver::CalculateBoneRotations(joints, joint_count, reinterpret_cast<IKVector3*>(bone_rotations));
+	}
+	if (iterations_used != nullptr)
+	{
+		*iterations_used = iterations;
+	}
+
+	return 1;
+}
+
+EXPORT_IK_API int Mediapipe_IK_Solve_Chain_Quaternion(float* joint_positions, int joint_count, const float* target_position, int solver_type, int max_iterations, float tolerance, float* bone_quaternions, int is_initialized, int* iterations_used)
+{
+	if (joint_positions == nullptr || target_position == nullptr || bone_quaternions == nullptr)
+	{
+		return 0;
+	}
+
+	IKVector3* joints = reinterpret_cast<IKVector3*>(joint_positions);
+	IKQuaternion* rotations = reinterpret_cast<IKQuaternion*>(bone_quaternions);
+	IKVector3 target{ target_position[0], target_position[1], target_position[2] };
+
+	if (is_initialized == 0)
+	{
+		IKSolver::InitBoneRotations(joints, joint_count, rotations);
+	}
+	int iterations = IKSolver::Solve((IKSolverType)solver_type, joints, joint_count, target, max_iterations, tolerance, rotations);
+	if (iterations < 0)
+	{
+		return 0;
+	}
+
+	if (iterations_used != nullptr)
+	{
+		*iterations_used = iterations;
+	}
+
+	return 1;
+}
+
+EXPORT_IK_API int Mediapipe_IK_Solve_Landmark_Chain(float* landmarks, int landmark_count, int landmark_stride, const int* chain_indices, int chain_length, const float* target_position, int solver_type, int max_iterations, float tolerance, float* bone_rotations, int* iterations_used)
+{
+	if (landmarks == nullptr || chain_indices == nullptr || target_position == nullptr
+		|| (landmark_stride != 2 && landmark_stride != 3)
+		|| chain_length < 2 || chain_length > IK_MAX_CHAIN_JOINTS)
+	{
+		return 0;
+	}
+
+	// gather the chain into a stack buffer, solve, and scatter it back
+	IKVector3 joints[IK_MAX_CHAIN_JOINTS];
+	for (int i = 0; i < chain_length; ++i)
+	{
+		int index = chain_indices[i];
+		if (index < 0 || index >= landmark_count)
+		{
+			return 0;
+		}
+		const float* landmark = landmarks + index * landmark_stride;
+		joints[i] = IKVector3{ landmark[0], landmark[1], landmark_stride == 3 ? landmark[2] : 0.0f };
+	}
+
+	IKVector3 target{ target_position[0], target_position[1], landmark_stride == 3 ? target_position[2] : 0.0f };
+	int iterations = IKSolver::Solve((IKSolverType)solver_type, joints, chain_length, target, max_iterations, tolerance);
+	if (iterations < 0)
+	{
+		return 0;
+	}
+
+	for (int i = 0; i < chain_length; ++i)
+	{
+		float* landmark = landmarks + chain_indices[i] * landmark_stride;
+		landmark[0] = joints[i].x;
+		landmark[1] = joints[i].y;
+		if (landmark_stride == 3)
+		{
+			landmark[2] = joints[i].z;
+		}
+	}
+
+	if (bone_rotations != nullptr)
+	{
+		IKSolver::CalculateBoneRotations(joints, chain_length, reinterpret_cast<IKVector3*>(bone_rotations));
+	}
+	if (iterations_used != nullptr)
+	{
+		*iterations_used = iterations;
+	}
+
+	return 1;
+}
+
+EXPORT_IK_API int Mediapipe_IK_Solve_Chain_Batch(float* xs, float* ys, float* zs, int chain_count, int joint_count, const float* targets, int max_iterations, float tolerance, int* iterations_used)
+{
+	int iterations = IKSolver::SolveFABRIKBatch(xs, ys, zs, chain_count, joint_count, targets, max_iterations, tolerance);
+	if (iterations < 0)
+	{
+		return 0;
+	}
+
+	if (iterations_used != nullptr)
+	{
+		*iterations_used = iterations;
+	}
+
+	return 1;
+}
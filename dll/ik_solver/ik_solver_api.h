@@ -0,0 +1,53 @@
+#ifndef IK_SOLVER_API_H
+#define IK_SOLVER_API_H
+
+#if defined(_WIN32)
+#define EXPORT_IK_API extern "C" __declspec(dllexport)
+#elif defined(__EMSCRIPTEN__)
+// standalone WebAssembly build for the browser demo, see IK_README.md
+#include <emscripten/emscripten.h>
+#define EXPORT_IK_API extern "C" EMSCRIPTEN_KEEPALIVE
+#else
+#define EXPORT_IK_API extern "C" __attribute__((visibility("default")))
+#endif
+
+//!
+//! @brief - IK exports linked into Mediapipe_Hand_Tracking and MediapipeHolisticTracking
+//!
+//! solver_type: 0 = CCD, 1 = FABRIK. bone_rotations may be null; otherwise it receives
+//! (pitch, yaw, roll) in degrees for every joint of the chain. iterations_used may be null.
+//! Every call returns 1 on success and 0 if the arguments are invalid.
+//!
+
+/*
+@brief Solve a chain stored as interleaved xyz floats, in place
+@param[in,out] joint_positions joint_count * 3 floats, root first
+@param[in] target_position 3 floats
+*/
+EXPORT_IK_API int Mediapipe_IK_Solve_Chain(float* joint_positions, int joint_count, const float* target_position, int solver_type, int max_iterations, float tolerance, float* bone_rotations, int* iterations_used);
+
+/*
+@brief Solve a chain picked out of a landmark array by index, in place
+@param[in,out] landmarks landmark_count landmarks of landmark_stride floats each;
+	a stride of 2 matches PoseInfo (z is taken as 0), a stride of 3 is x, y, z
+@param[in] chain_indices chain_length landmark indices, root first, e.g. {0, 5, 6, 7, 8} for the index finger
+*/
+EXPORT_IK_API int Mediapipe_IK_Solve_Landmark_Chain(float* landmarks, int landmark_count, int landmark_stride, const int* chain_indices, int chain_length, const float* target_position, int solver_type, int max_iterations, float tolerance, float* bone_rotations, int* iterations_used);
+
+/*
+@brief Solve a chain like Mediapipe_IK_Solve_Chain, keeping a quaternion per joint current
+@param[in,out] bone_quaternions joint_count * 4 floats, x y z w per joint, kept by the caller
+	between calls; each is the rotation taking +z onto the joint's bone, twist included
+@param[in] is_initialized 0 seeds bone_quaternions from the current joints first (yaw, then
+	pitch, no roll, matching bone_rotations); pass 1 once the caller holds earlier output
+*/
+EXPORT_IK_API int Mediapipe_IK_Solve_Chain_Quaternion(float* joint_positions, int joint_count, const float* target_position, int solver_type, int max_iterations, float tolerance, float* bone_quaternions, int is_initialized, int* iterations_used);
+
+/*
+@brief FABRIK over many equal-length chains at once, e.g. every finger of both hands
+@param[in,out] xs,ys,zs chain_count * joint_count floats each, joint-major: xs[joint * chain_count + chain]
+@param[in] targets chain_count * 3 floats, xyz per chain
+*/
+EXPORT_IK_API int Mediapipe_IK_Solve_Chain_Batch(float* xs, float* ys, float* zs, int chain_count, int joint_count, const float* targets, int max_iterations, float tolerance, int* iterations_used);
+
+#endif // !IK_SOLVER_API_H
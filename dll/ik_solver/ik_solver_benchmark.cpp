@@ -0,0 +1,343 @@
+//!
+//! @brief - Speed and convergence benchmark for the native IK solver
+//!
+//! Same cases and output columns as IKSolverBenchmark.js / IKSolverBenchmark.pas:
+//! solves/sec, mean iterations, residual error and heap allocations per solve, over a
+//! synthetic finger-curl sequence or a recorded landmark file (a JSON array of frames
+//! of 21 {x, y, z}).
+//!
+//! Usage: ik_solver_benchmark [--frames N] [--landmarks rec.json] [--random] [--seed S]
+//!
+
+#include "ik_solver.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+	std::atomic<long long> g_allocations{ 0 };
+
+	const int kFingerCount = 5;
+	const int kFingerJoints = 5;
+	const int kHandLandmarks = 21;
+	const float kScale = 100.0f; // same scale as IKSolverBenchmark.js
+
+	struct HandFrame
+	{
+		IKVector3 landmarks[kHandLandmarks];
+	};
+
+	struct FrameTargets
+	{
+		IKVector3 tips[kFingerCount];
+	};
+
+	struct SolveResult
+	{
+		int iterations;
+		float residual;
+	};
+
+	// Joint 0 of every finger chain is the wrist, as in FingerChainIndices
+	int FingerIndex(int finger, int joint)
+	{
+		return joint == 0 ? 0 : finger * 4 + joint;
+	}
+
+	float Distance(const IKVector3& a, const IKVector3& b)
+	{
+		return std::sqrt((a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y) + (a.z - b.z) * (a.z - b.z));
+	}
+
+	void PackFinger(const HandFrame& frame, int finger, IKVector3* joints)
+	{
+		for (int j = 0; j < kFingerJoints; ++j)
+			joints[j] = frame.landmarks[FingerIndex(finger, j)];
+	}
+
+	// Open hand in the y/z plane, each finger curling at its own rate, plus jitter
+	std::vector<HandFrame> CreateSyntheticSequence(int frame_count, std::mt19937& random)
+	{
+		const float knuckle_x[kFingerCount] = { -3.0f, -1.5f, 0.0f, 1.5f, 3.0f };
+		const float bone_length[4] = { 4.0f, 2.5f, 2.0f, 1.5f };
+		std::uniform_real_distribution<float> jitter(-0.1f, 0.1f);
+
+		std::vector<HandFrame> frames(frame_count);
+		for (int f = 0; f < frame_count; ++f)
+		{
+			const float t = f / 30.0f;
+			const IKVector3 drift{ std::sin(t * 0.7f) * 2.0f, std::cos(t * 0.5f) * 2.0f, 0.0f };
+			HandFrame& frame = frames[f];
+			frame.landmarks[0] = drift;
+			for (int k = 0; k < kFingerCount; ++k)
+			{
+				const float curl = (std::sin(t * (1.0f + k * 0.3f)) + 1.0f) * 0.35f;
+				IKVector3 pos{ drift.x + knuckle_x[k], drift.y + bone_length[0], drift.z };
+				frame.landmarks[FingerIndex(k, 1)] = pos;
+				float angle = 0.0f;
+				for (int j = 2; j <= 4; ++j)
+				{
+					angle += curl;
+					pos.y += std::cos(angle) * bone_length[j - 1];
+					pos.z += std::sin(angle) * bone_length[j - 1];
+					frame.landmarks[FingerIndex(k, j)] = pos;
+				}
+			}
+			for (IKVector3& p : frame.landmarks)
+			{
+				p.x += jitter(random);
+				p.y += jitter(random);
+				p.z += jitter(random);
+			}
+		}
+		return frames;
+	}
+
+	// The recorded format only contains x/y/z numbers, so reading every number in order
+	// yields the landmarks without a JSON parser
+	std::vector<HandFrame> LoadRecordedSequence(const char* path, int max_frames)
+	{
+		std::ifstream file(path);
+		std::stringstream text;
+		text << file.rdbuf();
+		const std::string json = text.str();
+
+		std::vector<float> values;
+		const char* p = json.c_str();
+		while (*p)
+		{
+			if ((*p >= '0' && *p <= '9') || *p == '-' || *p == '.')
+			{
+				char* end = nullptr;
+				values.push_back(std::strtof(p, &end));
+				p = end > p ? end : p + 1;
+			}
+			else
+				++p;
+		}
+
+		const size_t per_frame = kHandLandmarks * 3;
+		std::vector<HandFrame> frames(std::min<size_t>(values.size() / per_frame, max_frames));
+		for (size_t f = 0; f < frames.size(); ++f)
+			for (int i = 0; i < kHandLandmarks; ++i)
+			{
+				const float* v = &values[f * per_frame + i * 3];
+				frames[f].landmarks[i] = IKVector3{ v[0] * kScale, v[1] * kScale, v[2] * kScale };
+			}
+		return frames;
+	}
+
+	std::vector<FrameTargets> CreateTargets(const std::vector<HandFrame>& frames, bool random_targets, std::mt19937& random)
+	{
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+		std::vector<FrameTargets> targets(frames.size());
+		for (size_t f = 0; f < frames.size(); ++f)
+			for (int k = 0; k < kFingerCount; ++k)
+			{
+				if (random_targets)
+				{
+					float reach = 0.0f;
+					for (int j = 0; j < kFingerJoints - 1; ++j)
+						reach += Distance(frames[f].landmarks[FingerIndex(k, j)], frames[f].landmarks[FingerIndex(k, j + 1)]);
+					const IKVector3& base = frames[f].landmarks[0];
+					const float r = reach * 0.9f * std::cbrt(unit(random));
+					const float theta = unit(random) * 6.2831853f;
+					const float phi = std::acos(2.0f * unit(random) - 1.0f);
+					targets[f].tips[k] = IKVector3{ base.x + r * std::sin(phi) * std::cos(theta),
+						base.y + r * std::sin(phi) * std::sin(theta), base.z + r * std::cos(phi) };
+				}
+				else
+				{
+					const HandFrame& next = frames[std::min(f + 1, frames.size() - 1)];
+					targets[f].tips[k] = next.landmarks[FingerIndex(k, kFingerJoints - 1)];
+				}
+			}
+		return targets;
+	}
+
+	void Run(const char* name, const std::function<SolveResult(const HandFrame&, const FrameTargets&)>& solve,
+		const std::vector<HandFrame>& frames, const std::vector<FrameTargets>& targets)
+	{
+		// Warm up caches before measuring
+		for (size_t f = 0; f < std::min<size_t>(200, frames.size()); ++f)
+			solve(frames[f], targets[f]);
+
+		long long iterations = 0;
+		double residual = 0.0;
+		float max_residual = 0.0f;
+		const long long allocations = g_allocations.load();
+		const auto start = std::chrono::steady_clock::now();
+		for (size_t f = 0; f < frames.size(); ++f)
+		{
+			const SolveResult r = solve(frames[f], targets[f]);
+			iterations += r.iterations;
+			residual += r.residual;
+			max_residual = std::max(max_residual, r.residual / kFingerCount);
+		}
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		const double solves = static_cast<double>(frames.size()) * kFingerCount;
+
+		std::printf("%-14s%10.0f%12.2f%13.4f%13.4f%14.2f\n", name, solves / std::max(seconds, 1e-9),
+			iterations / solves, residual / solves, max_residual, (g_allocations.load() - allocations) / solves);
+	}
+}
+
+// Every heap allocation in the process is counted; the solver itself should add none
+void* operator new(std::size_t size)
+{
+	g_allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* p = std::malloc(size ? size : 1))
+		return p;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+int main(int argc, char** argv)
+{
+	int frame_count = 2000;
+	unsigned seed = 1;
+	const char* landmark_file = nullptr;
+	bool random_targets = false;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (!std::strcmp(argv[i], "--frames") && i + 1 < argc)
+			frame_count = std::atoi(argv[++i]);
+		else if (!std::strcmp(argv[i], "--seed") && i + 1 < argc)
+			seed = static_cast<unsigned>(std::atoi(argv[++i]));
+		else if (!std::strcmp(argv[i], "--landmarks") && i + 1 < argc)
+			landmark_file = argv[++i];
+		else if (!std::strcmp(argv[i], "--random"))
+			random_targets = true;
+	}
+
+	std::mt19937 random(seed);
+	const std::vector<HandFrame> frames = landmark_file
+		? LoadRecordedSequence(landmark_file, frame_count)
+		: CreateSyntheticSequence(frame_count, random);
+	if (frames.empty())
+	{
+		std::fprintf(stderr, "no frames to solve\n");
+		return 1;
+	}
+	const std::vector<FrameTargets> targets = CreateTargets(frames, random_targets, random);
+
+	std::printf("IK benchmark: %zu frames x %d fingers, %s targets\n", frames.size(), kFingerCount,
+		random_targets ? "random" : "next-frame");
+	std::printf("solver          solves/s   mean iter   mean resid    max resid  allocs/solve\n");
+
+	auto chain_case = [](IKSolverType solver_type)
+	{
+		return [solver_type](const HandFrame& frame, const FrameTargets& t)
+		{
+			IKVector3 joints[kFingerJoints];
+			SolveResult result{ 0, 0.0f };
+			for (int k = 0; k < kFingerCount; ++k)
+			{
+				PackFinger(frame, k, joints);
+				result.iterations += IKSolver::Solve(solver_type, joints, kFingerJoints, t.tips[k]);
+				result.residual += Distance(joints[kFingerJoints - 1], t.tips[k]);
+			}
+			return result;
+		};
+	};
+	Run("ccd", chain_case(IKST_CCD), frames, targets);
+	Run("fabrik", chain_case(IKST_FABRIK), frames, targets);
+
+	// Rotation output: Euler angles re-derived after every solve, against quaternions the
+	// solver keeps current. The quaternions are seeded once and carried across frames.
+	Run("ccd+euler", [](const HandFrame& frame, const FrameTargets& t)
+	{
+		IKVector3 joints[kFingerJoints];
+		IKVector3 rotations[kFingerJoints];
+		SolveResult result{ 0, 0.0f };
+		for (int k = 0; k < kFingerCount; ++k)
+		{
+			PackFinger(frame, k, joints);
+			result.iterations += IKSolver::SolveCCD(joints, kFingerJoints, t.tips[k]);
+			IKSolver::CalculateBoneRotations(joints, kFingerJoints, rotations);
+			result.residual += Distance(joints[kFingerJoints - 1], t.tips[k]);
+		}
+		return result;
+	}, frames, targets);
+	IKQuaternion finger_rotations[kFingerCount][kFingerJoints];
+	for (int k = 0; k < kFingerCount; ++k)
+	{
+		IKVector3 joints[kFingerJoints];
+		PackFinger(frames[0], k, joints);
+		IKSolver::InitBoneRotations(joints, kFingerJoints, finger_rotations[k]);
+	}
+	Run("ccd+quat", [&](const HandFrame& frame, const FrameTargets& t)
+	{
+		IKVector3 joints[kFingerJoints];
+		SolveResult result{ 0, 0.0f };
+		for (int k = 0; k < kFingerCount; ++k)
+		{
+			PackFinger(frame, k, joints);
+			result.iterations += IKSolver::SolveCCD(joints, kFingerJoints, t.tips[k], 10, 0.01f, finger_rotations[k]);
+			result.residual += Distance(joints[kFingerJoints - 1], t.tips[k]);
+		}
+		return result;
+	}, frames, targets);
+
+	float xs[kFingerJoints * kFingerCount], ys[kFingerJoints * kFingerCount], zs[kFingerJoints * kFingerCount];
+	float batch_targets[kFingerCount * 3];
+	Run("fabrik-batch", [&](const HandFrame& frame, const FrameTargets& t)
+	{
+		for (int k = 0; k < kFingerCount; ++k)
+		{
+			for (int j = 0; j < kFingerJoints; ++j)
+			{
+				const IKVector3& p = frame.landmarks[FingerIndex(k, j)];
+				xs[j * kFingerCount + k] = p.x;
+				ys[j * kFingerCount + k] = p.y;
+				zs[j * kFingerCount + k] = p.z;
+			}
+			batch_targets[k * 3] = t.tips[k].x;
+			batch_targets[k * 3 + 1] = t.tips[k].y;
+			batch_targets[k * 3 + 2] = t.tips[k].z;
+		}
+		// the batch iterates until its slowest chain converges
+		SolveResult result{ IKSolver::SolveFABRIKBatch(xs, ys, zs, kFingerCount, kFingerJoints, batch_targets) * kFingerCount, 0.0f };
+		const int end = (kFingerJoints - 1) * kFingerCount;
+		for (int k = 0; k < kFingerCount; ++k)
+			result.residual += Distance(IKVector3{ xs[end + k], ys[end + k], zs[end + k] }, t.tips[k]);
+		return result;
+	}, frames, targets);
+
+	// Wrist, knuckle and fingertip as a shoulder-elbow-wrist style chain for the closed form
+	Run("two-bone", [](const HandFrame& frame, const FrameTargets& t)
+	{
+		SolveResult result{ 0, 0.0f };
+		for (int k = 0; k < kFingerCount; ++k)
+		{
+			IKVector3 joints[3] = { frame.landmarks[0], frame.landmarks[FingerIndex(k, 2)], frame.landmarks[FingerIndex(k, 4)] };
+			IKSolver::SolveTwoBone(joints, t.tips[k]);
+			result.residual += Distance(joints[2], t.tips[k]);
+		}
+		return result;
+	}, frames, targets);
+
+	return 0;
+}
@@ -0,0 +1,200 @@
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/landmark.pb.h"
+#include "mediapipe/framework/port/status.h"
+
+#include "ik_solver.h"
+
+//!
+//! @brief - Graph stage turning landmarks into per-joint rotations with the native IK module
+//!
+//! Runs on the graph's own threads, so rotations for frame N are computed while frame N+1
+//! is still in inference and the caller receives them with the landmarks instead of
+//! rebuilding chains itself. Each output entry is (pitch, yaw, roll) in degrees for the
+//! landmark of the same index, as returned by IKSolver::CalculateBoneRotations.
+//!
+//! Inputs:
+//!   LANDMARKS        NormalizedLandmarkList, or
+//!   MULTI_LANDMARKS  std::vector<NormalizedLandmarkList>
+//!   IMAGE_SIZE       optional std::pair<int, int>; x and z are scaled by width and y by
+//!                    height so angles are not skewed by the image aspect ratio
+//! Input side packets:
+//!   PARENTS          optional std::vector<int>, parent of each landmark (-1 for the root,
+//!                    always smaller than the child). Defaults to the 21 hand landmarks.
+//! Outputs:
+//!   ROTATIONS        std::vector<IKVector3> for LANDMARKS, or
+//!   MULTI_ROTATIONS  std::vector<std::vector<IKVector3>> for MULTI_LANDMARKS
+//!
+//! node {
+//!   calculator: "LandmarksToJointRotationsCalculator"
+//!   input_stream: "MULTI_LANDMARKS:multi_hand_landmarks"
+//!   input_stream: "IMAGE_SIZE:image_size"
+//!   output_stream: "MULTI_ROTATIONS:multi_hand_rotations"
+//! }
+//!
+
+namespace mediapipe
+{
+	namespace
+	{
+		constexpr char kLandmarksTag[] = "LANDMARKS";
+		constexpr char kMultiLandmarksTag[] = "MULTI_LANDMARKS";
+		constexpr char kImageSizeTag[] = "IMAGE_SIZE";
+		constexpr char kParentsTag[] = "PARENTS";
+		constexpr char kRotationsTag[] = "ROTATIONS";
+		constexpr char kMultiRotationsTag[] = "MULTI_ROTATIONS";
+
+		const std::vector<int> kHandParents = { -1, 0, 1, 2, 3, 0, 5, 6, 7, 0, 9, 10, 11, 0, 13, 14, 15, 0, 17, 18, 19 };
+	}
+
+	class LandmarksToJointRotationsCalculator : public CalculatorBase
+	{
+	public:
+		static ::mediapipe::Status GetContract(CalculatorContract* cc)
+		{
+			RET_CHECK(cc->Inputs().HasTag(kLandmarksTag) ^ cc->Inputs().HasTag(kMultiLandmarksTag))
+				<< "Exactly one of LANDMARKS or MULTI_LANDMARKS must be connected.";
+
+			if (cc->Inputs().HasTag(kLandmarksTag))
+			{
+				cc->Inputs().Tag(kLandmarksTag).Set<NormalizedLandmarkList>();
+				cc->Outputs().Tag(kRotationsTag).Set<std::vector<IKVector3>>();
+			}
+			else
+			{
+				cc->Inputs().Tag(kMultiLandmarksTag).Set<std::vector<NormalizedLandmarkList>>();
+				cc->Outputs().Tag(kMultiRotationsTag).Set<std::vector<std::vector<IKVector3>>>();
+			}
+			if (cc->Inputs().HasTag(kImageSizeTag))
+			{
+				cc->Inputs().Tag(kImageSizeTag).Set<std::pair<int, int>>();
+			}
+			if (cc->InputSidePackets().HasTag(kParentsTag))
+			{
+				cc->InputSidePackets().Tag(kParentsTag).Set<std::vector<int>>();
+			}
+			return ::mediapipe::OkStatus();
+		}
+
+		::mediapipe::Status Open(CalculatorContext* cc) override
+		{
+			cc->SetOffset(TimestampDiff(0));
+
+			const std::vector<int>& parents = cc->InputSidePackets().HasTag(kParentsTag)
+				? cc->InputSidePackets().Tag(kParentsTag).Get<std::vector<int>>()
+				: kHandParents;
+			m_JointCount = static_cast<int>(parents.size());
+
+			// Split the tree into chains the solver can take: each starts at the root or at a
+			// branch off its parent (the parent is kept as a fixed base) and follows first children
+			std::vector<int> first_child(m_JointCount, -1);
+			for (int j = 0; j < m_JointCount; ++j)
+			{
+				RET_CHECK_LT(parents[j], j) << "Parents must precede their children.";
+				if (parents[j] >= 0 && first_child[parents[j]] < 0)
+				{
+					first_child[parents[j]] = j;
+				}
+			}
+			for (int j = 0; j < m_JointCount; ++j)
+			{
+				const bool is_root = parents[j] < 0;
+				if (!is_root && first_child[parents[j]] == j)
+				{
+					continue;
+				}
+				std::vector<int> chain;
+				if (!is_root)
+				{
+					chain.push_back(parents[j]);
+				}
+				for (int k = j; k >= 0; k = first_child[k])
+				{
+					chain.push_back(k);
+				}
+				RET_CHECK_LE(chain.size(), static_cast<size_t>(IK_MAX_CHAIN_JOINTS));
+				m_Chains.push_back(ChainDefinition{ std::move(chain), !is_root });
+			}
+			return ::mediapipe::OkStatus();
+		}
+
+		::mediapipe::Status Process(CalculatorContext* cc) override
+		{
+			IKVector3 scale{ 1.0f, 1.0f, 1.0f };
+			if (cc->Inputs().HasTag(kImageSizeTag) && !cc->Inputs().Tag(kImageSizeTag).IsEmpty())
+			{
+				const auto& size = cc->Inputs().Tag(kImageSizeTag).Get<std::pair<int, int>>();
+				scale = IKVector3{ static_cast<float>(size.first), static_cast<float>(size.second), static_cast<float>(size.first) };
+			}
+
+			if (cc->Inputs().HasTag(kLandmarksTag))
+			{
+				if (cc->Inputs().Tag(kLandmarksTag).IsEmpty())
+				{
+					return ::mediapipe::OkStatus();
+				}
+				auto rotations = absl::make_unique<std::vector<IKVector3>>();
+				RETURN_IF_ERROR(Rotate(cc->Inputs().Tag(kLandmarksTag).Get<NormalizedLandmarkList>(), scale, *rotations));
+				cc->Outputs().Tag(kRotationsTag).Add(rotations.release(), cc->InputTimestamp());
+			}
+			else
+			{
+				if (cc->Inputs().Tag(kMultiLandmarksTag).IsEmpty())
+				{
+					return ::mediapipe::OkStatus();
+				}
+				const auto& hands = cc->Inputs().Tag(kMultiLandmarksTag).Get<std::vector<NormalizedLandmarkList>>();
+				auto rotations = absl::make_unique<std::vector<std::vector<IKVector3>>>(hands.size());
+				for (size_t h = 0; h < hands.size(); ++h)
+				{
+					RETURN_IF_ERROR(Rotate(hands[h], scale, (*rotations)[h]));
+				}
+				cc->Outputs().Tag(kMultiRotationsTag).Add(rotations.release(), cc->InputTimestamp());
+			}
+			return ::mediapipe::OkStatus();
+		}
+
+	private:
+		struct ChainDefinition
+		{
+			std::vector<int> indices;
+			bool has_base; // indices[0] belongs to another chain and keeps that chain's rotation
+		};
+
+		::mediapipe::Status Rotate(const NormalizedLandmarkList& landmarks, const IKVector3& scale, std::vector<IKVector3>& rotations) const
+		{
+			RET_CHECK_EQ(landmarks.landmark_size(), m_JointCount) << "Landmark count does not match PARENTS.";
+			rotations.assign(m_JointCount, IKVector3{ 0.0f, 0.0f, 0.0f });
+
+			IKVector3 joints[IK_MAX_CHAIN_JOINTS];
+			IKVector3 chain_rotations[IK_MAX_CHAIN_JOINTS];
+			for (const ChainDefinition& chain : m_Chains)
+			{
+				const int count = static_cast<int>(chain.indices.size());
+				if (count < 2)
+				{
+					continue;
+				}
+				for (int i = 0; i < count; ++i)
+				{
+					const NormalizedLandmark& lm = landmarks.landmark(chain.indices[i]);
+					joints[i] = IKVector3{ lm.x() * scale.x, lm.y() * scale.y, lm.z() * scale.z };
+				}
+				IKSolver::CalculateBoneRotations(joints, count, chain_rotations);
+				for (int i = chain.has_base ? 1 : 0; i < count; ++i)
+				{
+					rotations[chain.indices[i]] = chain_rotations[i];
+				}
+			}
+			return ::mediapipe::OkStatus();
+		}
+
+		int m_JointCount = 0;
+		std::vector<ChainDefinition> m_Chains;
+	};
+
+	REGISTER_CALCULATOR(LandmarksToJointRotationsCalculator);
+}
@@ -0,0 +1,449 @@
+//!
+//! @brief - Per-model TFLite inference benchmark for the models the bundled modules run
+//!
+//! Loads each model on its own, without a graph, and runs it under every requested
+//! delegate and thread count, so a site can be sized from invoke times alone before the
+//! full pipeline is stood up. Inputs are filled with fixed-seed noise; the kernels do
+//! the same work whatever the pixels are.
+//!
+//! Reported per model, delegate and thread count: setup time split into reading the
+//! model file, building the interpreter, preparing the delegate (creation and
+//! ModifyGraphWithDelegate, which also does the first allocation of the tensors it
+//! leaves to TFLite) and AllocateTensors; the first invoke and the mean of the rest of the warm-up
+//! invokes, steady invoke latency percentiles over --runs, the span of the tensor arena
+//! and the resident memory that setup and warm-up added.
+//!
+//!   cpu      the op resolver as built (TFLite's default delegate applies when the build
+//!            sets tflite_with_xnnpack)
+//!   xnnpack  an explicit XNNPACK delegate with --threads threads
+//!   gpu      the OpenGL ES delegate, only in builds with MODEL_BENCHMARK_GPU (Linux)
+//!
+//! With a delegate the arena only holds the tensors the delegate left to TFLite; the
+//! delegate's own buffers show up in the resident memory column.
+//!
+//! Usage: model_benchmark [--models palm_detection,hand_landmark,...] [--model name=path]
+//!        [--delegates cpu,xnnpack] [--threads 1,2,4] [--warmup N] [--runs N] [--json]
+//!
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "mediapipe/util/tflite/cpu_op_resolver.h"
+#include "tensorflow/lite/delegates/xnnpack/xnnpack_delegate.h"
+#include "tensorflow/lite/interpreter.h"
+#include "tensorflow/lite/model.h"
+
+#if defined(MODEL_BENCHMARK_GPU)
+#include "tensorflow/lite/delegates/gpu/delegate.h"
+#endif
+
+#if defined(_WIN32)
+#include <Windows.h>
+#include <Psapi.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+	struct ModelEntry
+	{
+		std::string name;
+		std::string path;
+	};
+
+	// Paths as the modules export them, relative to the workspace root (bazel run's runfiles)
+	const ModelEntry kBundledModels[] = {
+		{ "palm_detection", "mediapipe/modules/palm_detection/palm_detection.tflite" },
+		{ "hand_landmark", "mediapipe/modules/hand_landmark/hand_landmark.tflite" },
+		{ "pose_detection", "mediapipe/modules/pose_detection/pose_detection.tflite" },
+		{ "pose_landmark", "mediapipe/modules/pose_landmark/pose_landmark_full.tflite" },
+		{ "face_detection", "mediapipe/modules/face_detection/face_detection_short_range.tflite" },
+		{ "face_landmark", "mediapipe/modules/face_landmark/face_landmark.tflite" },
+		{ "iris_landmark", "mediapipe/modules/iris_landmark/iris_landmark.tflite" },
+		{ "selfie_segmentation", "mediapipe/modules/selfie_segmentation/selfie_segmentation.tflite" },
+	};
+
+	struct Options
+	{
+		std::vector<ModelEntry> models;
+		std::vector<std::string> delegates = { "cpu", "xnnpack" };
+		std::vector<int> threads = { 1, 2, 4 };
+		int warmup = 10;
+		int runs = 100;
+		bool json = false;
+	};
+
+	struct RunResult
+	{
+		std::string model;
+		std::string delegate;
+		int threads = 0;
+		bool ok = false;
+		std::string error;
+		double file_ms = 0.0;
+		double build_ms = 0.0;
+		double delegate_ms = 0.0;
+		double allocate_ms = 0.0;
+		double first_invoke_ms = 0.0;
+		double warm_invoke_ms = 0.0;
+		std::vector<double> invoke_ms;
+		long long arena_bytes = 0;
+		long long persistent_bytes = 0;
+		long long resident_delta_bytes = 0;
+	};
+
+	// Owns whichever delegate a run created; the interpreter has to go first
+	struct DelegateHandle
+	{
+		TfLiteDelegate* delegate = nullptr;
+		void (*destroy)(TfLiteDelegate*) = nullptr;
+
+		~DelegateHandle()
+		{
+			if (delegate != nullptr && destroy != nullptr)
+				destroy(delegate);
+		}
+	};
+
+	long long NowNs()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	long long ResidentBytes()
+	{
+#if defined(_WIN32)
+		PROCESS_MEMORY_COUNTERS counters;
+		return GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) ? (long long)counters.WorkingSetSize : 0;
+#else
+		long long pages = 0;
+		long long resident = 0;
+		FILE* file = std::fopen("/proc/self/statm", "r");
+		if (file == nullptr)
+			return 0;
+		if (std::fscanf(file, "%lld %lld", &pages, &resident) != 2)
+			resident = 0;
+		std::fclose(file);
+		return resident * sysconf(_SC_PAGESIZE);
+#endif
+	}
+
+	double Percentile(std::vector<double> values, double p)
+	{
+		if (values.empty())
+			return 0.0;
+		std::sort(values.begin(), values.end());
+		const size_t index = std::min(values.size() - 1, (size_t)(p * (values.size() - 1) + 0.5));
+		return values[index];
+	}
+
+	std::vector<std::string> SplitList(const std::string& list)
+	{
+		std::vector<std::string> items;
+		std::stringstream stream(list);
+		for (std::string item; std::getline(stream, item, ',');)
+		{
+			if (!item.empty())
+				items.push_back(item);
+		}
+		return items;
+	}
+
+	// Fixed-seed noise in the value range of each input type
+	void FillInputs(tflite::Interpreter& interpreter)
+	{
+		std::mt19937 random(1234);
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+		for (int index : interpreter.inputs())
+		{
+			TfLiteTensor* tensor = interpreter.tensor(index);
+			if (tensor->type == kTfLiteFloat32)
+			{
+				float* data = interpreter.typed_tensor<float>(index);
+				for (size_t i = 0; i < tensor->bytes / sizeof(float); ++i)
+					data[i] = unit(random);
+			}
+			else if (tensor->data.raw != nullptr)
+			{
+				for (size_t i = 0; i < tensor->bytes; ++i)
+					tensor->data.raw[i] = (char)(random() & 0xff);
+			}
+		}
+	}
+
+	// Arena tensors all live in one buffer, so the span of their addresses is the arena in use
+	void MeasureArena(tflite::Interpreter& interpreter, RunResult& result)
+	{
+		uintptr_t arena_begin = UINTPTR_MAX;
+		uintptr_t arena_end = 0;
+		for (size_t i = 0; i < interpreter.tensors_size(); ++i)
+		{
+			const TfLiteTensor* tensor = interpreter.tensor((int)i);
+			if (tensor == nullptr || tensor->data.raw == nullptr || tensor->bytes == 0)
+				continue;
+			if (tensor->allocation_type == kTfLiteArenaRw)
+			{
+				const uintptr_t begin = (uintptr_t)tensor->data.raw;
+				arena_begin = std::min(arena_begin, begin);
+				arena_end = std::max(arena_end, begin + tensor->bytes);
+			}
+			else if (tensor->allocation_type == kTfLiteArenaRwPersistent)
+				result.persistent_bytes += (long long)tensor->bytes;
+		}
+		result.arena_bytes = arena_end > arena_begin ? (long long)(arena_end - arena_begin) : 0;
+	}
+
+	bool CreateDelegate(const std::string& name, int threads, DelegateHandle& handle, std::string& error)
+	{
+		if (name == "cpu")
+			return true;
+		if (name == "xnnpack")
+		{
+			TfLiteXNNPackDelegateOptions options = TfLiteXNNPackDelegateOptionsDefault();
+			options.num_threads = threads;
+			handle.delegate = TfLiteXNNPackDelegateCreate(&options);
+			handle.destroy = TfLiteXNNPackDelegateDelete;
+			return handle.delegate != nullptr;
+		}
+#if defined(MODEL_BENCHMARK_GPU)
+		if (name == "gpu")
+		{
+			TfLiteGpuDelegateOptionsV2 options = TfLiteGpuDelegateOptionsV2Default();
+			handle.delegate = TfLiteGpuDelegateV2Create(&options);
+			handle.destroy = TfLiteGpuDelegateV2Delete;
+			return handle.delegate != nullptr;
+		}
+#endif
+		error = "unknown delegate";
+		return false;
+	}
+
+	RunResult RunModel(const ModelEntry& model, const std::string& delegate_name, int threads, const Options& options)
+	{
+		RunResult result;
+		result.model = model.name;
+		result.delegate = delegate_name;
+		result.threads = threads;
+
+		const long long resident_before = ResidentBytes();
+		long long phase_start = NowNs();
+
+		std::unique_ptr<tflite::FlatBufferModel> flatbuffer = tflite::FlatBufferModel::BuildFromFile(model.path.c_str());
+		if (flatbuffer == nullptr)
+		{
+			result.error = "failed to load " + model.path;
+			return result;
+		}
+		result.file_ms = (NowNs() - phase_start) / 1e6;
+
+		// declared before the interpreter so it outlives it
+		DelegateHandle delegate;
+		phase_start = NowNs();
+		if (!CreateDelegate(delegate_name, threads, delegate, result.error))
+		{
+			if (result.error.empty())
+				result.error = "failed to create the " + delegate_name + " delegate";
+			return result;
+		}
+		result.delegate_ms = (NowNs() - phase_start) / 1e6;
+
+		phase_start = NowNs();
+		mediapipe::CpuOpResolver resolver;
+		std::unique_ptr<tflite::Interpreter> interpreter;
+		if (tflite::InterpreterBuilder(*flatbuffer, resolver)(&interpreter, threads) != kTfLiteOk || interpreter == nullptr)
+		{
+			result.error = "failed to build the interpreter";
+			return result;
+		}
+		result.build_ms = (NowNs() - phase_start) / 1e6;
+
+		phase_start = NowNs();
+		if (delegate.delegate != nullptr && interpreter->ModifyGraphWithDelegate(delegate.delegate) != kTfLiteOk)
+		{
+			result.error = "delegate rejected the graph";
+			return result;
+		}
+		result.delegate_ms += (NowNs() - phase_start) / 1e6;
+
+		phase_start = NowNs();
+		if (interpreter->AllocateTensors() != kTfLiteOk)
+		{
+			result.error = "AllocateTensors failed";
+			return result;
+		}
+		result.allocate_ms = (NowNs() - phase_start) / 1e6;
+
+		FillInputs(*interpreter);
+
+		// the first invoke pays for lazy packing and delegate compilation
+		long long t0 = NowNs();
+		if (interpreter->Invoke() != kTfLiteOk)
+		{
+			result.error = "Invoke failed";
+			return result;
+		}
+		result.first_invoke_ms = (NowNs() - t0) / 1e6;
+
+		double warm_ms = 0.0;
+		for (int i = 1; i < options.warmup; ++i)
+		{
+			t0 = NowNs();
+			interpreter->Invoke();
+			warm_ms += (NowNs() - t0) / 1e6;
+		}
+		result.warm_invoke_ms = options.warmup > 1 ? warm_ms / (options.warmup - 1) : result.first_invoke_ms;
+		result.resident_delta_bytes = ResidentBytes() - resident_before;
+
+		result.invoke_ms.reserve(options.runs);
+		for (int i = 0; i < options.runs; ++i)
+		{
+			t0 = NowNs();
+			interpreter->Invoke();
+			result.invoke_ms.push_back((NowNs() - t0) / 1e6);
+		}
+
+		MeasureArena(*interpreter, result);
+		result.ok = true;
+		return result;
+	}
+
+	void PrintResult(const RunResult& r, bool json, bool first)
+	{
+		if (json)
+		{
+			std::printf("%s\n    {\"model\": \"%s\", \"delegate\": \"%s\", \"threads\": %d, ", first ? "" : ",",
+				r.model.c_str(), r.delegate.c_str(), r.threads);
+			if (!r.ok)
+			{
+				std::printf("\"error\": \"%s\"}", r.error.c_str());
+				return;
+			}
+			std::printf("\"file_ms\": %.3f, \"build_ms\": %.3f, \"delegate_ms\": %.3f, \"allocate_ms\": %.3f, \"first_invoke_ms\": %.3f, \"warm_invoke_ms\": %.3f, "
+				"\"invoke_ms\": {\"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f}, "
+				"\"arena_bytes\": %lld, \"persistent_bytes\": %lld, \"resident_delta_bytes\": %lld}",
+				r.file_ms, r.build_ms, r.delegate_ms, r.allocate_ms, r.first_invoke_ms, r.warm_invoke_ms,
+				Percentile(r.invoke_ms, 0.5), Percentile(r.invoke_ms, 0.9), Percentile(r.invoke_ms, 0.99), Percentile(r.invoke_ms, 1.0),
+				r.arena_bytes, r.persistent_bytes, r.resident_delta_bytes);
+			return;
+		}
+		std::printf("%-20s%-9s%4d", r.model.c_str(), r.delegate.c_str(), r.threads);
+		if (!r.ok)
+		{
+			std::printf("  %s\n", r.error.c_str());
+			return;
+		}
+		std::printf("%8.1f%8.1f%8.1f%8.1f%10.2f%10.2f%10.2f%10.2f%10.2f%10.2f%10.2f\n", r.file_ms, r.build_ms, r.delegate_ms, r.allocate_ms, r.first_invoke_ms, r.warm_invoke_ms,
+			Percentile(r.invoke_ms, 0.5), Percentile(r.invoke_ms, 0.9), Percentile(r.invoke_ms, 0.99),
+			r.arena_bytes / (1024.0 * 1024.0), r.resident_delta_bytes / (1024.0 * 1024.0));
+	}
+
+	bool ParseOptions(int argc, char** argv, Options& options)
+	{
+		std::vector<std::string> names;
+		std::vector<ModelEntry> overrides;
+		for (int i = 1; i < argc; ++i)
+		{
+			const std::string arg = argv[i];
+			const bool has_value = i + 1 < argc;
+			if (arg == "--models" && has_value) names = SplitList(argv[++i]);
+			else if (arg == "--model" && has_value)
+			{
+				const std::string value = argv[++i];
+				const size_t equals = value.find('=');
+				if (equals == std::string::npos || equals == 0)
+					return false;
+				overrides.push_back({ value.substr(0, equals), value.substr(equals + 1) });
+			}
+			else if (arg == "--delegates" && has_value) options.delegates = SplitList(argv[++i]);
+			else if (arg == "--threads" && has_value)
+			{
+				options.threads.clear();
+				for (const std::string& count : SplitList(argv[++i]))
+					options.threads.push_back(std::max(1, std::atoi(count.c_str())));
+			}
+			else if (arg == "--warmup" && has_value) options.warmup = std::max(1, std::atoi(argv[++i]));
+			else if (arg == "--runs" && has_value) options.runs = std::max(1, std::atoi(argv[++i]));
+			else if (arg == "--json") options.json = true;
+			else
+				return false;
+		}
+
+		// --model replaces a bundled path or adds a model; --models picks and orders them
+		std::vector<ModelEntry> available(std::begin(kBundledModels), std::end(kBundledModels));
+		for (const ModelEntry& entry : overrides)
+		{
+			auto found = std::find_if(available.begin(), available.end(), [&](const ModelEntry& m) { return m.name == entry.name; });
+			if (found != available.end())
+				found->path = entry.path;
+			else
+				available.push_back(entry);
+		}
+		if (names.empty())
+		{
+			options.models = available;
+		}
+		else
+		{
+			for (const std::string& name : names)
+			{
+				auto found = std::find_if(available.begin(), available.end(), [&](const ModelEntry& m) { return m.name == name; });
+				if (found == available.end())
+				{
+					std::fprintf(stderr, "unknown model %s\n", name.c_str());
+					return false;
+				}
+				options.models.push_back(*found);
+			}
+		}
+		return !options.models.empty() && !options.delegates.empty() && !options.threads.empty();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	if (!ParseOptions(argc, argv, options))
+	{
+		std::printf("Usage: %s [--models name,...] [--model name=path] [--delegates cpu,xnnpack,gpu] [--threads 1,2,4]"
+			" [--warmup N] [--runs N] [--json]\n", argv[0]);
+		return 1;
+	}
+
+	if (options.json)
+		std::printf("{\n  \"warmup\": %d, \"runs\": %d,\n  \"results\": [", options.warmup, options.runs);
+	else
+		std::printf("%d warm-up invokes, %d timed\n%-20s%-9s%4s%8s%8s%8s%8s%10s%10s%10s%10s%10s%10s%10s\n", options.warmup, options.runs,
+			"model", "delegate", "thr", "file ms", "build", "deleg", "alloc", "first ms", "warm ms", "p50", "p90", "p99", "arena MB", "rss +MB");
+
+	bool first = true;
+	bool all_ok = true;
+	for (const ModelEntry& model : options.models)
+	{
+		for (const std::string& delegate : options.delegates)
+		{
+			// the gpu delegate picks its own parallelism, one row is enough
+			const std::vector<int> thread_counts = delegate == "gpu" ? std::vector<int>{ 1 } : options.threads;
+			for (int threads : thread_counts)
+			{
+				const RunResult result = RunModel(model, delegate, threads, options);
+				all_ok = all_ok && result.ok;
+				PrintResult(result, options.json, first);
+				first = false;
+			}
+		}
+	}
+
+	if (options.json)
+		std::printf("\n  ]\n}\n");
+	return all_ok ? 0 : 1;
+}
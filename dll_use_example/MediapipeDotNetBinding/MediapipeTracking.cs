@@ -0,0 +1,213 @@
+// .NET binding for the Mediapipe hand and holistic tracking DLLs
+//
+// Frames go to the DLL straight from the caller's memory (Span<byte>, byte[], or an
+// IntPtr from a NativeArray / Texture2D.GetRawTextureData), pinned only for the call.
+// Landmarks are delivered as ReadOnlySpan<PoseInfo> over the DLL's own buffer inside
+// the landmark callback, and copied into a preallocated buffer for reading afterwards,
+// so a frame costs no GC allocation and no marshaling.
+//
+// The DLLs keep their graph in globals, hence the static classes. Callbacks fire on the
+// thread that called DetectFrame, inside that call.
+//
+// Unity: put this file and the DLLs in Assets/Plugins and enable "Allow 'unsafe' code".
+// Other projects: see MediapipeTracking.csproj.
+
+using System;
+using System.Runtime.InteropServices;
+
+namespace Mediapipe.Tracking
+{
+    [StructLayout(LayoutKind.Sequential)]
+    public struct PoseInfo
+    {
+        public float X;
+        public float Y;
+    }
+
+    // int m_Gesture_Recognition_Result[2]; int m_HandUp_HandDown_Detect_Result[2]
+    [StructLayout(LayoutKind.Sequential)]
+    public struct GestureRecognitionResult
+    {
+        public int FirstGesture;
+        public int SecondGesture;
+        public int FirstHandUpHandDown;
+        public int SecondHandUpHandDown;
+
+        public int Gesture(int hand) => hand == 0 ? FirstGesture : SecondGesture;
+        public int HandUpHandDown(int hand) => hand == 0 ? FirstHandUpHandDown : SecondHandUpHandDown;
+    }
+
+    public delegate void LandmarksHandler(int imageIndex, ReadOnlySpan<PoseInfo> landmarks);
+    public delegate void GestureHandler(int imageIndex, ReadOnlySpan<int> gestures);
+
+    public static unsafe class MediapipeHandTracking
+    {
+        public const int HandKeypointCount = 21;
+        public const int MaxLandmarks = HandKeypointCount * 6;
+
+        const string DllName = "Mediapipe_Hand_Tracking";
+
+        [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+        delegate void NativeLandmarksCallBack(int imageIndex, PoseInfo* infos, int count);
+
+        [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+        delegate void NativeGestureResultCallBack(int imageIndex, int* recognResult, int count);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        static extern int Mediapipe_Hand_Tracking_Init([MarshalAs(UnmanagedType.LPStr)] string modelPath);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        static extern int Mediapipe_Hand_Tracking_Reigeter_Landmarks_Callback(NativeLandmarksCallBack func);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        static extern int Mediapipe_Hand_Tracking_Register_Gesture_Result_Callback(NativeGestureResultCallBack func);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        static extern int Mediapipe_Hand_Tracking_Detect_Frame(int imageIndex, int imageWidth, int imageHeight, void* imageData);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        static extern int Mediapipe_Hand_Tracking_Detect_Frame_Direct(int imageWidth, int imageHeight, void* imageData, GestureRecognitionResult* gestureResult);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        static extern int Mediapipe_Hand_Tracking_Release();
+
+        // kept in static fields so the GC never collects the thunks the DLL holds
+        static readonly NativeLandmarksCallBack s_LandmarksCallBack = OnLandmarks;
+        static readonly NativeGestureResultCallBack s_GestureResultCallBack = OnGestureResult;
+
+        static readonly PoseInfo[] s_Landmarks = new PoseInfo[MaxLandmarks];
+        static readonly int[] s_Gestures = { -1, -1 };
+        static int s_LandmarkCount;
+        static int s_LandmarkImageIndex = -1;
+
+        // Invoked inside DetectFrame; the span is the DLL's buffer and must not be kept
+        public static LandmarksHandler Landmarks;
+        public static GestureHandler Gestures;
+
+        public static bool Init(string modelPath)
+        {
+            if (Mediapipe_Hand_Tracking_Init(modelPath) == 0)
+            {
+                return false;
+            }
+            return Mediapipe_Hand_Tracking_Reigeter_Landmarks_Callback(s_LandmarksCallBack) != 0
+                && Mediapipe_Hand_Tracking_Register_Gesture_Result_Callback(s_GestureResultCallBack) != 0;
+        }
+
+        // bgr is densely packed width * height * 3 bytes
+        public static bool DetectFrame(int imageIndex, int width, int height, ReadOnlySpan<byte> bgr)
+        {
+            if (bgr.Length < width * height * 3)
+            {
+                throw new ArgumentException("frame is smaller than width * height * 3", nameof(bgr));
+            }
+            fixed (byte* pixels = bgr)
+            {
+                return DetectFrame(imageIndex, width, height, (IntPtr)pixels);
+            }
+        }
+
+        public static bool DetectFrame(int imageIndex, int width, int height, IntPtr bgr)
+        {
+            s_LandmarkCount = 0;
+            return Mediapipe_Hand_Tracking_Detect_Frame(imageIndex, width, height, (void*)bgr) != 0;
+        }
+
+        public static bool DetectFrameDirect(int width, int height, ReadOnlySpan<byte> bgr, out GestureRecognitionResult result)
+        {
+            if (bgr.Length < width * height * 3)
+            {
+                throw new ArgumentException("frame is smaller than width * height * 3", nameof(bgr));
+            }
+            result = new GestureRecognitionResult { FirstGesture = -1, SecondGesture = -1, FirstHandUpHandDown = -1, SecondHandUpHandDown = -1 };
+            fixed (byte* pixels = bgr)
+            fixed (GestureRecognitionResult* output = &result)
+            {
+                return Mediapipe_Hand_Tracking_Detect_Frame_Direct(width, height, pixels, output) != 0;
+            }
+        }
+
+        // Copy of the landmarks delivered during the last DetectFrame, empty if none were
+        public static ReadOnlySpan<PoseInfo> LatestLandmarks => new ReadOnlySpan<PoseInfo>(s_Landmarks, 0, s_LandmarkCount);
+        public static int LatestImageIndex => s_LandmarkImageIndex;
+        public static int LatestGesture(int hand) => s_Gestures[hand];
+
+        public static bool Release()
+        {
+            return Mediapipe_Hand_Tracking_Release() != 0;
+        }
+
+#if ENABLE_IL2CPP
+        [AOT.MonoPInvokeCallback(typeof(NativeLandmarksCallBack))]
+#endif
+        static void OnLandmarks(int imageIndex, PoseInfo* infos, int count)
+        {
+            int validCount = infos == null || count < 0 ? 0 : Math.Min(count, MaxLandmarks);
+            var landmarks = new ReadOnlySpan<PoseInfo>(infos, validCount);
+            landmarks.CopyTo(s_Landmarks);
+            s_LandmarkCount = validCount;
+            s_LandmarkImageIndex = imageIndex;
+            Landmarks?.Invoke(imageIndex, landmarks);
+        }
+
+#if ENABLE_IL2CPP
+        [AOT.MonoPInvokeCallback(typeof(NativeGestureResultCallBack))]
+#endif
+        static void OnGestureResult(int imageIndex, int* recognResult, int count)
+        {
+            var gestures = new ReadOnlySpan<int>(recognResult, recognResult == null || count < 0 ? 0 : count);
+            s_Gestures[0] = gestures.Length > 0 ? gestures[0] : -1;
+            s_Gestures[1] = gestures.Length > 1 ? gestures[1] : -1;
+            Gestures?.Invoke(imageIndex, gestures);
+        }
+    }
+
+    public static unsafe class MediapipeHolisticTracking
+    {
+        // left arm up/down, right arm up/down, left hand gesture, right hand gesture
+        public const int DetectResultCount = 4;
+
+        const string DllName = "MediapipeHolisticTracking";
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        static extern int MediapipeHolisticTrackingInit([MarshalAs(UnmanagedType.LPStr)] string modelPath,
+            [MarshalAs(UnmanagedType.U1)] bool isNeedVideoOutputStream, [MarshalAs(UnmanagedType.U1)] bool isNeedPoseOutputStream,
+            [MarshalAs(UnmanagedType.U1)] bool isNeedHandOutputStream, [MarshalAs(UnmanagedType.U1)] bool isNeedFaceOutputStream);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        static extern int MediapipeHolisticTrackingDetectFrameDirect(int imageWidth, int imageHeight, void* imageData, int* detectResult,
+            [MarshalAs(UnmanagedType.U1)] bool showResultImage);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        static extern int MediapipeHolisticTrackingRelease();
+
+        public static bool Init(string modelPath, bool video = true, bool pose = true, bool hand = true, bool face = true)
+        {
+            return MediapipeHolisticTrackingInit(modelPath, video, pose, hand, face) != 0;
+        }
+
+        // results receives DetectResultCount codes, -1 where unknown
+        public static bool DetectFrameDirect(int width, int height, ReadOnlySpan<byte> bgr, Span<int> results, bool showResultImage = false)
+        {
+            if (bgr.Length < width * height * 3)
+            {
+                throw new ArgumentException("frame is smaller than width * height * 3", nameof(bgr));
+            }
+            if (results.Length < DetectResultCount)
+            {
+                throw new ArgumentException("results needs room for 4 codes", nameof(results));
+            }
+            results.Slice(0, DetectResultCount).Fill(-1);
+            fixed (byte* pixels = bgr)
+            fixed (int* output = results)
+            {
+                return MediapipeHolisticTrackingDetectFrameDirect(width, height, pixels, output, showResultImage) != 0;
+            }
+        }
+
+        public static bool Release()
+        {
+            return MediapipeHolisticTrackingRelease() != 0;
+        }
+    }
+}
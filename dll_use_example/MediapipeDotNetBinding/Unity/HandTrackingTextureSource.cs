@@ -0,0 +1,158 @@
+// Unity component that feeds a camera texture to MediapipeHandTracking without stalling
+// the main thread.
+//
+// The texture is read back with AsyncGPUReadback, so the GPU copy completes a frame or
+// two later instead of blocking on ReadPixels. The readback is swizzled to the BGR,
+// top-down layout the DLL expects into a reused buffer, and detection runs on a worker
+// thread. Landmarks are published into a double buffer that the main thread reads
+// through TryGetLandmarks. At most one frame is in flight; frames arriving meanwhile
+// are not read back at all.
+//
+// Outside Unity the file compiles to nothing.
+
+#if UNITY_2018_2_OR_NEWER
+using System;
+using System.Threading;
+using Unity.Collections;
+using UnityEngine;
+using UnityEngine.Rendering;
+
+namespace Mediapipe.Tracking.Unity
+{
+    public sealed class HandTrackingTextureSource : MonoBehaviour
+    {
+        public Texture Source;
+        public string ModelPath = "hand_tracking_desktop_live.pbtxt";
+        // Unity textures are bottom-up; leave on unless Source is already flipped
+        public bool FlipVertically = true;
+
+        byte[] m_Frame;
+        int m_FrameWidth;
+        int m_FrameHeight;
+        int m_ImageIndex;
+
+        Thread m_Worker;
+        readonly AutoResetEvent m_FrameReady = new AutoResetEvent(false);
+        volatile bool m_IsRunning;
+        // a frame is being read back or detected
+        volatile bool m_IsBusy;
+
+        // written by the worker into the back buffer, swapped under the lock
+        readonly PoseInfo[][] m_Buffers = { new PoseInfo[MediapipeHandTracking.MaxLandmarks], new PoseInfo[MediapipeHandTracking.MaxLandmarks] };
+        readonly int[] m_Counts = new int[2];
+        readonly int[] m_ImageIndices = { -1, -1 };
+        int m_Front;
+        readonly object m_SwapLock = new object();
+        Action<AsyncGPUReadbackRequest> m_OnReadback;
+
+        void Start()
+        {
+            if (!MediapipeHandTracking.Init(ModelPath))
+            {
+                Debug.LogError("Mediapipe_Hand_Tracking_Init failed for " + ModelPath);
+                enabled = false;
+                return;
+            }
+            m_OnReadback = OnReadback;
+            m_IsRunning = true;
+            m_Worker = new Thread(WorkerLoop) { IsBackground = true, Name = "HandTracking" };
+            m_Worker.Start();
+        }
+
+        void Update()
+        {
+            if (Source == null || m_IsBusy || !SystemInfo.supportsAsyncGPUReadback)
+            {
+                return;
+            }
+            m_IsBusy = true;
+            AsyncGPUReadback.Request(Source, 0, TextureFormat.RGBA32, m_OnReadback);
+        }
+
+        void OnDestroy()
+        {
+            if (m_Worker == null)
+            {
+                return;
+            }
+            m_IsRunning = false;
+            m_FrameReady.Set();
+            m_Worker.Join();
+            m_Worker = null;
+            MediapipeHandTracking.Release();
+        }
+
+        // Copies the latest published landmarks; false until the first result
+        public bool TryGetLandmarks(Span<PoseInfo> destination, out int count, out int imageIndex)
+        {
+            lock (m_SwapLock)
+            {
+                count = Math.Min(m_Counts[m_Front], destination.Length);
+                imageIndex = m_ImageIndices[m_Front];
+                new ReadOnlySpan<PoseInfo>(m_Buffers[m_Front], 0, count).CopyTo(destination);
+            }
+            return imageIndex >= 0;
+        }
+
+        void OnReadback(AsyncGPUReadbackRequest request)
+        {
+            if (request.hasError || !m_IsRunning)
+            {
+                m_IsBusy = false;
+                return;
+            }
+
+            int width = request.width;
+            int height = request.height;
+            if (m_Frame == null || m_FrameWidth != width || m_FrameHeight != height)
+            {
+                m_Frame = new byte[width * height * 3];
+                m_FrameWidth = width;
+                m_FrameHeight = height;
+            }
+
+            // RGBA bottom-up -> BGR top-down in one pass
+            NativeArray<byte> rgba = request.GetData<byte>();
+            for (int y = 0; y < height; ++y)
+            {
+                int source = (FlipVertically ? height - 1 - y : y) * width * 4;
+                int target = y * width * 3;
+                for (int x = 0; x < width; ++x, source += 4, target += 3)
+                {
+                    m_Frame[target] = rgba[source + 2];
+                    m_Frame[target + 1] = rgba[source + 1];
+                    m_Frame[target + 2] = rgba[source];
+                }
+            }
+            m_FrameReady.Set();
+        }
+
+        void WorkerLoop()
+        {
+            while (true)
+            {
+                m_FrameReady.WaitOne();
+                if (!m_IsRunning)
+                {
+                    return;
+                }
+
+                int imageIndex = m_ImageIndex++;
+                if (MediapipeHandTracking.DetectFrame(imageIndex, m_FrameWidth, m_FrameHeight, m_Frame))
+                {
+                    ReadOnlySpan<PoseInfo> landmarks = MediapipeHandTracking.LatestLandmarks;
+                    int back = 1 - Volatile.Read(ref m_Front);
+                    landmarks.CopyTo(m_Buffers[back]);
+                    m_Counts[back] = landmarks.Length;
+                    m_ImageIndices[back] = imageIndex;
+                    lock (m_SwapLock)
+                    {
+                        m_Front = back;
+                    }
+                }
+                m_IsBusy = false;
+            }
+        }
+    }
+}
+#endif
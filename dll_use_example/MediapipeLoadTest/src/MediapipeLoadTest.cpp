@@ -0,0 +1,580 @@
+//!
+//! @brief - Capacity test: many simulated cameras on one MediapipeMultiCameraScheduler
+//!
+//! Decodes a clip into memory (or builds synthetic frames), then runs one step per
+//! entry of --cameras. In a step every camera gets its own producer thread that replays
+//! the clip at --fps from its own starting frame, the way a camera thread would call
+//! SubmitFrame, while the workers given by --dll (one copy of the DLL file each, see
+//! MediapipeMultiCameraScheduler.h) serve them. The first --warmup seconds of a step are
+//! not measured; after --seconds the producers stop and the frames still queued are
+//! drained before the step is scored.
+//!
+//! Each step prints the submit-to-result latency percentiles over all cameras and of
+//! the worst camera, the delivered fps, the share of offered frames that produced no
+//! result (dropped by the scheduler as stale or replaced, or a tick the producer missed
+//! because it could not keep its schedule), and the process CPU time per camera in % of
+//! one core. CPU time covers the whole process, so it includes the producers' frame
+//! copies, as a capture thread's would be on a real server.
+//!
+//! A step is sustained when at most --max-drop of the frames were dropped and the worst
+//! camera's p99 latency is within --max-p99-ms (default: the deadline). The summary names
+//! the largest sustained camera count before the first step that was not: the number
+//! of cameras this machine and worker count can take at this fps.
+//!
+//! --per-camera adds a line per camera to each step; --report writes the step rows as
+//! tab-separated text.
+//!
+//! Build together with ../../MediapipePackageDllTest/src/DynamicModuleLoader.cpp,
+//! MediapipeHandTrackingDll.cpp and MediapipeMultiCameraScheduler.cpp, with that
+//! directory on the include path, and link OpenCV.
+//!
+//! Usage: MediapipeLoadTest <model_path> <clip | synthetic:WxH> --dll path [--dll path ...]
+//!        [--fps 30] [--deadline-ms 100] [--cameras 1,2,4,8,12,16] [--seconds 10]
+//!        [--warmup 2] [--max-frames 300] [--max-drop 0.05] [--max-p99-ms ms]
+//!        [--per-camera] [--report out.tsv]
+//!
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "MediapipeMultiCameraScheduler.h"
+
+#if defined(WINDOWS)
+#include <Windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+	const int kDrainTimeoutMs = 5000;
+
+	struct LoadTestOptions
+	{
+		std::string m_Model_Path;
+		std::string m_Clip;
+		std::vector<std::string> m_Dll_Paths;
+		std::vector<int> m_Camera_Counts;
+		double m_Fps = 30.0;
+		int m_Deadline_Ms = 100;
+		double m_Seconds = 10.0;
+		double m_Warmup_Seconds = 2.0;
+		int m_Max_Frames = 300;
+		double m_Max_Drop = 0.05;
+		double m_Max_P99_Ms = -1.0;		// -1 for the deadline
+		bool m_Is_Per_Camera = false;
+		std::string m_Report_Path;
+	};
+
+	// written by the producer and the worker callbacks of one camera during a step
+	struct SimulatedCamera
+	{
+		int m_Camera_Id = -1;
+		std::thread m_Producer;
+		std::atomic<unsigned long long> m_Submitted{ 0 };
+		std::atomic<unsigned long long> m_Late_Ticks{ 0 };
+		std::mutex m_Mutex;
+		std::vector<double> m_Latencies;
+	};
+
+	struct CameraRow
+	{
+		int m_Camera_Id = -1;
+		unsigned long long m_Submitted = 0;
+		unsigned long long m_Processed = 0;
+		unsigned long long m_Dropped = 0;
+		double m_Fps = 0.0;
+		double m_Latency_P50_Ms = 0.0;
+		double m_Latency_P99_Ms = 0.0;
+	};
+
+	struct StepRow
+	{
+		int m_Cameras = 0;
+		double m_Offered_Fps = 0.0;
+		double m_Delivered_Fps = 0.0;
+		double m_Latency_P50_Ms = 0.0;
+		double m_Latency_P90_Ms = 0.0;
+		double m_Latency_P99_Ms = 0.0;
+		double m_Worst_Camera_P99_Ms = 0.0;
+		double m_Drop_Rate = 0.0;
+		unsigned long long m_Dropped_Stale = 0;
+		unsigned long long m_Dropped_Replaced = 0;
+		unsigned long long m_Late_Ticks = 0;
+		double m_Cpu_Per_Camera = 0.0;		// % of one core
+		bool m_Is_Sustained = false;
+		std::vector<CameraRow> m_Camera_Rows;
+	};
+
+	std::vector<std::unique_ptr<SimulatedCamera>> g_Cameras;
+	std::atomic<bool> g_IsMeasuring(false);
+	std::atomic<bool> g_IsProducing(false);
+
+	void OnCameraResult(const CameraFrameResult& result)
+	{
+		if (!g_IsMeasuring.load() || result.m_Camera_Id < 0 || result.m_Camera_Id >= (int)g_Cameras.size())
+		{
+			return;
+		}
+		SimulatedCamera& camera = *g_Cameras[result.m_Camera_Id];
+		std::lock_guard<std::mutex> lock(camera.m_Mutex);
+		camera.m_Latencies.push_back(result.m_Latency_Ms);
+	}
+
+	double ProcessCpuSeconds()
+	{
+#if defined(WINDOWS)
+		FILETIME creationTime, exitTime, kernelTime, userTime;
+		if (!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime))
+		{
+			return 0.0;
+		}
+		ULARGE_INTEGER kernel, user;
+		kernel.LowPart = kernelTime.dwLowDateTime;
+		kernel.HighPart = kernelTime.dwHighDateTime;
+		user.LowPart = userTime.dwLowDateTime;
+		user.HighPart = userTime.dwHighDateTime;
+		return (double)(kernel.QuadPart + user.QuadPart) * 1e-7;
+#else
+		rusage usage;
+		getrusage(RUSAGE_SELF, &usage);
+		return (double)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) + (double)(usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+#endif
+	}
+
+	double Percentile(const std::vector<double>& sorted, double fraction)
+	{
+		if (sorted.empty())
+		{
+			return 0.0;
+		}
+		size_t index = (size_t)(fraction * (double)(sorted.size() - 1) + 0.5);
+		return sorted[index < sorted.size() ? index : sorted.size() - 1];
+	}
+
+	bool ParseCameraCounts(const char* text, std::vector<int>& counts)
+	{
+		counts.clear();
+		std::istringstream fields(text);
+		std::string field;
+		while (std::getline(fields, field, ','))
+		{
+			int count = atoi(field.c_str());
+			if (count <= 0)
+			{
+				return false;
+			}
+			counts.push_back(count);
+		}
+		std::sort(counts.begin(), counts.end());
+		counts.erase(std::unique(counts.begin(), counts.end()), counts.end());
+		return !counts.empty();
+	}
+
+	// Decodes up to max_frames so the producers only copy from memory
+	bool LoadFrames(const LoadTestOptions& options, std::vector<cv::Mat>& frames)
+	{
+		frames.clear();
+		int width = 0;
+		int height = 0;
+		if (sscanf(options.m_Clip.c_str(), "synthetic:%dx%d", &width, &height) == 2)
+		{
+			if (width <= 0 || height <= 0)
+			{
+				return false;
+			}
+			// a bright square moving over a gradient, the same on every run
+			int count = std::min(options.m_Max_Frames, 60);
+			for (int i = 0; i < count; ++i)
+			{
+				cv::Mat frame(height, width, CV_8UC3);
+				for (int y = 0; y < height; ++y)
+				{
+					frame.row(y).setTo(cv::Scalar(y * 255 / height, 96, 255 - y * 255 / height));
+				}
+				int side = std::max(8, std::min(width, height) / 4);
+				int x = (width - side) * i / std::max(1, count - 1);
+				cv::rectangle(frame, cv::Rect(x, (height - side) / 2, side, side), cv::Scalar(220, 220, 220), cv::FILLED);
+				frames.push_back(frame);
+			}
+			return true;
+		}
+
+		cv::VideoCapture capture(options.m_Clip);
+		if (!capture.isOpened())
+		{
+			printf("Failed to open clip %s\n", options.m_Clip.c_str());
+			return false;
+		}
+		cv::Mat frame;
+		while ((int)frames.size() < options.m_Max_Frames && capture.read(frame) && !frame.empty())
+		{
+			// a fresh buffer per frame, and continuous for SubmitFrame
+			frames.push_back(frame.clone());
+		}
+		return !frames.empty();
+	}
+
+	// Replays the frames on a fixed schedule; a tick that is already a full period late is
+	// skipped and counted instead of being submitted in a burst
+	void RunProducer(MediapipeMultiCameraScheduler& scheduler, SimulatedCamera& camera, const std::vector<cv::Mat>& frames, double fps, size_t first_frame)
+	{
+		typedef std::chrono::steady_clock Clock;
+		const Clock::duration period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / fps));
+		Clock::time_point next = Clock::now();
+		size_t frameIndex = first_frame;
+		int imageIndex = 0;
+		while (g_IsProducing.load())
+		{
+			std::this_thread::sleep_until(next);
+			Clock::time_point now = Clock::now();
+			if (now - next >= period)
+			{
+				camera.m_Late_Ticks.fetch_add(1);
+			}
+			else
+			{
+				const cv::Mat& frame = frames[frameIndex];
+				if (scheduler.SubmitFrame(camera.m_Camera_Id, imageIndex++, frame.cols, frame.rows, frame.data, (int)frame.step))
+				{
+					camera.m_Submitted.fetch_add(1);
+				}
+			}
+			frameIndex = (frameIndex + 1) % frames.size();
+			next += period;
+		}
+	}
+
+	// Waits until every frame submitted to the cameras was processed or dropped
+	bool DrainCameras(MediapipeMultiCameraScheduler& scheduler, int camera_count)
+	{
+		auto start = std::chrono::steady_clock::now();
+		while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(kDrainTimeoutMs))
+		{
+			bool isDrained = true;
+			for (int i = 0; i < camera_count && isDrained; ++i)
+			{
+				CameraStats stats = scheduler.GetCameraStats(g_Cameras[i]->m_Camera_Id);
+				isDrained = stats.m_Processed + stats.m_Dropped_Stale + stats.m_Dropped_Replaced >= g_Cameras[i]->m_Submitted.load();
+			}
+			if (isDrained)
+			{
+				return true;
+			}
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+		}
+		return false;
+	}
+
+	bool RunStep(MediapipeMultiCameraScheduler& scheduler, const LoadTestOptions& options, const std::vector<cv::Mat>& frames, int camera_count, StepRow& row)
+	{
+		row = StepRow();
+		row.m_Cameras = camera_count;
+		row.m_Offered_Fps = options.m_Fps * (double)camera_count;
+
+		while ((int)g_Cameras.size() < camera_count)
+		{
+			// the callback indexes g_Cameras, which is only resized between steps
+			std::unique_ptr<SimulatedCamera> camera(new SimulatedCamera());
+			camera->m_Camera_Id = scheduler.AddCamera(options.m_Deadline_Ms);
+			g_Cameras.push_back(std::move(camera));
+		}
+		for (int i = 0; i < camera_count; ++i)
+		{
+			SimulatedCamera& camera = *g_Cameras[i];
+			camera.m_Submitted.store(0);
+			camera.m_Late_Ticks.store(0);
+			std::lock_guard<std::mutex> lock(camera.m_Mutex);
+			camera.m_Latencies.clear();
+		}
+
+		g_IsProducing.store(true);
+		for (int i = 0; i < camera_count; ++i)
+		{
+			// spread the cameras over the clip so they do not all show the same frame
+			size_t firstFrame = (size_t)i * frames.size() / (size_t)camera_count;
+			g_Cameras[i]->m_Producer = std::thread(RunProducer, std::ref(scheduler), std::ref(*g_Cameras[i]), std::cref(frames), options.m_Fps, firstFrame);
+		}
+
+		std::this_thread::sleep_for(std::chrono::duration<double>(options.m_Warmup_Seconds));
+		// counts restart with the measured window
+		std::vector<CameraStats> baseline(camera_count);
+		std::vector<unsigned long long> submittedBefore(camera_count);
+		std::vector<unsigned long long> lateBefore(camera_count);
+		for (int i = 0; i < camera_count; ++i)
+		{
+			baseline[i] = scheduler.GetCameraStats(g_Cameras[i]->m_Camera_Id);
+			submittedBefore[i] = g_Cameras[i]->m_Submitted.load();
+			lateBefore[i] = g_Cameras[i]->m_Late_Ticks.load();
+		}
+		double cpuStart = ProcessCpuSeconds();
+		auto wallStart = std::chrono::steady_clock::now();
+		g_IsMeasuring.store(true);
+
+		std::this_thread::sleep_for(std::chrono::duration<double>(options.m_Seconds));
+
+		g_IsProducing.store(false);
+		for (int i = 0; i < camera_count; ++i)
+		{
+			g_Cameras[i]->m_Producer.join();
+		}
+		double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+		double cpuSeconds = ProcessCpuSeconds() - cpuStart;
+		bool isDrained = DrainCameras(scheduler, camera_count);
+		g_IsMeasuring.store(false);
+		if (!isDrained)
+		{
+			printf("%d cameras: frames still queued %d ms after the producers stopped\n", camera_count, kDrainTimeoutMs);
+		}
+
+		std::vector<double> allLatencies;
+		unsigned long long submitted = 0;
+		unsigned long long processed = 0;
+		for (int i = 0; i < camera_count; ++i)
+		{
+			SimulatedCamera& camera = *g_Cameras[i];
+			CameraStats stats = scheduler.GetCameraStats(camera.m_Camera_Id);
+			CameraRow cameraRow;
+			cameraRow.m_Camera_Id = camera.m_Camera_Id;
+			cameraRow.m_Submitted = camera.m_Submitted.load() - submittedBefore[i];
+			cameraRow.m_Processed = stats.m_Processed - baseline[i].m_Processed;
+			unsigned long long stale = stats.m_Dropped_Stale - baseline[i].m_Dropped_Stale;
+			unsigned long long replaced = stats.m_Dropped_Replaced - baseline[i].m_Dropped_Replaced;
+			cameraRow.m_Dropped = stale + replaced;
+			cameraRow.m_Fps = wallSeconds > 0.0 ? (double)cameraRow.m_Processed / wallSeconds : 0.0;
+
+			std::vector<double> latencies;
+			{
+				std::lock_guard<std::mutex> lock(camera.m_Mutex);
+				latencies.swap(camera.m_Latencies);
+			}
+			std::sort(latencies.begin(), latencies.end());
+			cameraRow.m_Latency_P50_Ms = Percentile(latencies, 0.50);
+			cameraRow.m_Latency_P99_Ms = Percentile(latencies, 0.99);
+			allLatencies.insert(allLatencies.end(), latencies.begin(), latencies.end());
+
+			row.m_Dropped_Stale += stale;
+			row.m_Dropped_Replaced += replaced;
+			row.m_Late_Ticks += camera.m_Late_Ticks.load() - lateBefore[i];
+			row.m_Worst_Camera_P99_Ms = std::max(row.m_Worst_Camera_P99_Ms, cameraRow.m_Latency_P99_Ms);
+			submitted += cameraRow.m_Submitted;
+			processed += cameraRow.m_Processed;
+			row.m_Camera_Rows.push_back(cameraRow);
+		}
+
+		std::sort(allLatencies.begin(), allLatencies.end());
+		row.m_Latency_P50_Ms = Percentile(allLatencies, 0.50);
+		row.m_Latency_P90_Ms = Percentile(allLatencies, 0.90);
+		row.m_Latency_P99_Ms = Percentile(allLatencies, 0.99);
+		row.m_Delivered_Fps = wallSeconds > 0.0 ? (double)processed / wallSeconds : 0.0;
+		// ticks the producers missed were frames the cameras offered and nobody took
+		unsigned long long offered = submitted + row.m_Late_Ticks;
+		row.m_Drop_Rate = offered > 0 ? (double)(row.m_Dropped_Stale + row.m_Dropped_Replaced + row.m_Late_Ticks) / (double)offered : 0.0;
+		row.m_Cpu_Per_Camera = wallSeconds > 0.0 ? cpuSeconds / wallSeconds / (double)camera_count * 100.0 : 0.0;
+
+		double maxP99Ms = options.m_Max_P99_Ms >= 0.0 ? options.m_Max_P99_Ms : (double)options.m_Deadline_Ms;
+		row.m_Is_Sustained = isDrained && processed > 0 && row.m_Drop_Rate <= options.m_Max_Drop && row.m_Worst_Camera_P99_Ms <= maxP99Ms;
+		return isDrained;
+	}
+
+	void PrintStepHeader()
+	{
+		printf("%8s %9s %9s %8s %8s %8s %9s %7s %8s %8s %6s %9s %s\n", "cameras", "offered", "fps", "p50 ms", "p90 ms", "p99 ms", "worst 99", "drop %", "stale", "replaced", "late", "cpu/cam %", "");
+	}
+
+	void PrintStep(const StepRow& row, bool is_per_camera)
+	{
+		printf("%8d %9.1f %9.1f %8.2f %8.2f %8.2f %9.2f %7.2f %8llu %8llu %6llu %9.1f %s\n", row.m_Cameras, row.m_Offered_Fps, row.m_Delivered_Fps,
+			row.m_Latency_P50_Ms, row.m_Latency_P90_Ms, row.m_Latency_P99_Ms, row.m_Worst_Camera_P99_Ms, row.m_Drop_Rate * 100.0,
+			row.m_Dropped_Stale, row.m_Dropped_Replaced, row.m_Late_Ticks, row.m_Cpu_Per_Camera, row.m_Is_Sustained ? "ok" : "SATURATED");
+		if (!is_per_camera)
+		{
+			return;
+		}
+		for (const CameraRow& camera : row.m_Camera_Rows)
+		{
+			printf("%8s camera %d: %llu submitted, %llu processed, %llu dropped, %.1f fps, p50 %.2f ms, p99 %.2f ms\n", "", camera.m_Camera_Id,
+				camera.m_Submitted, camera.m_Processed, camera.m_Dropped, camera.m_Fps, camera.m_Latency_P50_Ms, camera.m_Latency_P99_Ms);
+		}
+	}
+
+	bool WriteReport(const std::string& path, const LoadTestOptions& options, const std::vector<StepRow>& rows)
+	{
+		FILE* file = fopen(path.c_str(), "w");
+		if (file == nullptr)
+		{
+			printf("Failed to write %s\n", path.c_str());
+			return false;
+		}
+		fprintf(file, "# workers\t%d\tfps\t%.3f\tdeadline_ms\t%d\n", (int)options.m_Dll_Paths.size(), options.m_Fps, options.m_Deadline_Ms);
+		fprintf(file, "cameras\toffered_fps\tdelivered_fps\tp50_ms\tp90_ms\tp99_ms\tworst_camera_p99_ms\tdrop_rate\tdropped_stale\tdropped_replaced\tlate_ticks\tcpu_per_camera\tsustained\n");
+		for (const StepRow& row : rows)
+		{
+			fprintf(file, "%d\t%.3f\t%.3f\t%.4f\t%.4f\t%.4f\t%.4f\t%.5f\t%llu\t%llu\t%llu\t%.3f\t%d\n", row.m_Cameras, row.m_Offered_Fps, row.m_Delivered_Fps,
+				row.m_Latency_P50_Ms, row.m_Latency_P90_Ms, row.m_Latency_P99_Ms, row.m_Worst_Camera_P99_Ms, row.m_Drop_Rate,
+				row.m_Dropped_Stale, row.m_Dropped_Replaced, row.m_Late_Ticks, row.m_Cpu_Per_Camera, row.m_Is_Sustained ? 1 : 0);
+		}
+		fclose(file);
+		return true;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 3)
+	{
+		printf("Usage: MediapipeLoadTest <model_path> <clip | synthetic:WxH> --dll path [--dll path ...] [--fps 30] [--deadline-ms 100] [--cameras 1,2,4,8,12,16] [--seconds 10] [--warmup 2] [--max-frames 300] [--max-drop 0.05] [--max-p99-ms ms] [--per-camera] [--report out.tsv]\n");
+		return 2;
+	}
+
+	LoadTestOptions options;
+	options.m_Model_Path = argv[1];
+	options.m_Clip = argv[2];
+	ParseCameraCounts("1,2,4,8,12,16", options.m_Camera_Counts);
+	for (int i = 3; i < argc; ++i)
+	{
+		if (strcmp(argv[i], "--per-camera") == 0)
+		{
+			options.m_Is_Per_Camera = true;
+			continue;
+		}
+		if (i + 1 >= argc)
+		{
+			printf("Option %s needs a value\n", argv[i]);
+			return 2;
+		}
+		const char* value = argv[++i];
+		if (strcmp(argv[i - 1], "--dll") == 0)
+		{
+			options.m_Dll_Paths.push_back(value);
+		}
+		else if (strcmp(argv[i - 1], "--fps") == 0)
+		{
+			options.m_Fps = atof(value);
+		}
+		else if (strcmp(argv[i - 1], "--deadline-ms") == 0)
+		{
+			options.m_Deadline_Ms = atoi(value);
+		}
+		else if (strcmp(argv[i - 1], "--cameras") == 0)
+		{
+			if (!ParseCameraCounts(value, options.m_Camera_Counts))
+			{
+				printf("--cameras takes a list of positive counts, e.g. 1,2,4,8\n");
+				return 2;
+			}
+		}
+		else if (strcmp(argv[i - 1], "--seconds") == 0)
+		{
+			options.m_Seconds = atof(value);
+		}
+		else if (strcmp(argv[i - 1], "--warmup") == 0)
+		{
+			options.m_Warmup_Seconds = atof(value);
+		}
+		else if (strcmp(argv[i - 1], "--max-frames") == 0)
+		{
+			options.m_Max_Frames = atoi(value);
+		}
+		else if (strcmp(argv[i - 1], "--max-drop") == 0)
+		{
+			options.m_Max_Drop = atof(value);
+		}
+		else if (strcmp(argv[i - 1], "--max-p99-ms") == 0)
+		{
+			options.m_Max_P99_Ms = atof(value);
+		}
+		else if (strcmp(argv[i - 1], "--report") == 0)
+		{
+			options.m_Report_Path = value;
+		}
+		else
+		{
+			printf("Unknown option %s\n", argv[i - 1]);
+			return 2;
+		}
+	}
+	if (options.m_Dll_Paths.empty() || (int)options.m_Dll_Paths.size() > MULTI_CAMERA_SCHEDULER_MAX_WORKERS)
+	{
+		printf("Give between 1 and %d --dll paths, one copy of the DLL per worker\n", MULTI_CAMERA_SCHEDULER_MAX_WORKERS);
+		return 2;
+	}
+	if (options.m_Fps <= 0.0 || options.m_Seconds <= 0.0 || options.m_Warmup_Seconds < 0.0 || options.m_Max_Frames <= 0 || options.m_Deadline_Ms <= 0)
+	{
+		printf("--fps, --seconds, --max-frames and --deadline-ms must be positive, --warmup not negative\n");
+		return 2;
+	}
+
+	std::vector<cv::Mat> frames;
+	if (!LoadFrames(options, frames))
+	{
+		printf("No frames from %s\n", options.m_Clip.c_str());
+		return 2;
+	}
+
+	MediapipeMultiCameraScheduler scheduler;
+	if (!scheduler.Start(options.m_Dll_Paths, options.m_Model_Path, OnCameraResult))
+	{
+		printf("Failed to start %d workers with %s\n", (int)options.m_Dll_Paths.size(), options.m_Model_Path.c_str());
+		return 1;
+	}
+
+	printf("%d workers, %d frames of %dx%d at %.1f fps per camera, deadline %d ms, %.1f s per step after %.1f s warm-up, %u hardware threads\n",
+		scheduler.GetWorkerCount(), (int)frames.size(), frames[0].cols, frames[0].rows, options.m_Fps, options.m_Deadline_Ms,
+		options.m_Seconds, options.m_Warmup_Seconds, std::thread::hardware_concurrency());
+	PrintStepHeader();
+
+	std::vector<StepRow> rows;
+	int sustainedCameras = 0;
+	int saturatedCameras = 0;
+	for (int cameraCount : options.m_Camera_Counts)
+	{
+		StepRow row;
+		RunStep(scheduler, options, frames, cameraCount, row);
+		PrintStep(row, options.m_Is_Per_Camera);
+		rows.push_back(row);
+		if (saturatedCameras == 0)
+		{
+			if (row.m_Is_Sustained)
+			{
+				sustainedCameras = cameraCount;
+			}
+			else
+			{
+				saturatedCameras = cameraCount;
+			}
+		}
+	}
+	scheduler.Stop();
+
+	if (saturatedCameras == 0)
+	{
+		printf("Sustained all %d cameras; raise --cameras to find the saturation point\n", sustainedCameras);
+	}
+	else if (sustainedCameras == 0)
+	{
+		printf("Saturated already at %d cameras\n", saturatedCameras);
+	}
+	else
+	{
+		printf("Sustains %d cameras at %.1f fps; saturated at %d\n", sustainedCameras, options.m_Fps, saturatedCameras);
+	}
+
+	if (!options.m_Report_Path.empty() && !WriteReport(options.m_Report_Path, options, rows))
+	{
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,88 @@
+/**
+ * Readers for the shared landmark arrays written by the hand tracking addon
+ *
+ * Kept free of the native addon so worker threads can require it with only the
+ * two SharedArrayBuffers posted to them.
+ */
+
+const CONTROL_SEQUENCE = 0;
+const CONTROL_IMAGE_INDEX = 1;
+const CONTROL_LANDMARK_COUNT = 2;
+const CONTROL_GESTURE_FIRST = 3;
+const CONTROL_GESTURE_SECOND = 4;
+const CONTROL_RESULT_COUNT = 5;
+
+const LANDMARKS_PER_HAND = 21;
+const MAX_HANDS = 6;                // MAX_HAND_COUNT in MediapipeHandTrackingDll.h
+
+/**
+ * Reads one consistent result from the shared arrays
+ *
+ * Usable from any thread holding the two views. Retries while the native side is
+ * writing; returns false only if a consistent copy could not be taken in maxRetries.
+ *
+ * @param {Int32Array} control - Control view created by HandTracker
+ * @param {Float32Array} landmarks - Landmark view created by HandTracker
+ * @param {Object} out - Receives imageIndex, count, gestures, sequence
+ * @param {Float32Array} target - Receives count * 2 floats
+ * @param {number} maxRetries - Attempts before giving up
+ * @returns {boolean} True when out and target hold a consistent result
+ */
+function readSharedLandmarks(control, landmarks, out, target, maxRetries = 64) {
+    for (let attempt = 0; attempt < maxRetries; attempt++) {
+        const before = Atomics.load(control, CONTROL_SEQUENCE);
+        if (before & 1) {
+            continue;
+        }
+        const count = Math.min(Atomics.load(control, CONTROL_LANDMARK_COUNT), target.length >> 1);
+        target.set(landmarks.subarray(0, count * 2));
+        out.imageIndex = Atomics.load(control, CONTROL_IMAGE_INDEX);
+        out.gestures[0] = Atomics.load(control, CONTROL_GESTURE_FIRST);
+        out.gestures[1] = Atomics.load(control, CONTROL_GESTURE_SECOND);
+        if (Atomics.load(control, CONTROL_SEQUENCE) === before) {
+            out.count = count;
+            out.sequence = before;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Blocks the calling worker thread until a result newer than lastSequence is published
+ *
+ * Atomics.wait is not allowed on the main thread; use the onFrame callback there.
+ *
+ * @param {Int32Array} control - Control view created by HandTracker
+ * @param {number} lastSequence - Sequence of the last result the caller read
+ * @param {number} timeoutMs - Maximum wait
+ * @returns {boolean} True when a newer result is available
+ */
+function waitForSharedFrame(control, lastSequence, timeoutMs = Infinity) {
+    const deadline = Date.now() + timeoutMs;
+    for (;;) {
+        const sequence = Atomics.load(control, CONTROL_SEQUENCE);
+        if (sequence !== lastSequence && !(sequence & 1)) {
+            return true;
+        }
+        const remaining = deadline - Date.now();
+        if (remaining <= 0) {
+            return false;
+        }
+        // woken by the notify in HandTracker's frame callback; a missed notify only costs the timeout slice
+        Atomics.wait(control, CONTROL_SEQUENCE, sequence, Math.min(remaining, 100));
+    }
+}
+
+module.exports = {
+    readSharedLandmarks,
+    waitForSharedFrame,
+    CONTROL_SEQUENCE,
+    CONTROL_IMAGE_INDEX,
+    CONTROL_LANDMARK_COUNT,
+    CONTROL_GESTURE_FIRST,
+    CONTROL_GESTURE_SECOND,
+    CONTROL_RESULT_COUNT,
+    LANDMARKS_PER_HAND,
+    MAX_HANDS
+};
@@ -0,0 +1,30 @@
+{
+  "targets": [
+    {
+      "target_name": "mediapipe_hand_tracking",
+      "sources": [
+        "src/MediapipeHandTrackingAddon.cpp",
+        "../MediapipePackageDllTest/src/DynamicModuleLoader.cpp",
+        "../MediapipePackageDllTest/src/MediapipeHandTrackingDll.cpp",
+        "../MediapipePackageDllTest/src/MediapipeHandTrackingAsync.cpp",
+        "../MediapipePackageDllTest/src/YuvFrameConversion.cpp",
+        "../MediapipePackageDllTest/src/FrameOrientation.cpp",
+        "../MediapipePackageDllTest/src/TrackerMetrics.cpp"
+      ],
+      "include_dirs": [
+        "../MediapipePackageDllTest/src"
+      ],
+      "cflags_cc": [ "-std=c++14", "-fexceptions" ],
+      "conditions": [
+        [ "OS=='win'", {
+          "msvs_settings": {
+            "VCCLCompilerTool": { "ExceptionHandling": 1 }
+          }
+        } ],
+        [ "OS=='linux'", {
+          "libraries": [ "-ldl", "-lpthread" ]
+        } ]
+      ]
+    }
+  ]
+}
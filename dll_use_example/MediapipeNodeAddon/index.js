@@ -0,0 +1,116 @@
+/**
+ * Node.js front end for the MediaPipe hand tracking DLL
+ *
+ * Wraps the native addon (src/MediapipeHandTrackingAddon.cpp). Landmarks land in a
+ * SharedArrayBuffer that can be posted to worker threads once; every reader then sees
+ * each new result in place, guarded by the sequence number in the control array.
+ *
+ * Usage:
+ *   const { HandTracker } = require('./index');
+ *   const tracker = new HandTracker();
+ *   tracker.open('MediapipeHandTracking.dll', 'hand_tracking_desktop_live.pbtxt', () => {
+ *       const frame = tracker.readLandmarks();
+ *       // frame.landmarks is a Float32Array of x, y pairs, 21 per hand
+ *   });
+ *   tracker.submitFrame(index, width, height, bgrBuffer);
+ *
+ * Worker threads get tracker.controlBuffer and tracker.landmarkBuffer and use
+ * waitForSharedFrame / readSharedLandmarks from SharedLandmarks.js.
+ */
+
+const addon = require('./build/Release/mediapipe_hand_tracking.node');
+
+const {
+    readSharedLandmarks,
+    waitForSharedFrame,
+    CONTROL_SEQUENCE,
+    CONTROL_RESULT_COUNT,
+    LANDMARKS_PER_HAND,
+    MAX_HANDS
+} = require('./SharedLandmarks');
+
+class HandTracker {
+    /**
+     * @param {number} maxHands - Landmark capacity of the shared buffer
+     */
+    constructor(maxHands = MAX_HANDS) {
+        this.controlBuffer = new SharedArrayBuffer(addon.CONTROL_LENGTH * Int32Array.BYTES_PER_ELEMENT);
+        this.landmarkBuffer = new SharedArrayBuffer(maxHands * LANDMARKS_PER_HAND * 2 * Float32Array.BYTES_PER_ELEMENT);
+        this.control = new Int32Array(this.controlBuffer);
+        this.landmarks = new Float32Array(this.landmarkBuffer);
+        this.result = { imageIndex: -1, count: 0, gestures: [-1, -1], sequence: 0, landmarks: new Float32Array(this.landmarks.length) };
+        this.isOpen = false;
+    }
+
+    /**
+     * Loads the DLL, initializes the graph and starts the tracker's worker
+     *
+     * @param {string} dllPath - Path of the hand tracking DLL
+     * @param {string} modelPath - Graph config (.pbtxt)
+     * @param {Function} onFrame - Optional, called on the event loop after new results; calls coalesce
+     * @param {number} queueDepth - Frames that may wait for the graph before the oldest is dropped
+     * @returns {boolean} True on success
+     */
+    open(dllPath, modelPath, onFrame = null, queueDepth = 2) {
+        const control = this.control;
+        const notify = () => {
+            Atomics.notify(control, CONTROL_SEQUENCE);
+            if (onFrame) {
+                onFrame();
+            }
+        };
+        this.isOpen = addon.open(dllPath, modelPath, this.control, this.landmarks, notify, queueDepth);
+        return this.isOpen;
+    }
+
+    /**
+     * Queues a BGR frame; returns immediately
+     *
+     * @param {number} imageIndex - Echoed back with the landmarks
+     * @param {number} width - Frame width
+     * @param {number} height - Frame height
+     * @param {Uint8Array} pixels - BGR pixels, e.g. a Buffer
+     * @param {number} stride - Row pitch in bytes, 0 for densely packed
+     * @returns {boolean} False when the frame was dropped
+     */
+    submitFrame(imageIndex, width, height, pixels, stride = 0) {
+        return addon.submitFrame(imageIndex, width, height, pixels, stride);
+    }
+
+    /**
+     * Copies the latest result into this.result without allocating
+     *
+     * @returns {Object|null} this.result, or null if no consistent copy could be taken
+     */
+    readLandmarks() {
+        const result = this.result;
+        if (!readSharedLandmarks(this.control, this.landmarks, result, result.landmarks)) {
+            return null;
+        }
+        return result;
+    }
+
+    /** @returns {number} Results published since open */
+    getResultCount() {
+        return Atomics.load(this.control, CONTROL_RESULT_COUNT);
+    }
+
+    /** @returns {Object} inFlight, droppedFrames, droppedResults of the native queue */
+    getStats() {
+        return addon.getStats();
+    }
+
+    close() {
+        if (this.isOpen) {
+            addon.close();
+            this.isOpen = false;
+        }
+    }
+}
+
+module.exports = {
+    HandTracker,
+    readSharedLandmarks,
+    waitForSharedFrame,
+    LANDMARKS_PER_HAND
+};
@@ -0,0 +1,420 @@
+//!
+//! @brief - Node-API addon around MediapipeHandTrackingAsync
+//!
+//! Frames are submitted from JS and run on the async tracker's worker thread, so the
+//! event loop never blocks in the graph. Landmarks are written by the DLL's callback
+//! straight into typed arrays the caller allocated once (normally over a
+//! SharedArrayBuffer) under a sequence lock in the control array, so JS reads them
+//! in place on any thread with no per-frame objects or JSON. An optional onFrame
+//! function is invoked through a thread-safe function after each result; calls
+//! coalesce while the event loop is busy. index.js wraps this with Atomics.notify so
+//! worker threads can Atomics.wait on the sequence.
+//!
+//! Control array (Int32Array, MEDIAPIPE_NODE_CONTROL_LENGTH entries):
+//!   [0] sequence, odd while the native side is writing
+//!   [1] image_index of the landmarks
+//!   [2] landmark count (21 per hand)
+//!   [3] [4] gesture result of the first and second hand, -1 when unknown
+//!   [5] results published so far
+//!
+//! The DLL keeps its graph in globals, so there is one tracker per process.
+//!
+
+#include <node_api.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "MediapipeHandTrackingAsync.h"
+
+#define MEDIAPIPE_NODE_CONTROL_LENGTH 8
+
+namespace
+{
+	enum ControlSlot
+	{
+		CS_Sequence = 0,
+		CS_Image_Index = 1,
+		CS_Landmark_Count = 2,
+		CS_Gesture_First = 3,
+		CS_Gesture_Second = 4,
+		CS_Result_Count = 5
+	};
+
+	struct AddonState
+	{
+		MediapipeHandTrackingDll m_Dll;
+		std::unique_ptr<MediapipeHandTrackingAsync> m_Async;
+		bool m_Initialized = false;
+		napi_env m_Env = nullptr;			// environment that opened the tracker
+
+		// views into caller-owned memory, kept alive by the references
+		napi_ref m_Control_Ref = nullptr;
+		napi_ref m_Landmarks_Ref = nullptr;
+		std::atomic<int32_t>* m_Control = nullptr;
+		float* m_Landmarks = nullptr;
+		size_t m_Landmark_Capacity = 0;		// in PoseInfo
+
+		napi_threadsafe_function m_On_Frame = nullptr;
+	};
+
+	AddonState g_State;
+	// set while open; the DLL callbacks carry no user pointer
+	std::atomic<AddonState*> g_ActiveState(nullptr);
+
+	static_assert(sizeof(std::atomic<int32_t>) == sizeof(int32_t), "control slots must alias Int32Array elements");
+
+	// Seqlock writer side; the reader in index.js retries while the sequence is odd or changed
+	void BeginWrite(std::atomic<int32_t>* control)
+	{
+		control[CS_Sequence].fetch_add(1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+	}
+
+	void EndWrite(std::atomic<int32_t>* control)
+	{
+		std::atomic_thread_fence(std::memory_order_release);
+		control[CS_Sequence].fetch_add(1, std::memory_order_release);
+	}
+
+	void OnLandmarks(int image_index, PoseInfo* infos, int count)
+	{
+		AddonState* state = g_ActiveState.load(std::memory_order_acquire);
+		if (state == nullptr || state->m_Control == nullptr)
+		{
+			return;
+		}
+		size_t copyCount = count > 0 && infos != nullptr ? (size_t)count : 0;
+		if (copyCount > state->m_Landmark_Capacity)
+		{
+			copyCount = state->m_Landmark_Capacity;
+		}
+
+		BeginWrite(state->m_Control);
+		memcpy(state->m_Landmarks, infos, copyCount * sizeof(PoseInfo));
+		state->m_Control[CS_Image_Index].store(image_index, std::memory_order_relaxed);
+		state->m_Control[CS_Landmark_Count].store((int32_t)copyCount, std::memory_order_relaxed);
+		state->m_Control[CS_Result_Count].fetch_add(1, std::memory_order_relaxed);
+		EndWrite(state->m_Control);
+
+		if (state->m_On_Frame != nullptr)
+		{
+			// queue size 1: a full queue means JS has not run the last call yet, which covers this one
+			napi_call_threadsafe_function(state->m_On_Frame, nullptr, napi_tsfn_nonblocking);
+		}
+	}
+
+	void OnGestureResult(int image_index, int* recogn_result, int count)
+	{
+		(void)image_index;
+		AddonState* state = g_ActiveState.load(std::memory_order_acquire);
+		if (state == nullptr || state->m_Control == nullptr)
+		{
+			return;
+		}
+		BeginWrite(state->m_Control);
+		state->m_Control[CS_Gesture_First].store(count > 0 && recogn_result != nullptr ? recogn_result[0] : -1, std::memory_order_relaxed);
+		state->m_Control[CS_Gesture_Second].store(count > 1 && recogn_result != nullptr ? recogn_result[1] : -1, std::memory_order_relaxed);
+		EndWrite(state->m_Control);
+	}
+
+	void CallOnFrame(napi_env env, napi_value js_callback, void* context, void* data)
+	{
+		(void)context;
+		(void)data;
+		if (env == nullptr || js_callback == nullptr)
+		{
+			return;
+		}
+		napi_value undefined;
+		napi_get_undefined(env, &undefined);
+		napi_call_function(env, undefined, js_callback, 0, nullptr, nullptr);
+	}
+
+	napi_value ThrowError(napi_env env, const char* message)
+	{
+		napi_throw_error(env, nullptr, message);
+		return nullptr;
+	}
+
+	napi_value MakeBool(napi_env env, bool value)
+	{
+		napi_value result;
+		napi_get_boolean(env, value, &result);
+		return result;
+	}
+
+	bool GetString(napi_env env, napi_value value, std::string& out)
+	{
+		size_t length = 0;
+		if (napi_get_value_string_utf8(env, value, nullptr, 0, &length) != napi_ok)
+		{
+			return false;
+		}
+		out.resize(length + 1);
+		if (napi_get_value_string_utf8(env, value, &out[0], out.size(), &length) != napi_ok)
+		{
+			return false;
+		}
+		out.resize(length);
+		return true;
+	}
+
+	bool GetTypedArray(napi_env env, napi_value value, napi_typedarray_type expected, void*& data, size_t& length)
+	{
+		bool isTypedArray = false;
+		if (napi_is_typedarray(env, value, &isTypedArray) != napi_ok || !isTypedArray)
+		{
+			return false;
+		}
+		napi_typedarray_type type;
+		napi_value arrayBuffer;
+		size_t byteOffset = 0;
+		if (napi_get_typedarray_info(env, value, &type, &length, &data, &arrayBuffer, &byteOffset) != napi_ok)
+		{
+			return false;
+		}
+		return type == expected;
+	}
+
+	void CloseTracker(napi_env env)
+	{
+		AddonState& state = g_State;
+		if (state.m_Async)
+		{
+			state.m_Async->Stop();
+			state.m_Async.reset();
+		}
+		// no callback can fire past this point
+		g_ActiveState.store(nullptr, std::memory_order_release);
+		if (state.m_Initialized && state.m_Dll.m_Mediapipe_Hand_Tracking_Release != nullptr)
+		{
+			state.m_Dll.m_Mediapipe_Hand_Tracking_Release();
+		}
+		state.m_Initialized = false;
+		state.m_Dll.UnLoadMediapipeHandTrackingDll();
+
+		if (state.m_On_Frame != nullptr)
+		{
+			napi_release_threadsafe_function(state.m_On_Frame, napi_tsfn_abort);
+			state.m_On_Frame = nullptr;
+		}
+		if (env != nullptr)
+		{
+			if (state.m_Control_Ref != nullptr)
+			{
+				napi_delete_reference(env, state.m_Control_Ref);
+			}
+			if (state.m_Landmarks_Ref != nullptr)
+			{
+				napi_delete_reference(env, state.m_Landmarks_Ref);
+			}
+		}
+		state.m_Control_Ref = nullptr;
+		state.m_Landmarks_Ref = nullptr;
+		state.m_Control = nullptr;
+		state.m_Landmarks = nullptr;
+		state.m_Landmark_Capacity = 0;
+		state.m_Env = nullptr;
+	}
+
+	// open(dllPath, modelPath, control: Int32Array, landmarks: Float32Array, onFrame?, queueDepth?)
+	napi_value Open(napi_env env, napi_callback_info info)
+	{
+		size_t argc = 6;
+		napi_value argv[6];
+		napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+		if (argc < 4)
+		{
+			return ThrowError(env, "open(dllPath, modelPath, control, landmarks[, onFrame[, queueDepth]])");
+		}
+		if (g_ActiveState.load() != nullptr)
+		{
+			return ThrowError(env, "a tracker is already open in this process");
+		}
+
+		std::string dllPath;
+		std::string modelPath;
+		void* controlData = nullptr;
+		size_t controlLength = 0;
+		void* landmarksData = nullptr;
+		size_t landmarksLength = 0;
+		if (!GetString(env, argv[0], dllPath) || !GetString(env, argv[1], modelPath))
+		{
+			return ThrowError(env, "dllPath and modelPath must be strings");
+		}
+		if (!GetTypedArray(env, argv[2], napi_int32_array, controlData, controlLength) || controlLength < MEDIAPIPE_NODE_CONTROL_LENGTH)
+		{
+			return ThrowError(env, "control must be an Int32Array of at least 8 elements");
+		}
+		if (!GetTypedArray(env, argv[3], napi_float32_array, landmarksData, landmarksLength) || landmarksLength < 2)
+		{
+			return ThrowError(env, "landmarks must be a Float32Array");
+		}
+
+		napi_valuetype onFrameType = napi_undefined;
+		if (argc > 4)
+		{
+			napi_typeof(env, argv[4], &onFrameType);
+		}
+		int queueDepth = 2;
+		if (argc > 5)
+		{
+			napi_get_value_int32(env, argv[5], &queueDepth);
+		}
+
+		AddonState& state = g_State;
+		state.m_Env = env;
+		state.m_Control = (std::atomic<int32_t>*)controlData;
+		state.m_Landmarks = (float*)landmarksData;
+		state.m_Landmark_Capacity = landmarksLength / 2;
+		napi_create_reference(env, argv[2], 1, &state.m_Control_Ref);
+		napi_create_reference(env, argv[3], 1, &state.m_Landmarks_Ref);
+		state.m_Control[CS_Gesture_First].store(-1);
+		state.m_Control[CS_Gesture_Second].store(-1);
+
+		if (onFrameType == napi_function)
+		{
+			napi_value resourceName;
+			napi_create_string_utf8(env, "MediapipeHandTrackingFrame", NAPI_AUTO_LENGTH, &resourceName);
+			if (napi_create_threadsafe_function(env, argv[4], nullptr, resourceName, 1, 1, nullptr, nullptr, nullptr, CallOnFrame, &state.m_On_Frame) != napi_ok)
+			{
+				CloseTracker(env);
+				return ThrowError(env, "failed to create the onFrame thread-safe function");
+			}
+			// the tracker must not keep the process alive by itself
+			napi_unref_threadsafe_function(env, state.m_On_Frame);
+		}
+
+		g_ActiveState.store(&state, std::memory_order_release);
+		if (!state.m_Dll.LoadMediapipeHandTrackingDll(dllPath) || !state.m_Dll.GetAllFunctions())
+		{
+			CloseTracker(env);
+			return MakeBool(env, false);
+		}
+		if (!state.m_Dll.m_Mediapipe_Hand_Tracking_Init(modelPath.c_str()))
+		{
+			CloseTracker(env);
+			return MakeBool(env, false);
+		}
+		state.m_Initialized = true;
+		if (!state.m_Dll.m_Mediapipe_Hand_Tracking_Reigeter_Landmarks_Callback(OnLandmarks)
+			|| !state.m_Dll.m_Mediapipe_Hand_Tracking_Register_Gesture_Result_Callback(OnGestureResult))
+		{
+			CloseTracker(env);
+			return MakeBool(env, false);
+		}
+
+		state.m_Async.reset(new MediapipeHandTrackingAsync(state.m_Dll, queueDepth > 0 ? queueDepth : 2));
+		if (!state.m_Async->Start())
+		{
+			CloseTracker(env);
+			return MakeBool(env, false);
+		}
+		return MakeBool(env, true);
+	}
+
+	// submitFrame(imageIndex, width, height, pixels: Uint8Array (BGR)[, stride]) -> false if dropped
+	napi_value SubmitFrame(napi_env env, napi_callback_info info)
+	{
+		size_t argc = 5;
+		napi_value argv[5];
+		napi_get_cb_info(env, info, &argc, argv, nullptr, nullptr);
+		AddonState& state = g_State;
+		if (!state.m_Async || argc < 4)
+		{
+			return MakeBool(env, false);
+		}
+
+		int32_t imageIndex = 0;
+		int32_t width = 0;
+		int32_t height = 0;
+		int32_t stride = 0;
+		napi_get_value_int32(env, argv[0], &imageIndex);
+		napi_get_value_int32(env, argv[1], &width);
+		napi_get_value_int32(env, argv[2], &height);
+		if (argc > 4)
+		{
+			napi_get_value_int32(env, argv[4], &stride);
+		}
+
+		void* pixels = nullptr;
+		size_t length = 0;
+		if (!GetTypedArray(env, argv[3], napi_uint8_array, pixels, length))
+		{
+			return ThrowError(env, "pixels must be a Uint8Array or Buffer");
+		}
+		size_t rowBytes = (size_t)(stride > 0 ? stride : width * 3);
+		if (width <= 0 || height <= 0 || length < rowBytes * (size_t)(height - 1) + (size_t)width * 3)
+		{
+			return ThrowError(env, "pixels is smaller than width x height x 3");
+		}
+
+		// copies into a queue slot and returns; the graph runs on the tracker's worker
+		return MakeBool(env, state.m_Async->SubmitFrame(imageIndex, width, height, pixels, stride));
+	}
+
+	napi_value Close(napi_env env, napi_callback_info info)
+	{
+		(void)info;
+		if (g_State.m_Env == env)
+		{
+			CloseTracker(env);
+		}
+		return nullptr;
+	}
+
+	// getStats() -> { inFlight, droppedFrames, droppedResults }
+	napi_value GetStats(napi_env env, napi_callback_info info)
+	{
+		(void)info;
+		AddonState& state = g_State;
+		napi_value stats;
+		napi_create_object(env, &stats);
+		napi_value value;
+		napi_create_int32(env, state.m_Async ? state.m_Async->GetInFlightCount() : 0, &value);
+		napi_set_named_property(env, stats, "inFlight", value);
+		napi_create_double(env, state.m_Async ? (double)state.m_Async->GetDroppedFrameCount() : 0.0, &value);
+		napi_set_named_property(env, stats, "droppedFrames", value);
+		napi_create_double(env, state.m_Async ? (double)state.m_Async->GetDroppedResultCount() : 0.0, &value);
+		napi_set_named_property(env, stats, "droppedResults", value);
+		return stats;
+	}
+
+	void OnEnvironmentCleanup(void* arg)
+	{
+		// every worker thread that loads the addon registers a hook; only the owner closes
+		if (g_State.m_Env != (napi_env)arg)
+		{
+			return;
+		}
+		// references belong to an environment that is going away
+		g_State.m_Control_Ref = nullptr;
+		g_State.m_Landmarks_Ref = nullptr;
+		CloseTracker(nullptr);
+	}
+
+	napi_value Init(napi_env env, napi_value exports)
+	{
+		napi_property_descriptor properties[] =
+		{
+			{ "open", nullptr, Open, nullptr, nullptr, nullptr, napi_default, nullptr },
+			{ "submitFrame", nullptr, SubmitFrame, nullptr, nullptr, nullptr, napi_default, nullptr },
+			{ "close", nullptr, Close, nullptr, nullptr, nullptr, napi_default, nullptr },
+			{ "getStats", nullptr, GetStats, nullptr, nullptr, nullptr, napi_default, nullptr },
+		};
+		napi_define_properties(env, exports, sizeof(properties) / sizeof(properties[0]), properties);
+
+		napi_value controlLength;
+		napi_create_int32(env, MEDIAPIPE_NODE_CONTROL_LENGTH, &controlLength);
+		napi_set_named_property(env, exports, "CONTROL_LENGTH", controlLength);
+
+		napi_add_env_cleanup_hook(env, OnEnvironmentCleanup, env);
+		return exports;
+	}
+}
+
+NAPI_MODULE(NODE_GYP_MODULE_NAME, Init)
@@ -1,5 +1,7 @@
 ﻿#include "DynamicModuleLoader.h"
 
+#include <fstream>
+
 namespace DynamicModuleLoaderSpace
 {
 	DynamicModuleLoader::DynamicModuleLoader() :m_DynamicModulePtr(NULL), m_ErrorMessage(""), m_DynamicModuleState(DynamicModuleState::DMS_UnLoaded)
@@ -10,30 +12,44 @@ namespace DynamicModuleLoaderSpace
 	{
 	}
 
-	bool DynamicModuleLoader::IsFileExist(const std::string filePath)
+	MODULE_HANDLER DynamicModuleLoader::OpenModule(const std::string& modulePath, DynamicModuleLoadMode loadMode)
 	{
-		std::fstream file;
-		file.open(filePath, std::ios::in);
-		if (file)
-		{
-			file.close();
-			return true;
-		}
-		else
-		{
-			return false;
-		}
+#ifdef WINDOWS
+		(void)loadMode;
+		return LoadLibrary(modulePath.c_str());
+#elif defined(LINUX)
+		int mode = loadMode == DMLM_Isolated ? (RTLD_LAZY | RTLD_LOCAL) : (RTLD_NOW | RTLD_GLOBAL);
+		return dlopen(modulePath.c_str(), mode);
+#endif // WINDOWS
 	}
 
-	bool DynamicModuleLoader::LoadDynamicModule(const std::string dynamicModulePath)
+	void DynamicModuleLoader::CloseModule(MODULE_HANDLER modulePtr)
 	{
-		if (IsFileExist(dynamicModulePath))
-		{
 #ifdef WINDOWS
-			m_DynamicModulePtr = LoadLibrary(dynamicModulePath.c_str());
-#elif LINUX
-			m_DynamicModulePtr = dlopen(dynamicModulePath.c_str(), RTLD_NOW | RTLD_GLOBAL);
+		FreeLibrary(modulePtr);
+#elif defined(LINUX)
+		dlclose(modulePtr);
 #endif // WINDOWS
+	}
+
+	bool DynamicModuleLoader::IsFileExist(const std::string& filePath)
+	{
+		// Attribute lookup only; nothing is opened
+#ifdef WINDOWS
+		DWORD attributes = GetFileAttributesA(filePath.c_str());
+		return attributes != INVALID_FILE_ATTRIBUTES && !(attributes & FILE_ATTRIBUTE_DIRECTORY);
+#elif defined(LINUX)
+		struct stat fileStat;
+		return stat(filePath.c_str(), &fileStat) == 0 && S_ISREG(fileStat.st_mode);
+#endif // WINDOWS
+	}
+
+	bool DynamicModuleLoader::LoadDynamicModule(const std::string& dynamicModulePath, DynamicModuleLoadMode loadMode)
+	{
+		if (IsFileExist(dynamicModulePath))
+		{
+			m_ResolvedFunctions.clear();
+			m_DynamicModulePtr = OpenModule(dynamicModulePath, loadMode);
 
 			if (m_DynamicModulePtr != NULL)
 			{
@@ -42,8 +58,9 @@ namespace DynamicModuleLoaderSpace
 			}
 			else
 			{
+				int errorCode = 0;
 #ifdef WINDOWS
-				int errorCode = GetLastError();
+				errorCode = GetLastError();
 #endif
 				GetInternalErrorMessge(errorCode);
 				return false;
@@ -54,25 +71,85 @@ namespace DynamicModuleLoaderSpace
 		return false;
 	}
 
-	void* DynamicModuleLoader::GetFunction(const std::string functionName)
+	bool DynamicModuleLoader::LoadPreloadManifest(const std::string& manifestPath, DynamicModuleLoadMode loadMode)
+	{
+		std::ifstream manifest(manifestPath);
+		if (!manifest)
+		{
+			m_ErrorMessage = "cannot open preload manifest " + manifestPath;
+			return false;
+		}
+
+		std::string baseDirectory;
+		size_t split = manifestPath.find_last_of("/\\");
+		if (split != std::string::npos)
+		{
+			baseDirectory = manifestPath.substr(0, split + 1);
+		}
+
+		std::string line;
+		while (std::getline(manifest, line))
+		{
+			line = line.substr(0, line.find('#'));
+			size_t begin = line.find_first_not_of(" \t\r");
+			if (begin == std::string::npos)
+			{
+				continue;
+			}
+			std::string libraryPath = line.substr(begin, line.find_last_not_of(" \t\r") - begin + 1);
+			// bare file names go through the system search path, other relative paths start at the manifest
+			bool hasDirectory = libraryPath.find_first_of("/\\") != std::string::npos;
+			bool isAbsolute = libraryPath[0] == '/' || libraryPath[0] == '\\' || (libraryPath.size() > 1 && libraryPath[1] == ':');
+			if (hasDirectory && !isAbsolute)
+			{
+				libraryPath = baseDirectory + libraryPath;
+			}
+
+			MODULE_HANDLER preloaded = OpenModule(libraryPath, loadMode);
+			if (preloaded == NULL)
+			{
+				int errorCode = 0;
+#ifdef WINDOWS
+				errorCode = GetLastError();
+#endif
+				GetInternalErrorMessge(errorCode);
+				m_ErrorMessage = libraryPath + ": " + m_ErrorMessage;
+				return false;
+			}
+			m_PreloadedModulePtrs.push_back(preloaded);
+		}
+		return true;
+	}
+
+	void* DynamicModuleLoader::GetFunction(const std::string& functionName)
 	{
 		if (m_DynamicModulePtr)
 		{
+			auto cached = m_ResolvedFunctions.find(functionName);
+			if (cached != m_ResolvedFunctions.end())
+			{
+				return cached->second;
+			}
+
 			void* tempFunctionPtr = NULL;
 #ifdef WINDOWS
-			tempFunctionPtr = GetProcAddress(m_DynamicModulePtr, functionName.c_str());
-#elif LINUX
+			tempFunctionPtr = (void*)GetProcAddress(m_DynamicModulePtr, functionName.c_str());
+#elif defined(LINUX)
 			tempFunctionPtr = dlsym(m_DynamicModulePtr, functionName.c_str());
 #endif // WINDOWS
 
+			// Misses are cached too: optional exports (e.g. Mediapipe_IK_*) are probed on every load
+			m_ResolvedFunctions.emplace(functionName, tempFunctionPtr);
+
 			if (tempFunctionPtr != NULL)
 			{
 				return tempFunctionPtr;
 			}
 			else
 			{
+				int errorCode = 0;
 #ifdef WINDOWS
-				int errorCode = GetLastError();
+				errorCode = GetLastError();
 #endif
 				GetInternalErrorMessge(errorCode);
 			}
@@ -92,13 +169,25 @@ namespace DynamicModuleLoaderSpace
 				GetInternalErrorMessge(errorCode);
 				return false;
 			}
-#elif LINUX
+#elif defined(LINUX)
 			dlclose(m_DynamicModulePtr);
 #endif
+			m_DynamicModulePtr = NULL;
+			m_ResolvedFunctions.clear();
 			m_DynamicModuleState = DynamicModuleState::DMS_UnLoaded;
-			return true;
 		}
-		return false;
+		else if (m_PreloadedModulePtrs.empty())
+		{
+			return false;
+		}
+
+		// dependencies go last, newest first
+		for (auto it = m_PreloadedModulePtrs.rbegin(); it != m_PreloadedModulePtrs.rend(); ++it)
+		{
+			CloseModule(*it);
+		}
+		m_PreloadedModulePtrs.clear();
+		return true;
 	}
 
 #ifdef WINDOWS
@@ -127,8 +216,10 @@ namespace DynamicModuleLoaderSpace
 			errorMessge = (LPCTSTR)(lpMsgBuf);
 			LocalFree(lpMsgBuf);
 		}
-#elif LINUX
-		errorMessge = dlerror();
+#elif defined(LINUX)
+		(void)errorCode;
+		const char* dlErrorMessage = dlerror();
+		errorMessge = dlErrorMessage != NULL ? dlErrorMessage : "";
 #endif // WINDOWS
 
 		m_ErrorMessage = errorMessge;
@@ -11,10 +11,19 @@
 #define _DYNAMIC_MODULE_LOADER_H_
 
 #include <string>
-#include <fstream>
+#include <unordered_map>
+#include <vector>
 
 #define _DYNAMIC_LOAD
+
+// Build with -DWINDOWS or -DLINUX to force a platform; otherwise it follows the compiler
+#if !defined(WINDOWS) && !defined(LINUX)
+#if defined(_WIN32)
 #define WINDOWS
+#else
+#define LINUX
+#endif
+#endif
 
 #if defined(_DYNAMIC_LOAD)
 
@@ -23,6 +32,7 @@
 #define MODULE_HANDLER HINSTANCE
 #elif defined(LINUX)
 #include <dlfcn.h>
+#include <sys/stat.h>
 #define MODULE_HANDLER void*
 #endif 
 
@@ -48,17 +58,38 @@ namespace DynamicModuleLoaderSpace
 		DMS_Loaded = 1
 	};
 
+	//! dlopen mode on Linux; ignored on Windows, where every DLL already has its own import namespace
+	enum DynamicModuleLoadMode
+	{
+		DMLM_Global = 0,	// RTLD_NOW | RTLD_GLOBAL: resolve everything up front, exports visible to later loads
+		DMLM_Isolated = 1	// RTLD_LAZY | RTLD_LOCAL: resolve on first call, so several versions can coexist
+	};
+
 	class DynamicModuleLoader
 	{
 	public:
 		DynamicModuleLoader();
 		virtual ~DynamicModuleLoader();
 
-		static bool IsFileExist(const std::string filePath);
+		static bool IsFileExist(const std::string& filePath);
+
+		bool LoadDynamicModule(const std::string& dynamicModulePath, DynamicModuleLoadMode loadMode = DMLM_Global);
+
+		//! Load the libraries listed in a manifest before the module itself, so its dependencies
+		//! come from those exact files. One library per line, '#' starts a comment; bare names
+		//! use the system search path and relative paths start at the manifest's directory.
+		//! They are unloaded with the module.
+		bool LoadPreloadManifest(const std::string& manifestPath, DynamicModuleLoadMode loadMode = DMLM_Global);
 
-		bool LoadDynamicModule(const std::string dynamicModulePath);
+		//! Resolved addresses (and misses) are cached until the module is unloaded,
+		//! so asking again for the same export does not go back to the OS loader
+		void* GetFunction(const std::string& functionName);
 
-		void* GetFunction(const std::string functionName);
+		template<typename FunctionType>
+		FunctionType GetFunction(const std::string& functionName)
+		{
+			return reinterpret_cast<FunctionType>(GetFunction(functionName));
+		}
 
 		bool UnloadDynamicModule();
 
@@ -67,12 +98,18 @@ namespace DynamicModuleLoaderSpace
 		bool GetDynamicModuleState();
 	private:
 		void GetInternalErrorMessge(int errorCode);
+		MODULE_HANDLER OpenModule(const std::string& modulePath, DynamicModuleLoadMode loadMode);
+		static void CloseModule(MODULE_HANDLER modulePtr);
 	private:
 		MODULE_HANDLER m_DynamicModulePtr;
 
+		std::vector<MODULE_HANDLER> m_PreloadedModulePtrs;
+
 		std::string m_ErrorMessage;
 
 		DynamicModuleState m_DynamicModuleState;
+
+		std::unordered_map<std::string, void*> m_ResolvedFunctions;
 	};
 }
 
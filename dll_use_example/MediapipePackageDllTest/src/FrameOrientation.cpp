@@ -0,0 +1,110 @@
+#include "FrameOrientation.h"
+
+#include <cstddef>
+#include <cstring>
+
+namespace
+{
+	// byte offset in the source of pixel (x, y) of the rotated (not yet mirrored) frame
+	ptrdiff_t SourceOffset(int x, int y, int source_width, int source_height, ptrdiff_t source_stride, FrameRotation rotation)
+	{
+		switch (rotation)
+		{
+		case FR_Rotate90:
+			return (ptrdiff_t)(source_height - 1 - x) * source_stride + (ptrdiff_t)y * 3;
+		case FR_Rotate180:
+			return (ptrdiff_t)(source_height - 1 - y) * source_stride + (ptrdiff_t)(source_width - 1 - x) * 3;
+		case FR_Rotate270:
+			return (ptrdiff_t)x * source_stride + (ptrdiff_t)(source_width - 1 - y) * 3;
+		default:
+			return (ptrdiff_t)y * source_stride + (ptrdiff_t)x * 3;
+		}
+	}
+}
+
+void GetOrientedSize(int source_width, int source_height, const FrameOrientation& orientation, int& oriented_width, int& oriented_height)
+{
+	bool isTransposed = orientation.m_Rotation == FR_Rotate90 || orientation.m_Rotation == FR_Rotate270;
+	oriented_width = isTransposed ? source_height : source_width;
+	oriented_height = isTransposed ? source_width : source_height;
+}
+
+bool CopyOrientedBGR(int source_width, int source_height, const unsigned char* source, int source_stride, const FrameOrientation& orientation, unsigned char* oriented, int oriented_stride)
+{
+	if (source == nullptr || oriented == nullptr || source_width <= 0 || source_height <= 0)
+	{
+		return false;
+	}
+	int width = 0;
+	int height = 0;
+	GetOrientedSize(source_width, source_height, orientation, width, height);
+	ptrdiff_t srcStride = source_stride > 0 ? source_stride : (ptrdiff_t)source_width * 3;
+	ptrdiff_t dstStride = oriented_stride > 0 ? oriented_stride : (ptrdiff_t)width * 3;
+	if (srcStride < (ptrdiff_t)source_width * 3 || dstStride < (ptrdiff_t)width * 3)
+	{
+		return false;
+	}
+
+	if (orientation.m_Rotation == FR_None && !orientation.m_Mirror)
+	{
+		for (int y = 0; y < height; ++y)
+		{
+			memcpy(oriented + y * dstStride, source + y * srcStride, (size_t)width * 3);
+		}
+		return true;
+	}
+
+	// The source address is linear along an output row: find its start and step once per row
+	for (int y = 0; y < height; ++y)
+	{
+		int firstX = orientation.m_Mirror ? width - 1 : 0;
+		int secondX = orientation.m_Mirror ? width - 2 : 1;
+		ptrdiff_t start = SourceOffset(firstX, y, source_width, source_height, srcStride, orientation.m_Rotation);
+		ptrdiff_t step = width > 1 ? SourceOffset(secondX, y, source_width, source_height, srcStride, orientation.m_Rotation) - start : 0;
+		const unsigned char* src = source + start;
+		unsigned char* dst = oriented + y * dstStride;
+		for (int x = 0; x < width; ++x, src += step, dst += 3)
+		{
+			dst[0] = src[0];
+			dst[1] = src[1];
+			dst[2] = src[2];
+		}
+	}
+	return true;
+}
+
+void MapLandmarksToSource(PoseInfo* infos, int count, int source_width, int source_height, const FrameOrientation& orientation)
+{
+	if (infos == nullptr)
+	{
+		return;
+	}
+	int width = 0;
+	int height = 0;
+	GetOrientedSize(source_width, source_height, orientation, width, height);
+	for (int i = 0; i < count; ++i)
+	{
+		// undo the mirror, then the rotation, the inverse of SourceOffset's mapping
+		float x = orientation.m_Mirror ? (float)(width - 1) - infos[i].x : infos[i].x;
+		float y = infos[i].y;
+		switch (orientation.m_Rotation)
+		{
+		case FR_Rotate90:
+			infos[i].x = y;
+			infos[i].y = (float)(source_height - 1) - x;
+			break;
+		case FR_Rotate180:
+			infos[i].x = (float)(source_width - 1) - x;
+			infos[i].y = (float)(source_height - 1) - y;
+			break;
+		case FR_Rotate270:
+			infos[i].x = (float)(source_width - 1) - y;
+			infos[i].y = x;
+			break;
+		default:
+			infos[i].x = x;
+			infos[i].y = y;
+			break;
+		}
+	}
+}
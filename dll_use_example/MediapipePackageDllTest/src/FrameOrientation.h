@@ -0,0 +1,42 @@
+#ifndef FRAME_ORIENTATION_H
+#define FRAME_ORIENTATION_H
+
+#include "MediapipeHandTrackingDll.h"
+
+//!
+//! @brief - Rotation / mirroring folded into the copy that feeds the DLL
+//!
+//! The DLLs take an upright BGR frame, so a portrait-mounted or mirrored camera needs
+//! its frame turned before Detect. CopyOrientedBGR does that while copying into the
+//! destination (e.g. MediapipeHandTrackingAsync's queue slot, which is copied into
+//! anyway), so orientation costs no extra pass over the frame. MapLandmarksToSource
+//! turns the DLL's landmarks back into the caller's original frame.
+//!
+//! The oriented frame is the source rotated clockwise by m_Rotation, then mirrored
+//! left-right when m_Mirror is set.
+//!
+
+enum FrameRotation
+{
+	FR_None = 0,
+	FR_Rotate90 = 1,		// clockwise
+	FR_Rotate180 = 2,
+	FR_Rotate270 = 3		// clockwise, i.e. 90 counter-clockwise
+};
+
+struct FrameOrientation
+{
+	FrameRotation m_Rotation = FR_None;
+	bool m_Mirror = false;
+};
+
+// Size of the oriented frame for a source_width x source_height source
+void GetOrientedSize(int source_width, int source_height, const FrameOrientation& orientation, int& oriented_width, int& oriented_height);
+
+// source_stride / oriented_stride are in bytes, 0 = densely packed
+bool CopyOrientedBGR(int source_width, int source_height, const unsigned char* source, int source_stride, const FrameOrientation& orientation, unsigned char* oriented, int oriented_stride);
+
+// In place: oriented-frame pixel coordinates -> source-frame pixel coordinates
+void MapLandmarksToSource(PoseInfo* infos, int count, int source_width, int source_height, const FrameOrientation& orientation);
+
+#endif // !FRAME_ORIENTATION_H
@@ -0,0 +1,239 @@
+#include "FramePipeline.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+namespace
+{
+	// weight of the newest sample in the HUD averages
+	const double kAverageWeight = 0.1;
+
+	double Average(double average, double sample)
+	{
+		return average == 0.0 ? sample : average * (1.0 - kAverageWeight) + sample * kAverageWeight;
+	}
+}
+
+FramePipeline::FramePipeline(int slot_count, int max_landmarks)
+	: m_Frames(slot_count < 2 ? 2 : slot_count)
+	, m_FreeSlots(m_Frames.size())
+	, m_CapturedSlots(m_Frames.size())
+	, m_DetectedSlots(m_Frames.size())
+	, m_IsRunning(false)
+	, m_IsCaptureDone(false)
+	, m_IsDetectDone(false)
+	, m_CapturedCount(0)
+	, m_DetectedCount(0)
+	, m_SkippedCount(0)
+	, m_DroppedCount(0)
+	, m_LastLandmarks(max_landmarks)
+	, m_LastLandmarkCount(0)
+{
+	for (PipelineFrame& frame : m_Frames)
+	{
+		frame.m_Landmarks.resize(max_landmarks);
+	}
+	for (int i = 0; i < 4; ++i)
+	{
+		m_LastResults[i] = -1;
+	}
+}
+
+FramePipeline::~FramePipeline()
+{
+}
+
+bool FramePipeline::Run(cv::VideoCapture& capture, DetectFunction detect, RenderFunction render)
+{
+	if (!capture.isOpened() || !detect || !render)
+	{
+		return false;
+	}
+
+	// every slot starts out free; the rings are empty between runs
+	for (int i = 0; i < (int)m_Frames.size(); ++i)
+	{
+		m_FreeSlots.TryPush([i](int& slot) { slot = i; });
+	}
+	m_IsCaptureDone = false;
+	m_IsDetectDone = false;
+	m_IsRunning = true;
+
+	std::thread captureThread(&FramePipeline::CaptureLoop, this, std::ref(capture));
+	std::thread detectThread(&FramePipeline::DetectLoop, this, std::ref(detect));
+
+	FramePipelineStats stats;
+	std::chrono::steady_clock::time_point lastShown;
+	int idleRounds = 0;
+	while (true)
+	{
+		int slotIndex = -1;
+		if (!m_DetectedSlots.TryPop([&slotIndex](int& slot) { slotIndex = slot; }))
+		{
+			if (m_IsDetectDone && m_DetectedSlots.IsEmpty())
+			{
+				break;
+			}
+			Backoff(idleRounds);
+			continue;
+		}
+		idleRounds = 0;
+
+		PipelineFrame& frame = m_Frames[slotIndex];
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		if (lastShown.time_since_epoch().count() != 0)
+		{
+			double intervalMs = std::chrono::duration<double, std::milli>(now - lastShown).count();
+			if (intervalMs > 0.0)
+			{
+				stats.m_Fps = Average(stats.m_Fps, 1000.0 / intervalMs);
+			}
+		}
+		lastShown = now;
+		stats.m_Latency_Ms = Average(stats.m_Latency_Ms, std::chrono::duration<double, std::milli>(now - frame.m_Capture_Time).count());
+		if (frame.m_Detected)
+		{
+			stats.m_Detect_Ms = Average(stats.m_Detect_Ms, frame.m_Detect_Ms);
+		}
+		stats.m_Captured = m_CapturedCount.load(std::memory_order_relaxed);
+		stats.m_Detected = m_DetectedCount.load(std::memory_order_relaxed);
+		stats.m_Skipped = m_SkippedCount.load(std::memory_order_relaxed);
+		stats.m_Dropped = m_DroppedCount.load(std::memory_order_relaxed);
+
+		bool keepRunning = render(frame, stats);
+		m_FreeSlots.TryPush([slotIndex](int& slot) { slot = slotIndex; });
+		if (!keepRunning)
+		{
+			break;
+		}
+	}
+
+	RequestStop();
+	captureThread.join();
+	detectThread.join();
+
+	// drain so the next Run starts from a full free ring
+	int unused = 0;
+	while (m_CapturedSlots.TryPop([&unused](int& slot) { unused = slot; })) {}
+	while (m_DetectedSlots.TryPop([&unused](int& slot) { unused = slot; })) {}
+	while (m_FreeSlots.TryPop([&unused](int& slot) { unused = slot; })) {}
+	return true;
+}
+
+void FramePipeline::RequestStop()
+{
+	m_IsRunning = false;
+}
+
+void FramePipeline::DrawHud(cv::Mat& image, const FramePipelineStats& stats)
+{
+	char text[160];
+	std::snprintf(text, sizeof(text), "%.1f fps  latency %.1f ms  detect %.1f ms  skipped %llu  dropped %llu",
+		stats.m_Fps, stats.m_Latency_Ms, stats.m_Detect_Ms, stats.m_Skipped, stats.m_Dropped);
+	cv::Point origin(10, 24);
+	// dark outline keeps the text readable on any background
+	cv::putText(image, text, origin, cv::FONT_HERSHEY_SIMPLEX, 0.6, cv::Scalar(0, 0, 0), 3);
+	cv::putText(image, text, origin, cv::FONT_HERSHEY_SIMPLEX, 0.6, cv::Scalar(255, 255, 255), 1);
+}
+
+void FramePipeline::CaptureLoop(cv::VideoCapture& capture)
+{
+	int imageIndex = 0;
+	while (m_IsRunning)
+	{
+		int slotIndex = -1;
+		if (!m_FreeSlots.TryPop([&slotIndex](int& slot) { slotIndex = slot; }))
+		{
+			// renderer behind: keep draining the camera so the next frame is fresh
+			if (!capture.read(m_DropFrame) || m_DropFrame.empty())
+			{
+				break;
+			}
+			m_DroppedCount.fetch_add(1, std::memory_order_relaxed);
+			++imageIndex;
+			continue;
+		}
+
+		PipelineFrame& frame = m_Frames[slotIndex];
+		// read() reuses the slot's buffer while the camera resolution is unchanged
+		if (!capture.read(frame.m_Image) || frame.m_Image.empty())
+		{
+			break;
+		}
+		frame.m_Image_Index = imageIndex++;
+		frame.m_Capture_Time = std::chrono::steady_clock::now();
+		m_CapturedCount.fetch_add(1, std::memory_order_relaxed);
+		// never full: there are only as many slots as ring entries
+		m_CapturedSlots.TryPush([slotIndex](int& slot) { slot = slotIndex; });
+	}
+	m_IsCaptureDone = true;
+}
+
+void FramePipeline::DetectLoop(DetectFunction& detect)
+{
+	int idleRounds = 0;
+	while (m_IsRunning)
+	{
+		int slotIndex = -1;
+		if (!m_CapturedSlots.TryPop([&slotIndex](int& slot) { slotIndex = slot; }))
+		{
+			if (m_IsCaptureDone && m_CapturedSlots.IsEmpty())
+			{
+				break;
+			}
+			Backoff(idleRounds);
+			continue;
+		}
+		idleRounds = 0;
+
+		PipelineFrame& frame = m_Frames[slotIndex];
+		if (!m_CapturedSlots.IsEmpty())
+		{
+			// a newer frame is already waiting: show this one with the last result instead
+			frame.m_Detected = false;
+			frame.m_Detect_Succeeded = false;
+			frame.m_Landmark_Count = m_LastLandmarkCount;
+			std::copy(m_LastLandmarks.begin(), m_LastLandmarks.begin() + m_LastLandmarkCount, frame.m_Landmarks.begin());
+			std::copy(m_LastResults, m_LastResults + 4, frame.m_Results);
+			m_SkippedCount.fetch_add(1, std::memory_order_relaxed);
+		}
+		else
+		{
+			frame.m_Landmark_Count = 0;
+			for (int i = 0; i < 4; ++i)
+			{
+				frame.m_Results[i] = -1;
+			}
+			std::chrono::steady_clock::time_point detectStart = std::chrono::steady_clock::now();
+			frame.m_Detect_Succeeded = detect(frame);
+			frame.m_Detect_Ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - detectStart).count();
+			frame.m_Detected = true;
+			if (frame.m_Landmark_Count > (int)frame.m_Landmarks.size())
+			{
+				frame.m_Landmark_Count = (int)frame.m_Landmarks.size();
+			}
+
+			m_LastLandmarkCount = frame.m_Landmark_Count;
+			std::copy(frame.m_Landmarks.begin(), frame.m_Landmarks.begin() + frame.m_Landmark_Count, m_LastLandmarks.begin());
+			std::copy(frame.m_Results, frame.m_Results + 4, m_LastResults);
+			m_DetectedCount.fetch_add(1, std::memory_order_relaxed);
+		}
+		m_DetectedSlots.TryPush([slotIndex](int& slot) { slot = slotIndex; });
+	}
+	m_IsDetectDone = true;
+}
+
+void FramePipeline::Backoff(int& idle_rounds)
+{
+	// frames arrive every few ms at most; yield briefly, then sleep instead of burning a core
+	if (++idle_rounds < 64)
+	{
+		std::this_thread::yield();
+	}
+	else
+	{
+		std::this_thread::sleep_for(std::chrono::microseconds(500));
+	}
+}
@@ -0,0 +1,102 @@
+#ifndef FRAME_PIPELINE_H
+#define FRAME_PIPELINE_H
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/videoio.hpp>
+
+#include "SpscRingBuffer.h"
+
+//!
+//! @brief - Capture / detection / render pipeline over a fixed pool of frame buffers
+//!
+//! Capture and detection each run on their own thread; rendering runs on the thread
+//! that calls Run(), since HighGUI windows can only be pumped by the thread that
+//! created them. The stages hand slot indices to each other through three
+//! SpscRingBuffers (free -> captured -> detected -> free), so every ring has exactly
+//! one producer and one consumer and no frame is allocated or copied after the first
+//! capture.
+//!
+//! When detection falls behind, it runs only on the newest captured frame and passes
+//! the older ones to the renderer with the previous landmarks (m_Detected false), so
+//! the display keeps the camera's frame rate. When the renderer falls behind and no
+//! slot is free, capture reads into a scratch frame and counts it as dropped, which
+//! keeps the camera's own buffer from going stale.
+//!
+
+struct PipelineFrame
+{
+	cv::Mat m_Image;							// captured BGR, reused across captures
+	int m_Image_Index = 0;
+	std::chrono::steady_clock::time_point m_Capture_Time;
+	bool m_Detected = false;					// false when carried over from an earlier frame
+	bool m_Detect_Succeeded = false;
+	double m_Detect_Ms = 0.0;
+	std::vector<cv::Point> m_Landmarks;			// m_Landmark_Count valid entries
+	int m_Landmark_Count = 0;
+	int m_Results[4] = { -1, -1, -1, -1 };		// gesture or holistic results, stage-defined
+};
+
+struct FramePipelineStats
+{
+	double m_Fps = 0.0;							// frames shown per second
+	double m_Latency_Ms = 0.0;					// capture to display
+	double m_Detect_Ms = 0.0;
+	unsigned long long m_Captured = 0;
+	unsigned long long m_Detected = 0;
+	unsigned long long m_Skipped = 0;			// shown without running detection
+	unsigned long long m_Dropped = 0;			// never left the capture stage
+};
+
+class FramePipeline
+{
+public:
+	// detect fills the frame's landmarks/results and returns whether the DLL call succeeded
+	typedef std::function<bool(PipelineFrame& frame)> DetectFunction;
+	// render shows the frame; returning false stops the pipeline
+	typedef std::function<bool(PipelineFrame& frame, const FramePipelineStats& stats)> RenderFunction;
+
+	// max_landmarks sizes every slot's landmark buffer once
+	FramePipeline(int slot_count = 4, int max_landmarks = 21 * 6);
+	virtual~FramePipeline();
+
+public:
+	// Blocks until render returns false, RequestStop() is called or the capture ends
+	bool Run(cv::VideoCapture& capture, DetectFunction detect, RenderFunction render);
+	void RequestStop();
+
+	// fps / latency / detect time / drop counters, one line at the top left
+	static void DrawHud(cv::Mat& image, const FramePipelineStats& stats);
+
+private:
+	void CaptureLoop(cv::VideoCapture& capture);
+	void DetectLoop(DetectFunction& detect);
+	void Backoff(int& idle_rounds);
+
+private:
+	std::vector<PipelineFrame> m_Frames;
+	SpscRingBuffer<int> m_FreeSlots;			// render -> capture
+	SpscRingBuffer<int> m_CapturedSlots;		// capture -> detect
+	SpscRingBuffer<int> m_DetectedSlots;		// detect -> render
+	cv::Mat m_DropFrame;						// capture target when no slot is free
+
+	std::atomic<bool> m_IsRunning;
+	std::atomic<bool> m_IsCaptureDone;
+	std::atomic<bool> m_IsDetectDone;
+	std::atomic<unsigned long long> m_CapturedCount;
+	std::atomic<unsigned long long> m_DetectedCount;
+	std::atomic<unsigned long long> m_SkippedCount;
+	std::atomic<unsigned long long> m_DroppedCount;
+
+	// last detection, copied into frames that skip it; detection thread only
+	std::vector<cv::Point> m_LastLandmarks;
+	int m_LastLandmarkCount;
+	int m_LastResults[4];
+};
+
+#endif // !FRAME_PIPELINE_H
@@ -0,0 +1,448 @@
+#include "GraphFlowConfig.h"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+	// Just enough of the protobuf text format to find fields and blocks and where they
+	// sit in the text; values are kept as text ranges, never interpreted
+	struct TextField
+	{
+		std::string m_Name;
+		size_t m_Name_Begin = 0;
+		size_t m_Value_Begin = 0;
+		size_t m_Value_End = 0;
+	};
+
+	struct TextBlock
+	{
+		std::string m_Name;
+		size_t m_Name_Begin = 0;
+		size_t m_Open = std::string::npos;	// npos for the top level
+		size_t m_Close = 0;
+		std::vector<TextField> m_Fields;
+		std::vector<TextBlock> m_Blocks;
+	};
+
+	struct TextEdit
+	{
+		size_t m_Position;
+		size_t m_Erase;
+		std::string m_Insert;
+	};
+
+	enum TokenType
+	{
+		TT_End,
+		TT_Name,
+		TT_String,
+		TT_Punct
+	};
+
+	struct Token
+	{
+		TokenType m_Type = TT_End;
+		size_t m_Begin = 0;
+		size_t m_End = 0;
+	};
+
+	class TextParser
+	{
+	public:
+		TextParser(const std::string& text) : m_Text(text), m_Position(0) {}
+
+		bool ParseBody(TextBlock& block, char close, std::string& error)
+		{
+			while (true)
+			{
+				Token token = Next();
+				if (token.m_Type == TT_End)
+				{
+					if (close != 0)
+					{
+						error = "unterminated block " + block.m_Name;
+						return false;
+					}
+					block.m_Close = m_Text.size();
+					return true;
+				}
+				if (token.m_Type == TT_Punct && (m_Text[token.m_Begin] == close))
+				{
+					block.m_Close = token.m_Begin;
+					return true;
+				}
+				if (token.m_Type == TT_Punct && (m_Text[token.m_Begin] == ',' || m_Text[token.m_Begin] == ';'))
+				{
+					continue;
+				}
+
+				// field name: identifier, or [extension.name]
+				size_t nameBegin = token.m_Begin;
+				std::string name;
+				if (token.m_Type == TT_Name)
+				{
+					name = m_Text.substr(token.m_Begin, token.m_End - token.m_Begin);
+				}
+				else if (token.m_Type == TT_Punct && m_Text[token.m_Begin] == '[')
+				{
+					size_t end = m_Text.find(']', token.m_End);
+					if (end == std::string::npos)
+					{
+						error = "unterminated extension name";
+						return false;
+					}
+					name = Trim(m_Text.substr(token.m_End, end - token.m_End));
+					m_Position = end + 1;
+				}
+				else
+				{
+					error = "unexpected '" + m_Text.substr(token.m_Begin, token.m_End - token.m_Begin) + "' at offset " + std::to_string(token.m_Begin);
+					return false;
+				}
+
+				Token value = Next();
+				if (value.m_Type == TT_Punct && m_Text[value.m_Begin] == ':')
+				{
+					value = Next();
+				}
+				if (value.m_Type == TT_Punct && (m_Text[value.m_Begin] == '{' || m_Text[value.m_Begin] == '<'))
+				{
+					TextBlock child;
+					child.m_Name = name;
+					child.m_Name_Begin = nameBegin;
+					child.m_Open = value.m_Begin;
+					if (!ParseBody(child, m_Text[value.m_Begin] == '{' ? '}' : '>', error))
+					{
+						return false;
+					}
+					block.m_Blocks.push_back(child);
+					continue;
+				}
+
+				TextField field;
+				field.m_Name = name;
+				field.m_Name_Begin = nameBegin;
+				field.m_Value_Begin = value.m_Begin;
+				if (value.m_Type == TT_Punct && m_Text[value.m_Begin] == '[')
+				{
+					// repeated scalars: [a, b, c]
+					Token item = Next();
+					while (item.m_Type != TT_End && !(item.m_Type == TT_Punct && m_Text[item.m_Begin] == ']'))
+					{
+						item = Next();
+					}
+					value = item;
+				}
+				else if (value.m_Type == TT_String)
+				{
+					// adjacent strings concatenate
+					size_t saved = m_Position;
+					Token more = Next();
+					while (more.m_Type == TT_String)
+					{
+						value = more;
+						saved = m_Position;
+						more = Next();
+					}
+					m_Position = saved;
+				}
+				else if (value.m_Type != TT_Name)
+				{
+					error = "missing value for " + name;
+					return false;
+				}
+				field.m_Value_End = value.m_End;
+				block.m_Fields.push_back(field);
+			}
+		}
+
+	private:
+		Token Next()
+		{
+			Token token;
+			while (m_Position < m_Text.size())
+			{
+				char c = m_Text[m_Position];
+				if (std::isspace((unsigned char)c))
+				{
+					++m_Position;
+				}
+				else if (c == '#')
+				{
+					size_t end = m_Text.find('\n', m_Position);
+					m_Position = end == std::string::npos ? m_Text.size() : end;
+				}
+				else
+				{
+					break;
+				}
+			}
+			token.m_Begin = m_Position;
+			if (m_Position >= m_Text.size())
+			{
+				token.m_End = m_Position;
+				return token;
+			}
+
+			char c = m_Text[m_Position];
+			if (c == '"' || c == '\'')
+			{
+				size_t i = m_Position + 1;
+				while (i < m_Text.size() && m_Text[i] != c)
+				{
+					i += m_Text[i] == '\\' ? 2 : 1;
+				}
+				m_Position = std::min(m_Text.size(), i + 1);
+				token.m_Type = TT_String;
+			}
+			else if (std::isalnum((unsigned char)c) || c == '_' || c == '-' || c == '.' || c == '+')
+			{
+				size_t i = m_Position;
+				while (i < m_Text.size() && (std::isalnum((unsigned char)m_Text[i]) || m_Text[i] == '_' || m_Text[i] == '-' || m_Text[i] == '.' || m_Text[i] == '+'))
+				{
+					++i;
+				}
+				m_Position = i;
+				token.m_Type = TT_Name;
+			}
+			else
+			{
+				m_Position += 1;
+				token.m_Type = TT_Punct;
+			}
+			token.m_End = m_Position;
+			return token;
+		}
+
+		static std::string Trim(const std::string& value)
+		{
+			size_t begin = value.find_first_not_of(" \t\r\n");
+			size_t end = value.find_last_not_of(" \t\r\n");
+			return begin == std::string::npos ? std::string() : value.substr(begin, end - begin + 1);
+		}
+
+	private:
+		const std::string& m_Text;
+		size_t m_Position;
+	};
+
+	bool EndsWith(const std::string& value, const std::string& suffix)
+	{
+		return value.size() >= suffix.size() && value.compare(value.size() - suffix.size(), suffix.size(), suffix) == 0;
+	}
+
+	const TextBlock* FindFlowLimiterOptions(const TextBlock& block)
+	{
+		for (const TextBlock& child : block.m_Blocks)
+		{
+			// node_options: { [type.googleapis.com/mediapipe.FlowLimiterCalculatorOptions] { } }
+			// or the older options: { [mediapipe.FlowLimiterCalculatorOptions.ext] { } }
+			if (EndsWith(child.m_Name, "FlowLimiterCalculatorOptions") || EndsWith(child.m_Name, "FlowLimiterCalculatorOptions.ext"))
+			{
+				return &child;
+			}
+			const TextBlock* found = FindFlowLimiterOptions(child);
+			if (found != nullptr)
+			{
+				return found;
+			}
+		}
+		return nullptr;
+	}
+
+	// the whitespace in front of position's line, when only whitespace precedes it there
+	bool LineIndent(const std::string& text, size_t position, size_t& line_begin, std::string& indent)
+	{
+		size_t begin = text.rfind('\n', position == 0 ? 0 : position - 1);
+		begin = begin == std::string::npos ? 0 : begin + 1;
+		if (position < begin)
+		{
+			begin = position;
+		}
+		std::string prefix = text.substr(begin, position - begin);
+		if (prefix.find_first_not_of(" \t") != std::string::npos)
+		{
+			return false;
+		}
+		line_begin = begin;
+		indent = prefix;
+		return true;
+	}
+
+	// sets name to value inside block: replaces the existing value, or adds the field before the closing brace
+	void SetField(const std::string& text, const TextBlock& block, const std::string& name, int value, std::vector<TextEdit>& edits)
+	{
+		for (const TextField& field : block.m_Fields)
+		{
+			if (field.m_Name == name)
+			{
+				edits.push_back({ field.m_Value_Begin, field.m_Value_End - field.m_Value_Begin, std::to_string(value) });
+				return;
+			}
+		}
+		size_t lineBegin = 0;
+		std::string indent;
+		if (LineIndent(text, block.m_Close, lineBegin, indent))
+		{
+			edits.push_back({ lineBegin, 0, indent + "  " + name + ": " + std::to_string(value) + "\n" });
+		}
+		else
+		{
+			edits.push_back({ block.m_Close, 0, name + ": " + std::to_string(value) + " " });
+		}
+	}
+}
+
+bool ApplyGraphFlowOptions(const std::string& graph_text, const GraphFlowOptions& options, std::string& patched_text, GraphFlowReport& report, std::string& error)
+{
+	report = GraphFlowReport();
+	TextBlock root;
+	TextParser parser(graph_text);
+	if (!parser.ParseBody(root, 0, error))
+	{
+		return false;
+	}
+
+	std::vector<TextEdit> edits;
+	for (const TextBlock& node : root.m_Blocks)
+	{
+		if (node.m_Name != "node")
+		{
+			continue;
+		}
+		bool isFlowLimiter = false;
+		for (const TextField& field : node.m_Fields)
+		{
+			if (field.m_Name == "calculator" && graph_text.compare(field.m_Value_Begin, field.m_Value_End - field.m_Value_Begin, "\"FlowLimiterCalculator\"") == 0)
+			{
+				isFlowLimiter = true;
+			}
+		}
+		if (!isFlowLimiter)
+		{
+			continue;
+		}
+		++report.m_Flow_Limiters;
+		if (options.m_Max_In_Flight < 0 && options.m_Max_In_Queue < 0)
+		{
+			continue;
+		}
+
+		const TextBlock* flowOptions = FindFlowLimiterOptions(node);
+		if (flowOptions != nullptr)
+		{
+			if (options.m_Max_In_Flight >= 0)
+			{
+				SetField(graph_text, *flowOptions, "max_in_flight", options.m_Max_In_Flight, edits);
+			}
+			if (options.m_Max_In_Queue >= 0)
+			{
+				SetField(graph_text, *flowOptions, "max_in_queue", options.m_Max_In_Queue, edits);
+			}
+			continue;
+		}
+
+		++report.m_Options_Added;
+		size_t lineBegin = 0;
+		std::string indent;
+		if (!LineIndent(graph_text, node.m_Name_Begin, lineBegin, indent))
+		{
+			indent.clear();
+		}
+		std::string inner = indent + "    ";
+		std::string block = indent + "  node_options: {\n" + indent + "    [type.googleapis.com/mediapipe.FlowLimiterCalculatorOptions] {\n";
+		if (options.m_Max_In_Flight >= 0)
+		{
+			block += inner + "  max_in_flight: " + std::to_string(options.m_Max_In_Flight) + "\n";
+		}
+		if (options.m_Max_In_Queue >= 0)
+		{
+			block += inner + "  max_in_queue: " + std::to_string(options.m_Max_In_Queue) + "\n";
+		}
+		block += inner + "}\n" + indent + "  }\n";
+		size_t closeLine = 0;
+		std::string closeIndent;
+		if (LineIndent(graph_text, node.m_Close, closeLine, closeIndent))
+		{
+			edits.push_back({ closeLine, 0, block });
+		}
+		else
+		{
+			edits.push_back({ node.m_Close, 0, "\n" + block + indent });
+		}
+	}
+
+	for (const TextField& field : root.m_Fields)
+	{
+		if (field.m_Name == "max_queue_size")
+		{
+			report.m_Has_Queue_Size = true;
+			if (options.m_Max_Queue_Size >= 0)
+			{
+				edits.push_back({ field.m_Value_Begin, field.m_Value_End - field.m_Value_Begin, std::to_string(options.m_Max_Queue_Size) });
+			}
+		}
+	}
+	if (!report.m_Has_Queue_Size && options.m_Max_Queue_Size >= 0)
+	{
+		// ahead of the first field, after the file's leading comments
+		size_t first = graph_text.size();
+		for (const TextField& field : root.m_Fields)
+		{
+			first = std::min(first, field.m_Name_Begin);
+		}
+		for (const TextBlock& block : root.m_Blocks)
+		{
+			first = std::min(first, block.m_Name_Begin);
+		}
+		size_t lineBegin = first;
+		std::string indent;
+		LineIndent(graph_text, first, lineBegin, indent);
+		edits.push_back({ lineBegin, 0, "max_queue_size: " + std::to_string(options.m_Max_Queue_Size) + "\n\n" });
+	}
+
+	// back to front, so earlier positions stay valid; stable keeps the insertion order at equal positions
+	std::stable_sort(edits.begin(), edits.end(), [](const TextEdit& a, const TextEdit& b) { return a.m_Position > b.m_Position; });
+	patched_text = graph_text;
+	for (const TextEdit& edit : edits)
+	{
+		patched_text.replace(edit.m_Position, edit.m_Erase, edit.m_Insert);
+	}
+	return true;
+}
+
+bool WriteGraphWithFlowOptions(const std::string& graph_path, const GraphFlowOptions& options, std::string& output_path, GraphFlowReport* report, std::string* error)
+{
+	std::string localError;
+	std::string& errorOut = error != nullptr ? *error : localError;
+	std::ifstream input(graph_path, std::ios::binary);
+	if (!input)
+	{
+		errorOut = "cannot read " + graph_path;
+		return false;
+	}
+	std::stringstream buffer;
+	buffer << input.rdbuf();
+
+	GraphFlowReport localReport;
+	std::string patched;
+	if (!ApplyGraphFlowOptions(buffer.str(), options, patched, report != nullptr ? *report : localReport, errorOut))
+	{
+		return false;
+	}
+
+	const std::string extension = ".pbtxt";
+	std::string stem = EndsWith(graph_path, extension) ? graph_path.substr(0, graph_path.size() - extension.size()) : graph_path;
+	output_path = stem + ".flow.pbtxt";
+	std::ofstream output(output_path, std::ios::binary | std::ios::trunc);
+	if (!output || !(output << patched))
+	{
+		errorOut = "cannot write " + output_path;
+		return false;
+	}
+	return true;
+}
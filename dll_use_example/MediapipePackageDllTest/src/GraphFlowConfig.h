@@ -0,0 +1,46 @@
+#ifndef GRAPH_FLOW_CONFIG_H
+#define GRAPH_FLOW_CONFIG_H
+
+#include <string>
+
+//!
+//! @brief - Per-deployment flow-control settings applied to a graph file before Init
+//!
+//! Init takes the path of a text CalculatorGraphConfig, so the flow limiter and queue
+//! settings are whatever the .pbtxt says. ApplyGraphFlowOptions() rewrites the text:
+//! every FlowLimiterCalculator node gets max_in_flight / max_in_queue in its
+//! FlowLimiterCalculatorOptions (added when the node has none), and the graph-wide
+//! max_queue_size, which bounds every input stream queue, is set or added. Fields
+//! left at -1 are not touched. Comments, order and formatting of everything else are
+//! kept, so the written file still diffs cleanly against the original.
+//!
+//! WriteGraphWithFlowOptions() writes the result next to the original for Init:
+//!
+//!   GraphFlowOptions flow;
+//!   flow.m_Max_In_Flight = 2;
+//!   std::string graph_path;
+//!   if (WriteGraphWithFlowOptions("hand_tracking_desktop_live.pbtxt", flow, graph_path))
+//!       dll.m_Mediapipe_Hand_Tracking_Init(graph_path.c_str());
+//!
+
+struct GraphFlowOptions
+{
+	int m_Max_In_Flight = -1;		// frames inside the graph behind each flow limiter; -1 keeps the file's
+	int m_Max_In_Queue = -1;		// frames the flow limiter holds back instead of dropping; -1 keeps the file's
+	int m_Max_Queue_Size = -1;		// graph-wide input stream queue bound, -1 keeps the file's (0 leaves it unbounded)
+};
+
+struct GraphFlowReport
+{
+	int m_Flow_Limiters = 0;		// FlowLimiterCalculator nodes found
+	int m_Options_Added = 0;		// of those, nodes that had no FlowLimiterCalculatorOptions
+	bool m_Has_Queue_Size = false;	// the file already set max_queue_size
+};
+
+// Returns false with error set when graph_text is not well-formed enough to patch
+bool ApplyGraphFlowOptions(const std::string& graph_text, const GraphFlowOptions& options, std::string& patched_text, GraphFlowReport& report, std::string& error);
+
+// Reads graph_path, patches it and writes <graph_path without .pbtxt>.flow.pbtxt; output_path receives that path
+bool WriteGraphWithFlowOptions(const std::string& graph_path, const GraphFlowOptions& options, std::string& output_path, GraphFlowReport* report = nullptr, std::string* error = nullptr);
+
+#endif // !GRAPH_FLOW_CONFIG_H
@@ -0,0 +1,215 @@
+#include "HandTrackAssigner.h"
+
+#include <algorithm>
+
+namespace
+{
+	struct Box
+	{
+		float m_Min_X;
+		float m_Min_Y;
+		float m_Max_X;
+		float m_Max_Y;
+	};
+
+	float Iou(const Box& a, const Box& b)
+	{
+		float w = std::min(a.m_Max_X, b.m_Max_X) - std::max(a.m_Min_X, b.m_Min_X);
+		float h = std::min(a.m_Max_Y, b.m_Max_Y) - std::max(a.m_Min_Y, b.m_Min_Y);
+		if (w <= 0.0f || h <= 0.0f)
+		{
+			return 0.0f;
+		}
+		float overlap = w * h;
+		float areaA = (a.m_Max_X - a.m_Min_X) * (a.m_Max_Y - a.m_Min_Y);
+		float areaB = (b.m_Max_X - b.m_Min_X) * (b.m_Max_Y - b.m_Min_Y);
+		return overlap / (areaA + areaB - overlap);
+	}
+}
+
+HandTrackAssigner::HandTrackAssigner(const HandTrackAssignerOptions& options)
+	: m_Options(options)
+	, m_NextTrackId(0)
+{
+	m_Options.m_Landmarks_Per_Hand = std::max(1, m_Options.m_Landmarks_Per_Hand);
+	m_Options.m_Max_Tracks = std::max(1, m_Options.m_Max_Tracks);
+	m_Options.m_Max_Missed_Frames = std::max(0, m_Options.m_Max_Missed_Frames);
+	m_Tracks.reserve(m_Options.m_Max_Tracks);
+	m_SlotUsed.assign(m_Options.m_Max_Tracks, false);
+}
+
+HandTrackAssigner::~HandTrackAssigner()
+{
+}
+
+int HandTrackAssigner::Update(const PoseInfo* landmarks, int count)
+{
+	int hands = (landmarks != nullptr && count > 0) ? count / m_Options.m_Landmarks_Per_Hand : 0;
+	hands = std::min(hands, m_Options.m_Max_Tracks);
+
+	std::vector<Box> boxes(hands);
+	for (int h = 0; h < hands; ++h)
+	{
+		const PoseInfo* points = landmarks + h * m_Options.m_Landmarks_Per_Hand;
+		Box& box = boxes[h];
+		box.m_Min_X = box.m_Max_X = points[0].x;
+		box.m_Min_Y = box.m_Max_Y = points[0].y;
+		for (int i = 1; i < m_Options.m_Landmarks_Per_Hand; ++i)
+		{
+			box.m_Min_X = std::min(box.m_Min_X, points[i].x);
+			box.m_Min_Y = std::min(box.m_Min_Y, points[i].y);
+			box.m_Max_X = std::max(box.m_Max_X, points[i].x);
+			box.m_Max_Y = std::max(box.m_Max_Y, points[i].y);
+		}
+	}
+
+	// every (track, hand) pair that overlaps enough, best first
+	struct Candidate
+	{
+		float m_Iou;
+		int m_Track;
+		int m_Hand;
+	};
+	std::vector<Candidate> candidates;
+	for (int t = 0; t < (int)m_Tracks.size(); ++t)
+	{
+		const HandTrack& track = m_Tracks[t];
+		Box predicted = { track.m_Min_X + track.m_Velocity_X, track.m_Min_Y + track.m_Velocity_Y,
+			track.m_Max_X + track.m_Velocity_X, track.m_Max_Y + track.m_Velocity_Y };
+		for (int h = 0; h < hands; ++h)
+		{
+			float iou = Iou(predicted, boxes[h]);
+			if (iou >= m_Options.m_Min_Iou)
+			{
+				candidates.push_back({ iou, t, h });
+			}
+		}
+	}
+	std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) { return a.m_Iou > b.m_Iou; });
+
+	for (HandTrack& track : m_Tracks)
+	{
+		track.m_Hand_Index = -1;
+		track.m_Is_New = false;
+	}
+	m_HandTracks.assign(hands, -1);
+	for (const Candidate& candidate : candidates)
+	{
+		HandTrack& track = m_Tracks[candidate.m_Track];
+		if (track.m_Hand_Index >= 0 || m_HandTracks[candidate.m_Hand] >= 0)
+		{
+			continue;
+		}
+		track.m_Hand_Index = candidate.m_Hand;
+		m_HandTracks[candidate.m_Hand] = candidate.m_Track;
+	}
+
+	// unmatched tracks age out; their slots are freed for new hands
+	for (size_t t = 0; t < m_Tracks.size();)
+	{
+		HandTrack& track = m_Tracks[t];
+		if (track.m_Hand_Index < 0 && ++track.m_Missed_Frames > m_Options.m_Max_Missed_Frames)
+		{
+			m_SlotUsed[track.m_State_Slot] = false;
+			m_Tracks.erase(m_Tracks.begin() + t);
+			for (int& index : m_HandTracks)
+			{
+				index = index > (int)t ? index - 1 : index;
+			}
+			continue;
+		}
+		++t;
+	}
+
+	for (int h = 0; h < hands; ++h)
+	{
+		if (m_HandTracks[h] >= 0)
+		{
+			continue;
+		}
+		int slot = (int)(std::find(m_SlotUsed.begin(), m_SlotUsed.end(), false) - m_SlotUsed.begin());
+		if (slot >= m_Options.m_Max_Tracks)
+		{
+			// every slot is held by a missed track: the oldest miss gives way
+			size_t victim = m_Tracks.size();
+			for (size_t t = 0; t < m_Tracks.size(); ++t)
+			{
+				if (m_Tracks[t].m_Hand_Index < 0 && (victim == m_Tracks.size() || m_Tracks[t].m_Missed_Frames > m_Tracks[victim].m_Missed_Frames))
+				{
+					victim = t;
+				}
+			}
+			if (victim == m_Tracks.size())
+			{
+				continue;
+			}
+			slot = m_Tracks[victim].m_State_Slot;
+			m_Tracks.erase(m_Tracks.begin() + victim);
+			for (int& index : m_HandTracks)
+			{
+				index = index > (int)victim ? index - 1 : index;
+			}
+		}
+
+		HandTrack track;
+		track.m_Track_Id = m_NextTrackId++;
+		track.m_State_Slot = slot;
+		track.m_Hand_Index = h;
+		track.m_Is_New = true;
+		track.m_Min_X = boxes[h].m_Min_X;
+		track.m_Min_Y = boxes[h].m_Min_Y;
+		track.m_Max_X = boxes[h].m_Max_X;
+		track.m_Max_Y = boxes[h].m_Max_Y;
+		m_SlotUsed[slot] = true;
+		m_HandTracks[h] = (int)m_Tracks.size();
+		m_Tracks.push_back(track);
+	}
+
+	for (HandTrack& track : m_Tracks)
+	{
+		++track.m_Age_Frames;
+		if (track.m_Hand_Index < 0 || track.m_Is_New)
+		{
+			continue;
+		}
+		const Box& box = boxes[track.m_Hand_Index];
+		track.m_Velocity_X = ((box.m_Min_X + box.m_Max_X) - (track.m_Min_X + track.m_Max_X)) * 0.5f;
+		track.m_Velocity_Y = ((box.m_Min_Y + box.m_Max_Y) - (track.m_Min_Y + track.m_Max_Y)) * 0.5f;
+		track.m_Min_X = box.m_Min_X;
+		track.m_Min_Y = box.m_Min_Y;
+		track.m_Max_X = box.m_Max_X;
+		track.m_Max_Y = box.m_Max_Y;
+		track.m_Missed_Frames = 0;
+	}
+	return hands;
+}
+
+int HandTrackAssigner::GetTrackId(int hand_index)
+{
+	if (hand_index < 0 || hand_index >= (int)m_HandTracks.size() || m_HandTracks[hand_index] < 0)
+	{
+		return -1;
+	}
+	return m_Tracks[m_HandTracks[hand_index]].m_Track_Id;
+}
+
+int HandTrackAssigner::GetStateSlot(int hand_index)
+{
+	if (hand_index < 0 || hand_index >= (int)m_HandTracks.size() || m_HandTracks[hand_index] < 0)
+	{
+		return -1;
+	}
+	return m_Tracks[m_HandTracks[hand_index]].m_State_Slot;
+}
+
+const std::vector<HandTrack>& HandTrackAssigner::GetTracks()
+{
+	return m_Tracks;
+}
+
+void HandTrackAssigner::Reset()
+{
+	m_Tracks.clear();
+	m_HandTracks.clear();
+	m_SlotUsed.assign(m_Options.m_Max_Tracks, false);
+}
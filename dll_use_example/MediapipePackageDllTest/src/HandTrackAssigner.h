@@ -0,0 +1,76 @@
+#ifndef HAND_TRACK_ASSIGNER_H
+#define HAND_TRACK_ASSIGNER_H
+
+#include <vector>
+
+#include "MediapipeHandTrackingDll.h"
+
+//!
+//! @brief - Gives the hands in the landmark callback IDs that survive reordering
+//!
+//! The DLL reports the hands of a frame one after another (m_Landmarks_Per_Hand
+//! points each) in whatever order the graph produced them, and that order can change
+//! from one frame to the next. Update() matches every hand to the tracks of the
+//! previous frame by the overlap (IoU) of the landmark bounding boxes, with each track
+//! box moved by its last displacement first, and keeps the ID of the matched track.
+//! Matching is greedy on the highest overlaps, which is exact for two hands.
+//!
+//! Every track also owns one of m_Max_Tracks state slots for as long as it lives, so
+//! per-hand state (gesture debouncing, smoothing filters, IK warm starts) can live in
+//! a caller array indexed by m_State_Slot. m_Is_New tells the caller to reset that
+//! slot. A track that is unmatched keeps its ID and slot for m_Max_Missed_Frames
+//! frames, so a hand lost for a frame or two comes back with its state.
+//!
+
+struct HandTrackAssignerOptions
+{
+	int m_Landmarks_Per_Hand = 21;
+	int m_Max_Tracks = 2;
+	float m_Min_Iou = 0.1f;				// below this a hand starts a new track
+	int m_Max_Missed_Frames = 5;
+};
+
+struct HandTrack
+{
+	int m_Track_Id = -1;				// increases from 0, never reused
+	int m_State_Slot = -1;				// 0 .. m_Max_Tracks - 1
+	int m_Hand_Index = -1;				// position in this frame's landmarks, -1 while missed
+	bool m_Is_New = false;				// first frame of this track: reset the slot's state
+	int m_Age_Frames = 0;
+	int m_Missed_Frames = 0;
+	float m_Min_X = 0.0f;
+	float m_Min_Y = 0.0f;
+	float m_Max_X = 0.0f;
+	float m_Max_Y = 0.0f;
+	float m_Velocity_X = 0.0f;			// box displacement over the last matched frame
+	float m_Velocity_Y = 0.0f;
+};
+
+class HandTrackAssigner
+{
+public:
+	HandTrackAssigner(const HandTrackAssignerOptions& options = HandTrackAssignerOptions());
+	virtual~HandTrackAssigner();
+
+public:
+	// landmarks/count as given to the landmark callback; call once per frame, also with count 0
+	// when no hand was found. Returns the number of hands in the frame.
+	int Update(const PoseInfo* landmarks, int count);
+
+	// Track ID of the hand_index-th hand of the last Update, -1 when out of range
+	int GetTrackId(int hand_index);
+	// State slot of the hand_index-th hand of the last Update, -1 when out of range
+	int GetStateSlot(int hand_index);
+	// Live tracks, matched and missed
+	const std::vector<HandTrack>& GetTracks();
+	void Reset();
+
+private:
+	HandTrackAssignerOptions m_Options;
+	std::vector<HandTrack> m_Tracks;
+	std::vector<int> m_HandTracks;		// hand index -> position in m_Tracks
+	std::vector<bool> m_SlotUsed;
+	int m_NextTrackId;
+};
+
+#endif // !HAND_TRACK_ASSIGNER_H
@@ -0,0 +1,50 @@
+#include "IdleThrottle.h"
+
+IdleThrottle::IdleThrottle(const IdleThrottleOptions& options)
+	: m_Options(options)
+	, m_HasRun(false)
+	, m_IsIdle(false)
+{
+}
+
+IdleThrottle::~IdleThrottle()
+{
+}
+
+bool IdleThrottle::ShouldRun()
+{
+	if (m_Options.m_Idle_After_Ms <= 0 || !m_HasRun)
+	{
+		return true;
+	}
+
+	Clock::time_point now = Clock::now();
+	if (!m_IsIdle && now - m_LastPresence >= std::chrono::milliseconds(m_Options.m_Idle_After_Ms))
+	{
+		m_IsIdle = true;
+	}
+	return !m_IsIdle || now - m_LastRun >= std::chrono::milliseconds(m_Options.m_Poll_Interval_Ms);
+}
+
+void IdleThrottle::ReportResult(bool found_something)
+{
+	Clock::time_point now = Clock::now();
+	if (!m_HasRun || found_something)
+	{
+		m_LastPresence = now;
+		m_IsIdle = false;
+	}
+	m_LastRun = now;
+	m_HasRun = true;
+}
+
+bool IdleThrottle::IsIdle()
+{
+	return m_IsIdle;
+}
+
+void IdleThrottle::Reset()
+{
+	m_HasRun = false;
+	m_IsIdle = false;
+}
@@ -0,0 +1,44 @@
+#ifndef IDLE_THROTTLE_H
+#define IDLE_THROTTLE_H
+
+#include <chrono>
+
+//!
+//! @brief - Drops to a low polling rate after nothing has been detected for a while
+//!
+//! Once no hand or person has been found for m_Idle_After_Ms, only one frame per
+//! m_Poll_Interval_Ms is let through to the graph. The first poll that finds
+//! something wakes it up again, so waking takes at most one poll interval.
+//!
+
+struct IdleThrottleOptions
+{
+	int m_Idle_After_Ms = 0;		// 0 disables idle mode
+	int m_Poll_Interval_Ms = 500;
+};
+
+class IdleThrottle
+{
+public:
+	IdleThrottle(const IdleThrottleOptions& options = IdleThrottleOptions());
+	virtual~IdleThrottle();
+
+public:
+	// true when the current frame should be run
+	bool ShouldRun();
+	// called after every frame that was run
+	void ReportResult(bool found_something);
+	bool IsIdle();
+	void Reset();
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	IdleThrottleOptions m_Options;
+	Clock::time_point m_LastPresence;
+	Clock::time_point m_LastRun;
+	bool m_HasRun;
+	bool m_IsIdle;
+};
+
+#endif // !IDLE_THROTTLE_H
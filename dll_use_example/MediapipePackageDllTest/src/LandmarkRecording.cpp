@@ -0,0 +1,354 @@
+#include "LandmarkRecording.h"
+
+#include <cerrno>
+#include <cstring>
+
+#if defined(LINUX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	// recordings run past 2 GB; plain fseek takes a long, which is 32-bit on Windows
+	int SeekFile(FILE* file, uint64_t offset, int origin)
+	{
+#if defined(WINDOWS)
+		return _fseeki64(file, (long long)offset, origin);
+#else
+		return fseeko(file, (off_t)offset, origin);
+#endif
+	}
+
+	uint64_t TellFile(FILE* file)
+	{
+#if defined(WINDOWS)
+		return (uint64_t)_ftelli64(file);
+#else
+		return (uint64_t)ftello(file);
+#endif
+	}
+
+	LandmarkRecordingHeader MakeHeader()
+	{
+		LandmarkRecordingHeader header;
+		memset(&header, 0, sizeof(header));
+		header.m_Magic = LANDMARK_RECORDING_MAGIC;
+		header.m_Version = LANDMARK_RECORDING_VERSION;
+		header.m_Byte_Order_Mark = LANDMARK_RECORDING_BYTE_ORDER_MARK;
+		header.m_Record_Bytes = sizeof(LandmarkRecord);
+		header.m_Max_Landmarks = LANDMARK_RECORDING_MAX_LANDMARKS;
+		header.m_Max_Gestures = LANDMARK_RECORDING_MAX_GESTURES;
+		return header;
+	}
+
+	bool IsCompatibleHeader(const LandmarkRecordingHeader& header)
+	{
+		LandmarkRecordingHeader expected = MakeHeader();
+		return header.m_Magic == expected.m_Magic
+			&& header.m_Version == expected.m_Version
+			&& header.m_Byte_Order_Mark == expected.m_Byte_Order_Mark
+			&& header.m_Record_Bytes == expected.m_Record_Bytes
+			&& header.m_Max_Landmarks == expected.m_Max_Landmarks
+			&& header.m_Max_Gestures == expected.m_Max_Gestures;
+	}
+}
+
+LandmarkRecord::LandmarkRecord()
+{
+	// zero the padding too, so recordings of the same session are byte-identical
+	memset((void*)this, 0, sizeof(*this));
+	m_Landmark_Count = -1;
+	m_Gesture_Count = -1;
+	m_Gesture_Result = GestureRecognitionResult();
+}
+
+bool LandmarkRecord::SetLandmarks(const PoseInfo* infos, int count)
+{
+	if (count > LANDMARK_RECORDING_MAX_LANDMARKS)
+	{
+		return false;
+	}
+	int copyCount = infos == nullptr || count < 0 ? 0 : count;
+	memcpy(m_Landmarks, infos, copyCount * sizeof(PoseInfo));
+	m_Landmark_Count = copyCount;
+	return true;
+}
+
+bool LandmarkRecord::SetGestures(const int* recogn_result, int count)
+{
+	if (count > LANDMARK_RECORDING_MAX_GESTURES)
+	{
+		return false;
+	}
+	int copyCount = recogn_result == nullptr || count < 0 ? 0 : count;
+	memcpy(m_Gestures, recogn_result, copyCount * sizeof(int));
+	m_Gesture_Count = copyCount;
+	return true;
+}
+
+LandmarkRecorder::LandmarkRecorder()
+	: m_File(nullptr)
+	, m_FrameCount(0)
+{
+}
+
+LandmarkRecorder::~LandmarkRecorder()
+{
+	Close();
+}
+
+bool LandmarkRecorder::Open(const std::string& path)
+{
+	Close();
+
+	m_File = fopen(path.c_str(), "r+b");
+	if (m_File != nullptr)
+	{
+		LandmarkRecordingHeader header;
+		if (fread(&header, sizeof(header), 1, m_File) == 1 && IsCompatibleHeader(header))
+		{
+			SeekFile(m_File, 0, SEEK_END);
+			m_FrameCount = (TellFile(m_File) - sizeof(header)) / sizeof(LandmarkRecord);
+			// a torn record from an interrupted session is overwritten by the next append
+			SeekFile(m_File, sizeof(header) + m_FrameCount * sizeof(LandmarkRecord), SEEK_SET);
+			return true;
+		}
+		// not a recording this build can append to; leave it as it is
+		Close();
+		return false;
+	}
+	if (errno != ENOENT)
+	{
+		// there may be a file we just cannot open; "wb" would truncate it
+		return false;
+	}
+
+	m_File = fopen(path.c_str(), "wb");
+	if (m_File == nullptr)
+	{
+		return false;
+	}
+	LandmarkRecordingHeader header = MakeHeader();
+	if (fwrite(&header, sizeof(header), 1, m_File) != 1)
+	{
+		Close();
+		return false;
+	}
+	m_FrameCount = 0;
+	return true;
+}
+
+bool LandmarkRecorder::Append(const LandmarkRecord& record)
+{
+	if (m_File == nullptr || fwrite(&record, sizeof(record), 1, m_File) != 1)
+	{
+		return false;
+	}
+	++m_FrameCount;
+	return true;
+}
+
+bool LandmarkRecorder::Flush()
+{
+	return m_File != nullptr && fflush(m_File) == 0;
+}
+
+void LandmarkRecorder::Close()
+{
+	if (m_File != nullptr)
+	{
+		fclose(m_File);
+		m_File = nullptr;
+	}
+	m_FrameCount = 0;
+}
+
+LandmarkReplay::LandmarkReplay()
+	: m_Data(nullptr)
+	, m_Size(0)
+	, m_FrameCount(0)
+	, m_IsWritable(false)
+#if defined(WINDOWS)
+	, m_File(INVALID_HANDLE_VALUE)
+	, m_Mapping(NULL)
+#endif
+{
+}
+
+LandmarkReplay::~LandmarkReplay()
+{
+	Close();
+}
+
+bool LandmarkReplay::Open(const std::string& path, bool is_writable)
+{
+	Close();
+
+#if defined(WINDOWS)
+	m_File = CreateFileA(path.c_str(), is_writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (m_File == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(m_File, &fileSize) || fileSize.QuadPart < (LONGLONG)sizeof(LandmarkRecordingHeader))
+	{
+		Close();
+		return false;
+	}
+	m_Mapping = CreateFileMappingA(m_File, NULL, is_writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, NULL);
+	if (m_Mapping == NULL)
+	{
+		Close();
+		return false;
+	}
+	m_Data = (const unsigned char*)MapViewOfFile(m_Mapping, is_writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0);
+	m_Size = (size_t)fileSize.QuadPart;
+#elif defined(LINUX)
+	int fd = open(path.c_str(), is_writable ? O_RDWR : O_RDONLY);
+	if (fd < 0)
+	{
+		return false;
+	}
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) != 0 || fileStat.st_size < (off_t)sizeof(LandmarkRecordingHeader))
+	{
+		close(fd);
+		return false;
+	}
+	void* data = mmap(nullptr, (size_t)fileStat.st_size, is_writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED)
+	{
+		return false;
+	}
+	// replay typically walks the session front to back
+	madvise(data, (size_t)fileStat.st_size, MADV_SEQUENTIAL);
+	m_Data = (const unsigned char*)data;
+	m_Size = (size_t)fileStat.st_size;
+#endif
+	if (m_Data == nullptr)
+	{
+		Close();
+		return false;
+	}
+
+	LandmarkRecordingHeader header;
+	memcpy(&header, m_Data, sizeof(header));
+	if (!IsCompatibleHeader(header))
+	{
+		Close();
+		return false;
+	}
+	m_FrameCount = (m_Size - sizeof(header)) / sizeof(LandmarkRecord);
+	m_IsWritable = is_writable;
+	return true;
+}
+
+void LandmarkReplay::Close()
+{
+#if defined(WINDOWS)
+	if (m_Data != nullptr)
+	{
+		UnmapViewOfFile(m_Data);
+	}
+	if (m_Mapping != NULL)
+	{
+		CloseHandle(m_Mapping);
+		m_Mapping = NULL;
+	}
+	if (m_File != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(m_File);
+		m_File = INVALID_HANDLE_VALUE;
+	}
+#elif defined(LINUX)
+	if (m_Data != nullptr)
+	{
+		munmap((void*)m_Data, m_Size);
+	}
+#endif
+	m_Data = nullptr;
+	m_Size = 0;
+	m_FrameCount = 0;
+	m_IsWritable = false;
+}
+
+bool LandmarkReplay::Flush()
+{
+	if (m_Data == nullptr || !m_IsWritable)
+	{
+		return false;
+	}
+#if defined(WINDOWS)
+	return FlushViewOfFile(m_Data, 0) != 0 && FlushFileBuffers(m_File) != 0;
+#elif defined(LINUX)
+	return msync((void*)m_Data, m_Size, MS_SYNC) == 0;
+#else
+	return false;
+#endif
+}
+
+const LandmarkRecord* LandmarkReplay::GetFrame(uint64_t index)
+{
+	if (index >= m_FrameCount)
+	{
+		return nullptr;
+	}
+	return (const LandmarkRecord*)(m_Data + sizeof(LandmarkRecordingHeader) + index * sizeof(LandmarkRecord));
+}
+
+LandmarkRecord* LandmarkReplay::GetMutableFrame(uint64_t index)
+{
+	if (!m_IsWritable)
+	{
+		return nullptr;
+	}
+	return (LandmarkRecord*)GetFrame(index);
+}
+
+uint64_t LandmarkReplay::FindFrame(int64_t timestamp_us)
+{
+	uint64_t low = 0;
+	uint64_t high = m_FrameCount;
+	while (low < high)
+	{
+		uint64_t middle = low + (high - low) / 2;
+		if (GetFrame(middle)->m_Timestamp_Us < timestamp_us)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+	return low;
+}
+
+bool ReanalyzeLandmarkRecording(const std::string& path, const std::function<bool(LandmarkRecord& record)>& reanalyze, uint64_t* changed_count)
+{
+	LandmarkReplay replay;
+	if (!reanalyze || !replay.Open(path, true))
+	{
+		return false;
+	}
+
+	// in order, so stateful rules (smoothing, hysteresis) see the session as it happened
+	uint64_t changedCount = 0;
+	for (uint64_t i = 0; i < replay.GetFrameCount(); ++i)
+	{
+		if (reanalyze(*replay.GetMutableFrame(i)))
+		{
+			++changedCount;
+		}
+	}
+	if (changed_count != nullptr)
+	{
+		*changed_count = changedCount;
+	}
+	return changedCount == 0 || replay.Flush();
+}
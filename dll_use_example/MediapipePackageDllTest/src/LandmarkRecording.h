@@ -0,0 +1,120 @@
+#ifndef LANDMARK_RECORDING_H
+#define LANDMARK_RECORDING_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <functional>
+
+#include "MediapipeHandTrackingDll.h"
+
+//!
+//! @brief - Fixed-stride binary recording of per-frame tracking results
+//!
+//! The file is a LandmarkRecordingHeader followed by LandmarkRecord entries of
+//! identical size, so frame i lives at sizeof(header) + i * record_bytes. The
+//! recorder appends; LandmarkReplay maps the file and returns frames by index or
+//! timestamp without parsing anything, which lets analytics jobs re-run gesture
+//! and IK logic over a session at memory speed.
+//!
+//! A replay opened writable can also update records in place, e.g. to store the
+//! output of revised gesture rules without re-running inference (see
+//! ReanalyzeLandmarkRecording).
+//!
+//! Records are written in the host's byte order; the header stores the record size
+//! and an endianness marker so a mismatched file is rejected rather than misread.
+//!
+
+#define LANDMARK_RECORDING_MAGIC 0x5243524D		// "MRCR"
+#define LANDMARK_RECORDING_VERSION 2
+#define LANDMARK_RECORDING_BYTE_ORDER_MARK 0x01020304
+#define LANDMARK_RECORDING_MAX_LANDMARKS (HAND_KEYPOINT_COUNT * MAX_HAND_COUNT)
+#define LANDMARK_RECORDING_MAX_GESTURES MAX_HAND_COUNT		// one per hand; also holds the four holistic results
+
+struct LandmarkRecordingHeader
+{
+	uint32_t m_Magic;
+	uint32_t m_Version;
+	uint32_t m_Byte_Order_Mark;
+	uint32_t m_Record_Bytes;
+	uint32_t m_Max_Landmarks;
+	uint32_t m_Max_Gestures;
+	uint64_t m_Reserved;
+};
+
+struct LandmarkRecord
+{
+	int64_t m_Timestamp_Us;		// caller's clock, expected to increase
+	int32_t m_Image_Index;
+	int32_t m_Landmark_Count;	// -1 when no landmarks were delivered for the frame
+	PoseInfo m_Landmarks[LANDMARK_RECORDING_MAX_LANDMARKS];
+	int32_t m_Gesture_Count;	// -1 when no gesture result was delivered for the frame
+	int32_t m_Gestures[LANDMARK_RECORDING_MAX_GESTURES];
+	GestureRecognitionResult m_Gesture_Result;
+
+	LandmarkRecord();
+	// false, and the record unchanged, when count is over the capacity above
+	bool SetLandmarks(const PoseInfo* infos, int count);
+	bool SetGestures(const int* recogn_result, int count);
+};
+
+class LandmarkRecorder
+{
+public:
+	LandmarkRecorder();
+	virtual~LandmarkRecorder();
+
+public:
+	// Appends to an existing recording with a matching layout and creates a missing one;
+	// fails on any other existing file rather than overwriting it
+	bool Open(const std::string& path);
+	bool Append(const LandmarkRecord& record);
+	bool Flush();
+	void Close();
+
+	uint64_t GetFrameCount() { return m_FrameCount; }
+
+private:
+	FILE* m_File;
+	uint64_t m_FrameCount;
+};
+
+class LandmarkReplay
+{
+public:
+	LandmarkReplay();
+	virtual~LandmarkReplay();
+
+public:
+	// is_writable maps the file read-write for GetMutableFrame
+	bool Open(const std::string& path, bool is_writable = false);
+	void Close();
+	// Writes modified records back to disk; Close also does this, lazily
+	bool Flush();
+
+	uint64_t GetFrameCount() { return m_FrameCount; }
+	// nullptr past the end; the pointer stays valid until Close
+	const LandmarkRecord* GetFrame(uint64_t index);
+	// nullptr past the end or when opened read-only; changes land in the file
+	LandmarkRecord* GetMutableFrame(uint64_t index);
+	// Index of the first frame with m_Timestamp_Us >= timestamp_us, GetFrameCount() if none
+	uint64_t FindFrame(int64_t timestamp_us);
+
+private:
+	const unsigned char* m_Data;
+	size_t m_Size;
+	uint64_t m_FrameCount;
+	bool m_IsWritable;
+#if defined(WINDOWS)
+	HANDLE m_File;
+	HANDLE m_Mapping;
+#endif
+};
+
+// Runs reanalyze over every record of a session in order and writes the records back in
+// place. Meant for downstream logic that only needs the stored landmarks (gesture
+// rules, arm up/down, IK); reanalyze returns true when it changed the record.
+// changed_count is optional.
+bool ReanalyzeLandmarkRecording(const std::string& path, const std::function<bool(LandmarkRecord& record)>& reanalyze, uint64_t* changed_count = nullptr);
+
+#endif // !LANDMARK_RECORDING_H
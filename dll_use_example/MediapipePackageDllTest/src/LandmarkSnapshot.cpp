@@ -0,0 +1,125 @@
+#include "LandmarkSnapshot.h"
+
+#include <thread>
+
+LandmarkSnapshot::LandmarkSnapshot(int capacity)
+	: m_Capacity(capacity > 0 ? capacity : 1)
+	, m_Sequence(0)
+	, m_ImageIndex(-1)
+	, m_Count(0)
+	, m_Coordinates(new std::atomic<float>[m_Capacity * 2])
+{
+	m_Gestures[0].store(-1, std::memory_order_relaxed);
+	m_Gestures[1].store(-1, std::memory_order_relaxed);
+	for (int i = 0; i < m_Capacity * 2; ++i)
+	{
+		m_Coordinates[i].store(0.0f, std::memory_order_relaxed);
+	}
+}
+
+LandmarkSnapshot::~LandmarkSnapshot()
+{
+}
+
+void LandmarkSnapshot::PublishLandmarks(int image_index, const PoseInfo* infos, int count)
+{
+	int validCount = infos == nullptr || count < 0 ? 0 : (count < m_Capacity ? count : m_Capacity);
+	BeginWrite();
+	for (int i = 0; i < validCount; ++i)
+	{
+		m_Coordinates[i * 2].store(infos[i].x, std::memory_order_relaxed);
+		m_Coordinates[i * 2 + 1].store(infos[i].y, std::memory_order_relaxed);
+	}
+	m_Count.store(validCount, std::memory_order_relaxed);
+	m_ImageIndex.store(image_index, std::memory_order_relaxed);
+	EndWrite();
+}
+
+void LandmarkSnapshot::PublishGestures(int image_index, const int* recogn_result, int count)
+{
+	(void)image_index;
+	BeginWrite();
+	m_Gestures[0].store(recogn_result != nullptr && count > 0 ? recogn_result[0] : -1, std::memory_order_relaxed);
+	m_Gestures[1].store(recogn_result != nullptr && count > 1 ? recogn_result[1] : -1, std::memory_order_relaxed);
+	EndWrite();
+}
+
+bool LandmarkSnapshot::Read(LandmarkSnapshotFrame& frame)
+{
+	if ((int)frame.m_Landmarks.size() < m_Capacity)
+	{
+		frame.m_Landmarks.resize(m_Capacity);
+	}
+
+	for (int attempt = 0; ; ++attempt)
+	{
+		unsigned int before = m_Sequence.load(std::memory_order_acquire);
+		if (before == 0)
+		{
+			return false;
+		}
+		if ((before & 1) == 0)
+		{
+			int count = m_Count.load(std::memory_order_relaxed);
+			for (int i = 0; i < count; ++i)
+			{
+				frame.m_Landmarks[i].x = m_Coordinates[i * 2].load(std::memory_order_relaxed);
+				frame.m_Landmarks[i].y = m_Coordinates[i * 2 + 1].load(std::memory_order_relaxed);
+			}
+			int imageIndex = m_ImageIndex.load(std::memory_order_relaxed);
+			int firstGesture = m_Gestures[0].load(std::memory_order_relaxed);
+			int secondGesture = m_Gestures[1].load(std::memory_order_relaxed);
+
+			// orders the loads above before the re-check of the sequence
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (m_Sequence.load(std::memory_order_relaxed) == before)
+			{
+				frame.m_Image_Index = imageIndex;
+				frame.m_Count = count;
+				frame.m_Sequence = before;
+				frame.m_Gestures[0] = firstGesture;
+				frame.m_Gestures[1] = secondGesture;
+				return true;
+			}
+		}
+		// a publish takes well under a microsecond; only a preempted writer makes us wait
+		if (attempt >= 64)
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+unsigned int LandmarkSnapshot::GetSequence()
+{
+	return m_Sequence.load(std::memory_order_acquire);
+}
+
+int LandmarkSnapshot::GetCapacity()
+{
+	return m_Capacity;
+}
+
+void LandmarkSnapshot::BeginWrite()
+{
+	// the landmark and gesture callbacks may run on different DLL threads; taking the
+	// sequence from even to odd is what lets one publish at a time
+	unsigned int sequence = m_Sequence.load(std::memory_order_relaxed);
+	for (int attempt = 0; (sequence & 1) != 0 || !m_Sequence.compare_exchange_weak(sequence, sequence + 1, std::memory_order_acquire, std::memory_order_relaxed); ++attempt)
+	{
+		// as in Read, the other publish is only slow if its thread was preempted
+		if (attempt >= 64)
+		{
+			std::this_thread::yield();
+		}
+		sequence = m_Sequence.load(std::memory_order_relaxed);
+	}
+	// keeps the payload stores below from moving above the odd sequence
+	std::atomic_thread_fence(std::memory_order_release);
+}
+
+void LandmarkSnapshot::EndWrite()
+{
+	// no other publisher can touch the sequence while it is odd
+	m_Sequence.store(m_Sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
@@ -0,0 +1,66 @@
+#ifndef LANDMARK_SNAPSHOT_H
+#define LANDMARK_SNAPSHOT_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "MediapipeHandTrackingDll.h"
+
+//!
+//! @brief - Landmark snapshot that readers copy without locks or tearing
+//!
+//! The DLL's landmark callback (on the DLL's thread, or on MediapipeHandTrackingAsync's
+//! worker) calls Publish; a render loop calls Read whenever it draws. Publish never
+//! waits for readers, and Read retries until it has copied a set that was not being
+//! overwritten, so a reader always sees the landmarks of exactly one frame.
+//!
+//! This is the seqlock pattern: the sequence is odd while Publish is writing, and a
+//! copy is only accepted if the sequence was even and unchanged across it. The
+//! coordinates are stored as relaxed atomics so the concurrent copy is well defined.
+//! The DLL's callback contract (see MediapipeHandTrackingDll.h) already keeps its
+//! publishes from overlapping. Publishers still serialize on the sequence itself: one
+//! that finds it odd spins until the other publish is done, so a snapshot fed by more
+//! than one tracker stays consistent too.
+//!
+
+struct LandmarkSnapshotFrame
+{
+	int m_Image_Index = -1;
+	int m_Count = 0;						// valid entries of m_Landmarks
+	unsigned int m_Sequence = 0;			// changes with every publish
+	int m_Gestures[2] = { -1, -1 };
+	std::vector<PoseInfo> m_Landmarks;		// sized by Read, reused across calls
+};
+
+class LandmarkSnapshot
+{
+public:
+	explicit LandmarkSnapshot(int capacity = 21 * 6);
+	virtual~LandmarkSnapshot();
+
+public:
+	// Writer side; concurrent publishes run one after the other. count is clamped to the capacity.
+	void PublishLandmarks(int image_index, const PoseInfo* infos, int count);
+	void PublishGestures(int image_index, const int* recogn_result, int count);
+
+	// Reader side, any number of threads; false until something was published
+	bool Read(LandmarkSnapshotFrame& frame);
+	// Cheap check for "anything new since frame was read"
+	unsigned int GetSequence();
+	int GetCapacity();
+
+private:
+	void BeginWrite();
+	void EndWrite();
+
+private:
+	int m_Capacity;
+	std::atomic<unsigned int> m_Sequence;
+	std::atomic<int> m_ImageIndex;
+	std::atomic<int> m_Count;
+	std::atomic<int> m_Gestures[2];
+	std::unique_ptr<std::atomic<float>[]> m_Coordinates;	// x, y interleaved
+};
+
+#endif // !LANDMARK_SNAPSHOT_H
@@ -0,0 +1,325 @@
+#include "LandmarkStream.h"
+
+#include <cmath>
+#include <cstring>
+
+#if defined(WINDOWS)
+#pragma comment(lib, "ws2_32.lib")
+#elif defined(LINUX)
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	const int kCoordinatesPerHand = LANDMARK_STREAM_LANDMARKS_PER_HAND * 2;
+	const float kQuantizationScale = 16.0f;
+
+	uint16_t Quantize(float value)
+	{
+		float scaled = std::floor(value * kQuantizationScale + 0.5f);
+		if (!(scaled > 0.0f))
+		{
+			return 0;
+		}
+		return scaled >= 65535.0f ? 65535 : (uint16_t)scaled;
+	}
+
+	void PutU16(unsigned char* p, uint32_t v) { p[0] = (unsigned char)v; p[1] = (unsigned char)(v >> 8); }
+	void PutU32(unsigned char* p, uint32_t v) { PutU16(p, v & 0xFFFF); PutU16(p + 2, v >> 16); }
+	uint32_t GetU16(const unsigned char* p) { return (uint32_t)p[0] | ((uint32_t)p[1] << 8); }
+	uint32_t GetU32(const unsigned char* p) { return GetU16(p) | (GetU16(p + 2) << 16); }
+
+	// zigzag maps small magnitudes of either sign to small codes; 7 bits per byte
+	unsigned char* PutVarint(unsigned char* p, int32_t delta)
+	{
+		uint32_t code = ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+		while (code >= 0x80)
+		{
+			*p++ = (unsigned char)(code | 0x80);
+			code >>= 7;
+		}
+		*p++ = (unsigned char)code;
+		return p;
+	}
+
+	const unsigned char* GetVarint(const unsigned char* p, const unsigned char* end, int32_t& delta)
+	{
+		uint32_t code = 0;
+		for (int shift = 0; shift < 21; shift += 7)
+		{
+			if (p >= end)
+			{
+				return nullptr;
+			}
+			unsigned char byte = *p++;
+			code |= (uint32_t)(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0)
+			{
+				delta = (int32_t)(code >> 1) ^ -(int32_t)(code & 1);
+				return p;
+			}
+		}
+		return nullptr;
+	}
+}
+
+LandmarkStreamEncoder::LandmarkStreamEncoder(int keyframe_interval)
+	: m_KeyframeInterval(keyframe_interval > 0 ? keyframe_interval : 1)
+	, m_FramesSinceKeyframe(0)
+	, m_KeyframeRequested(true)
+	, m_Sequence(0)
+	, m_PreviousHandMask(0)
+{
+	memset(m_Previous, 0, sizeof(m_Previous));
+}
+
+size_t LandmarkStreamEncoder::Encode(int image_index, const PoseInfo* infos, int count, unsigned char* packet, size_t packet_capacity)
+{
+	int handCount = count / LANDMARK_STREAM_LANDMARKS_PER_HAND;
+	if (count < 0 || count % LANDMARK_STREAM_LANDMARKS_PER_HAND != 0 || handCount > LANDMARK_STREAM_MAX_HANDS
+		|| (count > 0 && infos == nullptr) || packet_capacity < LANDMARK_STREAM_MAX_PACKET_BYTES)
+	{
+		return 0;
+	}
+
+	bool isKeyframe = m_KeyframeRequested || m_FramesSinceKeyframe >= m_KeyframeInterval;
+	uint8_t handMask = (uint8_t)((1u << handCount) - 1);
+
+	PutU16(packet, LANDMARK_STREAM_MAGIC);
+	packet[2] = LANDMARK_STREAM_VERSION;
+	packet[3] = isKeyframe ? LANDMARK_STREAM_FLAG_KEYFRAME : 0;
+	PutU32(packet + 4, m_Sequence);
+	PutU32(packet + 8, (uint32_t)image_index);
+	packet[12] = handMask;
+
+	unsigned char* p = packet + LANDMARK_STREAM_HEADER_BYTES;
+	for (int hand = 0; hand < handCount; ++hand)
+	{
+		// a hand that just appeared has no reference either
+		if (isKeyframe || (m_PreviousHandMask & (1u << hand)) == 0)
+		{
+			memset(m_Previous[hand], 0, sizeof(m_Previous[hand]));
+		}
+
+		const PoseInfo* handInfos = infos + hand * LANDMARK_STREAM_LANDMARKS_PER_HAND;
+		uint16_t* previous = m_Previous[hand];
+		for (int i = 0; i < LANDMARK_STREAM_LANDMARKS_PER_HAND; ++i)
+		{
+			uint16_t x = Quantize(handInfos[i].x);
+			uint16_t y = Quantize(handInfos[i].y);
+			p = PutVarint(p, (int32_t)x - previous[2 * i]);
+			p = PutVarint(p, (int32_t)y - previous[2 * i + 1]);
+			previous[2 * i] = x;
+			previous[2 * i + 1] = y;
+		}
+	}
+
+	m_PreviousHandMask = handMask;
+	m_FramesSinceKeyframe = isKeyframe ? 1 : m_FramesSinceKeyframe + 1;
+	m_KeyframeRequested = false;
+	++m_Sequence;
+	return (size_t)(p - packet);
+}
+
+void LandmarkStreamEncoder::RequestKeyframe()
+{
+	m_KeyframeRequested = true;
+}
+
+LandmarkStreamDecoder::LandmarkStreamDecoder()
+	: m_HasReference(false)
+	, m_ExpectedSequence(0)
+	, m_PreviousHandMask(0)
+	, m_DroppedPacketCount(0)
+{
+	memset(m_Previous, 0, sizeof(m_Previous));
+}
+
+bool LandmarkStreamDecoder::Decode(const unsigned char* packet, size_t packet_size, int& image_index, std::vector<PoseInfo>& infos)
+{
+	if (packet == nullptr || packet_size < LANDMARK_STREAM_HEADER_BYTES
+		|| GetU16(packet) != LANDMARK_STREAM_MAGIC || packet[2] != LANDMARK_STREAM_VERSION)
+	{
+		++m_DroppedPacketCount;
+		return false;
+	}
+
+	bool isKeyframe = (packet[3] & LANDMARK_STREAM_FLAG_KEYFRAME) != 0;
+	uint32_t sequence = GetU32(packet + 4);
+	uint8_t handMask = packet[12];
+
+	// a lost or reordered delta frame breaks the chain until the next keyframe
+	if (!isKeyframe && (!m_HasReference || sequence != m_ExpectedSequence))
+	{
+		m_HasReference = false;
+		++m_DroppedPacketCount;
+		return false;
+	}
+
+	uint16_t decoded[LANDMARK_STREAM_MAX_HANDS][kCoordinatesPerHand];
+	const unsigned char* p = packet + LANDMARK_STREAM_HEADER_BYTES;
+	const unsigned char* end = packet + packet_size;
+	int handCount = 0;
+	for (int hand = 0; hand < LANDMARK_STREAM_MAX_HANDS; ++hand)
+	{
+		if ((handMask & (1u << hand)) == 0)
+		{
+			continue;
+		}
+		bool hasReference = !isKeyframe && (m_PreviousHandMask & (1u << hand)) != 0;
+		for (int i = 0; i < kCoordinatesPerHand; ++i)
+		{
+			int32_t delta = 0;
+			p = GetVarint(p, end, delta);
+			if (p == nullptr)
+			{
+				m_HasReference = false;
+				++m_DroppedPacketCount;
+				return false;
+			}
+			decoded[handCount][i] = (uint16_t)((hasReference ? m_Previous[hand][i] : 0) + delta);
+		}
+		++handCount;
+	}
+
+	// commit only after the whole packet parsed: a truncated one never half-updates m_Previous,
+	// it drops the reference instead, so the next frame must be a keyframe
+	infos.resize((size_t)handCount * LANDMARK_STREAM_LANDMARKS_PER_HAND);
+	int slot = 0;
+	for (int hand = 0; hand < LANDMARK_STREAM_MAX_HANDS; ++hand)
+	{
+		if ((handMask & (1u << hand)) == 0)
+		{
+			continue;
+		}
+		memcpy(m_Previous[hand], decoded[slot], sizeof(m_Previous[hand]));
+		for (int i = 0; i < LANDMARK_STREAM_LANDMARKS_PER_HAND; ++i)
+		{
+			PoseInfo& info = infos[slot * LANDMARK_STREAM_LANDMARKS_PER_HAND + i];
+			info.x = decoded[slot][2 * i] / kQuantizationScale;
+			info.y = decoded[slot][2 * i + 1] / kQuantizationScale;
+		}
+		++slot;
+	}
+
+	m_PreviousHandMask = handMask;
+	m_HasReference = true;
+	m_ExpectedSequence = sequence + 1;
+	image_index = (int)GetU32(packet + 8);
+	return true;
+}
+
+LandmarkStreamServer::LandmarkStreamServer(int keyframe_interval)
+	: m_Encoder(keyframe_interval)
+	, m_Packet(LANDMARK_STREAM_MAX_PACKET_BYTES)
+	, m_SentBytes(0)
+{
+#if defined(WINDOWS)
+	m_Socket = INVALID_SOCKET;
+#elif defined(LINUX)
+	m_Socket = -1;
+#endif
+}
+
+LandmarkStreamServer::~LandmarkStreamServer()
+{
+	Close();
+}
+
+bool LandmarkStreamServer::Open()
+{
+	Close();
+#if defined(WINDOWS)
+	WSADATA wsaData;
+	if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+	{
+		return false;
+	}
+	m_Socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (m_Socket == INVALID_SOCKET)
+	{
+		WSACleanup();
+		return false;
+	}
+#elif defined(LINUX)
+	m_Socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (m_Socket < 0)
+	{
+		return false;
+	}
+#endif
+	m_Encoder.RequestKeyframe();
+	return true;
+}
+
+void LandmarkStreamServer::Close()
+{
+#if defined(WINDOWS)
+	if (m_Socket != INVALID_SOCKET)
+	{
+		closesocket(m_Socket);
+		m_Socket = INVALID_SOCKET;
+		WSACleanup();
+	}
+#elif defined(LINUX)
+	if (m_Socket >= 0)
+	{
+		close(m_Socket);
+		m_Socket = -1;
+	}
+#endif
+}
+
+bool LandmarkStreamServer::AddDestination(const std::string& host, int port)
+{
+	addrinfo hints;
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_INET;
+	hints.ai_socktype = SOCK_DGRAM;
+
+	addrinfo* result = nullptr;
+	if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &result) != 0 || result == nullptr)
+	{
+		return false;
+	}
+	sockaddr_in address;
+	memcpy(&address, result->ai_addr, sizeof(address));
+	freeaddrinfo(result);
+
+	m_Destinations.push_back(address);
+	// the new consumer has no reference frame yet
+	m_Encoder.RequestKeyframe();
+	return true;
+}
+
+void LandmarkStreamServer::ClearDestinations()
+{
+	m_Destinations.clear();
+}
+
+bool LandmarkStreamServer::Send(int image_index, const PoseInfo* infos, int count)
+{
+	size_t packetBytes = m_Encoder.Encode(image_index, infos, count, m_Packet.data(), m_Packet.size());
+	if (packetBytes == 0)
+	{
+		return false;
+	}
+
+	bool allSent = true;
+	for (const sockaddr_in& destination : m_Destinations)
+	{
+		int sent = (int)sendto(m_Socket, (const char*)m_Packet.data(), (int)packetBytes, 0, (const sockaddr*)&destination, sizeof(destination));
+		if (sent == (int)packetBytes)
+		{
+			m_SentBytes += packetBytes;
+		}
+		else
+		{
+			allSent = false;
+		}
+	}
+	return allSent;
+}
@@ -0,0 +1,115 @@
+#ifndef LANDMARK_STREAM_H
+#define LANDMARK_STREAM_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// winsock2.h must come before the Windows.h pulled in by DynamicModuleLoader.h
+#if defined(WINDOWS) || (!defined(LINUX) && defined(_WIN32))
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <netinet/in.h>
+#endif
+
+#include "MediapipeHandTrackingDll.h"
+
+//!
+//! @brief - Compact binary wire format for per-frame hand landmarks
+//!
+//! Every packet is one frame:
+//!   magic u16 | version u8 | flags u8 | sequence u32 | image_index i32 | hand mask u8
+//! followed, for every set bit of the hand mask, by 21 landmarks of x then y.
+//! Coordinates are pixels quantized to 1/16 px in an unsigned 16-bit range
+//! (0 .. 4095.9 px). In a keyframe they are written against zero, otherwise as the
+//! difference to the same hand in the previous frame; either way as zigzag varints,
+//! so a still landmark costs two bytes and an absent hand costs one bit.
+//!
+//! The stream is meant for UDP, so a decoder that sees a gap in the sequence drops
+//! frames until the next keyframe.
+//!
+
+#define LANDMARK_STREAM_MAGIC 0x4C4D		// "ML"
+#define LANDMARK_STREAM_VERSION 1
+#define LANDMARK_STREAM_FLAG_KEYFRAME 0x01
+#define LANDMARK_STREAM_LANDMARKS_PER_HAND 21
+#define LANDMARK_STREAM_MAX_HANDS 8
+#define LANDMARK_STREAM_HEADER_BYTES 13
+#define LANDMARK_STREAM_MAX_PACKET_BYTES (LANDMARK_STREAM_HEADER_BYTES + LANDMARK_STREAM_MAX_HANDS * LANDMARK_STREAM_LANDMARKS_PER_HAND * 2 * 3)
+
+class LandmarkStreamEncoder
+{
+public:
+	LandmarkStreamEncoder(int keyframe_interval = 30);
+
+public:
+	// infos/count as delivered by LandmarksCallBack; returns the packet size, 0 on error
+	size_t Encode(int image_index, const PoseInfo* infos, int count, unsigned char* packet, size_t packet_capacity);
+	// Forces the next packet to be a keyframe, e.g. when a consumer joins
+	void RequestKeyframe();
+
+private:
+	int m_KeyframeInterval;
+	int m_FramesSinceKeyframe;
+	bool m_KeyframeRequested;
+	uint32_t m_Sequence;
+	uint8_t m_PreviousHandMask;
+	uint16_t m_Previous[LANDMARK_STREAM_MAX_HANDS][LANDMARK_STREAM_LANDMARKS_PER_HAND * 2];
+};
+
+class LandmarkStreamDecoder
+{
+public:
+	LandmarkStreamDecoder();
+
+public:
+	// Returns true and fills infos with count landmarks (hands in slot order) when the
+	// packet could be reconstructed; false for malformed packets or while waiting for a keyframe
+	bool Decode(const unsigned char* packet, size_t packet_size, int& image_index, std::vector<PoseInfo>& infos);
+	unsigned long long GetDroppedPacketCount() { return m_DroppedPacketCount; }
+
+private:
+	bool m_HasReference;
+	uint32_t m_ExpectedSequence;
+	uint8_t m_PreviousHandMask;
+	uint16_t m_Previous[LANDMARK_STREAM_MAX_HANDS][LANDMARK_STREAM_LANDMARKS_PER_HAND * 2];
+	unsigned long long m_DroppedPacketCount;
+};
+
+//!
+//! @brief - Sends encoded landmark frames to a list of UDP consumers
+//!
+//! Register Send from the landmarks callback (or a MediapipeHandTrackingCallbackDispatcher
+//! consumer) and add one destination per render node.
+//!
+class LandmarkStreamServer
+{
+public:
+	LandmarkStreamServer(int keyframe_interval = 30);
+	virtual~LandmarkStreamServer();
+
+public:
+	bool Open();
+	void Close();
+	bool AddDestination(const std::string& host, int port);
+	void ClearDestinations();
+
+	// Encodes one frame and sends it to every destination; false if encoding or any send failed
+	bool Send(int image_index, const PoseInfo* infos, int count);
+
+	unsigned long long GetSentBytes() { return m_SentBytes; }
+
+private:
+#if defined(WINDOWS)
+	SOCKET m_Socket;
+#elif defined(LINUX)
+	int m_Socket;
+#endif
+	std::vector<sockaddr_in> m_Destinations;
+	LandmarkStreamEncoder m_Encoder;
+	std::vector<unsigned char> m_Packet;
+	unsigned long long m_SentBytes;
+};
+
+#endif // !LANDMARK_STREAM_H
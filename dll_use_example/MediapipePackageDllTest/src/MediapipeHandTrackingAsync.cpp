@@ -0,0 +1,612 @@
+#include "MediapipeHandTrackingAsync.h"
+
+#include <cstring>
+
+#if defined(LINUX)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "YuvFrameConversion.h"
+
+namespace
+{
+	inline void CpuRelax()
+	{
+#if defined(WINDOWS)
+		YieldProcessor();
+#elif defined(__x86_64__) || defined(__i386__)
+		__builtin_ia32_pause();
+#elif defined(__aarch64__)
+		__asm__ __volatile__("yield");
+#endif
+	}
+}
+
+MediapipeHandTrackingAsync::MediapipeHandTrackingAsync(MediapipeHandTrackingDll& hand_tracking_dll, int queue_depth, AsyncDropPolicy drop_policy, int latency_budget_ms)
+	: m_HandTrackingDll(hand_tracking_dll)
+	, m_DropPolicy(drop_policy)
+	, m_QueueDepth(queue_depth > 0 ? queue_depth : 1)
+	, m_PendingHead(0)
+	, m_PendingCount(0)
+	, m_InFlightCount(0)
+	, m_ResultHead(0)
+	, m_ResultCount(0)
+	, m_ResultOrder(ARO_Completion)
+	, m_DroppedFrameCount(0)
+	, m_DroppedResultCount(0)
+	, m_LatencyBudget(std::chrono::milliseconds(latency_budget_ms > 0 ? latency_budget_ms : 0))
+	, m_AverageDetectUs(0.0)
+	, m_OverBudgetDroppedCount(0)
+	, m_OverBudgetLateCount(0)
+	, m_Metrics(nullptr)
+	, m_ResultSequence(0)
+	, m_ResultWaiters(0)
+	, m_IsRunning(false)
+{
+	// queued frames + the one in the graph + the one being filled by the caller
+	int slotCount = m_QueueDepth + 2;
+	m_FrameSlots.resize(slotCount);
+	m_FreeSlots.reserve(slotCount);
+	for (int i = slotCount - 1; i >= 0; --i)
+	{
+		m_FreeSlots.push_back(i);
+	}
+
+	m_PendingSlots.resize(m_QueueDepth, -1);
+	m_Results.resize(m_QueueDepth);
+}
+
+MediapipeHandTrackingAsync::~MediapipeHandTrackingAsync()
+{
+	Stop();
+}
+
+bool MediapipeHandTrackingAsync::Start()
+{
+	if (m_HandTrackingDll.m_Mediapipe_Hand_Tracking_Detect_Frame == nullptr)
+	{
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	if (m_IsRunning)
+	{
+		return true;
+	}
+
+	m_IsRunning = true;
+	m_WorkerThread = std::thread(&MediapipeHandTrackingAsync::WorkerLoop, this);
+	return true;
+}
+
+void MediapipeHandTrackingAsync::SetMetrics(TrackerMetrics* metrics)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_Metrics = metrics;
+}
+
+void MediapipeHandTrackingAsync::SetResultOrder(AsyncResultOrder order, int reorder_window, int max_delay_ms)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_ResultOrder = order;
+	m_Reorder.Reset(reorder_window > 0 ? (size_t)reorder_window : 1, std::chrono::milliseconds(max_delay_ms > 0 ? max_delay_ms : 0));
+}
+
+void MediapipeHandTrackingAsync::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (!m_IsRunning)
+		{
+			return;
+		}
+		m_IsRunning = false;
+	}
+	m_WorkAvailable.notify_all();
+	m_ResultAvailable.notify_all();
+
+	if (m_WorkerThread.joinable())
+	{
+		m_WorkerThread.join();
+	}
+
+	// frames still queued at shutdown are discarded; held-back results are released
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	while (m_PendingCount > 0)
+	{
+		m_FreeSlots.push_back(m_PendingSlots[m_PendingHead]);
+		m_PendingHead = (m_PendingHead + 1) % m_QueueDepth;
+		--m_PendingCount;
+	}
+	DrainReorderLocked(true);
+}
+
+bool MediapipeHandTrackingAsync::SubmitFrame(int image_index, int image_width, int image_height, const void* image_data, int image_stride)
+{
+	size_t rowSize = (size_t)image_width * 3;
+	size_t srcStride = image_stride > 0 ? (size_t)image_stride : rowSize;
+	if (image_data == nullptr || image_width <= 0 || image_height <= 0 || srcStride < rowSize)
+	{
+		return false;
+	}
+
+	int slotIndex = AcquireSlot(image_index);
+	if (slotIndex < 0)
+	{
+		return false;
+	}
+
+	// The copy happens outside the lock so the worker can keep dequeuing.
+	FrameSlot& slot = m_FrameSlots[slotIndex];
+	size_t imageSize = rowSize * (size_t)image_height;
+	if (slot.m_Image_Data.size() < imageSize)
+	{
+		slot.m_Image_Data.resize(imageSize);
+	}
+	if (srcStride == rowSize)
+	{
+		memcpy(slot.m_Image_Data.data(), image_data, imageSize);
+	}
+	else
+	{
+		const unsigned char* src = (const unsigned char*)image_data;
+		unsigned char* dst = slot.m_Image_Data.data();
+		for (int row = 0; row < image_height; ++row)
+		{
+			memcpy(dst + row * rowSize, src + row * srcStride, rowSize);
+		}
+	}
+
+	return PublishSlot(slotIndex, image_index, image_width, image_height);
+}
+
+bool MediapipeHandTrackingAsync::SubmitFrameNV12(int image_index, int image_width, int image_height, const unsigned char* y_plane, int y_stride, const unsigned char* uv_plane, int uv_stride)
+{
+	if (y_plane == nullptr || uv_plane == nullptr || image_width <= 0 || image_height <= 0)
+	{
+		return false;
+	}
+
+	int slotIndex = AcquireSlot(image_index);
+	if (slotIndex < 0)
+	{
+		return false;
+	}
+
+	// converted straight into the slot; there is no intermediate BGR frame to copy
+	FrameSlot& slot = m_FrameSlots[slotIndex];
+	size_t imageSize = (size_t)image_width * 3 * (size_t)image_height;
+	if (slot.m_Image_Data.size() < imageSize)
+	{
+		slot.m_Image_Data.resize(imageSize);
+	}
+	if (!ConvertNV12ToBGR(image_width, image_height, y_plane, y_stride, uv_plane, uv_stride, slot.m_Image_Data.data(), image_width * 3))
+	{
+		ReleaseSlot(slotIndex, image_index);
+		return false;
+	}
+
+	return PublishSlot(slotIndex, image_index, image_width, image_height);
+}
+
+bool MediapipeHandTrackingAsync::SubmitFrameI420(int image_index, int image_width, int image_height, const unsigned char* y_plane, int y_stride, const unsigned char* u_plane, int u_stride, const unsigned char* v_plane, int v_stride)
+{
+	if (y_plane == nullptr || u_plane == nullptr || v_plane == nullptr || image_width <= 0 || image_height <= 0)
+	{
+		return false;
+	}
+
+	int slotIndex = AcquireSlot(image_index);
+	if (slotIndex < 0)
+	{
+		return false;
+	}
+
+	FrameSlot& slot = m_FrameSlots[slotIndex];
+	size_t imageSize = (size_t)image_width * 3 * (size_t)image_height;
+	if (slot.m_Image_Data.size() < imageSize)
+	{
+		slot.m_Image_Data.resize(imageSize);
+	}
+	if (!ConvertI420ToBGR(image_width, image_height, y_plane, y_stride, u_plane, u_stride, v_plane, v_stride, slot.m_Image_Data.data(), image_width * 3))
+	{
+		ReleaseSlot(slotIndex, image_index);
+		return false;
+	}
+
+	return PublishSlot(slotIndex, image_index, image_width, image_height);
+}
+
+bool MediapipeHandTrackingAsync::SubmitFrameOriented(int image_index, int image_width, int image_height, const void* image_data, int image_stride, const FrameOrientation& orientation)
+{
+	if (image_data == nullptr || image_width <= 0 || image_height <= 0)
+	{
+		return false;
+	}
+
+	int slotIndex = AcquireSlot(image_index);
+	if (slotIndex < 0)
+	{
+		return false;
+	}
+
+	int orientedWidth = 0;
+	int orientedHeight = 0;
+	GetOrientedSize(image_width, image_height, orientation, orientedWidth, orientedHeight);
+	FrameSlot& slot = m_FrameSlots[slotIndex];
+	size_t imageSize = (size_t)orientedWidth * 3 * (size_t)orientedHeight;
+	if (slot.m_Image_Data.size() < imageSize)
+	{
+		slot.m_Image_Data.resize(imageSize);
+	}
+	if (!CopyOrientedBGR(image_width, image_height, (const unsigned char*)image_data, image_stride, orientation, slot.m_Image_Data.data(), orientedWidth * 3))
+	{
+		ReleaseSlot(slotIndex, image_index);
+		return false;
+	}
+
+	return PublishSlot(slotIndex, image_index, orientedWidth, orientedHeight);
+}
+
+int MediapipeHandTrackingAsync::AcquireSlot(int image_index)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	if (!m_IsRunning)
+	{
+		return -1;
+	}
+	if (m_Metrics != nullptr)
+	{
+		m_Metrics->AddSubmitted();
+	}
+
+	if (m_PendingCount == m_QueueDepth)
+	{
+		if (m_Metrics != nullptr)
+		{
+			m_Metrics->AddDropped();
+		}
+		if (m_DropPolicy == ADP_DropNewest)
+		{
+			++m_DroppedFrameCount;
+			SkipResultLocked(image_index);
+			return -1;
+		}
+
+		// drop-oldest: recycle the slot of the oldest queued frame
+		int slotIndex = m_PendingSlots[m_PendingHead];
+		m_PendingHead = (m_PendingHead + 1) % m_QueueDepth;
+		--m_PendingCount;
+		++m_DroppedFrameCount;
+		SkipResultLocked(m_FrameSlots[slotIndex].m_Image_Index);
+		return slotIndex;
+	}
+	if (!m_FreeSlots.empty())
+	{
+		int slotIndex = m_FreeSlots.back();
+		m_FreeSlots.pop_back();
+		return slotIndex;
+	}
+
+	++m_DroppedFrameCount;
+	if (m_Metrics != nullptr)
+	{
+		m_Metrics->AddDropped();
+	}
+	SkipResultLocked(image_index);
+	return -1;
+}
+
+void MediapipeHandTrackingAsync::ReleaseSlot(int slot_index, int image_index)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_FreeSlots.push_back(slot_index);
+	SkipResultLocked(image_index);
+}
+
+bool MediapipeHandTrackingAsync::PublishSlot(int slot_index, int image_index, int image_width, int image_height)
+{
+	FrameSlot& slot = m_FrameSlots[slot_index];
+	slot.m_Image_Index = image_index;
+	slot.m_Image_Width = image_width;
+	slot.m_Image_Height = image_height;
+	slot.m_Submit_Time = std::chrono::steady_clock::now();
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (!m_IsRunning)
+		{
+			m_FreeSlots.push_back(slot_index);
+			return false;
+		}
+		// Another submitting thread may have filled the queue while this slot was
+		// being copied; apply the drop policy again rather than overrun the ring
+		if (m_PendingCount == m_QueueDepth)
+		{
+			++m_DroppedFrameCount;
+			if (m_Metrics != nullptr)
+			{
+				m_Metrics->AddDropped();
+			}
+			if (m_DropPolicy == ADP_DropNewest)
+			{
+				m_FreeSlots.push_back(slot_index);
+				SkipResultLocked(image_index);
+				return false;
+			}
+			int oldestSlot = m_PendingSlots[m_PendingHead];
+			m_PendingHead = (m_PendingHead + 1) % m_QueueDepth;
+			--m_PendingCount;
+			m_FreeSlots.push_back(oldestSlot);
+			SkipResultLocked(m_FrameSlots[oldestSlot].m_Image_Index);
+		}
+		int tail = (m_PendingHead + m_PendingCount) % m_QueueDepth;
+		m_PendingSlots[tail] = slot_index;
+		++m_PendingCount;
+		if (m_Metrics != nullptr)
+		{
+			m_Metrics->SetQueueDepth(m_PendingCount + m_InFlightCount);
+		}
+	}
+	m_WorkAvailable.notify_one();
+
+	return true;
+}
+
+bool MediapipeHandTrackingAsync::PollResult(AsyncHandTrackingResult& result)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	DrainReorderLocked(false);
+	if (m_ResultCount == 0)
+	{
+		return false;
+	}
+
+	result = m_Results[m_ResultHead];
+	m_ResultHead = (m_ResultHead + 1) % m_QueueDepth;
+	--m_ResultCount;
+	return true;
+}
+
+bool MediapipeHandTrackingAsync::WaitResult(AsyncHandTrackingResult& result, int spin_us, int timeout_ms)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	unsigned int sequence = m_ResultSequence.load(std::memory_order_acquire);
+	if (PollResult(result))
+	{
+		return true;
+	}
+
+	// the worker publishes under m_Mutex and then bumps the counter, so a changed
+	// counter means PollResult will find the result
+	std::chrono::steady_clock::time_point spinEnd = start + std::chrono::microseconds(spin_us > 0 ? spin_us : 0);
+	bool published = false;
+	while (!published && std::chrono::steady_clock::now() < spinEnd)
+	{
+		for (int i = 0; i < 64 && !published; ++i)
+		{
+			published = m_ResultSequence.load(std::memory_order_acquire) != sequence;
+			CpuRelax();
+		}
+	}
+	if (published && PollResult(result))
+	{
+		return true;
+	}
+
+	std::chrono::steady_clock::time_point deadline = start + std::chrono::milliseconds(timeout_ms > 0 ? timeout_ms : 0);
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	++m_ResultWaiters;
+	while (true)
+	{
+		// held-back results time out without the worker publishing anything
+		DrainReorderLocked(false);
+		if (m_ResultCount > 0 || !m_IsRunning || std::chrono::steady_clock::now() >= deadline)
+		{
+			break;
+		}
+		std::chrono::steady_clock::time_point wakeTime = deadline;
+		std::chrono::steady_clock::time_point reorderDeadline;
+		if (m_ResultOrder == ARO_ImageIndex && m_Reorder.GetNextDeadline(reorderDeadline) && reorderDeadline < wakeTime)
+		{
+			wakeTime = reorderDeadline;
+		}
+		m_ResultAvailable.wait_until(lock, wakeTime);
+	}
+	--m_ResultWaiters;
+	if (m_ResultCount == 0)
+	{
+		return false;
+	}
+	result = m_Results[m_ResultHead];
+	m_ResultHead = (m_ResultHead + 1) % m_QueueDepth;
+	--m_ResultCount;
+	return true;
+}
+
+bool MediapipeHandTrackingAsync::SetWorkerAffinity(int cpu_index)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	if (!m_IsRunning || cpu_index < 0)
+	{
+		return false;
+	}
+#if defined(WINDOWS)
+	if (cpu_index >= (int)(sizeof(DWORD_PTR) * 8))
+	{
+		return false;
+	}
+	return SetThreadAffinityMask(m_WorkerThread.native_handle(), (DWORD_PTR)1 << cpu_index) != 0;
+#elif defined(LINUX)
+	if (cpu_index >= CPU_SETSIZE)
+	{
+		return false;
+	}
+	cpu_set_t cpus;
+	CPU_ZERO(&cpus);
+	CPU_SET(cpu_index, &cpus);
+	return pthread_setaffinity_np(m_WorkerThread.native_handle(), sizeof(cpus), &cpus) == 0;
+#else
+	return false;
+#endif
+}
+
+int MediapipeHandTrackingAsync::GetInFlightCount()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_PendingCount + m_InFlightCount;
+}
+
+unsigned long long MediapipeHandTrackingAsync::GetDroppedFrameCount()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_DroppedFrameCount;
+}
+
+unsigned long long MediapipeHandTrackingAsync::GetDroppedResultCount()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_DroppedResultCount;
+}
+
+unsigned long long MediapipeHandTrackingAsync::GetOverBudgetDroppedCount()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_OverBudgetDroppedCount;
+}
+
+unsigned long long MediapipeHandTrackingAsync::GetOverBudgetLateCount()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_OverBudgetLateCount;
+}
+
+void MediapipeHandTrackingAsync::WorkerLoop()
+{
+	while (true)
+	{
+		int slotIndex = -1;
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_WorkAvailable.wait(lock, [this] { return !m_IsRunning || m_PendingCount > 0; });
+			if (!m_IsRunning)
+			{
+				break;
+			}
+
+			slotIndex = m_PendingSlots[m_PendingHead];
+			m_PendingHead = (m_PendingHead + 1) % m_QueueDepth;
+			--m_PendingCount;
+
+			// Skip frames that are already bound to miss the budget; the newest queued
+			// frame is never skipped this way, so the worker always makes progress
+			if (m_LatencyBudget.count() > 0 && m_PendingCount > 0)
+			{
+				std::chrono::microseconds waited = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_FrameSlots[slotIndex].m_Submit_Time);
+				if (waited.count() + m_AverageDetectUs > m_LatencyBudget.count())
+				{
+					m_FreeSlots.push_back(slotIndex);
+					++m_OverBudgetDroppedCount;
+					SkipResultLocked(m_FrameSlots[slotIndex].m_Image_Index);
+					if (m_Metrics != nullptr)
+					{
+						m_Metrics->AddDropped();
+					}
+					continue;
+				}
+			}
+			m_InFlightCount = 1;
+		}
+
+		FrameSlot& slot = m_FrameSlots[slotIndex];
+		std::chrono::steady_clock::time_point detectStart = std::chrono::steady_clock::now();
+		int detectResult = m_HandTrackingDll.m_Mediapipe_Hand_Tracking_Detect_Frame(slot.m_Image_Index, slot.m_Image_Width, slot.m_Image_Height, (void*)slot.m_Image_Data.data());
+		std::chrono::steady_clock::time_point detectEnd = std::chrono::steady_clock::now();
+		double detectUs = (double)std::chrono::duration_cast<std::chrono::microseconds>(detectEnd - detectStart).count();
+		m_AverageDetectUs = m_AverageDetectUs == 0.0 ? detectUs : m_AverageDetectUs * 0.9 + detectUs * 0.1;
+
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (m_LatencyBudget.count() > 0 && detectEnd - slot.m_Submit_Time > m_LatencyBudget)
+		{
+			++m_OverBudgetLateCount;
+		}
+		if (m_Metrics != nullptr)
+		{
+			m_Metrics->AddProcessed(detectUs / 1000.0, detectResult != 0, false);
+			m_Metrics->AddResultLatency(std::chrono::duration<double, std::milli>(detectEnd - slot.m_Submit_Time).count());
+			m_Metrics->SetQueueDepth(m_PendingCount);
+		}
+		AsyncHandTrackingResult result;
+		result.m_Image_Index = slot.m_Image_Index;
+		result.m_Detect_Result = detectResult;
+		bool isPublished = PublishResultLocked(result);
+
+		m_FreeSlots.push_back(slotIndex);
+		m_InFlightCount = 0;
+		if (isPublished)
+		{
+			m_ResultSequence.fetch_add(1, std::memory_order_release);
+		}
+		if (m_ResultWaiters > 0)
+		{
+			// also wakes ordered waiters so they re-arm on the new reorder deadline
+			m_ResultAvailable.notify_all();
+		}
+	}
+}
+
+bool MediapipeHandTrackingAsync::PublishResultLocked(const AsyncHandTrackingResult& result)
+{
+	if (m_ResultOrder == ARO_Completion)
+	{
+		PushResultLocked(result);
+		return true;
+	}
+	if (!m_Reorder.Push(result.m_Image_Index, result, std::chrono::steady_clock::now()))
+	{
+		// its index was already given up on
+		++m_DroppedResultCount;
+		return false;
+	}
+	return DrainReorderLocked(false);
+}
+
+void MediapipeHandTrackingAsync::SkipResultLocked(int image_index)
+{
+	if (m_ResultOrder == ARO_ImageIndex && image_index >= 0)
+	{
+		m_Reorder.Skip(image_index);
+	}
+}
+
+bool MediapipeHandTrackingAsync::DrainReorderLocked(bool force)
+{
+	if (m_ResultOrder == ARO_Completion)
+	{
+		return false;
+	}
+	bool isPublished = false;
+	AsyncHandTrackingResult result;
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	while (m_Reorder.Pop(result, now, force))
+	{
+		PushResultLocked(result);
+		isPublished = true;
+	}
+	return isPublished;
+}
+
+void MediapipeHandTrackingAsync::PushResultLocked(const AsyncHandTrackingResult& result)
+{
+	if (m_ResultCount == m_QueueDepth)
+	{
+		// nobody is polling; keep the newest results
+		m_ResultHead = (m_ResultHead + 1) % m_QueueDepth;
+		--m_ResultCount;
+		++m_DroppedResultCount;
+	}
+	int tail = (m_ResultHead + m_ResultCount) % m_QueueDepth;
+	m_Results[tail] = result;
+	++m_ResultCount;
+}
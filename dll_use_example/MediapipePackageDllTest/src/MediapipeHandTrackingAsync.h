@@ -0,0 +1,152 @@
+#ifndef MEDIAPIPE_HAND_TRACKING_ASYNC_H
+#define MEDIAPIPE_HAND_TRACKING_ASYNC_H
+
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+#include "MediapipeHandTrackingDll.h"
+#include "TrackerMetrics.h"
+#include "FrameOrientation.h"
+#include "ResultReorderBuffer.h"
+
+//!
+//! @brief - Non-blocking submit/poll front end for Mediapipe_Hand_Tracking_Detect_Frame
+//!
+//! Frames are copied into a fixed ring of preallocated slots and handed to a
+//! single worker thread, so the caller can capture the next frame while the
+//! previous one is still in the graph. The worker is the only thread that calls
+//! into the DLL; landmark and gesture callbacks therefore fire on the worker.
+//!
+//! With a latency budget, the worker also drops a queued frame when the time it has
+//! already waited plus the recent average detect time would exceed the budget, so a
+//! backlog turns into skipped frames instead of growing delay.
+//!
+//! For latency-critical single-camera setups, WaitResult can spin on a completion
+//! counter for a short while before it blocks, and SetWorkerAffinity pins the worker
+//! to a core, so neither side of the hand-off pays an OS wake-up in the common case.
+//!
+//! Results come out in submission order. When several threads submit, or frames are
+//! submitted out of index order, SetResultOrder(ARO_ImageIndex) holds results back in a
+//! ResultReorderBuffer so PollResult / WaitResult return them in image_index order;
+//! frames the tracker drops are skipped without waiting.
+//!
+
+enum AsyncDropPolicy
+{
+	ADP_DropOldest = 0,		// replace the oldest queued frame with the new one
+	ADP_DropNewest = 1		// reject the new frame while the queue is full
+};
+
+enum AsyncResultOrder
+{
+	ARO_Completion = 0,		// as they finish, the image index attached
+	ARO_ImageIndex = 1		// strictly increasing image_index, gaps waited for up to the delay
+};
+
+struct AsyncHandTrackingResult
+{
+	int m_Image_Index = -1;
+	int m_Detect_Result = 0;
+};
+
+class MediapipeHandTrackingAsync
+{
+public:
+	// latency_budget_ms is submit-to-result; 0 disables the budget
+	MediapipeHandTrackingAsync(MediapipeHandTrackingDll& hand_tracking_dll, int queue_depth = 2, AsyncDropPolicy drop_policy = ADP_DropOldest, int latency_budget_ms = 0);
+	virtual~MediapipeHandTrackingAsync();
+
+public:
+	bool Start();
+	void Stop();
+	// optional; set before Start, must outlive the tracker
+	void SetMetrics(TrackerMetrics* metrics);
+	// optional; set before Start. window is how many results may be held back for a gap
+	void SetResultOrder(AsyncResultOrder order, int reorder_window = 8, int max_delay_ms = 50);
+
+	// image_data is BGR; image_stride is the row pitch in bytes (0 = densely packed).
+	// Rows are packed while copying into the slot, so padded or ROI Mats need no extra copy.
+	bool SubmitFrame(int image_index, int image_width, int image_height, const void* image_data, int image_stride = 0);
+	// Camera/decoder formats, converted to BGR directly into the queue slot (see YuvFrameConversion.h)
+	bool SubmitFrameNV12(int image_index, int image_width, int image_height, const unsigned char* y_plane, int y_stride, const unsigned char* uv_plane, int uv_stride);
+	bool SubmitFrameI420(int image_index, int image_width, int image_height, const unsigned char* y_plane, int y_stride, const unsigned char* u_plane, int u_stride, const unsigned char* v_plane, int v_stride);
+	// Rotated/mirrored while copying into the slot (see FrameOrientation.h); the DLL sees the
+	// oriented size, so map the landmarks back with MapLandmarksToSource in the callback
+	bool SubmitFrameOriented(int image_index, int image_width, int image_height, const void* image_data, int image_stride, const FrameOrientation& orientation);
+	bool PollResult(AsyncHandTrackingResult& result);
+	// Spins up to spin_us on the completion counter, then blocks for the rest of timeout_ms
+	bool WaitResult(AsyncHandTrackingResult& result, int spin_us, int timeout_ms);
+	// Pins the worker thread to one CPU; call after Start
+	bool SetWorkerAffinity(int cpu_index);
+
+	int GetInFlightCount();
+	unsigned long long GetDroppedFrameCount();
+	unsigned long long GetDroppedResultCount();
+	// frames skipped because they could not finish within the budget
+	unsigned long long GetOverBudgetDroppedCount();
+	// frames that were run but finished past the budget anyway
+	unsigned long long GetOverBudgetLateCount();
+
+private:
+	struct FrameSlot
+	{
+		int m_Image_Index = -1;
+		int m_Image_Width = 0;
+		int m_Image_Height = 0;
+		std::chrono::steady_clock::time_point m_Submit_Time;
+		std::vector<unsigned char> m_Image_Data;
+	};
+
+	// slot bookkeeping shared by the Submit* variants; the pixel copy happens between the two
+	int AcquireSlot(int image_index);
+	void ReleaseSlot(int slot_index, int image_index);
+	bool PublishSlot(int slot_index, int image_index, int image_width, int image_height);
+	// m_Mutex held; return true if m_Results gained a result
+	bool PublishResultLocked(const AsyncHandTrackingResult& result);
+	void SkipResultLocked(int image_index);
+	bool DrainReorderLocked(bool force);
+	void PushResultLocked(const AsyncHandTrackingResult& result);
+	void WorkerLoop();
+
+private:
+	MediapipeHandTrackingDll& m_HandTrackingDll;
+	AsyncDropPolicy m_DropPolicy;
+	int m_QueueDepth;
+
+	std::vector<FrameSlot> m_FrameSlots;
+	std::vector<int> m_FreeSlots;
+	std::vector<int> m_PendingSlots;		// ring of slot indices, capacity m_QueueDepth
+	int m_PendingHead;
+	int m_PendingCount;
+	int m_InFlightCount;
+
+	std::vector<AsyncHandTrackingResult> m_Results;	// ring, capacity m_QueueDepth
+	int m_ResultHead;
+	int m_ResultCount;
+	AsyncResultOrder m_ResultOrder;
+	ResultReorderBuffer<AsyncHandTrackingResult> m_Reorder;
+
+	unsigned long long m_DroppedFrameCount;
+	unsigned long long m_DroppedResultCount;
+
+	std::chrono::microseconds m_LatencyBudget;
+	double m_AverageDetectUs;		// moving average of Detect_Frame, worker thread only
+	unsigned long long m_OverBudgetDroppedCount;
+	unsigned long long m_OverBudgetLateCount;
+	TrackerMetrics* m_Metrics;
+
+	std::atomic<unsigned int> m_ResultSequence;	// bumped per published result, spun on by WaitResult
+	int m_ResultWaiters;
+	std::condition_variable m_ResultAvailable;
+
+	std::mutex m_Mutex;
+	std::condition_variable m_WorkAvailable;
+	std::thread m_WorkerThread;
+	bool m_IsRunning;
+};
+
+#endif // !MEDIAPIPE_HAND_TRACKING_ASYNC_H
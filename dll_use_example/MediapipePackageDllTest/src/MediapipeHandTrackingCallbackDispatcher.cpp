@@ -0,0 +1,218 @@
+#include "MediapipeHandTrackingCallbackDispatcher.h"
+
+std::atomic<MediapipeHandTrackingCallbackDispatcher*> MediapipeHandTrackingCallbackDispatcher::s_ActiveDispatcher(nullptr);
+std::atomic<int> MediapipeHandTrackingCallbackDispatcher::s_InFlightCalls(0);
+
+MediapipeHandTrackingCallbackDispatcher::MediapipeHandTrackingCallbackDispatcher(int queue_capacity, int max_landmark_count)
+	: m_MaxLandmarkCount(max_landmark_count > 0 ? max_landmark_count : HAND_KEYPOINT_COUNT * MAX_HAND_COUNT)
+	, m_LandmarksRing(queue_capacity > 0 ? queue_capacity : 8)
+	, m_GestureResultRing(queue_capacity > 0 ? queue_capacity : 8)
+	, m_LandmarksCallback(nullptr)
+	, m_GestureResultCallback(nullptr)
+	, m_DroppedLandmarksCount(0)
+	, m_DroppedGestureResultCount(0)
+	, m_IsRunning(false)
+	, m_HasPending(false)
+	, m_IsWaiting(false)
+{
+	// every slot is sized once here; the trampolines never allocate
+	int maxHandCount = (m_MaxLandmarkCount + HAND_KEYPOINT_COUNT - 1) / HAND_KEYPOINT_COUNT;
+	for (size_t i = 0; i < m_LandmarksRing.Capacity(); ++i)
+	{
+		m_LandmarksRing.SlotAt(i).m_Infos.resize(m_MaxLandmarkCount);
+	}
+	for (size_t i = 0; i < m_GestureResultRing.Capacity(); ++i)
+	{
+		m_GestureResultRing.SlotAt(i).m_Results.resize(maxHandCount, -1);
+	}
+}
+
+MediapipeHandTrackingCallbackDispatcher::~MediapipeHandTrackingCallbackDispatcher()
+{
+	Stop();
+}
+
+bool MediapipeHandTrackingCallbackDispatcher::Start(MediapipeHandTrackingDll& hand_tracking_dll, LandmarksCallBack landmarks_callback, GestureResultCallBack gesture_result_callback)
+{
+	if (hand_tracking_dll.m_Mediapipe_Hand_Tracking_Reigeter_Landmarks_Callback == nullptr
+		|| hand_tracking_dll.m_Mediapipe_Hand_Tracking_Register_Gesture_Result_Callback == nullptr)
+	{
+		return false;
+	}
+
+	MediapipeHandTrackingCallbackDispatcher* expected = nullptr;
+	if (!s_ActiveDispatcher.compare_exchange_strong(expected, this))
+	{
+		return expected == this;
+	}
+
+	m_LandmarksCallback = landmarks_callback;
+	m_GestureResultCallback = gesture_result_callback;
+	m_IsRunning = true;
+	m_DispatchThread = std::thread(&MediapipeHandTrackingCallbackDispatcher::DispatchLoop, this);
+
+	if (!hand_tracking_dll.m_Mediapipe_Hand_Tracking_Reigeter_Landmarks_Callback(LandmarksTrampoline)
+		|| !hand_tracking_dll.m_Mediapipe_Hand_Tracking_Register_Gesture_Result_Callback(GestureResultTrampoline))
+	{
+		Stop();
+		return false;
+	}
+
+	return true;
+}
+
+void MediapipeHandTrackingCallbackDispatcher::Stop()
+{
+	MediapipeHandTrackingCallbackDispatcher* expected = this;
+	if (!s_ActiveDispatcher.compare_exchange_strong(expected, nullptr))
+	{
+		return;
+	}
+
+	// The DLL may still call the trampolines until Release; from here on they are no-ops.
+	// A call that picked up this dispatcher before the store is still copying into the
+	// rings, so wait it out; the trampolines only copy, this is a short spin.
+	while (s_InFlightCalls.load() != 0)
+	{
+		std::this_thread::yield();
+	}
+
+	m_IsRunning.store(false);
+	WakeDispatcher();
+	if (m_DispatchThread.joinable())
+	{
+		m_DispatchThread.join();
+	}
+}
+
+unsigned long long MediapipeHandTrackingCallbackDispatcher::GetDroppedLandmarksCount()
+{
+	return m_DroppedLandmarksCount.load();
+}
+
+unsigned long long MediapipeHandTrackingCallbackDispatcher::GetDroppedGestureResultCount()
+{
+	return m_DroppedGestureResultCount.load();
+}
+
+void MediapipeHandTrackingCallbackDispatcher::LandmarksTrampoline(int image_index, PoseInfo* infos, int count)
+{
+	// counted before the load, so Stop either sees this call or it sees nullptr
+	s_InFlightCalls.fetch_add(1);
+	MediapipeHandTrackingCallbackDispatcher* dispatcher = s_ActiveDispatcher.load();
+	if (dispatcher != nullptr)
+	{
+		dispatcher->OnLandmarks(image_index, infos, count);
+	}
+	s_InFlightCalls.fetch_sub(1);
+}
+
+void MediapipeHandTrackingCallbackDispatcher::GestureResultTrampoline(int image_index, int* recogn_result, int count)
+{
+	// counted before the load, so Stop either sees this call or it sees nullptr
+	s_InFlightCalls.fetch_add(1);
+	MediapipeHandTrackingCallbackDispatcher* dispatcher = s_ActiveDispatcher.load();
+	if (dispatcher != nullptr)
+	{
+		dispatcher->OnGestureResult(image_index, recogn_result, count);
+	}
+	s_InFlightCalls.fetch_sub(1);
+}
+
+void MediapipeHandTrackingCallbackDispatcher::OnLandmarks(int image_index, PoseInfo* infos, int count)
+{
+	int copyCount = count < m_MaxLandmarkCount ? count : m_MaxLandmarkCount;
+	bool pushed = m_LandmarksRing.TryPush([&](LandmarksSlot& slot)
+	{
+		slot.m_Image_Index = image_index;
+		slot.m_Count = copyCount;
+		for (int i = 0; i < copyCount; ++i)
+		{
+			slot.m_Infos[i] = infos[i];
+		}
+	});
+
+	if (pushed)
+	{
+		WakeDispatcher();
+	}
+	else
+	{
+		++m_DroppedLandmarksCount;
+	}
+}
+
+void MediapipeHandTrackingCallbackDispatcher::OnGestureResult(int image_index, int* recogn_result, int count)
+{
+	bool pushed = m_GestureResultRing.TryPush([&](GestureResultSlot& slot)
+	{
+		int copyCount = count < (int)slot.m_Results.size() ? count : (int)slot.m_Results.size();
+		slot.m_Image_Index = image_index;
+		slot.m_Count = copyCount;
+		for (int i = 0; i < copyCount; ++i)
+		{
+			slot.m_Results[i] = recogn_result[i];
+		}
+	});
+
+	if (pushed)
+	{
+		WakeDispatcher();
+	}
+	else
+	{
+		++m_DroppedGestureResultCount;
+	}
+}
+
+void MediapipeHandTrackingCallbackDispatcher::WakeDispatcher()
+{
+	// Either the dispatcher sees m_HasPending before it sleeps, or this sees m_IsWaiting.
+	// Only then is the lock taken: it makes sure the dispatcher is inside wait, so the
+	// notify cannot fall between its check and its sleep.
+	m_HasPending.store(true);
+	if (m_IsWaiting.load())
+	{
+		std::lock_guard<std::mutex> lock(m_WakeMutex);
+		m_WakeCondition.notify_one();
+	}
+}
+
+void MediapipeHandTrackingCallbackDispatcher::DispatchLoop()
+{
+	while (true)
+	{
+		bool delivered = true;
+		while (delivered)
+		{
+			delivered = m_LandmarksRing.TryPop([this](LandmarksSlot& slot)
+			{
+				if (m_LandmarksCallback != nullptr)
+				{
+					m_LandmarksCallback(slot.m_Image_Index, slot.m_Infos.data(), slot.m_Count);
+				}
+			});
+
+			delivered |= m_GestureResultRing.TryPop([this](GestureResultSlot& slot)
+			{
+				if (m_GestureResultCallback != nullptr)
+				{
+					m_GestureResultCallback(slot.m_Image_Index, slot.m_Results.data(), slot.m_Count);
+				}
+			});
+		}
+
+		if (!m_IsRunning.load())
+		{
+			break;
+		}
+
+		std::unique_lock<std::mutex> lock(m_WakeMutex);
+		m_IsWaiting.store(true);
+		m_WakeCondition.wait(lock, [this]
+		{
+			return m_HasPending.exchange(false) || !m_IsRunning.load();
+		});
+		m_IsWaiting.store(false);
+	}
+}
@@ -0,0 +1,88 @@
+#ifndef MEDIAPIPE_HAND_TRACKING_CALLBACK_DISPATCHER_H
+#define MEDIAPIPE_HAND_TRACKING_CALLBACK_DISPATCHER_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+#include "MediapipeHandTrackingDll.h"
+#include "SpscRingBuffer.h"
+
+//!
+//! @brief - Runs LandmarksCallBack/GestureResultCallBack on a dedicated thread
+//!
+//! The DLL calls its registered callbacks inline inside the detect call, so a slow
+//! consumer stalls inference. The dispatcher registers its own trampolines with the
+//! DLL; they only copy the result into a preallocated lock-free ring and return. A
+//! dispatcher thread then delivers the results to the caller's callbacks. When the
+//! consumer falls behind, new results are dropped and counted.
+//!
+//! Each trampoline is the single producer of its ring. The DLL's callback contract
+//! (see MediapipeHandTrackingDll.h) never enters a callback concurrently with itself,
+//! which is all the rings need; the producing thread may change between calls.
+//!
+//! The DLL callbacks carry no user pointer, so only one dispatcher can be active
+//! per process. Stop waits for trampoline calls already under way, so the dispatcher
+//! can be destroyed once it returns even though the DLL keeps its callbacks.
+//!
+class MediapipeHandTrackingCallbackDispatcher
+{
+public:
+	MediapipeHandTrackingCallbackDispatcher(int queue_capacity = 8, int max_landmark_count = HAND_KEYPOINT_COUNT * MAX_HAND_COUNT);
+	virtual~MediapipeHandTrackingCallbackDispatcher();
+
+public:
+	bool Start(MediapipeHandTrackingDll& hand_tracking_dll, LandmarksCallBack landmarks_callback, GestureResultCallBack gesture_result_callback);
+	void Stop();
+
+	unsigned long long GetDroppedLandmarksCount();
+	unsigned long long GetDroppedGestureResultCount();
+
+private:
+	struct LandmarksSlot
+	{
+		int m_Image_Index = -1;
+		int m_Count = 0;
+		std::vector<PoseInfo> m_Infos;
+	};
+
+	struct GestureResultSlot
+	{
+		int m_Image_Index = -1;
+		int m_Count = 0;
+		std::vector<int> m_Results;
+	};
+
+	static void LandmarksTrampoline(int image_index, PoseInfo* infos, int count);
+	static void GestureResultTrampoline(int image_index, int* recogn_result, int count);
+
+	void OnLandmarks(int image_index, PoseInfo* infos, int count);
+	void OnGestureResult(int image_index, int* recogn_result, int count);
+	void DispatchLoop();
+	void WakeDispatcher();
+
+private:
+	static std::atomic<MediapipeHandTrackingCallbackDispatcher*> s_ActiveDispatcher;
+	static std::atomic<int> s_InFlightCalls;			// trampoline calls that may still use s_ActiveDispatcher
+
+	int m_MaxLandmarkCount;
+	SpscRingBuffer<LandmarksSlot> m_LandmarksRing;
+	SpscRingBuffer<GestureResultSlot> m_GestureResultRing;
+
+	LandmarksCallBack m_LandmarksCallback;
+	GestureResultCallBack m_GestureResultCallback;
+
+	std::atomic<unsigned long long> m_DroppedLandmarksCount;
+	std::atomic<unsigned long long> m_DroppedGestureResultCount;
+
+	std::atomic<bool> m_IsRunning;
+	std::atomic<bool> m_HasPending;
+	std::atomic<bool> m_IsWaiting;						// the dispatcher is about to sleep or asleep
+	std::mutex m_WakeMutex;
+	std::condition_variable m_WakeCondition;
+	std::thread m_DispatchThread;
+};
+
+#endif // !MEDIAPIPE_HAND_TRACKING_CALLBACK_DISPATCHER_H
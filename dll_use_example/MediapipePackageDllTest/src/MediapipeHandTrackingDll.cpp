@@ -7,7 +7,11 @@ MediapipeHandTrackingDll::MediapipeHandTrackingDll()
 	m_Mediapipe_Hand_Tracking_Register_Gesture_Result_Callback = nullptr;
 	m_Mediapipe_Hand_Tracking_Detect_Frame = nullptr;
 	m_Mediapipe_Hand_Tracking_Detect_Video = nullptr;
+	m_Mediapipe_Hand_Tracking_Detect_Frame_Direct = nullptr;
 	m_Mediapipe_Hand_Tracking_Release = nullptr;
+	m_Mediapipe_IK_Solve_Chain = nullptr;
+	m_Mediapipe_IK_Solve_Landmark_Chain = nullptr;
+	m_Mediapipe_IK_Solve_Chain_Batch = nullptr;
 }
 
 MediapipeHandTrackingDll::~MediapipeHandTrackingDll()
@@ -18,15 +22,22 @@ MediapipeHandTrackingDll::~MediapipeHandTrackingDll()
 	}
 }
 
-bool MediapipeHandTrackingDll::LoadMediapipeHandTrackingDll(const std::string& dll_path)
+bool MediapipeHandTrackingDll::LoadMediapipeHandTrackingDll(const std::string& dll_path, DynamicModuleLoadMode load_mode, const std::string& preload_manifest)
 {
 	std::string dllPath = dll_path;
 	if (m_DynamicModuleLoader.IsFileExist(dllPath))
 	{
-		if (m_DynamicModuleLoader.LoadDynamicModule(dllPath))
+		if (!preload_manifest.empty() && !m_DynamicModuleLoader.LoadPreloadManifest(preload_manifest, load_mode))
+		{
+			m_DynamicModuleLoader.UnloadDynamicModule();
+			return false;
+		}
+		if (m_DynamicModuleLoader.LoadDynamicModule(dllPath, load_mode))
 		{
 			return true;
 		}
+		// drop whatever the manifest preloaded
+		m_DynamicModuleLoader.UnloadDynamicModule();
 	}
 
 	return false;
@@ -46,6 +57,13 @@ bool MediapipeHandTrackingDll::GetAllFunctions()
 {
 	if (m_DynamicModuleLoader.GetDynamicModuleState())
 	{
+		// DLLs that export the function table need a single lookup; older ones fall through
+		if (GetFunctionsFromApiTable())
+		{
+			GetOptionalFunctions();
+			return true;
+		}
+
 		// ȡMediapipe_Hand_Tracking_Init
 		void* p_Mediapipe_Hand_Tracking_Init = m_DynamicModuleLoader.GetFunction("Mediapipe_Hand_Tracking_Init");
 		if (p_Mediapipe_Hand_Tracking_Init != nullptr)
@@ -184,7 +202,55 @@ bool MediapipeHandTrackingDll::GetAllFunctions()
 			return false;
 		}
 
+		GetOptionalFunctions();
 	}
 
 	return true;
 }
+
+bool MediapipeHandTrackingDll::GetFunctionsFromApiTable()
+{
+	void* p_Mediapipe_Hand_Tracking_Get_Api_Table = m_DynamicModuleLoader.GetFunction("Mediapipe_Hand_Tracking_Get_Api_Table");
+	if (p_Mediapipe_Hand_Tracking_Get_Api_Table == nullptr)
+	{
+		return false;
+	}
+
+	Func_Mediapipe_Hand_Tracking_Get_Api_Table getApiTable = (Func_Mediapipe_Hand_Tracking_Get_Api_Table)(p_Mediapipe_Hand_Tracking_Get_Api_Table);
+	const MediapipeHandTrackingApiTable* apiTable = getApiTable(MEDIAPIPE_HAND_TRACKING_API_VERSION);
+	if (apiTable == nullptr
+		|| apiTable->m_Version < MEDIAPIPE_HAND_TRACKING_API_VERSION
+		|| apiTable->m_Size < (int)sizeof(MediapipeHandTrackingApiTable))
+	{
+		return false;
+	}
+
+	if (apiTable->m_Mediapipe_Hand_Tracking_Init == nullptr
+		|| apiTable->m_Mediapipe_Hand_Tracking_Reigeter_Landmarks_Callback == nullptr
+		|| apiTable->m_Mediapipe_Hand_Tracking_Register_Gesture_Result_Callback == nullptr
+		|| apiTable->m_Mediapipe_Hand_Tracking_Detect_Frame == nullptr
+		|| apiTable->m_Mediapipe_Hand_Tracking_Detect_Frame_Direct == nullptr
+		|| apiTable->m_Mediapipe_Hand_Tracking_Detect_Video == nullptr
+		|| apiTable->m_Mediapipe_Hand_Tracking_Release == nullptr)
+	{
+		return false;
+	}
+
+	m_Mediapipe_Hand_Tracking_Init = apiTable->m_Mediapipe_Hand_Tracking_Init;
+	m_Mediapipe_Hand_Tracking_Reigeter_Landmarks_Callback = apiTable->m_Mediapipe_Hand_Tracking_Reigeter_Landmarks_Callback;
+	m_Mediapipe_Hand_Tracking_Register_Gesture_Result_Callback = apiTable->m_Mediapipe_Hand_Tracking_Register_Gesture_Result_Callback;
+	m_Mediapipe_Hand_Tracking_Detect_Frame = apiTable->m_Mediapipe_Hand_Tracking_Detect_Frame;
+	m_Mediapipe_Hand_Tracking_Detect_Frame_Direct = apiTable->m_Mediapipe_Hand_Tracking_Detect_Frame_Direct;
+	m_Mediapipe_Hand_Tracking_Detect_Video = apiTable->m_Mediapipe_Hand_Tracking_Detect_Video;
+	m_Mediapipe_Hand_Tracking_Release = apiTable->m_Mediapipe_Hand_Tracking_Release;
+
+	return true;
+}
+
+void MediapipeHandTrackingDll::GetOptionalFunctions()
+{
+	// missing optional exports are not an error; callers check for nullptr
+	m_Mediapipe_IK_Solve_Chain = m_DynamicModuleLoader.GetFunction<Func_Mediapipe_IK_Solve_Chain>("Mediapipe_IK_Solve_Chain");
+	m_Mediapipe_IK_Solve_Landmark_Chain = m_DynamicModuleLoader.GetFunction<Func_Mediapipe_IK_Solve_Landmark_Chain>("Mediapipe_IK_Solve_Landmark_Chain");
+	m_Mediapipe_IK_Solve_Chain_Batch = m_DynamicModuleLoader.GetFunction<Func_Mediapipe_IK_Solve_Chain_Batch>("Mediapipe_IK_Solve_Chain_Batch");
+}
@@ -15,6 +15,20 @@ struct GestureRecognitionResult
 	int m_HandUp_HandDown_Detect_Result[2] = { -1,-1 };
 };
 
+// The landmark callback reports HAND_KEYPOINT_COUNT keypoints per detected hand, one hand
+// after the other; how many hands is set by num_hands in hand_tracking_desktop_live.pbtxt.
+// Buffers that take landmarks from the DLL are sized for MAX_HAND_COUNT hands, the
+// largest setting supported.
+#define HAND_KEYPOINT_COUNT 21
+#define MAX_HAND_COUNT 6
+
+// Callback threading contract: the DLL invokes both callbacks synchronously inside
+// Detect_Frame / Detect_Frame_Direct, on the thread that made the call, before the call
+// returns. The graph is not reentrant, so callers run one detect call at a time (from
+// one thread, or hand-over between threads with a happens-before, as the async worker
+// or a mutex provides); each callback is then never entered concurrently with itself
+// or with the other one. Code fed by these callbacks relies on that and nothing more:
+// the thread may change from one detect call to the next.
 typedef void(*LandmarksCallBack)(int image_index, PoseInfo* infos, int count);
 typedef void(*GestureResultCallBack)(int image_index, int* recogn_result, int count);
 
@@ -26,6 +40,36 @@ typedef int (*Func_Mediapipe_Hand_Tracking_Detect_Frame_Direct)(int image_width,
 typedef int (*Func_Mediapipe_Hand_Tracking_Detect_Video)(const char* video_path, int show_image);
 typedef int (*Func_Mediapipe_Hand_Tracking_Release)();
 
+// optional, exported by DLLs built with dll/ik_solver; see ik_solver_api.h
+typedef int (*Func_Mediapipe_IK_Solve_Chain)(float* joint_positions, int joint_count, const float* target_position, int solver_type, int max_iterations, float tolerance, float* bone_rotations, int* iterations_used);
+typedef int (*Func_Mediapipe_IK_Solve_Landmark_Chain)(float* landmarks, int landmark_count, int landmark_stride, const int* chain_indices, int chain_length, const float* target_position, int solver_type, int max_iterations, float tolerance, float* bone_rotations, int* iterations_used);
+typedef int (*Func_Mediapipe_IK_Solve_Chain_Batch)(float* xs, float* ys, float* zs, int chain_count, int joint_count, const float* targets, int max_iterations, float tolerance, int* iterations_used);
+
+//!
+//! @brief - Function table returned by Mediapipe_Hand_Tracking_Get_Api_Table
+//!
+//! New exports are appended at the end and MEDIAPIPE_HAND_TRACKING_API_VERSION is
+//! bumped, so a table of a newer version is still readable by an older client.
+//! The holistic DLL exports its table under its own name, so pointing this loader at
+//! it finds no table instead of one with a different layout.
+//!
+#define MEDIAPIPE_HAND_TRACKING_API_VERSION 1
+
+struct MediapipeHandTrackingApiTable
+{
+	int m_Version;
+	int m_Size;		// sizeof the table as compiled into the DLL
+	Func_Mediapipe_Hand_Tracking_Init m_Mediapipe_Hand_Tracking_Init;
+	Func_Mediapipe_Hand_Tracking_Reigeter_Landmarks_Callback m_Mediapipe_Hand_Tracking_Reigeter_Landmarks_Callback;
+	Func_Mediapipe_Hand_Tracking_Register_Gesture_Result_Callback m_Mediapipe_Hand_Tracking_Register_Gesture_Result_Callback;
+	Func_Mediapipe_Hand_Tracking_Detect_Frame m_Mediapipe_Hand_Tracking_Detect_Frame;
+	Func_Mediapipe_Hand_Tracking_Detect_Frame_Direct m_Mediapipe_Hand_Tracking_Detect_Frame_Direct;
+	Func_Mediapipe_Hand_Tracking_Detect_Video m_Mediapipe_Hand_Tracking_Detect_Video;
+	Func_Mediapipe_Hand_Tracking_Release m_Mediapipe_Hand_Tracking_Release;
+};
+
+typedef const MediapipeHandTrackingApiTable* (*Func_Mediapipe_Hand_Tracking_Get_Api_Table)(int version);
+
 class MediapipeHandTrackingDll
 {
 public:
@@ -33,7 +77,8 @@ public:
 	virtual~MediapipeHandTrackingDll();
 
 public:
-	bool LoadMediapipeHandTrackingDll(const std::string& dll_path);
+	// preload_manifest optionally lists dependency libraries to load first, see DynamicModuleLoader::LoadPreloadManifest
+	bool LoadMediapipeHandTrackingDll(const std::string& dll_path, DynamicModuleLoadMode load_mode = DMLM_Global, const std::string& preload_manifest = "");
 	bool UnLoadMediapipeHandTrackingDll();
 	bool GetAllFunctions();
 
@@ -47,6 +92,15 @@ public:
 	Func_Mediapipe_Hand_Tracking_Detect_Frame_Direct m_Mediapipe_Hand_Tracking_Detect_Frame_Direct;
 	Func_Mediapipe_Hand_Tracking_Release m_Mediapipe_Hand_Tracking_Release;
 
+	// null when the loaded DLL does not export them
+	Func_Mediapipe_IK_Solve_Chain m_Mediapipe_IK_Solve_Chain;
+	Func_Mediapipe_IK_Solve_Landmark_Chain m_Mediapipe_IK_Solve_Landmark_Chain;
+	Func_Mediapipe_IK_Solve_Chain_Batch m_Mediapipe_IK_Solve_Chain_Batch;
+
+private:
+	bool GetFunctionsFromApiTable();
+	void GetOptionalFunctions();
+
 private:
 	DynamicModuleLoader m_DynamicModuleLoader;
 };
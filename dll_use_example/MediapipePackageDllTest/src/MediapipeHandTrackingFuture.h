@@ -0,0 +1,278 @@
+#ifndef MEDIAPIPE_HAND_TRACKING_FUTURE_H
+#define MEDIAPIPE_HAND_TRACKING_FUTURE_H
+
+#include <deque>
+#include <future>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <functional>
+
+#include "MediapipeHandTrackingAsync.h"
+
+#if defined(__has_include)
+#if __has_include(<coroutine>) && defined(__cpp_impl_coroutine)
+#include <coroutine>
+#define MEDIAPIPE_HAND_TRACKING_HAS_COROUTINES 1
+#endif
+#endif
+
+//!
+//! @brief - std::future / co_await front end for MediapipeHandTrackingAsync (header only)
+//!
+//! Each Detect call submits one frame to the async tracker and completes when that
+//! frame's result is published, so a coroutine-based server can keep many frames in
+//! flight without parking a thread on each. A single completion thread waits on the
+//! tracker's results and matches them to requests in submission order; requests whose
+//! frame the tracker dropped (queue full, over budget) complete with m_Is_Dropped.
+//!
+//! Continuations run through the executor given to the constructor, e.g. a lambda that
+//! posts to the server's io context; without one they run on the completion thread and
+//! should only hand off. Landmarks still arrive through the DLL's landmark callback on
+//! the tracker's worker, before the matching request completes.
+//!
+//! The wrapper must be the only consumer of the tracker's PollResult / WaitResult.
+//! co_await needs C++20; DetectFuture and DetectWithCallback work from C++11.
+//!
+
+struct AsyncDetectOutcome
+{
+	int m_Image_Index = -1;
+	int m_Detect_Result = 0;
+	bool m_Is_Dropped = false;
+};
+
+class MediapipeHandTrackingFuture
+{
+public:
+	typedef std::function<void(const AsyncDetectOutcome&)> CompletionHandler;
+	typedef std::function<void(std::function<void()>)> CompletionExecutor;
+
+	// tracker must be started and outlive the wrapper
+	explicit MediapipeHandTrackingFuture(MediapipeHandTrackingAsync& tracker, CompletionExecutor executor = CompletionExecutor())
+		: m_Tracker(tracker)
+		, m_Executor(executor)
+		, m_IsRunning(true)
+	{
+		m_CompletionThread = std::thread(&MediapipeHandTrackingFuture::CompletionLoop, this);
+	}
+
+	virtual~MediapipeHandTrackingFuture()
+	{
+		Stop();
+	}
+
+	// Requests still pending complete as dropped
+	void Stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			if (!m_IsRunning)
+			{
+				return;
+			}
+			m_IsRunning = false;
+		}
+		if (m_CompletionThread.joinable())
+		{
+			m_CompletionThread.join();
+		}
+
+		std::deque<PendingRequest> pending;
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			pending.swap(m_Pending);
+		}
+		for (size_t i = 0; i < pending.size(); ++i)
+		{
+			AsyncDetectOutcome outcome;
+			outcome.m_Image_Index = pending[i].m_Image_Index;
+			outcome.m_Is_Dropped = true;
+			Complete(pending[i].m_Handler, outcome);
+		}
+	}
+
+	// false if the tracker rejected the frame; the handler is then never called.
+	// image_data is copied before this returns.
+	bool DetectWithCallback(int image_index, int image_width, int image_height, const void* image_data, int image_stride, CompletionHandler handler)
+	{
+		// serialized so queue order matches the tracker's submission order
+		std::lock_guard<std::mutex> submitLock(m_SubmitMutex);
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			if (!m_IsRunning)
+			{
+				return false;
+			}
+			PendingRequest request;
+			request.m_Image_Index = image_index;
+			request.m_Handler = handler;
+			m_Pending.push_back(request);
+		}
+		if (m_Tracker.SubmitFrame(image_index, image_width, image_height, image_data, image_stride))
+		{
+			return true;
+		}
+
+		// no result can follow a rejected frame, so it is still the last request
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (!m_Pending.empty() && m_Pending.back().m_Image_Index == image_index)
+		{
+			m_Pending.pop_back();
+		}
+		return false;
+	}
+
+	// A rejected frame yields a ready future with m_Is_Dropped set
+	std::future<AsyncDetectOutcome> DetectFuture(int image_index, int image_width, int image_height, const void* image_data, int image_stride = 0)
+	{
+		std::shared_ptr<std::promise<AsyncDetectOutcome> > promise = std::make_shared<std::promise<AsyncDetectOutcome> >();
+		std::future<AsyncDetectOutcome> future = promise->get_future();
+		if (!DetectWithCallback(image_index, image_width, image_height, image_data, image_stride,
+			[promise](const AsyncDetectOutcome& outcome) { promise->set_value(outcome); }))
+		{
+			AsyncDetectOutcome outcome;
+			outcome.m_Image_Index = image_index;
+			outcome.m_Is_Dropped = true;
+			promise->set_value(outcome);
+		}
+		return future;
+	}
+
+#if defined(MEDIAPIPE_HAND_TRACKING_HAS_COROUTINES)
+	class DetectAwaitable
+	{
+	public:
+		DetectAwaitable(MediapipeHandTrackingFuture& owner, int image_index, int image_width, int image_height, const void* image_data, int image_stride)
+			: m_Owner(owner)
+			, m_Image_Width(image_width)
+			, m_Image_Height(image_height)
+			, m_Image_Data(image_data)
+			, m_Image_Stride(image_stride)
+		{
+			m_Outcome.m_Image_Index = image_index;
+			m_Outcome.m_Is_Dropped = true;
+		}
+
+		bool await_ready() const noexcept
+		{
+			return false;
+		}
+
+		// The coroutine may be resumed on another thread before this returns, so
+		// nothing is touched after the submit
+		bool await_suspend(std::coroutine_handle<> handle)
+		{
+			DetectAwaitable* self = this;
+			return m_Owner.DetectWithCallback(m_Outcome.m_Image_Index, m_Image_Width, m_Image_Height, m_Image_Data, m_Image_Stride,
+				[self, handle](const AsyncDetectOutcome& outcome)
+				{
+					self->m_Outcome = outcome;
+					handle.resume();
+				});
+		}
+
+		AsyncDetectOutcome await_resume() const noexcept
+		{
+			return m_Outcome;
+		}
+
+	private:
+		MediapipeHandTrackingFuture& m_Owner;
+		int m_Image_Width;
+		int m_Image_Height;
+		const void* m_Image_Data;
+		int m_Image_Stride;
+		AsyncDetectOutcome m_Outcome;
+	};
+
+	// AsyncDetectOutcome outcome = co_await tracker.Detect(index, w, h, frame.data, (int)frame.step);
+	DetectAwaitable Detect(int image_index, int image_width, int image_height, const void* image_data, int image_stride = 0)
+	{
+		return DetectAwaitable(*this, image_index, image_width, image_height, image_data, image_stride);
+	}
+#endif
+
+private:
+	struct PendingRequest
+	{
+		int m_Image_Index;
+		CompletionHandler m_Handler;
+	};
+
+	void Complete(const CompletionHandler& handler, const AsyncDetectOutcome& outcome)
+	{
+		if (m_Executor)
+		{
+			m_Executor([handler, outcome]() { handler(outcome); });
+		}
+		else
+		{
+			handler(outcome);
+		}
+	}
+
+	void CompletionLoop()
+	{
+		while (true)
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				if (!m_IsRunning)
+				{
+					return;
+				}
+			}
+			// short timeout so Stop is noticed without a wake-up from the tracker
+			AsyncHandTrackingResult result;
+			if (!m_Tracker.WaitResult(result, 0, 20))
+			{
+				continue;
+			}
+
+			// The worker runs frames in submission order: requests queued ahead of the
+			// one this result belongs to were dropped by the tracker
+			std::deque<PendingRequest> finished;
+			bool isMatched = false;
+			{
+				std::lock_guard<std::mutex> lock(m_Mutex);
+				for (size_t i = 0; i < m_Pending.size(); ++i)
+				{
+					if (m_Pending[i].m_Image_Index == result.m_Image_Index)
+					{
+						finished.assign(m_Pending.begin(), m_Pending.begin() + i + 1);
+						m_Pending.erase(m_Pending.begin(), m_Pending.begin() + i + 1);
+						isMatched = true;
+						break;
+					}
+				}
+			}
+			if (!isMatched)
+			{
+				// a frame submitted to the tracker directly; not ours
+				continue;
+			}
+			for (size_t i = 0; i < finished.size(); ++i)
+			{
+				AsyncDetectOutcome outcome;
+				outcome.m_Image_Index = finished[i].m_Image_Index;
+				bool isThisResult = i + 1 == finished.size();
+				outcome.m_Detect_Result = isThisResult ? result.m_Detect_Result : 0;
+				outcome.m_Is_Dropped = !isThisResult;
+				Complete(finished[i].m_Handler, outcome);
+			}
+		}
+	}
+
+private:
+	MediapipeHandTrackingAsync& m_Tracker;
+	CompletionExecutor m_Executor;
+
+	std::deque<PendingRequest> m_Pending;
+	std::mutex m_SubmitMutex;
+	std::mutex m_Mutex;
+	std::thread m_CompletionThread;
+	bool m_IsRunning;
+};
+
+#endif // !MEDIAPIPE_HAND_TRACKING_FUTURE_H
@@ -0,0 +1,169 @@
+#include "MediapipeHandTrackingGestureOnly.h"
+
+#include <algorithm>
+#include <cstring>
+
+std::atomic<MediapipeHandTrackingGestureOnly*> MediapipeHandTrackingGestureOnly::s_ActiveGestureOnly(nullptr);
+
+MediapipeHandTrackingGestureOnly::MediapipeHandTrackingGestureOnly(MediapipeHandTrackingDll& hand_tracking_dll, const GestureOnlyOptions& options)
+	: m_HandTrackingDll(hand_tracking_dll)
+	, m_Options(options)
+	, m_GestureCallback(nullptr)
+	, m_IsStarted(false)
+	, m_InputWidth(0)
+	, m_InputHeight(0)
+{
+	m_Options.m_Downscale = std::min(4, std::max(1, m_Options.m_Downscale));
+	m_Options.m_Min_Input_Height = std::max(1, m_Options.m_Min_Input_Height);
+}
+
+MediapipeHandTrackingGestureOnly::~MediapipeHandTrackingGestureOnly()
+{
+	Stop();
+}
+
+bool MediapipeHandTrackingGestureOnly::Start(GestureResultCallBack gesture_callback)
+{
+	if (m_IsStarted)
+	{
+		return true;
+	}
+	if (m_HandTrackingDll.m_Mediapipe_Hand_Tracking_Detect_Frame_Direct == nullptr
+		|| m_HandTrackingDll.m_Mediapipe_Hand_Tracking_Reigeter_Landmarks_Callback == nullptr
+		|| m_HandTrackingDll.m_Mediapipe_Hand_Tracking_Register_Gesture_Result_Callback == nullptr)
+	{
+		return false;
+	}
+
+	MediapipeHandTrackingGestureOnly* expected = nullptr;
+	if (!s_ActiveGestureOnly.compare_exchange_strong(expected, this))
+	{
+		return false;
+	}
+	if (!m_HandTrackingDll.m_Mediapipe_Hand_Tracking_Reigeter_Landmarks_Callback(LandmarksTrampoline)
+		|| !m_HandTrackingDll.m_Mediapipe_Hand_Tracking_Register_Gesture_Result_Callback(GestureTrampoline))
+	{
+		s_ActiveGestureOnly.store(nullptr);
+		return false;
+	}
+
+	m_GestureCallback = gesture_callback;
+	m_IsStarted = true;
+	return true;
+}
+
+void MediapipeHandTrackingGestureOnly::Stop()
+{
+	if (!m_IsStarted)
+	{
+		return;
+	}
+	m_IsStarted = false;
+	MediapipeHandTrackingGestureOnly* expected = this;
+	s_ActiveGestureOnly.compare_exchange_strong(expected, nullptr);
+}
+
+bool MediapipeHandTrackingGestureOnly::DetectFrame(int image_index, int image_width, int image_height, const void* image_data, int image_stride, GestureRecognitionResult& result)
+{
+	if (!m_IsStarted || image_data == nullptr || image_width <= 0 || image_height <= 0)
+	{
+		return false;
+	}
+	if (image_stride <= 0)
+	{
+		image_stride = image_width * 3;
+	}
+
+	int factor = m_Options.m_Downscale;
+	while (factor > 1 && image_height / factor < m_Options.m_Min_Input_Height)
+	{
+		--factor;
+	}
+
+	// packed full-size frames go straight through; everything else is written into the scaled buffer
+	void* input = const_cast<void*>(image_data);
+	m_InputWidth = image_width / factor;
+	m_InputHeight = image_height / factor;
+	if (factor > 1 || image_stride != image_width * 3)
+	{
+		m_ScaledImage.resize((size_t)m_InputWidth * m_InputHeight * 3);
+		DownscaleBGR((const unsigned char*)image_data, image_width, image_height, image_stride, factor, m_ScaledImage.data());
+		input = m_ScaledImage.data();
+	}
+
+	result = GestureRecognitionResult();
+	int detected = m_HandTrackingDll.m_Mediapipe_Hand_Tracking_Detect_Frame_Direct(m_InputWidth, m_InputHeight, input, result);
+	if (detected != 0 && m_GestureCallback != nullptr)
+	{
+		m_GestureCallback(image_index, result.m_Gesture_Recognition_Result, 2);
+	}
+	return detected != 0;
+}
+
+int MediapipeHandTrackingGestureOnly::GetInputWidth()
+{
+	return m_InputWidth;
+}
+
+int MediapipeHandTrackingGestureOnly::GetInputHeight()
+{
+	return m_InputHeight;
+}
+
+void MediapipeHandTrackingGestureOnly::DownscaleBGR(const unsigned char* src, int width, int height, int src_stride, int factor, unsigned char* dst)
+{
+	const int dstWidth = width / factor;
+	const int dstHeight = height / factor;
+	if (factor == 1)
+	{
+		for (int y = 0; y < dstHeight; ++y)
+		{
+			memcpy(dst + (size_t)y * dstWidth * 3, src + (size_t)y * src_stride, (size_t)dstWidth * 3);
+		}
+		return;
+	}
+
+	// sum * reciprocal >> 16 divides by factor * factor for every sum a block can reach
+	const unsigned int reciprocal = (65536u + (unsigned int)(factor * factor) / 2) / (unsigned int)(factor * factor);
+	const unsigned int rounding = 32768u;
+	for (int y = 0; y < dstHeight; ++y)
+	{
+		const unsigned char* top = src + (size_t)y * factor * src_stride;
+		unsigned char* out = dst + (size_t)y * dstWidth * 3;
+		for (int x = 0; x < dstWidth; ++x)
+		{
+			unsigned int b = 0;
+			unsigned int g = 0;
+			unsigned int r = 0;
+			for (int row = 0; row < factor; ++row)
+			{
+				const unsigned char* block = top + (size_t)row * src_stride + x * factor * 3;
+				for (int k = 0; k < factor; ++k)
+				{
+					b += block[k * 3 + 0];
+					g += block[k * 3 + 1];
+					r += block[k * 3 + 2];
+				}
+			}
+			out[x * 3 + 0] = (unsigned char)std::min(255u, (b * reciprocal + rounding) >> 16);
+			out[x * 3 + 1] = (unsigned char)std::min(255u, (g * reciprocal + rounding) >> 16);
+			out[x * 3 + 2] = (unsigned char)std::min(255u, (r * reciprocal + rounding) >> 16);
+		}
+	}
+}
+
+void MediapipeHandTrackingGestureOnly::LandmarksTrampoline(int image_index, PoseInfo* infos, int count)
+{
+	// gesture-only: landmarks are not copied anywhere
+	(void)image_index;
+	(void)infos;
+	(void)count;
+}
+
+void MediapipeHandTrackingGestureOnly::GestureTrampoline(int image_index, int* recogn_result, int count)
+{
+	// Detect_Frame_Direct already returns the gesture result; DetectFrame forwards it
+	(void)image_index;
+	(void)recogn_result;
+	(void)count;
+}
@@ -0,0 +1,67 @@
+#ifndef MEDIAPIPE_HAND_TRACKING_GESTURE_ONLY_H
+#define MEDIAPIPE_HAND_TRACKING_GESTURE_ONLY_H
+
+#include <atomic>
+#include <vector>
+
+#include "MediapipeHandTrackingDll.h"
+
+//!
+//! @brief - Low-power hand tracking for callers that only need the gesture codes
+//!
+//! Frames are box-filtered down by an integer factor before they reach the DLL, so the
+//! DLL copies and converts a quarter (or less) of the pixels and palm detection
+//! resizes a smaller image; the gesture rules work on joint angles and do not depend
+//! on the image size. Initialize the DLL with a graph that uses the lite hand
+//! landmark model for the full power saving.
+//!
+//! Only gesture codes come out, through the GestureResultCallBack given to Start,
+//! with image_index as passed to DetectFrame and count 2 (one code per hand, -1 for
+//! none). The DLL's landmark callback is pointed at an empty function, so no landmark
+//! is copied on this side. While started this class owns both callbacks; only one
+//! instance may be started at a time.
+//!
+
+struct GestureOnlyOptions
+{
+	int m_Downscale = 2;				// 1..4; 2 halves width and height
+	int m_Min_Input_Height = 240;		// the factor is lowered rather than go below this
+};
+
+class MediapipeHandTrackingGestureOnly
+{
+public:
+	MediapipeHandTrackingGestureOnly(MediapipeHandTrackingDll& hand_tracking_dll, const GestureOnlyOptions& options = GestureOnlyOptions());
+	virtual~MediapipeHandTrackingGestureOnly();
+
+public:
+	bool Start(GestureResultCallBack gesture_callback);
+	void Stop();
+
+	// image_data is packed BGR rows of image_stride bytes (0 for width * 3)
+	bool DetectFrame(int image_index, int image_width, int image_height, const void* image_data, int image_stride, GestureRecognitionResult& result);
+
+	// size of the last frame handed to the DLL
+	int GetInputWidth();
+	int GetInputHeight();
+
+	// Box-filters a BGR image down by factor; writes (width / factor) x (height / factor) packed pixels
+	static void DownscaleBGR(const unsigned char* src, int width, int height, int src_stride, int factor, unsigned char* dst);
+
+private:
+	static void LandmarksTrampoline(int image_index, PoseInfo* infos, int count);
+	static void GestureTrampoline(int image_index, int* recogn_result, int count);
+
+private:
+	static std::atomic<MediapipeHandTrackingGestureOnly*> s_ActiveGestureOnly;
+
+	MediapipeHandTrackingDll& m_HandTrackingDll;
+	GestureOnlyOptions m_Options;
+	GestureResultCallBack m_GestureCallback;
+	bool m_IsStarted;
+	std::vector<unsigned char> m_ScaledImage;
+	int m_InputWidth;
+	int m_InputHeight;
+};
+
+#endif // !MEDIAPIPE_HAND_TRACKING_GESTURE_ONLY_H
@@ -0,0 +1,236 @@
+#include "MediapipeHandTrackingGuarded.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+std::atomic<MediapipeHandTrackingGuarded*> MediapipeHandTrackingGuarded::s_ActiveGuarded(nullptr);
+
+const char* GetHandTrackingStatusName(HandTrackingStatus status)
+{
+	switch (status)
+	{
+	case HTS_Ok:
+		return "ok";
+	case HTS_No_Result:
+		return "no result";
+	case HTS_Invalid_Argument:
+		return "invalid argument";
+	case HTS_Timeout:
+		return "timeout";
+	case HTS_Busy:
+		return "busy";
+	case HTS_Not_Started:
+		return "not started";
+	}
+	return "unknown";
+}
+
+MediapipeHandTrackingGuarded::MediapipeHandTrackingGuarded(MediapipeHandTrackingDll& hand_tracking_dll, const GuardedDetectOptions& options)
+	: m_HandTrackingDll(hand_tracking_dll)
+	, m_Options(options)
+	, m_IsStarted(false)
+	, m_IsStopping(false)
+	, m_IsBusy(false)
+	, m_IsInDllCall(false)
+	, m_SubmittedSeq(0)
+	, m_DoneSeq(0)
+	, m_FrameWidth(0)
+	, m_FrameHeight(0)
+{
+	m_Options.m_Max_Image_Width = std::max(1, m_Options.m_Max_Image_Width);
+	m_Options.m_Max_Image_Height = std::max(1, m_Options.m_Max_Image_Height);
+	m_Options.m_Max_Landmarks = std::max(0, m_Options.m_Max_Landmarks);
+}
+
+MediapipeHandTrackingGuarded::~MediapipeHandTrackingGuarded()
+{
+	Stop();
+}
+
+bool MediapipeHandTrackingGuarded::Start()
+{
+	if (m_IsStarted)
+	{
+		return true;
+	}
+	if (m_HandTrackingDll.m_Mediapipe_Hand_Tracking_Detect_Frame_Direct == nullptr
+		|| m_HandTrackingDll.m_Mediapipe_Hand_Tracking_Reigeter_Landmarks_Callback == nullptr
+		|| m_HandTrackingDll.m_Mediapipe_Hand_Tracking_Register_Gesture_Result_Callback == nullptr)
+	{
+		return false;
+	}
+
+	MediapipeHandTrackingGuarded* expected = nullptr;
+	if (!s_ActiveGuarded.compare_exchange_strong(expected, this))
+	{
+		return false;
+	}
+	if (!m_HandTrackingDll.m_Mediapipe_Hand_Tracking_Reigeter_Landmarks_Callback(LandmarksTrampoline)
+		|| !m_HandTrackingDll.m_Mediapipe_Hand_Tracking_Register_Gesture_Result_Callback(GestureTrampoline))
+	{
+		s_ActiveGuarded.store(nullptr);
+		return false;
+	}
+
+	m_Result.m_Landmarks.reserve(m_Options.m_Max_Landmarks);
+	m_IsStopping = false;
+	m_IsBusy = false;
+	m_IsStarted = true;
+	m_WorkerThread = std::thread(&MediapipeHandTrackingGuarded::WorkerLoop, this);
+	return true;
+}
+
+void MediapipeHandTrackingGuarded::Stop()
+{
+	if (!m_IsStarted)
+	{
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_IsStopping = true;
+	}
+	m_WorkReady.notify_all();
+	if (m_WorkerThread.joinable())
+	{
+		m_WorkerThread.join();
+	}
+	m_IsStarted = false;
+	MediapipeHandTrackingGuarded* expected = this;
+	s_ActiveGuarded.compare_exchange_strong(expected, nullptr);
+}
+
+HandTrackingStatus MediapipeHandTrackingGuarded::DetectFrame(int image_index, int image_width, int image_height, const void* image_data, int image_stride, int timeout_ms, GuardedDetectResult& result)
+{
+	(void)image_index;
+	auto start = std::chrono::steady_clock::now();
+	result.m_Detect_Result = 0;
+	result.m_Gesture_Result = GestureRecognitionResult();
+	result.m_Landmarks.clear();
+	result.m_Latency_Ms = 0.0;
+
+	if (image_stride == 0)
+	{
+		image_stride = image_width * 3;
+	}
+	HandTrackingStatus status = HTS_Ok;
+	if (!m_IsStarted)
+	{
+		status = HTS_Not_Started;
+	}
+	else if (image_data == nullptr || image_width <= 0 || image_height <= 0
+		|| image_width > m_Options.m_Max_Image_Width || image_height > m_Options.m_Max_Image_Height
+		|| image_stride < image_width * 3)
+	{
+		status = HTS_Invalid_Argument;
+	}
+
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	if (status == HTS_Ok && m_IsBusy)
+	{
+		status = HTS_Busy;
+	}
+	if (status != HTS_Ok)
+	{
+		++m_Stats.m_Status_Counts[status];
+		result.m_Status = status;
+		return status;
+	}
+
+	// the worker is idle, so the frame buffer is ours until m_IsBusy is set
+	const size_t rowBytes = (size_t)image_width * 3;
+	m_Frame.resize(rowBytes * image_height);
+	if ((size_t)image_stride == rowBytes)
+	{
+		memcpy(m_Frame.data(), image_data, m_Frame.size());
+	}
+	else
+	{
+		for (int y = 0; y < image_height; ++y)
+		{
+			memcpy(m_Frame.data() + y * rowBytes, (const unsigned char*)image_data + (size_t)y * image_stride, rowBytes);
+		}
+	}
+	m_FrameWidth = image_width;
+	m_FrameHeight = image_height;
+	m_IsBusy = true;
+	const unsigned long long seq = ++m_SubmittedSeq;
+	m_WorkReady.notify_one();
+
+	bool isDone = m_WorkDone.wait_for(lock, std::chrono::milliseconds(std::max(0, timeout_ms)), [this, seq] { return m_DoneSeq >= seq; });
+	if (!isDone)
+	{
+		// the worker discards this frame's results when it gets back
+		status = HTS_Timeout;
+	}
+	else
+	{
+		result.m_Detect_Result = m_Result.m_Detect_Result;
+		result.m_Gesture_Result = m_Result.m_Gesture_Result;
+		result.m_Landmarks.assign(m_Result.m_Landmarks.begin(), m_Result.m_Landmarks.end());
+		status = m_Result.m_Detect_Result != 0 ? HTS_Ok : HTS_No_Result;
+	}
+	++m_Stats.m_Status_Counts[status];
+	result.m_Status = status;
+	result.m_Latency_Ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	return status;
+}
+
+GuardedDetectStats MediapipeHandTrackingGuarded::GetStats()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_Stats;
+}
+
+void MediapipeHandTrackingGuarded::WorkerLoop()
+{
+	std::unique_lock<std::mutex> lock(m_Mutex);
+	unsigned long long served = 0;
+	while (true)
+	{
+		m_WorkReady.wait(lock, [this, served] { return m_IsStopping || m_SubmittedSeq > served; });
+		if (m_SubmittedSeq == served)
+		{
+			return;
+		}
+		served = m_SubmittedSeq;
+		lock.unlock();
+
+		m_Result.m_Detect_Result = 0;
+		m_Result.m_Gesture_Result = GestureRecognitionResult();
+		m_Result.m_Landmarks.clear();
+		auto callStart = std::chrono::steady_clock::now();
+		m_IsInDllCall.store(true);
+		int detected = m_HandTrackingDll.m_Mediapipe_Hand_Tracking_Detect_Frame_Direct(m_FrameWidth, m_FrameHeight, m_Frame.data(), m_Result.m_Gesture_Result);
+		m_IsInDllCall.store(false);
+		double callMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - callStart).count();
+
+		lock.lock();
+		m_Result.m_Detect_Result = detected;
+		m_Stats.m_Longest_Call_Ms = std::max(m_Stats.m_Longest_Call_Ms, callMs);
+		m_DoneSeq = served;
+		m_IsBusy = false;
+		m_WorkDone.notify_all();
+	}
+}
+
+void MediapipeHandTrackingGuarded::LandmarksTrampoline(int image_index, PoseInfo* infos, int count)
+{
+	(void)image_index;
+	// fires on the worker inside Detect_Frame_Direct, while it owns m_Result
+	MediapipeHandTrackingGuarded* guarded = s_ActiveGuarded.load();
+	if (guarded != nullptr && guarded->m_IsInDllCall.load() && infos != nullptr && count > 0)
+	{
+		int copyCount = std::min(count, guarded->m_Options.m_Max_Landmarks);
+		guarded->m_Result.m_Landmarks.assign(infos, infos + copyCount);
+	}
+}
+
+void MediapipeHandTrackingGuarded::GestureTrampoline(int image_index, int* recogn_result, int count)
+{
+	// Detect_Frame_Direct already fills the gesture result
+	(void)image_index;
+	(void)recogn_result;
+	(void)count;
+}
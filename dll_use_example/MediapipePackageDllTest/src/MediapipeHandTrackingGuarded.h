@@ -0,0 +1,111 @@
+#ifndef MEDIAPIPE_HAND_TRACKING_GUARDED_H
+#define MEDIAPIPE_HAND_TRACKING_GUARDED_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "MediapipeHandTrackingDll.h"
+
+//!
+//! @brief - Detect calls with a deadline and a typed status instead of an open-ended block
+//!
+//! A frame the graph chokes on can keep Detect_Frame_Direct from returning for a long
+//! time. Here the DLL runs on one worker thread; DetectFrame copies the frame to it
+//! and waits at most timeout_ms. A frame that misses the deadline is abandoned: the
+//! caller gets HTS_Timeout at once, and whatever the DLL reports for it later is
+//! thrown away. While the DLL is still inside an abandoned call, new frames fail with
+//! HTS_Busy without waiting, so the capture thread never stalls behind it and the
+//! graph is left to finish on its own rather than being reinitialized.
+//!
+//! Frames that cannot be valid (no data, sizes out of range, stride shorter than a
+//! row) fail with HTS_Invalid_Argument before they reach the DLL.
+//!
+//! While started this class owns both DLL callbacks and copies the landmarks into
+//! the result; only one instance may be started at a time.
+//!
+
+enum HandTrackingStatus
+{
+	HTS_Ok = 0,					// the DLL returned non-zero
+	HTS_No_Result = 1,			// the DLL returned 0: no hand, or a failure it does not tell apart
+	HTS_Invalid_Argument = 2,	// rejected before the DLL
+	HTS_Timeout = 3,			// abandoned after timeout_ms; the DLL may still be working on it
+	HTS_Busy = 4,				// the DLL has not returned from an abandoned frame yet
+	HTS_Not_Started = 5
+};
+
+struct GuardedDetectOptions
+{
+	int m_Max_Image_Width = 4096;
+	int m_Max_Image_Height = 4096;
+	int m_Max_Landmarks = 126;
+};
+
+struct GuardedDetectResult
+{
+	HandTrackingStatus m_Status = HTS_Not_Started;
+	int m_Detect_Result = 0;
+	GestureRecognitionResult m_Gesture_Result;
+	std::vector<PoseInfo> m_Landmarks;		// empty when the landmark callback did not fire
+	double m_Latency_Ms = 0.0;				// time the caller waited
+};
+
+struct GuardedDetectStats
+{
+	unsigned long long m_Status_Counts[HTS_Not_Started + 1] = { 0 };
+	double m_Longest_Call_Ms = 0.0;			// longest time the DLL spent in one call, abandoned ones included
+};
+
+const char* GetHandTrackingStatusName(HandTrackingStatus status);
+
+class MediapipeHandTrackingGuarded
+{
+public:
+	MediapipeHandTrackingGuarded(MediapipeHandTrackingDll& hand_tracking_dll, const GuardedDetectOptions& options = GuardedDetectOptions());
+	virtual~MediapipeHandTrackingGuarded();
+
+public:
+	bool Start();
+	// Waits for the worker, and so for a call still inside the DLL
+	void Stop();
+
+	// image_data is BGR rows of image_stride bytes (0 for width * 3)
+	HandTrackingStatus DetectFrame(int image_index, int image_width, int image_height, const void* image_data, int image_stride, int timeout_ms, GuardedDetectResult& result);
+
+	GuardedDetectStats GetStats();
+
+private:
+	void WorkerLoop();
+
+	static void LandmarksTrampoline(int image_index, PoseInfo* infos, int count);
+	static void GestureTrampoline(int image_index, int* recogn_result, int count);
+
+private:
+	static std::atomic<MediapipeHandTrackingGuarded*> s_ActiveGuarded;
+
+	MediapipeHandTrackingDll& m_HandTrackingDll;
+	GuardedDetectOptions m_Options;
+
+	std::mutex m_Mutex;
+	std::condition_variable m_WorkReady;
+	std::condition_variable m_WorkDone;
+	std::thread m_WorkerThread;
+	bool m_IsStarted;
+	bool m_IsStopping;
+	bool m_IsBusy;							// the worker owns m_Frame and m_Result
+	std::atomic<bool> m_IsInDllCall;		// landmark callbacks outside the worker's call are dropped
+	unsigned long long m_SubmittedSeq;
+	unsigned long long m_DoneSeq;
+	GuardedDetectStats m_Stats;
+
+	// written by the worker only while m_IsBusy
+	std::vector<unsigned char> m_Frame;
+	int m_FrameWidth;
+	int m_FrameHeight;
+	GuardedDetectResult m_Result;
+};
+
+#endif // !MEDIAPIPE_HAND_TRACKING_GUARDED_H
@@ -0,0 +1,270 @@
+#include "MediapipeHandTrackingHotSwap.h"
+
+#include <chrono>
+
+namespace
+{
+	// the first inferences allocate tensors and pick kernels; pay for them before going live
+	const int kWarmUpFrameCount = 2;
+	// a handle still held after this is a caller bug; its owner closes the module instead
+	const std::chrono::milliseconds kDrainTimeout(5000);
+}
+
+MediapipeHandTrackingHotSwap::MediapipeHandTrackingHotSwap()
+	: m_LandmarksCallback(nullptr)
+	, m_GestureCallback(nullptr)
+	, m_LastImageWidth(640)
+	, m_LastImageHeight(480)
+	, m_SwapState(HSS_Idle)
+{
+}
+
+MediapipeHandTrackingHotSwap::~MediapipeHandTrackingHotSwap()
+{
+	Unload();
+}
+
+bool MediapipeHandTrackingHotSwap::Load(const std::string& dll_path, const std::string& model_path, LandmarksCallBack landmarks_callback, GestureResultCallBack gesture_callback)
+{
+	std::lock_guard<std::mutex> lock(m_SwapMutex);
+	if (AcquireModule() != nullptr)
+	{
+		return false;
+	}
+
+	m_ModelPath = model_path;
+	m_LandmarksCallback = landmarks_callback;
+	m_GestureCallback = gesture_callback;
+
+	std::shared_ptr<ModuleEntry> module = OpenModule(dll_path);
+	if (module == nullptr || !RegisterCallbacks(*module))
+	{
+		// the only handle, so the deleter closes it right here
+		module.reset();
+		return false;
+	}
+
+	std::atomic_store(&m_ActiveModule, module);
+	return true;
+}
+
+void MediapipeHandTrackingHotSwap::Unload()
+{
+	WaitForSwap();
+
+	std::lock_guard<std::mutex> lock(m_SwapMutex);
+	std::shared_ptr<ModuleEntry> module = std::atomic_exchange(&m_ActiveModule, std::shared_ptr<ModuleEntry>());
+	if (module != nullptr)
+	{
+		DrainModule(module);
+	}
+}
+
+bool MediapipeHandTrackingHotSwap::BeginSwap(const std::string& dll_path)
+{
+	std::lock_guard<std::mutex> lock(m_SwapMutex);
+	int state = m_SwapState.load();
+	if (state == HSS_Preparing || state == HSS_Draining)
+	{
+		return false;
+	}
+
+	std::shared_ptr<ModuleEntry> active = AcquireModule();
+	if (active == nullptr || active->m_Dll_Path == dll_path)
+	{
+		return false;
+	}
+
+	if (m_SwapThread.joinable())
+	{
+		m_SwapThread.join();
+	}
+	m_SwapState = HSS_Preparing;
+	m_SwapThread = std::thread(&MediapipeHandTrackingHotSwap::SwapThread, this, dll_path);
+	return true;
+}
+
+bool MediapipeHandTrackingHotSwap::WaitForSwap()
+{
+	std::lock_guard<std::mutex> lock(m_SwapMutex);
+	if (m_SwapThread.joinable())
+	{
+		m_SwapThread.join();
+	}
+	return m_SwapState.load() == HSS_Idle;
+}
+
+HotSwapState MediapipeHandTrackingHotSwap::GetSwapState()
+{
+	return (HotSwapState)m_SwapState.load();
+}
+
+std::string MediapipeHandTrackingHotSwap::GetActiveDllPath()
+{
+	std::shared_ptr<ModuleEntry> module = AcquireModule();
+	return module != nullptr ? module->m_Dll_Path : std::string();
+}
+
+int MediapipeHandTrackingHotSwap::DetectFrame(int image_index, int image_width, int image_height, void* image_data)
+{
+	std::shared_ptr<ModuleEntry> module = AcquireModule();
+	if (module == nullptr)
+	{
+		return 0;
+	}
+
+	m_LastImageWidth.store(image_width, std::memory_order_relaxed);
+	m_LastImageHeight.store(image_height, std::memory_order_relaxed);
+	return module->m_Dll.m_Mediapipe_Hand_Tracking_Detect_Frame(image_index, image_width, image_height, image_data);
+}
+
+int MediapipeHandTrackingHotSwap::DetectFrameDirect(int image_width, int image_height, void* image_data, GestureRecognitionResult& gesture_result)
+{
+	std::shared_ptr<ModuleEntry> module = AcquireModule();
+	if (module == nullptr)
+	{
+		return 0;
+	}
+
+	m_LastImageWidth.store(image_width, std::memory_order_relaxed);
+	m_LastImageHeight.store(image_height, std::memory_order_relaxed);
+	return module->m_Dll.m_Mediapipe_Hand_Tracking_Detect_Frame_Direct(image_width, image_height, image_data, gesture_result);
+}
+
+std::shared_ptr<MediapipeHandTrackingDll> MediapipeHandTrackingHotSwap::GetActiveModule()
+{
+	std::shared_ptr<ModuleEntry> module = AcquireModule();
+	if (module == nullptr)
+	{
+		return nullptr;
+	}
+	// aliasing constructor: the returned pointer keeps the whole entry alive
+	return std::shared_ptr<MediapipeHandTrackingDll>(module, &module->m_Dll);
+}
+
+std::shared_ptr<MediapipeHandTrackingHotSwap::ModuleEntry> MediapipeHandTrackingHotSwap::OpenModule(const std::string& dll_path)
+{
+	std::shared_ptr<ModuleEntry> module(new ModuleEntry(), &MediapipeHandTrackingHotSwap::ReleaseModule);
+	module->m_Dll_Path = dll_path;
+	module->m_Drain = std::make_shared<ModuleDrain>();
+
+	if (!module->m_Dll.LoadMediapipeHandTrackingDll(dll_path))
+	{
+		return nullptr;
+	}
+	if (!module->m_Dll.GetAllFunctions() || !module->m_Dll.m_Mediapipe_Hand_Tracking_Init(m_ModelPath.c_str()))
+	{
+		module->m_Dll.UnLoadMediapipeHandTrackingDll();
+		return nullptr;
+	}
+	module->m_Is_Initialized = true;
+	return module;
+}
+
+bool MediapipeHandTrackingHotSwap::RegisterCallbacks(ModuleEntry& module)
+{
+	if (m_LandmarksCallback != nullptr && !module.m_Dll.m_Mediapipe_Hand_Tracking_Reigeter_Landmarks_Callback(m_LandmarksCallback))
+	{
+		return false;
+	}
+	if (m_GestureCallback != nullptr && !module.m_Dll.m_Mediapipe_Hand_Tracking_Register_Gesture_Result_Callback(m_GestureCallback))
+	{
+		return false;
+	}
+	return true;
+}
+
+void MediapipeHandTrackingHotSwap::WarmUp(ModuleEntry& module)
+{
+	int width = m_LastImageWidth.load(std::memory_order_relaxed);
+	int height = m_LastImageHeight.load(std::memory_order_relaxed);
+	std::vector<unsigned char> blankFrame((size_t)width * height * 3, 0);
+
+	for (int i = 0; i < kWarmUpFrameCount; ++i)
+	{
+		GestureRecognitionResult ignored;
+		module.m_Dll.m_Mediapipe_Hand_Tracking_Detect_Frame_Direct(width, height, blankFrame.data(), ignored);
+	}
+}
+
+void MediapipeHandTrackingHotSwap::ReleaseModule(ModuleEntry* module)
+{
+	std::shared_ptr<ModuleDrain> drain = module->m_Drain;
+	if (drain != nullptr)
+	{
+		std::lock_guard<std::mutex> lock(drain->m_Mutex);
+		if (drain->m_Is_Waiting)
+		{
+			// the drainer closes it on its own thread, off this caller's frame
+			drain->m_Is_Released = true;
+			drain->m_Released_Condition.notify_one();
+			return;
+		}
+	}
+	CloseModule(module);
+}
+
+void MediapipeHandTrackingHotSwap::CloseModule(ModuleEntry* module)
+{
+	// the graph is stopped before the code it runs is unmapped
+	if (module->m_Is_Initialized)
+	{
+		module->m_Dll.m_Mediapipe_Hand_Tracking_Release();
+		module->m_Dll.UnLoadMediapipeHandTrackingDll();
+	}
+	delete module;
+}
+
+bool MediapipeHandTrackingHotSwap::DrainModule(std::shared_ptr<ModuleEntry>& module)
+{
+	ModuleEntry* entry = module.get();
+	std::shared_ptr<ModuleDrain> drain = entry->m_Drain;
+	{
+		std::lock_guard<std::mutex> lock(drain->m_Mutex);
+		drain->m_Is_Waiting = true;
+	}
+	// Once unpublished nobody can acquire the module again; the last handle runs the deleter
+	module.reset();
+
+	std::unique_lock<std::mutex> lock(drain->m_Mutex);
+	bool released = drain->m_Released_Condition.wait_for(lock, kDrainTimeout, [&drain]() { return drain->m_Is_Released; });
+	drain->m_Is_Waiting = false;
+	lock.unlock();
+	if (released)
+	{
+		CloseModule(entry);
+	}
+	return released;
+}
+
+void MediapipeHandTrackingHotSwap::SwapThread(std::string dll_path)
+{
+	std::shared_ptr<ModuleEntry> module = OpenModule(dll_path);
+	if (module == nullptr)
+	{
+		m_SwapState = HSS_Failed;
+		return;
+	}
+
+	// callbacks are registered after the warm-up so blank frames never reach the caller
+	WarmUp(*module);
+	if (!RegisterCallbacks(*module))
+	{
+		module.reset();
+		m_SwapState = HSS_Failed;
+		return;
+	}
+
+	std::shared_ptr<ModuleEntry> previous = std::atomic_exchange(&m_ActiveModule, module);
+	module.reset();
+	m_SwapState = HSS_Draining;
+
+	// the new module is live either way; a held handle past the timeout closes the old one itself
+	DrainModule(previous);
+	m_SwapState = HSS_Idle;
+}
+
+std::shared_ptr<MediapipeHandTrackingHotSwap::ModuleEntry> MediapipeHandTrackingHotSwap::AcquireModule()
+{
+	return std::atomic_load(&m_ActiveModule);
+}
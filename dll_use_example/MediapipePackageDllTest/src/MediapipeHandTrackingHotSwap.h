@@ -0,0 +1,112 @@
+#ifndef MEDIAPIPE_HAND_TRACKING_HOT_SWAP_H
+#define MEDIAPIPE_HAND_TRACKING_HOT_SWAP_H
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "MediapipeHandTrackingDll.h"
+
+//!
+//! @brief - Replace the tracking DLL while frames keep flowing
+//!
+//! BeginSwap loads the new DLL next to the running one on a background thread,
+//! initializes it and runs warm-up frames through it, then publishes it with a
+//! single atomic pointer store. Capture threads keep calling DetectFrame /
+//! DetectFrameDirect throughout; calls that started on the old module finish on
+//! it, and the old module is released and unloaded once the last of them returns.
+//!
+//! The last reference to a module signals the draining thread through the shared_ptr
+//! deleter, so draining takes no polling. Handles from GetActiveModule count as calls:
+//! callers must drop them once their call returns. Draining waits at most 5 seconds;
+//! after that the swap (or Unload) finishes anyway and the old module is released and
+//! unloaded by whichever thread drops its last handle.
+//!
+//! Each version must be a separate file, e.g. Mediapipe_Hand_Tracking_v2.dll:
+//! the OS hands back the already loaded module for a path it has seen, and the
+//! DLL keeps its graph in globals, so two copies only coexist as two files.
+//!
+
+enum HotSwapState
+{
+	HSS_Idle = 0,			// no swap running; the last one (if any) succeeded
+	HSS_Preparing = 1,		// loading, initializing and warming up the new module
+	HSS_Draining = 2,		// new module is live; waiting for calls on the old one
+	HSS_Failed = 3			// the last swap failed; the previous module is still live
+};
+
+class MediapipeHandTrackingHotSwap
+{
+public:
+	MediapipeHandTrackingHotSwap();
+	virtual~MediapipeHandTrackingHotSwap();
+
+public:
+	// Synchronous first load; callbacks are registered again on every swapped-in module
+	bool Load(const std::string& dll_path, const std::string& model_path, LandmarksCallBack landmarks_callback = nullptr, GestureResultCallBack gesture_callback = nullptr);
+	void Unload();
+
+	// Returns false if no module is loaded, a swap is already running or dll_path is the live module
+	bool BeginSwap(const std::string& dll_path);
+	// Blocks until the running swap (including draining, bounded) is finished; true if it succeeded
+	bool WaitForSwap();
+	HotSwapState GetSwapState();
+	std::string GetActiveDllPath();
+
+	int DetectFrame(int image_index, int image_width, int image_height, void* image_data);
+	int DetectFrameDirect(int image_width, int image_height, void* image_data, GestureRecognitionResult& gesture_result);
+
+	// Keeps the current module alive while held; drop it as soon as the call returns
+	std::shared_ptr<MediapipeHandTrackingDll> GetActiveModule();
+
+private:
+	// Hand-off between a module's deleter and the thread draining it
+	struct ModuleDrain
+	{
+		std::mutex m_Mutex;
+		std::condition_variable m_Released_Condition;
+		bool m_Is_Waiting = false;				// a drainer takes the module over from the deleter
+		bool m_Is_Released = false;
+	};
+
+	struct ModuleEntry
+	{
+		MediapipeHandTrackingDll m_Dll;
+		std::string m_Dll_Path;
+		bool m_Is_Initialized = false;			// Init succeeded, Release is due
+		std::shared_ptr<ModuleDrain> m_Drain;
+	};
+
+	std::shared_ptr<ModuleEntry> OpenModule(const std::string& dll_path);
+	bool RegisterCallbacks(ModuleEntry& module);
+	void WarmUp(ModuleEntry& module);
+	// shared_ptr deleter: closes the module, or hands it to a waiting drainer
+	static void ReleaseModule(ModuleEntry* module);
+	static void CloseModule(ModuleEntry* module);
+	// Drops module and waits, bounded, until every other handle is gone and the module is closed
+	static bool DrainModule(std::shared_ptr<ModuleEntry>& module);
+	void SwapThread(std::string dll_path);
+	std::shared_ptr<ModuleEntry> AcquireModule();
+
+private:
+	// read with std::atomic_load, replaced with std::atomic_store
+	std::shared_ptr<ModuleEntry> m_ActiveModule;
+
+	std::string m_ModelPath;
+	LandmarksCallBack m_LandmarksCallback;
+	GestureResultCallBack m_GestureCallback;
+
+	// size of the last frame seen, used for the warm-up frames of the next module
+	std::atomic<int> m_LastImageWidth;
+	std::atomic<int> m_LastImageHeight;
+
+	std::atomic<int> m_SwapState;
+	std::mutex m_SwapMutex;
+	std::thread m_SwapThread;
+};
+
+#endif // !MEDIAPIPE_HAND_TRACKING_HOT_SWAP_H
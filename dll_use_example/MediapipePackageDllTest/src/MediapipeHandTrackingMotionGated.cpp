@@ -0,0 +1,167 @@
+#include "MediapipeHandTrackingMotionGated.h"
+
+#include <chrono>
+
+std::atomic<MediapipeHandTrackingMotionGated*> MediapipeHandTrackingMotionGated::s_ActiveGated(nullptr);
+
+MediapipeHandTrackingMotionGated::MediapipeHandTrackingMotionGated(MediapipeHandTrackingDll& hand_tracking_dll, const MotionGateOptions& options, const IdleThrottleOptions& idle_options)
+	: m_HandTrackingDll(hand_tracking_dll)
+	, m_MotionGate(options)
+	, m_IdleThrottle(idle_options)
+	, m_HasLastResult(false)
+	, m_IsStarted(false)
+	, m_ProcessedFrameCount(0)
+	, m_CachedFrameCount(0)
+	, m_Metrics(nullptr)
+{
+}
+
+MediapipeHandTrackingMotionGated::~MediapipeHandTrackingMotionGated()
+{
+	Stop();
+}
+
+bool MediapipeHandTrackingMotionGated::Start()
+{
+	if (m_IsStarted)
+	{
+		return true;
+	}
+	if (m_HandTrackingDll.m_Mediapipe_Hand_Tracking_Detect_Frame_Direct == nullptr
+		|| m_HandTrackingDll.m_Mediapipe_Hand_Tracking_Reigeter_Landmarks_Callback == nullptr
+		|| m_HandTrackingDll.m_Mediapipe_Hand_Tracking_Register_Gesture_Result_Callback == nullptr)
+	{
+		return false;
+	}
+
+	MediapipeHandTrackingMotionGated* expected = nullptr;
+	if (!s_ActiveGated.compare_exchange_strong(expected, this))
+	{
+		return false;
+	}
+	if (!m_HandTrackingDll.m_Mediapipe_Hand_Tracking_Reigeter_Landmarks_Callback(LandmarksTrampoline)
+		|| !m_HandTrackingDll.m_Mediapipe_Hand_Tracking_Register_Gesture_Result_Callback(GestureTrampoline))
+	{
+		s_ActiveGated.store(nullptr);
+		return false;
+	}
+
+	m_MotionGate.Reset();
+	m_IdleThrottle.Reset();
+	m_HasLastResult = false;
+	m_IsStarted = true;
+	return true;
+}
+
+void MediapipeHandTrackingMotionGated::Stop()
+{
+	if (!m_IsStarted)
+	{
+		return;
+	}
+	m_IsStarted = false;
+	MediapipeHandTrackingMotionGated* expected = this;
+	s_ActiveGated.compare_exchange_strong(expected, nullptr);
+}
+
+void MediapipeHandTrackingMotionGated::SetMetrics(TrackerMetrics* metrics)
+{
+	m_Metrics = metrics;
+}
+
+bool MediapipeHandTrackingMotionGated::DetectFrame(int image_width, int image_height, void* image_data, MotionGatedHandResult& result)
+{
+	if (!m_IsStarted)
+	{
+		return false;
+	}
+
+	if (m_Metrics != nullptr)
+	{
+		m_Metrics->AddSubmitted();
+	}
+	bool isStatic = m_MotionGate.IsStatic(image_width, image_height, (const unsigned char*)image_data);
+	bool isIdleSkip = !m_IdleThrottle.ShouldRun();
+	if (m_HasLastResult && (isStatic || isIdleSkip))
+	{
+		++m_CachedFrameCount;
+		if (m_Metrics != nullptr)
+		{
+			m_Metrics->AddCached();
+		}
+		result = m_LastResult;
+		result.m_Is_Cached = true;
+		result.m_Is_Idle = m_IdleThrottle.IsIdle();
+		return true;
+	}
+
+	// Detect_Frame_Direct returns after the frame's callbacks have fired; no landmark
+	// callback means no hand
+	m_LastResult.m_Landmarks.clear();
+	m_LastResult.m_Gesture_Result = GestureRecognitionResult();
+	std::chrono::steady_clock::time_point detectStart = std::chrono::steady_clock::now();
+	m_LastResult.m_Detect_Result = m_HandTrackingDll.m_Mediapipe_Hand_Tracking_Detect_Frame_Direct(image_width, image_height, image_data, m_LastResult.m_Gesture_Result);
+	if (m_Metrics != nullptr)
+	{
+		double detectMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - detectStart).count();
+		m_Metrics->AddProcessed(detectMs, m_LastResult.m_Detect_Result != 0, !m_LastResult.m_Landmarks.empty());
+		m_Metrics->AddResultLatency(detectMs);
+	}
+	m_LastResult.m_Is_Cached = false;
+	m_LastResult.m_Is_Idle = m_IdleThrottle.IsIdle();
+	m_IdleThrottle.ReportResult(!m_LastResult.m_Landmarks.empty());
+	++m_ProcessedFrameCount;
+
+	if (m_LastResult.m_Detect_Result != 0)
+	{
+		m_MotionGate.Accept();
+		m_HasLastResult = true;
+	}
+	else
+	{
+		// never re-emit a failed frame
+		m_MotionGate.Reset();
+		m_HasLastResult = false;
+	}
+
+	result = m_LastResult;
+	return result.m_Detect_Result != 0;
+}
+
+MotionGate& MediapipeHandTrackingMotionGated::GetMotionGate()
+{
+	return m_MotionGate;
+}
+
+IdleThrottle& MediapipeHandTrackingMotionGated::GetIdleThrottle()
+{
+	return m_IdleThrottle;
+}
+
+unsigned long long MediapipeHandTrackingMotionGated::GetProcessedFrameCount()
+{
+	return m_ProcessedFrameCount;
+}
+
+unsigned long long MediapipeHandTrackingMotionGated::GetCachedFrameCount()
+{
+	return m_CachedFrameCount;
+}
+
+void MediapipeHandTrackingMotionGated::LandmarksTrampoline(int image_index, PoseInfo* infos, int count)
+{
+	(void)image_index;
+	MediapipeHandTrackingMotionGated* gated = s_ActiveGated.load(std::memory_order_acquire);
+	if (gated != nullptr && infos != nullptr && count > 0)
+	{
+		gated->m_LastResult.m_Landmarks.assign(infos, infos + count);
+	}
+}
+
+void MediapipeHandTrackingMotionGated::GestureTrampoline(int image_index, int* recogn_result, int count)
+{
+	// Detect_Frame_Direct already returns the gesture result
+	(void)image_index;
+	(void)recogn_result;
+	(void)count;
+}
@@ -0,0 +1,71 @@
+#ifndef MEDIAPIPE_HAND_TRACKING_MOTION_GATED_H
+#define MEDIAPIPE_HAND_TRACKING_MOTION_GATED_H
+
+#include <atomic>
+#include <vector>
+
+#include "MediapipeHandTrackingDll.h"
+#include "IdleThrottle.h"
+#include "MotionGate.h"
+#include "TrackerMetrics.h"
+
+//!
+//! @brief - Mediapipe_Hand_Tracking_Detect_Frame_Direct behind a MotionGate
+//!
+//! When the gate reports a static scene, the DLL is not called and the result of the
+//! last processed frame is returned again with m_Is_Cached set. Landmarks are
+//! collected through the DLL's landmark callback, so while started this class owns
+//! both callbacks; only one instance may be started at a time.
+//!
+//! With idle options set, frames between idle polls are answered the same way once no
+//! hand has been seen for a while (see IdleThrottle).
+//!
+
+struct MotionGatedHandResult
+{
+	int m_Detect_Result = 0;
+	bool m_Is_Cached = false;				// true when re-emitted from the last processed frame
+	bool m_Is_Idle = false;					// the tracker was idle-polling when this frame arrived
+	GestureRecognitionResult m_Gesture_Result;
+	std::vector<PoseInfo> m_Landmarks;		// empty when no hand was found
+};
+
+class MediapipeHandTrackingMotionGated
+{
+public:
+	MediapipeHandTrackingMotionGated(MediapipeHandTrackingDll& hand_tracking_dll, const MotionGateOptions& options = MotionGateOptions(), const IdleThrottleOptions& idle_options = IdleThrottleOptions());
+	virtual~MediapipeHandTrackingMotionGated();
+
+public:
+	bool Start();
+	void Stop();
+	// optional, must outlive the tracker
+	void SetMetrics(TrackerMetrics* metrics);
+
+	// image_data is densely packed BGR, as Detect_Frame_Direct expects
+	bool DetectFrame(int image_width, int image_height, void* image_data, MotionGatedHandResult& result);
+
+	MotionGate& GetMotionGate();
+	IdleThrottle& GetIdleThrottle();
+	unsigned long long GetProcessedFrameCount();
+	unsigned long long GetCachedFrameCount();
+
+private:
+	static void LandmarksTrampoline(int image_index, PoseInfo* infos, int count);
+	static void GestureTrampoline(int image_index, int* recogn_result, int count);
+
+private:
+	static std::atomic<MediapipeHandTrackingMotionGated*> s_ActiveGated;
+
+	MediapipeHandTrackingDll& m_HandTrackingDll;
+	MotionGate m_MotionGate;
+	IdleThrottle m_IdleThrottle;
+	MotionGatedHandResult m_LastResult;
+	bool m_HasLastResult;
+	bool m_IsStarted;
+	unsigned long long m_ProcessedFrameCount;
+	unsigned long long m_CachedFrameCount;
+	TrackerMetrics* m_Metrics;
+};
+
+#endif // !MEDIAPIPE_HAND_TRACKING_MOTION_GATED_H
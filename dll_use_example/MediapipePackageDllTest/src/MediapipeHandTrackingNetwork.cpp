@@ -0,0 +1,332 @@
+#include "MediapipeHandTrackingNetwork.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include "MediapipeHandTrackingGestureOnly.h"
+
+namespace
+{
+	// beyond this the box filter's fixed-point reciprocal is no longer within rounding
+	const int kMaxDownscale = 8;
+
+	int DownscaleFor(int width, int height, int max_side)
+	{
+		int longSide = std::max(width, height);
+		int factor = (longSide + max_side - 1) / std::max(1, max_side);
+		return std::min(kMaxDownscale, std::max(1, factor));
+	}
+}
+
+MediapipeHandTrackingNetwork::Connection MediapipeHandTrackingNetwork::s_Connection;
+
+MediapipeHandTrackingNetwork::MediapipeHandTrackingNetwork()
+	: m_Connected(false)
+{
+}
+
+MediapipeHandTrackingNetwork::~MediapipeHandTrackingNetwork()
+{
+	Disconnect();
+}
+
+bool MediapipeHandTrackingNetwork::Connect(const std::string& host, int port, const NetworkOffloadOptions& options, int timeout_ms)
+{
+	std::lock_guard<std::mutex> lock(s_Connection.m_Mutex);
+	if (s_Connection.m_Socket != TRACKING_INVALID_SOCKET)
+	{
+		return false;
+	}
+#if defined(WINDOWS)
+	WSADATA wsaData;
+	if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+	{
+		return false;
+	}
+#endif
+
+	addrinfo hints;
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_STREAM;
+	addrinfo* addresses = nullptr;
+	if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0 || addresses == nullptr)
+	{
+#if defined(WINDOWS)
+		WSACleanup();
+#endif
+		return false;
+	}
+
+	// the service may still be loading the graph
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+	TrackingSocketHandle socketHandle = TRACKING_INVALID_SOCKET;
+	while (socketHandle == TRACKING_INVALID_SOCKET)
+	{
+		for (addrinfo* address = addresses; address != nullptr; address = address->ai_next)
+		{
+			socketHandle = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+			if (socketHandle == TRACKING_INVALID_SOCKET)
+			{
+				continue;
+			}
+			if (connect(socketHandle, address->ai_addr, (int)address->ai_addrlen) == 0)
+			{
+				break;
+			}
+			CloseTrackingSocket(socketHandle);
+			socketHandle = TRACKING_INVALID_SOCKET;
+		}
+		if (socketHandle != TRACKING_INVALID_SOCKET || std::chrono::steady_clock::now() >= deadline)
+		{
+			break;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	}
+	freeaddrinfo(addresses);
+	if (socketHandle == TRACKING_INVALID_SOCKET)
+	{
+#if defined(WINDOWS)
+		WSACleanup();
+#endif
+		return false;
+	}
+
+	// a service that stops answering fails the request instead of hanging the caller
+#if defined(WINDOWS)
+	DWORD receiveTimeout = (DWORD)std::max(1000, timeout_ms);
+#else
+	timeval receiveTimeout = { std::max(1000, timeout_ms) / 1000, (std::max(1000, timeout_ms) % 1000) * 1000 };
+#endif
+	setsockopt(socketHandle, SOL_SOCKET, SO_RCVTIMEO, (const char*)&receiveTimeout, sizeof(receiveTimeout));
+	SetTrackingSocketNoDelay(socketHandle);
+
+	s_Connection.m_Socket = socketHandle;
+	s_Connection.m_Options = options;
+	s_Connection.m_Options.m_Max_Crop_Side = std::max(16, options.m_Max_Crop_Side);
+	s_Connection.m_Options.m_Max_Full_Frame_Side = std::max(16, options.m_Max_Full_Frame_Side);
+	s_Connection.m_Options.m_Crop_Margin = std::max(0.0f, options.m_Crop_Margin);
+	s_Connection.m_Stats = NetworkOffloadStats();
+	s_Connection.m_Roi_Width = 0;
+	s_Connection.m_Frames_Since_Full = 0;
+
+	m_Mediapipe_Hand_Tracking_Init = StubInit;
+	m_Mediapipe_Hand_Tracking_Reigeter_Landmarks_Callback = StubRegisterLandmarksCallback;
+	m_Mediapipe_Hand_Tracking_Register_Gesture_Result_Callback = StubRegisterGestureResultCallback;
+	m_Mediapipe_Hand_Tracking_Detect_Frame = StubDetectFrame;
+	m_Mediapipe_Hand_Tracking_Detect_Frame_Direct = StubDetectFrameDirect;
+	m_Mediapipe_Hand_Tracking_Detect_Video = StubDetectVideo;
+	m_Mediapipe_Hand_Tracking_Release = StubRelease;
+	m_Connected = true;
+	return true;
+}
+
+void MediapipeHandTrackingNetwork::Disconnect()
+{
+	if (!m_Connected)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(s_Connection.m_Mutex);
+	if (s_Connection.m_Socket != TRACKING_INVALID_SOCKET)
+	{
+		CloseTrackingSocket(s_Connection.m_Socket);
+		s_Connection.m_Socket = TRACKING_INVALID_SOCKET;
+#if defined(WINDOWS)
+		WSACleanup();
+#endif
+	}
+	s_Connection.m_Landmarks_Callback = nullptr;
+	s_Connection.m_Gesture_Callback = nullptr;
+
+	m_Mediapipe_Hand_Tracking_Init = nullptr;
+	m_Mediapipe_Hand_Tracking_Reigeter_Landmarks_Callback = nullptr;
+	m_Mediapipe_Hand_Tracking_Register_Gesture_Result_Callback = nullptr;
+	m_Mediapipe_Hand_Tracking_Detect_Frame = nullptr;
+	m_Mediapipe_Hand_Tracking_Detect_Frame_Direct = nullptr;
+	m_Mediapipe_Hand_Tracking_Detect_Video = nullptr;
+	m_Mediapipe_Hand_Tracking_Release = nullptr;
+	m_Connected = false;
+}
+
+bool MediapipeHandTrackingNetwork::IsConnected()
+{
+	std::lock_guard<std::mutex> lock(s_Connection.m_Mutex);
+	return m_Connected && s_Connection.m_Socket != TRACKING_INVALID_SOCKET;
+}
+
+NetworkOffloadStats MediapipeHandTrackingNetwork::GetStats()
+{
+	std::lock_guard<std::mutex> lock(s_Connection.m_Mutex);
+	return s_Connection.m_Stats;
+}
+
+int MediapipeHandTrackingNetwork::StubInit(const char* model_path)
+{
+	(void)model_path;
+	std::lock_guard<std::mutex> lock(s_Connection.m_Mutex);
+	return s_Connection.m_Socket != TRACKING_INVALID_SOCKET ? 1 : 0;
+}
+
+int MediapipeHandTrackingNetwork::StubRegisterLandmarksCallback(LandmarksCallBack func)
+{
+	std::lock_guard<std::mutex> lock(s_Connection.m_Mutex);
+	s_Connection.m_Landmarks_Callback = func;
+	return 1;
+}
+
+int MediapipeHandTrackingNetwork::StubRegisterGestureResultCallback(GestureResultCallBack func)
+{
+	std::lock_guard<std::mutex> lock(s_Connection.m_Mutex);
+	s_Connection.m_Gesture_Callback = func;
+	return 1;
+}
+
+int MediapipeHandTrackingNetwork::StubDetectFrame(int image_index, int image_width, int image_height, void* image_data)
+{
+	return Request(image_index, image_width, image_height, image_data, nullptr);
+}
+
+int MediapipeHandTrackingNetwork::StubDetectFrameDirect(int image_width, int image_height, void* image_data, GestureRecognitionResult& gesture_result)
+{
+	return Request(0, image_width, image_height, image_data, &gesture_result);
+}
+
+int MediapipeHandTrackingNetwork::StubDetectVideo(const char* video_path, int show_image)
+{
+	// the service has no window or file access on the client's behalf
+	(void)video_path;
+	(void)show_image;
+	return 0;
+}
+
+int MediapipeHandTrackingNetwork::StubRelease()
+{
+	return 1;
+}
+
+int MediapipeHandTrackingNetwork::Request(int image_index, int image_width, int image_height, void* image_data, GestureRecognitionResult* gesture_result)
+{
+	LandmarksCallBack landmarksCallback = nullptr;
+	GestureResultCallBack gestureCallback = nullptr;
+	TrackingNetResponse response;
+	PoseInfo landmarks[TRACKING_NET_MAX_LANDMARKS];
+	int gestures[TRACKING_NET_MAX_GESTURES];
+
+	{
+		std::lock_guard<std::mutex> lock(s_Connection.m_Mutex);
+		Connection& connection = s_Connection;
+		const NetworkOffloadOptions& options = connection.m_Options;
+		if (connection.m_Socket == TRACKING_INVALID_SOCKET || image_data == nullptr || image_width <= 0 || image_height <= 0)
+		{
+			return 0;
+		}
+
+		// crop to the last hands, or the whole frame to look for new ones
+		bool isFull = connection.m_Roi_Width == 0
+			|| (options.m_Full_Frame_Interval > 0 && connection.m_Frames_Since_Full >= options.m_Full_Frame_Interval);
+		int roiX = isFull ? 0 : connection.m_Roi_X;
+		int roiY = isFull ? 0 : connection.m_Roi_Y;
+		int roiWidth = isFull ? image_width : std::min(connection.m_Roi_Width, image_width - roiX);
+		int roiHeight = isFull ? image_height : std::min(connection.m_Roi_Height, image_height - roiY);
+		if (roiWidth <= 0 || roiHeight <= 0)
+		{
+			isFull = true;
+			roiX = 0;
+			roiY = 0;
+			roiWidth = image_width;
+			roiHeight = image_height;
+		}
+		int factor = DownscaleFor(roiWidth, roiHeight, isFull ? options.m_Max_Full_Frame_Side : options.m_Max_Crop_Side);
+
+		TrackingNetRequest request;
+		request.m_Magic = TRACKING_NET_MAGIC;
+		request.m_Version = TRACKING_NET_VERSION;
+		request.m_Image_Index = image_index;
+		request.m_Image_Width = roiWidth / factor;
+		request.m_Image_Height = roiHeight / factor;
+		request.m_Payload_Bytes = (uint32_t)request.m_Image_Width * request.m_Image_Height * 3;
+		const unsigned char* region = (const unsigned char*)image_data + ((size_t)roiY * image_width + roiX) * 3;
+		connection.m_Payload.resize(request.m_Payload_Bytes);
+		MediapipeHandTrackingGestureOnly::DownscaleBGR(region, roiWidth, roiHeight, image_width * 3, factor, connection.m_Payload.data());
+
+		auto sendTime = std::chrono::steady_clock::now();
+		bool isExchanged = SendAll(connection.m_Socket, &request, sizeof(request))
+			&& SendAll(connection.m_Socket, connection.m_Payload.data(), connection.m_Payload.size())
+			&& ReceiveAll(connection.m_Socket, &response, sizeof(response))
+			&& response.m_Landmark_Count <= TRACKING_NET_MAX_LANDMARKS
+			&& response.m_Gesture_Count <= TRACKING_NET_MAX_GESTURES
+			&& (response.m_Landmark_Count <= 0 || ReceiveAll(connection.m_Socket, landmarks, response.m_Landmark_Count * sizeof(PoseInfo)))
+			&& (response.m_Gesture_Count <= 0 || ReceiveAll(connection.m_Socket, gestures, response.m_Gesture_Count * sizeof(int)));
+		if (!isExchanged)
+		{
+			// the stream is out of step; the connection is dead until Connect is called again
+			CloseTrackingSocket(connection.m_Socket);
+			connection.m_Socket = TRACKING_INVALID_SOCKET;
+			return 0;
+		}
+
+		NetworkOffloadStats& stats = connection.m_Stats;
+		double roundTripMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - sendTime).count();
+		unsigned long long frames = stats.m_Full_Frames + stats.m_Crop_Frames + 1;
+		stats.m_Mean_Round_Trip_Ms += (roundTripMs - stats.m_Mean_Round_Trip_Ms) / (double)frames;
+		stats.m_Full_Frames += isFull ? 1 : 0;
+		stats.m_Crop_Frames += isFull ? 0 : 1;
+		stats.m_Sent_Bytes += sizeof(request) + request.m_Payload_Bytes;
+		stats.m_Full_Size_Bytes += sizeof(request) + (unsigned long long)image_width * image_height * 3;
+		connection.m_Frames_Since_Full = isFull ? 1 : connection.m_Frames_Since_Full + 1;
+
+		// back to frame pixels, and the crop for the next frame around them
+		float minX = 0.0f;
+		float minY = 0.0f;
+		float maxX = 0.0f;
+		float maxY = 0.0f;
+		for (int i = 0; i < response.m_Landmark_Count; ++i)
+		{
+			landmarks[i].x = roiX + landmarks[i].x * factor;
+			landmarks[i].y = roiY + landmarks[i].y * factor;
+			minX = i == 0 ? landmarks[i].x : std::min(minX, landmarks[i].x);
+			minY = i == 0 ? landmarks[i].y : std::min(minY, landmarks[i].y);
+			maxX = i == 0 ? landmarks[i].x : std::max(maxX, landmarks[i].x);
+			maxY = i == 0 ? landmarks[i].y : std::max(maxY, landmarks[i].y);
+		}
+		connection.m_Roi_Width = 0;
+		if (response.m_Landmark_Count > 0)
+		{
+			float marginX = (maxX - minX) * options.m_Crop_Margin;
+			float marginY = (maxY - minY) * options.m_Crop_Margin;
+			int left = std::max(0, (int)(minX - marginX));
+			int top = std::max(0, (int)(minY - marginY));
+			int right = std::min(image_width, (int)(maxX + marginX) + 1);
+			int bottom = std::min(image_height, (int)(maxY + marginY) + 1);
+			if (right - left >= 8 && bottom - top >= 8)
+			{
+				connection.m_Roi_X = left;
+				connection.m_Roi_Y = top;
+				connection.m_Roi_Width = right - left;
+				connection.m_Roi_Height = bottom - top;
+			}
+		}
+
+		if (gesture_result != nullptr)
+		{
+			*gesture_result = response.m_Gesture_Result;
+		}
+		landmarksCallback = connection.m_Landmarks_Callback;
+		gestureCallback = connection.m_Gesture_Callback;
+	}
+
+	// callbacks run outside the lock so they may call back into the tracker
+	if (landmarksCallback != nullptr && response.m_Landmark_Count >= 0)
+	{
+		landmarksCallback(image_index, landmarks, response.m_Landmark_Count);
+	}
+	if (gestureCallback != nullptr && response.m_Gesture_Count >= 0)
+	{
+		gestureCallback(image_index, gestures, response.m_Gesture_Count);
+	}
+	return response.m_Detect_Result;
+}
@@ -0,0 +1,94 @@
+#ifndef MEDIAPIPE_HAND_TRACKING_NETWORK_H
+#define MEDIAPIPE_HAND_TRACKING_NETWORK_H
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "TrackingNetworkProtocol.h"
+#include "MediapipeHandTrackingDll.h"
+
+//!
+//! @brief - MediapipeHandTrackingDll backed by a MediapipeTrackingService on another machine
+//!
+//! For thin clients that cannot run the graph at the target rate. Connect opens a TCP
+//! connection to a service started with a port and points the inherited function
+//! members at local stubs, like MediapipeHandTrackingRemote does for shared memory;
+//! the landmark/gesture callbacks fire on the calling thread before DetectFrame
+//! returns.
+//!
+//! Only the region around the hands is shipped. After a frame with landmarks the next
+//! frame is cropped to their bounding box grown by m_Crop_Margin and box-filtered
+//! down until its long side is at most m_Max_Crop_Side, which is about the landmark
+//! model's input size, so the crop loses nothing the model would have seen. A whole
+//! frame (scaled to m_Max_Full_Frame_Side) goes out when no hand is tracked and every
+//! m_Full_Frame_Interval frames, so new hands are found. Landmarks are mapped back to
+//! frame pixels before the callbacks see them.
+//!
+//! The stubs are plain function pointers with no context, so one connection serves
+//! the whole process; calls from several threads are serialized.
+//!
+
+struct NetworkOffloadOptions
+{
+	float m_Crop_Margin = 0.5f;			// added to each side, as a fraction of the landmark box
+	int m_Max_Crop_Side = 256;
+	int m_Max_Full_Frame_Side = 640;
+	int m_Full_Frame_Interval = 30;		// frames; 0 sends only crops while a hand is tracked
+};
+
+struct NetworkOffloadStats
+{
+	unsigned long long m_Full_Frames = 0;
+	unsigned long long m_Crop_Frames = 0;
+	unsigned long long m_Sent_Bytes = 0;
+	unsigned long long m_Full_Size_Bytes = 0;	// what the same frames would have cost uncropped
+	double m_Mean_Round_Trip_Ms = 0.0;
+};
+
+class MediapipeHandTrackingNetwork : public MediapipeHandTrackingDll
+{
+public:
+	MediapipeHandTrackingNetwork();
+	virtual~MediapipeHandTrackingNetwork();
+
+public:
+	bool Connect(const std::string& host, int port = TRACKING_NET_DEFAULT_PORT, const NetworkOffloadOptions& options = NetworkOffloadOptions(), int timeout_ms = 5000);
+	void Disconnect();
+	bool IsConnected();
+	NetworkOffloadStats GetStats();
+
+private:
+	static int StubInit(const char* model_path);
+	static int StubRegisterLandmarksCallback(LandmarksCallBack func);
+	static int StubRegisterGestureResultCallback(GestureResultCallBack func);
+	static int StubDetectFrame(int image_index, int image_width, int image_height, void* image_data);
+	static int StubDetectFrameDirect(int image_width, int image_height, void* image_data, GestureRecognitionResult& gesture_result);
+	static int StubDetectVideo(const char* video_path, int show_image);
+	static int StubRelease();
+
+	static int Request(int image_index, int image_width, int image_height, void* image_data, GestureRecognitionResult* gesture_result);
+
+private:
+	struct Connection
+	{
+		TrackingSocketHandle m_Socket = TRACKING_INVALID_SOCKET;
+		NetworkOffloadOptions m_Options;
+		NetworkOffloadStats m_Stats;
+		LandmarksCallBack m_Landmarks_Callback = nullptr;
+		GestureResultCallBack m_Gesture_Callback = nullptr;
+		std::vector<unsigned char> m_Payload;
+		// crop for the next frame, from the last landmarks; invalid when m_Roi_Width is 0
+		int m_Roi_X = 0;
+		int m_Roi_Y = 0;
+		int m_Roi_Width = 0;
+		int m_Roi_Height = 0;
+		int m_Frames_Since_Full = 0;
+		std::mutex m_Mutex;
+	};
+
+	static Connection s_Connection;
+	bool m_Connected;
+};
+
+#endif // !MEDIAPIPE_HAND_TRACKING_NETWORK_H
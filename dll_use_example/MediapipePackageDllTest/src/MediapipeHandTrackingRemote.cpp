@@ -0,0 +1,242 @@
+#include "MediapipeHandTrackingRemote.h"
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+namespace
+{
+	// how often a pending request re-checks that the service is still alive
+	const int kServiceCheckIntervalMs = 200;
+}
+
+MediapipeHandTrackingRemote::Connection MediapipeHandTrackingRemote::s_Connection;
+
+MediapipeHandTrackingRemote::MediapipeHandTrackingRemote()
+	: m_Connected(false)
+{
+}
+
+MediapipeHandTrackingRemote::~MediapipeHandTrackingRemote()
+{
+	Disconnect();
+}
+
+bool MediapipeHandTrackingRemote::Connect(const std::string& service_name, int timeout_ms)
+{
+	std::lock_guard<std::mutex> lock(s_Connection.m_Mutex);
+	if (s_Connection.m_Channel != nullptr)
+	{
+		return false;
+	}
+
+	// the service may still be loading the graph
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+	TrackingServiceHeader* header = nullptr;
+	while (true)
+	{
+		if (s_Connection.m_Segment.Open(service_name))
+		{
+			header = (TrackingServiceHeader*)s_Connection.m_Segment.GetData();
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (header->m_Magic == TRACKING_SERVICE_MAGIC && header->m_Version == TRACKING_SERVICE_VERSION && header->m_Running.load() != 0)
+			{
+				break;
+			}
+			s_Connection.m_Segment.Close();
+		}
+		if (std::chrono::steady_clock::now() >= deadline)
+		{
+			return false;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	}
+
+	for (uint32_t i = 0; i < header->m_Channel_Count; ++i)
+	{
+		TrackingChannel* channel = GetTrackingChannel(header, i);
+		uint32_t noOwner = 0;
+		if (channel->m_Owner_Pid.compare_exchange_strong(noOwner, GetCurrentProcessIdentifier()))
+		{
+			channel->m_State.store(TCS_Idle);
+			s_Connection.m_Work_Signal.Open(TrackingWorkSignalName(service_name));
+			s_Connection.m_Channel_Signal.Open(TrackingChannelSignalName(service_name, i));
+			s_Connection.m_Header = header;
+			s_Connection.m_Channel = channel;
+			break;
+		}
+	}
+	if (s_Connection.m_Channel == nullptr)
+	{
+		s_Connection.m_Segment.Close();
+		return false;
+	}
+
+	m_Mediapipe_Hand_Tracking_Init = StubInit;
+	m_Mediapipe_Hand_Tracking_Reigeter_Landmarks_Callback = StubRegisterLandmarksCallback;
+	m_Mediapipe_Hand_Tracking_Register_Gesture_Result_Callback = StubRegisterGestureResultCallback;
+	m_Mediapipe_Hand_Tracking_Detect_Frame = StubDetectFrame;
+	m_Mediapipe_Hand_Tracking_Detect_Frame_Direct = StubDetectFrameDirect;
+	m_Mediapipe_Hand_Tracking_Detect_Video = StubDetectVideo;
+	m_Mediapipe_Hand_Tracking_Release = StubRelease;
+	m_Connected = true;
+	return true;
+}
+
+void MediapipeHandTrackingRemote::Disconnect()
+{
+	if (!m_Connected)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(s_Connection.m_Mutex);
+	if (s_Connection.m_Channel != nullptr)
+	{
+		// state first: once the pid is 0 another client may claim the channel
+		s_Connection.m_Channel->m_State.store(TCS_Free);
+		s_Connection.m_Channel->m_Owner_Pid.store(0);
+	}
+	s_Connection.m_Channel = nullptr;
+	s_Connection.m_Header = nullptr;
+	s_Connection.m_Landmarks_Callback = nullptr;
+	s_Connection.m_Gesture_Callback = nullptr;
+	s_Connection.m_Segment.Close();
+
+	m_Mediapipe_Hand_Tracking_Init = nullptr;
+	m_Mediapipe_Hand_Tracking_Reigeter_Landmarks_Callback = nullptr;
+	m_Mediapipe_Hand_Tracking_Register_Gesture_Result_Callback = nullptr;
+	m_Mediapipe_Hand_Tracking_Detect_Frame = nullptr;
+	m_Mediapipe_Hand_Tracking_Detect_Frame_Direct = nullptr;
+	m_Mediapipe_Hand_Tracking_Detect_Video = nullptr;
+	m_Mediapipe_Hand_Tracking_Release = nullptr;
+	m_Connected = false;
+}
+
+bool MediapipeHandTrackingRemote::IsConnected()
+{
+	std::lock_guard<std::mutex> lock(s_Connection.m_Mutex);
+	return m_Connected && s_Connection.m_Channel != nullptr;
+}
+
+int MediapipeHandTrackingRemote::StubInit(const char* model_path)
+{
+	(void)model_path;
+	std::lock_guard<std::mutex> lock(s_Connection.m_Mutex);
+	return s_Connection.m_Channel != nullptr ? 1 : 0;
+}
+
+int MediapipeHandTrackingRemote::StubRegisterLandmarksCallback(LandmarksCallBack func)
+{
+	std::lock_guard<std::mutex> lock(s_Connection.m_Mutex);
+	s_Connection.m_Landmarks_Callback = func;
+	return 1;
+}
+
+int MediapipeHandTrackingRemote::StubRegisterGestureResultCallback(GestureResultCallBack func)
+{
+	std::lock_guard<std::mutex> lock(s_Connection.m_Mutex);
+	s_Connection.m_Gesture_Callback = func;
+	return 1;
+}
+
+int MediapipeHandTrackingRemote::StubDetectFrame(int image_index, int image_width, int image_height, void* image_data)
+{
+	return Request(TRT_DetectFrame, image_index, image_width, image_height, image_data, nullptr);
+}
+
+int MediapipeHandTrackingRemote::StubDetectFrameDirect(int image_width, int image_height, void* image_data, GestureRecognitionResult& gesture_result)
+{
+	return Request(TRT_DetectFrameDirect, 0, image_width, image_height, image_data, &gesture_result);
+}
+
+int MediapipeHandTrackingRemote::StubDetectVideo(const char* video_path, int show_image)
+{
+	// the service has no window or file access on the client's behalf
+	(void)video_path;
+	(void)show_image;
+	return 0;
+}
+
+int MediapipeHandTrackingRemote::StubRelease()
+{
+	return 1;
+}
+
+int MediapipeHandTrackingRemote::Request(int request_type, int image_index, int image_width, int image_height, void* image_data, GestureRecognitionResult* gesture_result)
+{
+	LandmarksCallBack landmarksCallback = nullptr;
+	GestureResultCallBack gestureCallback = nullptr;
+	int landmarkCount = -1;
+	int gestureCount = -1;
+	int result = 0;
+	PoseInfo landmarks[TRACKING_SERVICE_MAX_LANDMARKS];
+	int gestures[TRACKING_SERVICE_MAX_GESTURES];
+
+	{
+		std::lock_guard<std::mutex> lock(s_Connection.m_Mutex);
+		TrackingServiceHeader* header = s_Connection.m_Header;
+		TrackingChannel* channel = s_Connection.m_Channel;
+		size_t frameBytes = (size_t)image_width * image_height * 3;
+		if (channel == nullptr || image_data == nullptr || image_width <= 0 || image_height <= 0 || frameBytes > header->m_Max_Frame_Bytes)
+		{
+			return 0;
+		}
+
+		channel->m_Request_Type = request_type;
+		channel->m_Image_Index = image_index;
+		channel->m_Image_Width = image_width;
+		channel->m_Image_Height = image_height;
+		memcpy(GetTrackingChannelFrame(channel), image_data, frameBytes);
+		channel->m_State.store(TCS_Requested, std::memory_order_release);
+		header->m_Work_Seq.fetch_add(1, std::memory_order_release);
+		s_Connection.m_Work_Signal.Wake(&header->m_Work_Seq);
+
+		while (channel->m_State.load(std::memory_order_acquire) == TCS_Requested)
+		{
+			s_Connection.m_Channel_Signal.Wait(&channel->m_State, TCS_Requested, kServiceCheckIntervalMs);
+			if (channel->m_State.load(std::memory_order_acquire) != TCS_Requested)
+			{
+				break;
+			}
+			if (header->m_Running.load() == 0 || !IsProcessAlive(header->m_Service_Pid))
+			{
+				// the service is gone; the connection is dead until Connect is called again
+				s_Connection.m_Channel = nullptr;
+				s_Connection.m_Header = nullptr;
+				return 0;
+			}
+		}
+
+		result = channel->m_Detect_Result;
+		if (gesture_result != nullptr)
+		{
+			*gesture_result = channel->m_Gesture_Result;
+		}
+		landmarkCount = channel->m_Landmark_Count;
+		gestureCount = channel->m_Gesture_Count;
+		if (landmarkCount > 0)
+		{
+			memcpy(landmarks, channel->m_Landmarks, landmarkCount * sizeof(PoseInfo));
+		}
+		if (gestureCount > 0)
+		{
+			memcpy(gestures, channel->m_Gestures, gestureCount * sizeof(int));
+		}
+		channel->m_State.store(TCS_Idle, std::memory_order_release);
+
+		landmarksCallback = s_Connection.m_Landmarks_Callback;
+		gestureCallback = s_Connection.m_Gesture_Callback;
+	}
+
+	// callbacks run outside the lock so they may call back into the tracker
+	if (landmarksCallback != nullptr && landmarkCount >= 0)
+	{
+		landmarksCallback(image_index, landmarks, landmarkCount);
+	}
+	if (gestureCallback != nullptr && gestureCount >= 0)
+	{
+		gestureCallback(image_index, gestures, gestureCount);
+	}
+	return result;
+}
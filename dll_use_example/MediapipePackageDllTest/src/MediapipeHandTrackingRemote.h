@@ -0,0 +1,63 @@
+#ifndef MEDIAPIPE_HAND_TRACKING_REMOTE_H
+#define MEDIAPIPE_HAND_TRACKING_REMOTE_H
+
+#include <mutex>
+#include <string>
+
+#include "MediapipeHandTrackingDll.h"
+#include "TrackingServiceProtocol.h"
+
+//!
+//! @brief - MediapipeHandTrackingDll backed by a MediapipeTrackingService process
+//!
+//! Connect claims a channel in the service's shared memory and points the inherited
+//! function members at local stubs, so code written against MediapipeHandTrackingDll
+//! runs unchanged. Frames are written straight into the channel; the service runs
+//! the graph and the landmark/gesture callbacks fire on the calling thread before
+//! DetectFrame returns. Init, Release and Detect_Video are no-ops, the model lives
+//! in the service.
+//!
+//! The stubs are plain function pointers with no context, so one connection serves
+//! the whole process; calls from several threads are serialized.
+//!
+class MediapipeHandTrackingRemote : public MediapipeHandTrackingDll
+{
+public:
+	MediapipeHandTrackingRemote();
+	virtual~MediapipeHandTrackingRemote();
+
+public:
+	// Waits up to timeout_ms for the service to come up; false if no channel is free
+	bool Connect(const std::string& service_name = TRACKING_SERVICE_DEFAULT_NAME, int timeout_ms = 5000);
+	void Disconnect();
+	bool IsConnected();
+
+private:
+	static int StubInit(const char* model_path);
+	static int StubRegisterLandmarksCallback(LandmarksCallBack func);
+	static int StubRegisterGestureResultCallback(GestureResultCallBack func);
+	static int StubDetectFrame(int image_index, int image_width, int image_height, void* image_data);
+	static int StubDetectFrameDirect(int image_width, int image_height, void* image_data, GestureRecognitionResult& gesture_result);
+	static int StubDetectVideo(const char* video_path, int show_image);
+	static int StubRelease();
+
+	static int Request(int request_type, int image_index, int image_width, int image_height, void* image_data, GestureRecognitionResult* gesture_result);
+
+private:
+	struct Connection
+	{
+		TrackingSharedSegment m_Segment;
+		TrackingSignal m_Work_Signal;
+		TrackingSignal m_Channel_Signal;
+		TrackingServiceHeader* m_Header = nullptr;
+		TrackingChannel* m_Channel = nullptr;
+		LandmarksCallBack m_Landmarks_Callback = nullptr;
+		GestureResultCallBack m_Gesture_Callback = nullptr;
+		std::mutex m_Mutex;
+	};
+
+	static Connection s_Connection;
+	bool m_Connected;
+};
+
+#endif // !MEDIAPIPE_HAND_TRACKING_REMOTE_H
@@ -0,0 +1,228 @@
+#include "MediapipeHandTrackingResultCache.h"
+
+#include <chrono>
+#include <cstring>
+
+namespace
+{
+	const size_t kThumbnailSize = MOTION_GATE_THUMBNAIL_WIDTH * MOTION_GATE_THUMBNAIL_HEIGHT;
+	// list node + hash map node, roughly
+	const size_t kEntryOverhead = sizeof(void*) * 6;
+}
+
+std::atomic<MediapipeHandTrackingResultCache*> MediapipeHandTrackingResultCache::s_ActiveCache(nullptr);
+
+MediapipeHandTrackingResultCache::MediapipeHandTrackingResultCache(MediapipeHandTrackingDll& hand_tracking_dll, const ResultCacheOptions& options)
+	: m_HandTrackingDll(hand_tracking_dll)
+	, m_Options(options)
+	, m_Thumbnail(kThumbnailSize)
+	, m_MemoryBytes(0)
+	, m_IsStarted(false)
+	, m_HitCount(0)
+	, m_MissCount(0)
+	, m_Metrics(nullptr)
+{
+}
+
+MediapipeHandTrackingResultCache::~MediapipeHandTrackingResultCache()
+{
+	Stop();
+}
+
+bool MediapipeHandTrackingResultCache::Start()
+{
+	if (m_IsStarted)
+	{
+		return true;
+	}
+	if (m_HandTrackingDll.m_Mediapipe_Hand_Tracking_Detect_Frame_Direct == nullptr
+		|| m_HandTrackingDll.m_Mediapipe_Hand_Tracking_Reigeter_Landmarks_Callback == nullptr
+		|| m_HandTrackingDll.m_Mediapipe_Hand_Tracking_Register_Gesture_Result_Callback == nullptr)
+	{
+		return false;
+	}
+
+	MediapipeHandTrackingResultCache* expected = nullptr;
+	if (!s_ActiveCache.compare_exchange_strong(expected, this))
+	{
+		return false;
+	}
+	if (!m_HandTrackingDll.m_Mediapipe_Hand_Tracking_Reigeter_Landmarks_Callback(LandmarksTrampoline)
+		|| !m_HandTrackingDll.m_Mediapipe_Hand_Tracking_Register_Gesture_Result_Callback(GestureTrampoline))
+	{
+		s_ActiveCache.store(nullptr);
+		return false;
+	}
+
+	m_IsStarted = true;
+	return true;
+}
+
+void MediapipeHandTrackingResultCache::Stop()
+{
+	if (!m_IsStarted)
+	{
+		return;
+	}
+	m_IsStarted = false;
+	MediapipeHandTrackingResultCache* expected = this;
+	s_ActiveCache.compare_exchange_strong(expected, nullptr);
+}
+
+void MediapipeHandTrackingResultCache::SetMetrics(TrackerMetrics* metrics)
+{
+	m_Metrics = metrics;
+}
+
+bool MediapipeHandTrackingResultCache::DetectFrame(int image_width, int image_height, void* image_data, CachedHandResult& result)
+{
+	if (!m_IsStarted || image_data == nullptr || image_width <= 0 || image_height <= 0)
+	{
+		return false;
+	}
+
+	if (m_Metrics != nullptr)
+	{
+		m_Metrics->AddSubmitted();
+	}
+	BuildMotionThumbnail(image_width, image_height, (const unsigned char*)image_data, (size_t)image_width * 3, m_Thumbnail.data());
+	unsigned long long hash = HashThumbnail(image_width, image_height, m_Thumbnail.data(), kThumbnailSize);
+
+	std::unordered_map<unsigned long long, EntryList::iterator>::iterator found = m_Index.find(hash);
+	if (found != m_Index.end())
+	{
+		CacheEntry& entry = *found->second;
+		if (entry.m_Image_Width == image_width && entry.m_Image_Height == image_height
+			&& memcmp(entry.m_Thumbnail.data(), m_Thumbnail.data(), kThumbnailSize) == 0)
+		{
+			m_Entries.splice(m_Entries.begin(), m_Entries, found->second);
+			++m_HitCount;
+			if (m_Metrics != nullptr)
+			{
+				m_Metrics->AddCached();
+			}
+			result = entry.m_Result;
+			result.m_Is_Cached = true;
+			return true;
+		}
+	}
+
+	// Detect_Frame_Direct returns after the frame's callbacks have fired; no landmark
+	// callback means no hand
+	++m_MissCount;
+	m_CurrentResult.m_Landmarks.clear();
+	m_CurrentResult.m_Gesture_Result = GestureRecognitionResult();
+	std::chrono::steady_clock::time_point detectStart = std::chrono::steady_clock::now();
+	m_CurrentResult.m_Detect_Result = m_HandTrackingDll.m_Mediapipe_Hand_Tracking_Detect_Frame_Direct(image_width, image_height, image_data, m_CurrentResult.m_Gesture_Result);
+	if (m_Metrics != nullptr)
+	{
+		double detectMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - detectStart).count();
+		m_Metrics->AddProcessed(detectMs, m_CurrentResult.m_Detect_Result != 0, !m_CurrentResult.m_Landmarks.empty());
+		m_Metrics->AddResultLatency(detectMs);
+	}
+	m_CurrentResult.m_Is_Cached = false;
+
+	if (m_CurrentResult.m_Detect_Result != 0)
+	{
+		Insert(hash, image_width, image_height);
+	}
+	result = m_CurrentResult;
+	return result.m_Detect_Result != 0;
+}
+
+void MediapipeHandTrackingResultCache::Clear()
+{
+	m_Entries.clear();
+	m_Index.clear();
+	m_MemoryBytes = 0;
+}
+
+unsigned long long MediapipeHandTrackingResultCache::GetHitCount()
+{
+	return m_HitCount;
+}
+
+unsigned long long MediapipeHandTrackingResultCache::GetMissCount()
+{
+	return m_MissCount;
+}
+
+int MediapipeHandTrackingResultCache::GetEntryCount()
+{
+	return (int)m_Index.size();
+}
+
+size_t MediapipeHandTrackingResultCache::GetMemoryBytes()
+{
+	return m_MemoryBytes;
+}
+
+unsigned long long MediapipeHandTrackingResultCache::HashThumbnail(int image_width, int image_height, const unsigned char* thumbnail, size_t size)
+{
+	// FNV-1a over the frame size and the thumbnail; 2304 bytes, so the hash costs nothing
+	// next to building the thumbnail
+	unsigned long long hash = 14695981039346656037ULL;
+	const unsigned long long prime = 1099511628211ULL;
+	hash = (hash ^ (unsigned long long)(unsigned int)image_width) * prime;
+	hash = (hash ^ (unsigned long long)(unsigned int)image_height) * prime;
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash = (hash ^ thumbnail[i]) * prime;
+	}
+	return hash;
+}
+
+void MediapipeHandTrackingResultCache::Insert(unsigned long long hash, int image_width, int image_height)
+{
+	// a colliding entry is replaced rather than chained
+	std::unordered_map<unsigned long long, EntryList::iterator>::iterator found = m_Index.find(hash);
+	if (found != m_Index.end())
+	{
+		Erase(found->second);
+	}
+
+	m_Entries.push_front(CacheEntry());
+	CacheEntry& entry = m_Entries.front();
+	entry.m_Hash = hash;
+	entry.m_Image_Width = image_width;
+	entry.m_Image_Height = image_height;
+	entry.m_Thumbnail = m_Thumbnail;
+	entry.m_Result = m_CurrentResult;
+	entry.m_Bytes = sizeof(CacheEntry) + kEntryOverhead + kThumbnailSize + entry.m_Result.m_Landmarks.size() * sizeof(PoseInfo);
+	m_Index[hash] = m_Entries.begin();
+	m_MemoryBytes += entry.m_Bytes;
+	EvictToLimits();
+}
+
+void MediapipeHandTrackingResultCache::Erase(EntryList::iterator entry)
+{
+	m_MemoryBytes -= entry->m_Bytes;
+	m_Index.erase(entry->m_Hash);
+	m_Entries.erase(entry);
+}
+
+void MediapipeHandTrackingResultCache::EvictToLimits()
+{
+	while (!m_Entries.empty() && ((int)m_Index.size() > m_Options.m_Max_Entries || m_MemoryBytes > m_Options.m_Max_Bytes))
+	{
+		Erase(--m_Entries.end());
+	}
+}
+
+void MediapipeHandTrackingResultCache::LandmarksTrampoline(int image_index, PoseInfo* infos, int count)
+{
+	(void)image_index;
+	MediapipeHandTrackingResultCache* cache = s_ActiveCache.load(std::memory_order_acquire);
+	if (cache != nullptr && infos != nullptr && count > 0)
+	{
+		cache->m_CurrentResult.m_Landmarks.assign(infos, infos + count);
+	}
+}
+
+void MediapipeHandTrackingResultCache::GestureTrampoline(int image_index, int* recogn_result, int count)
+{
+	// Detect_Frame_Direct already returns the gesture result
+	(void)image_index;
+	(void)recogn_result;
+	(void)count;
+}
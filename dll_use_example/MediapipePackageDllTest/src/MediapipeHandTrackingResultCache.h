@@ -0,0 +1,102 @@
+#ifndef MEDIAPIPE_HAND_TRACKING_RESULT_CACHE_H
+#define MEDIAPIPE_HAND_TRACKING_RESULT_CACHE_H
+
+#include <atomic>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "MediapipeHandTrackingDll.h"
+#include "MotionGate.h"
+#include "TrackerMetrics.h"
+
+//!
+//! @brief - Mediapipe_Hand_Tracking_Detect_Frame_Direct with a result cache for repeated frames
+//!
+//! Meant for streams that replay the same media, e.g. a looped clip: every frame is
+//! reduced to the MotionGate luma thumbnail and hashed, and a frame whose thumbnail
+//! was seen before gets the stored landmarks and gesture result instead of a DLL call.
+//! The stored thumbnail is compared byte for byte on a hit, so a hash collision alone
+//! is a miss. The key is the 64x36 thumbnail, not the frame: two frames of the same
+//! size whose thumbnails are identical share one result, even if they differ at full
+//! resolution. Decoders reproduce a looped clip bit-exactly, so repeats match; a live
+//! camera practically never repeats and should not use the cache.
+//!
+//! Entries are evicted least recently used once either limit is reached. Failed frames
+//! are not cached. Like MediapipeHandTrackingMotionGated, the class owns both DLL
+//! callbacks while started; only one instance may be started at a time.
+//!
+
+struct ResultCacheOptions
+{
+	int m_Max_Entries = 4096;
+	size_t m_Max_Bytes = 16 * 1024 * 1024;	// thumbnails + landmarks + bookkeeping, approximate
+};
+
+struct CachedHandResult
+{
+	int m_Detect_Result = 0;
+	bool m_Is_Cached = false;				// true when answered from the cache
+	GestureRecognitionResult m_Gesture_Result;
+	std::vector<PoseInfo> m_Landmarks;		// empty when no hand was found
+};
+
+class MediapipeHandTrackingResultCache
+{
+public:
+	MediapipeHandTrackingResultCache(MediapipeHandTrackingDll& hand_tracking_dll, const ResultCacheOptions& options = ResultCacheOptions());
+	virtual~MediapipeHandTrackingResultCache();
+
+public:
+	bool Start();
+	void Stop();
+	// optional, must outlive the tracker
+	void SetMetrics(TrackerMetrics* metrics);
+
+	// image_data is densely packed BGR, as Detect_Frame_Direct expects
+	bool DetectFrame(int image_width, int image_height, void* image_data, CachedHandResult& result);
+	// e.g. when the playlist or the model changes
+	void Clear();
+
+	unsigned long long GetHitCount();
+	unsigned long long GetMissCount();
+	int GetEntryCount();
+	size_t GetMemoryBytes();
+
+private:
+	struct CacheEntry
+	{
+		unsigned long long m_Hash = 0;
+		int m_Image_Width = 0;
+		int m_Image_Height = 0;
+		std::vector<unsigned char> m_Thumbnail;
+		CachedHandResult m_Result;
+		size_t m_Bytes = 0;
+	};
+	typedef std::list<CacheEntry> EntryList;
+
+	static unsigned long long HashThumbnail(int image_width, int image_height, const unsigned char* thumbnail, size_t size);
+	void Insert(unsigned long long hash, int image_width, int image_height);
+	void Erase(EntryList::iterator entry);
+	void EvictToLimits();
+
+	static void LandmarksTrampoline(int image_index, PoseInfo* infos, int count);
+	static void GestureTrampoline(int image_index, int* recogn_result, int count);
+
+private:
+	static std::atomic<MediapipeHandTrackingResultCache*> s_ActiveCache;
+
+	MediapipeHandTrackingDll& m_HandTrackingDll;
+	ResultCacheOptions m_Options;
+	std::vector<unsigned char> m_Thumbnail;
+	EntryList m_Entries;					// most recently used first
+	std::unordered_map<unsigned long long, EntryList::iterator> m_Index;
+	size_t m_MemoryBytes;
+	CachedHandResult m_CurrentResult;		// filled by the landmark callback
+	bool m_IsStarted;
+	unsigned long long m_HitCount;
+	unsigned long long m_MissCount;
+	TrackerMetrics* m_Metrics;
+};
+
+#endif // !MEDIAPIPE_HAND_TRACKING_RESULT_CACHE_H
@@ -0,0 +1,370 @@
+#include "MediapipeHandTrackingShadow.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#if defined(LINUX)
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+std::atomic<MediapipeHandTrackingShadow*> MediapipeHandTrackingShadow::s_ActiveShadow(nullptr);
+
+MediapipeHandTrackingShadow::MediapipeHandTrackingShadow(MediapipeHandTrackingDll& primary_dll, const ShadowTrackingOptions& options)
+	: m_PrimaryDll(primary_dll)
+	, m_Options(options)
+	, m_IsStarted(false)
+	, m_SampleCredit(0.0)
+	, m_PrimaryLandmarks(nullptr)
+	, m_HasSample(false)
+	, m_IsStopping(false)
+	, m_FrameCount(0)
+	, m_SkippedCount(0)
+	, m_LandmarkDeltaSum(0.0)
+	, m_NextLatency(0)
+{
+	m_Options.m_Sample_Rate = std::min(1.0, std::max(0.0, m_Options.m_Sample_Rate));
+	m_Options.m_Latency_Window = std::max(1, m_Options.m_Latency_Window);
+}
+
+MediapipeHandTrackingShadow::~MediapipeHandTrackingShadow()
+{
+	Stop();
+}
+
+bool MediapipeHandTrackingShadow::Start(const std::string& shadow_dll_path, const std::string& shadow_model_path)
+{
+	if (m_IsStarted)
+	{
+		return true;
+	}
+	if (m_PrimaryDll.m_Mediapipe_Hand_Tracking_Detect_Frame_Direct == nullptr
+		|| m_PrimaryDll.m_Mediapipe_Hand_Tracking_Reigeter_Landmarks_Callback == nullptr
+		|| m_PrimaryDll.m_Mediapipe_Hand_Tracking_Register_Gesture_Result_Callback == nullptr)
+	{
+		return false;
+	}
+
+	MediapipeHandTrackingShadow* expected = nullptr;
+	if (!s_ActiveShadow.compare_exchange_strong(expected, this))
+	{
+		return false;
+	}
+
+	// isolated, so a second copy of the same build keeps its own symbols on Linux
+	if (!m_ShadowDll.LoadMediapipeHandTrackingDll(shadow_dll_path, DMLM_Isolated) || !m_ShadowDll.GetAllFunctions()
+		|| !m_ShadowDll.m_Mediapipe_Hand_Tracking_Init(shadow_model_path.c_str()))
+	{
+		m_ShadowDll.UnLoadMediapipeHandTrackingDll();
+		s_ActiveShadow.store(nullptr);
+		return false;
+	}
+	if (!m_ShadowDll.m_Mediapipe_Hand_Tracking_Reigeter_Landmarks_Callback(ShadowLandmarksTrampoline)
+		|| !m_ShadowDll.m_Mediapipe_Hand_Tracking_Register_Gesture_Result_Callback(GestureTrampoline)
+		|| !m_PrimaryDll.m_Mediapipe_Hand_Tracking_Reigeter_Landmarks_Callback(PrimaryLandmarksTrampoline)
+		|| !m_PrimaryDll.m_Mediapipe_Hand_Tracking_Register_Gesture_Result_Callback(GestureTrampoline))
+	{
+		m_ShadowDll.m_Mediapipe_Hand_Tracking_Release();
+		m_ShadowDll.UnLoadMediapipeHandTrackingDll();
+		s_ActiveShadow.store(nullptr);
+		return false;
+	}
+
+	m_SampleCredit = 0.0;
+	m_HasSample = false;
+	m_IsStopping = false;
+	m_Worker = std::thread(&MediapipeHandTrackingShadow::WorkerThread, this);
+	m_IsStarted = true;
+	return true;
+}
+
+void MediapipeHandTrackingShadow::Stop()
+{
+	if (!m_IsStarted)
+	{
+		return;
+	}
+	m_IsStarted = false;
+
+	{
+		std::lock_guard<std::mutex> lock(m_SampleMutex);
+		m_IsStopping = true;
+	}
+	m_SampleReady.notify_one();
+	if (m_Worker.joinable())
+	{
+		m_Worker.join();
+	}
+
+	m_ShadowDll.m_Mediapipe_Hand_Tracking_Release();
+	m_ShadowDll.UnLoadMediapipeHandTrackingDll();
+
+	MediapipeHandTrackingShadow* expected = this;
+	s_ActiveShadow.compare_exchange_strong(expected, nullptr);
+}
+
+bool MediapipeHandTrackingShadow::DetectFrame(int image_width, int image_height, void* image_data, ShadowHandResult& result)
+{
+	if (!m_IsStarted)
+	{
+		return false;
+	}
+
+	// Detect_Frame_Direct returns after the frame's callbacks have fired; no landmark
+	// callback means no hand
+	result.m_Landmarks.clear();
+	result.m_Gesture_Result = GestureRecognitionResult();
+	result.m_Is_Sampled = false;
+	m_PrimaryLandmarks = &result.m_Landmarks;
+	std::chrono::steady_clock::time_point detectStart = std::chrono::steady_clock::now();
+	result.m_Detect_Result = m_PrimaryDll.m_Mediapipe_Hand_Tracking_Detect_Frame_Direct(image_width, image_height, image_data, result.m_Gesture_Result);
+	double primaryMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - detectStart).count();
+	m_PrimaryLandmarks = nullptr;
+	m_FrameCount.fetch_add(1, std::memory_order_relaxed);
+
+	// sampled on the credit alone, so primary failures reach the comparison too
+	m_SampleCredit += m_Options.m_Sample_Rate;
+	if (m_SampleCredit < 1.0)
+	{
+		return result.m_Detect_Result != 0;
+	}
+	m_SampleCredit -= 1.0;
+
+	// the worker only ever holds one sample; never wait for it
+	std::unique_lock<std::mutex> lock(m_SampleMutex, std::try_to_lock);
+	if (!lock.owns_lock() || m_HasSample)
+	{
+		m_SkippedCount.fetch_add(1, std::memory_order_relaxed);
+		return result.m_Detect_Result != 0;
+	}
+	m_Sample.m_Image_Width = image_width;
+	m_Sample.m_Image_Height = image_height;
+	const unsigned char* pixels = (const unsigned char*)image_data;
+	m_Sample.m_Image_Data.assign(pixels, pixels + (size_t)image_width * image_height * 3);
+	m_Sample.m_Primary_Result = result.m_Detect_Result;
+	m_Sample.m_Primary_Ms = primaryMs;
+	m_Sample.m_Primary_Gesture_Result = result.m_Gesture_Result;
+	m_Sample.m_Primary_Landmarks = result.m_Landmarks;
+	m_HasSample = true;
+	lock.unlock();
+	m_SampleReady.notify_one();
+
+	result.m_Is_Sampled = true;
+	return result.m_Detect_Result != 0;
+}
+
+ShadowTrackingStats MediapipeHandTrackingShadow::GetStats()
+{
+	std::lock_guard<std::mutex> lock(m_StatsMutex);
+	ShadowTrackingStats stats = m_Stats;
+	stats.m_Frames = m_FrameCount.load(std::memory_order_relaxed);
+	stats.m_Samples_Skipped = m_SkippedCount.load(std::memory_order_relaxed);
+	stats.m_Mean_Landmark_Delta_Px = stats.m_Landmark_Samples > 0 ? m_LandmarkDeltaSum / (double)stats.m_Landmark_Samples : 0.0;
+	stats.m_Primary_Latency_P50_Ms = Percentile(m_PrimaryLatencies, 0.50);
+	stats.m_Primary_Latency_P95_Ms = Percentile(m_PrimaryLatencies, 0.95);
+	stats.m_Shadow_Latency_P50_Ms = Percentile(m_ShadowLatencies, 0.50);
+	stats.m_Shadow_Latency_P95_Ms = Percentile(m_ShadowLatencies, 0.95);
+	return stats;
+}
+
+void MediapipeHandTrackingShadow::ResetStats()
+{
+	std::lock_guard<std::mutex> lock(m_StatsMutex);
+	m_Stats = ShadowTrackingStats();
+	m_LandmarkDeltaSum = 0.0;
+	m_PrimaryLatencies.clear();
+	m_ShadowLatencies.clear();
+	m_NextLatency = 0;
+	m_FrameCount.store(0, std::memory_order_relaxed);
+	m_SkippedCount.store(0, std::memory_order_relaxed);
+}
+
+void MediapipeHandTrackingShadow::WorkerThread()
+{
+	if (m_Options.m_Is_Low_Priority)
+	{
+#if defined(WINDOWS)
+		SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_LOWEST);
+#elif defined(LINUX)
+		// nice applies per thread on Linux
+		setpriority(PRIO_PROCESS, (id_t)syscall(SYS_gettid), 19);
+#endif
+	}
+
+	ShadowSample sample;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_SampleMutex);
+			m_SampleReady.wait(lock, [this]() { return m_HasSample || m_IsStopping; });
+			if (m_IsStopping)
+			{
+				return;
+			}
+			// swap keeps both buffers allocated; the next sample reuses this one's storage
+			std::swap(sample, m_Sample);
+		}
+
+		m_ShadowLandmarks.clear();
+		GestureRecognitionResult shadowGestureResult;
+		std::chrono::steady_clock::time_point detectStart = std::chrono::steady_clock::now();
+		int shadowResult = m_ShadowDll.m_Mediapipe_Hand_Tracking_Detect_Frame_Direct(sample.m_Image_Width, sample.m_Image_Height, sample.m_Image_Data.data(), shadowGestureResult);
+		double shadowMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - detectStart).count();
+		CompareSample(sample, shadowResult, shadowMs, shadowGestureResult);
+
+		std::lock_guard<std::mutex> lock(m_SampleMutex);
+		m_HasSample = false;
+	}
+}
+
+void MediapipeHandTrackingShadow::CompareSample(const ShadowSample& sample, int shadow_result, double shadow_ms, const GestureRecognitionResult& shadow_gesture_result)
+{
+	std::lock_guard<std::mutex> lock(m_StatsMutex);
+	m_Stats.m_Samples += 1;
+	bool primaryFailed = sample.m_Primary_Result == 0;
+	bool shadowFailed = shadow_result == 0;
+	m_Stats.m_Primary_Failures += primaryFailed ? 1 : 0;
+	m_Stats.m_Shadow_Failures += shadowFailed ? 1 : 0;
+	m_Stats.m_Result_Mismatches += primaryFailed != shadowFailed ? 1 : 0;
+	if (primaryFailed || shadowFailed)
+	{
+		return;
+	}
+
+	if ((int)m_PrimaryLatencies.size() < m_Options.m_Latency_Window)
+	{
+		m_PrimaryLatencies.push_back(sample.m_Primary_Ms);
+		m_ShadowLatencies.push_back(shadow_ms);
+	}
+	else
+	{
+		m_PrimaryLatencies[m_NextLatency] = sample.m_Primary_Ms;
+		m_ShadowLatencies[m_NextLatency] = shadow_ms;
+	}
+	m_NextLatency = (m_NextLatency + 1) % (size_t)m_Options.m_Latency_Window;
+
+	if (memcmp(sample.m_Primary_Gesture_Result.m_Gesture_Recognition_Result, shadow_gesture_result.m_Gesture_Recognition_Result, sizeof(shadow_gesture_result.m_Gesture_Recognition_Result)) != 0)
+	{
+		m_Stats.m_Gesture_Mismatches += 1;
+	}
+
+	const std::vector<PoseInfo>& primary = sample.m_Primary_Landmarks;
+	if (primary.size() != m_ShadowLandmarks.size())
+	{
+		m_Stats.m_Hand_Count_Mismatches += 1;
+		return;
+	}
+	if (primary.empty())
+	{
+		return;
+	}
+
+	double meanDelta = MatchedLandmarkDelta(primary, m_ShadowLandmarks);
+	m_LandmarkDeltaSum += meanDelta;
+	m_Stats.m_Landmark_Samples += 1;
+	m_Stats.m_Max_Landmark_Delta_Px = std::max(m_Stats.m_Max_Landmark_Delta_Px, meanDelta);
+}
+
+double MediapipeHandTrackingShadow::MatchedLandmarkDelta(const std::vector<PoseInfo>& primary, const std::vector<PoseInfo>& shadow)
+{
+	// landmark 0 of every hand is the wrist
+	int handCount = (int)std::min(primary.size(), shadow.size()) / HAND_KEYPOINT_COUNT;
+	if (handCount == 0)
+	{
+		// not whole hands; compare what there is point for point
+		size_t count = std::min(primary.size(), shadow.size());
+		double deltaSum = 0.0;
+		for (size_t i = 0; i < count; ++i)
+		{
+			double dx = (double)shadow[i].x - (double)primary[i].x;
+			double dy = (double)shadow[i].y - (double)primary[i].y;
+			deltaSum += sqrt(dx * dx + dy * dy);
+		}
+		return count > 0 ? deltaSum / (double)count : 0.0;
+	}
+
+	bool primaryUsed[MAX_HAND_COUNT] = {};
+	bool shadowUsed[MAX_HAND_COUNT] = {};
+	handCount = std::min(handCount, MAX_HAND_COUNT);
+	double deltaSum = 0.0;
+	// greedy on the closest remaining wrist pair, exact for two hands
+	for (int pair = 0; pair < handCount; ++pair)
+	{
+		int bestPrimary = -1;
+		int bestShadow = -1;
+		double bestDistance = 0.0;
+		for (int p = 0; p < handCount; ++p)
+		{
+			for (int s = 0; s < handCount && !primaryUsed[p]; ++s)
+			{
+				if (shadowUsed[s])
+				{
+					continue;
+				}
+				double dx = (double)shadow[s * HAND_KEYPOINT_COUNT].x - (double)primary[p * HAND_KEYPOINT_COUNT].x;
+				double dy = (double)shadow[s * HAND_KEYPOINT_COUNT].y - (double)primary[p * HAND_KEYPOINT_COUNT].y;
+				double distance = dx * dx + dy * dy;
+				if (bestPrimary < 0 || distance < bestDistance)
+				{
+					bestPrimary = p;
+					bestShadow = s;
+					bestDistance = distance;
+				}
+			}
+		}
+		primaryUsed[bestPrimary] = true;
+		shadowUsed[bestShadow] = true;
+
+		const PoseInfo* primaryHand = &primary[bestPrimary * HAND_KEYPOINT_COUNT];
+		const PoseInfo* shadowHand = &shadow[bestShadow * HAND_KEYPOINT_COUNT];
+		for (int i = 0; i < HAND_KEYPOINT_COUNT; ++i)
+		{
+			double dx = (double)shadowHand[i].x - (double)primaryHand[i].x;
+			double dy = (double)shadowHand[i].y - (double)primaryHand[i].y;
+			deltaSum += sqrt(dx * dx + dy * dy);
+		}
+	}
+	return deltaSum / (double)(handCount * HAND_KEYPOINT_COUNT);
+}
+
+double MediapipeHandTrackingShadow::Percentile(std::vector<double> values, double fraction)
+{
+	if (values.empty())
+	{
+		return 0.0;
+	}
+	std::sort(values.begin(), values.end());
+	size_t index = std::min(values.size() - 1, (size_t)(fraction * (double)(values.size() - 1) + 0.5));
+	return values[index];
+}
+
+void MediapipeHandTrackingShadow::PrimaryLandmarksTrampoline(int image_index, PoseInfo* infos, int count)
+{
+	(void)image_index;
+	MediapipeHandTrackingShadow* shadow = s_ActiveShadow.load(std::memory_order_acquire);
+	if (shadow != nullptr && shadow->m_PrimaryLandmarks != nullptr && infos != nullptr && count > 0)
+	{
+		shadow->m_PrimaryLandmarks->assign(infos, infos + count);
+	}
+}
+
+void MediapipeHandTrackingShadow::ShadowLandmarksTrampoline(int image_index, PoseInfo* infos, int count)
+{
+	(void)image_index;
+	MediapipeHandTrackingShadow* shadow = s_ActiveShadow.load(std::memory_order_acquire);
+	if (shadow != nullptr && infos != nullptr && count > 0)
+	{
+		shadow->m_ShadowLandmarks.assign(infos, infos + count);
+	}
+}
+
+void MediapipeHandTrackingShadow::GestureTrampoline(int image_index, int* recogn_result, int count)
+{
+	// Detect_Frame_Direct already returns the gesture result
+	(void)image_index;
+	(void)recogn_result;
+	(void)count;
+}
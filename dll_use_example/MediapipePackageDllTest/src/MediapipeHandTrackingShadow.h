@@ -0,0 +1,144 @@
+#ifndef MEDIAPIPE_HAND_TRACKING_SHADOW_H
+#define MEDIAPIPE_HAND_TRACKING_SHADOW_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "MediapipeHandTrackingDll.h"
+
+//!
+//! @brief - Run a sample of live frames through an alternate graph as well
+//!
+//! Every frame goes through the primary DLL on the caller's thread, as with
+//! Detect_Frame_Direct. A configurable fraction of them is also copied to a
+//! low-priority worker that runs the frame through a second copy of the DLL loaded
+//! with another graph (a quantized model, other thresholds) and compares the two:
+//! DLL latency of both on the same frames, landmark distance, and how often they
+//! disagree on success, the hand count or the gestures. Frames are sampled whatever
+//! the primary returned, so a shadow that succeeds where the primary fails shows up
+//! too. The DLL may report hands in either order, so hands are paired by the nearest
+//! wrist before their landmarks are compared. The caller only ever gets the primary
+//! result; a sample that arrives while the worker is still busy is skipped rather
+//! than queued, so the shadow never holds up production frames.
+//!
+//! The shadow DLL must be a separate file, e.g. Mediapipe_Hand_Tracking_shadow.dll,
+//! for the reasons given in MediapipeHandTrackingHotSwap.h. The primary's landmarks
+//! are collected through its landmark callback, so while started this class owns
+//! both callbacks of the primary; only one instance may be started at a time.
+//!
+//! Shadow latency is measured on a low-priority thread next to the production load,
+//! so it reads high when the cores are busy; compare it with the primary under the
+//! same load, or run MediapipeRegressionRunner offline for absolute numbers.
+//!
+
+struct ShadowTrackingOptions
+{
+	double m_Sample_Rate = 0.01;		// fraction of frames also run through the shadow, 0..1
+	int m_Latency_Window = 1024;		// most recent samples the percentiles are taken over
+	bool m_Is_Low_Priority = true;		// lower the worker's scheduling priority
+};
+
+struct ShadowHandResult
+{
+	int m_Detect_Result = 0;
+	bool m_Is_Sampled = false;				// the frame was handed to the shadow
+	GestureRecognitionResult m_Gesture_Result;
+	std::vector<PoseInfo> m_Landmarks;		// empty when no hand was found
+};
+
+struct ShadowTrackingStats
+{
+	unsigned long long m_Frames = 0;
+	unsigned long long m_Samples = 0;				// frames the shadow ran
+	unsigned long long m_Samples_Skipped = 0;		// sampled while the shadow was still busy
+	unsigned long long m_Primary_Failures = 0;		// the primary DLL call returned 0 on a sample
+	unsigned long long m_Shadow_Failures = 0;		// the shadow DLL call returned 0
+	unsigned long long m_Result_Mismatches = 0;		// samples where exactly one side failed
+	unsigned long long m_Hand_Count_Mismatches = 0;	// samples where one side found more hands
+	unsigned long long m_Gesture_Mismatches = 0;
+	unsigned long long m_Landmark_Samples = 0;		// samples with the same hand count, at least one hand
+	double m_Mean_Landmark_Delta_Px = 0.0;
+	double m_Max_Landmark_Delta_Px = 0.0;
+	double m_Primary_Latency_P50_Ms = 0.0;			// over the sampled frames only
+	double m_Primary_Latency_P95_Ms = 0.0;
+	double m_Shadow_Latency_P50_Ms = 0.0;
+	double m_Shadow_Latency_P95_Ms = 0.0;
+};
+
+class MediapipeHandTrackingShadow
+{
+public:
+	MediapipeHandTrackingShadow(MediapipeHandTrackingDll& primary_dll, const ShadowTrackingOptions& options = ShadowTrackingOptions());
+	virtual~MediapipeHandTrackingShadow();
+
+public:
+	// Loads and initializes the shadow DLL, then starts its worker
+	bool Start(const std::string& shadow_dll_path, const std::string& shadow_model_path);
+	void Stop();
+
+	// image_data is densely packed BGR, as Detect_Frame_Direct expects
+	bool DetectFrame(int image_width, int image_height, void* image_data, ShadowHandResult& result);
+
+	// safe from any thread
+	ShadowTrackingStats GetStats();
+	void ResetStats();
+
+private:
+	struct ShadowSample
+	{
+		int m_Image_Width = 0;
+		int m_Image_Height = 0;
+		std::vector<unsigned char> m_Image_Data;
+		int m_Primary_Result = 0;
+		double m_Primary_Ms = 0.0;
+		GestureRecognitionResult m_Primary_Gesture_Result;
+		std::vector<PoseInfo> m_Primary_Landmarks;
+	};
+
+	void WorkerThread();
+	void CompareSample(const ShadowSample& sample, int shadow_result, double shadow_ms, const GestureRecognitionResult& shadow_gesture_result);
+	// Mean landmark distance over the hands of primary and shadow paired by nearest wrist
+	static double MatchedLandmarkDelta(const std::vector<PoseInfo>& primary, const std::vector<PoseInfo>& shadow);
+	static double Percentile(std::vector<double> values, double fraction);
+
+	static void PrimaryLandmarksTrampoline(int image_index, PoseInfo* infos, int count);
+	static void ShadowLandmarksTrampoline(int image_index, PoseInfo* infos, int count);
+	static void GestureTrampoline(int image_index, int* recogn_result, int count);
+
+private:
+	static std::atomic<MediapipeHandTrackingShadow*> s_ActiveShadow;
+
+	MediapipeHandTrackingDll& m_PrimaryDll;
+	MediapipeHandTrackingDll m_ShadowDll;
+	ShadowTrackingOptions m_Options;
+	bool m_IsStarted;
+	double m_SampleCredit;
+
+	// written by the primary's landmark callback on the caller's thread
+	std::vector<PoseInfo>* m_PrimaryLandmarks;
+	// written by the shadow's landmark callback on the worker
+	std::vector<PoseInfo> m_ShadowLandmarks;
+
+	std::thread m_Worker;
+	std::mutex m_SampleMutex;
+	std::condition_variable m_SampleReady;
+	ShadowSample m_Sample;
+	bool m_HasSample;
+	bool m_IsStopping;
+
+	std::atomic<unsigned long long> m_FrameCount;
+	std::atomic<unsigned long long> m_SkippedCount;
+
+	std::mutex m_StatsMutex;
+	ShadowTrackingStats m_Stats;
+	double m_LandmarkDeltaSum;
+	std::vector<double> m_PrimaryLatencies;
+	std::vector<double> m_ShadowLatencies;
+	size_t m_NextLatency;
+};
+
+#endif // !MEDIAPIPE_HAND_TRACKING_SHADOW_H
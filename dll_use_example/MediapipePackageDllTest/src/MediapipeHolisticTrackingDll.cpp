@@ -4,7 +4,11 @@ MediapipeHolisticTrackingDll::MediapipeHolisticTrackingDll()
 {
 	m_MediapipeHolisticTrackingInit = nullptr;
 	m_MediapipeHolisticTrackingDetectFrameDirect = nullptr;
+	m_MediapipeHolisticTrackingDetectCamera = nullptr;
 	m_MediapipeHolisticTrackingRelease = nullptr;
+	m_MediapipeIKSolveChain = nullptr;
+	m_MediapipeIKSolveLandmarkChain = nullptr;
+	m_MediapipeIKSolveChainBatch = nullptr;
 }
 
 MediapipeHolisticTrackingDll::~MediapipeHolisticTrackingDll()
@@ -15,15 +19,22 @@ MediapipeHolisticTrackingDll::~MediapipeHolisticTrackingDll()
 	}
 }
 
-bool MediapipeHolisticTrackingDll::LoadMediapipeHolisticTrackingDll(const std::string& dll_path)
+bool MediapipeHolisticTrackingDll::LoadMediapipeHolisticTrackingDll(const std::string& dll_path, DynamicModuleLoadMode load_mode, const std::string& preload_manifest)
 {
 	std::string dllPath = dll_path;
 	if (m_DynamicModuleLoader.IsFileExist(dllPath))
 	{
-		if (m_DynamicModuleLoader.LoadDynamicModule(dllPath))
+		if (!preload_manifest.empty() && !m_DynamicModuleLoader.LoadPreloadManifest(preload_manifest, load_mode))
+		{
+			m_DynamicModuleLoader.UnloadDynamicModule();
+			return false;
+		}
+		if (m_DynamicModuleLoader.LoadDynamicModule(dllPath, load_mode))
 		{
 			return true;
 		}
+		// drop whatever the manifest preloaded
+		m_DynamicModuleLoader.UnloadDynamicModule();
 	}
 
 	return false;
@@ -43,6 +54,13 @@ bool MediapipeHolisticTrackingDll::GetAllFunctions()
 {
 	if (m_DynamicModuleLoader.GetDynamicModuleState())
 	{
+		// DLLs that export the function table need a single lookup; older ones fall through
+		if (GetFunctionsFromApiTable())
+		{
+			GetOptionalFunctions();
+			return true;
+		}
+
 		void* pMediapipeHolisticTrackingInit = m_DynamicModuleLoader.GetFunction("MediapipeHolisticTrackingInit");
 		if (pMediapipeHolisticTrackingInit != nullptr)
 		{
@@ -114,7 +132,50 @@ bool MediapipeHolisticTrackingDll::GetAllFunctions()
 		{
 			return false;
 		}
+
+		GetOptionalFunctions();
+	}
+
+	return true;
+}
+
+bool MediapipeHolisticTrackingDll::GetFunctionsFromApiTable()
+{
+	void* pMediapipeHolisticTrackingGetApiTable = m_DynamicModuleLoader.GetFunction("MediapipeHolisticTrackingGetApiTable");
+	if (pMediapipeHolisticTrackingGetApiTable == nullptr)
+	{
+		return false;
 	}
 
+	FuncMediapipeHolisticTrackingGetApiTable getApiTable = (FuncMediapipeHolisticTrackingGetApiTable)(pMediapipeHolisticTrackingGetApiTable);
+	const MediapipeHolisticTrackingApiTable* apiTable = getApiTable(MEDIAPIPE_HOLISTIC_TRACKING_API_VERSION);
+	if (apiTable == nullptr
+		|| apiTable->m_Version < MEDIAPIPE_HOLISTIC_TRACKING_API_VERSION
+		|| apiTable->m_Size < (int)sizeof(MediapipeHolisticTrackingApiTable))
+	{
+		return false;
+	}
+
+	if (apiTable->m_MediapipeHolisticTrackingInit == nullptr
+		|| apiTable->m_MediapipeHolisticTrackingDetectFrameDirect == nullptr
+		|| apiTable->m_MediapipeHolisticTrackingDetectCamera == nullptr
+		|| apiTable->m_MediapipeHolisticTrackingRelease == nullptr)
+	{
+		return false;
+	}
+
+	m_MediapipeHolisticTrackingInit = apiTable->m_MediapipeHolisticTrackingInit;
+	m_MediapipeHolisticTrackingDetectFrameDirect = apiTable->m_MediapipeHolisticTrackingDetectFrameDirect;
+	m_MediapipeHolisticTrackingDetectCamera = apiTable->m_MediapipeHolisticTrackingDetectCamera;
+	m_MediapipeHolisticTrackingRelease = apiTable->m_MediapipeHolisticTrackingRelease;
+
 	return true;
 }
+
+void MediapipeHolisticTrackingDll::GetOptionalFunctions()
+{
+	// missing optional exports are not an error; callers check for nullptr
+	m_MediapipeIKSolveChain = m_DynamicModuleLoader.GetFunction<FuncMediapipeIKSolveChain>("Mediapipe_IK_Solve_Chain");
+	m_MediapipeIKSolveLandmarkChain = m_DynamicModuleLoader.GetFunction<FuncMediapipeIKSolveLandmarkChain>("Mediapipe_IK_Solve_Landmark_Chain");
+	m_MediapipeIKSolveChainBatch = m_DynamicModuleLoader.GetFunction<FuncMediapipeIKSolveChainBatch>("Mediapipe_IK_Solve_Chain_Batch");
+}
@@ -9,6 +9,33 @@ typedef int (*FuncMediapipeHolisticTrackingDetectFrameDirect)(int image_width, i
 typedef int (*FuncMediapipeHolisticTrackingDetectCamera)(bool show_image);
 typedef int (*FuncMediapipeHolisticTrackingRelease)();
 
+// optional, exported by DLLs built with dll/ik_solver; see ik_solver_api.h
+typedef int (*FuncMediapipeIKSolveChain)(float* joint_positions, int joint_count, const float* target_position, int solver_type, int max_iterations, float tolerance, float* bone_rotations, int* iterations_used);
+typedef int (*FuncMediapipeIKSolveLandmarkChain)(float* landmarks, int landmark_count, int landmark_stride, const int* chain_indices, int chain_length, const float* target_position, int solver_type, int max_iterations, float tolerance, float* bone_rotations, int* iterations_used);
+typedef int (*FuncMediapipeIKSolveChainBatch)(float* xs, float* ys, float* zs, int chain_count, int joint_count, const float* targets, int max_iterations, float tolerance, int* iterations_used);
+
+//!
+//! @brief - Function table returned by MediapipeHolisticTrackingGetApiTable
+//!
+//! New exports are appended at the end and MEDIAPIPE_HOLISTIC_TRACKING_API_VERSION
+//! is bumped, so a table of a newer version is still readable by an older client.
+//! The hand DLL exports its table under its own name, so pointing this loader at it
+//! finds no table instead of one with a different layout.
+//!
+#define MEDIAPIPE_HOLISTIC_TRACKING_API_VERSION 1
+
+struct MediapipeHolisticTrackingApiTable
+{
+	int m_Version;
+	int m_Size;		// sizeof the table as compiled into the DLL
+	FuncMediapipeHolisticTrackingInit m_MediapipeHolisticTrackingInit;
+	FuncMediapipeHolisticTrackingDetectFrameDirect m_MediapipeHolisticTrackingDetectFrameDirect;
+	FuncMediapipeHolisticTrackingDetectCamera m_MediapipeHolisticTrackingDetectCamera;
+	FuncMediapipeHolisticTrackingRelease m_MediapipeHolisticTrackingRelease;
+};
+
+typedef const MediapipeHolisticTrackingApiTable* (*FuncMediapipeHolisticTrackingGetApiTable)(int version);
+
 class MediapipeHolisticTrackingDll
 {
 public:
@@ -16,7 +43,8 @@ public:
 	virtual~ MediapipeHolisticTrackingDll();
 
 public:
-	bool LoadMediapipeHolisticTrackingDll(const std::string& dll_path);
+	// preload_manifest optionally lists dependency libraries to load first, see DynamicModuleLoader::LoadPreloadManifest
+	bool LoadMediapipeHolisticTrackingDll(const std::string& dll_path, DynamicModuleLoadMode load_mode = DMLM_Global, const std::string& preload_manifest = "");
 	bool UnLoadMediapipeHolisticTrackingDll();
 	bool GetAllFunctions();
 
@@ -26,6 +54,15 @@ public:
 	FuncMediapipeHolisticTrackingDetectCamera m_MediapipeHolisticTrackingDetectCamera;
 	FuncMediapipeHolisticTrackingRelease m_MediapipeHolisticTrackingRelease;
 
+	// null when the loaded DLL does not export them
+	FuncMediapipeIKSolveChain m_MediapipeIKSolveChain;
+	FuncMediapipeIKSolveLandmarkChain m_MediapipeIKSolveLandmarkChain;
+	FuncMediapipeIKSolveChainBatch m_MediapipeIKSolveChainBatch;
+
+private:
+	bool GetFunctionsFromApiTable();
+	void GetOptionalFunctions();
+
 private:
 	DynamicModuleLoader m_DynamicModuleLoader;
 };
@@ -0,0 +1,81 @@
+#include "MediapipeHolisticTrackingMotionGated.h"
+
+MediapipeHolisticTrackingMotionGated::MediapipeHolisticTrackingMotionGated(MediapipeHolisticTrackingDll& holistic_tracking_dll, const MotionGateOptions& options, const IdleThrottleOptions& idle_options)
+	: m_HolisticTrackingDll(holistic_tracking_dll)
+	, m_MotionGate(options)
+	, m_IdleThrottle(idle_options)
+	, m_HasLastResult(false)
+	, m_ProcessedFrameCount(0)
+	, m_CachedFrameCount(0)
+{
+}
+
+MediapipeHolisticTrackingMotionGated::~MediapipeHolisticTrackingMotionGated()
+{
+}
+
+bool MediapipeHolisticTrackingMotionGated::DetectFrame(int image_width, int image_height, void* image_data, bool show_result_image, MotionGatedHolisticResult& result)
+{
+	if (m_HolisticTrackingDll.m_MediapipeHolisticTrackingDetectFrameDirect == nullptr)
+	{
+		return false;
+	}
+
+	bool isStatic = m_MotionGate.IsStatic(image_width, image_height, (const unsigned char*)image_data);
+	bool isIdleSkip = !m_IdleThrottle.ShouldRun();
+	if (m_HasLastResult && (isStatic || isIdleSkip))
+	{
+		++m_CachedFrameCount;
+		result = m_LastResult;
+		result.m_Is_Cached = true;
+		result.m_Is_Idle = m_IdleThrottle.IsIdle();
+		return true;
+	}
+
+	MotionGatedHolisticResult current;
+	int detectResult = m_HolisticTrackingDll.m_MediapipeHolisticTrackingDetectFrameDirect(image_width, image_height, image_data, current.m_Detect_Result, show_result_image);
+	++m_ProcessedFrameCount;
+	current.m_Is_Idle = m_IdleThrottle.IsIdle();
+
+	// -1 means unknown for every slot, i.e. nobody in view
+	bool foundSomething = false;
+	for (int i = 0; i < 4; ++i)
+	{
+		foundSomething = foundSomething || current.m_Detect_Result[i] != -1;
+	}
+	m_IdleThrottle.ReportResult(detectResult != 0 && foundSomething);
+
+	if (detectResult == 0)
+	{
+		// never re-emit a failed frame
+		m_MotionGate.Reset();
+		m_HasLastResult = false;
+		return false;
+	}
+
+	m_MotionGate.Accept();
+	m_LastResult = current;
+	m_HasLastResult = true;
+	result = current;
+	return true;
+}
+
+MotionGate& MediapipeHolisticTrackingMotionGated::GetMotionGate()
+{
+	return m_MotionGate;
+}
+
+IdleThrottle& MediapipeHolisticTrackingMotionGated::GetIdleThrottle()
+{
+	return m_IdleThrottle;
+}
+
+unsigned long long MediapipeHolisticTrackingMotionGated::GetProcessedFrameCount()
+{
+	return m_ProcessedFrameCount;
+}
+
+unsigned long long MediapipeHolisticTrackingMotionGated::GetCachedFrameCount()
+{
+	return m_CachedFrameCount;
+}
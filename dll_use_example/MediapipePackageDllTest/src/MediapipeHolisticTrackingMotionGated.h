@@ -0,0 +1,52 @@
+#ifndef MEDIAPIPE_HOLISTIC_TRACKING_MOTION_GATED_H
+#define MEDIAPIPE_HOLISTIC_TRACKING_MOTION_GATED_H
+
+#include "MediapipeHolisticTrackingDll.h"
+#include "IdleThrottle.h"
+#include "MotionGate.h"
+
+//!
+//! @brief - MediapipeHolisticTrackingDetectFrameDirect behind a MotionGate
+//!
+//! When the gate reports a static scene, the DLL is not called and the detect results
+//! of the last processed frame are returned again with m_Is_Cached set. Skipped frames
+//! are not shown even when show_result_image is set.
+//!
+//! With idle options set, frames between idle polls are answered the same way once
+//! none of the four results has been known for a while (see IdleThrottle).
+//!
+
+struct MotionGatedHolisticResult
+{
+	// left arm up/down, right arm up/down, left hand gesture, right hand gesture
+	int m_Detect_Result[4] = { -1, -1, -1, -1 };
+	bool m_Is_Cached = false;		// true when re-emitted from the last processed frame
+	bool m_Is_Idle = false;			// the tracker was idle-polling when this frame arrived
+};
+
+class MediapipeHolisticTrackingMotionGated
+{
+public:
+	MediapipeHolisticTrackingMotionGated(MediapipeHolisticTrackingDll& holistic_tracking_dll, const MotionGateOptions& options = MotionGateOptions(), const IdleThrottleOptions& idle_options = IdleThrottleOptions());
+	virtual~MediapipeHolisticTrackingMotionGated();
+
+public:
+	// image_data is densely packed BGR
+	bool DetectFrame(int image_width, int image_height, void* image_data, bool show_result_image, MotionGatedHolisticResult& result);
+
+	MotionGate& GetMotionGate();
+	IdleThrottle& GetIdleThrottle();
+	unsigned long long GetProcessedFrameCount();
+	unsigned long long GetCachedFrameCount();
+
+private:
+	MediapipeHolisticTrackingDll& m_HolisticTrackingDll;
+	MotionGate m_MotionGate;
+	IdleThrottle m_IdleThrottle;
+	MotionGatedHolisticResult m_LastResult;
+	bool m_HasLastResult;
+	unsigned long long m_ProcessedFrameCount;
+	unsigned long long m_CachedFrameCount;
+};
+
+#endif // !MEDIAPIPE_HOLISTIC_TRACKING_MOTION_GATED_H
@@ -0,0 +1,301 @@
+#include "MediapipeMultiCameraScheduler.h"
+
+#include <cstring>
+
+std::atomic<MediapipeMultiCameraScheduler*> MediapipeMultiCameraScheduler::s_ActiveScheduler(nullptr);
+
+namespace
+{
+	typedef void(*WorkerLandmarksCallBack)(int image_index, PoseInfo* infos, int count);
+
+	// Detect_Frame_Direct already returns the gesture result; registered so the DLL never calls a null callback
+	void IgnoreGestureResult(int image_index, int* recogn_result, int count)
+	{
+		(void)image_index;
+		(void)recogn_result;
+		(void)count;
+	}
+}
+
+// The DLL callbacks carry no user pointer, so each worker's DLL copy gets its own
+// instantiation and the index says which worker the landmarks belong to
+template<int Index>
+void MediapipeMultiCameraScheduler::LandmarksTrampoline(int image_index, PoseInfo* infos, int count)
+{
+	(void)image_index;
+	MediapipeMultiCameraScheduler* scheduler = s_ActiveScheduler.load(std::memory_order_acquire);
+	if (scheduler != nullptr)
+	{
+		scheduler->OnLandmarks(Index, infos, count);
+	}
+}
+
+MediapipeMultiCameraScheduler::MediapipeMultiCameraScheduler(int max_landmark_count)
+	: m_MaxLandmarkCount(max_landmark_count > 0 ? max_landmark_count : HAND_KEYPOINT_COUNT * MAX_HAND_COUNT)
+	, m_IsRunning(false)
+{
+}
+
+MediapipeMultiCameraScheduler::~MediapipeMultiCameraScheduler()
+{
+	Stop();
+}
+
+bool MediapipeMultiCameraScheduler::Start(const std::vector<std::string>& dll_paths, const std::string& model_path, CameraResultCallback callback)
+{
+	static const WorkerLandmarksCallBack kTrampolines[MULTI_CAMERA_SCHEDULER_MAX_WORKERS] =
+	{
+		LandmarksTrampoline<0>, LandmarksTrampoline<1>, LandmarksTrampoline<2>, LandmarksTrampoline<3>,
+		LandmarksTrampoline<4>, LandmarksTrampoline<5>, LandmarksTrampoline<6>, LandmarksTrampoline<7>
+	};
+
+	if (dll_paths.empty() || dll_paths.size() > MULTI_CAMERA_SCHEDULER_MAX_WORKERS)
+	{
+		return false;
+	}
+
+	MediapipeMultiCameraScheduler* expected = nullptr;
+	if (!s_ActiveScheduler.compare_exchange_strong(expected, this))
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i < dll_paths.size(); ++i)
+	{
+		std::unique_ptr<Worker> worker(new Worker());
+		worker->m_Landmarks.resize(m_MaxLandmarkCount);
+		if (!worker->m_Dll.LoadMediapipeHandTrackingDll(dll_paths[i])
+			|| !worker->m_Dll.GetAllFunctions()
+			|| !worker->m_Dll.m_Mediapipe_Hand_Tracking_Init(model_path.c_str())
+			|| !worker->m_Dll.m_Mediapipe_Hand_Tracking_Reigeter_Landmarks_Callback(kTrampolines[i])
+			|| !worker->m_Dll.m_Mediapipe_Hand_Tracking_Register_Gesture_Result_Callback(IgnoreGestureResult))
+		{
+			m_Workers.push_back(std::move(worker));
+			Stop();
+			return false;
+		}
+		m_Workers.push_back(std::move(worker));
+	}
+
+	m_Callback = callback;
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_IsRunning = true;
+	}
+	for (size_t i = 0; i < m_Workers.size(); ++i)
+	{
+		m_Workers[i]->m_Thread = std::thread(&MediapipeMultiCameraScheduler::WorkerLoop, this, (int)i);
+	}
+	return true;
+}
+
+void MediapipeMultiCameraScheduler::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		m_IsRunning = false;
+	}
+	m_WorkAvailable.notify_all();
+
+	for (std::unique_ptr<Worker>& worker : m_Workers)
+	{
+		if (worker->m_Thread.joinable())
+		{
+			worker->m_Thread.join();
+		}
+		if (worker->m_Dll.m_Mediapipe_Hand_Tracking_Release != nullptr)
+		{
+			worker->m_Dll.m_Mediapipe_Hand_Tracking_Release();
+		}
+		worker->m_Dll.UnLoadMediapipeHandTrackingDll();
+	}
+	m_Workers.clear();
+
+	MediapipeMultiCameraScheduler* expected = this;
+	s_ActiveScheduler.compare_exchange_strong(expected, nullptr);
+}
+
+int MediapipeMultiCameraScheduler::AddCamera(int deadline_ms)
+{
+	std::unique_ptr<Camera> camera(new Camera());
+	camera->m_Deadline = std::chrono::milliseconds(deadline_ms > 0 ? deadline_ms : 1);
+	camera->m_Last_Dispatch = Clock::now();
+
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_Cameras.push_back(std::move(camera));
+	return (int)m_Cameras.size() - 1;
+}
+
+bool MediapipeMultiCameraScheduler::SubmitFrame(int camera_id, int image_index, int image_width, int image_height, const void* image_data, int image_stride)
+{
+	size_t rowSize = (size_t)image_width * 3;
+	size_t srcStride = image_stride > 0 ? (size_t)image_stride : rowSize;
+	if (image_data == nullptr || image_width <= 0 || image_height <= 0 || srcStride < rowSize)
+	{
+		return false;
+	}
+
+	Camera* camera = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (!m_IsRunning || camera_id < 0 || camera_id >= (int)m_Cameras.size())
+		{
+			return false;
+		}
+		camera = m_Cameras[camera_id].get();
+	}
+
+	// Staging belongs to the camera's producer, so the copy needs no lock
+	Frame& staging = camera->m_Staging;
+	size_t imageSize = rowSize * (size_t)image_height;
+	if (staging.m_Image_Data.size() < imageSize)
+	{
+		staging.m_Image_Data.resize(imageSize);
+	}
+	if (srcStride == rowSize)
+	{
+		memcpy(staging.m_Image_Data.data(), image_data, imageSize);
+	}
+	else
+	{
+		const unsigned char* src = (const unsigned char*)image_data;
+		unsigned char* dst = staging.m_Image_Data.data();
+		for (int row = 0; row < image_height; ++row)
+		{
+			memcpy(dst + row * rowSize, src + row * srcStride, rowSize);
+		}
+	}
+	staging.m_Image_Index = image_index;
+	staging.m_Image_Width = image_width;
+	staging.m_Image_Height = image_height;
+	staging.m_Submit_Time = Clock::now();
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (camera->m_Has_Pending)
+		{
+			++camera->m_Stats.m_Dropped_Replaced;
+		}
+		std::swap(camera->m_Pending, camera->m_Staging);
+		camera->m_Has_Pending = true;
+	}
+	m_WorkAvailable.notify_one();
+	return true;
+}
+
+CameraStats MediapipeMultiCameraScheduler::GetCameraStats(int camera_id)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	if (camera_id < 0 || camera_id >= (int)m_Cameras.size())
+	{
+		return CameraStats();
+	}
+	return m_Cameras[camera_id]->m_Stats;
+}
+
+int MediapipeMultiCameraScheduler::GetWorkerCount()
+{
+	return (int)m_Workers.size();
+}
+
+void MediapipeMultiCameraScheduler::OnLandmarks(int worker_index, PoseInfo* infos, int count)
+{
+	if (worker_index >= (int)m_Workers.size())
+	{
+		return;
+	}
+	Worker& worker = *m_Workers[worker_index];
+	int copyCount = count < m_MaxLandmarkCount ? count : m_MaxLandmarkCount;
+	if (infos == nullptr || copyCount < 0)
+	{
+		copyCount = 0;
+	}
+	memcpy(worker.m_Landmarks.data(), infos, copyCount * sizeof(PoseInfo));
+	worker.m_Landmark_Count = copyCount;
+}
+
+bool MediapipeMultiCameraScheduler::TakeNextFrame(Worker& worker, int& camera_id)
+{
+	// caller holds m_Mutex
+	Clock::time_point now = Clock::now();
+	int best = -1;
+	Clock::time_point bestPriority;
+	for (size_t i = 0; i < m_Cameras.size(); ++i)
+	{
+		Camera& camera = *m_Cameras[i];
+		if (!camera.m_Has_Pending || camera.m_In_Flight)
+		{
+			continue;
+		}
+		Clock::time_point deadline = camera.m_Pending.m_Submit_Time + camera.m_Deadline;
+		if (deadline < now)
+		{
+			// already too late; running it would only delay fresher frames
+			camera.m_Has_Pending = false;
+			++camera.m_Stats.m_Dropped_Stale;
+			continue;
+		}
+		// Plain earliest-deadline-first starves relaxed cameras under overload; moving the
+		// deadline forward by the time since the camera was last served keeps it fair
+		Clock::time_point priority = deadline - (now - camera.m_Last_Dispatch);
+		if (best < 0 || priority < bestPriority)
+		{
+			best = (int)i;
+			bestPriority = priority;
+		}
+	}
+	if (best < 0)
+	{
+		return false;
+	}
+
+	Camera& camera = *m_Cameras[best];
+	std::swap(worker.m_Frame, camera.m_Pending);
+	camera.m_Has_Pending = false;
+	camera.m_In_Flight = true;
+	camera.m_Last_Dispatch = now;
+	camera_id = best;
+	return true;
+}
+
+void MediapipeMultiCameraScheduler::WorkerLoop(int worker_index)
+{
+	Worker& worker = *m_Workers[worker_index];
+	while (true)
+	{
+		int cameraId = -1;
+		{
+			std::unique_lock<std::mutex> lock(m_Mutex);
+			m_WorkAvailable.wait(lock, [&] { return !m_IsRunning || TakeNextFrame(worker, cameraId); });
+			if (cameraId < 0)
+			{
+				return;
+			}
+		}
+
+		// Detect_Frame_Direct returns after the frame's callbacks have fired
+		CameraFrameResult result;
+		worker.m_Landmark_Count = -1;
+		result.m_Detect_Result = worker.m_Dll.m_Mediapipe_Hand_Tracking_Detect_Frame_Direct(
+			worker.m_Frame.m_Image_Width, worker.m_Frame.m_Image_Height, worker.m_Frame.m_Image_Data.data(), result.m_Gesture_Result);
+
+		result.m_Camera_Id = cameraId;
+		result.m_Image_Index = worker.m_Frame.m_Image_Index;
+		result.m_Landmarks = worker.m_Landmarks.data();
+		result.m_Landmark_Count = worker.m_Landmark_Count;
+		result.m_Latency_Ms = std::chrono::duration<double, std::milli>(Clock::now() - worker.m_Frame.m_Submit_Time).count();
+		if (m_Callback)
+		{
+			m_Callback(result);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_Mutex);
+			Camera& camera = *m_Cameras[cameraId];
+			camera.m_In_Flight = false;
+			++camera.m_Stats.m_Processed;
+		}
+		// the camera may have a pending frame that was skipped while this one ran
+		m_WorkAvailable.notify_one();
+	}
+}
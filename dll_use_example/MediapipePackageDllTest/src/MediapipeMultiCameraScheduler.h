@@ -0,0 +1,122 @@
+#ifndef MEDIAPIPE_MULTI_CAMERA_SCHEDULER_H
+#define MEDIAPIPE_MULTI_CAMERA_SCHEDULER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "MediapipeHandTrackingDll.h"
+
+//!
+//! @brief - Shares a fixed pool of hand tracking instances between many cameras
+//!
+//! Each camera keeps at most one pending frame; a newer frame replaces it, so
+//! nothing queues up behind a slow worker. Idle workers take the pending frame with
+//! the earliest deadline (submit time + the camera's deadline), moved forward by the
+//! time since its camera was last served, from a camera that has no frame in
+//! flight. Frames already past their deadline are dropped instead of run. N workers therefore serve M cameras with N sets of graph threads
+//! instead of M.
+//!
+//! The DLL keeps its graph in globals, so every worker needs its own copy of the
+//! DLL file (e.g. Mediapipe_Hand_Tracking_0.dll .. _3.dll).
+//!
+
+#define MULTI_CAMERA_SCHEDULER_MAX_WORKERS 8
+
+struct CameraFrameResult
+{
+	int m_Camera_Id;
+	int m_Image_Index;
+	int m_Detect_Result;
+	GestureRecognitionResult m_Gesture_Result;
+	const PoseInfo* m_Landmarks;		// valid for the duration of the callback only
+	int m_Landmark_Count;				// -1 when the DLL reported no landmarks
+	double m_Latency_Ms;				// submit to result
+};
+
+struct CameraStats
+{
+	unsigned long long m_Processed = 0;
+	unsigned long long m_Dropped_Stale = 0;		// past the deadline when a worker got to it
+	unsigned long long m_Dropped_Replaced = 0;	// overwritten by a newer frame before dispatch
+};
+
+typedef std::function<void(const CameraFrameResult& result)> CameraResultCallback;
+
+class MediapipeMultiCameraScheduler
+{
+public:
+	MediapipeMultiCameraScheduler(int max_landmark_count = HAND_KEYPOINT_COUNT * MAX_HAND_COUNT);
+	virtual~MediapipeMultiCameraScheduler();
+
+public:
+	// One worker per DLL path; the callback runs on the worker threads
+	bool Start(const std::vector<std::string>& dll_paths, const std::string& model_path, CameraResultCallback callback);
+	void Stop();
+
+	// Returns the camera id; may be called while running
+	int AddCamera(int deadline_ms);
+	// image_data is BGR; image_stride is the row pitch in bytes (0 = densely packed).
+	// One producer thread per camera: the copy goes into the camera's staging buffer outside the lock.
+	bool SubmitFrame(int camera_id, int image_index, int image_width, int image_height, const void* image_data, int image_stride = 0);
+
+	CameraStats GetCameraStats(int camera_id);
+	int GetWorkerCount();
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	struct Frame
+	{
+		int m_Image_Index = -1;
+		int m_Image_Width = 0;
+		int m_Image_Height = 0;
+		Clock::time_point m_Submit_Time;
+		std::vector<unsigned char> m_Image_Data;
+	};
+
+	struct Camera
+	{
+		std::chrono::milliseconds m_Deadline;
+		Clock::time_point m_Last_Dispatch;
+		bool m_Has_Pending = false;
+		bool m_In_Flight = false;
+		Frame m_Pending;
+		Frame m_Staging;
+		CameraStats m_Stats;
+	};
+
+	struct Worker
+	{
+		MediapipeHandTrackingDll m_Dll;
+		std::thread m_Thread;
+		Frame m_Frame;
+		std::vector<PoseInfo> m_Landmarks;
+		int m_Landmark_Count = -1;
+	};
+
+	template<int Index> static void LandmarksTrampoline(int image_index, PoseInfo* infos, int count);
+	void OnLandmarks(int worker_index, PoseInfo* infos, int count);
+	void WorkerLoop(int worker_index);
+	bool TakeNextFrame(Worker& worker, int& camera_id);
+
+private:
+	static std::atomic<MediapipeMultiCameraScheduler*> s_ActiveScheduler;
+
+	int m_MaxLandmarkCount;
+	CameraResultCallback m_Callback;
+	std::vector<std::unique_ptr<Worker>> m_Workers;
+	std::vector<std::unique_ptr<Camera>> m_Cameras;
+
+	bool m_IsRunning;
+	std::mutex m_Mutex;
+	std::condition_variable m_WorkAvailable;
+};
+
+#endif // !MEDIAPIPE_MULTI_CAMERA_SCHEDULER_H
@@ -0,0 +1,148 @@
+#include "MotionGate.h"
+
+namespace
+{
+	const int kThumbnailSize = MOTION_GATE_THUMBNAIL_WIDTH * MOTION_GATE_THUMBNAIL_HEIGHT;
+	const int kSamplesPerAxis = 4;
+}
+
+MotionGate::MotionGate(const MotionGateOptions& options)
+	: m_Options(options)
+	, m_Current(kThumbnailSize)
+	, m_Reference(kThumbnailSize)
+	, m_HasReference(false)
+	, m_CachedFrames(0)
+	, m_LastDifference(-1)
+	, m_LastChangedCells(-1)
+	, m_ReferenceWidth(0)
+	, m_ReferenceHeight(0)
+	, m_CurrentWidth(0)
+	, m_CurrentHeight(0)
+{
+}
+
+MotionGate::~MotionGate()
+{
+}
+
+bool MotionGate::IsStatic(int image_width, int image_height, const unsigned char* image_data, int image_stride)
+{
+	size_t rowSize = (size_t)image_width * 3;
+	size_t stride = image_stride > 0 ? (size_t)image_stride : rowSize;
+	if (image_data == nullptr || image_width <= 0 || image_height <= 0 || stride < rowSize)
+	{
+		m_LastDifference = -1;
+		m_LastChangedCells = -1;
+		return false;
+	}
+
+	BuildThumbnail(image_width, image_height, image_data, stride);
+	m_CurrentWidth = image_width;
+	m_CurrentHeight = image_height;
+
+	if (!m_HasReference || image_width != m_ReferenceWidth || image_height != m_ReferenceHeight)
+	{
+		m_LastDifference = -1;
+		m_LastChangedCells = -1;
+		return false;
+	}
+
+	const unsigned char* current = m_Current.data();
+	const unsigned char* reference = m_Reference.data();
+	const int cellThreshold = m_Options.m_Cell_Threshold;
+	int sad = 0;
+	int changedCells = 0;
+	for (int i = 0; i < kThumbnailSize; ++i)
+	{
+		int diff = (int)current[i] - (int)reference[i];
+		diff = diff < 0 ? -diff : diff;
+		sad += diff;
+		changedCells += diff > cellThreshold ? 1 : 0;
+	}
+	m_LastDifference = sad / kThumbnailSize;
+	m_LastChangedCells = changedCells;
+
+	if (m_LastDifference >= m_Options.m_Threshold || m_LastChangedCells > m_Options.m_Max_Changed_Cells)
+	{
+		return false;
+	}
+	if (m_Options.m_Max_Cached_Frames > 0 && m_CachedFrames >= m_Options.m_Max_Cached_Frames)
+	{
+		return false;
+	}
+	++m_CachedFrames;
+	return true;
+}
+
+void MotionGate::Accept()
+{
+	if (m_CurrentWidth <= 0)
+	{
+		return;
+	}
+	m_Reference.swap(m_Current);
+	m_ReferenceWidth = m_CurrentWidth;
+	m_ReferenceHeight = m_CurrentHeight;
+	m_HasReference = true;
+	m_CachedFrames = 0;
+}
+
+void MotionGate::Reset()
+{
+	m_HasReference = false;
+	m_CachedFrames = 0;
+	m_LastDifference = -1;
+	m_LastChangedCells = -1;
+	m_CurrentWidth = 0;
+	m_CurrentHeight = 0;
+}
+
+int MotionGate::GetLastDifference()
+{
+	return m_LastDifference;
+}
+
+int MotionGate::GetLastChangedCells()
+{
+	return m_LastChangedCells;
+}
+
+void MotionGate::BuildThumbnail(int image_width, int image_height, const unsigned char* image_data, size_t image_stride)
+{
+	BuildMotionThumbnail(image_width, image_height, image_data, image_stride, m_Current.data());
+}
+
+void BuildMotionThumbnail(int image_width, int image_height, const unsigned char* image_data, size_t image_stride, unsigned char* thumbnail)
+{
+	// Sample positions are fixed per frame size, so they are computed once per cell
+	// column/row; (B + 2G + R) / 4 is close enough to luma for a difference test
+	int sampleX[MOTION_GATE_THUMBNAIL_WIDTH * kSamplesPerAxis];
+	const int sampleColumns = MOTION_GATE_THUMBNAIL_WIDTH * kSamplesPerAxis;
+	for (int i = 0; i < sampleColumns; ++i)
+	{
+		sampleX[i] = (int)(((long long)(2 * i + 1) * image_width) / (2 * sampleColumns)) * 3;
+	}
+
+	const int sampleRows = MOTION_GATE_THUMBNAIL_HEIGHT * kSamplesPerAxis;
+	unsigned char* out = thumbnail;
+	for (int cellY = 0; cellY < MOTION_GATE_THUMBNAIL_HEIGHT; ++cellY)
+	{
+		int sums[MOTION_GATE_THUMBNAIL_WIDTH] = { 0 };
+		for (int sy = 0; sy < kSamplesPerAxis; ++sy)
+		{
+			int i = cellY * kSamplesPerAxis + sy;
+			int y = (int)(((long long)(2 * i + 1) * image_height) / (2 * sampleRows));
+			const unsigned char* row = image_data + (size_t)y * image_stride;
+			for (int sx = 0; sx < sampleColumns; ++sx)
+			{
+				const unsigned char* pixel = row + sampleX[sx];
+				sums[sx / kSamplesPerAxis] += pixel[0] + 2 * pixel[1] + pixel[2];
+			}
+		}
+		for (int cellX = 0; cellX < MOTION_GATE_THUMBNAIL_WIDTH; ++cellX)
+		{
+			// 16 samples, each weighted by 4
+			out[cellY * MOTION_GATE_THUMBNAIL_WIDTH + cellX] = (unsigned char)(sums[cellX] >> 6);
+		}
+	}
+}
@@ -0,0 +1,74 @@
+#ifndef MOTION_GATE_H
+#define MOTION_GATE_H
+
+#include <cstddef>
+#include <vector>
+
+//!
+//! @brief - Decides whether a frame differs enough from the last processed one to be worth running
+//!
+//! Each BGR frame is reduced to a 64x36 luma thumbnail (every cell averages a 4x4
+//! grid of samples, so sensor noise mostly cancels) and compared against the thumbnail
+//! of the last frame that was actually processed, so slow drift still accumulates
+//! until it crosses the threshold. A frame is static only if both the mean absolute
+//! difference and the number of noticeably changed cells stay small; the cell count
+//! catches a small hand entering an otherwise unchanged scene, which barely moves the
+//! mean.
+//!
+//! Building the thumbnail touches 36864 pixels whatever the frame size, and the SAD
+//! is a plain byte loop the compiler vectorizes, so the check costs microseconds.
+//!
+
+#define MOTION_GATE_THUMBNAIL_WIDTH 64
+#define MOTION_GATE_THUMBNAIL_HEIGHT 36
+
+struct MotionGateOptions
+{
+	int m_Threshold = 3;			// mean absolute luma difference (0-255) below which a frame counts as static
+	int m_Cell_Threshold = 16;		// a cell whose luma moved by more than this counts as changed
+	int m_Max_Changed_Cells = 6;	// of 64x36; more changed cells than this means motion
+	int m_Max_Cached_Frames = 0;	// force a real run after this many consecutive skips; 0 = no limit
+};
+
+class MotionGate
+{
+public:
+	MotionGate(const MotionGateOptions& options = MotionGateOptions());
+	virtual~MotionGate();
+
+public:
+	// image_stride is the row pitch in bytes (0 = densely packed). Returns true when the
+	// frame can be skipped; the thumbnail is kept for a following Accept().
+	bool IsStatic(int image_width, int image_height, const unsigned char* image_data, int image_stride = 0);
+	// Makes the frame last passed to IsStatic the reference; call once it has been processed
+	void Accept();
+	// Forgets the reference so the next frame always runs, e.g. after a scene or camera change
+	void Reset();
+
+	// mean absolute difference computed by the last IsStatic, -1 when there was no reference
+	int GetLastDifference();
+	// changed cells counted by the last IsStatic, -1 when there was no reference
+	int GetLastChangedCells();
+
+private:
+	void BuildThumbnail(int image_width, int image_height, const unsigned char* image_data, size_t image_stride);
+
+private:
+	MotionGateOptions m_Options;
+	std::vector<unsigned char> m_Current;
+	std::vector<unsigned char> m_Reference;
+	bool m_HasReference;
+	int m_CachedFrames;
+	int m_LastDifference;
+	int m_LastChangedCells;
+	int m_ReferenceWidth;
+	int m_ReferenceHeight;
+	int m_CurrentWidth;
+	int m_CurrentHeight;
+};
+
+// The gate's 64x36 luma thumbnail of a BGR frame, also usable as a cheap frame signature;
+// thumbnail receives MOTION_GATE_THUMBNAIL_WIDTH * MOTION_GATE_THUMBNAIL_HEIGHT bytes
+void BuildMotionThumbnail(int image_width, int image_height, const unsigned char* image_data, size_t image_stride, unsigned char* thumbnail);
+
+#endif // !MOTION_GATE_H
@@ -0,0 +1,343 @@
+#include "MultiViewTriangulation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MULTI_VIEW_SSE
+#endif
+
+MultiViewTriangulator::MultiViewTriangulator(const std::vector<CameraCalibration>& cameras, int landmark_count)
+	: m_Cameras(cameras)
+	, m_LandmarkCount(std::max(1, landmark_count))
+	, m_ReprojectionError(0.0)
+{
+	const float nan = std::numeric_limits<float>::quiet_NaN();
+	m_X.assign(m_LandmarkCount, nan);
+	m_Y.assign(m_LandmarkCount, nan);
+	m_Z.assign(m_LandmarkCount, nan);
+	m_A00.resize(m_LandmarkCount);
+	m_A01.resize(m_LandmarkCount);
+	m_A02.resize(m_LandmarkCount);
+	m_A11.resize(m_LandmarkCount);
+	m_A12.resize(m_LandmarkCount);
+	m_A22.resize(m_LandmarkCount);
+	m_B0.resize(m_LandmarkCount);
+	m_B1.resize(m_LandmarkCount);
+	m_B2.resize(m_LandmarkCount);
+}
+
+MultiViewTriangulator::~MultiViewTriangulator()
+{
+}
+
+int MultiViewTriangulator::Triangulate(const std::vector<const PoseInfo*>& view_landmarks)
+{
+	const int n = m_LandmarkCount;
+	std::fill(m_A00.begin(), m_A00.end(), 0.0f);
+	std::fill(m_A01.begin(), m_A01.end(), 0.0f);
+	std::fill(m_A02.begin(), m_A02.end(), 0.0f);
+	std::fill(m_A11.begin(), m_A11.end(), 0.0f);
+	std::fill(m_A12.begin(), m_A12.end(), 0.0f);
+	std::fill(m_A22.begin(), m_A22.end(), 0.0f);
+	std::fill(m_B0.begin(), m_B0.end(), 0.0f);
+	std::fill(m_B1.begin(), m_B1.end(), 0.0f);
+	std::fill(m_B2.begin(), m_B2.end(), 0.0f);
+
+	float* a00 = m_A00.data();
+	float* a01 = m_A01.data();
+	float* a02 = m_A02.data();
+	float* a11 = m_A11.data();
+	float* a12 = m_A12.data();
+	float* a22 = m_A22.data();
+	float* b0 = m_B0.data();
+	float* b1 = m_B1.data();
+	float* b2 = m_B2.data();
+
+	int viewsSeen = 0;
+	const int views = std::min((int)view_landmarks.size(), (int)m_Cameras.size());
+	for (int v = 0; v < views; ++v)
+	{
+		const PoseInfo* points = view_landmarks[v];
+		if (points == nullptr)
+		{
+			continue;
+		}
+		++viewsSeen;
+		float p[12];
+		for (int k = 0; k < 12; ++k)
+		{
+			p[k] = (float)m_Cameras[v].m_Projection[k];
+		}
+
+		// each view adds the rows x * P3 - P1 and y * P3 - P2, normalized so every view weighs the same
+		int i = 0;
+#if defined(MULTI_VIEW_SSE)
+		// four landmarks per step; same arithmetic as the scalar loop below, which handles the tail
+		for (; i + 4 <= n; i += 4)
+		{
+			__m128 lo = _mm_loadu_ps(&points[i].x);
+			__m128 hi = _mm_loadu_ps(&points[i + 2].x);
+			__m128 coords[2] = { _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1)) };
+			for (int row = 0; row < 2; ++row)
+			{
+				const __m128 c = coords[row];
+				const float* q = p + row * 4;
+				__m128 r0 = _mm_sub_ps(_mm_mul_ps(c, _mm_set1_ps(p[8])), _mm_set1_ps(q[0]));
+				__m128 r1 = _mm_sub_ps(_mm_mul_ps(c, _mm_set1_ps(p[9])), _mm_set1_ps(q[1]));
+				__m128 r2 = _mm_sub_ps(_mm_mul_ps(c, _mm_set1_ps(p[10])), _mm_set1_ps(q[2]));
+				__m128 rhs = _mm_sub_ps(_mm_set1_ps(q[3]), _mm_mul_ps(c, _mm_set1_ps(p[11])));
+				__m128 norm = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(r0, r0), _mm_mul_ps(r1, r1)), _mm_mul_ps(r2, r2)), _mm_set1_ps(1e-20f));
+				__m128 scale = _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(norm));
+				r0 = _mm_mul_ps(r0, scale);
+				r1 = _mm_mul_ps(r1, scale);
+				r2 = _mm_mul_ps(r2, scale);
+				rhs = _mm_mul_ps(rhs, scale);
+				_mm_storeu_ps(a00 + i, _mm_add_ps(_mm_loadu_ps(a00 + i), _mm_mul_ps(r0, r0)));
+				_mm_storeu_ps(a01 + i, _mm_add_ps(_mm_loadu_ps(a01 + i), _mm_mul_ps(r0, r1)));
+				_mm_storeu_ps(a02 + i, _mm_add_ps(_mm_loadu_ps(a02 + i), _mm_mul_ps(r0, r2)));
+				_mm_storeu_ps(a11 + i, _mm_add_ps(_mm_loadu_ps(a11 + i), _mm_mul_ps(r1, r1)));
+				_mm_storeu_ps(a12 + i, _mm_add_ps(_mm_loadu_ps(a12 + i), _mm_mul_ps(r1, r2)));
+				_mm_storeu_ps(a22 + i, _mm_add_ps(_mm_loadu_ps(a22 + i), _mm_mul_ps(r2, r2)));
+				_mm_storeu_ps(b0 + i, _mm_add_ps(_mm_loadu_ps(b0 + i), _mm_mul_ps(r0, rhs)));
+				_mm_storeu_ps(b1 + i, _mm_add_ps(_mm_loadu_ps(b1 + i), _mm_mul_ps(r1, rhs)));
+				_mm_storeu_ps(b2 + i, _mm_add_ps(_mm_loadu_ps(b2 + i), _mm_mul_ps(r2, rhs)));
+			}
+		}
+#endif
+		for (; i < n; ++i)
+		{
+			const float coords[2] = { points[i].x, points[i].y };
+			for (int row = 0; row < 2; ++row)
+			{
+				const float c = coords[row];
+				const float* q = p + row * 4;
+				float r0 = c * p[8] - q[0];
+				float r1 = c * p[9] - q[1];
+				float r2 = c * p[10] - q[2];
+				float rhs = q[3] - c * p[11];
+				float scale = 1.0f / std::sqrt(r0 * r0 + r1 * r1 + r2 * r2 + 1e-20f);
+				r0 *= scale;
+				r1 *= scale;
+				r2 *= scale;
+				rhs *= scale;
+				a00[i] += r0 * r0;
+				a01[i] += r0 * r1;
+				a02[i] += r0 * r2;
+				a11[i] += r1 * r1;
+				a12[i] += r1 * r2;
+				a22[i] += r2 * r2;
+				b0[i] += r0 * rhs;
+				b1[i] += r1 * rhs;
+				b2[i] += r2 * rhs;
+			}
+		}
+	}
+
+	float* xs = m_X.data();
+	float* ys = m_Y.data();
+	float* zs = m_Z.data();
+	const float nan = std::numeric_limits<float>::quiet_NaN();
+	if (viewsSeen < 2)
+	{
+		std::fill(m_X.begin(), m_X.end(), nan);
+		std::fill(m_Y.begin(), m_Y.end(), nan);
+		std::fill(m_Z.begin(), m_Z.end(), nan);
+		m_ReprojectionError = 0.0;
+		return 0;
+	}
+
+	// solve every 3x3 system with its adjugate; parallel rays leave the determinant near zero
+	int triangulated = 0;
+	int i = 0;
+#if defined(MULTI_VIEW_SSE)
+	const __m128 nanv = _mm_set1_ps(nan);
+	const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+	for (; i + 4 <= n; i += 4)
+	{
+		__m128 m00 = _mm_loadu_ps(a00 + i);
+		__m128 m01 = _mm_loadu_ps(a01 + i);
+		__m128 m02 = _mm_loadu_ps(a02 + i);
+		__m128 m11 = _mm_loadu_ps(a11 + i);
+		__m128 m12 = _mm_loadu_ps(a12 + i);
+		__m128 m22 = _mm_loadu_ps(a22 + i);
+		__m128 v0 = _mm_loadu_ps(b0 + i);
+		__m128 v1 = _mm_loadu_ps(b1 + i);
+		__m128 v2 = _mm_loadu_ps(b2 + i);
+		__m128 c00 = _mm_sub_ps(_mm_mul_ps(m11, m22), _mm_mul_ps(m12, m12));
+		__m128 c01 = _mm_sub_ps(_mm_mul_ps(m02, m12), _mm_mul_ps(m01, m22));
+		__m128 c02 = _mm_sub_ps(_mm_mul_ps(m01, m12), _mm_mul_ps(m02, m11));
+		__m128 c11 = _mm_sub_ps(_mm_mul_ps(m00, m22), _mm_mul_ps(m02, m02));
+		__m128 c12 = _mm_sub_ps(_mm_mul_ps(m01, m02), _mm_mul_ps(m00, m12));
+		__m128 c22 = _mm_sub_ps(_mm_mul_ps(m00, m11), _mm_mul_ps(m01, m01));
+		__m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, c00), _mm_mul_ps(m01, c01)), _mm_mul_ps(m02, c02));
+		__m128 solvable = _mm_cmpgt_ps(_mm_and_ps(det, absMask), _mm_set1_ps(1e-9f));
+		__m128 inv = _mm_and_ps(solvable, _mm_div_ps(_mm_set1_ps(1.0f), det));
+		__m128 x = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(c00, v0), _mm_mul_ps(c01, v1)), _mm_mul_ps(c02, v2)), inv);
+		__m128 y = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(c01, v0), _mm_mul_ps(c11, v1)), _mm_mul_ps(c12, v2)), inv);
+		__m128 z = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(c02, v0), _mm_mul_ps(c12, v1)), _mm_mul_ps(c22, v2)), inv);
+		_mm_storeu_ps(xs + i, _mm_or_ps(_mm_and_ps(solvable, x), _mm_andnot_ps(solvable, nanv)));
+		_mm_storeu_ps(ys + i, _mm_or_ps(_mm_and_ps(solvable, y), _mm_andnot_ps(solvable, nanv)));
+		_mm_storeu_ps(zs + i, _mm_or_ps(_mm_and_ps(solvable, z), _mm_andnot_ps(solvable, nanv)));
+		int lanes = _mm_movemask_ps(solvable);
+		triangulated += (lanes & 1) + ((lanes >> 1) & 1) + ((lanes >> 2) & 1) + ((lanes >> 3) & 1);
+	}
+#endif
+	for (; i < n; ++i)
+	{
+		const float c00 = a11[i] * a22[i] - a12[i] * a12[i];
+		const float c01 = a02[i] * a12[i] - a01[i] * a22[i];
+		const float c02 = a01[i] * a12[i] - a02[i] * a11[i];
+		const float c11 = a00[i] * a22[i] - a02[i] * a02[i];
+		const float c12 = a01[i] * a02[i] - a00[i] * a12[i];
+		const float c22 = a00[i] * a11[i] - a01[i] * a01[i];
+		const float det = a00[i] * c00 + a01[i] * c01 + a02[i] * c02;
+		const bool isSolvable = std::fabs(det) > 1e-9f;
+		const float inv = isSolvable ? 1.0f / det : 0.0f;
+		xs[i] = isSolvable ? (c00 * b0[i] + c01 * b1[i] + c02 * b2[i]) * inv : nan;
+		ys[i] = isSolvable ? (c01 * b0[i] + c11 * b1[i] + c12 * b2[i]) * inv : nan;
+		zs[i] = isSolvable ? (c02 * b0[i] + c12 * b1[i] + c22 * b2[i]) * inv : nan;
+		triangulated += isSolvable ? 1 : 0;
+	}
+
+	double errorSum = 0.0;
+	int errorCount = 0;
+	for (int v = 0; v < views; ++v)
+	{
+		const PoseInfo* points = view_landmarks[v];
+		if (points == nullptr)
+		{
+			continue;
+		}
+		const double* p = m_Cameras[v].m_Projection;
+		for (int i = 0; i < n; ++i)
+		{
+			if (std::isnan(xs[i]))
+			{
+				continue;
+			}
+			double w = p[8] * xs[i] + p[9] * ys[i] + p[10] * zs[i] + p[11];
+			if (w <= 0.0)
+			{
+				continue;
+			}
+			double u = (p[0] * xs[i] + p[1] * ys[i] + p[2] * zs[i] + p[3]) / w;
+			double t = (p[4] * xs[i] + p[5] * ys[i] + p[6] * zs[i] + p[7]) / w;
+			errorSum += std::sqrt((u - points[i].x) * (u - points[i].x) + (t - points[i].y) * (t - points[i].y));
+			++errorCount;
+		}
+	}
+	m_ReprojectionError = errorCount > 0 ? errorSum / errorCount : 0.0;
+	return triangulated;
+}
+
+double MultiViewTriangulator::GetReprojectionError()
+{
+	return m_ReprojectionError;
+}
+
+void MultiViewTriangulator::GetPoints(float* xyz_out)
+{
+	for (int i = 0; i < m_LandmarkCount; ++i)
+	{
+		xyz_out[i * 3 + 0] = m_X[i];
+		xyz_out[i * 3 + 1] = m_Y[i];
+		xyz_out[i * 3 + 2] = m_Z[i];
+	}
+}
+
+const std::vector<float>& MultiViewTriangulator::GetX()
+{
+	return m_X;
+}
+
+const std::vector<float>& MultiViewTriangulator::GetY()
+{
+	return m_Y;
+}
+
+const std::vector<float>& MultiViewTriangulator::GetZ()
+{
+	return m_Z;
+}
+
+ViewRoi MultiViewTriangulator::ProjectRoi(int view, float margin)
+{
+	ViewRoi roi;
+	if (view < 0 || view >= (int)m_Cameras.size())
+	{
+		return roi;
+	}
+
+	const CameraCalibration& camera = m_Cameras[view];
+	const double* p = camera.m_Projection;
+	double minX = 0.0;
+	double minY = 0.0;
+	double maxX = 0.0;
+	double maxY = 0.0;
+	int projected = 0;
+	for (int i = 0; i < m_LandmarkCount; ++i)
+	{
+		if (std::isnan(m_X[i]))
+		{
+			continue;
+		}
+		double w = p[8] * m_X[i] + p[9] * m_Y[i] + p[10] * m_Z[i] + p[11];
+		if (w <= 0.0)
+		{
+			continue;
+		}
+		double u = (p[0] * m_X[i] + p[1] * m_Y[i] + p[2] * m_Z[i] + p[3]) / w;
+		double t = (p[4] * m_X[i] + p[5] * m_Y[i] + p[6] * m_Z[i] + p[7]) / w;
+		minX = projected == 0 ? u : std::min(minX, u);
+		minY = projected == 0 ? t : std::min(minY, t);
+		maxX = projected == 0 ? u : std::max(maxX, u);
+		maxY = projected == 0 ? t : std::max(maxY, t);
+		++projected;
+	}
+	if (projected < 2)
+	{
+		return roi;
+	}
+
+	// square box like the graph's own hand ROI, so the crop keeps the hand's aspect
+	double size = std::max(maxX - minX, maxY - minY) * (1.0 + 2.0 * margin);
+	double centerX = (minX + maxX) * 0.5;
+	double centerY = (minY + maxY) * 0.5;
+	int left = std::max(0, (int)std::floor(centerX - size * 0.5));
+	int top = std::max(0, (int)std::floor(centerY - size * 0.5));
+	int right = std::min(camera.m_Image_Width, (int)std::ceil(centerX + size * 0.5));
+	int bottom = std::min(camera.m_Image_Height, (int)std::ceil(centerY + size * 0.5));
+	if (right - left < 2 || bottom - top < 2)
+	{
+		return roi;
+	}
+
+	roi.m_X = left;
+	roi.m_Y = top;
+	roi.m_Width = right - left;
+	roi.m_Height = bottom - top;
+	roi.m_Is_Valid = true;
+	return roi;
+}
+
+void MultiViewTriangulator::OffsetLandmarks(PoseInfo* landmarks, int count, const ViewRoi& roi)
+{
+	for (int i = 0; i < count; ++i)
+	{
+		landmarks[i].x += (float)roi.m_X;
+		landmarks[i].y += (float)roi.m_Y;
+	}
+}
+
+int MultiViewTriangulator::GetViewCount()
+{
+	return (int)m_Cameras.size();
+}
+
+int MultiViewTriangulator::GetLandmarkCount()
+{
+	return m_LandmarkCount;
+}
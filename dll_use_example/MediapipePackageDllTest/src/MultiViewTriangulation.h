@@ -0,0 +1,92 @@
+#ifndef MULTI_VIEW_TRIANGULATION_H
+#define MULTI_VIEW_TRIANGULATION_H
+
+#include <vector>
+
+#include "MediapipeHandTrackingDll.h"
+
+//!
+//! @brief - Triangulates landmarks seen by calibrated cameras and projects them back as ROIs
+//!
+//! Every camera is described by its 3x4 projection matrix P = K [R | t] in pixels, all
+//! in one world frame. Triangulate() takes the landmarks each view reported (same
+//! landmark order in every view, nullptr for a view that saw nothing) and solves the
+//! linear least-squares point for every landmark once at least two views reported. The
+//! normal equations are kept in one float array per coefficient and accumulated and
+//! solved four landmarks at a time with SSE2 where the target has it.
+//!
+//! ProjectRoi() projects the last triangulated points into a view and returns the
+//! padded bounding box. The caller crops that view to the box before handing it to
+//! its tracker and moves the landmarks back with OffsetLandmarks(), so the secondary
+//! views only run on the region where the hand already is, as seen by the primary view
+//! the frame before.
+//!
+
+struct CameraCalibration
+{
+	double m_Projection[12] = { 0 };	// row-major 3x4, pixel coordinates
+	int m_Image_Width = 0;
+	int m_Image_Height = 0;
+};
+
+struct ViewRoi
+{
+	int m_X = 0;
+	int m_Y = 0;
+	int m_Width = 0;
+	int m_Height = 0;
+	bool m_Is_Valid = false;
+};
+
+class MultiViewTriangulator
+{
+public:
+	MultiViewTriangulator(const std::vector<CameraCalibration>& cameras, int landmark_count = 21);
+	virtual~MultiViewTriangulator();
+
+public:
+	// view_landmarks[v] holds landmark_count points of camera v, or nullptr.
+	// Returns the number of landmarks triangulated; the others are left NaN.
+	int Triangulate(const std::vector<const PoseInfo*>& view_landmarks);
+
+	// Mean distance in pixels between the reported landmarks and the reprojected points of the last Triangulate
+	double GetReprojectionError();
+
+	// xyz_out holds landmark_count * 3 floats, NaN for landmarks that were not triangulated
+	void GetPoints(float* xyz_out);
+	const std::vector<float>& GetX();
+	const std::vector<float>& GetY();
+	const std::vector<float>& GetZ();
+
+	// Bounding box of the last points projected into view, grown by margin (0.25 = a quarter of the box per side)
+	// and clamped to the image; invalid when fewer than two points land in front of the camera
+	ViewRoi ProjectRoi(int view, float margin = 0.25f);
+
+	// Moves landmarks found in a crop back to the coordinates of the full view
+	static void OffsetLandmarks(PoseInfo* landmarks, int count, const ViewRoi& roi);
+
+	int GetViewCount();
+	int GetLandmarkCount();
+
+private:
+	std::vector<CameraCalibration> m_Cameras;
+	int m_LandmarkCount;
+	double m_ReprojectionError;
+
+	std::vector<float> m_X;
+	std::vector<float> m_Y;
+	std::vector<float> m_Z;
+
+	// normal equations per landmark: symmetric 3x3 (upper triangle) and the right-hand side
+	std::vector<float> m_A00;
+	std::vector<float> m_A01;
+	std::vector<float> m_A02;
+	std::vector<float> m_A11;
+	std::vector<float> m_A12;
+	std::vector<float> m_A22;
+	std::vector<float> m_B0;
+	std::vector<float> m_B1;
+	std::vector<float> m_B2;
+};
+
+#endif // !MULTI_VIEW_TRIANGULATION_H
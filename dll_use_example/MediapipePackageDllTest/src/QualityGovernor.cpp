@@ -0,0 +1,266 @@
+#include "QualityGovernor.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
+// platform selection and Windows.h
+#include "DynamicModuleLoader.h"
+
+#if defined(WINDOWS)
+#include <powerbase.h>
+#pragma comment(lib, "powrprof.lib")
+#endif
+
+namespace
+{
+#if defined(WINDOWS)
+	// winnt.h documents the struct but no header declares it
+	struct ProcessorPowerInformation
+	{
+		ULONG m_Number;
+		ULONG m_Max_Mhz;
+		ULONG m_Current_Mhz;
+		ULONG m_Mhz_Limit;
+		ULONG m_Max_Idle_State;
+		ULONG m_Current_Idle_State;
+	};
+#elif defined(LINUX)
+	bool ReadLongLong(const std::string& path, long long& value)
+	{
+		FILE* file = std::fopen(path.c_str(), "r");
+		if (file == nullptr)
+		{
+			return false;
+		}
+		int fields = std::fscanf(file, "%lld", &value);
+		std::fclose(file);
+		return fields == 1;
+	}
+#endif
+}
+
+QualityGovernor::QualityGovernor(const QualityGovernorOptions& options)
+	: m_Options(options)
+	, m_QuietWindows(0)
+	, m_CooldownWindows(0)
+	, m_WindowsSinceUp(-1)
+	, m_PreviousLevel(-1)
+	, m_PreviousP90Ms(0.0)
+{
+	if (m_Options.m_Ladder.empty())
+	{
+		m_Options.m_Ladder = DefaultLadder();
+	}
+	m_Options.m_Target_Fps = std::max(1.0, m_Options.m_Target_Fps);
+	m_Options.m_Window_Frames = std::max(1, m_Options.m_Window_Frames);
+	m_Options.m_Up_Windows = std::max(1, m_Options.m_Up_Windows);
+	m_Options.m_Max_Up_Windows = std::max(m_Options.m_Up_Windows, m_Options.m_Max_Up_Windows);
+	m_Window.reserve(m_Options.m_Window_Frames);
+	Reset();
+}
+
+QualityGovernor::~QualityGovernor()
+{
+}
+
+bool QualityGovernor::ReportFrame(double frame_ms)
+{
+	m_Window.push_back(frame_ms);
+	if ((int)m_Window.size() < m_Options.m_Window_Frames)
+	{
+		return false;
+	}
+
+	int level = m_State.m_Level;
+	EvaluateWindow();
+	m_Window.clear();
+	return m_State.m_Level != level;
+}
+
+const QualityLevel& QualityGovernor::GetQuality()
+{
+	return m_Options.m_Ladder[m_State.m_Level];
+}
+
+QualityGovernorState QualityGovernor::GetState()
+{
+	return m_State;
+}
+
+void QualityGovernor::Reset()
+{
+	m_State = QualityGovernorState();
+	m_State.m_Budget_Ms = 1000.0 / m_Options.m_Target_Fps;
+	m_Window.clear();
+	m_UpWindowsNeeded.assign(m_Options.m_Ladder.size(), m_Options.m_Up_Windows);
+	m_StepCostRatios.assign(m_Options.m_Ladder.size(), 0.0);
+	m_PreviousLevel = -1;
+	m_PreviousP90Ms = 0.0;
+	m_QuietWindows = 0;
+	m_CooldownWindows = 0;
+	m_WindowsSinceUp = -1;
+}
+
+std::vector<QualityLevel> QualityGovernor::DefaultLadder()
+{
+	std::vector<QualityLevel> ladder;
+	QualityLevel level;
+	ladder.push_back(level);
+	level.m_Face_Every_N_Frames = 2;
+	ladder.push_back(level);
+	level.m_Face_Every_N_Frames = 4;
+	ladder.push_back(level);
+	level.m_Pose_Model_Complexity = 0;
+	ladder.push_back(level);
+	level.m_Palm_Cadence = 2;
+	ladder.push_back(level);
+	level.m_Palm_Cadence = 3;
+	ladder.push_back(level);
+	level.m_Input_Downscale = 2;
+	ladder.push_back(level);
+	return ladder;
+}
+
+void QualityGovernor::ReadThermalState(double& temperature_c, double& clock_ratio)
+{
+	temperature_c = -1.0;
+	clock_ratio = -1.0;
+#if defined(WINDOWS)
+	SYSTEM_INFO systemInfo;
+	GetSystemInfo(&systemInfo);
+	std::vector<ProcessorPowerInformation> processors(systemInfo.dwNumberOfProcessors);
+	if (CallNtPowerInformation(ProcessorInformation, nullptr, 0, processors.data(), (ULONG)(processors.size() * sizeof(ProcessorPowerInformation))) == 0)
+	{
+		double ratioSum = 0.0;
+		int counted = 0;
+		for (const ProcessorPowerInformation& processor : processors)
+		{
+			if (processor.m_Max_Mhz > 0)
+			{
+				ratioSum += (double)processor.m_Current_Mhz / (double)processor.m_Max_Mhz;
+				++counted;
+			}
+		}
+		if (counted > 0)
+		{
+			clock_ratio = ratioSum / counted;
+		}
+	}
+#elif defined(LINUX)
+	long long value = 0;
+	for (int zone = 0; zone < 32; ++zone)
+	{
+		if (!ReadLongLong("/sys/class/thermal/thermal_zone" + std::to_string(zone) + "/temp", value))
+		{
+			break;
+		}
+		// millidegrees
+		temperature_c = std::max(temperature_c, value / 1000.0);
+	}
+
+	double ratioSum = 0.0;
+	int counted = 0;
+	for (int cpu = 0; cpu < 256; ++cpu)
+	{
+		std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq/";
+		long long current = 0;
+		long long maximum = 0;
+		if (!ReadLongLong(base + "scaling_cur_freq", current) || !ReadLongLong(base + "cpuinfo_max_freq", maximum))
+		{
+			break;
+		}
+		if (maximum > 0)
+		{
+			ratioSum += (double)current / (double)maximum;
+			++counted;
+		}
+	}
+	if (counted > 0)
+	{
+		clock_ratio = ratioSum / counted;
+	}
+#endif
+}
+
+void QualityGovernor::EvaluateWindow()
+{
+	std::vector<double>& window = m_Window;
+	size_t p90 = std::min(window.size() - 1, (size_t)(0.9 * (double)(window.size() - 1) + 0.5));
+	std::nth_element(window.begin(), window.begin() + p90, window.end());
+	m_State.m_Window_P90_Ms = window[p90];
+
+	// adjacent windows on two neighbouring levels give their cost ratio under the same conditions
+	if (m_PreviousLevel >= 0 && (m_PreviousLevel == m_State.m_Level + 1 || m_PreviousLevel + 1 == m_State.m_Level) && m_State.m_Window_P90_Ms > 0.0 && m_PreviousP90Ms > 0.0)
+	{
+		bool isPreviousUpper = m_PreviousLevel < m_State.m_Level;
+		double upperMs = isPreviousUpper ? m_PreviousP90Ms : m_State.m_Window_P90_Ms;
+		double lowerMs = isPreviousUpper ? m_State.m_Window_P90_Ms : m_PreviousP90Ms;
+		m_StepCostRatios[std::min(m_PreviousLevel, m_State.m_Level)] = upperMs / lowerMs;
+	}
+	m_PreviousLevel = m_State.m_Level;
+	m_PreviousP90Ms = m_State.m_Window_P90_Ms;
+
+	if (m_Options.m_Is_Thermal_Sampling)
+	{
+		ReadThermalState(m_State.m_Temperature_C, m_State.m_Clock_Ratio);
+	}
+	m_State.m_Is_Throttled = (m_State.m_Temperature_C >= m_Options.m_Throttle_Temperature_C)
+		|| (m_State.m_Clock_Ratio >= 0.0 && m_State.m_Clock_Ratio < m_Options.m_Throttle_Clock_Ratio);
+
+	if (m_WindowsSinceUp >= 0)
+	{
+		++m_WindowsSinceUp;
+	}
+	if (m_CooldownWindows > 0)
+	{
+		--m_CooldownWindows;
+		return;
+	}
+
+	const double budget = m_State.m_Budget_Ms;
+	const int lowest = (int)m_Options.m_Ladder.size() - 1;
+	bool isOverBudget = m_State.m_Window_P90_Ms > budget * (1.0 + m_Options.m_Down_Margin);
+	// a throttled CPU keeps slowing down; leave before the budget is gone
+	bool isThrottledNearBudget = m_State.m_Is_Throttled && m_State.m_Window_P90_Ms > budget * 0.9;
+	if ((isOverBudget || isThrottledNearBudget) && m_State.m_Level < lowest)
+	{
+		// stepping up did not hold: the level above needs longer next time
+		if (m_WindowsSinceUp >= 0 && m_WindowsSinceUp <= m_UpWindowsNeeded[m_State.m_Level])
+		{
+			int& needed = m_UpWindowsNeeded[m_State.m_Level];
+			needed = std::min(m_Options.m_Max_Up_Windows, needed * 2);
+		}
+		ChangeLevel(m_State.m_Level + 1);
+		m_State.m_Steps_Down += 1;
+		m_WindowsSinceUp = -1;
+		return;
+	}
+
+	if (m_State.m_Level == 0)
+	{
+		return;
+	}
+	const double ratio = m_StepCostRatios[m_State.m_Level - 1];
+	bool hasHeadroom = ratio > 0.0
+		? m_State.m_Window_P90_Ms * ratio < budget * (1.0 - m_Options.m_Down_Margin)
+		: m_State.m_Window_P90_Ms < budget * m_Options.m_Up_Headroom;
+	if (!hasHeadroom || m_State.m_Is_Throttled)
+	{
+		m_QuietWindows = 0;
+		return;
+	}
+	if (++m_QuietWindows >= m_UpWindowsNeeded[m_State.m_Level - 1])
+	{
+		ChangeLevel(m_State.m_Level - 1);
+		m_State.m_Steps_Up += 1;
+		m_WindowsSinceUp = 0;
+	}
+}
+
+void QualityGovernor::ChangeLevel(int level)
+{
+	m_State.m_Level = level;
+	m_QuietWindows = 0;
+	m_CooldownWindows = m_Options.m_Cooldown_Windows;
+}
@@ -0,0 +1,101 @@
+#ifndef QUALITY_GOVERNOR_H
+#define QUALITY_GOVERNOR_H
+
+#include <vector>
+
+//!
+//! @brief - Steps tracking quality down and up a ladder to hold a target frame rate
+//!
+//! The caller reports how long every frame took; once per window of frames the
+//! governor compares the window's 90th percentile with the frame budget of the target
+//! fps, and reads the CPU temperature and clock where the OS exposes them
+//! (/sys/class/thermal and cpufreq on Linux, the processor clock through
+//! CallNtPowerInformation on Windows).
+//!
+//! Over budget it steps one level down at once. It steps back up only after
+//! m_Up_Windows windows in a row in which the level above is predicted to fit the
+//! budget and the CPU is not throttled. The prediction scales the current p90 by the
+//! cost ratio of the two levels, taken from the windows on either side of the last
+//! change between them, so it holds whether the machine is throttled or not. A level
+//! that had to be left again soon after stepping up needs twice as many quiet windows
+//! the next time, so a load that sits between two levels settles instead of
+//! oscillating. While the CPU is throttled it also steps down
+//! before the budget is hit, since the clock usually keeps falling.
+//!
+//! The ladder defaults to the order that costs the least tracking quality first: face
+//! mesh rate, pose model complexity, palm detection cadence, input resolution. The
+//! governor only picks the level; the caller applies whichever of its fields the
+//! pipeline supports (e.g. cadence in the capture loop, m_Input_Downscale through
+//! MediapipeHandTrackingGestureOnly, model complexity by switching graphs).
+//!
+
+struct QualityLevel
+{
+	int m_Face_Every_N_Frames = 1;		// run the face mesh on every Nth frame
+	int m_Pose_Model_Complexity = 1;	// 0 lite, 1 full, 2 heavy
+	int m_Palm_Cadence = 1;				// run palm detection on every Nth frame
+	int m_Input_Downscale = 1;			// integer factor applied to the frame before the DLL
+};
+
+struct QualityGovernorOptions
+{
+	double m_Target_Fps = 30.0;
+	int m_Window_Frames = 30;
+	double m_Down_Margin = 0.05;		// step down above budget * (1 + margin)
+	double m_Up_Headroom = 0.70;		// step up below budget * headroom while the level above was never measured
+	int m_Up_Windows = 5;				// quiet windows before a step up
+	int m_Max_Up_Windows = 80;			// cap of the doubling after an oscillation
+	int m_Cooldown_Windows = 2;			// windows ignored after any change
+	double m_Throttle_Temperature_C = 85.0;
+	double m_Throttle_Clock_Ratio = 0.75;	// current / maximum CPU clock
+	bool m_Is_Thermal_Sampling = true;
+	std::vector<QualityLevel> m_Ladder;	// empty: DefaultLadder()
+};
+
+struct QualityGovernorState
+{
+	int m_Level = 0;					// index into the ladder, 0 is full quality
+	double m_Window_P90_Ms = 0.0;
+	double m_Budget_Ms = 0.0;
+	double m_Temperature_C = -1.0;		// -1 when the OS does not expose it
+	double m_Clock_Ratio = -1.0;		// -1 when the OS does not expose it
+	bool m_Is_Throttled = false;
+	unsigned long long m_Steps_Down = 0;
+	unsigned long long m_Steps_Up = 0;
+};
+
+class QualityGovernor
+{
+public:
+	QualityGovernor(const QualityGovernorOptions& options = QualityGovernorOptions());
+	virtual~QualityGovernor();
+
+public:
+	// frame_ms: time the frame held the pipeline (capture to result); true when the level changed
+	bool ReportFrame(double frame_ms);
+	const QualityLevel& GetQuality();
+	QualityGovernorState GetState();
+	void Reset();
+
+	static std::vector<QualityLevel> DefaultLadder();
+	// Hottest thermal zone in degrees C and the mean current / maximum CPU clock, -1 where unknown
+	static void ReadThermalState(double& temperature_c, double& clock_ratio);
+
+private:
+	void EvaluateWindow();
+	void ChangeLevel(int level);
+
+private:
+	QualityGovernorOptions m_Options;
+	QualityGovernorState m_State;
+	std::vector<double> m_Window;
+	std::vector<int> m_UpWindowsNeeded;		// per level, doubled after an oscillation
+	std::vector<double> m_StepCostRatios;	// p90 at level i over p90 at level i + 1, 0 if never measured
+	int m_QuietWindows;
+	int m_CooldownWindows;
+	int m_WindowsSinceUp;					// -1 when the last change was not a step up
+	int m_PreviousLevel;					// level of the previous window, -1 before the first
+	double m_PreviousP90Ms;
+};
+
+#endif // !QUALITY_GOVERNOR_H
@@ -0,0 +1,201 @@
+#ifndef RESULT_REORDER_BUFFER_H
+#define RESULT_REORDER_BUFFER_H
+
+#include <vector>
+#include <chrono>
+#include <cstddef>
+
+//!
+//! @brief - Releases results strictly in image_index order, with a bounded wait for gaps
+//!
+//! Results pushed out of order are held until every smaller index has been released,
+//! skipped (the producer knows it will never complete), or given up on. A gap is given
+//! up on when window results are held or one of them has waited max_delay; results
+//! that arrive for an index already passed are discarded and counted as late. Indices
+//! are expected to be consecutive; the very first release waits for the window or the
+//! delay since the starting index is not known.
+//!
+//! Skips are kept apart from the window so a burst of dropped frames does not push out
+//! held results; when skip storage is full a skip is forgotten, which only costs the
+//! delay. Storage is allocated once; the window is small, so lookups are linear scans.
+//! Not thread-safe, the owner serializes access.
+//!
+template <typename T>
+class ResultReorderBuffer
+{
+public:
+	typedef std::chrono::steady_clock::time_point TimePoint;
+
+	ResultReorderBuffer(size_t window = 8, std::chrono::microseconds max_delay = std::chrono::milliseconds(50))
+	{
+		Reset(window, max_delay);
+	}
+
+	void Reset(size_t window, std::chrono::microseconds max_delay)
+	{
+		m_Entries.assign(window > 0 ? window : 1, Entry());
+		m_Skips.assign(m_Entries.size() * 4, 0);
+		m_SkipCount = 0;
+		m_MaxDelay = max_delay;
+		m_Count = 0;
+		m_NextIndex = 0;
+		m_HasNext = false;
+		m_LateCount = 0;
+	}
+
+	// false if the index was already passed; the value is discarded. Call Pop until it
+	// returns false before the next Push so there is always room.
+	bool Push(int index, const T& value, TimePoint now)
+	{
+		if ((m_HasNext && index < m_NextIndex) || m_Count == m_Entries.size())
+		{
+			++m_LateCount;
+			return false;
+		}
+		Entry& entry = FreeEntry();
+		entry.m_Index = index;
+		entry.m_Arrival = now;
+		entry.m_Value = value;
+		return true;
+	}
+
+	// index will never be pushed (e.g. the frame was dropped); later results need not wait for it
+	void Skip(int index)
+	{
+		if ((m_HasNext && index < m_NextIndex) || m_SkipCount == m_Skips.size())
+		{
+			return;
+		}
+		m_Skips[m_SkipCount++] = index;
+	}
+
+	// force releases everything held regardless of gaps, e.g. at shutdown
+	bool Pop(T& value, TimePoint now, bool force = false)
+	{
+		if (m_Count == 0)
+		{
+			return false;
+		}
+		Entry* smallest = nullptr;
+		bool isExpired = false;
+		for (size_t i = 0; i < m_Entries.size(); ++i)
+		{
+			Entry& entry = m_Entries[i];
+			if (!entry.m_Is_Used)
+			{
+				continue;
+			}
+			if (smallest == nullptr || entry.m_Index < smallest->m_Index)
+			{
+				smallest = &entry;
+			}
+			isExpired = isExpired || now - entry.m_Arrival >= m_MaxDelay;
+		}
+
+		// step over skipped indices in front of the smallest held result
+		while (m_HasNext && m_NextIndex < smallest->m_Index && RemoveSkip(m_NextIndex))
+		{
+			++m_NextIndex;
+		}
+		bool isNext = m_HasNext && smallest->m_Index == m_NextIndex;
+		if (!isNext && !force && !isExpired && m_Count < m_Entries.size())
+		{
+			return false;
+		}
+
+		smallest->m_Is_Used = false;
+		--m_Count;
+		m_NextIndex = smallest->m_Index + 1;
+		m_HasNext = true;
+		PruneSkips();
+		value = smallest->m_Value;
+		return true;
+	}
+
+	// when the oldest held result times out; false if none is held
+	bool GetNextDeadline(TimePoint& deadline) const
+	{
+		bool hasDeadline = false;
+		for (size_t i = 0; i < m_Entries.size(); ++i)
+		{
+			const Entry& entry = m_Entries[i];
+			if (entry.m_Is_Used && (!hasDeadline || entry.m_Arrival + m_MaxDelay < deadline))
+			{
+				deadline = entry.m_Arrival + m_MaxDelay;
+				hasDeadline = true;
+			}
+		}
+		return hasDeadline;
+	}
+
+	unsigned long long GetLateCount() const
+	{
+		return m_LateCount;
+	}
+
+private:
+	struct Entry
+	{
+		bool m_Is_Used = false;
+		int m_Index = 0;
+		TimePoint m_Arrival;
+		T m_Value = T();
+	};
+
+	Entry& FreeEntry()
+	{
+		for (size_t i = 0; i < m_Entries.size(); ++i)
+		{
+			if (!m_Entries[i].m_Is_Used)
+			{
+				m_Entries[i].m_Is_Used = true;
+				++m_Count;
+				return m_Entries[i];
+			}
+		}
+		// callers check m_Count first
+		return m_Entries[0];
+	}
+
+	bool RemoveSkip(int index)
+	{
+		for (size_t i = 0; i < m_SkipCount; ++i)
+		{
+			if (m_Skips[i] == index)
+			{
+				m_Skips[i] = m_Skips[--m_SkipCount];
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// skips behind the next index are no longer needed
+	void PruneSkips()
+	{
+		size_t i = 0;
+		while (i < m_SkipCount)
+		{
+			if (m_Skips[i] < m_NextIndex)
+			{
+				m_Skips[i] = m_Skips[--m_SkipCount];
+			}
+			else
+			{
+				++i;
+			}
+		}
+	}
+
+private:
+	std::vector<Entry> m_Entries;
+	std::chrono::microseconds m_MaxDelay;
+	size_t m_Count;
+	std::vector<int> m_Skips;
+	size_t m_SkipCount;
+	int m_NextIndex;
+	bool m_HasNext;
+	unsigned long long m_LateCount;
+};
+
+#endif // !RESULT_REORDER_BUFFER_H
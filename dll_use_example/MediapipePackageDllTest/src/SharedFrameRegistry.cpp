@@ -0,0 +1,168 @@
+#include "SharedFrameRegistry.h"
+
+#include <algorithm>
+#include <iterator>
+
+SharedFrameRegistry::SharedFrameRegistry(int capacity)
+	: m_Capacity(std::max(1, capacity))
+	, m_NewestIndex(-1)
+{
+}
+
+SharedFrameRegistry::~SharedFrameRegistry()
+{
+}
+
+SharedFrameRegistry& SharedFrameRegistry::Instance()
+{
+	static SharedFrameRegistry registry;
+	return registry;
+}
+
+std::shared_ptr<const SharedFrame> SharedFrameRegistry::GetOrCreate(int image_index, const std::string& key, const Producer& producer)
+{
+	EntryKey entryKey(image_index, key);
+	std::shared_ptr<Entry> entry;
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		for (;;)
+		{
+			auto it = m_Entries.find(entryKey);
+			if (it == m_Entries.end())
+			{
+				break;
+			}
+			entry = it->second;
+			if (!entry->m_Is_Producing)
+			{
+				++m_Stats.m_Hits;
+				return entry->m_Frame;
+			}
+			++m_Stats.m_Waits;
+			m_Produced.wait(lock, [&entry] { return !entry->m_Is_Producing; });
+			if (entry->m_Frame != nullptr)
+			{
+				return entry->m_Frame;
+			}
+			// the other caller's producer failed and removed the entry: look again
+		}
+		if (image_index > m_NewestIndex)
+		{
+			m_NewestIndex = image_index;
+			EvictLocked();
+		}
+		if (image_index <= m_NewestIndex - m_Capacity)
+		{
+			// already outside the window: produce for this caller only
+			lock.unlock();
+			std::shared_ptr<SharedFrame> frame = std::make_shared<SharedFrame>();
+			return producer(*frame) ? frame : nullptr;
+		}
+		entry = std::make_shared<Entry>();
+		entry->m_Is_Producing = true;
+		m_Entries[entryKey] = entry;
+		++m_Stats.m_Misses;
+	}
+
+	// the producer runs without the lock; waiters hold their own reference to entry
+	std::shared_ptr<SharedFrame> frame = std::make_shared<SharedFrame>();
+	bool isProduced = producer(*frame);
+
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		entry->m_Is_Producing = false;
+		if (isProduced)
+		{
+			entry->m_Frame = frame;
+		}
+		else if (entry->m_Frame == nullptr)
+		{
+			// keep a frame that was published meanwhile
+			auto it = m_Entries.find(entryKey);
+			if (it != m_Entries.end() && it->second == entry)
+			{
+				m_Entries.erase(it);
+			}
+		}
+	}
+	m_Produced.notify_all();
+	return isProduced ? frame : nullptr;
+}
+
+std::shared_ptr<const SharedFrame> SharedFrameRegistry::Find(int image_index, const std::string& key)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	auto it = m_Entries.find(EntryKey(image_index, key));
+	if (it == m_Entries.end() || it->second->m_Is_Producing)
+	{
+		return nullptr;
+	}
+	++m_Stats.m_Hits;
+	return it->second->m_Frame;
+}
+
+void SharedFrameRegistry::Publish(int image_index, const std::string& key, SharedFrame&& frame)
+{
+	std::shared_ptr<const SharedFrame> published = std::make_shared<SharedFrame>(std::move(frame));
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		if (image_index > m_NewestIndex)
+		{
+			m_NewestIndex = image_index;
+			EvictLocked();
+		}
+		if (image_index <= m_NewestIndex - m_Capacity)
+		{
+			return;
+		}
+		std::shared_ptr<Entry>& entry = m_Entries[EntryKey(image_index, key)];
+		if (entry == nullptr)
+		{
+			entry = std::make_shared<Entry>();
+		}
+		// callers waiting on a producer for this key take the published frame
+		entry->m_Frame = published;
+		entry->m_Is_Producing = false;
+	}
+	m_Produced.notify_all();
+}
+
+void SharedFrameRegistry::SetCapacity(int capacity)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_Capacity = std::max(1, capacity);
+	EvictLocked();
+}
+
+SharedFrameRegistryStats SharedFrameRegistry::GetStats()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	return m_Stats;
+}
+
+void SharedFrameRegistry::Clear()
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	for (auto it = m_Entries.begin(); it != m_Entries.end();)
+	{
+		// entries being produced stay until their producer finishes
+		it = it->second->m_Is_Producing ? std::next(it) : m_Entries.erase(it);
+	}
+	m_NewestIndex = -1;
+}
+
+void SharedFrameRegistry::EvictLocked()
+{
+	// keys sort by image_index first, so the stale entries are at the front
+	const int oldestKept = m_NewestIndex - m_Capacity + 1;
+	for (auto it = m_Entries.begin(); it != m_Entries.end() && it->first.first < oldestKept;)
+	{
+		if (it->second->m_Is_Producing)
+		{
+			++it;
+			continue;
+		}
+		it = m_Entries.erase(it);
+		++m_Stats.m_Evictions;
+	}
+}
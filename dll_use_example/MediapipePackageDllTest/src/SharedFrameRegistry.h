@@ -0,0 +1,96 @@
+#ifndef SHARED_FRAME_REGISTRY_H
+#define SHARED_FRAME_REGISTRY_H
+
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+//!
+//! @brief - Process-wide store of per-frame data shared by the hand and holistic pipelines
+//!
+//! When both DLLs are fed the same camera, every conversion done on this side (YUV to
+//! BGR, rotation, downscaling) and every result one pipeline already produced is
+//! computed once per image_index instead of once per DLL. Entries are keyed by
+//! (image_index, key); GetOrCreate() runs the producer only in the first caller and
+//! makes concurrent callers for the same entry wait for it, so two threads feeding
+//! the two DLLs never convert the same frame twice.
+//!
+//! Only the entries of the m_Capacity newest image indices are kept; older ones are
+//! dropped as new indices arrive. Entries are handed out as shared_ptr, so a frame
+//! still in use by a DLL call survives its eviction. Call Clear() when a new stream
+//! starts its image indices from 0 again.
+//!
+//! The detectors themselves run inside the DLLs, so detections can only be shared in
+//! the form the DLLs return them (the hand landmarks and gesture codes below).
+//!
+
+#define SHARED_FRAME_KEY_BGR "bgr"							// BGR frame as handed to the DLLs
+#define SHARED_FRAME_KEY_HAND_LANDMARKS "hand_landmarks"	// m_Values: x, y per landmark from the hand DLL
+#define SHARED_FRAME_KEY_GESTURE "gesture"					// m_Values: the two gesture codes from the hand DLL
+
+struct SharedFrame
+{
+	int m_Width = 0;
+	int m_Height = 0;
+	int m_Stride = 0;						// bytes per row of m_Data
+	std::vector<unsigned char> m_Data;		// image payload
+	std::vector<float> m_Values;			// non-image payload (landmarks, detections, codes)
+};
+
+struct SharedFrameRegistryStats
+{
+	unsigned long long m_Hits = 0;			// served from an existing entry
+	unsigned long long m_Misses = 0;		// the caller ran the producer
+	unsigned long long m_Waits = 0;			// waited for another caller's producer
+	unsigned long long m_Evictions = 0;
+};
+
+class SharedFrameRegistry
+{
+public:
+	SharedFrameRegistry(int capacity = 4);
+	virtual~SharedFrameRegistry();
+
+	// The instance shared by every pipeline in the process
+	static SharedFrameRegistry& Instance();
+
+public:
+	typedef std::function<bool(SharedFrame& frame)> Producer;
+
+	// Returns the entry, running producer when there is none; nullptr when the producer failed.
+	// A failed entry is not stored, so the next caller tries again.
+	std::shared_ptr<const SharedFrame> GetOrCreate(int image_index, const std::string& key, const Producer& producer);
+	// Returns the entry if it exists and is ready, without waiting
+	std::shared_ptr<const SharedFrame> Find(int image_index, const std::string& key);
+	// Stores a finished entry, replacing any ready entry with the same key
+	void Publish(int image_index, const std::string& key, SharedFrame&& frame);
+
+	void SetCapacity(int capacity);
+	SharedFrameRegistryStats GetStats();
+	void Clear();
+
+private:
+	struct Entry
+	{
+		std::shared_ptr<const SharedFrame> m_Frame;
+		bool m_Is_Producing = false;
+	};
+	typedef std::pair<int, std::string> EntryKey;
+
+	void EvictLocked();
+
+private:
+	std::mutex m_Mutex;
+	std::condition_variable m_Produced;
+	std::map<EntryKey, std::shared_ptr<Entry>> m_Entries;
+	int m_Capacity;
+	int m_NewestIndex;
+	SharedFrameRegistryStats m_Stats;
+};
+
+#endif // !SHARED_FRAME_REGISTRY_H
@@ -0,0 +1,280 @@
+#include "SkeletonOverlay.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+SkeletonOverlay::SkeletonOverlay(int joints_per_skeleton, const std::vector<std::vector<int>>& chains, const SkeletonOverlayStyle& style)
+	: m_JointsPerSkeleton(joints_per_skeleton > 0 ? joints_per_skeleton : 1)
+	, m_Chains(chains)
+	, m_Style(style)
+	, m_MinX(INT_MAX)
+	, m_MinY(INT_MAX)
+	, m_MaxX(INT_MIN)
+	, m_MaxY(INT_MIN)
+	, m_DiscRadius(-1)
+{
+	// drop indices outside the skeleton once, so the per-frame path never checks them
+	for (std::vector<int>& chain : m_Chains)
+	{
+		chain.erase(std::remove_if(chain.begin(), chain.end(), [this](int index) { return index < 0 || index >= m_JointsPerSkeleton; }), chain.end());
+	}
+}
+
+SkeletonOverlay::~SkeletonOverlay()
+{
+}
+
+SkeletonOverlay SkeletonOverlay::CreateHandOverlay(const SkeletonOverlayStyle& style)
+{
+	// same 21 bones DrawHandKeyponts used to draw one by one
+	std::vector<std::vector<int>> chains =
+	{
+		{ 0, 1, 2, 3, 4 },			// thumb
+		{ 0, 5, 6, 7, 8 },			// index
+		{ 9, 10, 11, 12 },			// middle
+		{ 13, 14, 15, 16 },			// ring
+		{ 0, 17, 18, 19, 20 },		// pinky
+		{ 5, 9, 13, 17 },			// palm
+	};
+	return SkeletonOverlay(21, chains, style);
+}
+
+void SkeletonOverlay::Begin()
+{
+	m_Joints.clear();
+	m_ChainPoints.clear();
+	m_ChainLengths.clear();
+	m_LineVertices.clear();
+	m_JointVertices.clear();
+	m_MinX = INT_MAX;
+	m_MinY = INT_MAX;
+	m_MaxX = INT_MIN;
+	m_MaxY = INT_MIN;
+}
+
+void SkeletonOverlay::AddSkeletons(const cv::Point* points, int count)
+{
+	if (points == nullptr)
+	{
+		return;
+	}
+	for (int offset = 0; offset + m_JointsPerSkeleton <= count; offset += m_JointsPerSkeleton)
+	{
+		AddSkeleton(points + offset);
+	}
+}
+
+void SkeletonOverlay::AddSkeletons(const PoseInfo* infos, int count)
+{
+	if (infos == nullptr || count <= 0)
+	{
+		return;
+	}
+	m_Scratch.resize(count);
+	for (int i = 0; i < count; ++i)
+	{
+		m_Scratch[i] = cv::Point((int)infos[i].x, (int)infos[i].y);
+	}
+	AddSkeletons(m_Scratch.data(), count);
+}
+
+void SkeletonOverlay::Draw(cv::Mat& image)
+{
+	if (IsEmpty() || image.empty())
+	{
+		return;
+	}
+	RenderBatch(image, cv::Point(0, 0), m_Style.m_Bone_Color, m_Style.m_Joint_Color);
+}
+
+bool SkeletonOverlay::DrawLayer(cv::Size frame_size, cv::Mat& layer, cv::Rect& roi)
+{
+	if (IsEmpty())
+	{
+		return false;
+	}
+	roi = GetBounds() & cv::Rect(0, 0, frame_size.width, frame_size.height);
+	if (roi.area() == 0)
+	{
+		return false;
+	}
+
+	// create() keeps the buffer while the ROI does not grow
+	layer.create(roi.size(), CV_8UC4);
+	layer.setTo(cv::Scalar(0, 0, 0, 0));
+	const cv::Scalar& bone = m_Style.m_Bone_Color;
+	const cv::Scalar& joint = m_Style.m_Joint_Color;
+	RenderBatch(layer, -roi.tl(), cv::Scalar(bone[0], bone[1], bone[2], 255), cv::Scalar(joint[0], joint[1], joint[2], 255));
+	return true;
+}
+
+bool SkeletonOverlay::IsEmpty()
+{
+	return m_Joints.empty();
+}
+
+cv::Rect SkeletonOverlay::GetBounds()
+{
+	if (IsEmpty())
+	{
+		return cv::Rect();
+	}
+	int pad = std::max(m_Style.m_Joint_Radius, m_Style.m_Bone_Thickness) + 1;
+	return cv::Rect(m_MinX - pad, m_MinY - pad, m_MaxX - m_MinX + 2 * pad + 1, m_MaxY - m_MinY + 2 * pad + 1);
+}
+
+const std::vector<float>& SkeletonOverlay::GetLineVertices()
+{
+	if (m_LineVertices.empty() && !m_ChainPoints.empty())
+	{
+		size_t start = 0;
+		for (int length : m_ChainLengths)
+		{
+			for (int i = 1; i < length; ++i)
+			{
+				const cv::Point& from = m_ChainPoints[start + i - 1];
+				const cv::Point& to = m_ChainPoints[start + i];
+				m_LineVertices.push_back((float)from.x);
+				m_LineVertices.push_back((float)from.y);
+				m_LineVertices.push_back((float)to.x);
+				m_LineVertices.push_back((float)to.y);
+			}
+			start += length;
+		}
+	}
+	return m_LineVertices;
+}
+
+const std::vector<float>& SkeletonOverlay::GetJointVertices()
+{
+	if (m_JointVertices.empty() && !m_Joints.empty())
+	{
+		m_JointVertices.reserve(m_Joints.size() * 2);
+		for (const cv::Point& joint : m_Joints)
+		{
+			m_JointVertices.push_back((float)joint.x);
+			m_JointVertices.push_back((float)joint.y);
+		}
+	}
+	return m_JointVertices;
+}
+
+SkeletonOverlayStyle& SkeletonOverlay::GetStyle()
+{
+	return m_Style;
+}
+
+void SkeletonOverlay::AddSkeleton(const cv::Point* points)
+{
+	for (int i = 0; i < m_JointsPerSkeleton; ++i)
+	{
+		const cv::Point& point = points[i];
+		m_Joints.push_back(point);
+		m_MinX = std::min(m_MinX, point.x);
+		m_MinY = std::min(m_MinY, point.y);
+		m_MaxX = std::max(m_MaxX, point.x);
+		m_MaxY = std::max(m_MaxY, point.y);
+	}
+	for (const std::vector<int>& chain : m_Chains)
+	{
+		for (int index : chain)
+		{
+			m_ChainPoints.push_back(points[index]);
+		}
+		m_ChainLengths.push_back((int)chain.size());
+	}
+}
+
+void SkeletonOverlay::RenderBatch(cv::Mat& image, cv::Point offset, const cv::Scalar& bone_color, const cv::Scalar& joint_color)
+{
+	const std::vector<cv::Point>* chainPoints = &m_ChainPoints;
+	if (offset != cv::Point(0, 0))
+	{
+		m_ShiftedPoints.resize(m_ChainPoints.size());
+		for (size_t i = 0; i < m_ChainPoints.size(); ++i)
+		{
+			m_ShiftedPoints[i] = m_ChainPoints[i] + offset;
+		}
+		chainPoints = &m_ShiftedPoints;
+	}
+
+	// pointers are rebuilt here because the point buffer may have grown since Begin()
+	m_ChainStarts.resize(m_ChainLengths.size());
+	size_t start = 0;
+	for (size_t i = 0; i < m_ChainLengths.size(); ++i)
+	{
+		m_ChainStarts[i] = chainPoints->data() + start;
+		start += m_ChainLengths[i];
+	}
+	// joints first, bones on top, as the example always drew them
+	if (m_Style.m_Joint_Radius > 0)
+	{
+		StampJoints(image, offset, joint_color);
+	}
+	if (m_Style.m_Bone_Thickness > 0 && !m_ChainStarts.empty())
+	{
+		cv::polylines(image, m_ChainStarts.data(), m_ChainLengths.data(), (int)m_ChainStarts.size(), false, bone_color, m_Style.m_Bone_Thickness, m_Style.m_Line_Type);
+	}
+}
+
+void SkeletonOverlay::StampJoints(cv::Mat& image, cv::Point offset, const cv::Scalar& color)
+{
+	int channels = image.channels();
+	if (image.depth() != CV_8U || (channels != 3 && channels != 4))
+	{
+		for (const cv::Point& joint : m_Joints)
+		{
+			cv::circle(image, joint + offset, m_Style.m_Joint_Radius, color, -1, m_Style.m_Line_Type);
+		}
+		return;
+	}
+
+	if (m_DiscRadius != m_Style.m_Joint_Radius)
+	{
+		BuildDisc();
+	}
+	unsigned char pixel[4];
+	for (int c = 0; c < 4; ++c)
+	{
+		pixel[c] = cv::saturate_cast<unsigned char>(color[c]);
+	}
+
+	int radius = m_DiscRadius;
+	for (const cv::Point& joint : m_Joints)
+	{
+		int centerX = joint.x + offset.x;
+		int centerY = joint.y + offset.y;
+		if (centerX + radius < 0 || centerX - radius >= image.cols || centerY + radius < 0 || centerY - radius >= image.rows)
+		{
+			continue;
+		}
+		int firstRow = std::max(-radius, -centerY);
+		int lastRow = std::min(radius, image.rows - 1 - centerY);
+		for (int dy = firstRow; dy <= lastRow; ++dy)
+		{
+			int halfWidth = m_DiscHalfWidths[dy + radius];
+			int fromX = std::max(centerX - halfWidth, 0);
+			int toX = std::min(centerX + halfWidth, image.cols - 1);
+			unsigned char* out = image.ptr<unsigned char>(centerY + dy) + fromX * channels;
+			for (int x = fromX; x <= toX; ++x, out += channels)
+			{
+				for (int c = 0; c < channels; ++c)
+				{
+					out[c] = pixel[c];
+				}
+			}
+		}
+	}
+}
+
+void SkeletonOverlay::BuildDisc()
+{
+	m_DiscRadius = m_Style.m_Joint_Radius;
+	m_DiscHalfWidths.resize(2 * m_DiscRadius + 1);
+	for (int dy = -m_DiscRadius; dy <= m_DiscRadius; ++dy)
+	{
+		// +0.5 matches the coverage of cv::circle's filled discs closely
+		m_DiscHalfWidths[dy + m_DiscRadius] = (int)std::sqrt((m_DiscRadius + 0.5) * (m_DiscRadius + 0.5) - dy * dy);
+	}
+}
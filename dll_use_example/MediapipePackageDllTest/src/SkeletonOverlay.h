@@ -0,0 +1,95 @@
+#ifndef SKELETON_OVERLAY_H
+#define SKELETON_OVERLAY_H
+
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "MediapipeHandTrackingDll.h"
+
+//!
+//! @brief - Batched skeleton overlay for any number of hands (or other fixed topologies)
+//!
+//! Begin() / AddSkeletons() collect every skeleton of a frame into one batch. Draw()
+//! then renders all bones with a single cv::polylines call and stamps the joints from
+//! a precomputed disc instead of one cv::circle and cv::line call per element.
+//!
+//! DrawLayer() rasterizes the same batch into a BGRA layer that covers only the
+//! skeletons' bounding box, for hosts that composite the overlay themselves (e.g. over
+//! a video texture). Hosts with their own OpenGL / D3D renderer can skip rasterizing
+//! altogether and upload GetLineVertices() / GetJointVertices() as one vertex buffer
+//! each; the bundled OpenCV is built without OpenGL, so this example does not draw
+//! through the GPU itself.
+//!
+//! Not thread-safe: one batch per rendering thread.
+//!
+
+struct SkeletonOverlayStyle
+{
+	cv::Scalar m_Joint_Color = cv::Scalar(0, 0, 255);
+	int m_Joint_Radius = 6;
+	cv::Scalar m_Bone_Color = cv::Scalar(0, 255, 0);
+	int m_Bone_Thickness = 2;
+	int m_Line_Type = cv::LINE_8;
+};
+
+class SkeletonOverlay
+{
+public:
+	// each chain is a joint index sequence drawn as one polyline
+	SkeletonOverlay(int joints_per_skeleton, const std::vector<std::vector<int>>& chains, const SkeletonOverlayStyle& style = SkeletonOverlayStyle());
+	virtual~SkeletonOverlay();
+
+	// The 21-keypoint hand: five fingers from the wrist (or knuckle) plus the palm line
+	static SkeletonOverlay CreateHandOverlay(const SkeletonOverlayStyle& style = SkeletonOverlayStyle());
+
+public:
+	void Begin();
+	// count is a multiple of joints_per_skeleton; a trailing partial skeleton is ignored
+	void AddSkeletons(const cv::Point* points, int count);
+	void AddSkeletons(const PoseInfo* infos, int count);
+
+	void Draw(cv::Mat& image);
+	// layer becomes a CV_8UC4 image of roi.size(), transparent outside the overlay;
+	// roi is the batch's bounds clipped to frame_size. False when the batch is empty.
+	bool DrawLayer(cv::Size frame_size, cv::Mat& layer, cv::Rect& roi);
+
+	bool IsEmpty();
+	// padded by the joint radius / bone thickness, unclipped
+	cv::Rect GetBounds();
+	// line list, x0 y0 x1 y1 per bone, in pixels
+	const std::vector<float>& GetLineVertices();
+	// x y per joint, in pixels
+	const std::vector<float>& GetJointVertices();
+
+	SkeletonOverlayStyle& GetStyle();
+
+private:
+	void AddSkeleton(const cv::Point* points);
+	void RenderBatch(cv::Mat& image, cv::Point offset, const cv::Scalar& bone_color, const cv::Scalar& joint_color);
+	void StampJoints(cv::Mat& image, cv::Point offset, const cv::Scalar& color);
+	void BuildDisc();
+
+private:
+	int m_JointsPerSkeleton;
+	std::vector<std::vector<int>> m_Chains;
+	SkeletonOverlayStyle m_Style;
+
+	// batch, reused across frames
+	std::vector<cv::Point> m_Joints;
+	std::vector<cv::Point> m_ChainPoints;		// all chains back to back
+	std::vector<int> m_ChainLengths;
+	std::vector<cv::Point> m_ShiftedPoints;		// m_ChainPoints moved into a layer's ROI
+	std::vector<const cv::Point*> m_ChainStarts;
+	std::vector<cv::Point> m_Scratch;			// PoseInfo conversion
+	std::vector<float> m_LineVertices;
+	std::vector<float> m_JointVertices;
+	int m_MinX, m_MinY, m_MaxX, m_MaxY;
+
+	// half-width of the joint disc per row, -radius .. radius
+	std::vector<int> m_DiscHalfWidths;
+	int m_DiscRadius;
+};
+
+#endif // !SKELETON_OVERLAY_H
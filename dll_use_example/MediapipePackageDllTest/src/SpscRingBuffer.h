@@ -0,0 +1,89 @@
+#ifndef SPSC_RING_BUFFER_H
+#define SPSC_RING_BUFFER_H
+
+#include <atomic>
+#include <vector>
+#include <cstddef>
+
+//!
+//! @brief - Fixed-capacity single-producer/single-consumer ring
+//!
+//! Slots are allocated once at construction and reused; producer and consumer
+//! fill or read a slot in place through the callable they pass in, so no element
+//! is copied or constructed on the hot path. Exactly one thread may push and
+//! exactly one other thread may pop.
+//!
+template <typename T>
+class SpscRingBuffer
+{
+public:
+	explicit SpscRingBuffer(size_t capacity)
+		: m_Slots(RoundUpToPowerOfTwo(capacity < 2 ? 2 : capacity))
+		, m_Mask(m_Slots.size() - 1)
+		, m_Head(0)
+		, m_Tail(0)
+	{
+	}
+
+	size_t Capacity() const
+	{
+		return m_Slots.size();
+	}
+
+	T& SlotAt(size_t index)
+	{
+		return m_Slots[index];
+	}
+
+	// writer(T& slot) fills the slot; returns false if the ring is full
+	template <typename Writer>
+	bool TryPush(Writer writer)
+	{
+		size_t tail = m_Tail.load(std::memory_order_relaxed);
+		if (tail - m_Head.load(std::memory_order_acquire) == m_Slots.size())
+		{
+			return false;
+		}
+		writer(m_Slots[tail & m_Mask]);
+		m_Tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	// reader(T& slot) consumes the slot; returns false if the ring is empty
+	template <typename Reader>
+	bool TryPop(Reader reader)
+	{
+		size_t head = m_Head.load(std::memory_order_relaxed);
+		if (head == m_Tail.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+		reader(m_Slots[head & m_Mask]);
+		m_Head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool IsEmpty() const
+	{
+		return m_Head.load(std::memory_order_acquire) == m_Tail.load(std::memory_order_acquire);
+	}
+
+private:
+	static size_t RoundUpToPowerOfTwo(size_t value)
+	{
+		size_t result = 1;
+		while (result < value)
+		{
+			result <<= 1;
+		}
+		return result;
+	}
+
+private:
+	std::vector<T> m_Slots;
+	size_t m_Mask;
+	alignas(64) std::atomic<size_t> m_Head;
+	alignas(64) std::atomic<size_t> m_Tail;
+};
+
+#endif // !SPSC_RING_BUFFER_H
@@ -0,0 +1,255 @@
+#include "TrackerMetrics.h"
+
+#include <cstdio>
+#include <initializer_list>
+#include <sstream>
+
+// platform selection and Windows.h
+#include "DynamicModuleLoader.h"
+
+#if defined(WINDOWS)
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#elif defined(LINUX)
+#include <unistd.h>
+#endif
+
+namespace
+{
+	const double kLatencyBucketsMs[TRACKER_METRICS_LATENCY_BUCKETS] = { 1, 2, 5, 10, 16, 33, 50, 100, 200, 500, 1000 };
+
+	struct Counter
+	{
+		const char* m_Name;
+		const char* m_Help;
+		unsigned long long TrackerMetricsSnapshot::* m_Field;
+	};
+
+	const Counter kCounters[] =
+	{
+		{ "frames_submitted", "Frames handed to the tracker.", &TrackerMetricsSnapshot::m_Frames_Submitted },
+		{ "frames_processed", "Frames the DLL ran.", &TrackerMetricsSnapshot::m_Frames_Processed },
+		{ "frames_dropped", "Frames dropped before reaching the DLL.", &TrackerMetricsSnapshot::m_Frames_Dropped },
+		{ "frames_cached", "Frames answered with a previous result.", &TrackerMetricsSnapshot::m_Frames_Cached },
+		{ "frames_with_detection", "Processed frames with at least one detection.", &TrackerMetricsSnapshot::m_Frames_With_Detection },
+		{ "detect_failures", "DLL detect calls that returned failure.", &TrackerMetricsSnapshot::m_Detect_Failures },
+	};
+
+	std::string Braces(const std::string& labels, const std::string& extra = "")
+	{
+		if (labels.empty() && extra.empty())
+		{
+			return "";
+		}
+		if (labels.empty() || extra.empty())
+		{
+			return "{" + labels + extra + "}";
+		}
+		return "{" + labels + "," + extra + "}";
+	}
+
+	void RenderHistogram(std::ostringstream& out, const std::string& family, const std::string& labels, const TrackerLatencyHistogram& histogram)
+	{
+		unsigned long long cumulative = 0;
+		char bound[32];
+		for (int i = 0; i < TRACKER_METRICS_LATENCY_BUCKETS; ++i)
+		{
+			cumulative += histogram.m_Bucket_Counts[i];
+			std::snprintf(bound, sizeof(bound), "le=\"%g\"", kLatencyBucketsMs[i] / 1000.0);
+			out << family << "_bucket" << Braces(labels, bound) << " " << cumulative << "\n";
+		}
+		cumulative += histogram.m_Bucket_Counts[TRACKER_METRICS_LATENCY_BUCKETS];
+		out << family << "_bucket" << Braces(labels, "le=\"+Inf\"") << " " << cumulative << "\n";
+		out << family << "_count" << Braces(labels) << " " << histogram.m_Count << "\n";
+		out << family << "_sum" << Braces(labels) << " " << histogram.m_Sum_Ms / 1000.0 << "\n";
+	}
+}
+
+TrackerMetrics::TrackerMetrics(const std::string& labels)
+	: m_Labels(labels)
+	, m_FramesSubmitted(0)
+	, m_FramesProcessed(0)
+	, m_FramesDropped(0)
+	, m_FramesCached(0)
+	, m_FramesWithDetection(0)
+	, m_DetectFailures(0)
+	, m_QueueDepth(0)
+{
+	for (Histogram* histogram : { &m_DetectLatency, &m_ResultLatency })
+	{
+		for (std::atomic<unsigned long long>& bucket : histogram->m_Bucket_Counts)
+		{
+			bucket.store(0, std::memory_order_relaxed);
+		}
+		histogram->m_Count.store(0, std::memory_order_relaxed);
+		histogram->m_Sum_Ns.store(0, std::memory_order_relaxed);
+	}
+}
+
+TrackerMetrics::~TrackerMetrics()
+{
+}
+
+void TrackerMetrics::AddSubmitted()
+{
+	m_FramesSubmitted.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TrackerMetrics::AddDropped(unsigned long long count)
+{
+	m_FramesDropped.fetch_add(count, std::memory_order_relaxed);
+}
+
+void TrackerMetrics::AddCached()
+{
+	m_FramesCached.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TrackerMetrics::AddProcessed(double detect_ms, bool detect_succeeded, bool has_detection)
+{
+	m_FramesProcessed.fetch_add(1, std::memory_order_relaxed);
+	if (!detect_succeeded)
+	{
+		m_DetectFailures.fetch_add(1, std::memory_order_relaxed);
+	}
+	if (has_detection)
+	{
+		m_FramesWithDetection.fetch_add(1, std::memory_order_relaxed);
+	}
+	Record(m_DetectLatency, detect_ms);
+}
+
+void TrackerMetrics::AddResultLatency(double result_ms)
+{
+	Record(m_ResultLatency, result_ms);
+}
+
+void TrackerMetrics::SetQueueDepth(int depth)
+{
+	m_QueueDepth.store(depth, std::memory_order_relaxed);
+}
+
+TrackerMetricsSnapshot TrackerMetrics::GetSnapshot()
+{
+	TrackerMetricsSnapshot snapshot;
+	snapshot.m_Frames_Submitted = m_FramesSubmitted.load(std::memory_order_relaxed);
+	snapshot.m_Frames_Processed = m_FramesProcessed.load(std::memory_order_relaxed);
+	snapshot.m_Frames_Dropped = m_FramesDropped.load(std::memory_order_relaxed);
+	snapshot.m_Frames_Cached = m_FramesCached.load(std::memory_order_relaxed);
+	snapshot.m_Frames_With_Detection = m_FramesWithDetection.load(std::memory_order_relaxed);
+	snapshot.m_Detect_Failures = m_DetectFailures.load(std::memory_order_relaxed);
+	snapshot.m_Queue_Depth = m_QueueDepth.load(std::memory_order_relaxed);
+	snapshot.m_Resident_Bytes = GetResidentBytes();
+	Read(m_DetectLatency, snapshot.m_Detect_Latency);
+	Read(m_ResultLatency, snapshot.m_Result_Latency);
+	return snapshot;
+}
+
+const std::string& TrackerMetrics::GetLabels()
+{
+	return m_Labels;
+}
+
+std::string TrackerMetrics::RenderOpenMetrics(const std::vector<TrackerMetrics*>& metrics, const std::string& name_prefix)
+{
+	std::vector<TrackerMetricsSnapshot> snapshots;
+	snapshots.reserve(metrics.size());
+	for (TrackerMetrics* tracker : metrics)
+	{
+		snapshots.push_back(tracker->GetSnapshot());
+	}
+
+	std::ostringstream out;
+	for (const Counter& counter : kCounters)
+	{
+		std::string family = name_prefix + "_" + counter.m_Name;
+		out << "# TYPE " << family << " counter\n";
+		out << "# HELP " << family << " " << counter.m_Help << "\n";
+		for (size_t i = 0; i < metrics.size(); ++i)
+		{
+			out << family << "_total" << Braces(metrics[i]->GetLabels()) << " " << snapshots[i].*counter.m_Field << "\n";
+		}
+	}
+
+	std::string queueFamily = name_prefix + "_queue_depth";
+	out << "# TYPE " << queueFamily << " gauge\n";
+	out << "# HELP " << queueFamily << " Frames queued or in the graph.\n";
+	for (size_t i = 0; i < metrics.size(); ++i)
+	{
+		out << queueFamily << Braces(metrics[i]->GetLabels()) << " " << snapshots[i].m_Queue_Depth << "\n";
+	}
+
+	const char* histograms[2][2] =
+	{
+		{ "_detect_latency_seconds", "Time spent inside the DLL detect call." },
+		{ "_result_latency_seconds", "Time from submit to result." },
+	};
+	for (int h = 0; h < 2; ++h)
+	{
+		std::string family = name_prefix + histograms[h][0];
+		out << "# TYPE " << family << " histogram\n";
+		out << "# UNIT " << family << " seconds\n";
+		out << "# HELP " << family << " " << histograms[h][1] << "\n";
+		for (size_t i = 0; i < metrics.size(); ++i)
+		{
+			RenderHistogram(out, family, metrics[i]->GetLabels(), h == 0 ? snapshots[i].m_Detect_Latency : snapshots[i].m_Result_Latency);
+		}
+	}
+
+	// process-wide, so rendered once without tracker labels
+	std::string rssFamily = name_prefix + "_resident_memory_bytes";
+	out << "# TYPE " << rssFamily << " gauge\n";
+	out << "# UNIT " << rssFamily << " bytes\n";
+	out << "# HELP " << rssFamily << " Resident memory of the process.\n";
+	out << rssFamily << " " << GetResidentBytes() << "\n";
+
+	out << "# EOF\n";
+	return out.str();
+}
+
+long long TrackerMetrics::GetResidentBytes()
+{
+#if defined(WINDOWS)
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+	{
+		return (long long)counters.WorkingSetSize;
+	}
+	return 0;
+#elif defined(LINUX)
+	long long pages = 0;
+	long long residentPages = 0;
+	FILE* file = std::fopen("/proc/self/statm", "r");
+	if (file == nullptr)
+	{
+		return 0;
+	}
+	int fields = std::fscanf(file, "%lld %lld", &pages, &residentPages);
+	std::fclose(file);
+	return fields == 2 ? residentPages * (long long)sysconf(_SC_PAGESIZE) : 0;
+#else
+	return 0;
+#endif
+}
+
+void TrackerMetrics::Record(Histogram& histogram, double ms)
+{
+	int bucket = 0;
+	while (bucket < TRACKER_METRICS_LATENCY_BUCKETS && ms > kLatencyBucketsMs[bucket])
+	{
+		++bucket;
+	}
+	histogram.m_Bucket_Counts[bucket].fetch_add(1, std::memory_order_relaxed);
+	histogram.m_Count.fetch_add(1, std::memory_order_relaxed);
+	histogram.m_Sum_Ns.fetch_add((unsigned long long)(ms > 0.0 ? ms * 1000000.0 : 0.0), std::memory_order_relaxed);
+}
+
+void TrackerMetrics::Read(Histogram& histogram, TrackerLatencyHistogram& snapshot)
+{
+	for (int i = 0; i <= TRACKER_METRICS_LATENCY_BUCKETS; ++i)
+	{
+		snapshot.m_Bucket_Counts[i] = histogram.m_Bucket_Counts[i].load(std::memory_order_relaxed);
+	}
+	snapshot.m_Count = histogram.m_Count.load(std::memory_order_relaxed);
+	snapshot.m_Sum_Ms = histogram.m_Sum_Ns.load(std::memory_order_relaxed) / 1000000.0;
+}
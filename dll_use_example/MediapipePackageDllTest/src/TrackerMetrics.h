@@ -0,0 +1,89 @@
+#ifndef TRACKER_METRICS_H
+#define TRACKER_METRICS_H
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+//!
+//! @brief - Lock-free tracker counters with an OpenMetrics text export
+//!
+//! The wrappers that own a tracker (MediapipeHandTrackingAsync,
+//! MediapipeHandTrackingMotionGated) record into an attached TrackerMetrics from
+//! whatever thread they run on; recording is a handful of relaxed atomic adds. A host
+//! either reads the flat TrackerMetricsSnapshot or serves RenderOpenMetrics() from its
+//! /metrics endpoint. Several trackers in one process are told apart by their labels
+//! and rendered into a single exposition.
+//!
+
+// finite latency buckets, 1 ms .. 1 s (see TrackerMetrics.cpp), plus one for +Inf
+#define TRACKER_METRICS_LATENCY_BUCKETS 11
+
+struct TrackerLatencyHistogram
+{
+	unsigned long long m_Bucket_Counts[TRACKER_METRICS_LATENCY_BUCKETS + 1] = { 0 };	// not cumulative
+	unsigned long long m_Count = 0;
+	double m_Sum_Ms = 0.0;
+};
+
+struct TrackerMetricsSnapshot
+{
+	unsigned long long m_Frames_Submitted = 0;
+	unsigned long long m_Frames_Processed = 0;		// frames the DLL ran
+	unsigned long long m_Frames_Dropped = 0;		// frames that never reached the DLL
+	unsigned long long m_Frames_Cached = 0;			// frames answered with a previous result
+	unsigned long long m_Frames_With_Detection = 0;	// stays 0 where the landmarks go straight to the caller's callback
+	unsigned long long m_Detect_Failures = 0;		// the DLL call returned 0
+	int m_Queue_Depth = 0;
+	long long m_Resident_Bytes = 0;					// of the whole process, sampled at snapshot time
+	TrackerLatencyHistogram m_Detect_Latency;		// time inside the DLL call
+	TrackerLatencyHistogram m_Result_Latency;		// submit to result, where the wrapper knows both ends
+};
+
+class TrackerMetrics
+{
+public:
+	// labels are rendered verbatim inside the braces, e.g. camera="3",model="hand"
+	TrackerMetrics(const std::string& labels = "");
+	virtual~TrackerMetrics();
+
+public:
+	void AddSubmitted();
+	void AddDropped(unsigned long long count = 1);
+	void AddCached();
+	void AddProcessed(double detect_ms, bool detect_succeeded, bool has_detection);
+	void AddResultLatency(double result_ms);
+	void SetQueueDepth(int depth);
+
+	TrackerMetricsSnapshot GetSnapshot();
+	const std::string& GetLabels();
+
+	// Text exposition for every tracker in the list, families grouped, terminated by # EOF
+	static std::string RenderOpenMetrics(const std::vector<TrackerMetrics*>& metrics, const std::string& name_prefix = "mediapipe_tracker");
+	static long long GetResidentBytes();
+
+private:
+	struct Histogram
+	{
+		std::atomic<unsigned long long> m_Bucket_Counts[TRACKER_METRICS_LATENCY_BUCKETS + 1];
+		std::atomic<unsigned long long> m_Count;
+		std::atomic<unsigned long long> m_Sum_Ns;
+	};
+
+	static void Record(Histogram& histogram, double ms);
+	static void Read(Histogram& histogram, TrackerLatencyHistogram& snapshot);
+
+private:
+	std::string m_Labels;
+	std::atomic<unsigned long long> m_FramesSubmitted;
+	std::atomic<unsigned long long> m_FramesProcessed;
+	std::atomic<unsigned long long> m_FramesDropped;
+	std::atomic<unsigned long long> m_FramesCached;
+	std::atomic<unsigned long long> m_FramesWithDetection;
+	std::atomic<unsigned long long> m_DetectFailures;
+	std::atomic<int> m_QueueDepth;
+	Histogram m_DetectLatency;
+	Histogram m_ResultLatency;
+};
+
+#endif // !TRACKER_METRICS_H
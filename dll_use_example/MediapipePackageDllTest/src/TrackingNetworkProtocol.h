@@ -0,0 +1,125 @@
+#ifndef TRACKING_NETWORK_PROTOCOL_H
+#define TRACKING_NETWORK_PROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+
+// winsock2.h must come before the Windows.h pulled in by DynamicModuleLoader.h
+#if defined(WINDOWS) || (!defined(LINUX) && defined(_WIN32))
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "ws2_32.lib")
+#else
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include "MediapipeHandTrackingDll.h"
+
+//!
+//! @brief - TCP wire format between MediapipeHandTrackingNetwork and MediapipeTrackingService
+//!
+//! The shared-memory channels of TrackingServiceProtocol.h only reach processes on the
+//! same machine. Over the network a client sends one request at a time:
+//!   TrackingNetRequest | m_Payload_Bytes of packed BGR (m_Image_Width x m_Image_Height)
+//! and reads back
+//!   TrackingNetResponse | m_Landmark_Count PoseInfo | m_Gesture_Count int32
+//! All fields are little-endian, as on every platform the DLL is built for. The
+//! payload is usually not the full frame but a crop around the hands, scaled down so
+//! its long side fits the landmark model input; landmarks come back in payload
+//! pixels and the client maps them to the frame.
+//!
+
+#define TRACKING_NET_MAGIC 0x4E54504D		// "MPTN"
+#define TRACKING_NET_VERSION 1
+#define TRACKING_NET_DEFAULT_PORT 9537
+#define TRACKING_NET_MAX_LANDMARKS 126
+#define TRACKING_NET_MAX_GESTURES 4
+
+#if defined(WINDOWS) || (!defined(LINUX) && defined(_WIN32))
+typedef SOCKET TrackingSocketHandle;
+#define TRACKING_INVALID_SOCKET INVALID_SOCKET
+#define TRACKING_SEND_FLAGS 0
+#else
+typedef int TrackingSocketHandle;
+#define TRACKING_INVALID_SOCKET (-1)
+// a send to a peer that hung up raises SIGPIPE, which would kill the process
+#if defined(MSG_NOSIGNAL)
+#define TRACKING_SEND_FLAGS MSG_NOSIGNAL
+#else
+#define TRACKING_SEND_FLAGS 0			// no MSG_NOSIGNAL (macOS): ignore SIGPIPE instead
+#endif
+#endif
+
+struct TrackingNetRequest
+{
+	uint32_t m_Magic;
+	uint32_t m_Version;
+	int32_t m_Image_Index;
+	int32_t m_Image_Width;
+	int32_t m_Image_Height;
+	uint32_t m_Payload_Bytes;			// m_Image_Width * m_Image_Height * 3
+};
+
+struct TrackingNetResponse
+{
+	int32_t m_Detect_Result;
+	GestureRecognitionResult m_Gesture_Result;
+	int32_t m_Landmark_Count;			// -1 when no landmarks callback fired for the frame
+	int32_t m_Gesture_Count;			// -1 when no gesture callback fired for the frame
+};
+
+inline void CloseTrackingSocket(TrackingSocketHandle socket_handle)
+{
+#if defined(WINDOWS) || (!defined(LINUX) && defined(_WIN32))
+	closesocket(socket_handle);
+#else
+	close(socket_handle);
+#endif
+}
+
+// Requests are tiny and latency-bound; Nagle would hold the response for the next write
+inline void SetTrackingSocketNoDelay(TrackingSocketHandle socket_handle)
+{
+	int enable = 1;
+	setsockopt(socket_handle, IPPROTO_TCP, TCP_NODELAY, (const char*)&enable, sizeof(enable));
+}
+
+inline bool SendAll(TrackingSocketHandle socket_handle, const void* data, size_t size)
+{
+	const char* bytes = (const char*)data;
+	while (size > 0)
+	{
+		int chunk = size > (1u << 30) ? (1 << 30) : (int)size;
+		int sent = (int)send(socket_handle, bytes, chunk, TRACKING_SEND_FLAGS);
+		if (sent <= 0)
+		{
+			return false;
+		}
+		bytes += sent;
+		size -= (size_t)sent;
+	}
+	return true;
+}
+
+inline bool ReceiveAll(TrackingSocketHandle socket_handle, void* data, size_t size)
+{
+	char* bytes = (char*)data;
+	while (size > 0)
+	{
+		int chunk = size > (1u << 30) ? (1 << 30) : (int)size;
+		int received = (int)recv(socket_handle, bytes, chunk, 0);
+		if (received <= 0)
+		{
+			return false;
+		}
+		bytes += received;
+		size -= (size_t)received;
+	}
+	return true;
+}
+
+#endif // !TRACKING_NETWORK_PROTOCOL_H
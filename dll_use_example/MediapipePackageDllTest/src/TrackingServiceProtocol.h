@@ -0,0 +1,335 @@
+#ifndef TRACKING_SERVICE_PROTOCOL_H
+#define TRACKING_SERVICE_PROTOCOL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "MediapipeHandTrackingDll.h"
+
+#if defined(WINDOWS)
+#include <Windows.h>
+#elif defined(LINUX)
+#include <cerrno>
+#include <climits>
+#include <ctime>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+//!
+//! @brief - Shared-memory layout between MediapipeTrackingService and MediapipeHandTrackingRemote
+//!
+//! One named segment holds a header and a fixed number of channels. A client claims
+//! a free channel, writes a frame straight into it, flips the channel state to
+//! TCS_Requested and bumps the header's work word. The service, the only process
+//! that runs the graph, solves requests one at a time, writes the results into the
+//! same channel and flips it to TCS_Done. Frames are never copied through a socket,
+//! and waiting uses futexes on Linux and named events on Windows.
+//!
+//! The claim is swapping the client's pid into m_Owner_Pid; the state leaves TCS_Free
+//! only after that, so every channel in use names an owner the service can check
+//! when it reclaims channels of clients that died.
+//!
+
+#define TRACKING_SERVICE_MAGIC 0x5354504D	// "MPTS"
+#define TRACKING_SERVICE_VERSION 1
+#define TRACKING_SERVICE_MAX_LANDMARKS 126	// 21 per hand, up to six hands (num_hands in the graph)
+#define TRACKING_SERVICE_MAX_GESTURES 4
+#define TRACKING_SERVICE_DEFAULT_NAME "MediapipeTrackingService"
+
+enum TrackingChannelState
+{
+	TCS_Free = 0,			// no client
+	TCS_Idle = 1,			// claimed, nothing pending
+	TCS_Requested = 2,		// frame written; service may read the channel
+	TCS_Done = 3			// results written; client may read the channel
+};
+
+enum TrackingRequestType
+{
+	TRT_DetectFrame = 0,
+	TRT_DetectFrameDirect = 1
+};
+
+struct TrackingServiceHeader
+{
+	uint32_t m_Magic;
+	uint32_t m_Version;
+	uint32_t m_Channel_Count;
+	uint32_t m_Max_Frame_Bytes;
+	uint64_t m_Channel_Stride;			// bytes from one channel to the next
+	uint32_t m_Service_Pid;
+	std::atomic<uint32_t> m_Work_Seq;	// bumped by clients after every request; the service waits on it
+	std::atomic<uint32_t> m_Running;	// cleared when the service shuts down
+};
+
+struct TrackingChannel
+{
+	std::atomic<uint32_t> m_State;		// TrackingChannelState; the client waits on it
+	std::atomic<uint32_t> m_Owner_Pid;	// 0 when free; claiming and releasing both go through this
+
+	// request
+	int32_t m_Request_Type;
+	int32_t m_Image_Index;
+	int32_t m_Image_Width;
+	int32_t m_Image_Height;
+
+	// results
+	int32_t m_Detect_Result;
+	GestureRecognitionResult m_Gesture_Result;
+	int32_t m_Landmark_Count;			// -1 when no landmarks callback fired for the frame
+	PoseInfo m_Landmarks[TRACKING_SERVICE_MAX_LANDMARKS];
+	int32_t m_Gesture_Count;			// -1 when no gesture callback fired for the frame
+	int32_t m_Gestures[TRACKING_SERVICE_MAX_GESTURES];
+};
+
+// frame bytes start here within each channel, cache-line aligned
+const size_t kTrackingChannelHeaderBytes = (sizeof(TrackingChannel) + 63) & ~(size_t)63;
+
+inline size_t TrackingChannelStride(uint32_t max_frame_bytes)
+{
+	return (kTrackingChannelHeaderBytes + max_frame_bytes + 63) & ~(size_t)63;
+}
+
+inline size_t TrackingSegmentBytes(uint32_t channel_count, uint32_t max_frame_bytes)
+{
+	return ((sizeof(TrackingServiceHeader) + 63) & ~(size_t)63) + channel_count * TrackingChannelStride(max_frame_bytes);
+}
+
+inline TrackingChannel* GetTrackingChannel(TrackingServiceHeader* header, uint32_t index)
+{
+	unsigned char* base = (unsigned char*)header + ((sizeof(TrackingServiceHeader) + 63) & ~(size_t)63);
+	return (TrackingChannel*)(base + index * header->m_Channel_Stride);
+}
+
+inline unsigned char* GetTrackingChannelFrame(TrackingChannel* channel)
+{
+	return (unsigned char*)channel + kTrackingChannelHeaderBytes;
+}
+
+//!
+//! @brief - Named shared-memory segment
+//!
+class TrackingSharedSegment
+{
+public:
+	TrackingSharedSegment() : m_Data(nullptr), m_Size(0)
+#if defined(WINDOWS)
+		, m_Mapping(NULL)
+#endif
+	{
+	}
+
+	~TrackingSharedSegment()
+	{
+		Close();
+	}
+
+	// Service side; an existing segment of the same name is replaced
+	bool Create(const std::string& name, size_t size)
+	{
+		Close();
+#if defined(WINDOWS)
+		m_Mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, (DWORD)((uint64_t)size >> 32), (DWORD)size, ("Local\\" + name).c_str());
+		if (m_Mapping == NULL)
+		{
+			return false;
+		}
+		m_Data = MapViewOfFile(m_Mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+#elif defined(LINUX)
+		m_Name = "/" + name;
+		shm_unlink(m_Name.c_str());
+		int fd = shm_open(m_Name.c_str(), O_CREAT | O_RDWR, 0600);
+		if (fd < 0)
+		{
+			return false;
+		}
+		if (ftruncate(fd, (off_t)size) != 0)
+		{
+			close(fd);
+			return false;
+		}
+		void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+		close(fd);
+		m_Data = data == MAP_FAILED ? nullptr : data;
+		m_Owner = true;
+#endif
+		m_Size = size;
+		return m_Data != nullptr;
+	}
+
+	// Client side; maps the whole segment as sized by the service
+	bool Open(const std::string& name)
+	{
+		Close();
+#if defined(WINDOWS)
+		m_Mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, ("Local\\" + name).c_str());
+		if (m_Mapping == NULL)
+		{
+			return false;
+		}
+		m_Data = MapViewOfFile(m_Mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+#elif defined(LINUX)
+		int fd = shm_open(("/" + name).c_str(), O_RDWR, 0600);
+		if (fd < 0)
+		{
+			return false;
+		}
+		off_t size = lseek(fd, 0, SEEK_END);
+		void* data = size > 0 ? mmap(nullptr, (size_t)size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) : MAP_FAILED;
+		close(fd);
+		m_Data = data == MAP_FAILED ? nullptr : data;
+		m_Size = size > 0 ? (size_t)size : 0;
+#endif
+		return m_Data != nullptr;
+	}
+
+	void Close()
+	{
+#if defined(WINDOWS)
+		if (m_Data != nullptr)
+		{
+			UnmapViewOfFile(m_Data);
+		}
+		if (m_Mapping != NULL)
+		{
+			CloseHandle(m_Mapping);
+			m_Mapping = NULL;
+		}
+#elif defined(LINUX)
+		if (m_Data != nullptr)
+		{
+			munmap(m_Data, m_Size);
+		}
+		if (m_Owner)
+		{
+			shm_unlink(m_Name.c_str());
+			m_Owner = false;
+		}
+#endif
+		m_Data = nullptr;
+		m_Size = 0;
+	}
+
+	void* GetData() { return m_Data; }
+
+private:
+	void* m_Data;
+	size_t m_Size;
+#if defined(WINDOWS)
+	HANDLE m_Mapping;
+#elif defined(LINUX)
+	std::string m_Name;
+	bool m_Owner = false;
+#endif
+};
+
+//!
+//! @brief - Cross-process wait/wake on a 32-bit word in the segment
+//!
+//! Linux waits on the word itself with a shared futex. Windows has no cross-process
+//! WaitOnAddress, so each word is paired with a named auto-reset event.
+//!
+class TrackingSignal
+{
+public:
+	TrackingSignal()
+#if defined(WINDOWS)
+		: m_Event(NULL)
+#endif
+	{
+	}
+
+	~TrackingSignal()
+	{
+#if defined(WINDOWS)
+		if (m_Event != NULL)
+		{
+			CloseHandle(m_Event);
+		}
+#endif
+	}
+
+	bool Open(const std::string& name)
+	{
+#if defined(WINDOWS)
+		m_Event = CreateEventA(NULL, FALSE, FALSE, ("Local\\" + name).c_str());
+		return m_Event != NULL;
+#else
+		(void)name;
+		return true;
+#endif
+	}
+
+	// Returns when *word != expected, on a wake, on timeout or spuriously; callers re-check
+	void Wait(std::atomic<uint32_t>* word, uint32_t expected, int timeout_ms)
+	{
+#if defined(WINDOWS)
+		if (word->load() == expected)
+		{
+			WaitForSingleObject(m_Event, (DWORD)timeout_ms);
+		}
+#elif defined(LINUX)
+		timespec timeout = { timeout_ms / 1000, (long)(timeout_ms % 1000) * 1000000L };
+		syscall(SYS_futex, (uint32_t*)word, FUTEX_WAIT, expected, &timeout, nullptr, 0);
+#endif
+	}
+
+	void Wake(std::atomic<uint32_t>* word)
+	{
+#if defined(WINDOWS)
+		(void)word;
+		SetEvent(m_Event);
+#elif defined(LINUX)
+		syscall(SYS_futex, (uint32_t*)word, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#endif
+	}
+
+private:
+#if defined(WINDOWS)
+	HANDLE m_Event;
+#endif
+};
+
+inline uint32_t GetCurrentProcessIdentifier()
+{
+#if defined(WINDOWS)
+	return (uint32_t)GetCurrentProcessId();
+#elif defined(LINUX)
+	return (uint32_t)getpid();
+#endif
+}
+
+inline bool IsProcessAlive(uint32_t pid)
+{
+#if defined(WINDOWS)
+	HANDLE process = OpenProcess(SYNCHRONIZE, FALSE, (DWORD)pid);
+	if (process == NULL)
+	{
+		return false;
+	}
+	bool alive = WaitForSingleObject(process, 0) == WAIT_TIMEOUT;
+	CloseHandle(process);
+	return alive;
+#elif defined(LINUX)
+	return kill((pid_t)pid, 0) == 0 || errno == EPERM;
+#endif
+}
+
+inline std::string TrackingChannelSignalName(const std::string& service_name, uint32_t index)
+{
+	return service_name + "_channel_" + std::to_string(index);
+}
+
+inline std::string TrackingWorkSignalName(const std::string& service_name)
+{
+	return service_name + "_work";
+}
+
+#endif // !TRACKING_SERVICE_PROTOCOL_H
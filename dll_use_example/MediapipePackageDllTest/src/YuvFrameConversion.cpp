@@ -0,0 +1,101 @@
+#include "YuvFrameConversion.h"
+
+#include <cstddef>
+
+namespace
+{
+	inline unsigned char Clamp(int value)
+	{
+		return (unsigned char)(value < 0 ? 0 : (value > 255 ? 255 : value));
+	}
+
+	// BT.601 limited range in 8.8 fixed point
+	inline void StorePixel(unsigned char* bgr, int luma, int chroma_b, int chroma_g, int chroma_r)
+	{
+		int c = (luma - 16) * 298 + 128;
+		bgr[0] = Clamp((c + chroma_b) >> 8);
+		bgr[1] = Clamp((c + chroma_g) >> 8);
+		bgr[2] = Clamp((c + chroma_r) >> 8);
+	}
+
+	// One chroma row drives two luma rows; u/v are read with a pixel step so NV12
+	// (interleaved, step 2) and I420 (planar, step 1) share the loop. The main loop
+	// covers whole pixel pairs without branches; an odd last column is handled apart.
+	template<int ChromaStep>
+	void ConvertRowPair(int width, const unsigned char* y0, const unsigned char* y1, const unsigned char* u, const unsigned char* v, unsigned char* bgr0, unsigned char* bgr1)
+	{
+		int pairs = width >> 1;
+		for (int i = 0; i < pairs; ++i)
+		{
+			int d = u[i * ChromaStep] - 128;
+			int e = v[i * ChromaStep] - 128;
+			int chromaB = 516 * d;
+			int chromaG = -100 * d - 208 * e;
+			int chromaR = 409 * e;
+
+			StorePixel(bgr0 + i * 6, y0[2 * i], chromaB, chromaG, chromaR);
+			StorePixel(bgr0 + i * 6 + 3, y0[2 * i + 1], chromaB, chromaG, chromaR);
+			StorePixel(bgr1 + i * 6, y1[2 * i], chromaB, chromaG, chromaR);
+			StorePixel(bgr1 + i * 6 + 3, y1[2 * i + 1], chromaB, chromaG, chromaR);
+		}
+		if (width & 1)
+		{
+			int d = u[pairs * ChromaStep] - 128;
+			int e = v[pairs * ChromaStep] - 128;
+			StorePixel(bgr0 + pairs * 6, y0[2 * pairs], 516 * d, -100 * d - 208 * e, 409 * e);
+			StorePixel(bgr1 + pairs * 6, y1[2 * pairs], 516 * d, -100 * d - 208 * e, 409 * e);
+		}
+	}
+
+	bool Convert(int width, int height, const unsigned char* y_plane, int y_stride, const unsigned char* u_plane, int u_stride, const unsigned char* v_plane, int v_stride, int chroma_step, unsigned char* bgr, int bgr_stride)
+	{
+		if (width <= 0 || height <= 0 || y_plane == nullptr || u_plane == nullptr || v_plane == nullptr || bgr == nullptr
+			|| y_stride < width || bgr_stride < width * 3)
+		{
+			return false;
+		}
+
+		for (int row = 0; row < height; row += 2)
+		{
+			const unsigned char* y0 = y_plane + (size_t)row * y_stride;
+			const unsigned char* y1 = y0 + y_stride;
+			const unsigned char* u = u_plane + (size_t)(row >> 1) * u_stride;
+			const unsigned char* v = v_plane + (size_t)(row >> 1) * v_stride;
+			unsigned char* bgr0 = bgr + (size_t)row * bgr_stride;
+			unsigned char* bgr1 = bgr0 + bgr_stride;
+			// an odd last row is written twice over itself instead of branching per pixel
+			if (row + 1 == height)
+			{
+				y1 = y0;
+				bgr1 = bgr0;
+			}
+			if (chroma_step == 2)
+			{
+				ConvertRowPair<2>(width, y0, y1, u, v, bgr0, bgr1);
+			}
+			else
+			{
+				ConvertRowPair<1>(width, y0, y1, u, v, bgr0, bgr1);
+			}
+		}
+		return true;
+	}
+}
+
+bool ConvertNV12ToBGR(int width, int height, const unsigned char* y_plane, int y_stride, const unsigned char* uv_plane, int uv_stride, unsigned char* bgr, int bgr_stride)
+{
+	if (uv_plane == nullptr || uv_stride < ((width + 1) & ~1))
+	{
+		return false;
+	}
+	return Convert(width, height, y_plane, y_stride, uv_plane, uv_stride, uv_plane + 1, uv_stride, 2, bgr, bgr_stride);
+}
+
+bool ConvertI420ToBGR(int width, int height, const unsigned char* y_plane, int y_stride, const unsigned char* u_plane, int u_stride, const unsigned char* v_plane, int v_stride, unsigned char* bgr, int bgr_stride)
+{
+	if (u_stride < (width + 1) / 2 || v_stride < (width + 1) / 2)
+	{
+		return false;
+	}
+	return Convert(width, height, y_plane, y_stride, u_plane, u_stride, v_plane, v_stride, 1, bgr, bgr_stride);
+}
@@ -0,0 +1,21 @@
+#ifndef YUV_FRAME_CONVERSION_H
+#define YUV_FRAME_CONVERSION_H
+
+//!
+//! @brief - NV12 / I420 to packed BGR in a single pass
+//!
+//! The DLLs take BGR. Cameras and hardware decoders mostly deliver NV12, so the
+//! conversion is unavoidable on this side of the API; these routines at least do it
+//! straight into the destination buffer (e.g. an async queue slot) instead of
+//! converting into a temporary Mat and copying that. Two output rows are produced per
+//! chroma row so each chroma sample is loaded once. BT.601 limited range, integer
+//! arithmetic, no per-pixel branches in the inner loop.
+//!
+//! Strides are in bytes. Odd widths and heights are supported.
+//!
+
+bool ConvertNV12ToBGR(int width, int height, const unsigned char* y_plane, int y_stride, const unsigned char* uv_plane, int uv_stride, unsigned char* bgr, int bgr_stride);
+
+bool ConvertI420ToBGR(int width, int height, const unsigned char* y_plane, int y_stride, const unsigned char* u_plane, int u_stride, const unsigned char* v_plane, int v_stride, unsigned char* bgr, int bgr_stride);
+
+#endif // !YUV_FRAME_CONVERSION_H
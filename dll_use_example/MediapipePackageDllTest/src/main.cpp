@@ -1,13 +1,19 @@
 #include <iostream> 
+#include <atomic>
 #include <opencv2/core/core.hpp> 
 #include <opencv2/highgui/highgui.hpp> 
 #include <opencv2/opencv.hpp>
 
 #include "MediapipeHandTrackingDll.h"
+#include "MediapipeHandTrackingAsync.h"
 #include "MediapipeHolisticTrackingDll.h"
+#include "FramePipeline.h"
+#include "LandmarkSnapshot.h"
+#include "SkeletonOverlay.h"
 
-std::vector<cv::Point> handKPs(42); // ȫֱֲؼϢ
-int gValidKpCount = 21;
+// Written by the landmark callback on the DLL's (or the async worker's) thread and read
+// by the display loop without locks; see LandmarkSnapshot.h
+LandmarkSnapshot gHandLandmarks(HAND_KEYPOINT_COUNT * MAX_HAND_COUNT);
 
 std::string GetGestureResult(int result)
 {
@@ -73,24 +79,13 @@ std::string GetArmUpAndDownResult(int result)
 
 // countΪ2142
 // countΪ42ʱ֣
+// with num_hands > 2 in the graph, count is 21 * number of detected hands
 void LandmarksCallBackImpl(int image_index, PoseInfo* infos, int count)
 {
 	std::cout << "image_index" << image_index << std::endl;
 	std::cout << "hand joint num" << count << std::endl;
-	gValidKpCount = count;
-	if (gValidKpCount > 42) {
-		gValidKpCount = 42;
-	}
-	for (int i = 0; i < count; ++i)
-	{
-		if (i < 42) {
-			handKPs[i] = cv::Point(infos[i].x, infos[i].y);
-		}		
-	//	float x = infos[i].x;
-	//	float y = infos[i].y;
-
-	//	//std::cout << "x=" << x << "," << "y=" << y << endl;
-	}
+	// Ĺؼᱻض
+	gHandLandmarks.PublishLandmarks(image_index, infos, count);
 }
 
 void GestureResultCallBackImpl(int image_index, int* recogn_result, int count)
@@ -100,47 +95,34 @@ void GestureResultCallBackImpl(int image_index, int* recogn_result, int count)
 	{
 		std::cout << "" << i << "ֵֻʶΪ" << GetGestureResult(recogn_result[i]) <<std::endl;
 	}
+	gHandLandmarks.PublishGestures(image_index, recogn_result, count);
+}
+
+// Copies the latest published landmarks into points; returns how many are valid
+int ReadHandKeypoints(LandmarkSnapshotFrame& snapshot, std::vector<cv::Point>& points)
+{
+	if (!gHandLandmarks.Read(snapshot))
+	{
+		return 0;
+	}
+	if ((int)points.size() < snapshot.m_Count)
+	{
+		points.resize(snapshot.m_Count);
+	}
+	for (int i = 0; i < snapshot.m_Count; ++i)
+	{
+		points[i] = cv::Point((int)snapshot.m_Landmarks[i].x, (int)snapshot.m_Landmarks[i].y);
+	}
+	return snapshot.m_Count;
 }
 
-void DrawHandKeyponts(cv::Mat& srcImage)
+void DrawHandKeyponts(cv::Mat& srcImage, const std::vector<cv::Point>& handKPs, int validKpCount)
 {
-	// ƹؼ
-	for (int i = 0; i < gValidKpCount; i++) {
-		// ʹ cv::circle ʵԲʾ
-		cv::circle(srcImage, handKPs[i], 6, cv::Scalar(0, 0, 255), -1);
-	}
-
-	int handCount = gValidKpCount / 21;
-	int offset = 0;
-	// ƹؼ֮
-	cv::Scalar lnColor(0, 255, 0);
-	int lnThickness = 2;
-	for (int i = 0; i < handCount; i++) {
-		cv::line(srcImage, handKPs[offset + 0], handKPs[offset + 1], lnColor, lnThickness);
-		cv::line(srcImage, handKPs[offset + 1], handKPs[offset + 2], lnColor, lnThickness);
-		cv::line(srcImage, handKPs[offset + 2], handKPs[offset + 3], lnColor, lnThickness);
-		cv::line(srcImage, handKPs[offset + 3], handKPs[offset + 4], lnColor, lnThickness);
-		cv::line(srcImage, handKPs[offset + 0], handKPs[offset + 5], lnColor, lnThickness);
-		cv::line(srcImage, handKPs[offset + 5], handKPs[offset + 6], lnColor, lnThickness);
-		cv::line(srcImage, handKPs[offset + 6], handKPs[offset + 7], lnColor, lnThickness);
-		cv::line(srcImage, handKPs[offset + 7], handKPs[offset + 8], lnColor, lnThickness);
-		cv::line(srcImage, handKPs[offset + 9], handKPs[offset + 10], lnColor, lnThickness);
-		cv::line(srcImage, handKPs[offset + 10], handKPs[offset + 11], lnColor, lnThickness);
-		cv::line(srcImage, handKPs[offset + 11], handKPs[offset + 12], lnColor, lnThickness);
-		cv::line(srcImage, handKPs[offset + 13], handKPs[offset + 14], lnColor, lnThickness);
-		cv::line(srcImage, handKPs[offset + 14], handKPs[offset + 15], lnColor, lnThickness);
-		cv::line(srcImage, handKPs[offset + 15], handKPs[offset + 16], lnColor, lnThickness);
-		cv::line(srcImage, handKPs[offset + 0], handKPs[offset + 17], lnColor, lnThickness);
-		cv::line(srcImage, handKPs[offset + 17], handKPs[offset + 18], lnColor, lnThickness);
-		cv::line(srcImage, handKPs[offset + 18], handKPs[offset + 19], lnColor, lnThickness);
-		cv::line(srcImage, handKPs[offset + 19], handKPs[offset + 20], lnColor, lnThickness);
-		cv::line(srcImage, handKPs[offset + 5], handKPs[offset + 9], lnColor, lnThickness);
-		cv::line(srcImage, handKPs[offset + 9], handKPs[offset + 13], lnColor, lnThickness);
-		cv::line(srcImage, handKPs[offset + 13], handKPs[offset + 17], lnColor, lnThickness);
-
-		offset += 21;
-	}
-	
+	// ֵĹؼߺϲһƣֻڻ߳ʹ
+	static SkeletonOverlay handOverlay = SkeletonOverlay::CreateHandOverlay();
+	handOverlay.Begin();
+	handOverlay.AddSkeletons(handKPs.data(), validKpCount);
+	handOverlay.Draw(srcImage);
 }
 
 void HandTrackingDllTest()
@@ -208,10 +190,13 @@ void HandTrackingDllTest()
 	cv::namedWindow("ֳƵ", 1);
 
 	int image_index = 0;
+	//Matѭ⸴û
+	cv::Mat frame;
+	cv::Mat displayMat;
+	LandmarkSnapshotFrame landmarkSnapshot;
+	std::vector<cv::Point> handKPs(HAND_KEYPOINT_COUNT * MAX_HAND_COUNT);
 	while (1)
 	{
-		//Mat
-		cv::Mat frame;
 		//capжȡһ֡浽frame
 		bool res = cap.read(frame);
 		if (!res)
@@ -225,24 +210,21 @@ void HandTrackingDllTest()
 			break;
 		}
 
-		//
-		cv::Mat copyMat;
-		frame.copyTo(copyMat);
-		cv::flip(frame, frame, /*flipcode=HORIZONTAL*/ 1);
-
-		// ǳ
-		/*Mat copyMat;
-		copyMat = frame;*/
+		// The DLL reads the capture buffer in place; only the display image is mirrored.
+		// Detect_Frame expects densely packed BGR, so padded Mats still need a copy.
+		cv::Mat inputMat = frame.isContinuous() ? frame : frame.clone();
+		cv::flip(frame, displayMat, /*flipcode=HORIZONTAL*/ 1);
 
-		uchar* pImageData = copyMat.data;
+		uchar* pImageData = inputMat.data;
 
 
 		/* 2 ڶַʽƵ֡ͨصص */
-		gValidKpCount = 0;
-		if (mediapipeHandTrackingDll.m_Mediapipe_Hand_Tracking_Detect_Frame(image_index, copyMat.cols, copyMat.rows, (void*)pImageData))
+		if (mediapipeHandTrackingDll.m_Mediapipe_Hand_Tracking_Detect_Frame(image_index, inputMat.cols, inputMat.rows, (void*)pImageData))
 		{
-			if (gValidKpCount > 0) {
-				DrawHandKeyponts(frame);
+			// ֻƱ֡صĹؼ
+			int validKpCount = ReadHandKeypoints(landmarkSnapshot, handKPs);
+			if (validKpCount > 0 && landmarkSnapshot.m_Image_Index == image_index) {
+				DrawHandKeyponts(displayMat, handKPs, validKpCount);
 			}				
 			//std::cout << "Mediapipe_Hand_Tracking_Detect_Frameִгɹ" << std::endl;
 		}
@@ -254,7 +236,7 @@ void HandTrackingDllTest()
 
 		/* 3 ַʽƵֱ֡ӷʶͨصؽ */
 		/*GestureRecognitionResult gestureRecognitionResult;
-		if (mediapipeHandTrackingDll.m_Mediapipe_Hand_Tracking_Detect_Frame_Direct(copyMat.cols, copyMat.rows, (void*)pImageData, gestureRecognitionResult))
+		if (mediapipeHandTrackingDll.m_Mediapipe_Hand_Tracking_Detect_Frame_Direct(inputMat.cols, inputMat.rows, (void*)pImageData, gestureRecognitionResult))
 		{
 			for (int i = 0; i < 2; ++i)
 			{
@@ -277,7 +259,7 @@ void HandTrackingDllTest()
 
 
 		//ʾͷȡͼ
-		imshow("ֳƵ", frame);
+		imshow("ֳƵ", displayMat);
 		//ȴ1룬˳ѭ
 		if (cv::waitKey(1) >= 0)
 		{
@@ -303,6 +285,90 @@ void HandTrackingDllTest()
 	mediapipeHandTrackingDll.UnLoadMediapipeHandTrackingDll();
 }
 
+// Same as HandTrackingDllTest, but frames go through MediapipeHandTrackingAsync
+// so the next capture overlaps with inference on the previous frame.
+void HandTrackingDllAsyncTest()
+{
+	MediapipeHandTrackingDll mediapipeHandTrackingDll;
+#ifdef _DEBUG
+	std::string dll_path = ".././bin/MediapipeTest/x64/Debug/Mediapipe_Hand_Tracking.dll";
+	std::string mediapipe_hand_tracking_model_path = ".././bin/MediapipeTest/x64/Debug/hand_tracking_desktop_live.pbtxt";
+#else
+	std::string dll_path = "./Mediapipe_Hand_Tracking.dll";
+	std::string mediapipe_hand_tracking_model_path = "./hand_tracking_desktop_live.pbtxt";
+#endif // _DEBUG
+
+	if (!mediapipeHandTrackingDll.LoadMediapipeHandTrackingDll(dll_path) || !mediapipeHandTrackingDll.GetAllFunctions())
+	{
+		std::cout << "Failed to load " << dll_path << std::endl;
+		return;
+	}
+
+	if (!mediapipeHandTrackingDll.m_Mediapipe_Hand_Tracking_Init(mediapipe_hand_tracking_model_path.c_str()))
+	{
+		std::cout << "Mediapipe_Hand_Tracking_Init failed" << std::endl;
+		return;
+	}
+	mediapipeHandTrackingDll.m_Mediapipe_Hand_Tracking_Reigeter_Landmarks_Callback(LandmarksCallBackImpl);
+	mediapipeHandTrackingDll.m_Mediapipe_Hand_Tracking_Register_Gesture_Result_Callback(GestureResultCallBackImpl);
+
+	MediapipeHandTrackingAsync handTrackingAsync(mediapipeHandTrackingDll, 2, ADP_DropOldest);
+	handTrackingAsync.Start();
+
+	cv::VideoCapture cap(0);
+	if (!cap.isOpened())
+	{
+		std::cout << "Failed to open camera 0" << std::endl;
+	}
+
+	cv::namedWindow("HandTrackingAsync", 1);
+
+	cv::Mat frame;
+	LandmarkSnapshotFrame landmarkSnapshot;
+	std::vector<cv::Point> handKPs(HAND_KEYPOINT_COUNT * MAX_HAND_COUNT);
+	int image_index = 0;
+	while (cap.read(frame) && !frame.empty())
+	{
+		// SubmitFrame copies the pixels, so the capture buffer can be reused right away.
+		handTrackingAsync.SubmitFrame(image_index, frame.cols, frame.rows, frame.data, (int)frame.step);
+
+		AsyncHandTrackingResult result;
+		while (handTrackingAsync.PollResult(result))
+		{
+			if (!result.m_Detect_Result)
+			{
+				std::cout << "Mediapipe_Hand_Tracking_Detect_Frame failed for frame " << result.m_Image_Index << std::endl;
+			}
+		}
+
+		cv::flip(frame, frame, /*flipcode=HORIZONTAL*/ 1);
+		// the callback runs on the async worker; draw whatever it published last
+		int validKpCount = ReadHandKeypoints(landmarkSnapshot, handKPs);
+		if (validKpCount > 0)
+		{
+			DrawHandKeyponts(frame, handKPs, validKpCount);
+		}
+
+		imshow("HandTrackingAsync", frame);
+		if (cv::waitKey(1) >= 0)
+		{
+			break;
+		}
+
+		image_index += 1;
+	}
+
+	handTrackingAsync.Stop();
+	std::cout << "Dropped frames: " << handTrackingAsync.GetDroppedFrameCount() << std::endl;
+
+	mediapipeHandTrackingDll.m_Mediapipe_Hand_Tracking_Release();
+
+	cap.release();
+	cv::destroyAllWindows();
+
+	mediapipeHandTrackingDll.UnLoadMediapipeHandTrackingDll();
+}
+
 
 void HolisticTrackingDllTest()
 {
@@ -347,10 +413,11 @@ void HolisticTrackingDllTest()
 	//
 	cv::namedWindow("ͷ", 1);
 
+	//Matѭ⸴û
+	cv::Mat frame;
+	int detect_result[4];
 	while (true)
 	{
-		//Mat
-		cv::Mat frame;
 		//capжȡһ֡浽frame
 		bool res = cap.read(frame);
 		if (!res)
@@ -364,13 +431,12 @@ void HolisticTrackingDllTest()
 			break;
 		}
 
-		//
-		cv::Mat copyMat;
-		frame.copyTo(copyMat);
+		// Pass the capture buffer straight through unless it is padded
+		cv::Mat inputMat = frame.isContinuous() ? frame : frame.clone();
 
-		uchar* pImageData = copyMat.data;
-		int* pdetect_result = new int[4];
-		if (mediapipeHolisticTrackingDll.m_MediapipeHolisticTrackingDetectFrameDirect(copyMat.cols, copyMat.rows, (void*)pImageData, pdetect_result,true))
+		uchar* pImageData = inputMat.data;
+		int* pdetect_result = detect_result;
+		if (mediapipeHolisticTrackingDll.m_MediapipeHolisticTrackingDetectFrameDirect(inputMat.cols, inputMat.rows, (void*)pImageData, pdetect_result,true))
 		{
 			std::string leftArmUpAndDownRecognitionResult = GetArmUpAndDownResult(pdetect_result[0]);
 			std::string rightArmUpAndDownRecognitionResult = GetArmUpAndDownResult(pdetect_result[1]);
@@ -386,7 +452,6 @@ void HolisticTrackingDllTest()
 		{
 			std::cout << "Mediapipe_Holistic_Tracking_Detect_Frame_Directִʧܣ" << std::endl;
 		}
-		delete[] pdetect_result;
 
 		//ʾͷȡͼ
 		imshow("ͷ", frame);
@@ -417,10 +482,196 @@ void HolisticTrackingDllTest()
 	mediapipeHolisticTrackingDll.UnLoadMediapipeHolisticTrackingDll();
 }
 
+// Frame the detection stage is running. By the DLL's callback contract the callbacks
+// fire inside Detect_Frame on the detection thread; the pointer is atomic so the
+// hand-off stays well defined without leaning on that.
+static std::atomic<PipelineFrame*> g_DetectingFrame(nullptr);
+
+void PipelineLandmarksCallBack(int image_index, PoseInfo* infos, int count)
+{
+	PipelineFrame* frame = g_DetectingFrame.load(std::memory_order_acquire);
+	if (frame == nullptr || frame->m_Image_Index != image_index)
+	{
+		return;
+	}
+	int validCount = count < (int)frame->m_Landmarks.size() ? count : (int)frame->m_Landmarks.size();
+	for (int i = 0; i < validCount; ++i)
+	{
+		frame->m_Landmarks[i] = cv::Point((int)infos[i].x, (int)infos[i].y);
+	}
+	frame->m_Landmark_Count = validCount;
+}
+
+void PipelineGestureResultCallBack(int image_index, int* recogn_result, int count)
+{
+	PipelineFrame* frame = g_DetectingFrame.load(std::memory_order_acquire);
+	if (frame == nullptr || frame->m_Image_Index != image_index)
+	{
+		return;
+	}
+	for (int i = 0; i < count && i < 2; ++i)
+	{
+		frame->m_Results[i] = recogn_result[i];
+	}
+}
+
+// HUD text for the result codes; cv::putText has no CJK glyphs
+const char* GetResultLabel(int result, bool is_arm)
+{
+	static const char* gestureLabels[] = { "-", "One", "Two", "Three", "Four", "Five", "Six", "ThumbUp", "Ok", "Fist" };
+	if (is_arm)
+	{
+		return result == 1 ? "up" : (result == 2 ? "down" : "-");
+	}
+	return result >= 1 && result <= 9 ? gestureLabels[result] : "-";
+}
+
+// Reference layout for production use: capture, detection and display each on their
+// own stage, connected by FramePipeline's lock-free rings over reused frame buffers
+void HandTrackingPipelineTest()
+{
+	MediapipeHandTrackingDll mediapipeHandTrackingDll;
+#ifdef _DEBUG
+	std::string dll_path = ".././bin/MediapipeTest/x64/Debug/Mediapipe_Hand_Tracking.dll";
+	std::string mediapipe_hand_tracking_model_path = ".././bin/MediapipeTest/x64/Debug/hand_tracking_desktop_live.pbtxt";
+#else
+	std::string dll_path = "./Mediapipe_Hand_Tracking.dll";
+	std::string mediapipe_hand_tracking_model_path = "./hand_tracking_desktop_live.pbtxt";
+#endif // _DEBUG
+
+	if (!mediapipeHandTrackingDll.LoadMediapipeHandTrackingDll(dll_path) || !mediapipeHandTrackingDll.GetAllFunctions())
+	{
+		std::cout << "Failed to load " << dll_path << std::endl;
+		return;
+	}
+	if (!mediapipeHandTrackingDll.m_Mediapipe_Hand_Tracking_Init(mediapipe_hand_tracking_model_path.c_str()))
+	{
+		std::cout << "Mediapipe_Hand_Tracking_Init failed" << std::endl;
+		return;
+	}
+	mediapipeHandTrackingDll.m_Mediapipe_Hand_Tracking_Reigeter_Landmarks_Callback(PipelineLandmarksCallBack);
+	mediapipeHandTrackingDll.m_Mediapipe_Hand_Tracking_Register_Gesture_Result_Callback(PipelineGestureResultCallBack);
+
+	cv::VideoCapture cap(0);
+	if (!cap.isOpened())
+	{
+		std::cout << "Failed to open camera 0" << std::endl;
+	}
+	cv::namedWindow("HandTrackingPipeline", 1);
+
+	FramePipeline pipeline(4, HAND_KEYPOINT_COUNT * MAX_HAND_COUNT);
+	cv::Mat displayMat;
+	pipeline.Run(cap,
+		[&mediapipeHandTrackingDll](PipelineFrame& frame)
+		{
+			// Detect_Frame expects densely packed BGR
+			if (!frame.m_Image.isContinuous())
+			{
+				frame.m_Image = frame.m_Image.clone();
+			}
+			g_DetectingFrame.store(&frame, std::memory_order_release);
+			bool succeeded = mediapipeHandTrackingDll.m_Mediapipe_Hand_Tracking_Detect_Frame(frame.m_Image_Index, frame.m_Image.cols, frame.m_Image.rows, (void*)frame.m_Image.data) != 0;
+			g_DetectingFrame.store(nullptr, std::memory_order_release);
+			return succeeded;
+		},
+		[&displayMat](PipelineFrame& frame, const FramePipelineStats& stats)
+		{
+			cv::flip(frame.m_Image, displayMat, /*flipcode=HORIZONTAL*/ 1);
+			if (frame.m_Landmark_Count > 0)
+			{
+				DrawHandKeyponts(displayMat, frame.m_Landmarks, frame.m_Landmark_Count);
+			}
+			FramePipeline::DrawHud(displayMat, stats);
+			char gestures[64];
+			snprintf(gestures, sizeof(gestures), "gesture %s / %s", GetResultLabel(frame.m_Results[0], false), GetResultLabel(frame.m_Results[1], false));
+			cv::putText(displayMat, gestures, cv::Point(10, 48), cv::FONT_HERSHEY_SIMPLEX, 0.6, cv::Scalar(0, 255, 255), 1);
+
+			imshow("HandTrackingPipeline", displayMat);
+			return cv::waitKey(1) < 0;
+		});
+
+	mediapipeHandTrackingDll.m_Mediapipe_Hand_Tracking_Release();
+
+	cap.release();
+	cv::destroyAllWindows();
+
+	mediapipeHandTrackingDll.UnLoadMediapipeHandTrackingDll();
+}
+
+// Holistic variant of HandTrackingPipelineTest; the DLL must not draw (show_result_image
+// false) because it would open its window from the detection thread
+void HolisticTrackingPipelineTest()
+{
+	MediapipeHolisticTrackingDll mediapipeHolisticTrackingDll;
+#ifdef _DEBUG
+	std::string dll_path = ".././bin/MediapipeTest/x64/Debug/MediapipeHolisticTracking.dll";
+	std::string mediapipe_holistic_tracking_model_path = ".././bin/MediapipeTest/x64/Debug/holistic_tracking_cpu.pbtxt";
+#else
+	std::string dll_path = "./MediapipeHolisticTracking.dll";
+	std::string mediapipe_holistic_tracking_model_path = "./holistic_tracking_cpu.pbtxt";
+#endif // _DEBUG
+
+	if (!mediapipeHolisticTrackingDll.LoadMediapipeHolisticTrackingDll(dll_path) || !mediapipeHolisticTrackingDll.GetAllFunctions())
+	{
+		std::cout << "Failed to load " << dll_path << std::endl;
+		return;
+	}
+	if (!mediapipeHolisticTrackingDll.m_MediapipeHolisticTrackingInit(mediapipe_holistic_tracking_model_path.c_str(), true, true, true, true))
+	{
+		std::cout << "MediapipeHolisticTrackingInit failed" << std::endl;
+		return;
+	}
+
+	cv::VideoCapture cap(0);
+	if (!cap.isOpened())
+	{
+		std::cout << "Failed to open camera 0" << std::endl;
+	}
+	cv::namedWindow("HolisticTrackingPipeline", 1);
+
+	FramePipeline pipeline(4, 0);
+	pipeline.Run(cap,
+		[&mediapipeHolisticTrackingDll](PipelineFrame& frame)
+		{
+			if (!frame.m_Image.isContinuous())
+			{
+				frame.m_Image = frame.m_Image.clone();
+			}
+			// results go straight into the slot, no per-frame allocation
+			return mediapipeHolisticTrackingDll.m_MediapipeHolisticTrackingDetectFrameDirect(frame.m_Image.cols, frame.m_Image.rows, (void*)frame.m_Image.data, frame.m_Results, false) != 0;
+		},
+		[](PipelineFrame& frame, const FramePipelineStats& stats)
+		{
+			FramePipeline::DrawHud(frame.m_Image, stats);
+			char results[96];
+			snprintf(results, sizeof(results), "arm %s / %s  gesture %s / %s",
+				GetResultLabel(frame.m_Results[0], true), GetResultLabel(frame.m_Results[1], true),
+				GetResultLabel(frame.m_Results[2], false), GetResultLabel(frame.m_Results[3], false));
+			cv::putText(frame.m_Image, results, cv::Point(10, 48), cv::FONT_HERSHEY_SIMPLEX, 0.6, cv::Scalar(0, 255, 255), 1);
+
+			imshow("HolisticTrackingPipeline", frame.m_Image);
+			return cv::waitKey(1) < 0;
+		});
+
+	mediapipeHolisticTrackingDll.m_MediapipeHolisticTrackingRelease();
+
+	cap.release();
+	cv::destroyAllWindows();
+
+	mediapipeHolisticTrackingDll.UnLoadMediapipeHolisticTrackingDll();
+}
+
 int main()
 {
 	HandTrackingDllTest();
 
+	// Capture and inference overlap through the submit/poll wrapper
+	//HandTrackingDllAsyncTest();
+
+	// Capture, detection and display on separate stages, with an fps/latency HUD
+	//HandTrackingPipelineTest();
+	//HolisticTrackingPipelineTest();
+
 	// DLLڲԻ棻лصϢ
 	//HolisticTrackingDllTest();
 
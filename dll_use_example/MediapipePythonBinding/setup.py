@@ -0,0 +1,35 @@
+"""
+Builds the mediapipe_hand_tracking extension:
+
+    python setup.py build_ext --inplace
+
+The DLL itself is loaded at runtime by mediapipe_hand_tracking.open(); only the client
+loader from ../MediapipePackageDllTest/src is compiled in.
+"""
+
+import sys
+
+from setuptools import Extension, setup
+
+client_src = "../MediapipePackageDllTest/src/"
+
+extra_compile_args = ["/EHsc"] if sys.platform == "win32" else ["-std=c++14"]
+libraries = [] if sys.platform == "win32" else ["dl"]
+
+setup(
+    name="mediapipe_hand_tracking",
+    version="1.0",
+    ext_modules=[
+        Extension(
+            "mediapipe_hand_tracking",
+            sources=[
+                "src/MediapipeHandTrackingModule.cpp",
+                client_src + "DynamicModuleLoader.cpp",
+                client_src + "MediapipeHandTrackingDll.cpp",
+            ],
+            include_dirs=[client_src],
+            extra_compile_args=extra_compile_args,
+            libraries=libraries,
+        )
+    ],
+)
@@ -0,0 +1,304 @@
+//!
+//! @brief - CPython extension around the hand tracking DLL
+//!
+//! import mediapipe_hand_tracking as hand_tracking
+//! hand_tracking.open("Mediapipe_Hand_Tracking.dll", "hand_tracking_desktop_live.pbtxt")
+//! landmarks = hand_tracking.detect(frame, image_index)	# frame: HxWx3 uint8 BGR, e.g. from cv2
+//! points = numpy.asarray(landmarks)						# (count, 2) float32, no copy
+//! left, right = hand_tracking.gestures()
+//! hand_tracking.close()
+//!
+//! detect() hands the frame's own memory to Mediapipe_Hand_Tracking_Detect_Frame when it
+//! is densely packed (a C-contiguous NumPy array, bytes, bytearray, memoryview); other
+//! layouts are packed once into a reused buffer. The GIL is released while the graph
+//! runs.
+//!
+//! The DLL's landmark buffer is only valid inside its callback, so the callback copies
+//! it into a buffer owned by this module; detect() returns a read-only memoryview of
+//! shape (count, 2) over that buffer. The view stays valid but its contents are replaced
+//! by the next detect(); copy it (numpy.array(view)) to keep a frame's landmarks.
+//!
+//! The DLL keeps its graph in globals, so the module is one tracker per process.
+//! open(), detect() and close() mark the tracker busy before they release the GIL, so
+//! a second call from another Python thread raises RuntimeError instead of running a
+//! frame into a graph that is mid-call or unloading the DLL underneath it.
+//!
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <vector>
+
+#include "MediapipeHandTrackingDll.h"
+
+#define MODULE_MAX_LANDMARKS (21 * 6)
+
+namespace
+{
+	struct ModuleState
+	{
+		MediapipeHandTrackingDll m_Dll;
+		bool m_Is_Open = false;
+		// set while a call runs the DLL with the GIL released; only touched under the GIL
+		bool m_Is_Busy = false;
+
+		// written by the DLL's callbacks, which fire on the thread inside detect()
+		PoseInfo m_Landmarks[MODULE_MAX_LANDMARKS];
+		int m_Landmark_Count = 0;
+		int m_Landmark_Image_Index = -1;
+		int m_Gestures[2] = { -1, -1 };
+
+		// shape of the exported view; the memoryview keeps pointing at these
+		Py_ssize_t m_Shape[2] = { 0, 2 };
+		Py_ssize_t m_Strides[2] = { sizeof(PoseInfo), sizeof(float) };
+		std::vector<unsigned char> m_PackedFrame;
+	};
+
+	ModuleState g_State;
+
+	void OnLandmarks(int image_index, PoseInfo* infos, int count)
+	{
+		int validCount = infos == nullptr || count < 0 ? 0 : (count < MODULE_MAX_LANDMARKS ? count : MODULE_MAX_LANDMARKS);
+		for (int i = 0; i < validCount; ++i)
+		{
+			g_State.m_Landmarks[i] = infos[i];
+		}
+		g_State.m_Landmark_Count = validCount;
+		g_State.m_Landmark_Image_Index = image_index;
+	}
+
+	void OnGestureResult(int image_index, int* recogn_result, int count)
+	{
+		(void)image_index;
+		g_State.m_Gestures[0] = recogn_result != nullptr && count > 0 ? recogn_result[0] : -1;
+		g_State.m_Gestures[1] = recogn_result != nullptr && count > 1 ? recogn_result[1] : -1;
+	}
+
+	PyObject* LandmarkView(int count)
+	{
+		g_State.m_Shape[0] = count;
+		Py_buffer view;
+		view.buf = g_State.m_Landmarks;
+		view.obj = nullptr;
+		view.len = (Py_ssize_t)count * (Py_ssize_t)sizeof(PoseInfo);
+		view.itemsize = sizeof(float);
+		view.readonly = 1;
+		view.ndim = 2;
+		view.format = (char*)"f";
+		view.shape = g_State.m_Shape;
+		view.strides = g_State.m_Strides;
+		view.suboffsets = nullptr;
+		view.internal = nullptr;
+		return PyMemoryView_FromBuffer(&view);
+	}
+
+	bool RejectBusy()
+	{
+		if (!g_State.m_Is_Busy)
+		{
+			return false;
+		}
+		PyErr_SetString(PyExc_RuntimeError, "the tracker is busy in another thread");
+		return true;
+	}
+
+	void CloseTracker()
+	{
+		if (g_State.m_Is_Open && g_State.m_Dll.m_Mediapipe_Hand_Tracking_Release != nullptr)
+		{
+			g_State.m_Dll.m_Mediapipe_Hand_Tracking_Release();
+		}
+		g_State.m_Is_Open = false;
+		g_State.m_Dll.UnLoadMediapipeHandTrackingDll();
+		g_State.m_Landmark_Count = 0;
+	}
+
+	PyObject* Open(PyObject* self, PyObject* args)
+	{
+		(void)self;
+		const char* dllPath = nullptr;
+		const char* modelPath = nullptr;
+		if (!PyArg_ParseTuple(args, "ss", &dllPath, &modelPath))
+		{
+			return nullptr;
+		}
+		if (RejectBusy())
+		{
+			return nullptr;
+		}
+		if (g_State.m_Is_Open)
+		{
+			PyErr_SetString(PyExc_RuntimeError, "the tracker is already open");
+			return nullptr;
+		}
+
+		if (!g_State.m_Dll.LoadMediapipeHandTrackingDll(dllPath) || !g_State.m_Dll.GetAllFunctions())
+		{
+			CloseTracker();
+			PyErr_Format(PyExc_OSError, "failed to load %s", dllPath);
+			return nullptr;
+		}
+		int initialized = 0;
+		g_State.m_Is_Busy = true;
+		Py_BEGIN_ALLOW_THREADS
+		initialized = g_State.m_Dll.m_Mediapipe_Hand_Tracking_Init(modelPath);
+		Py_END_ALLOW_THREADS
+		g_State.m_Is_Busy = false;
+		if (!initialized)
+		{
+			CloseTracker();
+			PyErr_Format(PyExc_RuntimeError, "Mediapipe_Hand_Tracking_Init failed for %s", modelPath);
+			return nullptr;
+		}
+		g_State.m_Is_Open = true;
+		if (!g_State.m_Dll.m_Mediapipe_Hand_Tracking_Reigeter_Landmarks_Callback(OnLandmarks)
+			|| !g_State.m_Dll.m_Mediapipe_Hand_Tracking_Register_Gesture_Result_Callback(OnGestureResult))
+		{
+			CloseTracker();
+			PyErr_SetString(PyExc_RuntimeError, "failed to register the tracking callbacks");
+			return nullptr;
+		}
+		Py_RETURN_NONE;
+	}
+
+	// detect(frame, image_index=0, width=0, height=0) -> memoryview (count, 2) float32, or None
+	PyObject* Detect(PyObject* self, PyObject* args, PyObject* kwargs)
+	{
+		(void)self;
+		static const char* keywords[] = { "frame", "image_index", "width", "height", nullptr };
+		PyObject* frameObject = nullptr;
+		int imageIndex = 0;
+		int width = 0;
+		int height = 0;
+		if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|iii", (char**)keywords, &frameObject, &imageIndex, &width, &height))
+		{
+			return nullptr;
+		}
+		if (RejectBusy())
+		{
+			return nullptr;
+		}
+		if (!g_State.m_Is_Open)
+		{
+			PyErr_SetString(PyExc_RuntimeError, "open() the tracker first");
+			return nullptr;
+		}
+
+		Py_buffer frame;
+		if (PyObject_GetBuffer(frameObject, &frame, PyBUF_STRIDED_RO) != 0)
+		{
+			return nullptr;
+		}
+		// an HxWx3 array carries its own size; flat buffers need width and height
+		if (frame.ndim == 3 && frame.shape[2] == 3 && frame.itemsize == 1)
+		{
+			height = (int)frame.shape[0];
+			width = (int)frame.shape[1];
+		}
+		if (width <= 0 || height <= 0 || frame.itemsize != 1 || frame.len != (Py_ssize_t)width * height * 3)
+		{
+			PyBuffer_Release(&frame);
+			PyErr_SetString(PyExc_ValueError, "frame must be HxWx3 uint8 BGR, or width * height * 3 bytes with width and height given");
+			return nullptr;
+		}
+
+		void* pixels = frame.buf;
+		if (!PyBuffer_IsContiguous(&frame, 'C'))
+		{
+			// e.g. a cropped or channel-reversed NumPy view; pack once into the reused buffer
+			g_State.m_PackedFrame.resize((size_t)frame.len);
+			if (PyBuffer_ToContiguous(g_State.m_PackedFrame.data(), &frame, frame.len, 'C') != 0)
+			{
+				PyBuffer_Release(&frame);
+				return nullptr;
+			}
+			pixels = g_State.m_PackedFrame.data();
+		}
+
+		g_State.m_Landmark_Count = 0;
+		g_State.m_Landmark_Image_Index = -1;
+		int detected = 0;
+		// the DLL reads the caller's buffer in place; the Py_buffer keeps it alive meanwhile
+		g_State.m_Is_Busy = true;
+		Py_BEGIN_ALLOW_THREADS
+		detected = g_State.m_Dll.m_Mediapipe_Hand_Tracking_Detect_Frame(imageIndex, width, height, pixels);
+		Py_END_ALLOW_THREADS
+		g_State.m_Is_Busy = false;
+		PyBuffer_Release(&frame);
+
+		if (!detected)
+		{
+			PyErr_SetString(PyExc_RuntimeError, "Mediapipe_Hand_Tracking_Detect_Frame failed");
+			return nullptr;
+		}
+		if (g_State.m_Landmark_Count == 0 || g_State.m_Landmark_Image_Index != imageIndex)
+		{
+			Py_RETURN_NONE;
+		}
+		return LandmarkView(g_State.m_Landmark_Count);
+	}
+
+	PyObject* Landmarks(PyObject* self, PyObject* args)
+	{
+		(void)self;
+		(void)args;
+		return LandmarkView(g_State.m_Landmark_Count);
+	}
+
+	PyObject* Gestures(PyObject* self, PyObject* args)
+	{
+		(void)self;
+		(void)args;
+		return Py_BuildValue("(ii)", g_State.m_Gestures[0], g_State.m_Gestures[1]);
+	}
+
+	PyObject* Close(PyObject* self, PyObject* args)
+	{
+		(void)self;
+		(void)args;
+		if (RejectBusy())
+		{
+			return nullptr;
+		}
+		CloseTracker();
+		Py_RETURN_NONE;
+	}
+
+	void FreeModule(void* module)
+	{
+		(void)module;
+		// a thread still inside the DLL at interpreter exit keeps it loaded
+		if (!g_State.m_Is_Busy)
+		{
+			CloseTracker();
+		}
+	}
+
+	PyMethodDef g_Methods[] =
+	{
+		{ "open", Open, METH_VARARGS, "open(dll_path, model_path): load the DLL and initialize the graph" },
+		{ "detect", (PyCFunction)(void(*)(void))Detect, METH_VARARGS | METH_KEYWORDS, "detect(frame, image_index=0, width=0, height=0): run one BGR frame, return a (count, 2) float32 view or None" },
+		{ "landmarks", Landmarks, METH_NOARGS, "landmarks(): view of the last landmarks" },
+		{ "gestures", Gestures, METH_NOARGS, "gestures(): (first, second) gesture codes of the last frame, -1 when unknown" },
+		{ "close", Close, METH_NOARGS, "close(): release the graph and unload the DLL" },
+		{ nullptr, nullptr, 0, nullptr }
+	};
+
+	PyModuleDef g_Module =
+	{
+		PyModuleDef_HEAD_INIT,
+		"mediapipe_hand_tracking",
+		"Hand tracking through the Mediapipe_Hand_Tracking DLL",
+		-1,
+		g_Methods,
+		nullptr,
+		nullptr,
+		nullptr,
+		FreeModule
+	};
+}
+
+PyMODINIT_FUNC PyInit_mediapipe_hand_tracking()
+{
+	return PyModule_Create(&g_Module);
+}
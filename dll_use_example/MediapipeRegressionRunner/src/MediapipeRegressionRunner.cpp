@@ -0,0 +1,718 @@
+//!
+//! @brief - Golden latency and accuracy regression run over a fixed set of recorded clips
+//!
+//! Reads a versioned manifest that names the clips and the DLL configurations to run
+//! them through (hand or holistic DLL, graph file, e.g. lite or full models, and the
+//! detection cadence), plays every clip through every configuration and prints one row
+//! per configuration: fps, DLL latency percentiles, and the distance of the results from
+//! the golden LandmarkRecording stored for the clip.
+//!
+//! With a cadence of N the DLL runs on every Nth frame and the frames in between repeat
+//! the last result, as an application skipping frames would show it; they are compared
+//! against the golden output like any other frame, so the report shows what the skipping
+//! costs in accuracy next to what it saves in time. Latency percentiles cover the frames
+//! the DLL ran, after the warm-up frames; fps counts every frame of the clip against the
+//! time spent producing results, so decoding the clip is not part of it.
+//!
+//! Hand goldens hold the landmarks and the gesture result of every frame, holistic
+//! goldens the four detect results (arm up/down, gestures) in m_Gestures, since the
+//! holistic DLL does not hand out its landmarks. --write-golden runs one configuration
+//! and writes its output as the goldens of its kind; commit the files together with a
+//! bumped manifest version.
+//!
+//! --report writes the rows as tab-separated text; --baseline reads such a file and exits
+//! with code 1 when a configuration lost more than 10% of its fps or its mean landmark
+//! error grew by more than 0.5 px against the baseline run.
+//!
+//! Build together with ../../MediapipePackageDllTest/src/DynamicModuleLoader.cpp,
+//! MediapipeHandTrackingDll.cpp, MediapipeHolisticTrackingDll.cpp and
+//! LandmarkRecording.cpp, with that directory on the include path, and link OpenCV.
+//!
+//! Manifest, one entry per line, # starts a comment, paths relative to the manifest:
+//!
+//!     version 3
+//!     clip wave clips/wave.mp4 hand=golden/wave.hand.rec holistic=golden/wave.holistic.rec
+//!     config hand-full hand Mediapipe_Hand_Tracking.dll hand_tracking_desktop_live.pbtxt
+//!     config hand-lite-skip2 hand Mediapipe_Hand_Tracking.dll hand_tracking_lite.pbtxt cadence=2
+//!     config holistic-full holistic MediapipeHolisticTracking.dll holistic_tracking_cpu.pbtxt
+//!
+//! Usage: MediapipeRegressionRunner <manifest> [--config name] [--warmup frames]
+//!        [--report out.tsv] [--baseline old.tsv] [--write-golden config]
+//!
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "MediapipeHandTrackingDll.h"
+#include "MediapipeHolisticTrackingDll.h"
+#include "LandmarkRecording.h"
+
+namespace
+{
+	const int kHolisticResultCount = 4;
+	const double kBaselineFpsDrop = 0.10;		// fraction of the baseline fps
+	const double kBaselineErrorGrowthPx = 0.5;
+
+	enum RegressionTrackerKind
+	{
+		RTK_Hand = 0,
+		RTK_Holistic = 1
+	};
+
+	struct RegressionClip
+	{
+		std::string m_Name;
+		std::string m_Video_Path;
+		std::string m_Golden_Paths[2];		// indexed by RegressionTrackerKind, empty when none
+	};
+
+	struct RegressionConfig
+	{
+		std::string m_Name;
+		RegressionTrackerKind m_Kind = RTK_Hand;
+		std::string m_Dll_Path;
+		std::string m_Model_Path;
+		int m_Cadence = 1;
+	};
+
+	struct RegressionManifest
+	{
+		int m_Version = 0;
+		std::vector<RegressionClip> m_Clips;
+		std::vector<RegressionConfig> m_Configs;
+	};
+
+	struct RegressionRow
+	{
+		std::string m_Config_Name;
+		uint64_t m_Frame_Count = 0;
+		uint64_t m_Detect_Count = 0;
+		uint64_t m_Detect_Failures = 0;
+		double m_Fps = 0.0;
+		double m_Latency_P50_Ms = 0.0;
+		double m_Latency_P90_Ms = 0.0;
+		double m_Latency_P99_Ms = 0.0;
+		double m_Latency_Max_Ms = 0.0;
+		double m_Mean_Error_Px = 0.0;		// over frames where both sides have the same landmarks
+		double m_P95_Error_Px = 0.0;
+		double m_Detection_Agreement = 0.0;	// fraction of frames with the same landmark count
+		double m_Result_Agreement = 0.0;	// fraction of frames with the same gestures / detect results
+		uint64_t m_Compared_Frames = 0;		// frames that had a golden record
+	};
+
+	// the result of the frame in the graph; the hand callbacks write into it
+	LandmarkRecord* g_CurrentRecord = nullptr;
+
+	void OnLandmarks(int image_index, PoseInfo* infos, int count)
+	{
+		(void)image_index;
+		if (g_CurrentRecord != nullptr && !g_CurrentRecord->SetLandmarks(infos, count))
+		{
+			printf("%d landmarks are more than a recording holds (%d); frame recorded without landmarks\n", count, LANDMARK_RECORDING_MAX_LANDMARKS);
+		}
+	}
+
+	void OnGestures(int image_index, int* recogn_result, int count)
+	{
+		(void)image_index;
+		if (g_CurrentRecord != nullptr && !g_CurrentRecord->SetGestures(recogn_result, count))
+		{
+			printf("%d gesture results are more than a recording holds (%d); frame recorded without them\n", count, LANDMARK_RECORDING_MAX_GESTURES);
+		}
+	}
+
+	std::string ResolvePath(const std::string& base_directory, const std::string& path)
+	{
+		if (path.empty() || base_directory.empty() || path[0] == '/' || path[0] == '\\' || (path.size() > 1 && path[1] == ':'))
+		{
+			return path;
+		}
+		return base_directory + "/" + path;
+	}
+
+	std::string DirectoryOf(const std::string& path)
+	{
+		size_t slash = path.find_last_of("/\\");
+		return slash == std::string::npos ? std::string() : path.substr(0, slash);
+	}
+
+	bool LoadManifest(const std::string& path, RegressionManifest& manifest)
+	{
+		std::ifstream file(path);
+		if (!file)
+		{
+			printf("Failed to open manifest %s\n", path.c_str());
+			return false;
+		}
+
+		std::string baseDirectory = DirectoryOf(path);
+		std::string line;
+		int lineNumber = 0;
+		while (std::getline(file, line))
+		{
+			lineNumber += 1;
+			size_t comment = line.find('#');
+			if (comment != std::string::npos)
+			{
+				line.resize(comment);
+			}
+
+			std::istringstream fields(line);
+			std::string keyword;
+			if (!(fields >> keyword))
+			{
+				continue;
+			}
+
+			if (keyword == "version")
+			{
+				fields >> manifest.m_Version;
+			}
+			else if (keyword == "clip")
+			{
+				RegressionClip clip;
+				std::string videoPath;
+				if (!(fields >> clip.m_Name >> videoPath))
+				{
+					printf("%s:%d: clip needs a name and a video path\n", path.c_str(), lineNumber);
+					return false;
+				}
+				clip.m_Video_Path = ResolvePath(baseDirectory, videoPath);
+
+				std::string option;
+				while (fields >> option)
+				{
+					if (option.compare(0, 5, "hand=") == 0)
+					{
+						clip.m_Golden_Paths[RTK_Hand] = ResolvePath(baseDirectory, option.substr(5));
+					}
+					else if (option.compare(0, 9, "holistic=") == 0)
+					{
+						clip.m_Golden_Paths[RTK_Holistic] = ResolvePath(baseDirectory, option.substr(9));
+					}
+					else
+					{
+						printf("%s:%d: unknown clip option %s\n", path.c_str(), lineNumber, option.c_str());
+						return false;
+					}
+				}
+				manifest.m_Clips.push_back(clip);
+			}
+			else if (keyword == "config")
+			{
+				RegressionConfig config;
+				std::string kind;
+				std::string dllPath;
+				std::string modelPath;
+				if (!(fields >> config.m_Name >> kind >> dllPath >> modelPath) || (kind != "hand" && kind != "holistic"))
+				{
+					printf("%s:%d: config needs a name, hand|holistic, a dll path and a model path\n", path.c_str(), lineNumber);
+					return false;
+				}
+				config.m_Kind = kind == "hand" ? RTK_Hand : RTK_Holistic;
+				config.m_Dll_Path = ResolvePath(baseDirectory, dllPath);
+				config.m_Model_Path = ResolvePath(baseDirectory, modelPath);
+
+				std::string option;
+				while (fields >> option)
+				{
+					if (option.compare(0, 8, "cadence=") == 0 && atoi(option.c_str() + 8) >= 1)
+					{
+						config.m_Cadence = atoi(option.c_str() + 8);
+					}
+					else
+					{
+						printf("%s:%d: unknown config option %s\n", path.c_str(), lineNumber, option.c_str());
+						return false;
+					}
+				}
+				manifest.m_Configs.push_back(config);
+			}
+			else
+			{
+				printf("%s:%d: unknown entry %s\n", path.c_str(), lineNumber, keyword.c_str());
+				return false;
+			}
+		}
+
+		if (manifest.m_Version <= 0 || manifest.m_Clips.empty() || manifest.m_Configs.empty())
+		{
+			printf("%s: needs a version, at least one clip and at least one config\n", path.c_str());
+			return false;
+		}
+		return true;
+	}
+
+	// Decodes the whole clip up front so the timed loop only sees the DLL
+	bool DecodeClip(const RegressionClip& clip, std::vector<cv::Mat>& frames)
+	{
+		frames.clear();
+		cv::VideoCapture capture(clip.m_Video_Path);
+		if (!capture.isOpened())
+		{
+			printf("Failed to open clip %s\n", clip.m_Video_Path.c_str());
+			return false;
+		}
+
+		cv::Mat frame;
+		while (capture.read(frame) && !frame.empty())
+		{
+			// a fresh buffer per frame, and continuous for the DLL
+			frames.push_back(frame.clone());
+		}
+		return !frames.empty();
+	}
+
+	double Percentile(const std::vector<double>& sorted, double fraction)
+	{
+		if (sorted.empty())
+		{
+			return 0.0;
+		}
+		size_t index = (size_t)(fraction * (double)(sorted.size() - 1) + 0.5);
+		return sorted[index < sorted.size() ? index : sorted.size() - 1];
+	}
+
+	double MeanLandmarkError(const LandmarkRecord& golden, const LandmarkRecord& result)
+	{
+		double sum = 0.0;
+		for (int i = 0; i < golden.m_Landmark_Count; ++i)
+		{
+			double dx = (double)result.m_Landmarks[i].x - (double)golden.m_Landmarks[i].x;
+			double dy = (double)result.m_Landmarks[i].y - (double)golden.m_Landmarks[i].y;
+			sum += sqrt(dx * dx + dy * dy);
+		}
+		return sum / (double)golden.m_Landmark_Count;
+	}
+
+	bool SameResults(const LandmarkRecord& golden, const LandmarkRecord& result, RegressionTrackerKind kind)
+	{
+		if (kind == RTK_Hand)
+		{
+			return memcmp(golden.m_Gesture_Result.m_Gesture_Recognition_Result, result.m_Gesture_Result.m_Gesture_Recognition_Result, sizeof(golden.m_Gesture_Result.m_Gesture_Recognition_Result)) == 0;
+		}
+		return golden.m_Gesture_Count == result.m_Gesture_Count && memcmp(golden.m_Gestures, result.m_Gestures, golden.m_Gesture_Count * sizeof(int)) == 0;
+	}
+
+	class RegressionTracker
+	{
+	public:
+		RegressionTracker()
+			: m_Kind(RTK_Hand), m_IsInitialized(false)
+		{
+		}
+
+		virtual~RegressionTracker()
+		{
+			Release();
+		}
+
+	public:
+		bool Start(const RegressionConfig& config)
+		{
+			m_Kind = config.m_Kind;
+			if (m_Kind == RTK_Hand)
+			{
+				if (!m_HandTrackingDll.LoadMediapipeHandTrackingDll(config.m_Dll_Path) || !m_HandTrackingDll.GetAllFunctions())
+				{
+					printf("Failed to load %s\n", config.m_Dll_Path.c_str());
+					return false;
+				}
+				if (!m_HandTrackingDll.m_Mediapipe_Hand_Tracking_Init(config.m_Model_Path.c_str()))
+				{
+					printf("Mediapipe_Hand_Tracking_Init failed for %s\n", config.m_Model_Path.c_str());
+					m_HandTrackingDll.UnLoadMediapipeHandTrackingDll();
+					return false;
+				}
+				m_HandTrackingDll.m_Mediapipe_Hand_Tracking_Reigeter_Landmarks_Callback(OnLandmarks);
+				m_HandTrackingDll.m_Mediapipe_Hand_Tracking_Register_Gesture_Result_Callback(OnGestures);
+			}
+			else
+			{
+				if (!m_HolisticTrackingDll.LoadMediapipeHolisticTrackingDll(config.m_Dll_Path) || !m_HolisticTrackingDll.GetAllFunctions())
+				{
+					printf("Failed to load %s\n", config.m_Dll_Path.c_str());
+					return false;
+				}
+				// only the pose and hand streams feed the detect results
+				if (!m_HolisticTrackingDll.m_MediapipeHolisticTrackingInit(config.m_Model_Path.c_str(), false, true, true, false))
+				{
+					printf("MediapipeHolisticTrackingInit failed for %s\n", config.m_Model_Path.c_str());
+					m_HolisticTrackingDll.UnLoadMediapipeHolisticTrackingDll();
+					return false;
+				}
+			}
+			m_IsInitialized = true;
+			return true;
+		}
+
+		// Runs one frame and fills record with its result
+		bool Detect(cv::Mat& frame, LandmarkRecord& record)
+		{
+			record = LandmarkRecord();
+			if (m_Kind == RTK_Hand)
+			{
+				g_CurrentRecord = &record;
+				int detected = m_HandTrackingDll.m_Mediapipe_Hand_Tracking_Detect_Frame_Direct(frame.cols, frame.rows, (void*)frame.data, record.m_Gesture_Result);
+				g_CurrentRecord = nullptr;
+				return detected != 0;
+			}
+
+			int detectResult[kHolisticResultCount] = { -1, -1, -1, -1 };
+			int detected = m_HolisticTrackingDll.m_MediapipeHolisticTrackingDetectFrameDirect(frame.cols, frame.rows, (void*)frame.data, detectResult, false);
+			record.SetGestures(detectResult, kHolisticResultCount);
+			return detected != 0;
+		}
+
+		void Release()
+		{
+			if (!m_IsInitialized)
+			{
+				return;
+			}
+			if (m_Kind == RTK_Hand)
+			{
+				m_HandTrackingDll.m_Mediapipe_Hand_Tracking_Release();
+				m_HandTrackingDll.UnLoadMediapipeHandTrackingDll();
+			}
+			else
+			{
+				m_HolisticTrackingDll.m_MediapipeHolisticTrackingRelease();
+				m_HolisticTrackingDll.UnLoadMediapipeHolisticTrackingDll();
+			}
+			m_IsInitialized = false;
+		}
+
+	private:
+		RegressionTrackerKind m_Kind;
+		bool m_IsInitialized;
+		MediapipeHandTrackingDll m_HandTrackingDll;
+		MediapipeHolisticTrackingDll m_HolisticTrackingDll;
+	};
+
+	// Plays every clip through one configuration; with write_golden the results become the
+	// goldens of the configuration's kind instead of being compared with them
+	bool RunConfig(const RegressionManifest& manifest, const RegressionConfig& config, int warmup_frames, bool write_golden, RegressionRow& row)
+	{
+		row = RegressionRow();
+		row.m_Config_Name = config.m_Name;
+
+		RegressionTracker tracker;
+		if (!tracker.Start(config))
+		{
+			return false;
+		}
+
+		std::vector<double> latencies;
+		std::vector<double> errors;
+		uint64_t detectionMatches = 0;
+		uint64_t resultMatches = 0;
+		double resultSeconds = 0.0;
+		bool isComplete = true;
+
+		std::vector<cv::Mat> frames;
+		for (const RegressionClip& clip : manifest.m_Clips)
+		{
+			const std::string& goldenPath = clip.m_Golden_Paths[config.m_Kind];
+			if (goldenPath.empty())
+			{
+				continue;
+			}
+			if (!DecodeClip(clip, frames))
+			{
+				isComplete = false;
+				continue;
+			}
+
+			LandmarkReplay golden;
+			LandmarkRecorder recorder;
+			if (write_golden)
+			{
+				// LandmarkRecorder appends to a matching file, a golden has to start over
+				remove(goldenPath.c_str());
+				if (!recorder.Open(goldenPath))
+				{
+					printf("Failed to create golden %s\n", goldenPath.c_str());
+					isComplete = false;
+					continue;
+				}
+			}
+			else if (!golden.Open(goldenPath))
+			{
+				printf("Missing golden %s for clip %s\n", goldenPath.c_str(), clip.m_Name.c_str());
+				isComplete = false;
+				continue;
+			}
+
+			LandmarkRecord result;
+			for (size_t i = 0; i < frames.size(); ++i)
+			{
+				auto frameStart = std::chrono::steady_clock::now();
+				if (i % (size_t)config.m_Cadence == 0)
+				{
+					if (!tracker.Detect(frames[i], result))
+					{
+						row.m_Detect_Failures += 1;
+					}
+					double detectMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count();
+					if (i >= (size_t)warmup_frames)
+					{
+						latencies.push_back(detectMs);
+					}
+					row.m_Detect_Count += 1;
+				}
+				resultSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - frameStart).count();
+				row.m_Frame_Count += 1;
+
+				result.m_Image_Index = (int32_t)i;
+				result.m_Timestamp_Us = (int64_t)i;
+				if (write_golden)
+				{
+					recorder.Append(result);
+					continue;
+				}
+
+				const LandmarkRecord* expected = golden.GetFrame(i);
+				if (expected == nullptr)
+				{
+					continue;
+				}
+				row.m_Compared_Frames += 1;
+				if (expected->m_Landmark_Count == result.m_Landmark_Count)
+				{
+					detectionMatches += 1;
+					if (expected->m_Landmark_Count > 0)
+					{
+						errors.push_back(MeanLandmarkError(*expected, result));
+					}
+				}
+				if (SameResults(*expected, result, config.m_Kind))
+				{
+					resultMatches += 1;
+				}
+			}
+
+			if (write_golden)
+			{
+				recorder.Close();
+				printf("Wrote %llu frames to %s\n", (unsigned long long)recorder.GetFrameCount(), goldenPath.c_str());
+			}
+			else if (golden.GetFrameCount() != frames.size())
+			{
+				printf("Clip %s has %llu frames, its golden %llu\n", clip.m_Name.c_str(), (unsigned long long)frames.size(), (unsigned long long)golden.GetFrameCount());
+			}
+		}
+
+		tracker.Release();
+
+		std::sort(latencies.begin(), latencies.end());
+		std::sort(errors.begin(), errors.end());
+		row.m_Fps = resultSeconds > 0.0 ? (double)row.m_Frame_Count / resultSeconds : 0.0;
+		row.m_Latency_P50_Ms = Percentile(latencies, 0.50);
+		row.m_Latency_P90_Ms = Percentile(latencies, 0.90);
+		row.m_Latency_P99_Ms = Percentile(latencies, 0.99);
+		row.m_Latency_Max_Ms = latencies.empty() ? 0.0 : latencies.back();
+		double errorSum = 0.0;
+		for (double error : errors)
+		{
+			errorSum += error;
+		}
+		row.m_Mean_Error_Px = errors.empty() ? 0.0 : errorSum / (double)errors.size();
+		row.m_P95_Error_Px = Percentile(errors, 0.95);
+		if (row.m_Compared_Frames > 0)
+		{
+			row.m_Detection_Agreement = (double)detectionMatches / (double)row.m_Compared_Frames;
+			row.m_Result_Agreement = (double)resultMatches / (double)row.m_Compared_Frames;
+		}
+		return isComplete;
+	}
+
+	void PrintRows(const std::vector<RegressionRow>& rows, int manifest_version)
+	{
+		printf("Regression set version %d\n", manifest_version);
+		printf("%-24s %8s %8s %8s %8s %8s %8s %9s %9s %9s %9s\n", "config", "frames", "fps", "p50 ms", "p90 ms", "p99 ms", "max ms", "err px", "p95 px", "detect %", "result %");
+		for (const RegressionRow& row : rows)
+		{
+			printf("%-24s %8llu %8.1f %8.2f %8.2f %8.2f %8.2f %9.3f %9.3f %9.2f %9.2f\n", row.m_Config_Name.c_str(), (unsigned long long)row.m_Frame_Count, row.m_Fps,
+				row.m_Latency_P50_Ms, row.m_Latency_P90_Ms, row.m_Latency_P99_Ms, row.m_Latency_Max_Ms,
+				row.m_Mean_Error_Px, row.m_P95_Error_Px, row.m_Detection_Agreement * 100.0, row.m_Result_Agreement * 100.0);
+			if (row.m_Detect_Failures > 0)
+			{
+				printf("%-24s %llu of %llu DLL calls failed\n", "", (unsigned long long)row.m_Detect_Failures, (unsigned long long)row.m_Detect_Count);
+			}
+		}
+	}
+
+	bool WriteReport(const std::string& path, const std::vector<RegressionRow>& rows, int manifest_version)
+	{
+		FILE* file = fopen(path.c_str(), "w");
+		if (file == nullptr)
+		{
+			printf("Failed to write %s\n", path.c_str());
+			return false;
+		}
+		fprintf(file, "# version\t%d\n", manifest_version);
+		fprintf(file, "config\tframes\tfps\tp50_ms\tp90_ms\tp99_ms\tmax_ms\tmean_error_px\tp95_error_px\tdetection_agreement\tresult_agreement\n");
+		for (const RegressionRow& row : rows)
+		{
+			fprintf(file, "%s\t%llu\t%.3f\t%.4f\t%.4f\t%.4f\t%.4f\t%.5f\t%.5f\t%.5f\t%.5f\n", row.m_Config_Name.c_str(), (unsigned long long)row.m_Frame_Count, row.m_Fps,
+				row.m_Latency_P50_Ms, row.m_Latency_P90_Ms, row.m_Latency_P99_Ms, row.m_Latency_Max_Ms,
+				row.m_Mean_Error_Px, row.m_P95_Error_Px, row.m_Detection_Agreement, row.m_Result_Agreement);
+		}
+		fclose(file);
+		return true;
+	}
+
+	// Returns true when any configuration regressed against the baseline report
+	bool CompareWithBaseline(const std::string& path, const std::vector<RegressionRow>& rows, int manifest_version)
+	{
+		std::ifstream file(path);
+		if (!file)
+		{
+			printf("Failed to open baseline %s\n", path.c_str());
+			return true;
+		}
+
+		bool isRegressed = false;
+		std::string line;
+		while (std::getline(file, line))
+		{
+			if (line.compare(0, 10, "# version\t") == 0)
+			{
+				int baselineVersion = atoi(line.c_str() + 10);
+				if (baselineVersion != manifest_version)
+				{
+					printf("Baseline is from regression set version %d, this run %d; accuracy is not comparable\n", baselineVersion, manifest_version);
+				}
+				continue;
+			}
+
+			std::istringstream fields(line);
+			RegressionRow old;
+			if (!(fields >> old.m_Config_Name >> old.m_Frame_Count >> old.m_Fps >> old.m_Latency_P50_Ms >> old.m_Latency_P90_Ms >> old.m_Latency_P99_Ms
+				>> old.m_Latency_Max_Ms >> old.m_Mean_Error_Px))
+			{
+				continue;
+			}
+
+			for (const RegressionRow& row : rows)
+			{
+				if (row.m_Config_Name != old.m_Config_Name)
+				{
+					continue;
+				}
+				if (row.m_Fps < old.m_Fps * (1.0 - kBaselineFpsDrop))
+				{
+					printf("REGRESSION %s: %.1f fps, baseline %.1f\n", row.m_Config_Name.c_str(), row.m_Fps, old.m_Fps);
+					isRegressed = true;
+				}
+				if (row.m_Mean_Error_Px > old.m_Mean_Error_Px + kBaselineErrorGrowthPx)
+				{
+					printf("REGRESSION %s: %.3f px mean error, baseline %.3f\n", row.m_Config_Name.c_str(), row.m_Mean_Error_Px, old.m_Mean_Error_Px);
+					isRegressed = true;
+				}
+			}
+		}
+		return isRegressed;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		printf("Usage: MediapipeRegressionRunner <manifest> [--config name] [--warmup frames] [--report out.tsv] [--baseline old.tsv] [--write-golden config]\n");
+		return 2;
+	}
+
+	std::string onlyConfig;
+	std::string reportPath;
+	std::string baselinePath;
+	std::string goldenConfig;
+	int warmupFrames = 5;
+	for (int i = 2; i + 1 < argc; i += 2)
+	{
+		if (strcmp(argv[i], "--config") == 0)
+		{
+			onlyConfig = argv[i + 1];
+		}
+		else if (strcmp(argv[i], "--warmup") == 0)
+		{
+			warmupFrames = atoi(argv[i + 1]);
+		}
+		else if (strcmp(argv[i], "--report") == 0)
+		{
+			reportPath = argv[i + 1];
+		}
+		else if (strcmp(argv[i], "--baseline") == 0)
+		{
+			baselinePath = argv[i + 1];
+		}
+		else if (strcmp(argv[i], "--write-golden") == 0)
+		{
+			goldenConfig = argv[i + 1];
+		}
+		else
+		{
+			printf("Unknown option %s\n", argv[i]);
+			return 2;
+		}
+	}
+
+	RegressionManifest manifest;
+	if (!LoadManifest(argv[1], manifest))
+	{
+		return 2;
+	}
+
+	if (!goldenConfig.empty())
+	{
+		for (const RegressionConfig& config : manifest.m_Configs)
+		{
+			if (config.m_Name == goldenConfig)
+			{
+				RegressionRow row;
+				return RunConfig(manifest, config, warmupFrames, true, row) ? 0 : 1;
+			}
+		}
+		printf("No config named %s\n", goldenConfig.c_str());
+		return 2;
+	}
+
+	bool isComplete = true;
+	std::vector<RegressionRow> rows;
+	for (const RegressionConfig& config : manifest.m_Configs)
+	{
+		if (!onlyConfig.empty() && config.m_Name != onlyConfig)
+		{
+			continue;
+		}
+		RegressionRow row;
+		if (!RunConfig(manifest, config, warmupFrames, false, row))
+		{
+			isComplete = false;
+		}
+		rows.push_back(row);
+	}
+
+	PrintRows(rows, manifest.m_Version);
+	if (!reportPath.empty() && !WriteReport(reportPath, rows, manifest.m_Version))
+	{
+		isComplete = false;
+	}
+	if (!baselinePath.empty() && CompareWithBaseline(baselinePath, rows, manifest.m_Version))
+	{
+		return 1;
+	}
+	return isComplete ? 0 : 1;
+}
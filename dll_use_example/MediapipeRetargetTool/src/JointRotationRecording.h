@@ -0,0 +1,53 @@
+#ifndef JOINT_ROTATION_RECORDING_H
+#define JOINT_ROTATION_RECORDING_H
+
+#include <cstdint>
+
+#include "MediapipeHandTrackingDll.h"
+
+//!
+//! @brief - Fixed-stride binary stream of per-frame joint rotations, as written by MediapipeRetargetTool
+//!
+//! Same layout rules as LandmarkRecording: a JointRotationRecordingHeader followed by
+//! JointRotationRecord entries of identical size, frame i at sizeof(header) + i *
+//! record_bytes, one record per frame of the source recording in the same order. A
+//! player can stream it front to back or map it and seek by index.
+//!
+//! Every landmark gets the unit quaternion (x, y, z, w) that rotates +z onto its bone,
+//! in the landmark coordinate space of the source recording (z taken as 0): the bone
+//! from a finger joint to the next joint of the same finger, from the wrist to the
+//! middle finger knuckle, and the fingertips repeat their last bone.
+//!
+//! Records are written in the host's byte order; the header stores the record size
+//! and an endianness marker so a mismatched file is rejected rather than misread.
+//!
+
+#define JOINT_ROTATION_RECORDING_MAGIC 0x5252544D		// "MTRR"
+#define JOINT_ROTATION_RECORDING_VERSION 2
+#define JOINT_ROTATION_RECORDING_BYTE_ORDER_MARK 0x01020304
+#define JOINT_ROTATION_RECORDING_MAX_HANDS MAX_HAND_COUNT
+#define JOINT_ROTATION_RECORDING_HAND_JOINTS HAND_KEYPOINT_COUNT
+
+struct JointRotationRecordingHeader
+{
+	uint32_t m_Magic;
+	uint32_t m_Version;
+	uint32_t m_Byte_Order_Mark;
+	uint32_t m_Record_Bytes;
+	uint32_t m_Max_Hands;
+	uint32_t m_Hand_Joints;
+	uint32_t m_Solver_Type;		// IKSolverType the rotations were solved with
+	uint32_t m_Reserved;
+};
+
+struct JointRotationRecord
+{
+	int64_t m_Timestamp_Us;		// copied from the source record
+	int32_t m_Image_Index;
+	int32_t m_Hand_Count;		// -1 when the source frame had no landmarks
+	float m_Rotations[JOINT_ROTATION_RECORDING_MAX_HANDS * JOINT_ROTATION_RECORDING_HAND_JOINTS][4];
+	float m_Mean_Residual;		// fingertip distance to the recorded tip after the solve
+	int32_t m_Reserved;
+};
+
+#endif // !JOINT_ROTATION_RECORDING_H
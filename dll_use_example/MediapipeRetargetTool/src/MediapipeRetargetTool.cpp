@@ -0,0 +1,444 @@
+//!
+//! @brief - Offline IK retargeting of a recorded session, on every core
+//!
+//! Maps a LandmarkRecording, solves every finger of every recorded hand with the
+//! native IK module and writes the bone rotations as a JointRotationRecording, one
+//! record per source frame. Frames are cut into chunks of consecutive frames; each
+//! worker starts with an equal run of chunks and, once its own run is done, steals
+//! from the back of the longest remaining run, so slow sections (two hands, many
+//! iterations) do not leave cores idle.
+//!
+//! Inside a chunk every finger is warm-started from its solution of the previous
+//! frame, like IKSolverState in IKSolver.js, and its quaternions are carried along;
+//! the first frame of a chunk, and a hand that reappears, are seeded from the recorded
+//! pose. Chunks are independent, so the output does not depend on the thread count
+//! as long as the chunk size stays the same.
+//!
+//! Build together with ../../MediapipePackageDllTest/src/LandmarkRecording.cpp and
+//! ../../../dll/ik_solver/ik_solver.cpp, with both directories on the include path.
+//! No tracking DLL is loaded.
+//!
+//! Usage: MediapipeRetargetTool <recording> <output> [--solver ccd|fabrik] [--threads N]
+//!        [--chunk frames] [--iterations N] [--tolerance T]
+//!
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "LandmarkRecording.h"
+#include "JointRotationRecording.h"
+#include "ik_solver.h"
+
+namespace
+{
+	const int kFingerCount = 5;
+	const int kFingerJoints = 5;
+	// the wrist takes the rotation of the middle finger's first bone
+	const int kWristFinger = 2;
+
+	struct RetargetOptions
+	{
+		IKSolverType m_Solver_Type = IKST_FABRIK;
+		int m_Thread_Count = 0;				// 0: one per core
+		uint64_t m_Chunk_Frames = 512;
+		int m_Iterations = 10;
+		float m_Tolerance = 0.5f;			// landmark units, i.e. pixels
+	};
+
+	struct FingerWarmState
+	{
+		IKVector3 m_Joints[kFingerJoints];
+		IKQuaternion m_Rotations[kFingerJoints];
+	};
+
+	struct HandWarmState
+	{
+		bool m_Is_Valid = false;
+		FingerWarmState m_Fingers[kFingerCount];
+	};
+
+	// A worker's run of chunks; the owner takes from the front, thieves from the back
+	struct ChunkRun
+	{
+		std::mutex m_Mutex;
+		uint64_t m_Next = 0;
+		uint64_t m_End = 0;
+	};
+
+	int FingerLandmark(int finger, int joint)
+	{
+		return joint == 0 ? 0 : finger * 4 + joint;
+	}
+
+	int SeekFile(FILE* file, uint64_t offset, int origin)
+	{
+#if defined(WINDOWS)
+		return _fseeki64(file, (long long)offset, origin);
+#else
+		return fseeko(file, (off_t)offset, origin);
+#endif
+	}
+
+	// Keep the recorded root and bone lengths, but take each bone's direction from the
+	// previous solution, so the solve starts from last frame's pose
+	void SeedFromPrevious(IKVector3* joints, const IKVector3* previous)
+	{
+		IKVector3 original = joints[0];
+		IKVector3 seeded = joints[0];
+		for (int i = 1; i < kFingerJoints; ++i)
+		{
+			IKVector3 current = joints[i];
+			float bx = current.x - original.x, by = current.y - original.y, bz = current.z - original.z;
+			float length = std::sqrt(bx * bx + by * by + bz * bz);
+			float dx = previous[i].x - previous[i - 1].x, dy = previous[i].y - previous[i - 1].y, dz = previous[i].z - previous[i - 1].z;
+			float d = std::sqrt(dx * dx + dy * dy + dz * dz);
+			if (d > 0.0f)
+			{
+				seeded = IKVector3{ seeded.x + dx / d * length, seeded.y + dy / d * length, seeded.z + dz / d * length };
+			}
+			else
+			{
+				seeded = IKVector3{ seeded.x + bx, seeded.y + by, seeded.z + bz };
+			}
+			joints[i] = seeded;
+			original = current;
+		}
+	}
+
+	class Retargeter
+	{
+	public:
+		Retargeter(LandmarkReplay& replay, FILE* output, const RetargetOptions& options)
+			: m_Replay(replay)
+			, m_Output(output)
+			, m_Options(options)
+			, m_ChunkCount((replay.GetFrameCount() + options.m_Chunk_Frames - 1) / options.m_Chunk_Frames)
+			, m_StolenCount(0)
+			, m_IsFailed(false)
+		{
+		}
+
+		bool Run(int thread_count)
+		{
+			m_Runs = std::vector<ChunkRun>(thread_count);
+			for (int i = 0; i < thread_count; ++i)
+			{
+				m_Runs[i].m_Next = m_ChunkCount * i / thread_count;
+				m_Runs[i].m_End = m_ChunkCount * (i + 1) / thread_count;
+			}
+			m_ResidualSums.assign(thread_count, 0.0);
+			m_SolvedCounts.assign(thread_count, 0);
+
+			std::vector<std::thread> workers;
+			for (int i = 0; i < thread_count; ++i)
+			{
+				workers.push_back(std::thread(&Retargeter::WorkerLoop, this, i));
+			}
+			for (size_t i = 0; i < workers.size(); ++i)
+			{
+				workers[i].join();
+			}
+			return !m_IsFailed.load();
+		}
+
+		uint64_t GetChunkCount() { return m_ChunkCount; }
+		uint64_t GetStolenCount() { return m_StolenCount.load(); }
+
+		double GetMeanResidual()
+		{
+			double sum = 0.0;
+			uint64_t count = 0;
+			for (size_t i = 0; i < m_ResidualSums.size(); ++i)
+			{
+				sum += m_ResidualSums[i];
+				count += m_SolvedCounts[i];
+			}
+			return count > 0 ? sum / (double)count : 0.0;
+		}
+
+	private:
+		void WorkerLoop(int worker)
+		{
+			std::vector<JointRotationRecord> records;
+			uint64_t chunk = 0;
+			while (!m_IsFailed.load(std::memory_order_relaxed) && TakeChunk(worker, chunk))
+			{
+				RetargetChunk(worker, chunk, records);
+			}
+		}
+
+		bool TakeChunk(int worker, uint64_t& chunk)
+		{
+			{
+				ChunkRun& own = m_Runs[worker];
+				std::lock_guard<std::mutex> lock(own.m_Mutex);
+				if (own.m_Next < own.m_End)
+				{
+					chunk = own.m_Next++;
+					return true;
+				}
+			}
+
+			// Steal the last chunk of the longest run; the victim keeps its front, which
+			// it is already working through
+			while (true)
+			{
+				int victim = -1;
+				uint64_t longest = 0;
+				for (size_t i = 0; i < m_Runs.size(); ++i)
+				{
+					std::lock_guard<std::mutex> lock(m_Runs[i].m_Mutex);
+					uint64_t remaining = m_Runs[i].m_End - m_Runs[i].m_Next;
+					if (remaining > longest)
+					{
+						longest = remaining;
+						victim = (int)i;
+					}
+				}
+				if (victim < 0)
+				{
+					return false;
+				}
+				std::lock_guard<std::mutex> lock(m_Runs[victim].m_Mutex);
+				if (m_Runs[victim].m_Next < m_Runs[victim].m_End)
+				{
+					chunk = --m_Runs[victim].m_End;
+					m_StolenCount.fetch_add(1, std::memory_order_relaxed);
+					return true;
+				}
+			}
+		}
+
+		void RetargetChunk(int worker, uint64_t chunk, std::vector<JointRotationRecord>& records)
+		{
+			uint64_t first = chunk * m_Options.m_Chunk_Frames;
+			uint64_t last = first + m_Options.m_Chunk_Frames;
+			if (last > m_Replay.GetFrameCount())
+			{
+				last = m_Replay.GetFrameCount();
+			}
+
+			// warm start never crosses a chunk boundary
+			HandWarmState hands[JOINT_ROTATION_RECORDING_MAX_HANDS];
+			records.resize((size_t)(last - first));
+			for (uint64_t i = first; i < last; ++i)
+			{
+				RetargetFrame(worker, *m_Replay.GetFrame(i), hands, records[(size_t)(i - first)]);
+			}
+
+			// fixed-stride output: each chunk lands at its own offset, in any order
+			std::lock_guard<std::mutex> lock(m_OutputMutex);
+			if (SeekFile(m_Output, sizeof(JointRotationRecordingHeader) + first * sizeof(JointRotationRecord), SEEK_SET) != 0
+				|| fwrite(records.data(), sizeof(JointRotationRecord), records.size(), m_Output) != records.size())
+			{
+				m_IsFailed.store(true);
+			}
+		}
+
+		void RetargetFrame(int worker, const LandmarkRecord& source, HandWarmState* hands, JointRotationRecord& record)
+		{
+			memset((void*)&record, 0, sizeof(record));
+			record.m_Timestamp_Us = source.m_Timestamp_Us;
+			record.m_Image_Index = source.m_Image_Index;
+			for (int i = 0; i < JOINT_ROTATION_RECORDING_MAX_HANDS * JOINT_ROTATION_RECORDING_HAND_JOINTS; ++i)
+			{
+				record.m_Rotations[i][3] = 1.0f;
+			}
+
+			int handCount = source.m_Landmark_Count < 0 ? -1 : source.m_Landmark_Count / JOINT_ROTATION_RECORDING_HAND_JOINTS;
+			if (handCount > JOINT_ROTATION_RECORDING_MAX_HANDS)
+			{
+				handCount = JOINT_ROTATION_RECORDING_MAX_HANDS;
+			}
+			record.m_Hand_Count = handCount;
+			for (int h = handCount < 0 ? 0 : handCount; h < JOINT_ROTATION_RECORDING_MAX_HANDS; ++h)
+			{
+				// a hand that reappears is seeded from its recorded pose again
+				hands[h].m_Is_Valid = false;
+			}
+
+			float residual = 0.0f;
+			for (int h = 0; h < handCount; ++h)
+			{
+				const PoseInfo* landmarks = source.m_Landmarks + h * JOINT_ROTATION_RECORDING_HAND_JOINTS;
+				float(*rotations)[4] = record.m_Rotations + h * JOINT_ROTATION_RECORDING_HAND_JOINTS;
+				for (int f = 0; f < kFingerCount; ++f)
+				{
+					FingerWarmState& finger = hands[h].m_Fingers[f];
+					IKVector3 joints[kFingerJoints];
+					for (int j = 0; j < kFingerJoints; ++j)
+					{
+						const PoseInfo& landmark = landmarks[FingerLandmark(f, j)];
+						joints[j] = IKVector3{ landmark.x, landmark.y, 0.0f };
+					}
+					IKVector3 target = joints[kFingerJoints - 1];
+
+					if (hands[h].m_Is_Valid)
+					{
+						// the carried quaternions describe exactly these seeded directions
+						SeedFromPrevious(joints, finger.m_Joints);
+					}
+					else
+					{
+						IKSolver::InitBoneRotations(joints, kFingerJoints, finger.m_Rotations);
+					}
+					IKSolver::Solve(m_Options.m_Solver_Type, joints, kFingerJoints, target, m_Options.m_Iterations, m_Options.m_Tolerance, finger.m_Rotations);
+					memcpy(finger.m_Joints, joints, sizeof(joints));
+
+					float dx = joints[kFingerJoints - 1].x - target.x, dy = joints[kFingerJoints - 1].y - target.y;
+					residual += std::sqrt(dx * dx + dy * dy);
+
+					for (int j = 1; j < kFingerJoints; ++j)
+					{
+						memcpy(rotations[FingerLandmark(f, j)], &finger.m_Rotations[j], sizeof(float) * 4);
+					}
+					if (f == kWristFinger)
+					{
+						memcpy(rotations[0], &finger.m_Rotations[0], sizeof(float) * 4);
+					}
+				}
+				hands[h].m_Is_Valid = true;
+			}
+
+			if (handCount > 0)
+			{
+				record.m_Mean_Residual = residual / (float)(handCount * kFingerCount);
+				m_ResidualSums[worker] += residual;
+				m_SolvedCounts[worker] += handCount * kFingerCount;
+			}
+		}
+
+	private:
+		LandmarkReplay& m_Replay;
+		FILE* m_Output;
+		RetargetOptions m_Options;
+		uint64_t m_ChunkCount;
+
+		std::vector<ChunkRun> m_Runs;
+		std::mutex m_OutputMutex;
+		std::atomic<uint64_t> m_StolenCount;
+		std::atomic<bool> m_IsFailed;
+		// per worker, summed after the join
+		std::vector<double> m_ResidualSums;
+		std::vector<uint64_t> m_SolvedCounts;
+	};
+
+	bool ParseOptions(int argc, char* argv[], RetargetOptions& options)
+	{
+		for (int i = 3; i < argc; ++i)
+		{
+			std::string arg = argv[i];
+			if (i + 1 >= argc)
+			{
+				return false;
+			}
+			const char* value = argv[++i];
+			if (arg == "--solver")
+			{
+				if (strcmp(value, "ccd") == 0)
+				{
+					options.m_Solver_Type = IKST_CCD;
+				}
+				else if (strcmp(value, "fabrik") == 0)
+				{
+					options.m_Solver_Type = IKST_FABRIK;
+				}
+				else
+				{
+					return false;
+				}
+			}
+			else if (arg == "--threads")
+			{
+				options.m_Thread_Count = atoi(value);
+			}
+			else if (arg == "--chunk")
+			{
+				options.m_Chunk_Frames = (uint64_t)strtoull(value, nullptr, 10);
+			}
+			else if (arg == "--iterations")
+			{
+				options.m_Iterations = atoi(value);
+			}
+			else if (arg == "--tolerance")
+			{
+				options.m_Tolerance = (float)atof(value);
+			}
+			else
+			{
+				return false;
+			}
+		}
+		return options.m_Chunk_Frames > 0 && options.m_Iterations > 0 && options.m_Thread_Count >= 0;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	RetargetOptions options;
+	if (argc < 3 || !ParseOptions(argc, argv, options))
+	{
+		printf("Usage: %s <recording> <output> [--solver ccd|fabrik] [--threads N] [--chunk frames] [--iterations N] [--tolerance T]\n", argv[0]);
+		return 1;
+	}
+
+	LandmarkReplay replay;
+	if (!replay.Open(argv[1]))
+	{
+		printf("Cannot open recording %s\n", argv[1]);
+		return 1;
+	}
+
+	FILE* output = fopen(argv[2], "wb");
+	if (output == nullptr)
+	{
+		printf("Cannot create %s\n", argv[2]);
+		return 1;
+	}
+	JointRotationRecordingHeader header;
+	memset(&header, 0, sizeof(header));
+	header.m_Magic = JOINT_ROTATION_RECORDING_MAGIC;
+	header.m_Version = JOINT_ROTATION_RECORDING_VERSION;
+	header.m_Byte_Order_Mark = JOINT_ROTATION_RECORDING_BYTE_ORDER_MARK;
+	header.m_Record_Bytes = sizeof(JointRotationRecord);
+	header.m_Max_Hands = JOINT_ROTATION_RECORDING_MAX_HANDS;
+	header.m_Hand_Joints = JOINT_ROTATION_RECORDING_HAND_JOINTS;
+	header.m_Solver_Type = (uint32_t)options.m_Solver_Type;
+	if (fwrite(&header, sizeof(header), 1, output) != 1)
+	{
+		printf("Cannot write %s\n", argv[2]);
+		fclose(output);
+		return 1;
+	}
+
+	int threadCount = options.m_Thread_Count > 0 ? options.m_Thread_Count : (int)std::thread::hardware_concurrency();
+	if (threadCount <= 0)
+	{
+		threadCount = 1;
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	Retargeter retargeter(replay, output, options);
+	bool isOk = retargeter.Run(threadCount);
+	isOk = fclose(output) == 0 && isOk;
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	if (!isOk)
+	{
+		printf("Writing %s failed\n", argv[2]);
+		return 1;
+	}
+
+	printf("%llu frames in %llu chunks on %d threads (%llu stolen): %.2f s, %.0f frames/s, mean residual %.4f\n",
+		(unsigned long long)replay.GetFrameCount(), (unsigned long long)retargeter.GetChunkCount(), threadCount,
+		(unsigned long long)retargeter.GetStolenCount(), seconds, seconds > 0.0 ? (double)replay.GetFrameCount() / seconds : 0.0,
+		retargeter.GetMeanResidual());
+	return 0;
+}
@@ -0,0 +1,421 @@
+//!
+//! @brief - Out-of-process host for the hand tracking DLL
+//!
+//! Loads Mediapipe_Hand_Tracking once, keeps its graph warm and serves frames from
+//! any number of client processes through the shared-memory channels described in
+//! TrackingServiceProtocol.h. Clients link MediapipeHandTrackingRemote instead of the
+//! DLL, so a crash in the graph takes down this process only, and several
+//! applications share one loaded model set.
+//!
+//! Given a tcp_port it also serves MediapipeHandTrackingNetwork clients on other
+//! machines (TrackingNetworkProtocol.h). Each TCP connection gets a private channel
+//! outside the segment that the graph loop serves in turn with the shared-memory
+//! ones; a connection thread only moves bytes between its socket and its channel.
+//!
+//! Build together with ../../MediapipePackageDllTest/src/DynamicModuleLoader.cpp and
+//! MediapipeHandTrackingDll.cpp, with that directory on the include path.
+//!
+//! Usage: MediapipeTrackingService <dll_path> <model_path> [service_name] [channels] [max_width] [max_height] [tcp_port]
+//!
+
+// first: winsock2.h has to come before Windows.h
+#include "TrackingNetworkProtocol.h"
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "MediapipeHandTrackingDll.h"
+#include "TrackingServiceProtocol.h"
+
+namespace
+{
+	volatile std::sig_atomic_t g_StopRequested = 0;
+
+	// the channel whose frame is in the graph; the callbacks write into it
+	TrackingChannel* g_CurrentChannel = nullptr;
+
+	void OnStopSignal(int)
+	{
+		g_StopRequested = 1;
+	}
+
+	void OnLandmarks(int image_index, PoseInfo* infos, int count)
+	{
+		(void)image_index;
+		TrackingChannel* channel = g_CurrentChannel;
+		if (channel == nullptr)
+		{
+			return;
+		}
+		int copyCount = count < TRACKING_SERVICE_MAX_LANDMARKS ? count : TRACKING_SERVICE_MAX_LANDMARKS;
+		memcpy(channel->m_Landmarks, infos, copyCount * sizeof(PoseInfo));
+		channel->m_Landmark_Count = copyCount;
+	}
+
+	void OnGestures(int image_index, int* recogn_result, int count)
+	{
+		(void)image_index;
+		TrackingChannel* channel = g_CurrentChannel;
+		if (channel == nullptr)
+		{
+			return;
+		}
+		int copyCount = count < TRACKING_SERVICE_MAX_GESTURES ? count : TRACKING_SERVICE_MAX_GESTURES;
+		memcpy(channel->m_Gestures, recogn_result, copyCount * sizeof(int));
+		channel->m_Gesture_Count = copyCount;
+	}
+
+	void ServeRequest(MediapipeHandTrackingDll& handTrackingDll, TrackingChannel* channel, TrackingSignal& channelSignal, uint32_t maxFrameBytes)
+	{
+		channel->m_Landmark_Count = -1;
+		channel->m_Gesture_Count = -1;
+		channel->m_Gesture_Result = GestureRecognitionResult();
+
+		// Any process that maps the segment can write the channel, so the size is read once
+		// and checked here; a frame past the channel's slot would crash the service for all
+		const int32_t imageWidth = channel->m_Image_Width;
+		const int32_t imageHeight = channel->m_Image_Height;
+		if (imageWidth <= 0 || imageHeight <= 0 || (uint64_t)imageWidth * (uint64_t)imageHeight * 3 > maxFrameBytes)
+		{
+			channel->m_Detect_Result = 0;
+		}
+		else
+		{
+			// Both request types use the synchronous entry point, so every callback for the
+			// frame has fired before the channel is handed back
+			g_CurrentChannel = channel;
+			channel->m_Detect_Result = handTrackingDll.m_Mediapipe_Hand_Tracking_Detect_Frame_Direct(
+				imageWidth, imageHeight, GetTrackingChannelFrame(channel), channel->m_Gesture_Result);
+			g_CurrentChannel = nullptr;
+		}
+
+		channel->m_State.store(TCS_Done, std::memory_order_release);
+		channelSignal.Wake(&channel->m_State);
+	}
+
+	struct NetworkClient
+	{
+		TrackingSocketHandle m_Socket = TRACKING_INVALID_SOCKET;
+		std::vector<unsigned char> m_Storage;		// a TrackingChannel followed by its frame, as in the segment
+		TrackingChannel* m_Channel = nullptr;
+		TrackingSignal m_Signal;
+		std::thread m_Thread;
+		std::atomic<bool> m_Is_Finished{ false };
+	};
+
+	std::mutex g_NetworkMutex;
+	std::vector<std::unique_ptr<NetworkClient>> g_NetworkClients;
+
+	// Moves requests from the socket into the client's channel and results back until the peer goes away
+	void RunNetworkClient(NetworkClient* client, TrackingServiceHeader* header, TrackingSignal* workSignal)
+	{
+		TrackingChannel* channel = client->m_Channel;
+		TrackingNetRequest request;
+		while (header->m_Running.load() != 0 && ReceiveAll(client->m_Socket, &request, sizeof(request)))
+		{
+			uint64_t frameBytes = (uint64_t)(uint32_t)request.m_Image_Width * (uint32_t)request.m_Image_Height * 3;
+			if (request.m_Magic != TRACKING_NET_MAGIC || request.m_Version != TRACKING_NET_VERSION
+				|| request.m_Image_Width <= 0 || request.m_Image_Height <= 0
+				|| request.m_Payload_Bytes != frameBytes || frameBytes > header->m_Max_Frame_Bytes
+				|| !ReceiveAll(client->m_Socket, GetTrackingChannelFrame(channel), request.m_Payload_Bytes))
+			{
+				break;
+			}
+			channel->m_Request_Type = TRT_DetectFrame;
+			channel->m_Image_Index = request.m_Image_Index;
+			channel->m_Image_Width = request.m_Image_Width;
+			channel->m_Image_Height = request.m_Image_Height;
+			channel->m_State.store(TCS_Requested, std::memory_order_release);
+			header->m_Work_Seq.fetch_add(1, std::memory_order_release);
+			workSignal->Wake(&header->m_Work_Seq);
+
+			while (channel->m_State.load(std::memory_order_acquire) == TCS_Requested && header->m_Running.load() != 0)
+			{
+				client->m_Signal.Wait(&channel->m_State, TCS_Requested, 200);
+			}
+			if (channel->m_State.load(std::memory_order_acquire) != TCS_Done)
+			{
+				break;
+			}
+
+			TrackingNetResponse response;
+			response.m_Detect_Result = channel->m_Detect_Result;
+			response.m_Gesture_Result = channel->m_Gesture_Result;
+			response.m_Landmark_Count = channel->m_Landmark_Count;
+			response.m_Gesture_Count = channel->m_Gesture_Count;
+			channel->m_State.store(TCS_Idle, std::memory_order_release);
+			if (!SendAll(client->m_Socket, &response, sizeof(response))
+				|| (response.m_Landmark_Count > 0 && !SendAll(client->m_Socket, channel->m_Landmarks, response.m_Landmark_Count * sizeof(PoseInfo)))
+				|| (response.m_Gesture_Count > 0 && !SendAll(client->m_Socket, channel->m_Gestures, response.m_Gesture_Count * sizeof(int))))
+			{
+				break;
+			}
+		}
+		client->m_Is_Finished.store(true);
+	}
+
+	// Accepts network clients until the service stops
+	void RunNetworkListener(TrackingSocketHandle listener, TrackingServiceHeader* header, TrackingSignal* workSignal, const std::string& serviceName)
+	{
+		int nextClientId = 0;
+		// main clears m_Running after a stop signal; g_StopRequested is not for other threads
+		while (header->m_Running.load() != 0)
+		{
+			// select with a timeout so a stop request is noticed
+			fd_set readable;
+			FD_ZERO(&readable);
+			FD_SET(listener, &readable);
+			timeval timeout = { 0, 200 * 1000 };
+			if (select((int)listener + 1, &readable, nullptr, nullptr, &timeout) <= 0)
+			{
+				continue;
+			}
+			TrackingSocketHandle socketHandle = accept(listener, nullptr, nullptr);
+			if (socketHandle == TRACKING_INVALID_SOCKET)
+			{
+				continue;
+			}
+			SetTrackingSocketNoDelay(socketHandle);
+
+			std::unique_ptr<NetworkClient> client(new NetworkClient());
+			client->m_Socket = socketHandle;
+			client->m_Storage.resize(header->m_Channel_Stride);
+			client->m_Channel = new (client->m_Storage.data()) TrackingChannel();
+			client->m_Channel->m_State.store(TCS_Idle);
+			client->m_Signal.Open(serviceName + "_net_" + std::to_string(nextClientId++));
+			client->m_Thread = std::thread(RunNetworkClient, client.get(), header, workSignal);
+
+			std::lock_guard<std::mutex> lock(g_NetworkMutex);
+			g_NetworkClients.push_back(std::move(client));
+		}
+	}
+
+	void ServeNetworkClients(MediapipeHandTrackingDll& handTrackingDll, uint32_t maxFrameBytes, bool& served)
+	{
+		std::lock_guard<std::mutex> lock(g_NetworkMutex);
+		for (std::unique_ptr<NetworkClient>& client : g_NetworkClients)
+		{
+			if (client->m_Channel->m_State.load(std::memory_order_acquire) == TCS_Requested)
+			{
+				ServeRequest(handTrackingDll, client->m_Channel, client->m_Signal, maxFrameBytes);
+				served = true;
+			}
+		}
+	}
+
+	void CloseNetworkClients(bool only_finished)
+	{
+		std::lock_guard<std::mutex> lock(g_NetworkMutex);
+		for (size_t i = 0; i < g_NetworkClients.size();)
+		{
+			NetworkClient* client = g_NetworkClients[i].get();
+			if (only_finished && !client->m_Is_Finished.load())
+			{
+				++i;
+				continue;
+			}
+			// unblocks a connection thread still waiting in recv
+#if defined(WINDOWS)
+			shutdown(client->m_Socket, SD_BOTH);
+#else
+			shutdown(client->m_Socket, SHUT_RDWR);
+#endif
+			client->m_Thread.join();
+			CloseTrackingSocket(client->m_Socket);
+			g_NetworkClients.erase(g_NetworkClients.begin() + i);
+		}
+	}
+
+	TrackingSocketHandle OpenNetworkListener(int port)
+	{
+#if defined(WINDOWS)
+		WSADATA wsaData;
+		if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+		{
+			return TRACKING_INVALID_SOCKET;
+		}
+#endif
+		TrackingSocketHandle listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+		if (listener == TRACKING_INVALID_SOCKET)
+		{
+			return TRACKING_INVALID_SOCKET;
+		}
+		int reuse = 1;
+		setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, (const char*)&reuse, sizeof(reuse));
+		sockaddr_in address;
+		memset(&address, 0, sizeof(address));
+		address.sin_family = AF_INET;
+		address.sin_addr.s_addr = htonl(INADDR_ANY);
+		address.sin_port = htons((uint16_t)port);
+		if (bind(listener, (const sockaddr*)&address, sizeof(address)) != 0 || listen(listener, 16) != 0)
+		{
+			CloseTrackingSocket(listener);
+			return TRACKING_INVALID_SOCKET;
+		}
+		return listener;
+	}
+
+	// Channels of clients that exited without disconnecting are returned to the pool
+	void ReclaimAbandonedChannels(TrackingServiceHeader* header)
+	{
+		for (uint32_t i = 0; i < header->m_Channel_Count; ++i)
+		{
+			TrackingChannel* channel = GetTrackingChannel(header, i);
+			// a client publishes its pid before it touches the state, so pid 0 is a free
+			// channel, never one being claimed; this also frees a client that died between
+			// the two writes
+			uint32_t ownerPid = channel->m_Owner_Pid.load();
+			if (ownerPid != 0 && !IsProcessAlive(ownerPid))
+			{
+				channel->m_State.store(TCS_Free);
+				channel->m_Owner_Pid.compare_exchange_strong(ownerPid, 0);
+			}
+		}
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 3)
+	{
+		printf("Usage: %s <dll_path> <model_path> [service_name] [channels] [max_width] [max_height] [tcp_port]\n", argv[0]);
+		return 1;
+	}
+
+	std::string dllPath = argv[1];
+	std::string modelPath = argv[2];
+	std::string serviceName = argc > 3 ? argv[3] : TRACKING_SERVICE_DEFAULT_NAME;
+	uint32_t channelCount = argc > 4 ? (uint32_t)atoi(argv[4]) : 4;
+	uint32_t maxWidth = argc > 5 ? (uint32_t)atoi(argv[5]) : 1920;
+	uint32_t maxHeight = argc > 6 ? (uint32_t)atoi(argv[6]) : 1080;
+	int tcpPort = argc > 7 ? atoi(argv[7]) : 0;
+	uint32_t maxFrameBytes = maxWidth * maxHeight * 3;
+
+	MediapipeHandTrackingDll handTrackingDll;
+	if (!handTrackingDll.LoadMediapipeHandTrackingDll(dllPath) || !handTrackingDll.GetAllFunctions())
+	{
+		printf("failed to load %s\n", dllPath.c_str());
+		return 1;
+	}
+	if (!handTrackingDll.m_Mediapipe_Hand_Tracking_Init(modelPath.c_str())
+		|| !handTrackingDll.m_Mediapipe_Hand_Tracking_Reigeter_Landmarks_Callback(OnLandmarks)
+		|| !handTrackingDll.m_Mediapipe_Hand_Tracking_Register_Gesture_Result_Callback(OnGestures))
+	{
+		printf("failed to initialize the graph from %s\n", modelPath.c_str());
+		return 1;
+	}
+
+	TrackingSharedSegment segment;
+	if (!segment.Create(serviceName, TrackingSegmentBytes(channelCount, maxFrameBytes)))
+	{
+		printf("failed to create shared memory %s\n", serviceName.c_str());
+		handTrackingDll.m_Mediapipe_Hand_Tracking_Release();
+		return 1;
+	}
+
+	TrackingServiceHeader* header = new (segment.GetData()) TrackingServiceHeader();
+	header->m_Channel_Count = channelCount;
+	header->m_Max_Frame_Bytes = maxFrameBytes;
+	header->m_Channel_Stride = TrackingChannelStride(maxFrameBytes);
+	header->m_Service_Pid = GetCurrentProcessIdentifier();
+	header->m_Work_Seq.store(0);
+	header->m_Running.store(1);
+
+	TrackingSignal workSignal;
+	workSignal.Open(TrackingWorkSignalName(serviceName));
+	std::vector<TrackingSignal> channelSignals(channelCount);
+	for (uint32_t i = 0; i < channelCount; ++i)
+	{
+		new (GetTrackingChannel(header, i)) TrackingChannel();
+		channelSignals[i].Open(TrackingChannelSignalName(serviceName, i));
+	}
+
+	// Clients check the magic last, so they never attach to a half-initialized segment
+	header->m_Version = TRACKING_SERVICE_VERSION;
+	std::atomic_thread_fence(std::memory_order_release);
+	header->m_Magic = TRACKING_SERVICE_MAGIC;
+
+	std::signal(SIGINT, OnStopSignal);
+	std::signal(SIGTERM, OnStopSignal);
+	printf("%s serving %u channels of up to %ux%u\n", serviceName.c_str(), channelCount, maxWidth, maxHeight);
+
+	TrackingSocketHandle listener = TRACKING_INVALID_SOCKET;
+	std::thread listenerThread;
+	if (tcpPort > 0)
+	{
+#if !defined(WINDOWS)
+		// SendAll passes MSG_NOSIGNAL where there is one; this covers the rest
+		std::signal(SIGPIPE, SIG_IGN);
+#endif
+		listener = OpenNetworkListener(tcpPort);
+		if (listener == TRACKING_INVALID_SOCKET)
+		{
+			printf("failed to listen on tcp port %d\n", tcpPort);
+		}
+		else
+		{
+			listenerThread = std::thread(RunNetworkListener, listener, header, &workSignal, serviceName);
+			printf("%s accepting network clients on tcp port %d\n", serviceName.c_str(), tcpPort);
+		}
+	}
+
+	auto lastReclaim = std::chrono::steady_clock::now();
+	while (!g_StopRequested)
+	{
+		uint32_t workSeq = header->m_Work_Seq.load(std::memory_order_acquire);
+
+		bool served = false;
+		for (uint32_t i = 0; i < channelCount; ++i)
+		{
+			TrackingChannel* channel = GetTrackingChannel(header, i);
+			if (channel->m_State.load(std::memory_order_acquire) == TCS_Requested)
+			{
+				ServeRequest(handTrackingDll, channel, channelSignals[i], maxFrameBytes);
+				served = true;
+			}
+		}
+		ServeNetworkClients(handTrackingDll, maxFrameBytes, served);
+
+		auto now = std::chrono::steady_clock::now();
+		if (now - lastReclaim > std::chrono::seconds(1))
+		{
+			ReclaimAbandonedChannels(header);
+			CloseNetworkClients(true);
+			lastReclaim = now;
+		}
+
+		if (!served)
+		{
+			workSignal.Wait(&header->m_Work_Seq, workSeq, 200);
+		}
+	}
+
+	header->m_Running.store(0);
+	for (uint32_t i = 0; i < channelCount; ++i)
+	{
+		channelSignals[i].Wake(&GetTrackingChannel(header, i)->m_State);
+	}
+	if (listenerThread.joinable())
+	{
+		listenerThread.join();
+		CloseTrackingSocket(listener);
+	}
+	CloseNetworkClients(false);
+#if defined(WINDOWS)
+	if (listener != TRACKING_INVALID_SOCKET)
+	{
+		WSACleanup();
+	}
+#endif
+	handTrackingDll.m_Mediapipe_Hand_Tracking_Release();
+	printf("%s stopped\n", serviceName.c_str());
+	return 0;
+}